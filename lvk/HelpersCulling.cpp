@@ -0,0 +1,426 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include "HelpersCulling.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+namespace {
+
+static const char* codeCullingCommon = R"(
+struct CullingMesh {
+  vec4 boundingSphere;
+  uint indexCount;
+  uint firstIndex;
+  int vertexOffset;
+  uint padding;
+};
+
+struct CullingInstance {
+  mat4 model;
+  uint meshIndex;
+  uint padding[3];
+};
+
+struct DrawIndexedIndirectCommand {
+  uint indexCount;
+  uint instanceCount;
+  uint firstIndex;
+  int vertexOffset;
+  uint baseInstance;
+};
+
+layout(std430, buffer_reference) readonly buffer CullingParams {
+  vec4 frustumPlanes[6];
+  mat4 hiZViewProj;
+  uint hiZMips[16];
+  uint hiZWidth;
+  uint hiZHeight;
+  uint numHiZMips;
+  uint numInstances;
+  uint maxDraws;
+  uint isOcclusionEnabled;
+  uint isReverseZ;
+  uint padding;
+};
+
+layout(std430, buffer_reference) readonly buffer Instances {
+  CullingInstance instances[];
+};
+
+layout(std430, buffer_reference) readonly buffer Meshes {
+  CullingMesh meshes[];
+};
+
+layout(std430, buffer_reference) writeonly buffer Draws {
+  DrawIndexedIndirectCommand draws[];
+};
+
+layout(std430, buffer_reference) buffer DrawCount {
+  uint count;
+};
+
+layout (set = 0, binding = 2, r32f) uniform image2D kHiZ[];
+)";
+
+static const char* codeCullCS = R"(
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(push_constant) uniform PushConstants {
+  CullingParams params;
+  Instances instances;
+  Meshes meshes;
+  Draws draws;
+  DrawCount drawCount;
+} pc;
+
+bool isOccluded(vec3 center, float radius) {
+  vec2 uvMin = vec2(1.0);
+  vec2 uvMax = vec2(0.0);
+  float zNearest = pc.params.isReverseZ != 0 ? 0.0 : 1.0;
+
+  // project the bounding box of the sphere into the viewport of the previous frame
+  for (uint i = 0; i != 8; i++) {
+    const vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+    const vec4 p = pc.params.hiZViewProj * vec4(corner, 1.0);
+    if (p.w <= 1e-5) {
+      return false; // crosses the camera plane
+    }
+    const vec3 ndc = p.xyz / p.w;
+    const vec2 uv = ndc.xy * 0.5 + 0.5;
+    uvMin = min(uvMin, uv);
+    uvMax = max(uvMax, uv);
+    zNearest = pc.params.isReverseZ != 0 ? max(zNearest, ndc.z) : min(zNearest, ndc.z);
+  }
+
+  uvMin = clamp(uvMin, vec2(0.0), vec2(1.0));
+  uvMax = clamp(uvMax, vec2(0.0), vec2(1.0));
+
+  if (any(greaterThanEqual(uvMin, uvMax))) {
+    return false; // outside of the viewport - the frustum test is the authority here
+  }
+
+  // choose the level where the footprint covers at most 2x2 texels
+  const vec2 sizePx = (uvMax - uvMin) * vec2(pc.params.hiZWidth, pc.params.hiZHeight);
+  const uint level = min(uint(ceil(log2(max(max(sizePx.x, sizePx.y), 1.0)))), pc.params.numHiZMips - 1);
+  const ivec2 dim = max(ivec2(pc.params.hiZWidth, pc.params.hiZHeight) >> level, ivec2(1));
+  const ivec2 p0 = clamp(ivec2(uvMin * vec2(dim)), ivec2(0), dim - 1);
+  const ivec2 p1 = clamp(ivec2(uvMax * vec2(dim)), ivec2(0), dim - 1);
+  const uint id = pc.params.hiZMips[level];
+
+  const float d00 = imageLoad(kHiZ[nonuniformEXT(id)], p0).r;
+  const float d10 = imageLoad(kHiZ[nonuniformEXT(id)], ivec2(p1.x, p0.y)).r;
+  const float d01 = imageLoad(kHiZ[nonuniformEXT(id)], ivec2(p0.x, p1.y)).r;
+  const float d11 = imageLoad(kHiZ[nonuniformEXT(id)], p1).r;
+
+  // the pyramid stores the farthest depth of each region
+  if (pc.params.isReverseZ != 0) {
+    return zNearest < min(min(d00, d10), min(d01, d11));
+  }
+  return zNearest > max(max(d00, d10), max(d01, d11));
+}
+
+void main() {
+  const uint idx = gl_GlobalInvocationID.x;
+
+  if (idx >= pc.params.numInstances) {
+    return;
+  }
+
+  const CullingInstance instance = pc.instances.instances[idx];
+  const CullingMesh mesh = pc.meshes.meshes[instance.meshIndex];
+
+  const vec3 center = (instance.model * vec4(mesh.boundingSphere.xyz, 1.0)).xyz;
+  const float scale = max(max(length(instance.model[0].xyz), length(instance.model[1].xyz)), length(instance.model[2].xyz));
+  const float radius = mesh.boundingSphere.w * scale;
+
+  for (uint i = 0; i != 6; i++) {
+    if (dot(pc.params.frustumPlanes[i].xyz, center) + pc.params.frustumPlanes[i].w < -radius) {
+      return;
+    }
+  }
+
+  if (pc.params.isOcclusionEnabled != 0 && isOccluded(center, radius)) {
+    return;
+  }
+
+  const uint slot = atomicAdd(pc.drawCount.count, 1);
+
+  if (slot < pc.params.maxDraws) {
+    pc.draws.draws[slot] = DrawIndexedIndirectCommand(mesh.indexCount, 1, mesh.firstIndex, mesh.vertexOffset, idx);
+  }
+}
+)";
+
+static const char* codeHiZCS = R"(
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(push_constant) uniform PushConstants {
+  uint srcId; // the depth texture for level 0, the previous level otherwise
+  uint dstId;
+  uint srcWidth;
+  uint srcHeight;
+  uint dstWidth;
+  uint dstHeight;
+  uint isDepthSource;
+  uint isReverseZ;
+} pc;
+
+float farthest(float a, float b) {
+  return pc.isReverseZ != 0 ? min(a, b) : max(a, b);
+}
+
+void main() {
+  const uvec2 xy = gl_GlobalInvocationID.xy;
+
+  if (xy.x >= pc.dstWidth || xy.y >= pc.dstHeight) {
+    return;
+  }
+
+  // every destination texel covers a rectangle of source texels: 2x2 for power-of-two levels, up to 3x3 for the depth buffer
+  const uvec2 srcDim = uvec2(pc.srcWidth, pc.srcHeight);
+  const uvec2 dstDim = uvec2(pc.dstWidth, pc.dstHeight);
+  const uvec2 begin = (xy * srcDim) / dstDim;
+  const uvec2 end = min(((xy + 1) * srcDim + dstDim - 1) / dstDim, srcDim);
+
+  float d = pc.isReverseZ != 0 ? 1.0 : 0.0;
+
+  for (uint y = begin.y; y < end.y; y++) {
+    for (uint x = begin.x; x < end.x; x++) {
+      const float s = pc.isDepthSource != 0 ? texelFetch(kTextures2D[pc.srcId], ivec2(x, y), 0).r
+                                            : imageLoad(kHiZ[pc.srcId], ivec2(x, y)).r;
+      d = farthest(d, s);
+    }
+  }
+
+  imageStore(kHiZ[pc.dstId], ivec2(xy), vec4(d));
+}
+)";
+
+struct CullingParams {
+  float frustumPlanes[6][4];
+  float hiZViewProj[16];
+  uint32_t hiZMips[lvk::GpuCuller::LVK_MAX_HIZ_MIP_LEVELS];
+  uint32_t hiZWidth;
+  uint32_t hiZHeight;
+  uint32_t numHiZMips;
+  uint32_t numInstances;
+  uint32_t maxDraws;
+  uint32_t isOcclusionEnabled;
+  uint32_t isReverseZ;
+  uint32_t padding;
+};
+
+static_assert(sizeof(CullingParams) == 256, "Should match the std430 layout in codeCullingCommon");
+static_assert(sizeof(lvk::CullingMesh) == 32);
+static_assert(sizeof(lvk::CullingInstance) == 80);
+static_assert(sizeof(lvk::DrawIndexedIndirectCommand) == 20);
+
+// Gribb-Hartmann for a column-major matrix and Vulkan clip space 0 <= z <= w
+void getFrustumPlanes(const float* m, float planes[6][4]) {
+  auto row = [m](uint32_t r, uint32_t c) -> float { return m[c * 4 + r]; };
+
+  for (uint32_t c = 0; c != 4; c++) {
+    planes[0][c] = row(3, c) + row(0, c); // left
+    planes[1][c] = row(3, c) - row(0, c); // right
+    planes[2][c] = row(3, c) + row(1, c); // bottom
+    planes[3][c] = row(3, c) - row(1, c); // top
+    planes[4][c] = row(2, c); // near (far for reversed depth)
+    planes[5][c] = row(3, c) - row(2, c); // far (near for reversed depth)
+  }
+
+  for (uint32_t i = 0; i != 6; i++) {
+    const float len = sqrtf(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+    if (len > 0.0f) {
+      for (uint32_t c = 0; c != 4; c++) {
+        planes[i][c] /= len;
+      }
+    } else {
+      // a degenerate plane (i.e. the infinite far plane) never culls anything
+      planes[i][0] = planes[i][1] = planes[i][2] = 0.0f;
+      planes[i][3] = 1.0f;
+    }
+  }
+}
+
+uint32_t getPrevPowerOfTwo(uint32_t v) {
+  uint32_t r = 1;
+  while (r * 2 <= v) {
+    r *= 2;
+  }
+  return r;
+}
+
+} // namespace
+
+namespace lvk {
+
+GpuCuller::GpuCuller(lvk::IContext& ctx, uint32_t maxDraws, bool isReverseZ) : ctx_(ctx), maxDraws_(maxDraws), isReverseZ_(isReverseZ) {
+  LVK_ASSERT(maxDraws);
+
+  const std::string cull = std::string(codeCullingCommon) + codeCullCS;
+  const std::string hiZ = std::string(codeCullingCommon) + codeHiZCS;
+
+  compCull_ = ctx_.createShaderModule({cull.c_str(), Stage_Comp, "Shader Module: culling (comp)"});
+  compHiZ_ = ctx_.createShaderModule({hiZ.c_str(), Stage_Comp, "Shader Module: Hi-Z (comp)"});
+  pipelineCull_ = ctx_.createComputePipeline({.smComp = compCull_, .debugName = "GpuCuller: pipelineCull_"});
+  pipelineHiZ_ = ctx_.createComputePipeline({.smComp = compHiZ_, .debugName = "GpuCuller: pipelineHiZ_"});
+
+  draws_ = ctx_.createBuffer({
+      .usage = lvk::BufferUsageBits_Storage | lvk::BufferUsageBits_Indirect,
+      .storage = lvk::StorageType_Device,
+      .size = maxDraws * sizeof(DrawIndexedIndirectCommand),
+      .debugName = "GpuCuller: draws_",
+  });
+  count_ = ctx_.createBuffer({
+      .usage = lvk::BufferUsageBits_Storage | lvk::BufferUsageBits_Indirect,
+      .storage = lvk::StorageType_Device,
+      .size = sizeof(uint32_t),
+      .debugName = "GpuCuller: count_",
+  });
+}
+
+void GpuCuller::createHiZ(const lvk::Dimensions& depthDim) {
+  depthDim_ = depthDim;
+  hiZDim_ = {getPrevPowerOfTwo(depthDim.width), getPrevPowerOfTwo(depthDim.height), 1};
+  numHiZMips_ = std::min(lvk::calcNumMipLevels(hiZDim_.width, hiZDim_.height), (uint32_t)LVK_MAX_HIZ_MIP_LEVELS);
+  hasHiZ_ = false;
+
+  for (lvk::Holder<lvk::TextureHandle>& mip : hiZMips_) {
+    mip = nullptr;
+  }
+
+  hiZ_ = ctx_.createTexture({
+      .type = lvk::TextureType_2D,
+      .format = lvk::Format_R_F32,
+      .dimensions = hiZDim_,
+      .usage = lvk::TextureUsageBits_Sampled | lvk::TextureUsageBits_Storage,
+      .numMipLevels = numHiZMips_,
+      .debugName = "GpuCuller: hiZ_",
+  });
+
+  for (uint32_t i = 0; i != numHiZMips_; i++) {
+    hiZMips_[i] = ctx_.createTextureView(hiZ_, {.mipLevel = i}, "GpuCuller: hiZMips_");
+  }
+}
+
+void GpuCuller::cull(lvk::ICommandBuffer& buffer, const CullingDesc& desc) {
+  LVK_PROFILER_FUNCTION();
+
+  if (!LVK_VERIFY(desc.instances.valid() && desc.meshes.valid())) {
+    return;
+  }
+
+  CullingParams params = {
+      .hiZWidth = hiZDim_.width,
+      .hiZHeight = hiZDim_.height,
+      .numHiZMips = numHiZMips_,
+      .numInstances = desc.numInstances,
+      .maxDraws = maxDraws_,
+      .isOcclusionEnabled = desc.enableOcclusion && hasHiZ_ ? 1u : 0u,
+      .isReverseZ = isReverseZ_ ? 1u : 0u,
+  };
+  getFrustumPlanes(desc.viewProj, params.frustumPlanes);
+  memcpy(params.hiZViewProj, hiZViewProj_, sizeof(hiZViewProj_));
+  for (uint32_t i = 0; i != numHiZMips_; i++) {
+    params.hiZMips[i] = hiZMips_[i].index();
+  }
+
+  // per-frame data - recycled by the context once the GPU is done with it
+  const lvk::TransientAllocation paramsAlloc = ctx_.allocateTransient(sizeof(params));
+
+  memcpy(paramsAlloc.ptr, &params, sizeof(params));
+
+  buffer.cmdPushDebugGroupLabel("GpuCuller::cull()", 0xff0080ff);
+
+  buffer.cmdFillBuffer(count_, 0, sizeof(uint32_t), 0);
+
+  const struct {
+    uint64_t params;
+    uint64_t instances;
+    uint64_t meshes;
+    uint64_t draws;
+    uint64_t count;
+  } pc = {
+      .params = paramsAlloc.gpuAddress,
+      .instances = ctx_.gpuAddress(desc.instances),
+      .meshes = ctx_.gpuAddress(desc.meshes),
+      .draws = ctx_.gpuAddress(draws_),
+      .count = ctx_.gpuAddress(count_),
+  };
+
+  buffer.cmdBindComputePipeline(pipelineCull_);
+  buffer.cmdPushConstants(pc);
+  buffer.cmdDispatchThreadGroups(
+      {.width = (desc.numInstances + 63) / 64},
+      {
+          .textures = {hasHiZ_ ? lvk::TextureHandle(hiZ_) : lvk::TextureHandle()},
+          .buffers = {lvk::BufferHandle(count_), lvk::BufferHandle(draws_), desc.instances, desc.meshes},
+      });
+
+  buffer.cmdPopDebugGroupLabel();
+}
+
+void GpuCuller::cmdDraw(lvk::ICommandBuffer& buffer) const {
+  buffer.cmdDrawIndexedIndirectCount(draws_, 0, count_, 0, maxDraws_, sizeof(DrawIndexedIndirectCommand));
+}
+
+void GpuCuller::buildHiZ(lvk::ICommandBuffer& buffer, TextureHandle depth, const float* viewProj) {
+  LVK_PROFILER_FUNCTION();
+
+  if (!LVK_VERIFY(depth.valid() && viewProj)) {
+    return;
+  }
+
+  const lvk::Dimensions dim = ctx_.getDimensions(depth);
+
+  if (dim.width != depthDim_.width || dim.height != depthDim_.height) {
+    createHiZ(dim);
+  }
+
+  buffer.cmdPushDebugGroupLabel("GpuCuller::buildHiZ()", 0xff0080ff);
+  buffer.cmdBindComputePipeline(pipelineHiZ_);
+
+  for (uint32_t i = 0; i != numHiZMips_; i++) {
+    const uint32_t dstWidth = std::max(hiZDim_.width >> i, 1u);
+    const uint32_t dstHeight = std::max(hiZDim_.height >> i, 1u);
+    const struct {
+      uint32_t srcId;
+      uint32_t dstId;
+      uint32_t srcWidth;
+      uint32_t srcHeight;
+      uint32_t dstWidth;
+      uint32_t dstHeight;
+      uint32_t isDepthSource;
+      uint32_t isReverseZ;
+    } pc = {
+        .srcId = i ? hiZMips_[i - 1].index() : depth.index(),
+        .dstId = hiZMips_[i].index(),
+        .srcWidth = i ? std::max(hiZDim_.width >> (i - 1), 1u) : dim.width,
+        .srcHeight = i ? std::max(hiZDim_.height >> (i - 1), 1u) : dim.height,
+        .dstWidth = dstWidth,
+        .dstHeight = dstHeight,
+        .isDepthSource = i ? 0u : 1u,
+        .isReverseZ = isReverseZ_ ? 1u : 0u,
+    };
+    buffer.cmdPushConstants(pc);
+    // every level depends on the previous one - the storage image barrier of `hiZ_` is issued for each dispatch
+    buffer.cmdDispatchThreadGroups({.width = (dstWidth + 7) / 8, .height = (dstHeight + 7) / 8},
+                                   {.textures = {depth, lvk::TextureHandle(hiZ_)}});
+  }
+
+  buffer.cmdPopDebugGroupLabel();
+
+  memcpy(hiZViewProj_, viewProj, sizeof(hiZViewProj_));
+  hasHiZ_ = true;
+}
+
+} // namespace lvk
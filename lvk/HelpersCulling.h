@@ -0,0 +1,99 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#pragma once
+
+#include <lvk/LVK.h>
+
+namespace lvk {
+
+// std430 layouts shared with the culling compute shaders
+
+struct CullingMesh {
+  float boundingSphere[4] = {}; // xyz - center in object space, w - radius
+  uint32_t indexCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t vertexOffset = 0;
+  uint32_t padding = 0;
+};
+
+struct CullingInstance {
+  float model[16] = {}; // column-major object-to-world matrix
+  uint32_t meshIndex = 0; // into the array of CullingMesh
+  uint32_t padding[3] = {};
+};
+
+// VkDrawIndexedIndirectCommand; `baseInstance` is the index of the CullingInstance which produced the draw
+struct DrawIndexedIndirectCommand {
+  uint32_t indexCount = 0;
+  uint32_t instanceCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t vertexOffset = 0;
+  uint32_t baseInstance = 0;
+};
+
+struct CullingDesc {
+  BufferHandle instances; // CullingInstance[numInstances], BufferUsageBits_Storage
+  BufferHandle meshes; // CullingMesh[], BufferUsageBits_Storage
+  uint32_t numInstances = 0;
+  float viewProj[16] = {}; // column-major, Vulkan clip space
+  bool enableOcclusion = true; // the Hi-Z pyramid from the last buildHiZ() call
+};
+
+// GPU-driven frustum and Hi-Z occlusion culling:
+//   1. cull() writes compacted DrawIndexedIndirectCommand's and their count
+//   2. put getIndirectBuffer() and getCountBuffer() into Dependencies::buffers of the next cmdBeginRendering() and call cmdDraw()
+//   3. buildHiZ() after rendering the depth buffer; the pyramid is used for the occlusion test of the next cull() call
+class GpuCuller {
+ public:
+  enum { LVK_MAX_HIZ_MIP_LEVELS = 16 };
+
+  explicit GpuCuller(lvk::IContext& ctx, uint32_t maxDraws, bool isReverseZ = false);
+
+  void cull(lvk::ICommandBuffer& buffer, const CullingDesc& desc);
+  void cmdDraw(lvk::ICommandBuffer& buffer) const;
+  // `depth` should be a single-sampled depth attachment with TextureUsageBits_Sampled; `viewProj` is the matrix it was rendered with
+  void buildHiZ(lvk::ICommandBuffer& buffer, TextureHandle depth, const float* viewProj);
+
+  [[nodiscard]] BufferHandle getIndirectBuffer() const {
+    return draws_;
+  }
+  [[nodiscard]] BufferHandle getCountBuffer() const {
+    return count_;
+  }
+  [[nodiscard]] TextureHandle getHiZ() const {
+    return hiZ_;
+  }
+  [[nodiscard]] uint32_t getMaxDraws() const {
+    return maxDraws_;
+  }
+
+ private:
+  void createHiZ(const lvk::Dimensions& depthDim);
+
+ private:
+  lvk::IContext& ctx_;
+  lvk::Holder<lvk::ShaderModuleHandle> compCull_;
+  lvk::Holder<lvk::ShaderModuleHandle> compHiZ_;
+  lvk::Holder<lvk::ComputePipelineHandle> pipelineCull_;
+  lvk::Holder<lvk::ComputePipelineHandle> pipelineHiZ_;
+  lvk::Holder<lvk::BufferHandle> draws_;
+  lvk::Holder<lvk::BufferHandle> count_;
+  lvk::Holder<lvk::TextureHandle> hiZ_;
+  lvk::Holder<lvk::TextureHandle> hiZMips_[LVK_MAX_HIZ_MIP_LEVELS] = {};
+
+  uint32_t maxDraws_ = 0;
+  bool isReverseZ_ = false;
+
+  lvk::Dimensions depthDim_ = {};
+  lvk::Dimensions hiZDim_ = {};
+  uint32_t numHiZMips_ = 0;
+  bool hasHiZ_ = false; // the pyramid contains depth rendered with hiZViewProj_
+  float hiZViewProj_[16] = {};
+};
+
+} // namespace lvk
@@ -90,6 +90,7 @@ static constexpr TextureFormatProperties properties[] = {
     PROPS(Z_F32_S_UI8, 5, .depth = true, .stencil = true),
     PROPS(YUV_NV12, 24, .blockWidth = 4, .blockHeight = 4, .compressed = true, .numPlanes = 2), // Subsampled 420
     PROPS(YUV_420p, 24, .blockWidth = 4, .blockHeight = 4, .compressed = true, .numPlanes = 3), // Subsampled 420
+    PROPS(ASTC_4x4_RGBA, 16, .blockWidth = 4, .blockHeight = 4, .compressed = true),
 };
 
 } // namespace
@@ -99,7 +100,7 @@ void* createCocoaWindowView(GLFWwindow* window, void** outLayer);
 #endif
 
 static_assert(sizeof(TextureFormatProperties) <= sizeof(uint32_t));
-static_assert(LVK_ARRAY_NUM_ELEMENTS(properties) == lvk::Format_YUV_420p + 1);
+static_assert(LVK_ARRAY_NUM_ELEMENTS(properties) == lvk::Format_ASTC_4x4_RGBA + 1);
 
 bool lvk::isDepthOrStencilFormat(lvk::Format format) {
   return properties[format].depth || properties[format].stencil;
@@ -145,6 +146,31 @@ uint32_t lvk::getVertexFormatSize(lvk::VertexFormat format) {
 #undef SIZE2_4_NORM
 }
 
+uint32_t lvk::getSparsePageIndex(const SparseTextureInfo& info, const SparsePage& page) {
+  LVK_ASSERT(page.mipLevel < info.firstMipTailLevel);
+  LVK_ASSERT(page.x < info.levelPagesPerRow[page.mipLevel]);
+
+  return info.levelFirstPage[page.mipLevel] + page.y * info.levelPagesPerRow[page.mipLevel] + page.x;
+}
+
+lvk::SparsePage lvk::getSparsePage(const SparseTextureInfo& info, uint32_t pageIndex) {
+  LVK_ASSERT(pageIndex < info.numPages);
+
+  uint32_t level = 0;
+
+  while (level + 1 < info.firstMipTailLevel && info.levelFirstPage[level + 1] <= pageIndex) {
+    level++;
+  }
+
+  const uint32_t index = pageIndex - info.levelFirstPage[level];
+
+  return {
+      .x = index % info.levelPagesPerRow[level],
+      .y = index / info.levelPagesPerRow[level],
+      .mipLevel = level,
+  };
+}
+
 uint32_t lvk::getTextureBytesPerLayer(uint32_t width, uint32_t height, lvk::Format format, uint32_t level) {
   const uint32_t levelWidth = std::max(width >> level, 1u);
   const uint32_t levelHeight = std::max(height >> level, 1u);
@@ -245,6 +271,12 @@ void lvk::destroy(lvk::IContext* ctx, lvk::AccelStructHandle handle) {
   }
 }
 
+void lvk::destroy(lvk::IContext* ctx, lvk::ReadbackHandle handle) {
+  if (ctx) {
+    ctx->destroy(handle);
+  }
+}
+
 // Logs GLSL shaders with line numbers annotation
 void lvk::logShaderSource(const char* text) {
   uint32_t line = 0;
@@ -44,6 +44,7 @@
   #define LVK_PROFILER_ZONE_END() }
   #define LVK_PROFILER_THREAD(name) tracy::SetThreadName(name)
   #define LVK_PROFILER_FRAME(name) FrameMarkNamed(name)
+  #define LVK_PROFILER_PLOT(name, value) TracyPlot(name, value)
 #else
   #define LVK_PROFILER_FUNCTION()
   #define LVK_PROFILER_FUNCTION_COLOR(color)
@@ -51,6 +52,7 @@
   #define LVK_PROFILER_ZONE_END() }
   #define LVK_PROFILER_THREAD(name)
   #define LVK_PROFILER_FRAME(name)
+  #define LVK_PROFILER_PLOT(name, value)
 #endif // LVK_WITH_TRACY
 // clang-format on
 
@@ -124,6 +126,7 @@ using BufferHandle = lvk::Handle<struct Buffer>;
 using TextureHandle = lvk::Handle<struct Texture>;
 using QueryPoolHandle = lvk::Handle<struct QueryPool>;
 using AccelStructHandle = lvk::Handle<struct AccelerationStructure>;
+using ReadbackHandle = lvk::Handle<struct Readback>;
 
 // forward declarations to access incomplete type IContext
 void destroy(lvk::IContext* ctx, lvk::ComputePipelineHandle handle);
@@ -135,6 +138,7 @@ void destroy(lvk::IContext* ctx, lvk::BufferHandle handle);
 void destroy(lvk::IContext* ctx, lvk::TextureHandle handle);
 void destroy(lvk::IContext* ctx, lvk::QueryPoolHandle handle);
 void destroy(lvk::IContext* ctx, lvk::AccelStructHandle handle);
+void destroy(lvk::IContext* ctx, lvk::ReadbackHandle handle);
 
 template<typename HandleType>
 class Holder final {
@@ -219,6 +223,7 @@ namespace lvk {
 
 enum { LVK_MAX_COLOR_ATTACHMENTS = 8 };
 enum { LVK_MAX_MIP_LEVELS = 16 };
+enum { LVK_MAX_COMMAND_BUFFERS = 64 }; // the default ContextConfig::maxCommandBuffers
 
 enum IndexFormat : uint8_t {
   IndexFormat_UI8,
@@ -285,6 +290,7 @@ struct HWDeviceDesc {
 enum StorageType {
   StorageType_Device,
   StorageType_HostVisible,
+  // transient attachments backed by lazily allocated memory when available (tiled GPUs); device-local memory otherwise
   StorageType_Memoryless,
 };
 
@@ -296,6 +302,7 @@ struct Result {
     Ok,
     ArgumentOutOfRange,
     RuntimeError,
+    Pending, // nothing was done because the resources are busy; try again later
   };
 
   Code code = Code::Ok;
@@ -546,6 +553,9 @@ enum Format : uint8_t {
 
   Format_YUV_NV12,
   Format_YUV_420p,
+
+  // appended to keep the values of the formats above
+  Format_ASTC_4x4_RGBA,
 };
 
 enum LoadOp : uint8_t {
@@ -589,6 +599,13 @@ enum ShaderStage : uint8_t {
   Stage_Callable,
 };
 
+// what happens when a pipeline which is still being compiled in the background (see IContext::prewarm()) is bound
+enum PipelineNotReady : uint8_t {
+  PipelineNotReady_Wait = 0, // block until the compilation is finished
+  PipelineNotReady_Skip, // skip all draw, dispatch and trace rays commands until another pipeline is bound
+  PipelineNotReady_Fallback, // bind the `fallback` pipeline from the pipeline description instead (fallbacks are not chained)
+};
+
 union ClearColorValue {
   float float32[4];
   int32_t int32[4];
@@ -720,6 +737,9 @@ struct RenderPipelineDesc final {
   uint32_t patchControlPoints = 0;
   float minSampleShading = 0.0f;
 
+  PipelineNotReady notReady = PipelineNotReady_Wait;
+  RenderPipelineHandle fallback = {}; // should be compatible with the same render passes as this pipeline
+
   const char* debugName = "";
 
   uint32_t getNumColorAttachments() const {
@@ -735,6 +755,8 @@ struct ComputePipelineDesc final {
   ShaderModuleHandle smComp;
   SpecializationConstantDesc specInfo = {};
   const char* entryPoint = "main";
+  PipelineNotReady notReady = PipelineNotReady_Wait;
+  ComputePipelineHandle fallback = {};
   const char* debugName = "";
 };
 
@@ -753,6 +775,8 @@ struct RayTracingPipelineDesc final {
   ShaderModuleHandle smCallable[LVK_MAX_RAY_TRACING_SHADERS] = {};
   RayTracingHitGroupDesc hitGroups[LVK_MAX_RAY_TRACING_HIT_GROUPS] = {}; // hit groups - one per material
   SpecializationConstantDesc specInfo = {};
+  PipelineNotReady notReady = PipelineNotReady_Wait;
+  RayTracingPipelineHandle fallback = {};
   const char* debugName = "";
   // clang-format off
 #define GET_SHADER_GROUP_SIZE(name, sm) \
@@ -789,6 +813,9 @@ struct RenderPass final {
   uint32_t layerCount = 1;
   uint32_t viewMask = 0;
 
+  // the contents of this render pass are recorded into secondary command buffers and executed via cmdExecuteCommands()
+  bool secondaryCommandBuffers = false;
+
   uint32_t getNumColorAttachments() const {
     uint32_t n = 0;
     while (n < LVK_MAX_COLOR_ATTACHMENTS && color[n].loadOp != LoadOp_Invalid) {
@@ -835,9 +862,98 @@ struct BufferDesc final {
   StorageType storage = StorageType_HostVisible;
   size_t size = 0;
   const void* data = nullptr;
+  // VK_SHARING_MODE_CONCURRENT: the buffer can be accessed from the compute and transfer queues as well as from the graphics queue. Other
+  // buffers belong to the graphics queue family (ownership transfers are not supported), and uploadAsync() falls back to upload() for them
+  bool isShared = false;
   const char* debugName = "";
 };
 
+// a sub-allocation of a persistently mapped buffer returned by IContext::allocateTransient()
+struct TransientAllocation {
+  void* ptr = nullptr;
+  uint64_t gpuAddress = 0;
+  BufferHandle buffer;
+  uint64_t offset = 0; // `buffer` and `offset` can be used to bind the allocation as a vertex, index or indirect buffer
+};
+
+// counters accumulated while a command buffer is being recorded; secondary command buffers are added to their primary ones
+struct CommandBufferStats {
+  uint32_t numDrawCalls = 0; // direct and indirect draw commands, including mesh tasks
+  uint32_t numDispatches = 0; // compute dispatches and ray tracing launches
+  uint32_t numBarriers = 0; // individual memory barriers
+  uint32_t numRedundantBinds = 0; // bind and set commands which were dropped because the state was already set
+};
+
+struct GpuTimingScope {
+  char name[64] = {};
+  uint32_t depth = 0; // nesting level inside its command buffer
+  double beginMs = 0; // relative to the earliest timing scope of the frame
+  double durationMs = 0;
+  int64_t cpuTimeNs = 0; // std::chrono::steady_clock time of the beginning; 0 without VK_KHR_calibrated_timestamps
+};
+
+enum MemoryCategory : uint8_t {
+  MemoryCategory_Buffer = 0,
+  MemoryCategory_Texture,
+  MemoryCategory_AccelStruct, // acceleration structure storage buffers
+  MemoryCategory_Staging, // staging and readback buffers owned by LVK
+  MemoryCategory_Descriptors, // descriptor buffers; descriptor pools live in driver memory which Vulkan does not report
+  MemoryCategory_SparsePages, // memory blocks of the sparse page pool (see IContext::updateSparsePages())
+  MemoryCategory_Num,
+};
+
+struct MemoryHeapStats {
+  uint64_t size = 0;
+  uint64_t budget = 0; // how much this process can allocate before the driver starts paging; 80% of `size` without VK_EXT_memory_budget
+  uint64_t usage = 0; // allocated by this process; only by LVK without VK_EXT_memory_budget
+  bool isDeviceLocal = false;
+};
+
+// see IContext::getMemoryStats()
+struct MemoryStats {
+  enum { LVK_MAX_MEMORY_HEAPS = 16 };
+  uint32_t numHeaps = 0;
+  MemoryHeapStats heaps[LVK_MAX_MEMORY_HEAPS] = {};
+  uint64_t categoryBytes[MemoryCategory_Num] = {}; // memory allocated by LVK for each MemoryCategory
+  uint32_t categoryCount[MemoryCategory_Num] = {}; // the number of resources in each MemoryCategory
+  bool hasMemoryBudget = false; // VK_EXT_memory_budget
+};
+
+// invoked by IContext::submit() at the end of every frame while the usage of `heapIndex` is above the threshold
+using MemoryBudgetCallback = void (*)(const MemoryStats& stats, uint32_t heapIndex, void* userData);
+
+// see IContext::getFrameStats()
+struct FrameStats {
+  enum { LVK_MAX_GPU_TIMING_SCOPES = 256 };
+  enum { LVK_MAX_FRAME_COMMAND_BUFFERS = 16 };
+  uint64_t frameIndex = 0;
+  uint32_t numCommandBuffers = 0; // only the first LVK_MAX_FRAME_COMMAND_BUFFERS are stored in `commandBuffers`
+  CommandBufferStats commandBuffers[LVK_MAX_FRAME_COMMAND_BUFFERS] = {}; // in submission order
+  CommandBufferStats total = {}; // all command buffers submitted during the frame
+  uint32_t numScopes = 0;
+  GpuTimingScope scopes[LVK_MAX_GPU_TIMING_SCOPES] = {}; // in the order they were opened
+  double gpuTimeMs = 0; // from the earliest beginning to the latest end of all timing scopes
+};
+
+// see IContext::getCreationStats(); accumulated over the lifetime of the context, including background compilation
+struct CreationStats {
+  uint32_t numPipelines = 0; // only pipelines with valid VkPipelineCreationFeedback
+  uint32_t numPipelineCacheHits = 0;
+  double pipelineTimeMs = 0;
+  uint32_t numShaderCompilations = 0; // GLSL and Slang compilations; SPIR-V cache hits are not compiled
+  uint32_t numShaderCacheHits = 0; // see ContextConfig::enableShaderCache
+  double shaderCompilationTimeMs = 0;
+};
+
+// see IContext::getPresentTimings(); the presentation of a frame is observed by the IContext::waitForNextFrame() call which waits for it
+struct PresentTimings {
+  uint64_t frameIndex = 0; // the last presented frame
+  double sleepMs = 0; // the time the CPU spent in waitForNextFrame() before starting this frame
+  double latencyMs = 0; // from waitForNextFrame() returning (input sampling) to the presentation of this frame
+  double intervalMs = 0; // between the presentation of this frame and the previous one
+  bool isPresentWait = false; // VK_KHR_present_wait; otherwise, the presentation is approximated by the GPU finishing the frame
+};
+
 struct Offset3D {
   int32_t x = 0;
   int32_t y = 0;
@@ -900,9 +1016,44 @@ struct TextureDesc {
   const void* data = nullptr;
   uint32_t dataNumMipLevels = 1; // how many mip-levels we want to upload
   bool generateMipmaps = false; // generate mip-levels immediately, valid only with non-null data
+  // VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT: only the mip-tail is backed by memory after creation, see IContext::updateSparsePages().
+  // 2D textures with 1 layer and 1 sample, no initial data
+  bool sparse = false;
+  // Place this attachment into the memory of another attachment; the contents of both textures are discarded whenever either of them is
+  // rendered into without LoadOp_Load. Both textures must not be used within the same render pass. `aliasTexture` must outlive it.
+  TextureHandle aliasTexture = {};
+  // VK_SHARING_MODE_CONCURRENT: see BufferDesc::isShared
+  bool isShared = false;
   const char* debugName = "";
 };
 
+// a page of a sparse texture (see TextureDesc::sparse); `x` and `y` are in pages, not texels
+struct SparsePage {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t mipLevel = 0;
+};
+
+/*
+ Sparse textures report which pages shaders have requested through a feedback buffer written by textureBindless2DSparse() (GLSL):
+
+   vec4 textureBindless2DSparse(uint textureid, uint samplerid, vec2 uv, uvec2 feedback); // feedback = gpuAddress(info.feedback)
+
+ It samples the finest resident mip-level and sets the bit of the requested page in the bitmask located at `feedbackOffset`. Read the
+ bitmask back with readbackAsync(), clear it with cmdFillBuffer(), and use getSparsePage() to find out which pages to bind.
+*/
+struct SparseTextureInfo {
+  Dimensions pageDimensions = {}; // in texels
+  uint32_t pageSize = 0; // in bytes
+  uint32_t firstMipTailLevel = 0; // mip-levels [firstMipTailLevel...numMipLevels) are always resident
+  uint32_t numPages = 0; // in all mip-levels before the mip-tail
+  uint32_t numResidentPages = 0;
+  uint32_t levelFirstPage[LVK_MAX_MIP_LEVELS] = {}; // the index of the first page of every mip-level before the mip-tail
+  uint32_t levelPagesPerRow[LVK_MAX_MIP_LEVELS] = {};
+  BufferHandle feedback; // owned by the texture
+  uint32_t feedbackOffset = 0; // the bitmask of requested pages (1 bit per page), `numPages` bits
+};
+
 struct TextureViewDesc {
   TextureType type = TextureType_2D;
   uint32_t layer = 0;
@@ -985,11 +1136,25 @@ struct AccelStructDesc {
   BufferHandle instancesBuffer;
   AccelStructBuildRange buildRange = {};
   uint8_t buildFlags = AccelStructBuildFlagBits_PreferFastTrace;
+  // TLAS only: cmdUpdateTLAS() refits a TLAS built with AccelStructBuildFlagBits_AllowUpdate up to this many times in a row and then
+  // does a full rebuild to restore the trace quality lost by refitting (0 means always refit)
+  uint32_t maxNumRefits = 0;
+  // TLAS only: VK_SHARING_MODE_CONCURRENT for the storage and scratch buffers (see BufferDesc::isShared), needed to update it from a
+  // QueueType_Compute command buffer
+  bool isShared = false;
   const char* debugName = "";
 };
 
+enum QueueType : uint8_t {
+  QueueType_Graphics = 0,
+  // async compute queue (falls back to the graphics queue family if the device has no dedicated compute queue); resources accessed
+  // from it have to be created with `isShared` when its queue family is different from the graphics one
+  QueueType_Compute,
+  QueueType_Transfer, // asynchronous uploads only (see IContext::uploadAsync()); cannot be used to acquire command buffers
+};
+
 struct Dependencies {
-  enum { LVK_MAX_SUBMIT_DEPENDENCIES = 4 };
+  enum { LVK_MAX_SUBMIT_DEPENDENCIES = 8 };
   TextureHandle textures[LVK_MAX_SUBMIT_DEPENDENCIES] = {};
   BufferHandle buffers[LVK_MAX_SUBMIT_DEPENDENCIES] = {};
   TextureHandle inputAttachments[LVK_MAX_COLOR_ATTACHMENTS] = {};
@@ -1006,6 +1171,11 @@ class ICommandBuffer {
   virtual void cmdInsertDebugEventLabel(const char* label, uint32_t colorRGBA = 0xffffffff) const = 0;
   virtual void cmdPopDebugGroupLabel() const = 0;
 
+  // nested GPU timing scopes are also debug group labels; results are available a few frames later via IContext::getFrameStats()
+  virtual void cmdBeginTimingScope(const char* name, uint32_t colorRGBA = 0xffffffff) = 0;
+  virtual void cmdEndTimingScope() = 0;
+  [[nodiscard]] virtual const CommandBufferStats& getStats() const = 0;
+
   virtual void cmdBindRayTracingPipeline(lvk::RayTracingPipelineHandle handle) = 0;
 
   virtual void cmdBindComputePipeline(lvk::ComputePipelineHandle handle) = 0;
@@ -1014,6 +1184,8 @@ class ICommandBuffer {
   virtual void cmdBeginRendering(const lvk::RenderPass& renderPass, const lvk::Framebuffer& desc, const Dependencies& deps = {}) = 0;
   virtual void cmdEndRendering() = 0;
   virtual void cmdNextSubpass() = 0;
+  // execute secondary command buffers acquired via IContext::acquireSecondaryCommandBuffer()
+  virtual void cmdExecuteCommands(ICommandBuffer* const* secondaryCommandBuffers, uint32_t numCommandBuffers) = 0;
 
   virtual void cmdBindViewport(const Viewport& viewport) = 0;
   virtual void cmdBindScissorRect(const ScissorRect& rect) = 0;
@@ -1084,7 +1256,15 @@ class ICommandBuffer {
                             const TextureLayers& srcLayers = {},
                             const TextureLayers& dstLayers = {}) = 0;
   virtual void cmdGenerateMipmap(TextureHandle handle) = 0;
-  virtual void cmdUpdateTLAS(AccelStructHandle handle, BufferHandle instancesBuffer) = 0;
+  // 2D and cube textures with TextureUsageBits_Sampled and TextureUsageBits_Storage are processed together in compute shaders, which
+  // also works for formats that cannot be blitted; all other textures fall back to per-level blits
+  virtual void cmdGenerateMipmaps(const TextureHandle* handles, uint32_t numTextures) = 0;
+  // Refits or rebuilds the TLAS in-place (see AccelStructDesc::maxNumRefits); `forceRebuild` is needed when instances moved far enough
+  // to make a refit degrade the trace quality. The number of instances is fixed at creation (AccelStructDesc::buildRange); hide unused
+  // instances with a zero mask or create a new TLAS. Can be recorded into a QueueType_Compute command buffer to rebuild asynchronously
+  // if the TLAS was created with AccelStructDesc::isShared: keep two TLAS handles, update one while tracing the other, and make the
+  // consumer gpuWait() on the SubmitHandle of the update before swapping them.
+  virtual void cmdUpdateTLAS(AccelStructHandle handle, BufferHandle instancesBuffer, bool forceRebuild = false) = 0;
 };
 
 struct SubmitHandle {
@@ -1104,6 +1284,8 @@ struct SubmitHandle {
 
 static_assert(sizeof(SubmitHandle) == sizeof(uint64_t));
 
+// Resources (buffers, textures, samplers, shader modules, pipelines, query pools, and acceleration structures) can be created, uploaded,
+// and destroyed from any thread. Command buffers are acquired, recorded, and submitted on one thread.
 class IContext {
  protected:
   IContext() = default;
@@ -1111,10 +1293,24 @@ class IContext {
  public:
   virtual ~IContext() = default;
 
-  virtual ICommandBuffer& acquireCommandBuffer() = 0;
+  // only one command buffer per queue can be acquired at a time
+  virtual ICommandBuffer& acquireCommandBuffer(QueueType queue = QueueType_Graphics) = 0;
 
   virtual SubmitHandle submit(ICommandBuffer& commandBuffer, TextureHandle present = {}) = 0;
   virtual void wait(SubmitHandle handle) = 0; // waiting on an empty handle results in vkDeviceWaitIdle()
+  // GPU-side cross-queue dependency: the next submit() to `queue` waits until the work of `handle` (from another queue) has completed.
+  // Resources used by async compute should be kept alive until its submit handle has completed.
+  virtual void gpuWait(QueueType queue, SubmitHandle handle) = 0;
+  // non-blocking check if the work of `handle` has been completed by the GPU
+  [[nodiscard]] virtual bool isReady(SubmitHandle handle) const = 0;
+
+  // Secondary command buffers can be recorded in parallel on worker threads (every thread gets its own command pool). Call
+  // endSecondaryCommandBuffer() on the recording thread and then cmdExecuteCommands() on the primary command buffer inside a render
+  // pass with `RenderPass::secondaryCommandBuffers = true`. Do not create or destroy resources while secondary recording is in progress:
+  // descriptor sets are updated by cmdBeginRendering() of the primary command buffer. Finished secondary command buffers which were not
+  // executed by the next submit() are recycled.
+  virtual ICommandBuffer& acquireSecondaryCommandBuffer(const RenderPass& renderPass, const Framebuffer& fb) = 0;
+  virtual void endSecondaryCommandBuffer(ICommandBuffer& commandBuffer) = 0;
 
   [[nodiscard]] virtual Holder<BufferHandle> createBuffer(const BufferDesc& desc,
                                                           const char* debugName = nullptr,
@@ -1133,12 +1329,23 @@ class IContext {
   [[nodiscard]] virtual Holder<RayTracingPipelineHandle> createRayTracingPipeline(const RayTracingPipelineDesc& desc,
                                                                                   Result* outResult = nullptr) = 0;
   [[nodiscard]] virtual Holder<ShaderModuleHandle> createShaderModule(const ShaderModuleDesc& desc, Result* outResult = nullptr) = 0;
+  // compile shader modules in parallel on the pipeline compiler threads; `outHandles` should have `numShaderModules` elements
+  virtual void createShaderModules(const ShaderModuleDesc* desc,
+                                   Holder<ShaderModuleHandle>* outHandles,
+                                   uint32_t numShaderModules,
+                                   Result* outResult = nullptr) = 0;
 
   [[nodiscard]] virtual Holder<QueryPoolHandle> createQueryPool(uint32_t numQueries,
                                                                 const char* debugName,
                                                                 Result* outResult = nullptr) = 0;
 
   [[nodiscard]] virtual Holder<AccelStructHandle> createAccelerationStructure(const AccelStructDesc& desc, Result* outResult = nullptr) = 0;
+  // build all BLASes in batches sharing scratch memory and compact the ones with AccelStructBuildFlagBits_AllowCompaction; TLASes are
+  // created afterwards one by one; `outHandles` should have `numAccelStructs` elements
+  virtual void createAccelerationStructures(const AccelStructDesc* desc,
+                                            Holder<AccelStructHandle>* outHandles,
+                                            uint32_t numAccelStructs,
+                                            Result* outResult = nullptr) = 0;
 
   virtual void destroy(ComputePipelineHandle handle) = 0;
   virtual void destroy(RenderPipelineHandle handle) = 0;
@@ -1149,10 +1356,24 @@ class IContext {
   virtual void destroy(TextureHandle handle) = 0;
   virtual void destroy(QueryPoolHandle handle) = 0;
   virtual void destroy(AccelStructHandle handle) = 0;
+  virtual void destroy(ReadbackHandle handle) = 0;
   virtual void destroy(Framebuffer& fb) = 0;
 
   [[nodiscard]] virtual uint64_t gpuAddress(AccelStructHandle handle) const = 0;
 
+#pragma region Pipeline prewarming
+  // Compile pipelines on background threads ahead of their first use, so that binding them does not stall the render thread. A render
+  // pipeline is compiled for the multiview `viewMask` of the render pass it is going to be used with. Binding a pipeline which is still
+  // compiling behaves according to its `notReady` policy. Shader modules have to be kept alive until the compilation has finished.
+  virtual void prewarm(RenderPipelineHandle handle, uint32_t viewMask = 0) = 0;
+  virtual void prewarm(ComputePipelineHandle handle) = 0;
+  virtual void prewarm(RayTracingPipelineHandle handle) = 0;
+  // non-blocking check if a pipeline has been compiled and can be bound without waiting
+  [[nodiscard]] virtual bool isReady(RenderPipelineHandle handle) const = 0;
+  [[nodiscard]] virtual bool isReady(ComputePipelineHandle handle) const = 0;
+  [[nodiscard]] virtual bool isReady(RayTracingPipelineHandle handle) const = 0;
+#pragma endregion
+
 #pragma region Acceleration structure functions
   [[nodiscard]] virtual AccelStructSizes getAccelStructSizes(const AccelStructDesc& desc, Result* outResult = nullptr) const = 0;
 #pragma endregion
@@ -1166,6 +1387,45 @@ class IContext {
   [[nodiscard]] virtual uint32_t getMaxStorageBufferRange() const = 0;
 #pragma endregion
 
+#pragma region Asynchronous uploads
+  // The data is copied into staging memory before returning and the copies run on a dedicated transfer queue (when the device has one)
+  // without stalling the CPU. Call gpuWait(QueueType_Graphics, handle) before using the resource on the graphics queue or poll isReady().
+  // Resources have to be kept alive until the returned submit handle has completed. Only resources created with `isShared` are uploaded
+  // asynchronously when the transfer queue belongs to another queue family; other resources are uploaded on the graphics queue, and so
+  // are texture ranges not covering whole mip-levels if the transfer queue has a coarse minImageTransferGranularity. When the staging
+  // memory is full, nothing is uploaded and `outResult` is set to Result::Code::Pending: call it again later.
+  virtual SubmitHandle uploadAsync(BufferHandle handle, const void* data, size_t size, size_t offset = 0, Result* outResult = nullptr) = 0;
+  virtual SubmitHandle uploadAsync(TextureHandle handle,
+                                   const TextureRangeDesc& range,
+                                   const void* data,
+                                   uint32_t bufferRowLength = 0,
+                                   Result* outResult = nullptr) = 0;
+#pragma endregion
+
+#pragma region Asynchronous readbacks
+  // Copy the contents as seen by all previously submitted command buffers into host-visible memory and return without waiting for the
+  // GPU. Poll isReady() a few frames later and access the data with getReadbackData(); it stays valid until the handle is destroyed.
+  // Textures are read back one mip-level at a time (all requested layers are tightly packed one after another).
+  [[nodiscard]] virtual Holder<ReadbackHandle> readbackAsync(BufferHandle handle,
+                                                             size_t size,
+                                                             size_t offset = 0,
+                                                             Result* outResult = nullptr) = 0;
+  [[nodiscard]] virtual Holder<ReadbackHandle> readbackAsync(TextureHandle handle,
+                                                             const TextureRangeDesc& range,
+                                                             Result* outResult = nullptr) = 0;
+  [[nodiscard]] virtual bool isReady(ReadbackHandle handle) const = 0;
+  // returns nullptr if the copy has not completed yet; never waits
+  [[nodiscard]] virtual const void* getReadbackData(ReadbackHandle handle, size_t* outSize = nullptr) = 0;
+#pragma endregion
+
+#pragma region Transient allocations
+  // Bump-allocate host-visible memory for per-frame data such as uniforms, dynamic vertices or indirect commands. The memory is valid
+  // until the GPU has finished executing the command buffers being recorded at the time of the allocation and the next command buffer
+  // submitted to the graphics or compute queue; it is recycled automatically after that. The alignment is raised to the uniform and
+  // storage buffer offset alignments of the device.
+  [[nodiscard]] virtual TransientAllocation allocateTransient(size_t size, size_t alignment = 16) = 0;
+#pragma endregion
+
 #pragma region Texture functions
   // `data` contains mip-levels and layers as in https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html
   virtual Result upload(TextureHandle handle, const TextureRangeDesc& range, const void* data, uint32_t bufferRowLength = 0) = 0;
@@ -1173,6 +1433,8 @@ class IContext {
   [[nodiscard]] virtual Dimensions getDimensions(TextureHandle handle) const = 0;
   [[nodiscard]] virtual float getAspectRatio(TextureHandle handle) const = 0;
   [[nodiscard]] virtual Format getFormat(TextureHandle handle) const = 0;
+  // the format can be used for sampled textures with optimal tiling (e.g. to pick BC7 or ASTC for compressed textures)
+  [[nodiscard]] virtual bool isTextureFormatSupported(Format format) const = 0;
 #pragma endregion
 
   virtual TextureHandle getCurrentSwapchainTexture() = 0;
@@ -1184,11 +1446,43 @@ class IContext {
   [[nodiscard]] virtual bool setCurrentPresentMode(PresentMode mode) = 0; // VK_KHR_swapchain_maintenance1
   [[nodiscard]] virtual PresentMode getCurrentPresentMode() const = 0;
 
+#pragma region Frame pacing
+  // Call right before sampling input: sleeps until the CPU is at most `maxFramesInFlight` frames ahead of presentation (see
+  // ContextConfig::enableLowLatency). Does nothing without a swapchain
+  virtual void waitForNextFrame() = 0;
+  // 0 means as many as there are swapchain images
+  virtual void setMaxFramesInFlight(uint32_t maxFramesInFlight) = 0;
+  // returns false if no frame has been presented yet
+  virtual bool getPresentTimings(PresentTimings& outTimings) const = 0;
+#pragma endregion
+
   // MSAA level is supported if ((samples & bitmask) != 0), where samples must be power of two.
   virtual uint32_t getFramebufferMSAABitMask() const = 0;
 
   virtual bool isExtensionEnabled(const char* ext) const = 0;
 
+#pragma region Memory budget
+  virtual void getMemoryStats(MemoryStats& outStats) const = 0;
+  // `threshold` is a fraction of MemoryHeapStats::budget; the callback can destroy resources (e.g. evict texture mip-levels) before the
+  // driver starts paging. Pass nullptr to remove the callback
+  virtual void setMemoryBudgetCallback(MemoryBudgetCallback callback, void* userData, float threshold = 0.9f) = 0;
+#pragma endregion
+
+#pragma region Sparse textures
+  // TextureDesc::sparse needs sparseBinding, sparseResidencyImage2D, and shaderResourceResidency on a graphics queue with sparse binding
+  [[nodiscard]] virtual bool isSparseResidencySupported() const = 0;
+  [[nodiscard]] virtual SparseTextureInfo getSparseTextureInfo(TextureHandle handle) const = 0;
+  // Back the `bind` pages with memory from the page pool and return the memory of the `unbind` pages into the pool. The new bindings take
+  // effect on the GPU after all previously submitted command buffers have completed, and before the next ones start. The contents of
+  // newly bound pages are undefined until uploaded (upload() or uploadAsync() with page-aligned ranges). Keep the coarser pages of every
+  // bound page resident, so textureBindless2DSparse() has something to fall back to.
+  virtual Result updateSparsePages(TextureHandle handle,
+                                   const SparsePage* bind,
+                                   uint32_t numBind,
+                                   const SparsePage* unbind = nullptr,
+                                   uint32_t numUnbind = 0) = 0;
+#pragma endregion
+
 #pragma region Performance queries
   virtual double getTimestampPeriodToMs() const = 0;
   virtual bool getQueryPoolResults(QueryPoolHandle pool,
@@ -1197,6 +1491,12 @@ class IContext {
                                    size_t dataSize,
                                    void* outData,
                                    size_t stride) const = 0;
+  // the number of times uploads had to wait for the GPU to recycle staging memory
+  [[nodiscard]] virtual uint32_t getNumStagingStalls() const = 0;
+  // the most recent frame whose GPU timings are available; a frame ends with a present (or with every submit when headless).
+  // Never waits for the GPU and returns false if no frame has been completed yet
+  virtual bool getFrameStats(FrameStats& outStats) const = 0;
+  virtual void getCreationStats(CreationStats& outStats) const = 0;
 #pragma endregion
 };
 
@@ -1224,6 +1524,9 @@ struct ContextConfig {
   // owned by the application - should be alive until createVulkanContextWithSwapchain() returns
   const void* pipelineCacheData = nullptr;
   size_t pipelineCacheDataSize = 0;
+  // persistent pipeline cache file, keyed by the GPU and driver version; ignored if `pipelineCacheData` is provided (the string is copied)
+  const char* pipelineCacheFileName = nullptr;
+  uint32_t pipelineCacheSaveIntervalSec = 60; // 0 saves the pipeline cache file only when the context is destroyed
   // Define preferred present modes, the first available present mode will  be used. PresentMode_FIFO is always available
   lvk::PresentMode presentModes[kMaxPresentModes] = {
 #if defined(__linux__) || defined(_M_ARM64)
@@ -1240,8 +1543,34 @@ struct ContextConfig {
 
   // LVK knows about these extensions and can manage them automatically upon request
   bool enableHeadlessSurface = false; // VK_EXT_headless_surface
-
-  uint64_t maxStagingBufferSize = 128ull * 1024ull * 1024ull; // a reasonable default
+  // store bindless descriptors in a host-visible descriptor buffer; falls back to descriptor sets if unsupported
+  bool enableDescriptorBuffer = false; // VK_EXT_descriptor_buffer
+  // set cull mode, front face, topology, polygon mode, sample count and color blending at draw time; render pipelines which differ only
+  // in these fields share one VkPipeline (topologies are shared within their class: points, lines, triangles, patches)
+  bool enableExtendedDynamicState3 = false; // VK_EXT_extended_dynamic_state3
+  // IContext::waitForNextFrame() waits for the actual presentation (VK_KHR_present_id + VK_KHR_present_wait) and lets the driver pick
+  // the moment to start the frame (VK_NV_low_latency2); falls back to waiting for the GPU to finish the frame if unsupported
+  bool enableLowLatency = false;
+  uint32_t maxFramesInFlight = 0; // how many frames the CPU can run ahead of presentation; 0 means as many as there are swapchain images
+
+  uint64_t maxStagingBufferSize = 128ull * 1024ull * 1024ull; // a reasonable default; the maximal size of one staging block
+  uint32_t maxStagingBufferBlocks = 4; // staging memory can grow up to (maxStagingBufferBlocks * maxStagingBufferSize) bytes
+  uint64_t transientChunkSize = 4ull * 1024ull * 1024ull; // IContext::allocateTransient() grows by chunks of this size
+  // per queue; when all of them are in flight, acquiring a command buffer blocks until the GPU retires the oldest one
+  uint32_t maxCommandBuffers = LVK_MAX_COMMAND_BUFFERS;
+
+  // bindless capacity reserved upfront (clamped by device limits) so that creating new resources does not change the descriptor
+  // set layout; exceeding it grows the layout and rebuilds all pipelines
+  uint32_t maxBindlessTextures = 16384;
+  uint32_t maxBindlessSamplers = 1024;
+  uint32_t maxBindlessAccelStructs = 256;
+
+  // cache SPIR-V compiled from GLSL and Slang sources in memory; and on disk in the existing `shaderCacheDirectory` if set
+  bool enableShaderCache = false;
+  const char* shaderCacheDirectory = nullptr;
+
+  // background threads used by IContext::prewarm() and IContext::createShaderModules(); 0 compiles synchronously
+  uint32_t numPipelineCompilerThreads = 2;
 };
 
 [[nodiscard]] bool isDepthOrStencilFormat(lvk::Format format);
@@ -1249,6 +1578,9 @@ struct ContextConfig {
 [[nodiscard]] uint32_t getTextureBytesPerLayer(uint32_t width, uint32_t height, lvk::Format format, uint32_t level);
 [[nodiscard]] uint32_t getTextureBytesPerPlane(uint32_t width, uint32_t height, lvk::Format format, uint32_t plane);
 [[nodiscard]] uint32_t getVertexFormatSize(lvk::VertexFormat format);
+// the index of a page in the feedback bitmask and the inverse mapping (see SparseTextureInfo)
+[[nodiscard]] uint32_t getSparsePageIndex(const SparseTextureInfo& info, const SparsePage& page);
+[[nodiscard]] SparsePage getSparsePage(const SparseTextureInfo& info, uint32_t pageIndex);
 void logShaderSource(const char* text);
 
 constexpr uint32_t calcNumMipLevels(uint32_t width, uint32_t height) {
@@ -1,7 +1,9 @@
 ﻿#pragma once
 
 #include <assert.h>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "lvk/LVK.h"
@@ -9,54 +11,172 @@
 /// Pool<> is used only by the implementation
 namespace lvk {
 
+/// Pool<> is thread-safe: objects can be created and destroyed from any thread. Objects live in fixed-size pages which are never
+/// reallocated, so get() does not lock anything and the returned pointers stay valid while other threads create new objects.
+/// The hot per-slot metadata (generations and the free list) is stored apart from the objects: a release get() touches only the object.
 template<typename ObjectType, typename ImplObjectType>
 class Pool {
   static constexpr uint32_t kListEndSentinel = 0xffffffff;
+  static constexpr uint32_t kPageSizeLog2 = 8; // 256 objects per page
+  static constexpr uint32_t kPageSize = 1u << kPageSizeLog2;
+  static constexpr uint32_t kMaxPages = 1024;
   struct PoolEntry {
-    explicit PoolEntry(ImplObjectType& obj) : obj_(std::move(obj)) {}
     ImplObjectType obj_ = {};
+  };
+  struct Metadata {
     uint32_t gen_ = 1;
     uint32_t nextFree_ = kListEndSentinel;
   };
+  // a std::vector-like container with stable addresses; only the owning Pool<> can add or remove elements
+  template<typename T>
+  class PagedArray {
+   public:
+    template<typename ArrayType, typename ElementType>
+    class Iterator {
+     public:
+      Iterator(ArrayType* array, size_t index) : array_(array), index_(index) {}
+      ElementType& operator*() const {
+        return (*array_)[index_];
+      }
+      Iterator& operator++() {
+        index_++;
+        return *this;
+      }
+      bool operator!=(const Iterator& other) const {
+        return index_ != other.index_;
+      }
+
+     private:
+      ArrayType* array_ = nullptr;
+      size_t index_ = 0;
+    };
+
+    PagedArray() = default;
+    ~PagedArray() {
+      clear();
+    }
+    PagedArray(const PagedArray&) = delete;
+    PagedArray& operator=(const PagedArray&) = delete;
+
+    size_t size() const {
+      return size_.load(std::memory_order_acquire);
+    }
+    bool empty() const {
+      return size() == 0;
+    }
+    T& operator[](size_t index) {
+      return pages_[index >> kPageSizeLog2].load(std::memory_order_acquire)[index & (kPageSize - 1)];
+    }
+    const T& operator[](size_t index) const {
+      return pages_[index >> kPageSizeLog2].load(std::memory_order_acquire)[index & (kPageSize - 1)];
+    }
+    T& front() {
+      return (*this)[0];
+    }
+    const T& front() const {
+      return (*this)[0];
+    }
+    Iterator<PagedArray, T> begin() {
+      return {this, 0};
+    }
+    Iterator<PagedArray, T> end() {
+      return {this, size()};
+    }
+    Iterator<const PagedArray, const T> begin() const {
+      return {this, 0};
+    }
+    Iterator<const PagedArray, const T> end() const {
+      return {this, size()};
+    }
+
+   private:
+    friend class Pool;
+    bool isFull() const {
+      return size() == kMaxPages * kPageSize;
+    }
+    T& push_back() {
+      const uint32_t index = size_.load(std::memory_order_relaxed);
+      std::atomic<T*>& page = pages_[index >> kPageSizeLog2];
+      if (!page.load(std::memory_order_relaxed)) {
+        page.store(new T[kPageSize], std::memory_order_release);
+      }
+      size_.store(index + 1, std::memory_order_release);
+      return (*this)[index];
+    }
+    void clear() {
+      for (std::atomic<T*>& page : pages_) {
+        delete[] page.exchange(nullptr);
+      }
+      size_.store(0, std::memory_order_release);
+    }
+
+   private:
+    std::atomic<T*> pages_[kMaxPages] = {};
+    std::atomic<uint32_t> size_ = 0;
+  };
+  mutable std::mutex mutex_;
   uint32_t freeListHead_ = kListEndSentinel;
-  uint32_t numObjects_ = 0;
+  std::atomic<uint32_t> numObjects_ = 0;
+  PagedArray<Metadata> metadata_;
 
  public:
-  std::vector<PoolEntry> objects_;
+  PagedArray<PoolEntry> objects_;
 
+  // returns an empty handle if the pool is full
   Handle<ObjectType> create(ImplObjectType&& obj) {
+    std::lock_guard lock(mutex_);
     uint32_t idx = 0;
     if (freeListHead_ != kListEndSentinel) {
       idx = freeListHead_;
-      freeListHead_ = objects_[idx].nextFree_;
-      objects_[idx].obj_ = std::move(obj);
+      freeListHead_ = metadata_[idx].nextFree_;
     } else {
+      if (objects_.isFull()) {
+        LVK_ASSERT_MSG(false, "The pool is full (%u objects)", kMaxPages * kPageSize);
+        LLOGW("The pool is full (%u objects)\n", kMaxPages * kPageSize);
+        return {};
+      }
       idx = (uint32_t)objects_.size();
-      objects_.emplace_back(obj);
+      // metadata goes first: a slot becomes visible to other threads when `objects_` grows
+      metadata_.push_back();
+      objects_.push_back();
     }
+    objects_[idx].obj_ = std::move(obj);
     numObjects_++;
-    return Handle<ObjectType>(idx, objects_[idx].gen_);
+    return Handle<ObjectType>(idx, metadata_[idx].gen_);
   }
   void destroy(Handle<ObjectType> handle) {
     if (handle.empty())
       return;
+    invalidate(handle);
+    recycle(handle.index());
+  }
+  // destroys the object but keeps its slot out of the free list until recycle() is called
+  void invalidate(Handle<ObjectType> handle) {
+    if (handle.empty())
+      return;
+    std::lock_guard lock(mutex_);
     assert(numObjects_ > 0); // double deletion
     const uint32_t index = handle.index();
     assert(index < objects_.size());
-    assert(handle.gen() == objects_[index].gen_); // double deletion
+    assert(handle.gen() == metadata_[index].gen_); // double deletion
     objects_[index].obj_ = ImplObjectType{};
-    objects_[index].gen_++;
-    objects_[index].nextFree_ = freeListHead_;
-    freeListHead_ = index;
+    metadata_[index].gen_++;
     numObjects_--;
   }
+  void recycle(uint32_t index) {
+    std::lock_guard lock(mutex_);
+    if (index >= objects_.size())
+      return; // the pool was cleared
+    metadata_[index].nextFree_ = freeListHead_;
+    freeListHead_ = index;
+  }
   const ImplObjectType* get(Handle<ObjectType> handle) const {
     if (handle.empty())
       return nullptr;
 
     const uint32_t index = handle.index();
     assert(index < objects_.size());
-    assert(handle.gen() == objects_[index].gen_); // accessing deleted object
+    assert(handle.gen() == metadata_[index].gen_); // accessing deleted object
     return &objects_[index].obj_;
   }
   ImplObjectType* get(Handle<ObjectType> handle) {
@@ -65,7 +185,7 @@ class Pool {
 
     const uint32_t index = handle.index();
     assert(index < objects_.size());
-    assert(handle.gen() == objects_[index].gen_); // accessing deleted object
+    assert(handle.gen() == metadata_[index].gen_); // accessing deleted object
     return &objects_[index].obj_;
   }
   Handle<ObjectType> getHandle(uint32_t index) const {
@@ -73,22 +193,26 @@ class Pool {
     if (index >= objects_.size())
       return {};
 
-    return Handle<ObjectType>(index, objects_[index].gen_);
+    return Handle<ObjectType>(index, metadata_[index].gen_);
   }
   Handle<ObjectType> findObject(const ImplObjectType* obj) {
     if (!obj)
       return {};
 
+    std::lock_guard lock(mutex_);
+
     for (size_t idx = 0; idx != objects_.size(); idx++) {
       if (objects_[idx].obj_ == *obj) {
-        return Handle<ObjectType>((uint32_t)idx, objects_[idx].gen_);
+        return Handle<ObjectType>((uint32_t)idx, metadata_[idx].gen_);
       }
     }
 
     return {};
   }
   void clear() {
+    std::lock_guard lock(mutex_);
     objects_.clear();
+    metadata_.clear();
     freeListHead_ = kListEndSentinel;
     numObjects_ = 0;
   }
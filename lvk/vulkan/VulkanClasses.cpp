@@ -5,7 +5,18 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
 #include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #define VMA_IMPLEMENTATION
@@ -39,7 +50,7 @@
 #include <malloc.h>
 #endif
 
-uint32_t lvk::VulkanPipelineBuilder::numPipelinesCreated_ = 0;
+std::atomic<uint32_t> lvk::VulkanPipelineBuilder::numPipelinesCreated_ = 0;
 
 static_assert(lvk::HWDeviceDesc::LVK_MAX_PHYSICAL_DEVICE_NAME_SIZE == VK_MAX_PHYSICAL_DEVICE_NAME_SIZE);
 static_assert(lvk::Swizzle_Default == (uint32_t)VK_COMPONENT_SWIZZLE_IDENTITY);
@@ -69,15 +80,338 @@ enum Bindings {
 
 const uint32_t kDescriptorSet_InputAttachments = 4; // for VkDescriptorSetLayout in getVkPipeline()
 
+VkShaderStageFlags getBindlessShaderStageFlags(bool hasRayTracingPipeline) {
+  VkShaderStageFlags stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT |
+                                  VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+  if (hasRayTracingPipeline) {
+    stageFlags |= (VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_ANY_HIT_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
+                   VK_SHADER_STAGE_MISS_BIT_KHR | VK_SHADER_STAGE_INTERSECTION_BIT_KHR | VK_SHADER_STAGE_CALLABLE_BIT_KHR);
+  }
+  return stageFlags;
+}
+
 VkDeviceSize getAlignedSize(uint64_t value, uint64_t alignment) {
   return (value + alignment - 1) & ~(alignment - 1);
 }
 
+struct DescriptorRange {
+  uint32_t first = 0;
+  uint32_t count = 0;
+};
+
+// sort the dirty pool slots and coalesce them into contiguous ranges of descriptors
+void getDirtyDescriptorRanges(std::vector<uint32_t>& indices, std::vector<DescriptorRange>& outRanges) {
+  std::sort(indices.begin(), indices.end());
+
+  for (uint32_t idx : indices) {
+    if (!outRanges.empty() && idx < outRanges.back().first + outRanges.back().count) {
+      continue; // duplicate
+    }
+    if (!outRanges.empty() && idx == outRanges.back().first + outRanges.back().count) {
+      outRanges.back().count++;
+    } else {
+      outRanges.push_back({idx, 1});
+    }
+  }
+
+  indices.clear();
+}
+
 uint64_t getAlignedAddress(uint64_t addr, uint64_t align) {
   const uint64_t offs = addr % align;
   return offs ? addr + (align - offs) : addr;
 }
 
+bool isPipelineCompiled(const std::shared_future<VkPipeline>& future) {
+  return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// returns VK_NULL_HANDLE if the pipeline is still being compiled and the policy does not allow waiting for it
+VkPipeline takeCompiledPipeline(std::shared_future<VkPipeline>& future, lvk::PipelineNotReady notReady) {
+  if (notReady != lvk::PipelineNotReady_Wait && !isPipelineCompiled(future)) {
+    return VK_NULL_HANDLE;
+  }
+
+  const VkPipeline pipeline = future.get();
+
+  future = {};
+
+  return pipeline;
+}
+
+// the pools can be reallocated while a pipeline is being compiled, so background compilation tasks own copies of the shader module
+// states: copy them into a storage owned by the task and repoint the array to the copies
+void copyShaderModules(std::vector<lvk::ShaderModuleState>& copies, const lvk::ShaderModuleState** modules, size_t numModules) {
+  for (size_t i = 0; i != numModules; i++) {
+    if (modules[i]) {
+      LVK_ASSERT(copies.size() < copies.capacity()); // no reallocations allowed
+      copies.push_back(*modules[i]);
+      modules[i] = &copies.back();
+    }
+  }
+}
+
+// a pipeline cache blob is only valid for the exact GPU and driver which created it
+struct PipelineCacheFileHeader {
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t vendorID = 0;
+  uint32_t deviceID = 0;
+  uint32_t driverVersion = 0;
+  uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+  uint32_t reserved = 0; // no implicit padding - the header is compared with memcmp()
+  uint64_t dataSize = 0;
+};
+
+static_assert(sizeof(PipelineCacheFileHeader) == 48);
+
+const uint32_t kPipelineCacheFileMagic = 0x4350564C; // "LVPC"
+const uint32_t kPipelineCacheFileVersion = 1;
+
+PipelineCacheFileHeader getPipelineCacheFileHeader(const VkPhysicalDeviceProperties& props, uint64_t dataSize) {
+  PipelineCacheFileHeader header = {
+      .magic = kPipelineCacheFileMagic,
+      .version = kPipelineCacheFileVersion,
+      .vendorID = props.vendorID,
+      .deviceID = props.deviceID,
+      .driverVersion = props.driverVersion,
+      .dataSize = dataSize,
+  };
+  memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+  return header;
+}
+
+std::vector<uint8_t> loadPipelineCacheFile(const char* fileName, const VkPhysicalDeviceProperties& props) {
+  LVK_PROFILER_FUNCTION();
+
+  FILE* file = fopen(fileName, "rb");
+
+  if (!file) {
+    return {};
+  }
+
+  SCOPE_EXIT {
+    fclose(file);
+  };
+
+  PipelineCacheFileHeader header = {};
+
+  if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != kPipelineCacheFileMagic ||
+      header.version != kPipelineCacheFileVersion) {
+    LLOGW("Ignoring invalid pipeline cache file `%s`\n", fileName);
+    return {};
+  }
+
+  const PipelineCacheFileHeader expected = getPipelineCacheFileHeader(props, header.dataSize);
+
+  if (memcmp(&header, &expected, sizeof(header)) != 0) {
+    LLOGL("Pipeline cache file `%s` was created by a different GPU or driver\n", fileName);
+    return {};
+  }
+
+  // do not trust the header with the allocation size
+  const long fileSize = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+
+  if (fileSize < 0 || uint64_t(fileSize) != sizeof(header) + header.dataSize || fseek(file, sizeof(header), SEEK_SET) != 0) {
+    LLOGW("Pipeline cache file `%s` has an invalid size\n", fileName);
+    return {};
+  }
+
+  std::vector<uint8_t> data(header.dataSize);
+
+  if (fread(data.data(), 1, data.size(), file) != data.size()) {
+    LLOGW("Pipeline cache file `%s` is truncated\n", fileName);
+    return {};
+  }
+
+  return data;
+}
+
+// write into a temporary file and rename it, so that a crash in the middle never leaves a corrupted file behind
+bool writeFileAtomically(const char* fileName, const void* header, size_t headerSize, const void* data, size_t dataSize) {
+  // the same file can be written from multiple threads
+  const std::string tmpFileName =
+      std::string(fileName) + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+  FILE* file = fopen(tmpFileName.c_str(), "wb");
+
+  if (!file) {
+    LLOGW("Cannot write file `%s`\n", tmpFileName.c_str());
+    return false;
+  }
+
+  const bool success = fwrite(header, 1, headerSize, file) == headerSize && fwrite(data, 1, dataSize, file) == dataSize;
+
+  if (fclose(file) != 0 || !success) {
+    LLOGW("Cannot write file `%s`\n", tmpFileName.c_str());
+    remove(tmpFileName.c_str());
+    return false;
+  }
+
+#if defined(_WIN32)
+  // rename() does not replace existing files on Windows
+  remove(fileName);
+#endif // _WIN32
+
+  if (rename(tmpFileName.c_str(), fileName) != 0) {
+    LLOGW("Cannot rename `%s` into `%s`\n", tmpFileName.c_str(), fileName);
+    remove(tmpFileName.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool savePipelineCacheFile(const std::string& fileName, const VkPhysicalDeviceProperties& props, const std::vector<uint8_t>& data) {
+  LVK_PROFILER_FUNCTION();
+
+  const PipelineCacheFileHeader header = getPipelineCacheFileHeader(props, data.size());
+
+  return writeFileAtomically(fileName.c_str(), &header, sizeof(header), data.data(), data.size());
+}
+
+uint64_t hashFNV1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i != size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// with VK_EXT_extended_dynamic_state3, pipelines can be shared when everything except the dynamic state is equal
+std::string getStaticRenderPipelineStateKey(const lvk::RenderPipelineState& rps) {
+  const lvk::RenderPipelineDesc& desc = rps.desc_;
+
+  std::string key;
+  key.append((const char*)rps.vkBindings_, rps.numBindings_ * sizeof(VkVertexInputBindingDescription));
+  key.append((const char*)rps.vkAttributes_, rps.numAttributes_ * sizeof(VkVertexInputAttributeDescription));
+
+  // append individual fields to skip the struct padding
+  auto appendValue = [&key](const auto& value) { key.append((const char*)&value, sizeof(value)); };
+
+  // without dynamicPrimitiveTopologyUnrestricted, the dynamic topology has to be of the same class as the static one
+  const lvk::Topology topologyClass = desc.topology == lvk::Topology_LineStrip       ? lvk::Topology_Line
+                                      : desc.topology == lvk::Topology_TriangleStrip ? lvk::Topology_Triangle
+                                                                                     : desc.topology;
+  appendValue(topologyClass);
+
+  for (const lvk::ShaderModuleHandle sm : {desc.smVert, desc.smTesc, desc.smTese, desc.smGeom, desc.smTask, desc.smMesh, desc.smFrag}) {
+    appendValue(sm.index());
+    appendValue(sm.gen());
+  }
+  for (const char* entryPoint : {desc.entryPointVert,
+                                 desc.entryPointTesc,
+                                 desc.entryPointTese,
+                                 desc.entryPointGeom,
+                                 desc.entryPointTask,
+                                 desc.entryPointMesh,
+                                 desc.entryPointFrag}) {
+    // the terminating zero keeps adjacent strings apart
+    key.append(entryPoint ? entryPoint : "").push_back('\0');
+  }
+
+  const uint32_t numSpecConstants = desc.specInfo.getNumSpecializationConstants();
+  for (uint32_t i = 0; i != numSpecConstants; i++) {
+    appendValue(desc.specInfo.entries[i].constantId);
+    appendValue(desc.specInfo.entries[i].offset);
+    appendValue(desc.specInfo.entries[i].size);
+  }
+  if (desc.specInfo.data) {
+    key.append((const char*)desc.specInfo.data, desc.specInfo.dataSize);
+  }
+
+  const uint32_t numColorAttachments = desc.getNumColorAttachments();
+  for (uint32_t i = 0; i != numColorAttachments; i++) {
+    appendValue(desc.color[i].format);
+  }
+  appendValue(desc.depthFormat);
+  appendValue(desc.stencilFormat);
+
+  for (const lvk::StencilState& s : {desc.backFaceStencil, desc.frontFaceStencil}) {
+    appendValue(s.stencilFailureOp);
+    appendValue(s.depthFailureOp);
+    appendValue(s.depthStencilPassOp);
+    appendValue(s.stencilCompareOp);
+    appendValue(s.readMask);
+    appendValue(s.writeMask);
+  }
+
+  appendValue(desc.patchControlPoints);
+  appendValue(desc.minSampleShading);
+
+  return key;
+}
+
+// the full key is stored after the header and compared on load - the hash only names the file
+struct ShaderCacheFileHeader {
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t hash = 0;
+  uint64_t keySize = 0;
+  uint64_t dataSize = 0;
+};
+
+static_assert(sizeof(ShaderCacheFileHeader) == 32);
+
+const uint32_t kShaderCacheFileMagic = 0x4353564C; // "LVSC"
+const uint32_t kShaderCacheFileVersion = 2;
+
+std::string getShaderCacheFileName(const char* directory, uint64_t key) {
+  char fileName[32] = {};
+  snprintf(fileName, sizeof(fileName), "%016" PRIx64 ".spv", key);
+  return std::string(directory) + "/" + fileName;
+}
+
+bool loadShaderCacheFile(const char* directory, const std::string& key, std::vector<uint8_t>& outSPIRV) {
+  LVK_PROFILER_FUNCTION();
+
+  const uint64_t hash = hashFNV1a(key.data(), key.size());
+
+  FILE* file = fopen(getShaderCacheFileName(directory, hash).c_str(), "rb");
+
+  if (!file) {
+    return false;
+  }
+
+  SCOPE_EXIT {
+    fclose(file);
+  };
+
+  ShaderCacheFileHeader header = {};
+
+  if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != kShaderCacheFileMagic ||
+      header.version != kShaderCacheFileVersion || header.hash != hash || header.keySize != key.size() || !header.dataSize ||
+      header.dataSize % sizeof(uint32_t)) {
+    return false;
+  }
+
+  std::string storedKey(key.size(), '\0');
+
+  if (fread(storedKey.data(), 1, storedKey.size(), file) != storedKey.size() || storedKey != key) {
+    // a hash collision
+    return false;
+  }
+
+  outSPIRV.resize(header.dataSize);
+
+  return fread(outSPIRV.data(), 1, outSPIRV.size(), file) == outSPIRV.size();
+}
+
+void saveShaderCacheFile(const char* directory, const std::string& key, const std::vector<uint8_t>& spirv) {
+  const ShaderCacheFileHeader header = {
+      .magic = kShaderCacheFileMagic,
+      .version = kShaderCacheFileVersion,
+      .hash = hashFNV1a(key.data(), key.size()),
+      .keySize = key.size(),
+      .dataSize = spirv.size(),
+  };
+
+  std::vector<uint8_t> data(key.begin(), key.end());
+  data.insert(data.end(), spirv.begin(), spirv.end());
+
+  writeFileAtomically(getShaderCacheFileName(directory, header.hash).c_str(), &header, sizeof(header), data.data(), data.size());
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL vulkanDebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT msgSeverity,
                                                    [[maybe_unused]] VkDebugUtilsMessageTypeFlagsEXT msgType,
                                                    const VkDebugUtilsMessengerCallbackDataEXT* cbData,
@@ -631,6 +965,22 @@ bool isHostVisibleSingleHeapMemory(VkPhysicalDevice physDev) {
   return false;
 }
 
+bool hasLazilyAllocatedMemory(VkPhysicalDevice physDev) {
+  VkPhysicalDeviceMemoryProperties2 props = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+  };
+
+  vkGetPhysicalDeviceMemoryProperties2(physDev, &props);
+
+  for (uint32_t i = 0; i < props.memoryProperties.memoryTypeCount; i++) {
+    if (props.memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 void getDeviceExtensionProps(VkPhysicalDevice dev, std::vector<VkExtensionProperties>& props, const char* validationLayer = nullptr) {
   uint32_t numExtensions = 0;
   vkEnumerateDeviceExtensionProperties(dev, validationLayer, &numExtensions, nullptr);
@@ -647,19 +997,81 @@ bool hasExtension(const char* ext, const std::vector<VkExtensionProperties>& pro
   return false;
 }
 
-void transitionToColorAttachment(VkCommandBuffer buffer, lvk::VulkanImage* colorTex) {
+bool isValidColorAttachment(const lvk::VulkanImage* colorTex) {
   if (!LVK_VERIFY(colorTex)) {
-    return;
+    return false;
   }
 
   if (!LVK_VERIFY(!colorTex->isDepthFormat_ && !colorTex->isStencilFormat_)) {
     LVK_ASSERT_MSG(false, "Color attachments cannot have depth/stencil formats");
-    return;
+    return false;
   }
   LVK_ASSERT_MSG(colorTex->vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid color attachment format");
-  colorTex->transitionLayout(buffer,
-                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                             VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+
+  return true;
+}
+
+// an attachment which is not loaded can be transitioned from VK_IMAGE_LAYOUT_UNDEFINED, which is required after its memory was aliased
+void discardAliasedContents(const lvk::VulkanImage& image, lvk::LoadOp loadOp) {
+  if (image.isMemoryAliased_ && loadOp != lvk::LoadOp_Load) {
+    image.vkImageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+}
+
+bool isReadOnlyImageLayout(VkImageLayout layout) {
+  return layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL || layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL ||
+         layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL || layout == VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL;
+}
+
+// only writes have to be made available; prior reads are covered by the execution dependency
+VkAccessFlags2 getWriteAccessMask(VkAccessFlags2 access) {
+  return access & (VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+                   VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT |
+                   VK_ACCESS_2_MEMORY_WRITE_BIT | VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
+}
+
+VkAccessFlags2 getBufferSrcAccessMask(VkPipelineStageFlags2 srcStage) {
+  if (srcStage & VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT) {
+    return VK_ACCESS_2_MEMORY_WRITE_BIT;
+  }
+
+  VkAccessFlags2 access = 0;
+
+  if (srcStage & VK_PIPELINE_STAGE_2_TRANSFER_BIT) {
+    access |= VK_ACCESS_2_TRANSFER_WRITE_BIT;
+  }
+  if (srcStage & ~(VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT)) {
+    access |= VK_ACCESS_2_SHADER_WRITE_BIT;
+  }
+
+  return access;
+}
+
+VkAccessFlags2 getBufferDstAccessMask(VkPipelineStageFlags2 dstStage, VkBufferUsageFlags usage) {
+  VkAccessFlags2 access = 0;
+
+  if (dstStage & VK_PIPELINE_STAGE_2_TRANSFER_BIT) {
+    access |= VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+  }
+  if (dstStage & VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT) {
+    access |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+  }
+  if (dstStage & VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT) {
+    if (usage & VK_BUFFER_USAGE_INDEX_BUFFER_BIT) {
+      access |= VK_ACCESS_2_INDEX_READ_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT) {
+      access |= VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT;
+    }
+  }
+  if (dstStage & ~(VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT)) {
+    access |= VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+    if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+      access |= VK_ACCESS_2_UNIFORM_READ_BIT;
+    }
+  }
+
+  return access;
 }
 
 VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats,
@@ -725,14 +1137,86 @@ VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>
   return formats[0];
 }
 
+// every 8x8 workgroup reduces a 16x16 tile of the source level into up to 4 mip-levels using shared memory, so that
+// a full mip-chain needs only one dispatch (and one barrier) per 4 levels. Reads past the edges of the previous level are clamped
+// to its last row/column - the same as fetch() - so odd and non-square sizes match the blit path (use the texture without
+// TextureUsageBits_Storage to compare against it)
+const char* kMipmapComputeShader =
+    "#version 460\n"
+    "#extension GL_EXT_samplerless_texture_functions : require\n"
+    "layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;\n"
+    "layout (set = 0, binding = 0) uniform texture2D kSrc;\n"
+    "layout (set = 0, binding = 1) uniform writeonly image2D kDst[4];\n"
+    "layout (push_constant) uniform PushConstants {\n"
+    "  ivec2 srcSize;\n"
+    "  uint numLevels;\n"
+    "} pc;\n"
+    "shared vec4 tile[8][8];\n"
+    "vec4 fetch(ivec2 p) {\n"
+    "  return texelFetch(kSrc, min(p, pc.srcSize - 1), 0);\n"
+    "}\n"
+    "void store(uint level, ivec2 p, vec4 v) {\n"
+    "  if (level == 0) imageStore(kDst[0], p, v);\n"
+    "  else if (level == 1) imageStore(kDst[1], p, v);\n"
+    "  else if (level == 2) imageStore(kDst[2], p, v);\n"
+    "  else imageStore(kDst[3], p, v);\n"
+    "}\n"
+    "void main() {\n"
+    "  const ivec2 lid = ivec2(gl_LocalInvocationID.xy);\n"
+    "  const ivec2 gid = ivec2(gl_GlobalInvocationID.xy);\n"
+    "  ivec2 size = max(pc.srcSize >> 1, ivec2(1));\n"
+    "  vec4 v = 0.25 * (fetch(2 * gid) + fetch(2 * gid + ivec2(1, 0)) + fetch(2 * gid + ivec2(0, 1)) + fetch(2 * gid + ivec2(1, 1)));\n"
+    "  if (all(lessThan(gid, size))) store(0, gid, v);\n"
+    "  for (uint i = 1; i < pc.numLevels; i++) {\n"
+    "    tile[lid.y][lid.x] = v;\n"
+    "    barrier();\n"
+    "    const int s = 1 << (i - 1);\n"
+    "    const ivec2 prevSize = size;\n"
+    "    size = max(size >> 1, ivec2(1));\n"
+    "    if (((lid.x | lid.y) & (2 * s - 1)) == 0) {\n"
+    "      const ivec2 q = gid >> (i - 1);\n" // this invocation's texel in the previous level
+    "      const int dx = q.x + 1 < prevSize.x ? s : 0;\n"
+    "      const int dy = q.y + 1 < prevSize.y ? s : 0;\n"
+    "      v = 0.25 * (tile[lid.y][lid.x] + tile[lid.y][lid.x + dx] + tile[lid.y + dy][lid.x] + tile[lid.y + dy][lid.x + dx]);\n"
+    "      const ivec2 p = gid >> i;\n"
+    "      if (all(lessThan(p, size))) store(i, p, v);\n"
+    "    }\n"
+    "    barrier();\n"
+    "  }\n"
+    "}\n";
+
+const uint32_t kMipmapLevelsPerDispatch = 4;
+
+struct MipmapPushConstants {
+  int32_t srcSize[2];
+  uint32_t numLevels;
+};
+
+// the compute path writes mip-levels as storage images and averages them as floats, otherwise fall back to blits
+bool isMipmapComputeSupported(const lvk::VulkanImage& image) {
+  const VkFormatFeatureFlags features = image.vkFormatProperties_.optimalTilingFeatures;
+
+  return image.vkType_ == VK_IMAGE_TYPE_2D && image.isSampledImage() && image.isStorageImage() && !image.isDepthFormat_ &&
+         !image.isStencilFormat_ && image.numLayers_ <= LVK_ARRAY_NUM_ELEMENTS(image.imageViewForFramebuffer_[0]) &&
+         (features & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) && (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+}
+
 } // namespace
 
 namespace lvk {
 
-struct DeferredTask {
-  DeferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) : task_(std::move(task)), handle_(handle) {}
-  std::packaged_task<void()> task_;
-  SubmitHandle handle_;
+struct DeferredObject {
+  DeferredObjectType type_ = DeferredObjectType_Buffer;
+  uint64_t object_ = 0;
+  VmaAllocation allocation_ = VK_NULL_HANDLE;
+};
+
+// everything released before one submit; buckets are retired in submission order and recycled with their capacity
+struct DeferredBucket {
+  SubmitHandle handle_ = {};
+  SubmitHandle computeHandle_ = {}; // async compute work which can still reference the objects
+  std::vector<DeferredObject> objects_;
+  std::vector<std::packaged_task<void()>> tasks_;
 };
 
 struct VulkanContextImpl final {
@@ -740,8 +1224,111 @@ struct VulkanContextImpl final {
   VmaAllocator vma_ = VK_NULL_HANDLE;
 
   lvk::CommandBuffer currentCommandBuffer_;
-
-  std::vector<DeferredTask> deferredTasks_;
+  lvk::CommandBuffer currentCommandBufferCompute_;
+
+  // secondary command buffers are recorded on worker threads - one VkCommandPool per recording thread
+  struct SecondaryCommandBuffer {
+    VulkanImmediateCommands::CommandBufferWrapper wrapper_;
+    lvk::CommandBuffer cmdBuffer_;
+    SubmitHandle handle_ = {}; // the submit of the primary command buffer which executed this secondary command buffer
+    bool isAvailable_ = true;
+  };
+  struct SecondaryCommandPool {
+    std::thread::id threadId_;
+    VkCommandPool commandPool_ = VK_NULL_HANDLE;
+    std::vector<std::unique_ptr<SecondaryCommandBuffer>> buffers_;
+  };
+  std::mutex secondaryPoolsMutex_;
+  std::vector<std::unique_ptr<SecondaryCommandPool>> secondaryPools_;
+  std::vector<const lvk::CommandBuffer*> secondaryBuffersExecuted_; // executed by the current primary command buffer
+  std::mutex renderPipelinesMutex_; // getVkPipeline() can be called from multiple recording threads
+
+  // VK_EXT_extended_dynamic_state3 - render pipelines with equal static state share one VkPipeline; guarded by renderPipelinesMutex_
+  struct SharedRenderPipeline {
+    VkPipeline pipeline_ = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
+    std::shared_future<VkPipeline> pendingPipeline_;
+    VkShaderStageFlags shaderStageFlags_ = 0;
+    uint32_t numRefs_ = 0;
+    std::string key_; // the full static state key - the map is keyed by its hash
+  };
+  std::unordered_map<uint64_t, SharedRenderPipeline> sharedRenderPipelines_;
+  std::mutex mipmapPipelineMutex_;
+
+  // background pipeline compilation - see IContext::prewarm()
+  std::vector<std::thread> compilerThreads_;
+  std::mutex compilerMutex_;
+  std::condition_variable compilerCondition_;
+  std::deque<std::packaged_task<VkPipeline()>> compilerTasks_;
+  bool compilerExit_ = false;
+
+  // persistent pipeline cache - see ContextConfig::pipelineCacheFileName
+  std::string pipelineCacheFileName_; // the application's string can go away while the file is being saved asynchronously
+  std::atomic<uint32_t> numPipelineCacheHits_ = 0;
+  std::atomic<uint32_t> numPipelineCacheMisses_ = 0;
+  std::atomic<uint64_t> pipelineCreationTimeNs_ = 0;
+  uint32_t numPipelineCacheMissesSaved_ = 0; // nothing new to save if there were no misses since the last save
+  std::chrono::steady_clock::time_point lastPipelineCacheSaveTime_ = std::chrono::steady_clock::now();
+  std::future<bool> pipelineCacheSaveFuture_;
+
+  // SPIR-V cache - see ContextConfig::enableShaderCache
+  std::mutex shaderCacheMutex_;
+  std::unordered_map<std::string, std::vector<uint8_t>> shaderCache_; // keyed by the full key, not by its hash
+
+  // see IContext::getCreationStats()
+  std::atomic<uint32_t> numShaderCompilations_ = 0;
+  std::atomic<uint32_t> numShaderCacheHits_ = 0;
+  std::atomic<uint64_t> shaderCompilationTimeNs_ = 0;
+
+  // deferred destruction - deferredDestroy() and deferredTask() can be called from any thread
+  std::mutex deferredMutex_;
+  std::deque<DeferredBucket> deferredBuckets_; // the oldest buckets are at the front
+  std::vector<DeferredBucket> freeDeferredBuckets_;
+
+  // GPU timing scopes and frame statistics - a ring of frames resolved without waiting once the GPU has written all timestamps
+  enum { kNumTimingFrames = 4 };
+  enum { kMaxTimingQueries = 4 * FrameStats::LVK_MAX_GPU_TIMING_SCOPES };
+  struct TimingFrame {
+    VkQueryPool queryPool_ = VK_NULL_HANDLE;
+    uint32_t numQueries_ = 0;
+    uint32_t beginQueries_[FrameStats::LVK_MAX_GPU_TIMING_SCOPES] = {};
+    uint32_t endQueries_[FrameStats::LVK_MAX_GPU_TIMING_SCOPES] = {}; // ~0u if the scope was not closed
+    FrameStats stats_ = {};
+    SubmitHandle handle_ = {}; // the last graphics and compute submits of the frame
+    SubmitHandle computeHandle_ = {};
+    bool isPending_ = false; // the frame has ended and waits for the GPU
+  };
+  mutable std::mutex timingMutex_;
+  TimingFrame timingFrames_[kNumTimingFrames];
+  uint32_t currentTimingFrame_ = 0;
+  uint64_t timingFrameIndex_ = 0;
+  bool isTimingFrameDropped_ = false; // all timing frames were still pending when the current frame began
+  bool hasTimingQueryPools_ = false;
+  bool isTimingSupported_ = true;
+  bool hasFrameStats_ = false;
+  FrameStats lastFrameStats_ = {};
+
+  // memory allocated by LVK - see IContext::getMemoryStats()
+  std::atomic<uint64_t> memoryBytes_[MemoryCategory_Num] = {};
+  std::atomic<uint32_t> memoryCount_[MemoryCategory_Num] = {};
+  std::mutex memoryBudgetMutex_;
+  MemoryBudgetCallback memoryBudgetCallback_ = nullptr;
+  void* memoryBudgetUserData_ = nullptr;
+  float memoryBudgetThreshold_ = 0.9f;
+  uint32_t vmaFrameIndex_ = 0;
+
+  // sparse textures - see IContext::updateSparsePages(); a page id is `block * kSparsePagesPerBlock + page`
+  enum { kSparsePagesPerBlock = 256 };
+  struct SparseMemoryBlock {
+    VkDeviceMemory memory_ = VK_NULL_HANDLE;
+    uint32_t memoryTypeBits_ = 0;
+    VkDeviceSize pageSize_ = 0;
+    std::vector<uint32_t> freePages_;
+  };
+  std::mutex sparseMutex_;
+  std::vector<SparseMemoryBlock> sparseBlocks_;
+  VkSemaphore sparseTimelineSemaphore_ = VK_NULL_HANDLE; // signaled by every vkQueueBindSparse()
+  uint64_t sparseTimelineValue_ = 0;
 
   struct YcbcrConversionData {
     VkSamplerYcbcrConversionInfo info;
@@ -761,6 +1348,31 @@ struct VulkanContextImpl final {
 
 } // namespace lvk
 
+template<typename ObjectType, typename ImplObjectType>
+lvk::Handle<ObjectType> lvk::VulkanContext::createBindless(lvk::Pool<ObjectType, ImplObjectType>& pool,
+                                                          std::vector<uint32_t>& dirty,
+                                                          ImplObjectType&& obj) {
+  std::lock_guard lock(descriptorsMutex_);
+
+  const Handle<ObjectType> handle = pool.create(std::move(obj));
+
+  if (handle.valid()) {
+    dirty.push_back(handle.index());
+    awaitingCreation_ = true;
+  }
+
+  return handle;
+}
+
+template<typename ObjectType, typename ImplObjectType>
+void lvk::VulkanContext::recycleBindless(lvk::Pool<ObjectType, ImplObjectType>& pool, std::vector<uint32_t>& dirty, uint32_t index) {
+  std::lock_guard lock(descriptorsMutex_);
+
+  pool.recycle(index);
+  dirty.push_back(index);
+  awaitingCreation_ = true;
+}
+
 void lvk::VulkanBuffer::flushMappedMemory(const VulkanContext& ctx, VkDeviceSize offset, VkDeviceSize size) const {
   if (!LVK_VERIFY(isMapped())) {
     return;
@@ -836,6 +1448,9 @@ void lvk::VulkanBuffer::bufferSubData(const VulkanContext& ctx, size_t offset, s
   }
 }
 
+static_assert(offsetof(lvk::VulkanImage, vkType_) <= 64, "The hot fields of VulkanImage should fit into one cache line");
+static_assert(sizeof(lvk::VulkanBuffer) == 64, "VulkanBuffer should fit into one cache line");
+
 VkImageView lvk::VulkanImage::createImageView(VkDevice device,
                                               VkImageViewType type,
                                               VkFormat format,
@@ -870,6 +1485,24 @@ void lvk::VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
                                         const VkImageSubresourceRange& subresourceRange) const {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
 
+  VkImageMemoryBarrier2 barrier = {};
+
+  if (!transitionLayout(newImageLayout, subresourceRange, barrier)) {
+    return;
+  }
+
+  const VkDependencyInfo depInfo{
+      .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+      .imageMemoryBarrierCount = 1,
+      .pImageMemoryBarriers = &barrier,
+  };
+
+  vkCmdPipelineBarrier2(commandBuffer, &depInfo);
+}
+
+bool lvk::VulkanImage::transitionLayout(VkImageLayout newImageLayout,
+                                        const VkImageSubresourceRange& subresourceRange,
+                                        VkImageMemoryBarrier2& outBarrier) const {
   const VkImageLayout oldImageLayout =
       vkImageLayout_ == VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL
           ? (isDepthAttachment() ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
@@ -879,9 +1512,20 @@ void lvk::VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
     newImageLayout = isDepthAttachment() ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
   }
 
+  if (oldImageLayout == newImageLayout && isReadOnlyImageLayout(newImageLayout)) {
+    // read-after-read does not need any synchronization
+    return false;
+  }
+
   StageAccess src = getPipelineStageAccess(oldImageLayout);
   StageAccess dst = getPipelineStageAccess(newImageLayout);
 
+  if (isMemoryAliased_ && oldImageLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+    // the memory could have been written through another image aliasing it
+    src.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    src.access = VK_ACCESS_2_MEMORY_WRITE_BIT;
+  }
+
   if (isDepthAttachment() && isResolveAttachment) {
     // https://registry.khronos.org/vulkan/specs/latest/html/vkspec.html#renderpass-resolve-operations
     src.stage |= VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -890,10 +1534,10 @@ void lvk::VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
     dst.access |= VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
   }
 
-  const VkImageMemoryBarrier2 barrier = {
+  outBarrier = {
       .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
       .srcStageMask = src.stage,
-      .srcAccessMask = src.access,
+      .srcAccessMask = getWriteAccessMask(src.access),
       .dstStageMask = dst.stage,
       .dstAccessMask = dst.access,
       .oldLayout = vkImageLayout_,
@@ -904,15 +1548,9 @@ void lvk::VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
       .subresourceRange = subresourceRange,
   };
 
-  const VkDependencyInfo depInfo{
-      .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-      .imageMemoryBarrierCount = 1,
-      .pImageMemoryBarriers = &barrier,
-  };
-
-  vkCmdPipelineBarrier2(commandBuffer, &depInfo);
-
   vkImageLayout_ = newImageLayout;
+
+  return true;
 }
 
 VkImageAspectFlags lvk::VulkanImage::getImageAspectFlags() const {
@@ -1230,9 +1868,14 @@ lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32
       .presentModeCount = numRegisteredPresentModes_,
       .pPresentModes = registeredPresentModes_,
   };
+  const VkSwapchainLatencyCreateInfoNV latencyci = {
+      .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_LATENCY_CREATE_INFO_NV,
+      .pNext = ctx.has_KHR_swapchain_maintenance1_ ? &pmci : nullptr,
+      .latencyModeEnable = VK_TRUE,
+  };
   const VkSwapchainCreateInfoKHR ci = {
       .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
-      .pNext = ctx.has_KHR_swapchain_maintenance1_ ? &pmci : nullptr,
+      .pNext = ctx.has_NV_low_latency2_ ? (const void*)&latencyci : ctx.has_KHR_swapchain_maintenance1_ ? (const void*)&pmci : nullptr,
       .surface = ctx.vkSurface_,
       .minImageCount = chooseSwapImageCount(ctx.deviceSurfaceCaps_),
       .imageFormat = surfaceFormat_.format,
@@ -1255,6 +1898,17 @@ lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32
   };
   VK_ASSERT(vkCreateSwapchainKHR(device_, &ci, nullptr, &swapchain_));
 
+  if (ctx_.has_NV_low_latency2_) {
+    const VkLatencySleepModeInfoNV sleepModeInfo = {
+        .sType = VK_STRUCTURE_TYPE_LATENCY_SLEEP_MODE_INFO_NV,
+        .lowLatencyMode = VK_TRUE,
+        .lowLatencyBoost = VK_TRUE,
+        .minimumIntervalUs = 0,
+    };
+    VK_ASSERT(vkSetLatencySleepModeNV(device_, swapchain_, &sleepModeInfo));
+    latencySemaphore_ = lvk::createSemaphoreTimeline(device_, 0, "Semaphore: latencySemaphore_");
+  }
+
   if (ctx_.has_EXT_hdr_metadata_) {
     const VkHdrMetadataEXT metadata = {
         .sType = VK_STRUCTURE_TYPE_HDR_METADATA_EXT,
@@ -1298,13 +1952,13 @@ lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32
     VulkanImage image = {
         .vkImage_ = swapchainImages[i],
         .vkUsageFlags_ = usageFlags,
-        .vkExtent_ = VkExtent3D{.width = width_, .height = height_, .depth = 1},
-        .vkType_ = VK_IMAGE_TYPE_2D,
         .vkImageFormat_ = surfaceFormat_.format,
-        .isSwapchainImage_ = true,
-        .isOwningVkImage_ = false,
+        .vkExtent_ = VkExtent3D{.width = width_, .height = height_, .depth = 1},
         .isDepthFormat_ = VulkanImage::isDepthFormat(surfaceFormat_.format),
         .isStencilFormat_ = VulkanImage::isStencilFormat(surfaceFormat_.format),
+        .isSwapchainImage_ = true,
+        .vkType_ = VK_IMAGE_TYPE_2D,
+        .isOwningVkImage_ = false,
     };
 
     VK_ASSERT(lvk::setDebugObjectName(device_, VK_OBJECT_TYPE_IMAGE, (uint64_t)image.vkImage_, debugNameImage));
@@ -1341,6 +1995,9 @@ lvk::VulkanSwapchain::~VulkanSwapchain() {
     if (fence)
       vkDestroyFence(device_, fence, nullptr);
   }
+  if (latencySemaphore_) {
+    vkDestroySemaphore(device_, latencySemaphore_, nullptr);
+  }
 }
 
 VkImage lvk::VulkanSwapchain::getCurrentVkImage() const {
@@ -1427,27 +2084,130 @@ bool lvk::VulkanSwapchain::setCurrentPresentMode(VkPresentModeKHR mode) {
   return false;
 }
 
-lvk::Result lvk::VulkanSwapchain::present(VkSemaphore waitSemaphore) {
-  LVK_PROFILER_FUNCTION();
+void lvk::VulkanSwapchain::waitForNextFrame() {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_WAIT);
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  if (ctx_.has_NV_low_latency2_) {
+    // the driver picks the moment to start the frame
+    const VkLatencySleepInfoNV sleepInfo = {
+        .sType = VK_STRUCTURE_TYPE_LATENCY_SLEEP_INFO_NV,
+        .signalSemaphore = latencySemaphore_,
+        .value = ++latencySemaphoreValue_,
+    };
+    VK_ASSERT(vkLatencySleepNV(device_, swapchain_, &sleepInfo));
+    const VkSemaphoreWaitInfo waitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &latencySemaphore_,
+        .pValues = &latencySemaphoreValue_,
+    };
+    VK_ASSERT(vkWaitSemaphores(device_, &waitInfo, UINT64_MAX));
+  }
+
+  const uint32_t maxFramesInFlight =
+      ctx_.config_.maxFramesInFlight ? std::min(ctx_.config_.maxFramesInFlight, numSwapchainImages_) : numSwapchainImages_;
+
+  if (currentFrameIndex_ >= maxFramesInFlight) {
+    // this frame should be presented before the next one starts
+    const uint64_t frame = currentFrameIndex_ - maxFramesInFlight;
+
+    // the frame has not been presented if the wait timed out or the swapchain is out of date
+    bool isPresented = true;
+
+    if (ctx_.has_KHR_present_wait_) {
+      // do not stall forever if the presentation engine never reports this frame (e.g. the window is minimized)
+      constexpr uint64_t kPresentWaitTimeoutNs = 100ull * 1000ull * 1000ull;
+      const VkResult r = vkWaitForPresentKHR(device_, swapchain_, frame + 1, kPresentWaitTimeoutNs);
+      if (r != VK_SUCCESS && r != VK_TIMEOUT && r != VK_SUBOPTIMAL_KHR && r != VK_ERROR_OUT_OF_DATE_KHR) {
+        VK_ASSERT(r);
+      }
+      isPresented = r == VK_SUCCESS || r == VK_SUBOPTIMAL_KHR;
+    } else {
+      // see VulkanContext::submit()
+      const uint64_t value = frame + numSwapchainImages_;
+      const VkSemaphoreWaitInfo waitInfo = {
+          .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+          .semaphoreCount = 1,
+          .pSemaphores = &ctx_.timelineSemaphore_,
+          .pValues = &value,
+      };
+      VK_ASSERT(vkWaitSemaphores(device_, &waitInfo, UINT64_MAX));
+    }
+
+    if (isPresented) {
+      const std::chrono::steady_clock::time_point presentTime = std::chrono::steady_clock::now();
+      const uint32_t slot = frame % LVK_MAX_SWAPCHAIN_IMAGES;
+
+      presentTimings_ = {
+          .frameIndex = frame,
+          .sleepMs = frameSleepMs_[slot],
+          .latencyMs = std::chrono::duration<double, std::milli>(presentTime - frameStartTime_[slot]).count(),
+          .intervalMs = hasPresentTimings_ ? std::chrono::duration<double, std::milli>(presentTime - lastPresentTime_).count() : 0.0,
+          .isPresentWait = ctx_.has_KHR_present_wait_,
+      };
+      lastPresentTime_ = presentTime;
+      hasPresentTimings_ = true;
+    }
+  }
+
+  const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  const uint32_t slot = currentFrameIndex_ % LVK_MAX_SWAPCHAIN_IMAGES;
+
+  frameStartTime_[slot] = end;
+  frameSleepMs_[slot] = std::chrono::duration<double, std::milli>(end - start).count();
+
+  setLatencyMarker(VK_LATENCY_MARKER_SIMULATION_START_NV);
+  setLatencyMarker(VK_LATENCY_MARKER_INPUT_SAMPLE_NV);
+}
+
+void lvk::VulkanSwapchain::setLatencyMarker(VkLatencyMarkerNV marker) const {
+  if (!ctx_.has_NV_low_latency2_) {
+    return;
+  }
+
+  const VkSetLatencyMarkerInfoNV info = {
+      .sType = VK_STRUCTURE_TYPE_SET_LATENCY_MARKER_INFO_NV,
+      .presentID = currentFrameIndex_ + 1,
+      .marker = marker,
+  };
+  vkSetLatencyMarkerNV(device_, swapchain_, &info);
+}
+
+lvk::Result lvk::VulkanSwapchain::present(VkSemaphore waitSemaphore) {
+  LVK_PROFILER_FUNCTION();
 
   LVK_PROFILER_ZONE("vkQueuePresent()", LVK_PROFILER_COLOR_PRESENT);
   if (ctx_.has_KHR_swapchain_maintenance1_ && !presentFence_[currentImageIndex_]) {
     presentFence_[currentImageIndex_] = lvk::createFence(device_, "Fence: present-fence");
   }
   presentFenceInfo_.pFences = &presentFence_[currentImageIndex_];
+  // see waitForNextFrame()
+  const uint64_t presentId = currentFrameIndex_ + 1;
+  const VkPresentIdKHR presentIdInfo = {
+      .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+      .pNext = ctx_.has_KHR_swapchain_maintenance1_ ? &presentFenceInfo_ : nullptr,
+      .swapchainCount = 1,
+      .pPresentIds = &presentId,
+  };
   const VkPresentInfoKHR pi = {
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-      .pNext = ctx_.has_KHR_swapchain_maintenance1_ ? &presentFenceInfo_ : nullptr,
+      .pNext = ctx_.has_KHR_present_wait_               ? (const void*)&presentIdInfo
+               : ctx_.has_KHR_swapchain_maintenance1_ ? (const void*)&presentFenceInfo_
+                                                      : nullptr,
       .waitSemaphoreCount = 1,
       .pWaitSemaphores = &waitSemaphore,
       .swapchainCount = 1u,
       .pSwapchains = &swapchain_,
       .pImageIndices = &currentImageIndex_,
   };
+  setLatencyMarker(VK_LATENCY_MARKER_PRESENT_START_NV);
   VkResult r = vkQueuePresentKHR(graphicsQueue_, &pi);
   if (r != VK_SUCCESS && r != VK_SUBOPTIMAL_KHR && r != VK_ERROR_OUT_OF_DATE_KHR) {
     VK_ASSERT(r);
   }
+  setLatencyMarker(VK_LATENCY_MARKER_PRESENT_END_NV);
   LVK_PROFILER_ZONE_END();
 
   // drop the previous present mode so we don't set it again in the next `present()` call if the present mode is not switched at runtime
@@ -1464,14 +2224,19 @@ lvk::Result lvk::VulkanSwapchain::present(VkSemaphore waitSemaphore) {
 
 lvk::VulkanImmediateCommands::VulkanImmediateCommands(VkDevice device,
                                                       uint32_t queueFamilyIndex,
+                                                      lvk::QueueType queueType,
                                                       bool has_EXT_device_fault,
-                                                      const char* debugName)
+                                                      const char* debugName,
+                                                      uint32_t maxCommandBuffers)
 : device_(device)
 , queueFamilyIndex_(queueFamilyIndex)
+, queueType_(queueType)
 , has_EXT_device_fault_(has_EXT_device_fault)
 , debugName_(debugName) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
 
+  LVK_ASSERT(maxCommandBuffers > 0 && maxCommandBuffers < (1u << kQueueTypeShift));
+
   vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue_);
 
   const VkCommandPoolCreateInfo ci = {
@@ -1482,6 +2247,14 @@ lvk::VulkanImmediateCommands::VulkanImmediateCommands(VkDevice device,
   VK_ASSERT(vkCreateCommandPool(device, &ci, nullptr, &commandPool_));
   VK_ASSERT(lvk::setDebugObjectName(device, VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)commandPool_, debugName));
 
+  {
+    char timelineName[256] = {0};
+    if (debugName) {
+      snprintf(timelineName, sizeof(timelineName) - 1, "Semaphore: %s (timeline)", debugName);
+    }
+    timelineSemaphore_ = lvk::createSemaphoreTimeline(device, 0, timelineName);
+  }
+
   const VkCommandBufferAllocateInfo ai = {
       .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
       .commandPool = commandPool_,
@@ -1489,18 +2262,21 @@ lvk::VulkanImmediateCommands::VulkanImmediateCommands(VkDevice device,
       .commandBufferCount = 1,
   };
 
-  for (uint32_t i = 0; i != kMaxCommandBuffers; i++) {
+  buffers_.resize(maxCommandBuffers);
+  freeBuffers_.resize(maxCommandBuffers);
+  submittedBuffers_.resize(maxCommandBuffers);
+
+  for (uint32_t i = 0; i != maxCommandBuffers; i++) {
     CommandBufferWrapper& buf = buffers_[i];
-    char fenceName[256] = {0};
     char semaphoreName[256] = {0};
     if (debugName) {
-      snprintf(fenceName, sizeof(fenceName) - 1, "Fence: %s (cmdbuf %u)", debugName, i);
       snprintf(semaphoreName, sizeof(semaphoreName) - 1, "Semaphore: %s (cmdbuf %u)", debugName, i);
     }
     buf.semaphore_ = lvk::createSemaphore(device, semaphoreName);
-    buf.fence_ = lvk::createFence(device, fenceName);
     VK_ASSERT(vkAllocateCommandBuffers(device, &ai, &buf.cmdBufAllocated_));
-    buffers_[i].handle_.bufferIndex_ = i;
+    buf.handle_.bufferIndex_ = i | (uint32_t(queueType) << kQueueTypeShift);
+    // acquire() takes buffers from the back, start with the buffer 0
+    freeBuffers_[i] = maxCommandBuffers - 1 - i;
   }
 }
 
@@ -1510,75 +2286,106 @@ lvk::VulkanImmediateCommands::~VulkanImmediateCommands() {
   waitAll();
 
   for (CommandBufferWrapper& buf : buffers_) {
-    // lifetimes of all VkFence objects are managed explicitly we do not use deferredTask() for them
-    vkDestroyFence(device_, buf.fence_, nullptr);
     vkDestroySemaphore(device_, buf.semaphore_, nullptr);
   }
 
+  vkDestroySemaphore(device_, timelineSemaphore_, nullptr);
   vkDestroyCommandPool(device_, commandPool_, nullptr);
 }
 
+uint64_t lvk::VulkanImmediateCommands::updateCompletedTimelineValue() const {
+  uint64_t value = 0;
+  VK_ASSERT(vkGetSemaphoreCounterValue(device_, timelineSemaphore_, &value));
+  completedTimelineValue_ = std::max(completedTimelineValue_, value);
+  return completedTimelineValue_;
+}
+
+void lvk::VulkanImmediateCommands::waitTimelineValue(uint64_t value) {
+  {
+    std::lock_guard lock(mutex_);
+    if (value <= completedTimelineValue_) {
+      return;
+    }
+  }
+
+  const VkSemaphoreWaitInfo waitInfo = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+      .semaphoreCount = 1,
+      .pSemaphores = &timelineSemaphore_,
+      .pValues = &value,
+  };
+  VK_ASSERT(vkWaitSemaphores(device_, &waitInfo, UINT64_MAX));
+
+  std::lock_guard lock(mutex_);
+
+  completedTimelineValue_ = std::max(completedTimelineValue_, value);
+}
+
 void lvk::VulkanImmediateCommands::purge() {
   LVK_PROFILER_FUNCTION();
 
-  const uint32_t numBuffers = static_cast<uint32_t>(LVK_ARRAY_NUM_ELEMENTS(buffers_));
+  if (!numSubmittedBuffers_) {
+    return;
+  }
 
-  for (uint32_t i = 0; i != numBuffers; i++) {
-    // always start checking with the oldest submitted buffer, then wrap around
-    CommandBufferWrapper& buf = buffers_[(i + lastSubmitHandle_.bufferIndex_ + 1) % numBuffers];
+  const uint32_t numBuffers = (uint32_t)buffers_.size();
 
-    if (buf.cmdBuf_ == VK_NULL_HANDLE || buf.isEncoding_) {
-      continue;
-    }
+  // timeline values grow with every submit: one query retires all the buffers completed so far, starting with the oldest one
+  const uint64_t completedValue = updateCompletedTimelineValue();
 
-    const VkResult result = vkWaitForFences(device_, 1, &buf.fence_, VK_TRUE, 0);
+  while (numSubmittedBuffers_) {
+    const uint32_t index = submittedBuffers_[firstSubmittedBuffer_];
+    CommandBufferWrapper& buf = buffers_[index];
 
-    if (result == VK_SUCCESS) {
-      VK_ASSERT(vkResetCommandBuffer(buf.cmdBuf_, VkCommandBufferResetFlags{0}));
-      VK_ASSERT(vkResetFences(device_, 1, &buf.fence_));
-      buf.cmdBuf_ = VK_NULL_HANDLE;
-      numAvailableCommandBuffers_++;
-    } else {
-      if (result != VK_TIMEOUT) {
-        VK_ASSERT(result);
-      }
+    if (buf.timelineValue_ > completedValue) {
+      break;
     }
+
+    VK_ASSERT(vkResetCommandBuffer(buf.cmdBuf_, VkCommandBufferResetFlags{0}));
+    buf.cmdBuf_ = VK_NULL_HANDLE;
+    freeBuffers_.push_back(index);
+
+    firstSubmittedBuffer_ = (firstSubmittedBuffer_ + 1) % numBuffers;
+    numSubmittedBuffers_--;
   }
 }
 
 const lvk::VulkanImmediateCommands::CommandBufferWrapper& lvk::VulkanImmediateCommands::acquire() {
   LVK_PROFILER_FUNCTION();
 
-  if (!numAvailableCommandBuffers_) {
+  std::unique_lock lock(mutex_);
+
+  if (freeBuffers_.empty()) {
     purge();
   }
 
-  while (!numAvailableCommandBuffers_) {
+  // other threads can take the retired buffer while we are not holding the lock
+  while (freeBuffers_.empty()) {
     LLOGL("Waiting for command buffers...\n");
     LVK_PROFILER_ZONE("Waiting for command buffers...", LVK_PROFILER_COLOR_WAIT);
+    if (numSubmittedBuffers_) {
+      // the remaining buffers are either in flight or being encoded; block until the GPU retires the oldest submitted one
+      const uint64_t value = buffers_[submittedBuffers_[firstSubmittedBuffer_]].timelineValue_;
+      // do not block other threads while waiting for the GPU
+      lock.unlock();
+      waitTimelineValue(value);
+      lock.lock();
+    } else {
+      // all buffers are being encoded by other threads (increase ContextConfig::maxCommandBuffers); the caller must not hold
+      // getMutex() here, otherwise none of them can be submitted
+      submitted_.wait(lock);
+    }
     purge();
     LVK_PROFILER_ZONE_END();
   }
 
-  VulkanImmediateCommands::CommandBufferWrapper* current = nullptr;
-
-  // we are ok with any available buffer
-  for (CommandBufferWrapper& buf : buffers_) {
-    if (buf.cmdBuf_ == VK_NULL_HANDLE) {
-      current = &buf;
-      break;
-    }
-  }
-
-  // make clang happy
-  assert(current);
+  CommandBufferWrapper* current = &buffers_[freeBuffers_.back()];
+  freeBuffers_.pop_back();
 
-  LVK_ASSERT_MSG(numAvailableCommandBuffers_, "No available command buffers");
-  LVK_ASSERT_MSG(current, "No available command buffers");
+  LVK_ASSERT(current->cmdBuf_ == VK_NULL_HANDLE);
   LVK_ASSERT(current->cmdBufAllocated_ != VK_NULL_HANDLE);
 
   current->handle_.submitId_ = submitCounter_;
-  numAvailableCommandBuffers_--;
 
   current->cmdBuf_ = current->cmdBufAllocated_;
   current->isEncoding_ = true;
@@ -1596,21 +2403,33 @@ const lvk::VulkanImmediateCommands::CommandBufferWrapper& lvk::VulkanImmediateCo
 void lvk::VulkanImmediateCommands::wait(const SubmitHandle handle) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_WAIT);
 
-  if (handle.empty()) {
-    vkDeviceWaitIdle(device_);
-    return;
-  }
+  uint64_t value = 0;
+  {
+    std::lock_guard lock(mutex_);
 
-  if (isReady(handle)) {
-    return;
-  }
+    if (handle.empty()) {
+      vkDeviceWaitIdle(device_);
+      return;
+    }
 
-  if (!LVK_VERIFY(!buffers_[handle.bufferIndex_].isEncoding_)) {
-    // we are waiting for a buffer which has not been submitted - this is probably a logic error somewhere in the calling code
-    return;
+    if (isReady(handle)) {
+      return;
+    }
+
+    const CommandBufferWrapper& buf = buffers_[getBufferIndex(handle)];
+
+    if (!LVK_VERIFY(!buf.isEncoding_)) {
+      // we are waiting for a buffer which has not been submitted - this is probably a logic error somewhere in the calling code
+      return;
+    }
+
+    value = buf.timelineValue_;
   }
 
-  VK_ASSERT(vkWaitForFences(device_, 1, &buffers_[handle.bufferIndex_].fence_, VK_TRUE, UINT64_MAX));
+  // other threads can keep submitting while we are blocked on the GPU
+  waitTimelineValue(value);
+
+  std::lock_guard lock(mutex_);
 
   purge();
 }
@@ -1618,32 +2437,32 @@ void lvk::VulkanImmediateCommands::wait(const SubmitHandle handle) {
 void lvk::VulkanImmediateCommands::waitAll() {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_WAIT);
 
-  VkFence fences[kMaxCommandBuffers];
-
-  uint32_t numFences = 0;
-
-  for (const CommandBufferWrapper& buf : buffers_) {
-    if (buf.cmdBuf_ != VK_NULL_HANDLE && !buf.isEncoding_) {
-      fences[numFences++] = buf.fence_;
-    }
+  uint64_t value = 0;
+  {
+    std::lock_guard lock(mutex_);
+    // the most recent submit signals the largest value
+    value = numSubmittedBuffers_ ? timelineValue_ : 0;
   }
 
-  if (numFences) {
-    VK_ASSERT(vkWaitForFences(device_, numFences, fences, VK_TRUE, UINT64_MAX));
-  }
+  waitTimelineValue(value);
+
+  std::lock_guard lock(mutex_);
 
   purge();
 }
 
 bool lvk::VulkanImmediateCommands::isReady(const SubmitHandle handle, bool fastCheckNoVulkan) const {
-  LVK_ASSERT(handle.bufferIndex_ < kMaxCommandBuffers);
-
   if (handle.empty()) {
     // a null handle
     return true;
   }
 
-  const CommandBufferWrapper& buf = buffers_[handle.bufferIndex_];
+  std::lock_guard lock(mutex_);
+
+  LVK_ASSERT(getQueueType(handle) == queueType_);
+  LVK_ASSERT(getBufferIndex(handle) < buffers_.size());
+
+  const CommandBufferWrapper& buf = buffers_[getBufferIndex(handle)];
 
   if (buf.cmdBuf_ == VK_NULL_HANDLE) {
     // already recycled and not yet reused
@@ -1655,20 +2474,32 @@ bool lvk::VulkanImmediateCommands::isReady(const SubmitHandle handle, bool fastC
     return true;
   }
 
+  if (buf.isEncoding_) {
+    return false;
+  }
+
+  if (buf.timelineValue_ <= completedTimelineValue_) {
+    // the GPU is known to be done with it, but purge() has not recycled it yet
+    return true;
+  }
+
   if (fastCheckNoVulkan) {
     // do not ask the Vulkan API about it, just let it retire naturally (when submitId for this bufferIndex gets incremented)
     return false;
   }
 
-  return vkWaitForFences(device_, 1, &buf.fence_, VK_TRUE, 0) == VK_SUCCESS;
+  return buf.timelineValue_ <= updateCompletedTimelineValue();
 }
 
 lvk::SubmitHandle lvk::VulkanImmediateCommands::submit(const CommandBufferWrapper& wrapper) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_SUBMIT);
+
+  std::lock_guard lock(mutex_);
+
   LVK_ASSERT(wrapper.isEncoding_);
   VK_ASSERT(vkEndCommandBuffer(wrapper.cmdBuf_));
 
-  VkSemaphoreSubmitInfo waitSemaphores[] = {{}, {}};
+  VkSemaphoreSubmitInfo waitSemaphores[2 + kMaxTimelineWaits] = {};
   uint32_t numWaitSemaphores = 0;
   if (waitSemaphore_.semaphore) {
     waitSemaphores[numWaitSemaphores++] = waitSemaphore_;
@@ -1676,13 +2507,21 @@ lvk::SubmitHandle lvk::VulkanImmediateCommands::submit(const CommandBufferWrappe
   if (lastSubmitSemaphore_.semaphore) {
     waitSemaphores[numWaitSemaphores++] = lastSubmitSemaphore_;
   }
+  for (uint32_t i = 0; i != numWaitTimelineSemaphores_; i++) {
+    waitSemaphores[numWaitSemaphores++] = waitTimelineSemaphores_[i];
+  }
+  const_cast<CommandBufferWrapper&>(wrapper).timelineValue_ = ++timelineValue_;
   VkSemaphoreSubmitInfo signalSemaphores[] = {
       VkSemaphoreSubmitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
                             .semaphore = wrapper.semaphore_,
                             .stageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT},
+      VkSemaphoreSubmitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                            .semaphore = timelineSemaphore_,
+                            .value = timelineValue_,
+                            .stageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT},
       {},
   };
-  uint32_t numSignalSemaphores = 1;
+  uint32_t numSignalSemaphores = 2;
   if (signalSemaphore_.semaphore) {
     signalSemaphores[numSignalSemaphores++] = signalSemaphore_;
   }
@@ -1704,7 +2543,7 @@ lvk::SubmitHandle lvk::VulkanImmediateCommands::submit(const CommandBufferWrappe
       .signalSemaphoreInfoCount = numSignalSemaphores,
       .pSignalSemaphoreInfos = signalSemaphores,
   };
-  const VkResult result = vkQueueSubmit2(queue_, 1u, &si, wrapper.fence_);
+  const VkResult result = vkQueueSubmit2(queue_, 1u, &si, VK_NULL_HANDLE);
   if (has_EXT_device_fault_ && result == VK_ERROR_DEVICE_LOST) {
     VkDeviceFaultCountsEXT count = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_FAULT_COUNTS_EXT,
@@ -1776,10 +2615,15 @@ lvk::SubmitHandle lvk::VulkanImmediateCommands::submit(const CommandBufferWrappe
   VK_ASSERT(result);
   LVK_PROFILER_ZONE_END();
 
+  // retired by purge() in the submission order
+  submittedBuffers_[(firstSubmittedBuffer_ + numSubmittedBuffers_) % (uint32_t)buffers_.size()] = getBufferIndex(wrapper.handle_);
+  numSubmittedBuffers_++;
+
   lastSubmitSemaphore_.semaphore = wrapper.semaphore_;
   lastSubmitHandle_ = wrapper.handle_;
   waitSemaphore_.semaphore = VK_NULL_HANDLE;
   signalSemaphore_.semaphore = VK_NULL_HANDLE;
+  numWaitTimelineSemaphores_ = 0;
 
   // reset
   const_cast<CommandBufferWrapper&>(wrapper).isEncoding_ = false;
@@ -1790,16 +2634,22 @@ lvk::SubmitHandle lvk::VulkanImmediateCommands::submit(const CommandBufferWrappe
     submitCounter_++;
   }
 
+  submitted_.notify_all();
+
   return lastSubmitHandle_;
 }
 
 void lvk::VulkanImmediateCommands::waitSemaphore(VkSemaphore semaphore) {
+  std::lock_guard lock(mutex_);
+
   LVK_ASSERT(waitSemaphore_.semaphore == VK_NULL_HANDLE);
 
   waitSemaphore_.semaphore = semaphore;
 }
 
 void lvk::VulkanImmediateCommands::signalSemaphore(VkSemaphore semaphore, uint64_t signalValue) {
+  std::lock_guard lock(mutex_);
+
   LVK_ASSERT(signalSemaphore_.semaphore == VK_NULL_HANDLE);
 
   signalSemaphore_.semaphore = semaphore;
@@ -1807,22 +2657,53 @@ void lvk::VulkanImmediateCommands::signalSemaphore(VkSemaphore semaphore, uint64
 }
 
 VkSemaphore lvk::VulkanImmediateCommands::acquireLastSubmitSemaphore() {
+  std::lock_guard lock(mutex_);
   return std::exchange(lastSubmitSemaphore_.semaphore, VK_NULL_HANDLE);
 }
 
-VkFence lvk::VulkanImmediateCommands::getVkFence(lvk::SubmitHandle handle) const {
-  if (handle.empty()) {
-    return VK_NULL_HANDLE;
+uint64_t lvk::VulkanImmediateCommands::getTimelineValue(SubmitHandle handle) const {
+  std::lock_guard lock(mutex_);
+
+  if (isReady(handle, true)) {
+    return 0;
+  }
+
+  const CommandBufferWrapper& buf = buffers_[getBufferIndex(handle)];
+
+  LVK_ASSERT_MSG(!buf.isEncoding_, "The command buffer has not been submitted yet");
+
+  return buf.timelineValue_;
+}
+
+void lvk::VulkanImmediateCommands::waitSemaphoreTimeline(VkSemaphore semaphore, uint64_t value) {
+  std::lock_guard lock(mutex_);
+
+  for (uint32_t i = 0; i != numWaitTimelineSemaphores_; i++) {
+    if (waitTimelineSemaphores_[i].semaphore == semaphore) {
+      waitTimelineSemaphores_[i].value = std::max(waitTimelineSemaphores_[i].value, value);
+      return;
+    }
   }
 
-  return buffers_[handle.bufferIndex_].fence_;
+  if (!LVK_VERIFY(numWaitTimelineSemaphores_ < kMaxTimelineWaits)) {
+    return;
+  }
+
+  waitTimelineSemaphores_[numWaitTimelineSemaphores_++] = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+      .semaphore = semaphore,
+      .value = value,
+      .stageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+  };
 }
 
 lvk::SubmitHandle lvk::VulkanImmediateCommands::getLastSubmitHandle() const {
+  std::lock_guard lock(mutex_);
   return lastSubmitHandle_;
 }
 
 lvk::SubmitHandle lvk::VulkanImmediateCommands::getNextSubmitHandle() const {
+  std::lock_guard lock(mutex_);
   return nextSubmitHandle_;
 }
 
@@ -1974,6 +2855,16 @@ lvk::VulkanPipelineBuilder& lvk::VulkanPipelineBuilder::patchControlPoints(uint3
   return *this;
 }
 
+lvk::VulkanPipelineBuilder& lvk::VulkanPipelineBuilder::flags(VkPipelineCreateFlags flags) {
+  flags_ = flags;
+  return *this;
+}
+
+lvk::VulkanPipelineBuilder& lvk::VulkanPipelineBuilder::creationFeedback(VkPipelineCreationFeedback* feedback) {
+  creationFeedback_ = feedback;
+  return *this;
+}
+
 lvk::VulkanPipelineBuilder& lvk::VulkanPipelineBuilder::shaderStage(VkPipelineShaderStageCreateInfo stage) {
   if (stage.pNext) {
     LVK_ASSERT(numShaderStages_ < LVK_ARRAY_NUM_ELEMENTS(shaderStages_));
@@ -2057,9 +2948,13 @@ VkResult lvk::VulkanPipelineBuilder::build(VkDevice device,
       .attachmentCount = numColorAttachments_,
       .pAttachments = colorBlendAttachmentStates_,
   };
+  const VkPipelineCreationFeedbackCreateInfo feedbackInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO,
+      .pPipelineCreationFeedback = creationFeedback_,
+  };
   const VkPipelineRenderingCreateInfo renderingInfo = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
-      .pNext = nullptr,
+      .pNext = creationFeedback_ ? &feedbackInfo : nullptr,
       .viewMask = viewMask_,
       .colorAttachmentCount = numColorAttachments_,
       .pColorAttachmentFormats = colorAttachmentFormats_,
@@ -2070,7 +2965,7 @@ VkResult lvk::VulkanPipelineBuilder::build(VkDevice device,
   const VkGraphicsPipelineCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
       .pNext = &renderingInfo,
-      .flags = 0,
+      .flags = flags_,
       .stageCount = numShaderStages_,
       .pStages = shaderStages_,
       .pVertexInputState = &vertexInputState_,
@@ -2104,7 +2999,14 @@ VkResult lvk::VulkanPipelineBuilder::build(VkDevice device,
   return lvk::setDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outPipeline, debugName);
 }
 
-lvk::CommandBuffer::CommandBuffer(VulkanContext* ctx) : ctx_(ctx), wrapper_(&ctx_->immediate_->acquire()) {}
+lvk::CommandBuffer::CommandBuffer(VulkanContext* ctx, QueueType queue)
+: ctx_(ctx)
+, wrapper_(&(queue == QueueType_Compute ? ctx_->immediateCompute_ : ctx_->immediate_)->acquire()) {}
+
+lvk::CommandBuffer::CommandBuffer(VulkanContext* ctx, const VulkanImmediateCommands::CommandBufferWrapper* secondaryWrapper)
+: ctx_(ctx)
+, wrapper_(secondaryWrapper)
+, isSecondary_(true) {}
 
 lvk::CommandBuffer::~CommandBuffer() {
   // did you forget to call cmdEndRendering()?
@@ -2159,13 +3061,26 @@ void lvk::CommandBuffer::cmdBindRayTracingPipeline(lvk::RayTracingPipelineHandle
   const lvk::RayTracingPipelineState* rtps = ctx_->rayTracingPipelinesPool_.get(handle);
 
   LVK_ASSERT(rtps);
-  LVK_ASSERT(pipeline != VK_NULL_HANDLE);
+
+  if (pipeline == VK_NULL_HANDLE) {
+    // the pipeline is still being compiled in the background
+    const RayTracingPipelineHandle fallback = rtps->desc_.fallback;
+    const lvk::RayTracingPipelineState* fallbackState = ctx_->rayTracingPipelinesPool_.get(fallback);
+    if (rtps->desc_.notReady == PipelineNotReady_Fallback && fallbackState && fallbackState->desc_.notReady != PipelineNotReady_Fallback) {
+      cmdBindRayTracingPipeline(fallback);
+      return;
+    }
+    isRayTracingPipelineNotReady_ = true;
+    return;
+  }
+
+  isRayTracingPipelineNotReady_ = false;
 
   if (lastPipelineBound_ != pipeline) {
     lastPipelineBound_ = pipeline;
     vkCmdBindPipeline(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline);
     ctx_->checkAndUpdateDescriptorSets();
-    ctx_->bindDefaultDescriptorSets(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rtps->pipelineLayout_);
+    bindDefaultDescriptorSets(VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rtps->pipelineLayout_);
   }
 }
 
@@ -2185,13 +3100,26 @@ void lvk::CommandBuffer::cmdBindComputePipeline(lvk::ComputePipelineHandle handl
   const lvk::ComputePipelineState* cps = ctx_->computePipelinesPool_.get(handle);
 
   LVK_ASSERT(cps);
-  LVK_ASSERT(pipeline != VK_NULL_HANDLE);
+
+  if (pipeline == VK_NULL_HANDLE) {
+    // the pipeline is still being compiled in the background
+    const ComputePipelineHandle fallback = cps->desc_.fallback;
+    const lvk::ComputePipelineState* fallbackState = ctx_->computePipelinesPool_.get(fallback);
+    if (cps->desc_.notReady == PipelineNotReady_Fallback && fallbackState && fallbackState->desc_.notReady != PipelineNotReady_Fallback) {
+      cmdBindComputePipeline(fallback);
+      return;
+    }
+    isComputePipelineNotReady_ = true;
+    return;
+  }
+
+  isComputePipelineNotReady_ = false;
 
   if (lastPipelineBound_ != pipeline) {
     lastPipelineBound_ = pipeline;
     vkCmdBindPipeline(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
     ctx_->checkAndUpdateDescriptorSets();
-    ctx_->bindDefaultDescriptorSets(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_COMPUTE, cps->pipelineLayout_);
+    bindDefaultDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, cps->pipelineLayout_);
   }
 }
 
@@ -2199,6 +3127,10 @@ void lvk::CommandBuffer::cmdDispatchThreadGroups(const Dimensions& threadgroupCo
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDispatchThreadGroups()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DISPATCH);
 
+  if (isComputePipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   LVK_ASSERT(!isRendering_);
 
   for (uint32_t i = 0; i != Dependencies::LVK_MAX_SUBMIT_DEPENDENCIES && deps.textures[i]; i++) {
@@ -2212,6 +3144,9 @@ void lvk::CommandBuffer::cmdDispatchThreadGroups(const Dimensions& threadgroupCo
                   VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
   }
+  flushBarriers();
+
+  stats_.numDispatches++;
 
   vkCmdDispatch(wrapper_->cmdBuf_, threadgroupCount.width, threadgroupCount.height, threadgroupCount.depth);
 }
@@ -2259,6 +3194,50 @@ void lvk::CommandBuffer::cmdPopDebugGroupLabel() const {
   vkCmdEndDebugUtilsLabelEXT(wrapper_->cmdBuf_);
 }
 
+uint32_t lvk::CommandBuffer::getNumTimestampViews() const {
+  if (!isRendering_ || !viewMask_) {
+    return 1;
+  }
+#if defined(_MSC_VER)
+  return _mm_popcnt_u32(viewMask_);
+#else
+  return __builtin_popcount(viewMask_);
+#endif
+}
+
+void lvk::CommandBuffer::cmdBeginTimingScope(const char* name, uint32_t colorRGBA) {
+  LVK_ASSERT(name);
+  LVK_ASSERT_MSG(numTimingScopes_ < kMaxTimingScopeDepth, "Too many nested timing scopes");
+
+  if (!name || numTimingScopes_ >= kMaxTimingScopeDepth) {
+    return;
+  }
+
+  cmdPushDebugGroupLabel(name, colorRGBA);
+
+  // queue families without timestamp support still get the debug label
+  const QueueType queue = VulkanImmediateCommands::getQueueType(wrapper_->handle_);
+
+  timingScopes_[numTimingScopes_] = ctx_->timestampValidBits_[queue]
+                                        ? ctx_->beginTimingScope(wrapper_->cmdBuf_, name, numTimingScopes_, getNumTimestampViews())
+                                        : TimingScopeRef();
+  numTimingScopes_++;
+}
+
+void lvk::CommandBuffer::cmdEndTimingScope() {
+  LVK_ASSERT_MSG(numTimingScopes_, "cmdEndTimingScope() without a matching cmdBeginTimingScope()");
+
+  if (!numTimingScopes_) {
+    return;
+  }
+
+  numTimingScopes_--;
+
+  ctx_->endTimingScope(wrapper_->cmdBuf_, timingScopes_[numTimingScopes_], getNumTimestampViews());
+
+  cmdPopDebugGroupLabel();
+}
+
 void lvk::CommandBuffer::useComputeTexture(TextureHandle handle, VkPipelineStageFlags2 dstStage) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
 
@@ -2272,66 +3251,107 @@ void lvk::CommandBuffer::useComputeTexture(TextureHandle handle, VkPipelineStage
     return;
   }
 
-  tex.transitionLayout(wrapper_->cmdBuf_,
-                       tex.isStorageImage() ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                       VkImageSubresourceRange{tex.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+  imageBarrier(tex,
+               tex.isStorageImage() ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+               VkImageSubresourceRange{tex.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
 }
 
 void lvk::CommandBuffer::bufferBarrier(BufferHandle handle, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage) {
-  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
+  const lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(handle);
+
+  LVK_ASSERT(buf);
 
-  lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(handle);
+  const VkAccessFlags2 srcAccess = getBufferSrcAccessMask(srcStage);
+  const VkAccessFlags2 dstAccess = getBufferDstAccessMask(dstStage, buf->vkUsageFlags_);
 
-  VkBufferMemoryBarrier2 barrier = {
+  // merge barriers for the same buffer
+  for (VkBufferMemoryBarrier2& b : pendingBufferBarriers_) {
+    if (b.buffer == buf->vkBuffer_) {
+      b.srcStageMask |= srcStage;
+      b.srcAccessMask |= srcAccess;
+      b.dstStageMask |= dstStage;
+      b.dstAccessMask |= dstAccess;
+      return;
+    }
+  }
+
+  pendingBufferBarriers_.push_back(VkBufferMemoryBarrier2{
       .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
       .srcStageMask = srcStage,
-      .srcAccessMask = 0,
+      .srcAccessMask = srcAccess,
       .dstStageMask = dstStage,
-      .dstAccessMask = 0,
+      .dstAccessMask = dstAccess,
       .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
       .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
       .buffer = buf->vkBuffer_,
       .offset = 0,
       .size = VK_WHOLE_SIZE,
-  };
+  });
+}
 
-  if (srcStage & VK_PIPELINE_STAGE_2_TRANSFER_BIT) {
-    barrier.srcAccessMask |= VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
-  } else {
-    barrier.srcAccessMask |= VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+void lvk::CommandBuffer::imageBarrier(const lvk::VulkanImage& image,
+                                      VkImageLayout newImageLayout,
+                                      const VkImageSubresourceRange& subresourceRange) {
+  // consecutive transitions of the same image cannot be recorded as one batch
+  for (const VkImageMemoryBarrier2& b : pendingImageBarriers_) {
+    if (b.image == image.vkImage_) {
+      flushBarriers();
+      break;
+    }
   }
 
-  if (dstStage & VK_PIPELINE_STAGE_2_TRANSFER_BIT) {
-    barrier.dstAccessMask |= VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
-  } else {
-    barrier.dstAccessMask |= VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
-  }
-  if (dstStage & VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT) {
-    barrier.dstAccessMask |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+  VkImageMemoryBarrier2 barrier = {};
+
+  if (image.transitionLayout(newImageLayout, subresourceRange, barrier)) {
+    pendingImageBarriers_.push_back(barrier);
   }
-  if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDEX_BUFFER_BIT) {
-    barrier.dstAccessMask |= VK_ACCESS_2_INDEX_READ_BIT;
+}
+
+void lvk::CommandBuffer::flushBarriers() {
+  if (pendingImageBarriers_.empty() && pendingBufferBarriers_.empty()) {
+    return;
   }
 
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
+
   const VkDependencyInfo depInfo = {
       .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-      .bufferMemoryBarrierCount = 1,
-      .pBufferMemoryBarriers = &barrier,
+      .bufferMemoryBarrierCount = (uint32_t)pendingBufferBarriers_.size(),
+      .pBufferMemoryBarriers = pendingBufferBarriers_.data(),
+      .imageMemoryBarrierCount = (uint32_t)pendingImageBarriers_.size(),
+      .pImageMemoryBarriers = pendingImageBarriers_.data(),
   };
 
   vkCmdPipelineBarrier2(wrapper_->cmdBuf_, &depInfo);
+
+  stats_.numBarriers += (uint32_t)(pendingBufferBarriers_.size() + pendingImageBarriers_.size());
+
+  pendingBufferBarriers_.clear();
+  pendingImageBarriers_.clear();
 }
 
 void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, const lvk::Framebuffer& fb, const Dependencies& deps) {
   LVK_PROFILER_FUNCTION();
 
   LVK_ASSERT(!isRendering_);
+  // framebuffer image views are created lazily here and are not guarded against worker threads recording secondary command buffers
+  LVK_ASSERT_MSG(!isSecondary_, "Secondary command buffers inherit the render pass from IContext::acquireSecondaryCommandBuffer()");
+  LVK_ASSERT_MSG(VulkanImmediateCommands::getQueueType(wrapper_->handle_) == QueueType_Graphics,
+                 "Rendering is not supported on the compute queue");
 
   isRendering_ = true;
   viewMask_ = renderPass.viewMask;
 
+  // all layout transitions and dependencies of this render pass are recorded with one barrier
   for (uint32_t i = 0; i != Dependencies::LVK_MAX_SUBMIT_DEPENDENCIES && deps.textures[i]; i++) {
-    transitionToShaderReadOnly(deps.textures[i]);
+    const lvk::VulkanImage& img = *ctx_->texturesPool_.get(deps.textures[i]);
+    LVK_ASSERT(!img.isSwapchainImage_);
+    // transition only non-multisampled images - MSAA images cannot be accessed from shaders
+    if (img.vkSamples_ == VK_SAMPLE_COUNT_1_BIT) {
+      imageBarrier(img,
+                   img.isSampledImage() ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL,
+                   VkImageSubresourceRange{img.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+    }
   }
   for (uint32_t i = 0; i != Dependencies::LVK_MAX_SUBMIT_DEPENDENCIES && deps.buffers[i]; i++) {
     VkPipelineStageFlags2 dstStageFlags = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
@@ -2355,15 +3375,22 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
 
   // transition all the color attachments
   for (uint32_t i = 0; i != numFbColorAttachments; i++) {
+    const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
     if (TextureHandle handle = fb.color[i].texture) {
       lvk::VulkanImage* colorTex = ctx_->texturesPool_.get(handle);
-      transitionToColorAttachment(wrapper_->cmdBuf_, colorTex);
+      if (isValidColorAttachment(colorTex)) {
+        discardAliasedContents(*colorTex, renderPass.color[i].loadOp);
+        imageBarrier(*colorTex, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, range);
+      }
     }
     // handle MSAA
     if (TextureHandle handle = fb.color[i].resolveTexture) {
       lvk::VulkanImage* colorResolveTex = ctx_->texturesPool_.get(handle);
-      colorResolveTex->isResolveAttachment = true;
-      transitionToColorAttachment(wrapper_->cmdBuf_, colorResolveTex);
+      if (isValidColorAttachment(colorResolveTex)) {
+        colorResolveTex->isResolveAttachment = true;
+        discardAliasedContents(*colorResolveTex, LoadOp_DontCare);
+        imageBarrier(*colorResolveTex, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, range);
+      }
     }
   }
   // transition depth-stencil attachment
@@ -2373,9 +3400,12 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
     LVK_ASSERT_MSG(depthImg.vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid depth attachment format");
     LVK_ASSERT_MSG(depthImg.isDepthFormat_, "Invalid depth attachment format");
     const VkImageAspectFlags flags = depthImg.getImageAspectFlags();
-    depthImg.transitionLayout(wrapper_->cmdBuf_,
-                              VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                              VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+    discardAliasedContents(depthImg,
+                           renderPass.depth.loadOp == LoadOp_Load || renderPass.stencil.loadOp == LoadOp_Load ? LoadOp_Load
+                                                                                                            : LoadOp_DontCare);
+    imageBarrier(depthImg,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                 VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
   }
   // handle depth MSAA
   if (TextureHandle handle = fb.depthStencil.resolveTexture) {
@@ -2383,9 +3413,10 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
     LVK_ASSERT_MSG(depthResolveImg.isDepthFormat_, "Invalid resolve depth attachment format");
     depthResolveImg.isResolveAttachment = true;
     const VkImageAspectFlags flags = depthResolveImg.getImageAspectFlags();
-    depthResolveImg.transitionLayout(wrapper_->cmdBuf_,
-                                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                                     VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+    discardAliasedContents(depthResolveImg, LoadOp_DontCare);
+    imageBarrier(depthResolveImg,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                 VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
   }
 
   // calculate and transition input attachments
@@ -2395,7 +3426,12 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
       const lvk::TextureHandle handle = deps.inputAttachments[i];
       const lvk::VulkanImage* tex = ctx_->texturesPool_.get(handle);
       LVK_ASSERT(tex);
-      transitionToRenderingLocalRead(handle);
+      LVK_ASSERT(!tex->isSwapchainImage_);
+      LVK_ASSERT_MSG(tex->vkUsageFlags_ & VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+                     "Input attachment texture must have VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT (lvk::TextureUsageBits_InputAttachment)");
+      imageBarrier(*tex,
+                   VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR,
+                   VkImageSubresourceRange{tex->getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
       inputAttachments_.imageInfos[i] = {
           .sampler = VK_NULL_HANDLE,
           .imageView = tex->imageView_,
@@ -2415,6 +3451,8 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
     inputAttachments_.count = i;
   }
 
+  flushBarriers();
+
   VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
   uint32_t mipLevel = 0;
   uint32_t fbWidth = 0;
@@ -2515,12 +3553,14 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
 
   VkRenderingAttachmentInfo stencilAttachment = depthAttachment;
 
-  const bool isStencilFormat = renderPass.stencil.loadOp != lvk::LoadOp_Invalid;
+  // must match acquireSecondaryCommandBuffer()
+  const bool isStencilFormat = renderPass.stencil.loadOp != lvk::LoadOp_Invalid && depthTex &&
+                               VulkanImage::isStencilFormat(ctx_->texturesPool_.get(fb.depthStencil.texture)->vkImageFormat_);
 
   const VkRenderingInfo renderingInfo = {
       .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
       .pNext = nullptr,
-      .flags = 0,
+      .flags = renderPass.secondaryCommandBuffers ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : VkRenderingFlags{},
       .renderArea = {VkOffset2D{(int32_t)scissor.x, (int32_t)scissor.y}, VkExtent2D{scissor.width, scissor.height}},
       .layerCount = renderPass.layerCount,
       .viewMask = renderPass.viewMask,
@@ -2530,6 +3570,11 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
       .pStencilAttachment = isStencilFormat ? &stencilAttachment : nullptr,
   };
 
+  // always set the dynamic state at the beginning of a render pass; bound buffers and push constants are preserved
+  boundState_.hasViewport = false;
+  boundState_.hasScissor = false;
+  boundState_.hasDepthState = false;
+
   cmdBindViewport(viewport);
   cmdBindScissorRect(scissor);
   cmdBindDepthState({});
@@ -2544,6 +3589,7 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
 
 void lvk::CommandBuffer::cmdEndRendering() {
   LVK_ASSERT(isRendering_);
+  LVK_ASSERT_MSG(!isSecondary_, "Secondary command buffers should be finished with IContext::endSecondaryCommandBuffer()");
 
   isRendering_ = false;
 
@@ -2571,9 +3617,64 @@ void lvk::CommandBuffer::cmdNextSubpass() {
   };
 
   vkCmdPipelineBarrier2(wrapper_->cmdBuf_, &dependencyInfo);
+
+  stats_.numBarriers++;
+}
+
+void lvk::CommandBuffer::cmdExecuteCommands(ICommandBuffer* const* secondaryCommandBuffers, uint32_t numCommandBuffers) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(isRendering_);
+  LVK_ASSERT(!isSecondary_);
+
+  constexpr uint32_t kMaxBatch = 32;
+
+  VkCommandBuffer cmdBufs[kMaxBatch];
+
+  for (uint32_t first = 0; first < numCommandBuffers; first += kMaxBatch) {
+    const uint32_t num = std::min(numCommandBuffers - first, kMaxBatch);
+    for (uint32_t i = 0; i != num; i++) {
+      const lvk::CommandBuffer* buf = static_cast<const lvk::CommandBuffer*>(secondaryCommandBuffers[first + i]);
+      LVK_ASSERT(buf && buf->isSecondary_);
+      LVK_ASSERT_MSG(!buf->wrapper_->isEncoding_, "Did you forget to call IContext::endSecondaryCommandBuffer()?");
+      cmdBufs[i] = buf->wrapper_->cmdBuf_;
+      ctx_->pimpl_->secondaryBuffersExecuted_.push_back(buf);
+      stats_.numDrawCalls += buf->stats_.numDrawCalls;
+      stats_.numDispatches += buf->stats_.numDispatches;
+      stats_.numBarriers += buf->stats_.numBarriers;
+      stats_.numRedundantBinds += buf->stats_.numRedundantBinds;
+    }
+#if LVK_VULKAN_PRINT_COMMANDS
+    LLOGL("%p vkCmdExecuteCommands(%u)\n", wrapper_->cmdBuf_, num);
+#endif // LVK_VULKAN_PRINT_COMMANDS
+    vkCmdExecuteCommands(wrapper_->cmdBuf_, num, cmdBufs);
+  }
+
+  // the state of a primary command buffer is undefined after vkCmdExecuteCommands()
+  lastPipelineBound_ = VK_NULL_HANDLE;
+  resetBoundState();
+}
+
+void lvk::CommandBuffer::resetBoundState() {
+  boundState_ = {};
+}
+
+void lvk::CommandBuffer::bindDefaultDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout) {
+  if (ctx_->has_EXT_descriptor_buffer_ && !boundState_.hasDescriptorBuffer) {
+    ctx_->bindDescriptorBuffer(wrapper_->cmdBuf_);
+    boundState_.hasDescriptorBuffer = true;
+  }
+  ctx_->bindDefaultDescriptorSets(wrapper_->cmdBuf_, bindPoint, layout);
 }
 
 void lvk::CommandBuffer::cmdBindViewport(const Viewport& viewport) {
+  if (boundState_.hasViewport && !memcmp(&boundState_.viewport, &viewport, sizeof(viewport))) {
+    stats_.numRedundantBinds++;
+    return;
+  }
+  boundState_.viewport = viewport;
+  boundState_.hasViewport = true;
+
   // https://www.saschawillems.de/blog/2019/03/29/flipping-the-vulkan-viewport/
   const VkViewport vp = {
       .x = viewport.x, // float x;
@@ -2587,6 +3688,13 @@ void lvk::CommandBuffer::cmdBindViewport(const Viewport& viewport) {
 }
 
 void lvk::CommandBuffer::cmdBindScissorRect(const ScissorRect& rect) {
+  if (boundState_.hasScissor && !memcmp(&boundState_.scissor, &rect, sizeof(rect))) {
+    stats_.numRedundantBinds++;
+    return;
+  }
+  boundState_.scissor = rect;
+  boundState_.hasScissor = true;
+
   const VkRect2D scissor = {
       VkOffset2D{(int32_t)rect.x, (int32_t)rect.y},
       VkExtent2D{rect.width, rect.height},
@@ -2615,14 +3723,27 @@ void lvk::CommandBuffer::cmdBindRenderPipeline(lvk::RenderPipelineHandle handle)
     LLOGW("Make sure your render pass and render pipeline both have matching depth attachments");
   }
 
-  VkPipeline pipeline = ctx_->getVkPipeline(handle, viewMask_);
+  // descriptor sets are updated only on the submitting thread, secondary command buffers use the ones from the primary cmdBeginRendering()
+  VkPipeline pipeline = ctx_->getVkPipeline(handle, viewMask_, !isSecondary_);
+
+  if (pipeline == VK_NULL_HANDLE) {
+    // the pipeline is still being compiled in the background
+    const RenderPipelineHandle fallback = rps->desc_.fallback;
+    const lvk::RenderPipelineState* fallbackState = ctx_->renderPipelinesPool_.get(fallback);
+    if (rps->desc_.notReady == PipelineNotReady_Fallback && fallbackState && fallbackState->desc_.notReady != PipelineNotReady_Fallback) {
+      cmdBindRenderPipeline(fallback);
+      return;
+    }
+    isGraphicsPipelineNotReady_ = true;
+    return;
+  }
 
-  LVK_ASSERT(pipeline != VK_NULL_HANDLE);
+  isGraphicsPipelineNotReady_ = false;
 
   if (lastPipelineBound_ != pipeline) {
     lastPipelineBound_ = pipeline;
     vkCmdBindPipeline(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-    ctx_->bindDefaultDescriptorSets(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, rps->pipelineLayout_);
+    bindDefaultDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, rps->pipelineLayout_);
     if (inputAttachments_.count) {
       vkCmdPushDescriptorSetKHR(wrapper_->cmdBuf_,
                                 VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -2632,11 +3753,57 @@ void lvk::CommandBuffer::cmdBindRenderPipeline(lvk::RenderPipelineHandle handle)
                                 inputAttachments_.writes);
     }
   }
+
+  if (ctx_->has_EXT_extended_dynamic_state3_) {
+    // different render pipelines can share one VkPipeline - set everything which makes them different
+    const RenderPipelineDesc& desc = rps->desc_;
+    const VkCommandBuffer cmdBuf = wrapper_->cmdBuf_;
+
+    vkCmdSetCullMode(cmdBuf, cullModeToVkCullMode(desc.cullMode));
+    vkCmdSetFrontFace(cmdBuf, windingModeToVkFrontFace(desc.frontFace));
+    if (!desc.smMesh.valid()) {
+      vkCmdSetPrimitiveTopology(cmdBuf, topologyToVkPrimitiveTopology(desc.topology));
+    }
+    vkCmdSetPolygonModeEXT(cmdBuf, polygonModeToVkPolygonMode(desc.polygonMode));
+    vkCmdSetRasterizationSamplesEXT(cmdBuf, getVulkanSampleCountFlags(desc.samplesCount, ctx_->getFramebufferMSAABitMask()));
+
+    const uint32_t numColorAttachments = desc.getNumColorAttachments();
+
+    if (numColorAttachments) {
+      VkBool32 blendEnables[LVK_MAX_COLOR_ATTACHMENTS] = {};
+      VkColorBlendEquationEXT blendEquations[LVK_MAX_COLOR_ATTACHMENTS] = {};
+      VkColorComponentFlags writeMasks[LVK_MAX_COLOR_ATTACHMENTS] = {};
+      for (uint32_t i = 0; i != numColorAttachments; i++) {
+        const lvk::ColorAttachment& attachment = desc.color[i];
+        blendEnables[i] = attachment.blendEnabled ? VK_TRUE : VK_FALSE;
+        blendEquations[i] = {
+            .srcColorBlendFactor = blendFactorToVkBlendFactor(attachment.srcRGBBlendFactor),
+            .dstColorBlendFactor = blendFactorToVkBlendFactor(attachment.dstRGBBlendFactor),
+            .colorBlendOp = blendOpToVkBlendOp(attachment.rgbBlendOp),
+            .srcAlphaBlendFactor = blendFactorToVkBlendFactor(attachment.srcAlphaBlendFactor),
+            .dstAlphaBlendFactor = blendFactorToVkBlendFactor(attachment.dstAlphaBlendFactor),
+            .alphaBlendOp = blendOpToVkBlendOp(attachment.alphaBlendOp),
+        };
+        writeMasks[i] = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+      }
+      vkCmdSetColorBlendEnableEXT(cmdBuf, 0, numColorAttachments, blendEnables);
+      vkCmdSetColorBlendEquationEXT(cmdBuf, 0, numColorAttachments, blendEquations);
+      vkCmdSetColorWriteMaskEXT(cmdBuf, 0, numColorAttachments, writeMasks);
+    }
+  }
 }
 
 void lvk::CommandBuffer::cmdBindDepthState(const DepthState& desc) {
   LVK_PROFILER_FUNCTION();
 
+  if (boundState_.hasDepthState && boundState_.depthState.compareOp == desc.compareOp &&
+      boundState_.depthState.isDepthWriteEnabled == desc.isDepthWriteEnabled) {
+    stats_.numRedundantBinds++;
+    return;
+  }
+  boundState_.depthState = desc;
+  boundState_.hasDepthState = true;
+
   const VkCompareOp op = compareOpToVkCompareOp(desc.compareOp);
   vkCmdSetDepthWriteEnable(wrapper_->cmdBuf_, desc.isDepthWriteEnabled ? VK_TRUE : VK_FALSE);
   vkCmdSetDepthTestEnable(wrapper_->cmdBuf_, (op != VK_COMPARE_OP_ALWAYS || desc.isDepthWriteEnabled) ? VK_TRUE : VK_FALSE);
@@ -2646,6 +3813,8 @@ void lvk::CommandBuffer::cmdBindDepthState(const DepthState& desc) {
   // On Android (Mali-G715-Immortalis MC11 v1.r38p1-01eac0.c1a71ccca2acf211eb87c5db5322f569)
   // if depth-stencil texture is not set, call of vkCmdSetDepthCompareOp leads to disappearing of all content.
   if (!framebuffer_.depthStencil.texture) {
+    // the compare op was not set - do not let the next call skip it
+    boundState_.hasDepthState = false;
     return;
   }
 #endif
@@ -2659,6 +3828,17 @@ void lvk::CommandBuffer::cmdBindVertexBuffer(uint32_t index, BufferHandle buffer
     return;
   }
 
+  LVK_ASSERT(index < VertexInput::LVK_VERTEX_BUFFER_MAX);
+
+  if (index < VertexInput::LVK_VERTEX_BUFFER_MAX) {
+    if (boundState_.vertexBuffers[index] == buffer && boundState_.vertexBufferOffsets[index] == bufferOffset) {
+      stats_.numRedundantBinds++;
+      return;
+    }
+    boundState_.vertexBuffers[index] = buffer;
+    boundState_.vertexBufferOffsets[index] = bufferOffset;
+  }
+
   lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(buffer);
 
   LVK_ASSERT(buf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
@@ -2667,6 +3847,15 @@ void lvk::CommandBuffer::cmdBindVertexBuffer(uint32_t index, BufferHandle buffer
 }
 
 void lvk::CommandBuffer::cmdBindIndexBuffer(BufferHandle indexBuffer, IndexFormat indexFormat, uint64_t indexBufferOffset) {
+  if (!indexBuffer.empty() && boundState_.indexBuffer == indexBuffer && boundState_.indexFormat == indexFormat &&
+      boundState_.indexBufferOffset == indexBufferOffset) {
+    stats_.numRedundantBinds++;
+    return;
+  }
+  boundState_.indexBuffer = indexBuffer;
+  boundState_.indexFormat = indexFormat;
+  boundState_.indexBufferOffset = indexBufferOffset;
+
   lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(indexBuffer);
 
   LVK_ASSERT(buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
@@ -2678,6 +3867,12 @@ void lvk::CommandBuffer::cmdBindIndexBuffer(BufferHandle indexBuffer, IndexForma
 void lvk::CommandBuffer::cmdPushConstants(const void* data, size_t size, size_t offset) {
   LVK_PROFILER_FUNCTION();
 
+  if ((!currentPipelineGraphics_.empty() && isGraphicsPipelineNotReady_) ||
+      (!currentPipelineCompute_.empty() && isComputePipelineNotReady_) ||
+      (!currentPipelineRayTracing_.empty() && isRayTracingPipelineNotReady_)) {
+    return; // the pipeline is still being compiled
+  }
+
   LVK_ASSERT(size % 4 == 0); // VUID-vkCmdPushConstants-size-00369: size must be a multiple of 4
 
   // check push constant size is within max size
@@ -2702,6 +3897,23 @@ void lvk::CommandBuffer::cmdPushConstants(const void* data, size_t size, size_t
   VkShaderStageFlags shaderStageFlags = stateGraphics ? stateGraphics->shaderStageFlags_
                                                       : (stateCompute ? VK_SHADER_STAGE_COMPUTE_BIT : stateRayTracing->shaderStageFlags_);
 
+  // the same bytes pushed into the same range of the same layout are already there
+  BoundState& s = boundState_;
+  if (s.pushConstantsLayout == layout && s.pushConstantsStages == shaderStageFlags && s.pushConstantsOffset == offset &&
+      s.pushConstantsSize == size && !memcmp(s.pushConstants, data, size)) {
+    stats_.numRedundantBinds++;
+    return;
+  }
+  if (size <= kMaxPushConstantsShadowSize) {
+    s.pushConstantsLayout = layout;
+    s.pushConstantsStages = shaderStageFlags;
+    s.pushConstantsOffset = (uint32_t)offset;
+    s.pushConstantsSize = (uint32_t)size;
+    memcpy(s.pushConstants, data, size);
+  } else {
+    s.pushConstantsLayout = VK_NULL_HANDLE;
+  }
+
   vkCmdPushConstants(wrapper_->cmdBuf_, layout, shaderStageFlags, (uint32_t)offset, (uint32_t)size, data);
 }
 
@@ -2715,6 +3927,7 @@ void lvk::CommandBuffer::cmdFillBuffer(BufferHandle buffer, size_t bufferOffset,
   lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(buffer);
 
   bufferBarrier(buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+  flushBarriers();
 
   vkCmdFillBuffer(wrapper_->cmdBuf_, buf->vkBuffer_, bufferOffset, size, data);
 
@@ -2723,11 +3936,12 @@ void lvk::CommandBuffer::cmdFillBuffer(BufferHandle buffer, size_t bufferOffset,
   if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) {
     dstStage |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
   }
-  if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT) {
+  if (buf->vkUsageFlags_ & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
     dstStage |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
   }
 
   bufferBarrier(buffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, dstStage);
+  flushBarriers();
 }
 
 void lvk::CommandBuffer::cmdCopyBuffer(BufferHandle srcBuffer, BufferHandle dstBuffer, size_t srcOffset, size_t dstOffset, size_t size) {
@@ -2749,6 +3963,7 @@ void lvk::CommandBuffer::cmdCopyBuffer(BufferHandle srcBuffer, BufferHandle dstB
 
   bufferBarrier(srcBuffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
   bufferBarrier(dstBuffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+  flushBarriers();
 
   const VkBufferCopy2 copyRegion = {
       .sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2,
@@ -2772,7 +3987,7 @@ void lvk::CommandBuffer::cmdCopyBuffer(BufferHandle srcBuffer, BufferHandle dstB
   if (srcBuf->vkUsageFlags_ & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) {
     srcStage |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
   }
-  if (srcBuf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT) {
+  if (srcBuf->vkUsageFlags_ & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
     srcStage |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
   }
 
@@ -2781,12 +3996,13 @@ void lvk::CommandBuffer::cmdCopyBuffer(BufferHandle srcBuffer, BufferHandle dstB
   if (dstBuf->vkUsageFlags_ & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) {
     dstStage |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
   }
-  if (dstBuf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT) {
+  if (dstBuf->vkUsageFlags_ & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
     dstStage |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
   }
 
   bufferBarrier(srcBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, srcStage);
   bufferBarrier(dstBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, dstStage);
+  flushBarriers();
 }
 
 void lvk::CommandBuffer::cmdUpdateBuffer(BufferHandle buffer, size_t bufferOffset, size_t size, const void* data) {
@@ -2800,6 +4016,7 @@ void lvk::CommandBuffer::cmdUpdateBuffer(BufferHandle buffer, size_t bufferOffse
   lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(buffer);
 
   bufferBarrier(buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+  flushBarriers();
 
   vkCmdUpdateBuffer(wrapper_->cmdBuf_, buf->vkBuffer_, bufferOffset, size, data);
 
@@ -2808,21 +4025,32 @@ void lvk::CommandBuffer::cmdUpdateBuffer(BufferHandle buffer, size_t bufferOffse
   if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) {
     dstStage |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
   }
-  if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT) {
+  if (buf->vkUsageFlags_ & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
     dstStage |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
   }
+  if (ctx_->has_EXT_mesh_shader_) {
+    // task and mesh shaders are not ordered after the vertex shader stage
+    dstStage |= VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+  }
 
   bufferBarrier(buffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, dstStage);
+  flushBarriers();
 }
 
 void lvk::CommandBuffer::cmdDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t baseInstance) {
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDraw()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   if (vertexCount == 0) {
     return;
   }
 
+  stats_.numDrawCalls++;
+
   vkCmdDraw(wrapper_->cmdBuf_, vertexCount, instanceCount, firstVertex, baseInstance);
 }
 
@@ -2834,12 +4062,18 @@ void lvk::CommandBuffer::cmdDrawIndexed(uint32_t indexCount,
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDrawIndexed()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   if (indexCount == 0) {
     return;
   }
 
   LVK_ASSERT(ctx_->awaitingCreation_ == false);
 
+  stats_.numDrawCalls++;
+
   vkCmdDrawIndexed(wrapper_->cmdBuf_, indexCount, instanceCount, firstIndex, vertexOffset, baseInstance);
 }
 
@@ -2847,10 +4081,16 @@ void lvk::CommandBuffer::cmdDrawIndirect(BufferHandle indirectBuffer, size_t ind
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDrawIndirect()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   lvk::VulkanBuffer* bufIndirect = ctx_->buffersPool_.get(indirectBuffer);
 
   LVK_ASSERT(bufIndirect);
 
+  stats_.numDrawCalls++;
+
   vkCmdDrawIndirect(
       wrapper_->cmdBuf_, bufIndirect->vkBuffer_, indirectBufferOffset, drawCount, stride ? stride : sizeof(VkDrawIndirectCommand));
 }
@@ -2862,10 +4102,16 @@ void lvk::CommandBuffer::cmdDrawIndexedIndirect(BufferHandle indirectBuffer,
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDrawIndexedIndirect()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   lvk::VulkanBuffer* bufIndirect = ctx_->buffersPool_.get(indirectBuffer);
 
   LVK_ASSERT(bufIndirect);
 
+  stats_.numDrawCalls++;
+
   vkCmdDrawIndexedIndirect(
       wrapper_->cmdBuf_, bufIndirect->vkBuffer_, indirectBufferOffset, drawCount, stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
 }
@@ -2879,12 +4125,18 @@ void lvk::CommandBuffer::cmdDrawIndexedIndirectCount(BufferHandle indirectBuffer
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDrawIndexedIndirectCount()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   lvk::VulkanBuffer* bufIndirect = ctx_->buffersPool_.get(indirectBuffer);
   lvk::VulkanBuffer* bufCount = ctx_->buffersPool_.get(countBuffer);
 
   LVK_ASSERT(bufIndirect);
   LVK_ASSERT(bufCount);
 
+  stats_.numDrawCalls++;
+
   vkCmdDrawIndexedIndirectCount(wrapper_->cmdBuf_,
                                 bufIndirect->vkBuffer_,
                                 indirectBufferOffset,
@@ -2898,8 +4150,14 @@ void lvk::CommandBuffer::cmdDrawMeshTasks(const Dimensions& threadgroupCount) {
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDrawMeshTasks()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   LVK_ASSERT_MSG(ctx_->has_EXT_mesh_shader_, "Mesh shaders not supported\n");
 
+  stats_.numDrawCalls++;
+
   vkCmdDrawMeshTasksEXT(wrapper_->cmdBuf_, threadgroupCount.width, threadgroupCount.height, threadgroupCount.depth);
 }
 
@@ -2910,12 +4168,18 @@ void lvk::CommandBuffer::cmdDrawMeshTasksIndirect(BufferHandle indirectBuffer,
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDrawMeshTasksIndirect()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   LVK_ASSERT_MSG(ctx_->has_EXT_mesh_shader_, "Mesh shaders not supported\n");
 
   lvk::VulkanBuffer* bufIndirect = ctx_->buffersPool_.get(indirectBuffer);
 
   LVK_ASSERT(bufIndirect);
 
+  stats_.numDrawCalls++;
+
   vkCmdDrawMeshTasksIndirectEXT(wrapper_->cmdBuf_,
                                 bufIndirect->vkBuffer_,
                                 indirectBufferOffset,
@@ -2932,6 +4196,10 @@ void lvk::CommandBuffer::cmdDrawMeshTasksIndirectCount(BufferHandle indirectBuff
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdDrawMeshTasksIndirectCount()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_DRAW);
 
+  if (isGraphicsPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   LVK_ASSERT_MSG(ctx_->has_EXT_mesh_shader_, "Mesh shaders not supported\n");
 
   lvk::VulkanBuffer* bufIndirect = ctx_->buffersPool_.get(indirectBuffer);
@@ -2940,6 +4208,8 @@ void lvk::CommandBuffer::cmdDrawMeshTasksIndirectCount(BufferHandle indirectBuff
   LVK_ASSERT(bufIndirect);
   LVK_ASSERT(bufCount);
 
+  stats_.numDrawCalls++;
+
   vkCmdDrawMeshTasksIndirectCountEXT(wrapper_->cmdBuf_,
                                      bufIndirect->vkBuffer_,
                                      indirectBufferOffset,
@@ -2953,6 +4223,10 @@ void lvk::CommandBuffer::cmdTraceRays(uint32_t width, uint32_t height, uint32_t
   LVK_PROFILER_FUNCTION();
   LVK_PROFILER_GPU_ZONE("cmdTraceRays()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_RTX);
 
+  if (isRayTracingPipelineNotReady_) {
+    return; // the pipeline is still being compiled
+  }
+
   lvk::RayTracingPipelineState* rtps = ctx_->rayTracingPipelinesPool_.get(currentPipelineRayTracing_);
 
   if (!LVK_VERIFY(rtps)) {
@@ -2969,6 +4243,9 @@ void lvk::CommandBuffer::cmdTraceRays(uint32_t width, uint32_t height, uint32_t
                   VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
                   VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR);
   }
+  flushBarriers();
+
+  stats_.numDispatches++;
 
   vkCmdTraceRaysKHR(
       wrapper_->cmdBuf_, &rtps->sbtEntryRayGen, &rtps->sbtEntryMiss, &rtps->sbtEntryHit, &rtps->sbtEntryCallable, width, height, depth);
@@ -2979,6 +4256,15 @@ void lvk::CommandBuffer::cmdSetBlendColor(const float color[4]) {
 }
 
 void lvk::CommandBuffer::cmdSetDepthBias(float constantFactor, float slopeFactor, float clamp) {
+  const float depthBias[3] = {constantFactor, slopeFactor, clamp};
+
+  if (boundState_.hasDepthBias && !memcmp(boundState_.depthBias, depthBias, sizeof(depthBias))) {
+    stats_.numRedundantBinds++;
+    return;
+  }
+  memcpy(boundState_.depthBias, depthBias, sizeof(depthBias));
+  boundState_.hasDepthBias = true;
+
   vkCmdSetDepthBias(wrapper_->cmdBuf_, constantFactor, clamp, slopeFactor);
 }
 
@@ -3198,22 +4484,37 @@ void lvk::CommandBuffer::cmdCopyImage(TextureHandle src,
 }
 
 void lvk::CommandBuffer::cmdGenerateMipmap(TextureHandle handle) {
-  if (handle.empty()) {
+  cmdGenerateMipmaps(&handle, 1);
+}
+
+void lvk::CommandBuffer::cmdGenerateMipmaps(const TextureHandle* handles, uint32_t numTextures) {
+  LVK_PROFILER_GPU_ZONE("cmdGenerateMipmaps()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_COPY);
+
+  LVK_ASSERT(!isRendering_);
+
+  if (!handles || !numTextures) {
     return;
   }
 
-  const lvk::VulkanImage* tex = ctx_->texturesPool_.get(handle);
+  std::vector<lvk::VulkanImage*> images;
+  images.reserve(numTextures);
 
-  if (tex->numLevels_ <= 1) {
-    return;
+  for (uint32_t i = 0; i != numTextures; i++) {
+    if (lvk::VulkanImage* tex = ctx_->texturesPool_.get(handles[i])) {
+      images.push_back(tex);
+    }
   }
 
-  LVK_ASSERT(tex->vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
+  flushBarriers();
 
-  tex->generateMipmap(wrapper_->cmdBuf_);
+  ctx_->generateMipmaps(wrapper_->cmdBuf_, images.data(), (uint32_t)images.size());
+
+  // the compute path binds its own pipeline, descriptors and push constants
+  lastPipelineBound_ = VK_NULL_HANDLE;
+  resetBoundState();
 }
 
-void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle instancesBuffer) {
+void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle instancesBuffer, bool forceRebuild) {
   LVK_PROFILER_GPU_ZONE("cmdUpdateTLAS()", ctx_, wrapper_->cmdBuf_, LVK_PROFILER_COLOR_CMD_RTX);
 
   if (handle.empty()) {
@@ -3222,6 +4523,17 @@ void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle in
 
   lvk::AccelerationStructure* as = ctx_->accelStructuresPool_.get(handle);
 
+  if (!LVK_VERIFY(as && as->isTLAS)) {
+    return;
+  }
+
+  // refitting keeps the original BVH topology and degrades over time, so do a full rebuild every `maxNumRefits` updates
+  const bool canRefit = (as->buildFlags & lvk::AccelStructBuildFlagBits_AllowUpdate) && !forceRebuild &&
+                        (!as->maxNumRefits || as->numRefits < as->maxNumRefits);
+  as->numRefits = canRefit ? as->numRefits + 1 : 0;
+
+  const VkBuildAccelerationStructureFlagsKHR buildFlags = buildFlagsToVkBuildAccelerationStructureFlags(as->buildFlags);
+
   const VkAccelerationStructureGeometryKHR accelerationStructureGeometry{
       .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
       .geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR,
@@ -3234,13 +4546,13 @@ void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle in
                       .data = {.deviceAddress = ctx_->gpuAddress(instancesBuffer)},
                   },
           },
-      .flags = VK_GEOMETRY_OPAQUE_BIT_KHR,
+      .flags = as->geometryFlags,
   };
 
   VkAccelerationStructureBuildGeometryInfoKHR accelerationStructureBuildGeometryInfo{
       .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
       .type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
-      .flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR,
+      .flags = buildFlags,
       .geometryCount = 1,
       .pGeometries = &accelerationStructureGeometry,
   };
@@ -3258,13 +4570,17 @@ void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle in
   accelerationStructureBuildSizesInfo.updateScratchSize += alignment;
   accelerationStructureBuildSizesInfo.buildScratchSize += alignment;
 
-  if (!as->scratchBuffer.valid() || getBufferSize(ctx_, as->scratchBuffer) < accelerationStructureBuildSizesInfo.updateScratchSize) {
+  const VkDeviceSize scratchSize =
+      canRefit ? accelerationStructureBuildSizesInfo.updateScratchSize : accelerationStructureBuildSizesInfo.buildScratchSize;
+
+  if (!as->scratchBuffer.valid() || getBufferSize(ctx_, as->scratchBuffer) < scratchSize) {
     LLOGD("Recreating scratch buffer for TLAS update");
     as->scratchBuffer = ctx_->createBuffer(
         lvk::BufferDesc{
             .usage = lvk::BufferUsageBits_Storage,
             .storage = lvk::StorageType_Device,
-            .size = accelerationStructureBuildSizesInfo.updateScratchSize,
+            .size = scratchSize,
+            .isShared = as->isShared,
             .debugName = "scratchBuffer",
         },
         nullptr,
@@ -3274,9 +4590,9 @@ void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle in
   const VkAccelerationStructureBuildGeometryInfoKHR accelerationBuildGeometryInfo = {
       .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
       .type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
-      .flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR,
-      .mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR,
-      .srcAccelerationStructure = as->vkHandle,
+      .flags = buildFlags,
+      .mode = canRefit ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR,
+      .srcAccelerationStructure = canRefit ? as->vkHandle : VK_NULL_HANDLE,
       .dstAccelerationStructure = as->vkHandle,
       .geometryCount = 1,
       .pGeometries = &accelerationStructureGeometry,
@@ -3314,6 +4630,7 @@ void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle in
         .pBufferMemoryBarriers = barriers,
     };
     vkCmdPipelineBarrier2(wrapper_->cmdBuf_, &dependencyInfo);
+    stats_.numBarriers += (uint32_t)LVK_ARRAY_NUM_ELEMENTS(barriers);
   }
   vkCmdBuildAccelerationStructuresKHR(wrapper_->cmdBuf_, 1, &accelerationBuildGeometryInfo, accelerationBuildStructureRangeInfos);
   {
@@ -3330,10 +4647,11 @@ void lvk::CommandBuffer::cmdUpdateTLAS(AccelStructHandle handle, BufferHandle in
     const VkDependencyInfo dependencyInfo{
         .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO, .bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &barrier};
     vkCmdPipelineBarrier2(wrapper_->cmdBuf_, &dependencyInfo);
+    stats_.numBarriers++;
   }
 }
 
-lvk::VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx) : ctx_(ctx) {
+lvk::VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx, VulkanImmediateCommands& immediate) : ctx_(ctx), immediate_(immediate) {
   LVK_PROFILER_FUNCTION();
 
   const VkDeviceSize maxMemoryAllocationSize = ctx_.vkPhysicalDeviceVulkan11Properties_.maxMemoryAllocationSize;
@@ -3343,24 +4661,37 @@ lvk::VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx) : ctx_(ctx) {
   // clamped to the max limits
   maxBufferSize_ = std::min(maxMemoryAllocationSize, ctx_.config_.maxStagingBufferSize);
   minBufferSize_ = std::min(minBufferSize_, maxBufferSize_);
+  maxNumBlocks_ = std::max(ctx_.config_.maxStagingBufferBlocks, 1u);
 }
 
-void lvk::VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer, size_t dstOffset, size_t size, const void* data) {
+lvk::SubmitHandle lvk::VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer,
+                                                          size_t dstOffset,
+                                                          size_t size,
+                                                          const void* data,
+                                                          bool* outIsPending) {
   LVK_PROFILER_FUNCTION();
 
   if (buffer.isMapped()) {
     buffer.bufferSubData(ctx_, dstOffset, size, data);
-    return;
+    return {};
   }
 
-  lvk::VulkanBuffer* stagingBuffer = ctx_.buffersPool_.get(stagingBuffer_);
+  std::lock_guard lock(mutex_);
 
-  LVK_ASSERT(stagingBuffer);
+  SubmitHandle handle;
 
   while (size) {
-    // get next staging buffer free offset
-    MemoryRegionDesc desc = getNextFreeOffset((uint32_t)size);
-    const uint32_t chunkSize = std::min((uint64_t)size, desc.size_);
+    // get the next chunk of staging memory; once the first chunk has been submitted, the rest of the upload has to complete
+    MemoryRegionDesc desc = allocate(std::min((uint64_t)size, maxBufferSize_),
+                                     std::min((uint64_t)size, (uint64_t)kMinBufferChunkSize),
+                                     !outIsPending || !handle.empty());
+    if (!desc.size_) {
+      *outIsPending = true;
+      return {};
+    }
+    const uint64_t chunkSize = std::min((uint64_t)size, desc.size_);
+
+    lvk::VulkanBuffer* stagingBuffer = getStagingBuffer(desc);
 
     // copy data into staging buffer
     stagingBuffer->bufferSubData(ctx_, desc.offset_, chunkSize, data);
@@ -3372,7 +4703,7 @@ void lvk::VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer, size_t dstOff
         .size = chunkSize,
     };
 
-    const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = ctx_.immediate_->acquire();
+    const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = immediate_.acquire();
     vkCmdCopyBuffer(wrapper.cmdBuf_, stagingBuffer->vkBuffer_, buffer.vkBuffer_, 1, &copy);
     VkBufferMemoryBarrier barrier = {
         .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
@@ -3401,30 +4732,39 @@ void lvk::VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer, size_t dstOff
       dstMask |= VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
       barrier.dstAccessMask |= VK_ACCESS_MEMORY_READ_BIT;
     }
-    vkCmdPipelineBarrier(
-        wrapper.cmdBuf_, VK_PIPELINE_STAGE_TRANSFER_BIT, dstMask, VkDependencyFlags{}, 0, nullptr, 1, &barrier, 0, nullptr);
-    desc.handle_ = ctx_.immediate_->submit(wrapper);
-    regions_.push_back(desc);
+    // transfer-only queues do not support these pipeline stages; the semaphore wait on the consuming queue makes the copy visible there
+    if (immediate_.getQueueType() != QueueType_Transfer) {
+      vkCmdPipelineBarrier(
+          wrapper.cmdBuf_, VK_PIPELINE_STAGE_TRANSFER_BIT, dstMask, VkDependencyFlags{}, 0, nullptr, 1, &barrier, 0, nullptr);
+    }
+    desc.handle_ = immediate_.submit(wrapper);
+    inFlightRegions_.push_back(desc);
+    handle = desc.handle_;
 
     size -= chunkSize;
     data = (uint8_t*)data + chunkSize;
     dstOffset += chunkSize;
   }
+
+  return handle;
 }
 
-void lvk::VulkanStagingDevice::imageData2D(VulkanImage& image,
-                                           const VkRect2D& imageRegion,
-                                           uint32_t baseMipLevel,
-                                           uint32_t numMipLevels,
-                                           uint32_t layer,
-                                           uint32_t numLayers,
-                                           VkFormat format,
-                                           const void* data,
-                                           uint32_t bufferRowLength) {
+lvk::SubmitHandle lvk::VulkanStagingDevice::imageData2D(VulkanImage& image,
+                                                        const VkRect2D& imageRegion,
+                                                        uint32_t baseMipLevel,
+                                                        uint32_t numMipLevels,
+                                                        uint32_t layer,
+                                                        uint32_t numLayers,
+                                                        VkFormat format,
+                                                        const void* data,
+                                                        uint32_t bufferRowLength,
+                                                        bool* outIsPending) {
   LVK_PROFILER_FUNCTION();
 
   LVK_ASSERT(numMipLevels <= LVK_MAX_MIP_LEVELS);
 
+  std::lock_guard lock(mutex_);
+
   const Format texFormat = vkFormatToFormat(format);
 
   // divide the width and height by 2 until we get to the size of level 'baseMipLevel'
@@ -3450,22 +4790,17 @@ void lvk::VulkanStagingDevice::imageData2D(VulkanImage& image,
 
   const uint32_t storageSize = layerStorageSize * numLayers;
 
-  ensureStagingBufferSize(storageSize);
+  // no support for copying images in multiple smaller chunks
+  MemoryRegionDesc desc = allocate(storageSize, storageSize, !outIsPending);
 
-  LVK_ASSERT(storageSize <= stagingBufferSize_);
-
-  MemoryRegionDesc desc = getNextFreeOffset(storageSize);
-  // No support for copying image in multiple smaller chunk sizes. If we get smaller buffer size than storageSize, we will wait for GPU idle
-  // and get bigger chunk.
-  if (desc.size_ < storageSize) {
-    waitAndReset();
-    desc = getNextFreeOffset(storageSize);
+  if (!desc.size_) {
+    *outIsPending = true;
+    return {};
   }
-  LVK_ASSERT(desc.size_ >= storageSize);
 
-  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = ctx_.immediate_->acquire();
+  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = immediate_.acquire();
 
-  lvk::VulkanBuffer* stagingBuffer = ctx_.buffersPool_.get(stagingBuffer_);
+  lvk::VulkanBuffer* stagingBuffer = getStagingBuffer(desc);
 
   stagingBuffer->bufferSubData(ctx_, desc.offset_, storageSize, data);
 
@@ -3563,42 +4898,39 @@ void lvk::VulkanStagingDevice::imageData2D(VulkanImage& image,
 
   image.vkImageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-  desc.handle_ = ctx_.immediate_->submit(wrapper);
-  regions_.push_back(desc);
+  desc.handle_ = immediate_.submit(wrapper);
+  inFlightRegions_.push_back(desc);
+
+  return desc.handle_;
 }
 
-void lvk::VulkanStagingDevice::imageData3D(VulkanImage& image,
-                                           const VkOffset3D& offset,
-                                           const VkExtent3D& extent,
-                                           VkFormat format,
-                                           const void* data) {
+lvk::SubmitHandle lvk::VulkanStagingDevice::imageData3D(VulkanImage& image,
+                                                        const VkOffset3D& offset,
+                                                        const VkExtent3D& extent,
+                                                        VkFormat format,
+                                                        const void* data,
+                                                        bool* outIsPending) {
   LVK_PROFILER_FUNCTION();
   LVK_ASSERT_MSG(image.numLevels_ == 1, "Can handle only 3D images with exactly 1 mip-level");
   LVK_ASSERT_MSG((offset.x == 0) && (offset.y == 0) && (offset.z == 0), "Can upload only full-size 3D images");
   const uint32_t storageSize = extent.width * extent.height * extent.depth * getBytesPerPixel(format);
 
-  ensureStagingBufferSize(storageSize);
-
-  LVK_ASSERT_MSG(storageSize <= stagingBufferSize_, "No support for copying image in multiple smaller chunk sizes");
+  std::lock_guard lock(mutex_);
 
-  // get next staging buffer free offset
-  MemoryRegionDesc desc = getNextFreeOffset(storageSize);
+  // no support for copying images in multiple smaller chunks
+  MemoryRegionDesc desc = allocate(storageSize, storageSize, !outIsPending);
 
-  // No support for copying image in multiple smaller chunk sizes.
-  // If we get smaller buffer size than storageSize, we will wait for GPU idle and get a bigger chunk.
-  if (desc.size_ < storageSize) {
-    waitAndReset();
-    desc = getNextFreeOffset(storageSize);
+  if (!desc.size_) {
+    *outIsPending = true;
+    return {};
   }
 
-  LVK_ASSERT(desc.size_ >= storageSize);
-
-  lvk::VulkanBuffer* stagingBuffer = ctx_.buffersPool_.get(stagingBuffer_);
+  lvk::VulkanBuffer* stagingBuffer = getStagingBuffer(desc);
 
   // 1. Copy the pixel data into the host visible staging buffer
   stagingBuffer->bufferSubData(ctx_, desc.offset_, storageSize, data);
 
-  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = ctx_.immediate_->acquire();
+  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = immediate_.acquire();
 
   // 1. Transition initial image layout into TRANSFER_DST_OPTIMAL
   lvk::imageMemoryBarrier2(wrapper.cmdBuf_,
@@ -3641,8 +4973,10 @@ void lvk::VulkanStagingDevice::imageData3D(VulkanImage& image,
 
   image.vkImageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-  desc.handle_ = ctx_.immediate_->submit(wrapper);
-  regions_.push_back(desc);
+  desc.handle_ = immediate_.submit(wrapper);
+  inFlightRegions_.push_back(desc);
+
+  return desc.handle_;
 }
 
 void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
@@ -3654,27 +4988,15 @@ void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
   LVK_ASSERT(image.vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
   LVK_ASSERT(range.layerCount == 1);
 
-  const uint32_t storageSize = extent.width * extent.height * extent.depth * getBytesPerPixel(format);
-
-  ensureStagingBufferSize(storageSize);
-
-  LVK_ASSERT(storageSize <= stagingBufferSize_);
+  std::lock_guard lock(mutex_);
 
-  // get next staging buffer free offset
-  MemoryRegionDesc desc = getNextFreeOffset(storageSize);
-
-  // No support for copying image in multiple smaller chunk sizes.
-  // If we get smaller buffer size than storageSize, we will wait for GPU idle and get a bigger chunk.
-  if (desc.size_ < storageSize) {
-    waitAndReset();
-    desc = getNextFreeOffset(storageSize);
-  }
+  const uint32_t storageSize = extent.width * extent.height * extent.depth * getBytesPerPixel(format);
 
-  LVK_ASSERT(desc.size_ >= storageSize);
+  MemoryRegionDesc desc = allocate(storageSize, storageSize);
 
-  lvk::VulkanBuffer* stagingBuffer = ctx_.buffersPool_.get(stagingBuffer_);
+  lvk::VulkanBuffer* stagingBuffer = getStagingBuffer(desc);
 
-  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper1 = ctx_.immediate_->acquire();
+  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper1 = immediate_.acquire();
 
   // 1. Transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
   lvk::imageMemoryBarrier2(
@@ -3712,10 +5034,10 @@ void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
   };
   vkCmdCopyImageToBuffer2(wrapper1.cmdBuf_, &copyInfo);
 
-  desc.handle_ = ctx_.immediate_->submit(wrapper1);
-  regions_.push_back(desc);
+  desc.handle_ = immediate_.submit(wrapper1);
+  inFlightRegions_.push_back(desc);
 
-  waitAndReset();
+  immediate_.wait(desc.handle_);
 
   if (!stagingBuffer->isCoherentMemory_) {
     stagingBuffer->invalidateMappedMemory(ctx_, desc.offset_, desc.size_);
@@ -3725,7 +5047,7 @@ void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
   memcpy(outData, stagingBuffer->getMappedPtr() + desc.offset_, storageSize);
 
   // 4. Transition back to the initial image layout
-  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper2 = ctx_.immediate_->acquire();
+  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper2 = immediate_.acquire();
 
   lvk::imageMemoryBarrier2(
       wrapper2.cmdBuf_,
@@ -3736,132 +5058,294 @@ void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
       image.vkImageLayout_,
       range);
 
-  ctx_.immediate_->wait(ctx_.immediate_->submit(wrapper2));
+  immediate_.wait(immediate_.submit(wrapper2));
+}
+
+lvk::VulkanBuffer* lvk::VulkanStagingDevice::getStagingBuffer(const MemoryRegionDesc& desc) const {
+  LVK_ASSERT(desc.block_ < blocks_.size());
+
+  lvk::VulkanBuffer* buf = ctx_.buffersPool_.get(blocks_[desc.block_].buffer_);
+
+  LVK_ASSERT(buf);
+
+  return buf;
 }
 
-void lvk::VulkanStagingDevice::ensureStagingBufferSize(uint32_t sizeNeeded) {
+lvk::VulkanStagingDevice::StagingBlock lvk::VulkanStagingDevice::createBlock(uint64_t size) {
   LVK_PROFILER_FUNCTION();
 
-  const uint32_t alignedSize = std::max(getAlignedSize(sizeNeeded, kStagingBufferAlignment), minBufferSize_);
+  const VkDeviceSize blockSize = std::min(std::max(getAlignedSize(size, kStagingBufferAlignment), minBufferSize_), maxBufferSize_);
+
+  char debugName[256] = {0};
+  snprintf(debugName, sizeof(debugName) - 1, "Buffer: staging buffer %u", stagingBufferCounter_++);
+
+  StagingBlock block = {
+      .buffer_ = {&ctx_,
+                  ctx_.createBuffer(blockSize,
+                                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                    nullptr,
+                                    debugName)},
+      .size_ = blockSize,
+  };
+  LVK_ASSERT(!block.buffer_.empty());
 
-  sizeNeeded = alignedSize < ctx_.config_.maxStagingBufferSize ? alignedSize : ctx_.config_.maxStagingBufferSize;
+  return block;
+}
 
-  if (!stagingBuffer_.empty()) {
-    const bool isEnoughSize = sizeNeeded <= stagingBufferSize_;
-    const bool isMaxSize = stagingBufferSize_ == ctx_.config_.maxStagingBufferSize;
+bool lvk::VulkanStagingDevice::tryAllocate(uint32_t blockIndex, uint64_t size, uint64_t minSize, MemoryRegionDesc& outDesc) {
+  StagingBlock& block = blocks_[blockIndex];
 
-    if (isEnoughSize || isMaxSize) {
-      return;
-    }
+  // contiguous free ranges: [head_, size_) and [0, tail_) if the ring is not wrapped, or [head_, tail_) if it is
+  const uint64_t freeAtHead = block.isWrapped_ ? block.tail_ - block.head_ : block.size_ - block.head_;
+  const uint64_t freeAtStart = block.isWrapped_ ? 0 : block.tail_;
+
+  uint64_t offset = block.head_;
+  uint64_t allocSize = std::min(size, freeAtHead);
+
+  if (freeAtHead < size && freeAtStart > freeAtHead) {
+    // wrap around and skip the unused end of the block
+    offset = 0;
+    allocSize = std::min(size, freeAtStart);
+  }
+
+  if (allocSize < minSize) {
+    return false;
   }
 
-  waitAndReset();
+  if (offset < block.head_) {
+    block.isWrapped_ = true;
+  }
+
+  block.head_ = offset + allocSize;
+  block.numInFlight_++;
+
+  outDesc = {
+      .block_ = blockIndex,
+      .offset_ = offset,
+      .size_ = allocSize,
+      .handle_ = SubmitHandle(),
+  };
+
+  return true;
+}
 
-  // deallocate the previous staging buffer
-  stagingBuffer_ = nullptr;
+bool lvk::VulkanStagingDevice::tryAllocateFromAnyBlock(uint64_t size, uint64_t minSize, MemoryRegionDesc& outDesc) {
+  const uint32_t numBlocks = (uint32_t)blocks_.size();
 
-  // if the combined size of the new staging buffer and the existing one is larger than the limit imposed by some architectures on buffers
-  // that are device and host visible, we need to wait for the current buffer to be destroyed before we can allocate a new one
-  if ((sizeNeeded + stagingBufferSize_) > ctx_.config_.maxStagingBufferSize) {
-    ctx_.waitDeferredTasks();
+  // the current block is tried first
+  for (uint32_t i = 0; i != numBlocks; i++) {
+    const uint32_t blockIndex = (currentBlock_ + i) % numBlocks;
+    if (tryAllocate(blockIndex, size, minSize, outDesc)) {
+      currentBlock_ = blockIndex;
+      return true;
+    }
   }
 
-  stagingBufferSize_ = sizeNeeded;
+  return false;
+}
+
+void lvk::VulkanStagingDevice::retireCompletedRegions() {
+  LVK_PROFILER_FUNCTION();
 
-  char debugName[256] = {0};
-  snprintf(debugName, sizeof(debugName) - 1, "Buffer: staging buffer %u", stagingBufferCounter_++);
+  // regions are retired in submission order, so we only have to check the oldest ones
+  while (!inFlightRegions_.empty() && immediate_.isReady(inFlightRegions_.front().handle_)) {
+    const MemoryRegionDesc& r = inFlightRegions_.front();
+    StagingBlock& block = blocks_[r.block_];
 
-  stagingBuffer_ = {&ctx_,
-                    ctx_.createBuffer(stagingBufferSize_,
-                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                      nullptr,
-                                      debugName)};
-  LVK_ASSERT(!stagingBuffer_.empty());
+    if (r.offset_ < block.tail_) {
+      // the tail has followed the head around the ring
+      block.isWrapped_ = false;
+    }
+    block.tail_ = r.offset_ + r.size_;
+
+    LVK_ASSERT(block.numInFlight_);
+
+    if (--block.numInFlight_ == 0) {
+      block.head_ = 0;
+      block.tail_ = 0;
+      block.isWrapped_ = false;
+    }
 
-  regions_.clear();
-  regions_.push_back({0, stagingBufferSize_, SubmitHandle()});
+    inFlightRegions_.pop_front();
+  }
 }
 
-lvk::VulkanStagingDevice::MemoryRegionDesc lvk::VulkanStagingDevice::getNextFreeOffset(uint32_t size) {
+lvk::VulkanStagingDevice::MemoryRegionDesc lvk::VulkanStagingDevice::allocate(uint64_t size, uint64_t minSize, bool canStall) {
   LVK_PROFILER_FUNCTION();
 
-  const uint32_t requestedAlignedSize = getAlignedSize(size, kStagingBufferAlignment);
+  size = getAlignedSize(size, kStagingBufferAlignment);
+  minSize = getAlignedSize(minSize, kStagingBufferAlignment);
 
-  ensureStagingBufferSize(requestedAlignedSize);
+  LVK_ASSERT(minSize && minSize <= size);
+  LVK_ASSERT_MSG(minSize <= maxBufferSize_, "The requested staging memory size exceeds ContextConfig::maxStagingBufferSize");
 
-  LVK_ASSERT(!regions_.empty());
+  MemoryRegionDesc desc;
 
-  // if we can't find an available region that is big enough to store requestedAlignedSize, return whatever we could find, which will be
-  // stored in bestNextIt
-  auto bestNextIt = regions_.begin();
+  // 1. Bump the head of one of the existing blocks
+  if (tryAllocateFromAnyBlock(size, minSize, desc)) {
+    return desc;
+  }
 
-  for (auto it = regions_.begin(); it != regions_.end(); ++it) {
-    if (ctx_.immediate_->isReady(it->handle_)) {
-      // This region is free, but is it big enough?
-      if (it->size_ >= requestedAlignedSize) {
-        // It is big enough!
-        const uint32_t unusedSize = it->size_ - requestedAlignedSize;
-        const uint32_t unusedOffset = it->offset_ + requestedAlignedSize;
+  // 2. Retire completed regions and try again
+  retireCompletedRegions();
 
-        // Return this region and add the remaining unused size to the regions_ deque
-        SCOPE_EXIT {
-          regions_.erase(it);
-          if (unusedSize > 0) {
-            regions_.insert(regions_.begin(), {unusedOffset, unusedSize, SubmitHandle()});
-          }
-        };
+  if (tryAllocateFromAnyBlock(size, minSize, desc)) {
+    return desc;
+  }
 
-        return {it->offset_, requestedAlignedSize, SubmitHandle()};
-      }
-      // cache the largest available region that isn't as big as the one we're looking for
-      if (it->size_ > bestNextIt->size_) {
-        bestNextIt = it;
-      }
-    }
+  // 3. Create a new block
+  if (blocks_.size() < maxNumBlocks_) {
+    blocks_.push_back(createBlock(size));
+    currentBlock_ = (uint32_t)blocks_.size() - 1;
+    LVK_VERIFY(tryAllocate(currentBlock_, size, minSize, desc));
+    return desc;
   }
 
-  // we found a region that is available that is smaller than the requested size. It's the best we can do
-  if (bestNextIt != regions_.end() && ctx_.immediate_->isReady(bestNextIt->handle_)) {
-    SCOPE_EXIT {
-      regions_.erase(bestNextIt);
-    };
+  if (!canStall && !inFlightRegions_.empty()) {
+    return {};
+  }
 
-    return {bestNextIt->offset_, bestNextIt->size_, SubmitHandle()};
+  // 4. Stall until the GPU retires enough regions
+  LVK_PROFILER_ZONE("VulkanStagingDevice::allocate() stall", LVK_PROFILER_COLOR_WAIT);
+  numStalls_++;
+  while (!tryAllocateFromAnyBlock(size, minSize, desc)) {
+    if (inFlightRegions_.empty()) {
+      // nothing is in flight but no block is large enough: replace the current block with a bigger one
+      blocks_[currentBlock_] = createBlock(size);
+      continue;
+    }
+    immediate_.wait(inFlightRegions_.front().handle_);
+    retireCompletedRegions();
   }
+  LVK_PROFILER_ZONE_END();
+
+  return desc;
+}
 
-  // nothing was available. Let's wait for the entire staging buffer to become free
-  waitAndReset();
+lvk::VulkanTransientAllocator::VulkanTransientAllocator(VulkanContext& ctx) : ctx_(ctx) {
+  const VkPhysicalDeviceLimits& limits = ctx_.getVkPhysicalDeviceProperties().limits;
 
-  // waitAndReset() adds a region that spans the entire buffer. Since we'll be using part of it, we need to replace it with a used block and
-  // an unused portion
-  regions_.clear();
+  minAlignment_ = std::max({minAlignment_, limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment});
+}
+
+lvk::TransientAllocation lvk::VulkanTransientAllocator::allocate(size_t size, size_t alignment) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(size);
+  LVK_ASSERT_MSG(alignment && (alignment & (alignment - 1)) == 0, "Alignment should be a power of two");
+
+  // the allocation can be bound as a uniform or storage buffer at `offset`
+  alignment = std::max(alignment, (size_t)minAlignment_);
 
-  // store the unused size in the deque first...
-  const uint64_t unusedSize = stagingBufferSize_ > requestedAlignedSize ? stagingBufferSize_ - requestedAlignedSize : 0;
+  std::lock_guard lock(mutex_);
 
-  if (unusedSize) {
-    const uint64_t unusedOffset = stagingBufferSize_ - unusedSize;
-    regions_.insert(regions_.begin(), {unusedOffset, unusedSize, SubmitHandle()});
+  if (current_ == ~0u || getAlignedSize(chunks_[current_].offset_, alignment) + size > chunks_[current_].size_) {
+    // the previous chunk stays in use until the end of the frame
+    current_ = acquireChunk(size);
   }
 
-  // ...and then return the smallest free region that can hold the requested size
+  Chunk& chunk = chunks_[current_];
+
+  // any command buffer being recorded right now can use the allocation, even if another queue submits first; allocations made
+  // outside of command buffers are retired by the next graphics submit
+  chunk.isInUse_[QueueType_Graphics] |= isRecording_[QueueType_Graphics] || !isRecording_[QueueType_Compute];
+  chunk.isInUse_[QueueType_Compute] |= isRecording_[QueueType_Compute];
+
+  const uint64_t offset = getAlignedSize(chunk.offset_, alignment);
+
+  chunk.offset_ = offset + size;
+
   return {
-      .offset_ = 0,
-      .size_ = stagingBufferSize_ - unusedSize,
-      .handle_ = SubmitHandle(),
+      .ptr = chunk.ptr_ + offset,
+      .gpuAddress = chunk.gpuAddress_ + offset,
+      .buffer = chunk.buffer_,
+      .offset = offset,
+  };
+}
+
+uint32_t lvk::VulkanTransientAllocator::acquireChunk(uint64_t minSize) {
+  // 1. Recycle a chunk which is not used by the current frame and has been retired by the GPU
+  for (uint32_t i = 0; i != chunks_.size(); i++) {
+    Chunk& chunk = chunks_[i];
+    if (!chunk.isInUse_[QueueType_Graphics] && !chunk.isInUse_[QueueType_Compute] && chunk.size_ >= minSize &&
+        ctx_.immediate_->isReady(chunk.handle_) && ctx_.immediateCompute_->isReady(chunk.computeHandle_)) {
+      chunk.offset_ = 0;
+      chunk.handle_ = {};
+      chunk.computeHandle_ = {};
+      return i;
+    }
+  }
+
+  // 2. Create a new chunk
+  LVK_PROFILER_ZONE("VulkanTransientAllocator::acquireChunk() create", LVK_PROFILER_COLOR_CREATE);
+
+  const VkDeviceSize chunkSize = std::max(getAlignedSize(minSize, minAlignment_), ctx_.config_.transientChunkSize);
+
+  char debugName[256] = {0};
+  snprintf(debugName, sizeof(debugName) - 1, "Buffer: transient chunk %u", chunkCounter_++);
+
+  Chunk chunk = {
+      .buffer_ = {&ctx_,
+                  ctx_.createBuffer(chunkSize,
+                                    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                                        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                    nullptr,
+                                    debugName,
+                                    true)},
+      .size_ = chunkSize,
   };
+  LVK_ASSERT(!chunk.buffer_.empty());
+
+  const lvk::VulkanBuffer* buf = ctx_.buffersPool_.get(chunk.buffer_);
+
+  LVK_ASSERT(buf && buf->isMapped());
+
+  chunk.ptr_ = buf->getMappedPtr();
+  chunk.gpuAddress_ = buf->vkDeviceAddress_;
+
+  chunks_.push_back(std::move(chunk));
+
+  LVK_PROFILER_ZONE_END();
+
+  return (uint32_t)chunks_.size() - 1;
 }
 
-void lvk::VulkanStagingDevice::waitAndReset() {
-  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_WAIT);
+void lvk::VulkanTransientAllocator::beginFrame(QueueType queue) {
+  LVK_ASSERT(queue == QueueType_Graphics || queue == QueueType_Compute);
 
-  for (const MemoryRegionDesc& r : regions_) {
-    ctx_.immediate_->wait(r.handle_);
-  };
+  std::lock_guard lock(mutex_);
+
+  isRecording_[queue] = true;
+}
+
+void lvk::VulkanTransientAllocator::endFrame(SubmitHandle handle) {
+  LVK_PROFILER_FUNCTION();
+
+  const QueueType queue = VulkanImmediateCommands::getQueueType(handle) == QueueType_Compute ? QueueType_Compute : QueueType_Graphics;
+
+  std::lock_guard lock(mutex_);
+
+  for (Chunk& chunk : chunks_) {
+    if (!chunk.isInUse_[queue]) {
+      continue;
+    }
+    const lvk::VulkanBuffer* buf = ctx_.buffersPool_.get(chunk.buffer_);
+    if (!buf->isCoherentMemory_) {
+      buf->flushMappedMemory(ctx_, 0, VK_WHOLE_SIZE);
+    }
+    if (queue == QueueType_Compute) {
+      chunk.computeHandle_ = handle;
+    } else {
+      chunk.handle_ = handle;
+    }
+    chunk.isInUse_[queue] = false;
+  }
 
-  regions_.clear();
-  regions_.push_back({0, stagingBufferSize_, SubmitHandle()});
+  isRecording_[queue] = false;
+  current_ = ~0u;
 }
 
 lvk::VulkanContext::VulkanContext(const lvk::ContextConfig& config, void* window, void* display, VkSurfaceKHR surface)
@@ -3871,6 +5355,10 @@ lvk::VulkanContext::VulkanContext(const lvk::ContextConfig& config, void* window
 
   pimpl_ = std::make_unique<VulkanContextImpl>();
 
+  if (config.pipelineCacheFileName) {
+    pimpl_->pipelineCacheFileName_ = config.pipelineCacheFileName;
+  }
+
   if (volkInitialize() != VK_SUCCESS) {
     LLOGW("volkInitialize() failed\n");
     exit(255);
@@ -3895,8 +5383,32 @@ lvk::VulkanContext::VulkanContext(const lvk::ContextConfig& config, void* window
 lvk::VulkanContext::~VulkanContext() {
   LVK_PROFILER_FUNCTION();
 
+  {
+    std::lock_guard lock(pimpl_->compilerMutex_);
+    pimpl_->compilerExit_ = true;
+  }
+  pimpl_->compilerCondition_.notify_all();
+  // the remaining queued pipelines are compiled before the threads exit
+  for (std::thread& t : pimpl_->compilerThreads_) {
+    t.join();
+  }
+
+  if (!pimpl_->pipelineCacheFileName_.empty()) {
+    LLOGL("Pipeline cache: %u hits, %u misses\n", pimpl_->numPipelineCacheHits_.load(), pimpl_->numPipelineCacheMisses_.load());
+    savePipelineCache();
+  }
+  if (pimpl_->pipelineCacheSaveFuture_.valid()) {
+    pimpl_->pipelineCacheSaveFuture_.wait();
+  }
+
   VK_ASSERT(vkDeviceWaitIdle(vkDevice_));
 
+  for (const VulkanContextImpl::TimingFrame& f : pimpl_->timingFrames_) {
+    if (f.queryPool_) {
+      vkDestroyQueryPool(vkDevice_, f.queryPool_, nullptr);
+    }
+  }
+
 #if defined(LVK_WITH_TRACY_GPU)
   TracyVkDestroy(pimpl_->tracyVkCtx_);
   if (pimpl_->tracyCommandPool_) {
@@ -3904,12 +5416,22 @@ lvk::VulkanContext::~VulkanContext() {
   }
 #endif // LVK_WITH_TRACY_GPU
 
+  transientAllocator_.reset(nullptr);
+  readbacksPool_.clear();
+  freeReadbackBuffers_.clear();
   stagingDevice_.reset(nullptr);
+  stagingDeviceAsync_.reset(nullptr);
   swapchain_.reset(nullptr); // swapchain has to be destroyed prior to Surface
 
+  for (const std::unique_ptr<VulkanContextImpl::SecondaryCommandPool>& pool : pimpl_->secondaryPools_) {
+    vkDestroyCommandPool(vkDevice_, pool->commandPool_, nullptr);
+  }
+  pimpl_->secondaryPools_.clear();
+
   vkDestroySemaphore(vkDevice_, timelineSemaphore_, nullptr);
 
   destroy(dummyTexture_);
+  destroy(descriptorBuffer_);
 
   for (VulkanContextImpl::YcbcrConversionData& data : pimpl_->ycbcrConversionData_) {
     if (data.info.conversion != VK_NULL_HANDLE) {
@@ -3948,13 +5470,25 @@ lvk::VulkanContext::~VulkanContext() {
 
   waitDeferredTasks();
 
+  immediateTransfer_.reset(nullptr);
+  immediateCompute_.reset(nullptr);
   immediate_.reset(nullptr);
 
+  for (const VulkanContextImpl::SparseMemoryBlock& block : pimpl_->sparseBlocks_) {
+    vkFreeMemory(vkDevice_, block.memory_, nullptr);
+  }
+  if (pimpl_->sparseTimelineSemaphore_) {
+    vkDestroySemaphore(vkDevice_, pimpl_->sparseTimelineSemaphore_, nullptr);
+  }
+
   for (const DescriptorSet& dset : DSets_) {
     vkDestroyDescriptorPool(vkDevice_, dset.vkDPool, nullptr);
     vkDestroyDescriptorSetLayout(vkDevice_, dset.vkDSL, nullptr);
   }
   vkDestroyDescriptorSetLayout(vkDevice_, dslInputAttachments_, nullptr);
+  vkDestroyPipeline(vkDevice_, pipelineMipmap_, nullptr);
+  vkDestroyPipelineLayout(vkDevice_, pipelineLayoutMipmap_, nullptr);
+  vkDestroyDescriptorSetLayout(vkDevice_, dslMipmap_, nullptr);
   vkDestroySurfaceKHR(vkInstance_, vkSurface_, nullptr);
   vkDestroyPipelineCache(vkDevice_, pipelineCache_, nullptr);
 
@@ -3977,9 +5511,20 @@ lvk::VulkanContext::~VulkanContext() {
   LLOGL("Vulkan graphics pipelines created: %u\n", VulkanPipelineBuilder::getNumPipelinesCreated());
 }
 
-lvk::ICommandBuffer& lvk::VulkanContext::acquireCommandBuffer() {
+lvk::ICommandBuffer& lvk::VulkanContext::acquireCommandBuffer(QueueType queue) {
   LVK_PROFILER_FUNCTION();
 
+  LVK_ASSERT_MSG(queue != QueueType_Transfer, "The transfer queue is reserved for asynchronous uploads");
+
+  if (queue == QueueType_Compute) {
+    LVK_ASSERT_MSG(!pimpl_->currentCommandBufferCompute_.ctx_, "Cannot acquire more than 1 compute command buffer simultaneously");
+
+    pimpl_->currentCommandBufferCompute_ = CommandBuffer(this, QueueType_Compute);
+    transientAllocator_->beginFrame(QueueType_Compute);
+
+    return pimpl_->currentCommandBufferCompute_;
+  }
+
   LVK_ASSERT_MSG(!pimpl_->currentCommandBuffer_.ctx_, "Cannot acquire more than 1 command buffer simultaneously");
 
 #if defined(_M_ARM64)
@@ -3987,6 +5532,7 @@ lvk::ICommandBuffer& lvk::VulkanContext::acquireCommandBuffer() {
 #endif
 
   pimpl_->currentCommandBuffer_ = CommandBuffer(this);
+  transientAllocator_->beginFrame(QueueType_Graphics);
 
   return pimpl_->currentCommandBuffer_;
 }
@@ -3999,6 +5545,24 @@ lvk::SubmitHandle lvk::VulkanContext::submit(lvk::ICommandBuffer& commandBuffer,
   LVK_ASSERT(vkCmdBuffer);
   LVK_ASSERT(vkCmdBuffer->ctx_);
   LVK_ASSERT(vkCmdBuffer->wrapper_);
+  LVK_ASSERT(!vkCmdBuffer->isSecondary_);
+  LVK_ASSERT_MSG(!vkCmdBuffer->numTimingScopes_, "Did you forget to call cmdEndTimingScope()?");
+
+  addCommandBufferStats(vkCmdBuffer->stats_);
+
+  if (VulkanImmediateCommands::getQueueType(vkCmdBuffer->wrapper_->handle_) == QueueType_Compute) {
+    LVK_ASSERT_MSG(!present, "Cannot present from the compute queue");
+    // transient allocations made while this command buffer was recorded are retired together with this submit
+    transientAllocator_->endFrame(vkCmdBuffer->wrapper_->handle_);
+    vkCmdBuffer->lastSubmitHandle_ = immediateCompute_->submit(*vkCmdBuffer->wrapper_);
+    const SubmitHandle handle = vkCmdBuffer->lastSubmitHandle_;
+    // reset
+    pimpl_->currentCommandBufferCompute_ = {};
+    processDeferredTasks();
+    // the current dset is not reused until both queues are done with it
+    DSets_[lastUpdatedDSet_].computeHandle_ = handle;
+    return handle;
+  }
 
 #if defined(LVK_WITH_TRACY_GPU)
   TracyVkCollect(pimpl_->tracyVkCtx_, vkCmdBuffer->wrapper_->cmdBuf_);
@@ -4016,6 +5580,13 @@ lvk::SubmitHandle lvk::VulkanContext::submit(lvk::ICommandBuffer& commandBuffer,
 
   const bool shouldPresent = hasSwapchain() && present;
 
+  // transient allocations made while this command buffer was recorded are retired together with this submit; not under
+  // `lockImmediate`, as VulkanTransientAllocator queries the queues while holding its own mutex
+  transientAllocator_->endFrame(vkCmdBuffer->wrapper_->handle_);
+
+  // other threads can submit uploads in between - keep our semaphores to ourselves
+  std::unique_lock lockImmediate(immediate_->getMutex());
+
   if (shouldPresent) {
     // if we a presenting a swapchain image, signal our timeline semaphore
     const uint64_t signalValue = swapchain_->currentFrameIndex_ + swapchain_->getNumSwapchainImages();
@@ -4024,16 +5595,66 @@ lvk::SubmitHandle lvk::VulkanContext::submit(lvk::ICommandBuffer& commandBuffer,
     immediate_->signalSemaphore(timelineSemaphore_, signalValue);
   }
 
+  if (shouldPresent) {
+    swapchain_->setLatencyMarker(VK_LATENCY_MARKER_RENDERSUBMIT_START_NV);
+  }
+
   vkCmdBuffer->lastSubmitHandle_ = immediate_->submit(*vkCmdBuffer->wrapper_);
 
   if (shouldPresent) {
+    swapchain_->setLatencyMarker(VK_LATENCY_MARKER_RENDERSUBMIT_END_NV);
     swapchain_->present(immediate_->acquireLastSubmitSemaphore());
   }
 
+  lockImmediate.unlock();
+
+  // a frame ends with a present; without a swapchain, every submit is a frame
+  if (shouldPresent || !hasSwapchain()) {
+    endTimingFrame();
+    checkMemoryBudget();
+  }
+
   processDeferredTasks();
 
+  if (!pimpl_->pipelineCacheFileName_.empty() && config_.pipelineCacheSaveIntervalSec &&
+      std::chrono::steady_clock::now() - pimpl_->lastPipelineCacheSaveTime_ >=
+          std::chrono::seconds(config_.pipelineCacheSaveIntervalSec)) {
+    savePipelineCache();
+  }
+
   SubmitHandle handle = vkCmdBuffer->lastSubmitHandle_;
 
+  // assign the submit handle to all secondary command buffers executed by this submit and retire the completed ones
+  {
+    std::lock_guard lock(pimpl_->secondaryPoolsMutex_);
+    for (const std::unique_ptr<VulkanContextImpl::SecondaryCommandPool>& pool : pimpl_->secondaryPools_) {
+      for (const std::unique_ptr<VulkanContextImpl::SecondaryCommandBuffer>& buf : pool->buffers_) {
+        if (buf->isAvailable_) {
+          continue;
+        }
+        if (buf->handle_.empty()) {
+          for (const lvk::CommandBuffer* executed : pimpl_->secondaryBuffersExecuted_) {
+            if (executed == &buf->cmdBuffer_) {
+              buf->handle_ = handle;
+              break;
+            }
+          }
+          if (buf->handle_.empty() && !buf->wrapper_.isEncoding_) {
+            // finished but never executed - nothing on the GPU references it
+            buf->isAvailable_ = true;
+          }
+        } else if (immediate_->isReady(buf->handle_)) {
+          buf->handle_ = {};
+          buf->isAvailable_ = true;
+        }
+      }
+    }
+    pimpl_->secondaryBuffersExecuted_.clear();
+  }
+
+  // the current dset can be used by every submit
+  DSets_[lastUpdatedDSet_].handle_ = handle;
+
   // assign the last submit handle to all previous "orphan" dsets
   const size_t numSets = DSets_.size();
   for (size_t count = 0; count != numSets; count++) {
@@ -4053,44 +5674,231 @@ lvk::SubmitHandle lvk::VulkanContext::submit(lvk::ICommandBuffer& commandBuffer,
 }
 
 void lvk::VulkanContext::wait(SubmitHandle handle) {
-  immediate_->wait(handle);
+  getImmediateCommands(handle)->wait(handle);
 }
 
-lvk::Holder<lvk::BufferHandle> lvk::VulkanContext::createBuffer(const BufferDesc& requestedDesc, const char* debugName, Result* outResult) {
-  BufferDesc desc = requestedDesc;
-
-  if (debugName && *debugName)
-    desc.debugName = debugName;
-
-  if (!useStaging_ && (desc.storage == StorageType_Device)) {
-    desc.storage = StorageType_HostVisible;
+void lvk::VulkanContext::gpuWait(QueueType queue, SubmitHandle handle) {
+  if (handle.empty()) {
+    return;
   }
 
-  // Use staging device to transfer data into the buffer when the storage is private to the device
-  VkBufferUsageFlags usageFlags = (desc.storage == StorageType_Device) ? VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-                                                                       : 0;
+  lvk::VulkanImmediateCommands* src = getImmediateCommands(handle);
+  lvk::VulkanImmediateCommands* dst = getImmediateCommands(queue);
 
-  if (desc.usage == 0) {
-    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Invalid buffer usage"));
-    return {};
+  if (src == dst) {
+    // submits to the same queue are already chained using binary semaphores
+    return;
   }
 
-  if (desc.usage & BufferUsageBits_Index) {
-    usageFlags |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-  }
-  if (desc.usage & BufferUsageBits_Vertex) {
-    usageFlags |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-  }
-  if (desc.usage & BufferUsageBits_Uniform) {
-    usageFlags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  if (const uint64_t value = src->getTimelineValue(handle)) {
+    dst->waitSemaphoreTimeline(src->getTimelineSemaphore(), value);
   }
+}
 
-  if (desc.usage & BufferUsageBits_Storage) {
-    usageFlags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
-  }
+bool lvk::VulkanContext::isReady(SubmitHandle handle) const {
+  return getImmediateCommands(handle)->isReady(handle);
+}
 
-  if (desc.usage & BufferUsageBits_Indirect) {
-    usageFlags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+lvk::VulkanImmediateCommands* lvk::VulkanContext::getImmediateCommands(SubmitHandle handle) const {
+  return getImmediateCommands(VulkanImmediateCommands::getQueueType(handle));
+}
+
+lvk::VulkanImmediateCommands* lvk::VulkanContext::getImmediateCommands(QueueType queue) const {
+  switch (queue) {
+  case QueueType_Compute:
+    return immediateCompute_.get();
+  case QueueType_Transfer:
+    return immediateTransfer_.get();
+  default:
+    return immediate_.get();
+  }
+}
+
+lvk::ICommandBuffer& lvk::VulkanContext::acquireSecondaryCommandBuffer(const RenderPass& renderPass, const Framebuffer& fb) {
+  LVK_PROFILER_FUNCTION();
+
+  VulkanContextImpl::SecondaryCommandBuffer* buf = nullptr;
+
+  {
+    std::lock_guard lock(pimpl_->secondaryPoolsMutex_);
+
+    const std::thread::id threadId = std::this_thread::get_id();
+
+    VulkanContextImpl::SecondaryCommandPool* pool = nullptr;
+
+    for (const std::unique_ptr<VulkanContextImpl::SecondaryCommandPool>& p : pimpl_->secondaryPools_) {
+      if (p->threadId_ == threadId) {
+        pool = p.get();
+        break;
+      }
+    }
+
+    if (!pool) {
+      pimpl_->secondaryPools_.push_back(std::make_unique<VulkanContextImpl::SecondaryCommandPool>());
+      pool = pimpl_->secondaryPools_.back().get();
+      pool->threadId_ = threadId;
+      const VkCommandPoolCreateInfo ci = {
+          .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+          .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+          .queueFamilyIndex = deviceQueues_.graphicsQueueFamilyIndex,
+      };
+      VK_ASSERT(vkCreateCommandPool(vkDevice_, &ci, nullptr, &pool->commandPool_));
+      char debugName[256] = {0};
+      snprintf(debugName, sizeof(debugName) - 1, "Command Pool: secondary %u", (uint32_t)pimpl_->secondaryPools_.size() - 1);
+      VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)pool->commandPool_, debugName));
+    }
+
+    for (const std::unique_ptr<VulkanContextImpl::SecondaryCommandBuffer>& b : pool->buffers_) {
+      if (b->isAvailable_) {
+        buf = b.get();
+        break;
+      }
+    }
+
+    if (!buf) {
+      pool->buffers_.push_back(std::make_unique<VulkanContextImpl::SecondaryCommandBuffer>());
+      buf = pool->buffers_.back().get();
+      const VkCommandBufferAllocateInfo ai = {
+          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+          .commandPool = pool->commandPool_,
+          .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+          .commandBufferCount = 1,
+      };
+      VK_ASSERT(vkAllocateCommandBuffers(vkDevice_, &ai, &buf->wrapper_.cmdBufAllocated_));
+    }
+
+    buf->isAvailable_ = false;
+    buf->handle_ = {};
+  }
+
+  // the command pool is owned by this thread, so the rest can be done without locking
+  VkFormat colorFormats[LVK_MAX_COLOR_ATTACHMENTS] = {};
+  VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+  VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+  uint32_t mipLevel = 0;
+  uint32_t fbWidth = 0;
+  uint32_t fbHeight = 0;
+
+  const uint32_t numColorAttachments = fb.getNumColorAttachments();
+
+  LVK_ASSERT(numColorAttachments == renderPass.getNumColorAttachments());
+
+  for (uint32_t i = 0; i != numColorAttachments; i++) {
+    const lvk::VulkanImage* img = texturesPool_.get(fb.color[i].texture);
+    LVK_ASSERT(img);
+    colorFormats[i] = img->vkImageFormat_;
+    samples = img->vkSamples_;
+    mipLevel = renderPass.color[i].level;
+    fbWidth = img->vkExtent_.width;
+    fbHeight = img->vkExtent_.height;
+  }
+  if (const lvk::VulkanImage* img = texturesPool_.get(fb.depthStencil.texture)) {
+    depthFormat = img->vkImageFormat_;
+    samples = img->vkSamples_;
+    mipLevel = renderPass.depth.level;
+    fbWidth = img->vkExtent_.width;
+    fbHeight = img->vkExtent_.height;
+  }
+
+  // the stencil aspect comes from the framebuffer attachment format, the same way as in cmdBeginRendering()
+  const bool isStencilFormat = renderPass.stencil.loadOp != lvk::LoadOp_Invalid && VulkanImage::isStencilFormat(depthFormat);
+
+  const VkCommandBufferInheritanceRenderingInfo renderingInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+      .viewMask = renderPass.viewMask,
+      .colorAttachmentCount = numColorAttachments,
+      .pColorAttachmentFormats = colorFormats,
+      .depthAttachmentFormat = depthFormat,
+      .stencilAttachmentFormat = isStencilFormat ? depthFormat : VK_FORMAT_UNDEFINED,
+      .rasterizationSamples = samples,
+  };
+  const VkCommandBufferInheritanceInfo inheritanceInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+      .pNext = &renderingInfo,
+  };
+  const VkCommandBufferBeginInfo bi = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+      .pInheritanceInfo = &inheritanceInfo,
+  };
+
+  buf->wrapper_.cmdBuf_ = buf->wrapper_.cmdBufAllocated_;
+  buf->wrapper_.isEncoding_ = true;
+
+  // implicitly resets the command buffer
+  VK_ASSERT(vkBeginCommandBuffer(buf->wrapper_.cmdBuf_, &bi));
+
+  buf->cmdBuffer_ = CommandBuffer(this, &buf->wrapper_);
+  buf->cmdBuffer_.framebuffer_ = fb;
+  buf->cmdBuffer_.viewMask_ = renderPass.viewMask;
+  buf->cmdBuffer_.isRendering_ = true;
+
+  // dynamic state is not inherited from the primary command buffer
+  const uint32_t width = std::max(fbWidth >> mipLevel, 1u);
+  const uint32_t height = std::max(fbHeight >> mipLevel, 1u);
+
+  buf->cmdBuffer_.cmdBindViewport({0.0f, 0.0f, (float)width, (float)height, 0.0f, +1.0f});
+  buf->cmdBuffer_.cmdBindScissorRect({0, 0, width, height});
+  buf->cmdBuffer_.cmdBindDepthState({});
+
+  vkCmdSetDepthBiasEnable(buf->wrapper_.cmdBuf_, VK_FALSE);
+
+  return buf->cmdBuffer_;
+}
+
+void lvk::VulkanContext::endSecondaryCommandBuffer(ICommandBuffer& commandBuffer) {
+  LVK_PROFILER_FUNCTION();
+
+  CommandBuffer* cmdBuffer = static_cast<CommandBuffer*>(&commandBuffer);
+
+  LVK_ASSERT(cmdBuffer->isSecondary_);
+  LVK_ASSERT(cmdBuffer->wrapper_->isEncoding_);
+
+  VK_ASSERT(vkEndCommandBuffer(cmdBuffer->wrapper_->cmdBuf_));
+
+  // submit() checks this to recycle secondary command buffers which were not executed
+  std::lock_guard lock(pimpl_->secondaryPoolsMutex_);
+
+  const_cast<VulkanImmediateCommands::CommandBufferWrapper*>(cmdBuffer->wrapper_)->isEncoding_ = false;
+  cmdBuffer->isRendering_ = false;
+}
+
+lvk::Holder<lvk::BufferHandle> lvk::VulkanContext::createBuffer(const BufferDesc& requestedDesc, const char* debugName, Result* outResult) {
+  BufferDesc desc = requestedDesc;
+
+  if (debugName && *debugName)
+    desc.debugName = debugName;
+
+  if (!useStaging_ && (desc.storage == StorageType_Device)) {
+    desc.storage = StorageType_HostVisible;
+  }
+
+  // Use staging device to transfer data into the buffer when the storage is private to the device
+  // every buffer can be read back with readbackAsync()
+  VkBufferUsageFlags usageFlags = (desc.storage == StorageType_Device) ? VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+                                                                       : VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+  if (desc.usage == 0) {
+    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Invalid buffer usage"));
+    return {};
+  }
+
+  if (desc.usage & BufferUsageBits_Index) {
+    usageFlags |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+  }
+  if (desc.usage & BufferUsageBits_Vertex) {
+    usageFlags |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+  }
+  if (desc.usage & BufferUsageBits_Uniform) {
+    usageFlags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  }
+
+  if (desc.usage & BufferUsageBits_Storage) {
+    usageFlags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  }
+
+  if (desc.usage & BufferUsageBits_Indirect) {
+    usageFlags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
   }
 
   if (desc.usage & BufferUsageBits_ShaderBindingTable) {
@@ -4111,7 +5919,7 @@ lvk::Holder<lvk::BufferHandle> lvk::VulkanContext::createBuffer(const BufferDesc
   const VkMemoryPropertyFlags memFlags = storageTypeToVkMemoryPropertyFlags(desc.storage);
 
   Result result;
-  BufferHandle handle = createBuffer(desc.size, usageFlags, memFlags, &result, desc.debugName);
+  BufferHandle handle = createBuffer(desc.size, usageFlags, memFlags, &result, desc.debugName, desc.isShared);
 
   if (!LVK_VERIFY(result.isOk())) {
     Result::setResult(outResult, result);
@@ -4150,7 +5958,13 @@ lvk::Holder<lvk::QueryPoolHandle> lvk::VulkanContext::createQueryPool(uint32_t n
     VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)queryPool, debugName));
   }
 
-  lvk::QueryPoolHandle handle = queriesPool_.create(std::move(queryPool));
+  lvk::QueryPoolHandle handle = queriesPool_.create(VkQueryPool(queryPool));
+
+  if (handle.empty()) {
+    vkDestroyQueryPool(vkDevice_, queryPool, nullptr);
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create QueryPool: the pool is full");
+    return {};
+  }
 
   return {this, handle};
 }
@@ -4187,8 +6001,6 @@ lvk::Holder<lvk::AccelStructHandle> lvk::VulkanContext::createAccelerationStruct
 
   Result::setResult(outResult, result);
 
-  awaitingCreation_ = true;
-
   return {this, handle};
 }
 
@@ -4280,6 +6092,38 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
     desc.usage = lvk::TextureUsageBits_Sampled;
   }
 
+  if (desc.storage == lvk::StorageType_Memoryless &&
+      ((desc.usage & ~(lvk::TextureUsageBits_Attachment | lvk::TextureUsageBits_InputAttachment)) || desc.data)) {
+    LVK_ASSERT_MSG(false, "Memoryless textures can be used only as attachments");
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Memoryless textures can be used only as attachments");
+    return {};
+  }
+
+  lvk::VulkanImage* aliasedImage = desc.aliasTexture ? texturesPool_.get(desc.aliasTexture) : nullptr;
+
+  if (desc.aliasTexture) {
+    const bool isValidAlias = aliasedImage && aliasedImage->isOwningVkImage_ && aliasedImage->isOwningVkMemory_ &&
+                              aliasedImage->vkMemory_[1] == VK_NULL_HANDLE && !aliasedImage->mappedPtr_ &&
+                              (desc.usage & lvk::TextureUsageBits_Attachment) && desc.storage != lvk::StorageType_HostVisible &&
+                              !desc.data && lvk::getNumImagePlanes(desc.format) == 1;
+    if (!isValidAlias) {
+      LVK_ASSERT_MSG(false, "Only single-plane device-local attachments can alias memory of other attachments");
+      Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Invalid TextureDesc::aliasTexture");
+      return {};
+    }
+  }
+
+  if (desc.sparse) {
+    const bool isValidSparse = type == TextureType_2D && desc.numLayers == 1 && desc.numSamples <= 1 && !desc.data && !desc.aliasTexture &&
+                               desc.storage == lvk::StorageType_Device && lvk::getNumImagePlanes(desc.format) == 1 &&
+                               !lvk::isDepthOrStencilFormat(desc.format);
+    if (!has_sparseResidency_ || !isValidSparse) {
+      LVK_ASSERT_MSG(false, "Sparse textures should be single-layer single-sample 2D color textures without initial data");
+      Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Invalid TextureDesc::sparse");
+      return {};
+    }
+  }
+
   /* Use staging device to transfer data into the image when the storage is private to the device */
   VkImageUsageFlags usageFlags = (desc.storage == StorageType_Device) ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0;
 
@@ -4309,7 +6153,12 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
 
   LVK_ASSERT_MSG(usageFlags != 0, "Invalid usage flags");
 
-  const VkMemoryPropertyFlags memFlags = storageTypeToVkMemoryPropertyFlags(desc.storage);
+  VkMemoryPropertyFlags memFlags = storageTypeToVkMemoryPropertyFlags(desc.storage);
+
+  if (desc.storage == lvk::StorageType_Memoryless && !hasLazilyAllocatedMemory_) {
+    // VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT is still valid for images backed by regular memory
+    memFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  }
 
   const bool hasDebugName = desc.debugName && *desc.debugName;
 
@@ -4364,14 +6213,15 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
 
   lvk::VulkanImage image = {
       .vkUsageFlags_ = usageFlags,
-      .vkExtent_ = vkExtent,
-      .vkType_ = vkImageType,
       .vkImageFormat_ = vkFormat,
       .vkSamples_ = vkSamples,
+      .vkExtent_ = vkExtent,
       .numLevels_ = numLevels,
       .numLayers_ = numLayers,
       .isDepthFormat_ = VulkanImage::isDepthFormat(vkFormat),
       .isStencilFormat_ = VulkanImage::isStencilFormat(vkFormat),
+      .vkType_ = vkImageType,
+      .isShared_ = desc.isShared,
   };
 
   if (hasDebugName) {
@@ -4399,6 +6249,13 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
     awaitingNewImmutableSamplers_ = true;
   }
 
+  if (desc.sparse) {
+    vkCreateFlags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+  }
+
+  // shared images can be accessed from the graphics, async compute, and transfer queues without ownership transfers
+  const bool isConcurrentSharing = desc.isShared && numSharedQueueFamilyIndices_ > 1;
+
   const VkImageCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
       .pNext = nullptr,
@@ -4411,18 +6268,58 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
       .samples = vkSamples,
       .tiling = VK_IMAGE_TILING_OPTIMAL,
       .usage = usageFlags,
-      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-      .queueFamilyIndexCount = 0,
-      .pQueueFamilyIndices = nullptr,
+      .sharingMode = isConcurrentSharing ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+      .queueFamilyIndexCount = isConcurrentSharing ? numSharedQueueFamilyIndices_ : 0u,
+      .pQueueFamilyIndices = isConcurrentSharing ? sharedQueueFamilyIndices_ : nullptr,
       .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
   };
 
-  if (LVK_VULKAN_USE_VMA && numPlanes == 1) {
+  if (desc.sparse) {
+    VK_ASSERT(vkCreateImage(vkDevice_, &ci, nullptr, &image.vkImage_));
+
+    const Result result = createSparseImage(image, ci, desc.debugName);
+
+    if (!result.isOk()) {
+      vkDestroyImage(vkDevice_, image.vkImage_, nullptr);
+      Result::setResult(outResult, result);
+      return {};
+    }
+  } else if (aliasedImage) {
+    VK_ASSERT(vkCreateImage(vkDevice_, &ci, nullptr, &image.vkImage_));
+
+    VkMemoryRequirements requirements = {};
+    VkMemoryRequirements aliasedRequirements = {};
+    vkGetImageMemoryRequirements(vkDevice_, image.vkImage_, &requirements);
+    vkGetImageMemoryRequirements(vkDevice_, aliasedImage->vkImage_, &aliasedRequirements);
+
+    // the memory of the aliased image has been allocated for its own requirements
+    if (requirements.size > aliasedRequirements.size || requirements.alignment > aliasedRequirements.alignment ||
+        (requirements.memoryTypeBits & aliasedRequirements.memoryTypeBits) != aliasedRequirements.memoryTypeBits) {
+      vkDestroyImage(vkDevice_, image.vkImage_, nullptr);
+      LVK_ASSERT_MSG(false, "The aliased texture memory is not compatible with this texture");
+      Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "The aliased texture memory is not compatible with this texture");
+      return {};
+    }
+
+    if (aliasedImage->vmaAllocation_) {
+      VK_ASSERT(vmaBindImageMemory((VmaAllocator)getVmaAllocator(), aliasedImage->vmaAllocation_, image.vkImage_));
+    } else {
+      VK_ASSERT(vkBindImageMemory(vkDevice_, image.vkImage_, aliasedImage->vkMemory_[0], 0));
+    }
+
+    image.isOwningVkMemory_ = false;
+    image.isMemoryAliased_ = true;
+    aliasedImage->isMemoryAliased_ = true;
+  } else if (LVK_VULKAN_USE_VMA && numPlanes == 1) {
     VmaAllocationCreateInfo vmaAllocInfo = {
-        .usage = memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ? VMA_MEMORY_USAGE_CPU_TO_GPU : VMA_MEMORY_USAGE_AUTO,
+        .usage = memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT      ? VMA_MEMORY_USAGE_CPU_TO_GPU
+                 : memFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED
+                                                                      : VMA_MEMORY_USAGE_AUTO,
     };
 
-    VkResult result = vmaCreateImage((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, &image.vkImage_, &image.vmaAllocation_, nullptr);
+    VmaAllocationInfo allocationInfo = {};
+    VkResult result =
+        vmaCreateImage((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, &image.vkImage_, &image.vmaAllocation_, &allocationInfo);
 
     if (!LVK_VERIFY(result == VK_SUCCESS)) {
       LLOGW("Failed: error result: %d, memflags: %d,  imageformat: %d\n", result, memFlags, image.vkImageFormat_);
@@ -4430,6 +6327,8 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
       return {};
     }
 
+    image.memorySize_ = allocationInfo.size;
+
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
       vmaMapMemory((VmaAllocator)getVmaAllocator(), image.vmaAllocation_, &image.mappedPtr_);
@@ -4467,6 +6366,7 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
       vkGetImageMemoryRequirements2(vkDevice_, &imgRequirements[p], &memRequirements[p]);
       LVK_ASSERT(memRequirements[p].memoryRequirements.size <= maxMemoryAllocationSize);
       VK_ASSERT(lvk::allocateMemory2(vkPhysicalDevice_, vkDevice_, &memRequirements[p], memFlags, &image.vkMemory_[p]));
+      image.memorySize_ += memRequirements[p].memoryRequirements.size;
     }
 
     const VkBindImagePlaneMemoryInfo bindImagePlaneMemoryInfo[kNumMaxImagePlanes] = {
@@ -4535,9 +6435,16 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
     return {};
   }
 
-  TextureHandle handle = texturesPool_.create(std::move(image));
+  if (image.isOwningVkMemory_) {
+    trackMemory(MemoryCategory_Texture, image.memorySize_, true);
+  }
+
+  TextureHandle handle = createBindless(texturesPool_, dirtyTextures_, std::move(image));
 
-  awaitingCreation_ = true;
+  if (handle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create Texture: the pool is full");
+    return {};
+  }
 
   if (desc.data) {
     LVK_ASSERT(desc.type == TextureType_2D || desc.type == TextureType_Cube);
@@ -4648,9 +6555,12 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTextureView(lvk::Textu
     }
   }
 
-  TextureHandle handle = texturesPool_.create(std::move(image));
+  TextureHandle handle = createBindless(texturesPool_, dirtyTextures_, std::move(image));
 
-  awaitingCreation_ = true;
+  if (handle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create TextureView: the pool is full");
+    return {};
+  }
 
   return {this, handle};
 }
@@ -4725,7 +6635,7 @@ lvk::AccelStructHandle lvk::VulkanContext::createBLAS(const AccelStructDesc& des
   };
   accelStruct.deviceAddress = vkGetAccelerationStructureDeviceAddressKHR(vkDevice_, &accelerationDeviceAddressInfo);
 
-  return accelStructuresPool_.create(std::move(accelStruct));
+  return createBindless(accelStructuresPool_, dirtyAccelStructs_, std::move(accelStruct));
 }
 
 lvk::AccelStructHandle lvk::VulkanContext::createTLAS(const AccelStructDesc& desc, Result* outResult) {
@@ -4751,10 +6661,15 @@ lvk::AccelStructHandle lvk::VulkanContext::createTLAS(const AccelStructDesc& des
               .usage = lvk::BufferUsageBits_AccelStructStorage,
               .storage = lvk::StorageType_Device,
               .size = accelerationStructureBuildSizesInfo.accelerationStructureSize,
+              .isShared = desc.isShared,
               .debugName = debugNameBuffer,
           },
           nullptr,
           outResult),
+      .buildFlags = desc.buildFlags,
+      .geometryFlags = accelerationStructureGeometry.flags,
+      .maxNumRefits = desc.maxNumRefits,
+      .isShared = desc.isShared,
   };
 
   const VkAccelerationStructureCreateInfoKHR ciAccelerationStructure = {
@@ -4770,6 +6685,7 @@ lvk::AccelStructHandle lvk::VulkanContext::createTLAS(const AccelStructDesc& des
           .usage = lvk::BufferUsageBits_Storage,
           .storage = lvk::StorageType_Device,
           .size = accelerationStructureBuildSizesInfo.buildScratchSize,
+          .isShared = desc.isShared,
           .debugName = "Buffer: TLAS scratch",
       },
       nullptr,
@@ -4804,7 +6720,272 @@ lvk::AccelStructHandle lvk::VulkanContext::createTLAS(const AccelStructDesc& des
   };
   accelStruct.deviceAddress = vkGetAccelerationStructureDeviceAddressKHR(vkDevice_, &accelerationDeviceAddressInfo);
 
-  return accelStructuresPool_.create(std::move(accelStruct));
+  return createBindless(accelStructuresPool_, dirtyAccelStructs_, std::move(accelStruct));
+}
+
+void lvk::VulkanContext::createAccelerationStructures(const AccelStructDesc* desc,
+                                                      Holder<AccelStructHandle>* outHandles,
+                                                      uint32_t numAccelStructs,
+                                                      Result* outResult) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  if (!LVK_VERIFY(has_KHR_acceleration_structure_)) {
+    Result::setResult(outResult, Result(Result::Code::RuntimeError, "VK_KHR_acceleration_structure is not enabled"));
+    return;
+  }
+
+  if (!LVK_VERIFY(desc && outHandles)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Expecting non-null `desc` and `outHandles`");
+    return;
+  }
+
+  Result::setResult(outResult, Result());
+
+  struct Build {
+    uint32_t index = 0; // into `desc` and `outHandles`
+    VkAccelerationStructureGeometryKHR geometry = {};
+    VkAccelerationStructureBuildSizesInfoKHR sizes = {};
+    lvk::AccelerationStructure accelStruct;
+  };
+
+  auto createStorage = [this](lvk::AccelerationStructure& accelStruct, VkDeviceSize size, const char* debugName) -> Result {
+    char debugNameBuffer[256] = {0};
+    if (debugName) {
+      snprintf(debugNameBuffer, sizeof(debugNameBuffer) - 1, "Buffer: %s", debugName);
+    }
+    Result result;
+    accelStruct.buffer = createBuffer(
+        {
+            .usage = lvk::BufferUsageBits_AccelStructStorage,
+            .storage = lvk::StorageType_Device,
+            .size = size,
+            .debugName = debugNameBuffer,
+        },
+        nullptr,
+        &result);
+    if (!result.isOk()) {
+      return result;
+    }
+    const VkAccelerationStructureCreateInfoKHR ci = {
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
+        .buffer = getVkBuffer(this, accelStruct.buffer),
+        .size = size,
+        .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+    };
+    VK_ASSERT_RETURN(vkCreateAccelerationStructureKHR(vkDevice_, &ci, nullptr, &accelStruct.vkHandle));
+    return Result();
+  };
+
+  const uint64_t scratchAlignment = accelerationStructureProperties_.minAccelerationStructureScratchOffsetAlignment;
+
+  std::vector<Build> builds;
+  builds.reserve(numAccelStructs);
+
+  uint64_t maxScratchSize = 0;
+  uint64_t totalScratchSize = 0;
+
+  // nothing has been built yet - the storage buffers are released by their holders
+  auto destroyBuilds = [this, &builds]() {
+    for (const Build& b : builds) {
+      if (b.accelStruct.vkHandle != VK_NULL_HANDLE) {
+        vkDestroyAccelerationStructureKHR(vkDevice_, b.accelStruct.vkHandle, nullptr);
+      }
+    }
+    builds.clear();
+  };
+
+  for (uint32_t i = 0; i != numAccelStructs; i++) {
+    if (desc[i].type != AccelStructType_BLAS) {
+      continue;
+    }
+    Build& b = builds.emplace_back();
+    b.index = i;
+    getBuildInfoBLAS(desc[i], b.geometry, b.sizes);
+    b.accelStruct.buildRangeInfo = {
+        .primitiveCount = desc[i].buildRange.primitiveCount,
+        .primitiveOffset = desc[i].buildRange.primitiveOffset,
+        .firstVertex = desc[i].buildRange.firstVertex,
+        .transformOffset = desc[i].buildRange.transformOffset,
+    };
+    const Result result = createStorage(b.accelStruct, b.sizes.accelerationStructureSize, desc[i].debugName);
+    if (!result.isOk()) {
+      destroyBuilds();
+      Result::setResult(outResult, result);
+      return;
+    }
+    const uint64_t scratchSize = getAlignedSize(b.sizes.buildScratchSize, scratchAlignment);
+    maxScratchSize = std::max(maxScratchSize, scratchSize);
+    totalScratchSize += scratchSize;
+  }
+
+  if (!builds.empty()) {
+    // all builds within one vkCmdBuildAccelerationStructuresKHR() need their own scratch memory; it is reused by the next batch
+    const uint64_t kScratchBudget = 256ull * 1024ull * 1024ull;
+    const uint64_t scratchBufferSize = std::min(totalScratchSize, std::max(maxScratchSize, kScratchBudget));
+
+    Result result;
+    lvk::Holder<lvk::BufferHandle> scratchBuffer = createBuffer(
+        {
+            .usage = lvk::BufferUsageBits_Storage,
+            .storage = lvk::StorageType_Device,
+            .size = scratchBufferSize + scratchAlignment,
+            .debugName = "Buffer: BLAS batch scratch",
+        },
+        nullptr,
+        &result);
+    if (!result.isOk()) {
+      destroyBuilds();
+      Result::setResult(outResult, result);
+      return;
+    }
+    const uint64_t scratchAddress = getAlignedAddress(gpuAddress(scratchBuffer), scratchAlignment);
+
+    lvk::ICommandBuffer& buffer = acquireCommandBuffer();
+    const VkCommandBuffer cmdBuf = lvk::getVkCommandBuffer(buffer);
+
+    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildInfos;
+    std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> buildRanges;
+    std::vector<VkAccelerationStructureKHR> compactable; // in the order of `builds`
+    uint64_t scratchOffset = 0;
+
+    auto recordBuilds = [&]() {
+      if (buildInfos.empty()) {
+        return;
+      }
+      vkCmdBuildAccelerationStructuresKHR(cmdBuf, (uint32_t)buildInfos.size(), buildInfos.data(), buildRanges.data());
+      // make the scratch memory and the acceleration structures available to the next builds and property queries
+      const VkMemoryBarrier2 barrier = {
+          .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+          .srcStageMask = VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+          .srcAccessMask = VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+          .dstStageMask = VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+          .dstAccessMask = VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+      };
+      const VkDependencyInfo depInfo = {
+          .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+          .memoryBarrierCount = 1,
+          .pMemoryBarriers = &barrier,
+      };
+      vkCmdPipelineBarrier2(cmdBuf, &depInfo);
+      buildInfos.clear();
+      buildRanges.clear();
+      scratchOffset = 0;
+    };
+
+    for (Build& b : builds) {
+      const uint64_t scratchSize = getAlignedSize(b.sizes.buildScratchSize, scratchAlignment);
+      if (scratchOffset + scratchSize > scratchBufferSize) {
+        recordBuilds();
+      }
+      const uint8_t buildFlags = desc[b.index].buildFlags;
+      buildInfos.push_back(VkAccelerationStructureBuildGeometryInfoKHR{
+          .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
+          .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+          .flags = buildFlagsToVkBuildAccelerationStructureFlags(buildFlags),
+          .mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR,
+          .dstAccelerationStructure = b.accelStruct.vkHandle,
+          .geometryCount = 1,
+          .pGeometries = &b.geometry,
+          .scratchData = {.deviceAddress = scratchAddress + scratchOffset},
+      });
+      buildRanges.push_back(&b.accelStruct.buildRangeInfo);
+      scratchOffset += scratchSize;
+      if (buildFlags & AccelStructBuildFlagBits_AllowCompaction) {
+        compactable.push_back(b.accelStruct.vkHandle);
+      }
+    }
+    recordBuilds();
+
+    const uint32_t numCompactable = (uint32_t)compactable.size();
+
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+
+    if (numCompactable) {
+      const VkQueryPoolCreateInfo ci = {
+          .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+          .queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+          .queryCount = numCompactable,
+      };
+      VK_ASSERT(vkCreateQueryPool(vkDevice_, &ci, nullptr, &queryPool));
+      vkCmdResetQueryPool(cmdBuf, queryPool, 0, numCompactable);
+      vkCmdWriteAccelerationStructuresPropertiesKHR(
+          cmdBuf, numCompactable, compactable.data(), VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, queryPool, 0);
+    }
+
+    wait(submit(buffer, {}));
+
+    // compaction: copy into smaller acceleration structures and get rid of the original ones
+    if (queryPool != VK_NULL_HANDLE) {
+      std::vector<VkDeviceSize> compactedSizes(numCompactable);
+      VK_ASSERT(vkGetQueryPoolResults(vkDevice_,
+                                      queryPool,
+                                      0,
+                                      numCompactable,
+                                      numCompactable * sizeof(VkDeviceSize),
+                                      compactedSizes.data(),
+                                      sizeof(VkDeviceSize),
+                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+      vkDestroyQueryPool(vkDevice_, queryPool, nullptr);
+
+      std::vector<lvk::AccelerationStructure> uncompacted;
+      uncompacted.reserve(numCompactable);
+
+      lvk::ICommandBuffer& copyBuffer = acquireCommandBuffer();
+
+      uint32_t q = 0;
+      uint64_t numBytesSaved = 0;
+      for (Build& b : builds) {
+        if ((desc[b.index].buildFlags & AccelStructBuildFlagBits_AllowCompaction) == 0) {
+          continue;
+        }
+        const VkDeviceSize compactedSize = compactedSizes[q++];
+        if (!compactedSize || compactedSize >= b.sizes.accelerationStructureSize) {
+          continue;
+        }
+        lvk::AccelerationStructure compacted = {.buildRangeInfo = b.accelStruct.buildRangeInfo};
+        if (!createStorage(compacted, compactedSize, desc[b.index].debugName).isOk()) {
+          // keep the uncompacted one
+          continue;
+        }
+        const VkCopyAccelerationStructureInfoKHR ci = {
+            .sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR,
+            .src = b.accelStruct.vkHandle,
+            .dst = compacted.vkHandle,
+            .mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR,
+        };
+        vkCmdCopyAccelerationStructureKHR(lvk::getVkCommandBuffer(copyBuffer), &ci);
+        numBytesSaved += b.sizes.accelerationStructureSize - compactedSize;
+        uncompacted.push_back(std::move(b.accelStruct));
+        b.accelStruct = std::move(compacted);
+      }
+
+      wait(submit(copyBuffer, {}));
+
+      for (const lvk::AccelerationStructure& as : uncompacted) {
+        vkDestroyAccelerationStructureKHR(vkDevice_, as.vkHandle, nullptr);
+      }
+
+      if (numBytesSaved) {
+        LLOGL("Compacted %u BLASes: saved %llu KB\n", (uint32_t)uncompacted.size(), (unsigned long long)(numBytesSaved / 1024));
+      }
+    }
+
+    for (Build& b : builds) {
+      const VkAccelerationStructureDeviceAddressInfoKHR ai = {
+          .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR,
+          .accelerationStructure = b.accelStruct.vkHandle,
+      };
+      b.accelStruct.deviceAddress = vkGetAccelerationStructureDeviceAddressKHR(vkDevice_, &ai);
+      outHandles[b.index] = {this, createBindless(accelStructuresPool_, dirtyAccelStructs_, std::move(b.accelStruct))};
+    }
+  }
+
+  // TLASes are built one by one after all BLASes
+  for (uint32_t i = 0; i != numAccelStructs; i++) {
+    if (desc[i].type != AccelStructType_BLAS) {
+      outHandles[i] = createAccelerationStructure(desc[i], outResult);
+    }
+  }
 }
 
 static_assert(1 << (sizeof(lvk::Format) * 8) <= LVK_ARRAY_NUM_ELEMENTS(lvk::VulkanContextImpl::ycbcrConversionData_),
@@ -4821,6 +7002,8 @@ VkSampler lvk::VulkanContext::getOrCreateYcbcrSampler(lvk::Format format) {
 }
 
 const VkSamplerYcbcrConversionInfo* lvk::VulkanContext::getOrCreateYcbcrConversionInfo(lvk::Format format) {
+  std::lock_guard lock(descriptorsMutex_);
+
   if (pimpl_->ycbcrConversionData_[format].info.sType) {
     return &pimpl_->ycbcrConversionData_[format].info;
   }
@@ -4900,80 +7083,112 @@ const VkSamplerYcbcrConversionInfo* lvk::VulkanContext::getOrCreateYcbcrConversi
   return &pimpl_->ycbcrConversionData_[format].info;
 }
 
-VkPipeline lvk::VulkanContext::getVkPipeline(RenderPipelineHandle handle, uint32_t viewMask) {
+VkPipeline lvk::VulkanContext::getVkPipeline(RenderPipelineHandle handle, uint32_t viewMask, bool updateDescriptorSets) {
+  std::lock_guard lock(pimpl_->renderPipelinesMutex_);
+
   lvk::RenderPipelineState* rps = renderPipelinesPool_.get(handle);
 
   if (!rps) {
     return VK_NULL_HANDLE;
   }
 
-  checkAndUpdateDescriptorSets();
+  // pipelines with PipelineNotReady_Wait which were not prewarmed are built right here on the calling thread
+  buildPipeline(rps, viewMask, rps->desc_.notReady != PipelineNotReady_Wait, updateDescriptorSets);
+
+  if (rps->pendingPipeline_.valid()) {
+    rps->pipeline_ = takeCompiledPipeline(rps->pendingPipeline_, rps->desc_.notReady);
+  }
+
+  return rps->pipeline_;
+}
+
+void lvk::VulkanContext::prewarm(RenderPipelineHandle handle, uint32_t viewMask) {
+  std::lock_guard lock(pimpl_->renderPipelinesMutex_);
+
+  lvk::RenderPipelineState* rps = renderPipelinesPool_.get(handle);
+
+  if (!LVK_VERIFY(rps)) {
+    return;
+  }
+
+  buildPipeline(rps, viewMask, true);
+}
+
+bool lvk::VulkanContext::isReady(RenderPipelineHandle handle) const {
+  std::lock_guard lock(pimpl_->renderPipelinesMutex_);
+
+  const lvk::RenderPipelineState* rps = renderPipelinesPool_.get(handle);
+
+  return rps && (rps->pipeline_ != VK_NULL_HANDLE || isPipelineCompiled(rps->pendingPipeline_));
+}
+
+void lvk::VulkanContext::buildPipeline(lvk::RenderPipelineState* rps, uint32_t viewMask, bool async, bool updateDescriptorSets) {
+  if (updateDescriptorSets) {
+    checkAndUpdateDescriptorSets();
+  }
 
   const DescriptorSet& dset = DSets_[lastUpdatedDSet_];
 
   if (rps->lastVkDescriptorSetLayout_ != dset.vkDSL || rps->viewMask_ != viewMask) {
-    deferredTask(std::packaged_task<void()>(
-        [device = getVkDevice(), pipeline = rps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-    deferredTask(std::packaged_task<void()>(
-        [device = getVkDevice(), layout = rps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
-    rps->pipeline_ = VK_NULL_HANDLE;
+    releasePipeline(rps);
     rps->lastVkDescriptorSetLayout_ = dset.vkDSL;
     rps->viewMask_ = viewMask;
   }
 
-  if (rps->pipeline_ != VK_NULL_HANDLE) {
-    return rps->pipeline_;
+  if (rps->pipeline_ != VK_NULL_HANDLE || rps->pendingPipeline_.valid()) {
+    return;
   }
 
-  // build a new Vulkan pipeline
+  VulkanContextImpl::SharedRenderPipeline* shared = nullptr;
+
+  if (has_EXT_extended_dynamic_state3_) {
+    std::string key = rps->staticStateKey_;
+    key.append((const char*)&viewMask, sizeof(viewMask));
+    key.append((const char*)&dset.vkDSL, sizeof(dset.vkDSL));
+    uint64_t hash = hashFNV1a(key.data(), key.size());
+    hash += !hash; // zero means "not shared"
+    shared = &pimpl_->sharedRenderPipelines_[hash];
+    if (!shared->numRefs_) {
+      shared->key_ = std::move(key);
+    } else if (shared->key_ != key) {
+      // a hash collision - this pipeline gets its own VkPipeline
+      shared = nullptr;
+    }
+    if (shared) {
+      rps->sharedPipelineKey_ = hash;
+      if (shared->numRefs_++) {
+        // there is a compatible pipeline already - all the differences are set as dynamic state in cmdBindRenderPipeline()
+        rps->pipeline_ = shared->pipeline_;
+        rps->pipelineLayout_ = shared->pipelineLayout_;
+        rps->pendingPipeline_ = shared->pendingPipeline_;
+        rps->shaderStageFlags_ = shared->shaderStageFlags_;
+        return;
+      }
+    }
+  }
+
+  // build a new Vulkan pipeline
 
   VkPipelineLayout layout = VK_NULL_HANDLE;
-  VkPipeline pipeline = VK_NULL_HANDLE;
 
   const RenderPipelineDesc& desc = rps->desc_;
 
-  const uint32_t numColorAttachments = rps->desc_.getNumColorAttachments();
-
-  // Not all attachments are valid. We need to create color blend attachments only for active attachments
-  VkPipelineColorBlendAttachmentState colorBlendAttachmentStates[LVK_MAX_COLOR_ATTACHMENTS] = {};
-  VkFormat colorAttachmentFormats[LVK_MAX_COLOR_ATTACHMENTS] = {};
-
-  for (uint32_t i = 0; i != numColorAttachments; i++) {
-    const lvk::ColorAttachment& attachment = desc.color[i];
-    LVK_ASSERT(attachment.format != Format_Invalid);
-    colorAttachmentFormats[i] = formatToVkFormat(attachment.format);
-    if (!attachment.blendEnabled) {
-      colorBlendAttachmentStates[i] = VkPipelineColorBlendAttachmentState{
-          .blendEnable = VK_FALSE,
-          .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
-          .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
-          .colorBlendOp = VK_BLEND_OP_ADD,
-          .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
-          .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
-          .alphaBlendOp = VK_BLEND_OP_ADD,
-          .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
-      };
-    } else {
-      colorBlendAttachmentStates[i] = VkPipelineColorBlendAttachmentState{
-          .blendEnable = VK_TRUE,
-          .srcColorBlendFactor = blendFactorToVkBlendFactor(attachment.srcRGBBlendFactor),
-          .dstColorBlendFactor = blendFactorToVkBlendFactor(attachment.dstRGBBlendFactor),
-          .colorBlendOp = blendOpToVkBlendOp(attachment.rgbBlendOp),
-          .srcAlphaBlendFactor = blendFactorToVkBlendFactor(attachment.srcAlphaBlendFactor),
-          .dstAlphaBlendFactor = blendFactorToVkBlendFactor(attachment.dstAlphaBlendFactor),
-          .alphaBlendOp = blendOpToVkBlendOp(attachment.alphaBlendOp),
-          .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
-      };
-    }
-  }
-
-  const lvk::ShaderModuleState* vertModule = shaderModulesPool_.get(desc.smVert);
-  const lvk::ShaderModuleState* tescModule = shaderModulesPool_.get(desc.smTesc);
-  const lvk::ShaderModuleState* teseModule = shaderModulesPool_.get(desc.smTese);
-  const lvk::ShaderModuleState* geomModule = shaderModulesPool_.get(desc.smGeom);
-  const lvk::ShaderModuleState* fragModule = shaderModulesPool_.get(desc.smFrag);
-  const lvk::ShaderModuleState* taskModule = shaderModulesPool_.get(desc.smTask);
-  const lvk::ShaderModuleState* meshModule = shaderModulesPool_.get(desc.smMesh);
+  const lvk::ShaderModuleState* modules[Stage_Mesh + 1] = {};
+  modules[Stage_Vert] = shaderModulesPool_.get(desc.smVert);
+  modules[Stage_Tesc] = shaderModulesPool_.get(desc.smTesc);
+  modules[Stage_Tese] = shaderModulesPool_.get(desc.smTese);
+  modules[Stage_Geom] = shaderModulesPool_.get(desc.smGeom);
+  modules[Stage_Frag] = shaderModulesPool_.get(desc.smFrag);
+  modules[Stage_Task] = shaderModulesPool_.get(desc.smTask);
+  modules[Stage_Mesh] = shaderModulesPool_.get(desc.smMesh);
+
+  const lvk::ShaderModuleState* vertModule = modules[Stage_Vert];
+  const lvk::ShaderModuleState* tescModule = modules[Stage_Tesc];
+  const lvk::ShaderModuleState* teseModule = modules[Stage_Tese];
+  const lvk::ShaderModuleState* geomModule = modules[Stage_Geom];
+  const lvk::ShaderModuleState* fragModule = modules[Stage_Frag];
+  const lvk::ShaderModuleState* taskModule = modules[Stage_Task];
+  const lvk::ShaderModuleState* meshModule = modules[Stage_Mesh];
 
   LVK_ASSERT(vertModule || meshModule);
   LVK_ASSERT(fragModule);
@@ -4984,18 +7199,6 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RenderPipelineHandle handle, uint32
                desc.patchControlPoints <= vkPhysicalDeviceProperties2_.properties.limits.maxTessellationPatchSize);
   }
 
-  const VkPipelineVertexInputStateCreateInfo ciVertexInputState = {
-      .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-      .vertexBindingDescriptionCount = rps->numBindings_,
-      .pVertexBindingDescriptions = rps->numBindings_ ? rps->vkBindings_ : nullptr,
-      .vertexAttributeDescriptionCount = rps->numAttributes_,
-      .pVertexAttributeDescriptions = rps->numAttributes_ ? rps->vkAttributes_ : nullptr,
-  };
-
-  VkSpecializationMapEntry entries[SpecializationConstantDesc::LVK_SPECIALIZATION_CONSTANTS_MAX] = {};
-
-  const VkSpecializationInfo si = lvk::getPipelineShaderStageSpecializationInfo(desc.specInfo, entries);
-
   // create pipeline layout
   {
 #define UPDATE_PUSH_CONSTANT_SIZE(sm, bit)                                  \
@@ -5050,7 +7253,142 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RenderPipelineHandle handle, uint32
     VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE_LAYOUT, (uint64_t)layout, pipelineLayoutName));
   }
 
-  lvk::VulkanPipelineBuilder()
+  rps->pipelineLayout_ = layout;
+
+  if (!async) {
+    rps->pipeline_ = compileRenderPipeline(*rps, modules, layout, viewMask);
+  } else {
+    auto copies = std::make_shared<std::vector<lvk::ShaderModuleState>>();
+    copies->reserve(LVK_ARRAY_NUM_ELEMENTS(modules));
+    copyShaderModules(*copies, modules, LVK_ARRAY_NUM_ELEMENTS(modules));
+
+    rps->pendingPipeline_ = compilePipelineAsync(std::packaged_task<VkPipeline()>(
+        [this, state = *rps, copies, modules, layout, viewMask]() { return compileRenderPipeline(state, modules, layout, viewMask); }));
+  }
+
+  if (shared) {
+    shared->pipeline_ = rps->pipeline_;
+    shared->pipelineLayout_ = rps->pipelineLayout_;
+    shared->pendingPipeline_ = rps->pendingPipeline_;
+    shared->shaderStageFlags_ = rps->shaderStageFlags_;
+  }
+}
+
+void lvk::VulkanContext::releasePipeline(lvk::RenderPipelineState* rps) {
+  if (rps->pendingPipeline_.valid()) {
+    // the pipeline being compiled is stale or its owner is going away - it references the specialization constants data
+    rps->pipeline_ = takeCompiledPipeline(rps->pendingPipeline_, PipelineNotReady_Wait);
+  }
+
+  if (rps->sharedPipelineKey_) {
+    auto it = pimpl_->sharedRenderPipelines_.find(rps->sharedPipelineKey_);
+    LVK_ASSERT(it != pimpl_->sharedRenderPipelines_.end());
+    rps->sharedPipelineKey_ = 0;
+    VulkanContextImpl::SharedRenderPipeline& shared = it->second;
+    if (--shared.numRefs_) {
+      // still used by other render pipelines
+      rps->pipeline_ = VK_NULL_HANDLE;
+      rps->pipelineLayout_ = VK_NULL_HANDLE;
+      return;
+    }
+    rps->pipeline_ = shared.pendingPipeline_.valid() ? takeCompiledPipeline(shared.pendingPipeline_, PipelineNotReady_Wait)
+                                                     : shared.pipeline_;
+    pimpl_->sharedRenderPipelines_.erase(it);
+  }
+
+  deferredDestroy(DeferredObjectType_Pipeline, (uint64_t)rps->pipeline_);
+  deferredDestroy(DeferredObjectType_PipelineLayout, (uint64_t)rps->pipelineLayout_);
+  rps->pipeline_ = VK_NULL_HANDLE;
+  rps->pipelineLayout_ = VK_NULL_HANDLE;
+}
+
+VkPipeline lvk::VulkanContext::compileRenderPipeline(const lvk::RenderPipelineState& rps,
+                                                     const lvk::ShaderModuleState* const* modules,
+                                                     VkPipelineLayout layout,
+                                                     uint32_t viewMask) const {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  VkPipelineCreationFeedback feedback = {};
+
+  const RenderPipelineDesc& desc = rps.desc_;
+
+  const uint32_t numColorAttachments = rps.desc_.getNumColorAttachments();
+
+  // Not all attachments are valid. We need to create color blend attachments only for active attachments
+  VkPipelineColorBlendAttachmentState colorBlendAttachmentStates[LVK_MAX_COLOR_ATTACHMENTS] = {};
+  VkFormat colorAttachmentFormats[LVK_MAX_COLOR_ATTACHMENTS] = {};
+
+  for (uint32_t i = 0; i != numColorAttachments; i++) {
+    const lvk::ColorAttachment& attachment = desc.color[i];
+    LVK_ASSERT(attachment.format != Format_Invalid);
+    colorAttachmentFormats[i] = formatToVkFormat(attachment.format);
+    if (!attachment.blendEnabled) {
+      colorBlendAttachmentStates[i] = VkPipelineColorBlendAttachmentState{
+          .blendEnable = VK_FALSE,
+          .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
+          .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
+          .colorBlendOp = VK_BLEND_OP_ADD,
+          .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+          .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+          .alphaBlendOp = VK_BLEND_OP_ADD,
+          .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+      };
+    } else {
+      colorBlendAttachmentStates[i] = VkPipelineColorBlendAttachmentState{
+          .blendEnable = VK_TRUE,
+          .srcColorBlendFactor = blendFactorToVkBlendFactor(attachment.srcRGBBlendFactor),
+          .dstColorBlendFactor = blendFactorToVkBlendFactor(attachment.dstRGBBlendFactor),
+          .colorBlendOp = blendOpToVkBlendOp(attachment.rgbBlendOp),
+          .srcAlphaBlendFactor = blendFactorToVkBlendFactor(attachment.srcAlphaBlendFactor),
+          .dstAlphaBlendFactor = blendFactorToVkBlendFactor(attachment.dstAlphaBlendFactor),
+          .alphaBlendOp = blendOpToVkBlendOp(attachment.alphaBlendOp),
+          .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+      };
+    }
+  }
+
+  const lvk::ShaderModuleState* vertModule = modules[Stage_Vert];
+  const lvk::ShaderModuleState* tescModule = modules[Stage_Tesc];
+  const lvk::ShaderModuleState* teseModule = modules[Stage_Tese];
+  const lvk::ShaderModuleState* geomModule = modules[Stage_Geom];
+  const lvk::ShaderModuleState* fragModule = modules[Stage_Frag];
+  const lvk::ShaderModuleState* taskModule = modules[Stage_Task];
+  const lvk::ShaderModuleState* meshModule = modules[Stage_Mesh];
+
+  const VkPipelineVertexInputStateCreateInfo ciVertexInputState = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+      .vertexBindingDescriptionCount = rps.numBindings_,
+      .pVertexBindingDescriptions = rps.numBindings_ ? rps.vkBindings_ : nullptr,
+      .vertexAttributeDescriptionCount = rps.numAttributes_,
+      .pVertexAttributeDescriptions = rps.numAttributes_ ? rps.vkAttributes_ : nullptr,
+  };
+
+  VkSpecializationMapEntry entries[SpecializationConstantDesc::LVK_SPECIALIZATION_CONSTANTS_MAX] = {};
+
+  const VkSpecializationInfo si = lvk::getPipelineShaderStageSpecializationInfo(desc.specInfo, entries);
+
+  lvk::VulkanPipelineBuilder builder;
+
+  if (has_EXT_extended_dynamic_state3_) {
+    // the static values below are ignored; the actual ones are set in cmdBindRenderPipeline()
+    builder
+        // from Vulkan 1.3 or VK_EXT_extended_dynamic_state
+        .dynamicState(VK_DYNAMIC_STATE_CULL_MODE)
+        .dynamicState(VK_DYNAMIC_STATE_FRONT_FACE)
+        // from VK_EXT_extended_dynamic_state3
+        .dynamicState(VK_DYNAMIC_STATE_POLYGON_MODE_EXT)
+        .dynamicState(VK_DYNAMIC_STATE_RASTERIZATION_SAMPLES_EXT)
+        .dynamicState(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT)
+        .dynamicState(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT)
+        .dynamicState(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+    if (!meshModule) {
+      // mesh shader pipelines have no input assembly state
+      builder.dynamicState(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY);
+    }
+  }
+
+  builder
       // from Vulkan 1.0
       .dynamicState(VK_DYNAMIC_STATE_VIEWPORT)
       .dynamicState(VK_DYNAMIC_STATE_SCISSOR)
@@ -5101,10 +7439,11 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RenderPipelineHandle handle, uint32
       .depthAttachmentFormat(formatToVkFormat(desc.depthFormat))
       .stencilAttachmentFormat(formatToVkFormat(desc.stencilFormat))
       .patchControlPoints(desc.patchControlPoints)
+      .flags(has_EXT_descriptor_buffer_ ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u)
+      .creationFeedback(&feedback)
       .build(vkDevice_, pipelineCache_, layout, &pipeline, desc.debugName);
 
-  rps->pipeline_ = pipeline;
-  rps->pipelineLayout_ = layout;
+  trackPipelineCacheHit(feedback);
 
   return pipeline;
 }
@@ -5116,54 +7455,84 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
     return VK_NULL_HANDLE;
   }
 
-  checkAndUpdateDescriptorSets();
-
-  const DescriptorSet& dset = DSets_[lastUpdatedDSet_];
+  buildPipeline(rtps, rtps->desc_.notReady != PipelineNotReady_Wait);
 
-  if (rtps->lastVkDescriptorSetLayout_ != dset.vkDSL) {
-    deferredTask(
-        std::packaged_task<void()>([device = vkDevice_, pipeline = rtps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-    deferredTask(std::packaged_task<void()>(
-        [device = vkDevice_, layout = rtps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
-    rtps->pipeline_ = VK_NULL_HANDLE;
-    rtps->pipelineLayout_ = VK_NULL_HANDLE;
-    rtps->lastVkDescriptorSetLayout_ = dset.vkDSL;
+  if (rtps->pendingPipeline_.valid()) {
+    rtps->pipeline_ = takeCompiledPipeline(rtps->pendingPipeline_, rtps->desc_.notReady);
+    if (rtps->pipeline_) {
+      createShaderBindingTable(rtps);
+    }
   }
 
-  if (rtps->pipeline_) {
-    return rtps->pipeline_;
+  return rtps->pipeline_;
+}
+
+void lvk::VulkanContext::prewarm(RayTracingPipelineHandle handle) {
+  lvk::RayTracingPipelineState* rtps = rayTracingPipelinesPool_.get(handle);
+
+  if (!LVK_VERIFY(rtps)) {
+    return;
   }
 
-  // build a new Vulkan ray tracing pipeline
-  const RayTracingPipelineDesc& desc = rtps->desc_;
+  buildPipeline(rtps, true);
+}
 
-  using RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_HIT_GROUPS;
-  using RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_SHADERS;
-
-  const lvk::ShaderModuleState* moduleRGen[LVK_MAX_RAY_TRACING_SHADERS] = {};
-  const lvk::ShaderModuleState* moduleMiss[LVK_MAX_RAY_TRACING_SHADERS] = {};
-  const lvk::ShaderModuleState* moduleCall[LVK_MAX_RAY_TRACING_SHADERS] = {};
-  const lvk::ShaderModuleState* moduleAHit[LVK_MAX_RAY_TRACING_HIT_GROUPS] = {};
-  const lvk::ShaderModuleState* moduleCHit[LVK_MAX_RAY_TRACING_HIT_GROUPS] = {};
-  const lvk::ShaderModuleState* moduleIntr[LVK_MAX_RAY_TRACING_HIT_GROUPS] = {};
-  for (int i = 0; i < LVK_MAX_RAY_TRACING_SHADERS; ++i) {
+bool lvk::VulkanContext::isReady(RayTracingPipelineHandle handle) const {
+  const lvk::RayTracingPipelineState* rtps = rayTracingPipelinesPool_.get(handle);
+
+  return rtps && (rtps->pipeline_ != VK_NULL_HANDLE || isPipelineCompiled(rtps->pendingPipeline_));
+}
+
+lvk::RayTracingShaderModules lvk::VulkanContext::getRayTracingShaderModules(const lvk::RayTracingPipelineDesc& desc) const {
+  lvk::RayTracingShaderModules modules;
+
+  for (int i = 0; i < RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_SHADERS; ++i) {
     if (desc.smRayGen[i])
-      moduleRGen[i] = shaderModulesPool_.get(desc.smRayGen[i]);
+      modules.rayGen[i] = shaderModulesPool_.get(desc.smRayGen[i]);
     if (desc.smMiss[i])
-      moduleMiss[i] = shaderModulesPool_.get(desc.smMiss[i]);
+      modules.miss[i] = shaderModulesPool_.get(desc.smMiss[i]);
     if (desc.smCallable[i])
-      moduleCall[i] = shaderModulesPool_.get(desc.smCallable[i]);
+      modules.callable[i] = shaderModulesPool_.get(desc.smCallable[i]);
   }
   for (int i = 0; i < LVK_ARRAY_NUM_ELEMENTS(desc.hitGroups); ++i) {
     if (desc.hitGroups[i].smAnyHit)
-      moduleAHit[i] = shaderModulesPool_.get(desc.hitGroups[i].smAnyHit);
+      modules.anyHit[i] = shaderModulesPool_.get(desc.hitGroups[i].smAnyHit);
     if (desc.hitGroups[i].smClosestHit)
-      moduleCHit[i] = shaderModulesPool_.get(desc.hitGroups[i].smClosestHit);
+      modules.closestHit[i] = shaderModulesPool_.get(desc.hitGroups[i].smClosestHit);
     if (desc.hitGroups[i].smIntersection)
-      moduleIntr[i] = shaderModulesPool_.get(desc.hitGroups[i].smIntersection);
+      modules.intersection[i] = shaderModulesPool_.get(desc.hitGroups[i].smIntersection);
+  }
+
+  return modules;
+}
+
+void lvk::VulkanContext::buildPipeline(lvk::RayTracingPipelineState* rtps, bool async) {
+  checkAndUpdateDescriptorSets();
+
+  const DescriptorSet& dset = DSets_[lastUpdatedDSet_];
+
+  if (rtps->lastVkDescriptorSetLayout_ != dset.vkDSL) {
+    if (rtps->pendingPipeline_.valid()) {
+      // the pipeline being compiled is stale - wait for it and get rid of it below
+      rtps->pipeline_ = takeCompiledPipeline(rtps->pendingPipeline_, PipelineNotReady_Wait);
+    }
+    deferredDestroy(DeferredObjectType_Pipeline, (uint64_t)rtps->pipeline_);
+    deferredDestroy(DeferredObjectType_PipelineLayout, (uint64_t)rtps->pipelineLayout_);
+    rtps->pipeline_ = VK_NULL_HANDLE;
+    rtps->pipelineLayout_ = VK_NULL_HANDLE;
+    rtps->lastVkDescriptorSetLayout_ = dset.vkDSL;
+  }
+
+  if (rtps->pipeline_ || rtps->pendingPipeline_.valid()) {
+    return;
   }
 
-  LVK_ASSERT(moduleRGen);
+  // build a new Vulkan ray tracing pipeline
+  lvk::RayTracingShaderModules modules = getRayTracingShaderModules(rtps->desc_);
+
+  LVK_ASSERT(modules.rayGen[0]);
+
+  VkPipelineLayout layout = VK_NULL_HANDLE;
 
   // create pipeline layout
   {
@@ -5176,12 +7545,12 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
   }
     rtps->shaderStageFlags_ = 0;
     uint32_t pushConstantsSize = 0;
-    UPDATE_PUSH_CONSTANT_SIZE(moduleRGen, VK_SHADER_STAGE_RAYGEN_BIT_KHR);
-    UPDATE_PUSH_CONSTANT_SIZE(moduleAHit, VK_SHADER_STAGE_ANY_HIT_BIT_KHR);
-    UPDATE_PUSH_CONSTANT_SIZE(moduleCHit, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR);
-    UPDATE_PUSH_CONSTANT_SIZE(moduleMiss, VK_SHADER_STAGE_MISS_BIT_KHR);
-    UPDATE_PUSH_CONSTANT_SIZE(moduleIntr, VK_SHADER_STAGE_INTERSECTION_BIT_KHR);
-    UPDATE_PUSH_CONSTANT_SIZE(moduleCall, VK_SHADER_STAGE_CALLABLE_BIT_KHR);
+    UPDATE_PUSH_CONSTANT_SIZE(modules.rayGen, VK_SHADER_STAGE_RAYGEN_BIT_KHR);
+    UPDATE_PUSH_CONSTANT_SIZE(modules.anyHit, VK_SHADER_STAGE_ANY_HIT_BIT_KHR);
+    UPDATE_PUSH_CONSTANT_SIZE(modules.closestHit, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR);
+    UPDATE_PUSH_CONSTANT_SIZE(modules.miss, VK_SHADER_STAGE_MISS_BIT_KHR);
+    UPDATE_PUSH_CONSTANT_SIZE(modules.intersection, VK_SHADER_STAGE_INTERSECTION_BIT_KHR);
+    UPDATE_PUSH_CONSTANT_SIZE(modules.callable, VK_SHADER_STAGE_CALLABLE_BIT_KHR);
 #undef UPDATE_PUSH_CONSTANT_SIZE
 
     // maxPushConstantsSize is guaranteed to be at least 128 bytes
@@ -5205,17 +7574,47 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
         .pushConstantRangeCount = 1,
         .pPushConstantRanges = &range,
     };
-    VK_ASSERT(vkCreatePipelineLayout(vkDevice_, &ciPipelineLayout, nullptr, &rtps->pipelineLayout_));
+    VK_ASSERT(vkCreatePipelineLayout(vkDevice_, &ciPipelineLayout, nullptr, &layout));
     char pipelineLayoutName[256] = {0};
     if (rtps->desc_.debugName) {
       snprintf(pipelineLayoutName, sizeof(pipelineLayoutName) - 1, "Pipeline Layout: %s", rtps->desc_.debugName);
     }
-    VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE_LAYOUT, (uint64_t)rtps->pipelineLayout_, pipelineLayoutName));
+    VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE_LAYOUT, (uint64_t)layout, pipelineLayoutName));
+  }
+
+  rtps->pipelineLayout_ = layout;
+
+  if (!async) {
+    rtps->pipeline_ = compileRayTracingPipeline(rtps->desc_, modules, layout);
+    createShaderBindingTable(rtps);
+    return;
   }
 
+  auto copies = std::make_shared<std::vector<lvk::ShaderModuleState>>();
+  copies->reserve(sizeof(modules) / sizeof(modules.rayGen[0]));
+  copyShaderModules(*copies, modules.rayGen, LVK_ARRAY_NUM_ELEMENTS(modules.rayGen));
+  copyShaderModules(*copies, modules.miss, LVK_ARRAY_NUM_ELEMENTS(modules.miss));
+  copyShaderModules(*copies, modules.callable, LVK_ARRAY_NUM_ELEMENTS(modules.callable));
+  copyShaderModules(*copies, modules.anyHit, LVK_ARRAY_NUM_ELEMENTS(modules.anyHit));
+  copyShaderModules(*copies, modules.closestHit, LVK_ARRAY_NUM_ELEMENTS(modules.closestHit));
+  copyShaderModules(*copies, modules.intersection, LVK_ARRAY_NUM_ELEMENTS(modules.intersection));
+
+  rtps->pendingPipeline_ = compilePipelineAsync(std::packaged_task<VkPipeline()>(
+      [this, desc = rtps->desc_, copies, modules, layout]() { return compileRayTracingPipeline(desc, modules, layout); }));
+}
+
+VkPipeline lvk::VulkanContext::compileRayTracingPipeline(const lvk::RayTracingPipelineDesc& desc,
+                                                         const lvk::RayTracingShaderModules& modules,
+                                                         VkPipelineLayout layout) const {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  using RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_HIT_GROUPS;
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+
   VkSpecializationMapEntry entries[SpecializationConstantDesc::LVK_SPECIALIZATION_CONSTANTS_MAX] = {};
 
-  const VkSpecializationInfo siComp = lvk::getPipelineShaderStageSpecializationInfo(rtps->desc_.specInfo, entries);
+  const VkSpecializationInfo siComp = lvk::getPipelineShaderStageSpecializationInfo(desc.specInfo, entries);
 
   const uint32_t kMaxRayTracingShaderStages = 6 * LVK_MAX_RAY_TRACING_HIT_GROUPS;
   VkPipelineShaderStageCreateInfo ciShaderStages[kMaxRayTracingShaderStages];
@@ -5231,20 +7630,14 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
   const uint32_t kMaxShaderGroups = 4 * LVK_MAX_RAY_TRACING_HIT_GROUPS;
   VkRayTracingShaderGroupCreateInfoKHR shaderGroups[kMaxShaderGroups];
   uint32_t numShaderGroups = 0;
-  uint32_t idxMiss = 0;
-  uint32_t numMissGroups = 0;
-  uint32_t idxHit = 0;
-  uint32_t numHitGroups = 0;
-  uint32_t idxCallable = 0;
-  uint32_t numCallableGroups = 0;
 
   // ray generation groups
-  for (int i = 0; i < LVK_ARRAY_NUM_ELEMENTS(moduleRGen); ++i) {
-    if (moduleRGen[i]) {
+  for (int i = 0; i < LVK_ARRAY_NUM_ELEMENTS(modules.rayGen); ++i) {
+    if (modules.rayGen[i]) {
       shaderGroups[numShaderGroups++] = VkRayTracingShaderGroupCreateInfoKHR{
           .sType = VK_STRUCTURE_TYPE_RAY_TRACING_SHADER_GROUP_CREATE_INFO_KHR,
           .type = VK_RAY_TRACING_SHADER_GROUP_TYPE_GENERAL_KHR,
-          .generalShader = addStage(VK_SHADER_STAGE_RAYGEN_BIT_KHR, moduleRGen[i]->ci),
+          .generalShader = addStage(VK_SHADER_STAGE_RAYGEN_BIT_KHR, modules.rayGen[i]->ci),
           .closestHitShader = VK_SHADER_UNUSED_KHR,
           .anyHitShader = VK_SHADER_UNUSED_KHR,
           .intersectionShader = VK_SHADER_UNUSED_KHR,
@@ -5252,15 +7645,12 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
     }
   }
   // miss groups
-  for (int i = 0; i < LVK_ARRAY_NUM_ELEMENTS(moduleMiss); ++i) {
-    if (moduleMiss[i]) {
-      if (!numMissGroups)
-        idxMiss = numShaderGroups;
-      numMissGroups++;
+  for (int i = 0; i < LVK_ARRAY_NUM_ELEMENTS(modules.miss); ++i) {
+    if (modules.miss[i]) {
       shaderGroups[numShaderGroups++] = VkRayTracingShaderGroupCreateInfoKHR{
           .sType = VK_STRUCTURE_TYPE_RAY_TRACING_SHADER_GROUP_CREATE_INFO_KHR,
           .type = VK_RAY_TRACING_SHADER_GROUP_TYPE_GENERAL_KHR,
-          .generalShader = addStage(VK_SHADER_STAGE_MISS_BIT_KHR, moduleMiss[i]->ci),
+          .generalShader = addStage(VK_SHADER_STAGE_MISS_BIT_KHR, modules.miss[i]->ci),
           .closestHitShader = VK_SHADER_UNUSED_KHR,
           .anyHitShader = VK_SHADER_UNUSED_KHR,
           .intersectionShader = VK_SHADER_UNUSED_KHR,
@@ -5269,30 +7659,26 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
   }
   // hit groups: add chit/ahit/intr stages per-group so indices are correct for each pairing
   for (int i = 0; i < LVK_MAX_RAY_TRACING_HIT_GROUPS; ++i) {
-    if (moduleAHit[i] || moduleCHit[i] || moduleIntr[i]) {
-      if (!numHitGroups)
-        idxHit = numShaderGroups;
-      numHitGroups++;
+    if (modules.anyHit[i] || modules.closestHit[i] || modules.intersection[i]) {
       shaderGroups[numShaderGroups++] = VkRayTracingShaderGroupCreateInfoKHR{
           .sType = VK_STRUCTURE_TYPE_RAY_TRACING_SHADER_GROUP_CREATE_INFO_KHR,
           .type = VK_RAY_TRACING_SHADER_GROUP_TYPE_TRIANGLES_HIT_GROUP_KHR,
           .generalShader = VK_SHADER_UNUSED_KHR,
-          .closestHitShader = moduleCHit[i] ? addStage(VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, moduleCHit[i]->ci) : VK_SHADER_UNUSED_KHR,
-          .anyHitShader = moduleAHit[i] ? addStage(VK_SHADER_STAGE_ANY_HIT_BIT_KHR, moduleAHit[i]->ci) : VK_SHADER_UNUSED_KHR,
-          .intersectionShader = moduleIntr[i] ? addStage(VK_SHADER_STAGE_INTERSECTION_BIT_KHR, moduleIntr[i]->ci) : VK_SHADER_UNUSED_KHR,
+          .closestHitShader = modules.closestHit[i] ? addStage(VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, modules.closestHit[i]->ci)
+                                                    : VK_SHADER_UNUSED_KHR,
+          .anyHitShader = modules.anyHit[i] ? addStage(VK_SHADER_STAGE_ANY_HIT_BIT_KHR, modules.anyHit[i]->ci) : VK_SHADER_UNUSED_KHR,
+          .intersectionShader = modules.intersection[i] ? addStage(VK_SHADER_STAGE_INTERSECTION_BIT_KHR, modules.intersection[i]->ci)
+                                                        : VK_SHADER_UNUSED_KHR,
       };
     }
   }
   // callable groups
-  for (int i = 0; i < LVK_ARRAY_NUM_ELEMENTS(moduleCall); ++i) {
-    if (moduleCall[i]) {
-      if (!numCallableGroups)
-        idxCallable = numShaderGroups;
-      numCallableGroups++;
+  for (int i = 0; i < LVK_ARRAY_NUM_ELEMENTS(modules.callable); ++i) {
+    if (modules.callable[i]) {
       shaderGroups[numShaderGroups++] = VkRayTracingShaderGroupCreateInfoKHR{
           .sType = VK_STRUCTURE_TYPE_RAY_TRACING_SHADER_GROUP_CREATE_INFO_KHR,
           .type = VK_RAY_TRACING_SHADER_GROUP_TYPE_GENERAL_KHR,
-          .generalShader = addStage(VK_SHADER_STAGE_CALLABLE_BIT_KHR, moduleCall[i]->ci),
+          .generalShader = addStage(VK_SHADER_STAGE_CALLABLE_BIT_KHR, modules.callable[i]->ci),
           .closestHitShader = VK_SHADER_UNUSED_KHR,
           .anyHitShader = VK_SHADER_UNUSED_KHR,
           .intersectionShader = VK_SHADER_UNUSED_KHR,
@@ -5300,18 +7686,56 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
     }
   }
 
+  VkPipelineCreationFeedback feedback = {};
+
+  const VkPipelineCreationFeedbackCreateInfo feedbackInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO,
+      .pPipelineCreationFeedback = &feedback,
+  };
   const VkRayTracingPipelineCreateInfoKHR ciRayTracingPipeline = {
       .sType = VK_STRUCTURE_TYPE_RAY_TRACING_PIPELINE_CREATE_INFO_KHR,
+      .pNext = &feedbackInfo,
+      .flags = has_EXT_descriptor_buffer_ ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u,
       .stageCount = numShaderStages,
       .pStages = ciShaderStages,
       .groupCount = numShaderGroups,
       .pGroups = shaderGroups,
       .maxPipelineRayRecursionDepth = rayTracingPipelineProperties_.maxRayRecursionDepth,
-      .layout = rtps->pipelineLayout_,
+      .layout = layout,
+  };
+  VK_ASSERT(vkCreateRayTracingPipelinesKHR(vkDevice_, VK_NULL_HANDLE, pipelineCache_, 1, &ciRayTracingPipeline, nullptr, &pipeline));
+  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE, (uint64_t)pipeline, desc.debugName));
+
+  trackPipelineCacheHit(feedback);
+
+  return pipeline;
+}
+
+void lvk::VulkanContext::createShaderBindingTable(lvk::RayTracingPipelineState* rtps) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  const lvk::RayTracingShaderModules modules = getRayTracingShaderModules(rtps->desc_);
+
+  auto countModules = [](const lvk::ShaderModuleState* const* sm, size_t n) -> uint32_t {
+    return (uint32_t)std::count_if(sm, sm + n, [](const lvk::ShaderModuleState* m) { return m != nullptr; });
   };
-  VK_ASSERT(vkCreateRayTracingPipelinesKHR(vkDevice_, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &ciRayTracingPipeline, nullptr, &rtps->pipeline_));
 
-  // shader binding table
+  uint32_t numHitGroups = 0;
+  for (int i = 0; i < RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_HIT_GROUPS; ++i) {
+    if (modules.anyHit[i] || modules.closestHit[i] || modules.intersection[i]) {
+      numHitGroups++;
+    }
+  }
+
+  // the groups are laid out in the same order as in compileRayTracingPipeline(): raygen, miss, hit, callable
+  const uint32_t numRayGenGroups = countModules(modules.rayGen, LVK_ARRAY_NUM_ELEMENTS(modules.rayGen));
+  const uint32_t numMissGroups = countModules(modules.miss, LVK_ARRAY_NUM_ELEMENTS(modules.miss));
+  const uint32_t numCallableGroups = countModules(modules.callable, LVK_ARRAY_NUM_ELEMENTS(modules.callable));
+  const uint32_t idxMiss = numRayGenGroups;
+  const uint32_t idxHit = idxMiss + numMissGroups;
+  const uint32_t idxCallable = idxHit + numHitGroups;
+  const uint32_t numShaderGroups = idxCallable + numCallableGroups;
+
   const VkPhysicalDeviceRayTracingPipelinePropertiesKHR& props = rayTracingPipelineProperties_;
   const uint32_t handleSize = props.shaderGroupHandleSize;
   const uint32_t handleSizeAligned = getAlignedSize(props.shaderGroupHandleSize, props.shaderGroupHandleAlignment);
@@ -5365,8 +7789,6 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RayTracingPipelineHandle handle) {
       .stride = sbtEntrySizeAligned,
       .size = numCallableGroups * sbtEntrySizeAligned,
   };
-
-  return rtps->pipeline_;
 }
 
 VkPipeline lvk::VulkanContext::getVkPipeline(ComputePipelineHandle handle) {
@@ -5376,85 +7798,186 @@ VkPipeline lvk::VulkanContext::getVkPipeline(ComputePipelineHandle handle) {
     return VK_NULL_HANDLE;
   }
 
+  buildPipeline(cps, cps->desc_.notReady != PipelineNotReady_Wait);
+
+  if (cps->pendingPipeline_.valid()) {
+    cps->pipeline_ = takeCompiledPipeline(cps->pendingPipeline_, cps->desc_.notReady);
+  }
+
+  return cps->pipeline_;
+}
+
+void lvk::VulkanContext::prewarm(ComputePipelineHandle handle) {
+  lvk::ComputePipelineState* cps = computePipelinesPool_.get(handle);
+
+  if (!LVK_VERIFY(cps)) {
+    return;
+  }
+
+  buildPipeline(cps, true);
+}
+
+bool lvk::VulkanContext::isReady(ComputePipelineHandle handle) const {
+  const lvk::ComputePipelineState* cps = computePipelinesPool_.get(handle);
+
+  return cps && (cps->pipeline_ != VK_NULL_HANDLE || isPipelineCompiled(cps->pendingPipeline_));
+}
+
+void lvk::VulkanContext::buildPipeline(lvk::ComputePipelineState* cps, bool async) {
   checkAndUpdateDescriptorSets();
 
   const DescriptorSet& dset = DSets_[lastUpdatedDSet_];
 
   if (cps->lastVkDescriptorSetLayout_ != dset.vkDSL) {
-    deferredTask(
-        std::packaged_task<void()>([device = vkDevice_, pipeline = cps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-    deferredTask(std::packaged_task<void()>(
-        [device = vkDevice_, layout = cps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+    if (cps->pendingPipeline_.valid()) {
+      // the pipeline being compiled is stale - wait for it and get rid of it below
+      cps->pipeline_ = takeCompiledPipeline(cps->pendingPipeline_, PipelineNotReady_Wait);
+    }
+    deferredDestroy(DeferredObjectType_Pipeline, (uint64_t)cps->pipeline_);
+    deferredDestroy(DeferredObjectType_PipelineLayout, (uint64_t)cps->pipelineLayout_);
     cps->pipeline_ = VK_NULL_HANDLE;
     cps->pipelineLayout_ = VK_NULL_HANDLE;
     cps->lastVkDescriptorSetLayout_ = dset.vkDSL;
   }
 
-  if (cps->pipeline_ == VK_NULL_HANDLE) {
-    const lvk::ShaderModuleState* sm = shaderModulesPool_.get(cps->desc_.smComp);
-
-    LVK_ASSERT(sm);
+  if (cps->pipeline_ != VK_NULL_HANDLE || cps->pendingPipeline_.valid()) {
+    return;
+  }
 
-    VkSpecializationMapEntry entries[SpecializationConstantDesc::LVK_SPECIALIZATION_CONSTANTS_MAX] = {};
+  const lvk::ShaderModuleState* sm = shaderModulesPool_.get(cps->desc_.smComp);
 
-    const VkSpecializationInfo siComp = lvk::getPipelineShaderStageSpecializationInfo(cps->desc_.specInfo, entries);
+  LVK_ASSERT(sm);
 
-    // create pipeline layout
-    {
-      // duplicate for MoltenVK
-      const VkDescriptorSetLayout dsls[] = {dset.vkDSL, dset.vkDSL, dset.vkDSL, dset.vkDSL};
-      const VkPushConstantRange range = {
-          .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
-          .offset = 0,
-          .size = (uint32_t)getAlignedSize(sm->pushConstantsSize, 16),
-      };
-      const VkPipelineLayoutCreateInfo ci = {
-          .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-          .setLayoutCount = (uint32_t)LVK_ARRAY_NUM_ELEMENTS(dsls),
-          .pSetLayouts = dsls,
-          .pushConstantRangeCount = 1,
-          .pPushConstantRanges = &range,
-      };
-      VK_ASSERT(vkCreatePipelineLayout(vkDevice_, &ci, nullptr, &cps->pipelineLayout_));
-      char pipelineLayoutName[256] = {0};
-      if (cps->desc_.debugName) {
-        snprintf(pipelineLayoutName, sizeof(pipelineLayoutName) - 1, "Pipeline Layout: %s", cps->desc_.debugName);
-      }
-      VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE_LAYOUT, (uint64_t)cps->pipelineLayout_, pipelineLayoutName));
+  // create pipeline layout
+  {
+    // duplicate for MoltenVK
+    const VkDescriptorSetLayout dsls[] = {dset.vkDSL, dset.vkDSL, dset.vkDSL, dset.vkDSL};
+    const VkPushConstantRange range = {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = (uint32_t)getAlignedSize(sm->pushConstantsSize, 16),
+    };
+    const VkPipelineLayoutCreateInfo ci = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = (uint32_t)LVK_ARRAY_NUM_ELEMENTS(dsls),
+        .pSetLayouts = dsls,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &range,
+    };
+    VK_ASSERT(vkCreatePipelineLayout(vkDevice_, &ci, nullptr, &cps->pipelineLayout_));
+    char pipelineLayoutName[256] = {0};
+    if (cps->desc_.debugName) {
+      snprintf(pipelineLayoutName, sizeof(pipelineLayoutName) - 1, "Pipeline Layout: %s", cps->desc_.debugName);
     }
+    VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE_LAYOUT, (uint64_t)cps->pipelineLayout_, pipelineLayoutName));
+  }
 
-    const VkComputePipelineCreateInfo ci = {
-        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
-        .flags = 0,
-        .stage = lvk::getPipelineShaderStageCreateInfo(VK_SHADER_STAGE_COMPUTE_BIT, sm->ci, cps->desc_.entryPoint, &siComp),
-        .layout = cps->pipelineLayout_,
-        .basePipelineHandle = VK_NULL_HANDLE,
-        .basePipelineIndex = -1,
-    };
-    VK_ASSERT(vkCreateComputePipelines(vkDevice_, pipelineCache_, 1, &ci, nullptr, &cps->pipeline_));
-    VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE, (uint64_t)cps->pipeline_, cps->desc_.debugName));
+  if (!async) {
+    cps->pipeline_ = compileComputePipeline(cps->desc_, *sm, cps->pipelineLayout_);
+    return;
   }
 
-  return cps->pipeline_;
+  cps->pendingPipeline_ = compilePipelineAsync(std::packaged_task<VkPipeline()>(
+      [this, desc = cps->desc_, sm = *sm, layout = cps->pipelineLayout_]() { return compileComputePipeline(desc, sm, layout); }));
 }
 
-lvk::Holder<lvk::ComputePipelineHandle> lvk::VulkanContext::createComputePipeline(const ComputePipelineDesc& desc, Result* outResult) {
-  if (!LVK_VERIFY(desc.smComp.valid())) {
-    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Missing compute shader");
-    return {};
-  }
+VkPipeline lvk::VulkanContext::compileComputePipeline(const lvk::ComputePipelineDesc& desc,
+                                                      const lvk::ShaderModuleState& sm,
+                                                      VkPipelineLayout layout) const {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
 
-  lvk::ComputePipelineState cps{desc};
+  VkPipeline pipeline = VK_NULL_HANDLE;
 
-  if (desc.specInfo.data && desc.specInfo.dataSize) {
-    // copy into a local storage
-    cps.specConstantDataStorage_ = malloc(desc.specInfo.dataSize);
-    memcpy(cps.specConstantDataStorage_, desc.specInfo.data, desc.specInfo.dataSize);
-    cps.desc_.specInfo.data = cps.specConstantDataStorage_;
-  }
+  VkSpecializationMapEntry entries[SpecializationConstantDesc::LVK_SPECIALIZATION_CONSTANTS_MAX] = {};
 
-  return {this, computePipelinesPool_.create(std::move(cps))};
-}
+  const VkSpecializationInfo siComp = lvk::getPipelineShaderStageSpecializationInfo(desc.specInfo, entries);
+
+  VkPipelineCreationFeedback feedback = {};
+
+  const VkPipelineCreationFeedbackCreateInfo feedbackInfo = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO,
+      .pPipelineCreationFeedback = &feedback,
+  };
+  const VkComputePipelineCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .pNext = &feedbackInfo,
+      .flags = has_EXT_descriptor_buffer_ ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u,
+      .stage = lvk::getPipelineShaderStageCreateInfo(VK_SHADER_STAGE_COMPUTE_BIT, sm.ci, desc.entryPoint, &siComp),
+      .layout = layout,
+      .basePipelineHandle = VK_NULL_HANDLE,
+      .basePipelineIndex = -1,
+  };
+  VK_ASSERT(vkCreateComputePipelines(vkDevice_, pipelineCache_, 1, &ci, nullptr, &pipeline));
+  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_PIPELINE, (uint64_t)pipeline, desc.debugName));
+
+  trackPipelineCacheHit(feedback);
+
+  return pipeline;
+}
+
+std::shared_future<VkPipeline> lvk::VulkanContext::compilePipelineAsync(std::packaged_task<VkPipeline()>&& task) {
+  std::shared_future<VkPipeline> future = task.get_future().share();
+
+  if (!config_.numPipelineCompilerThreads) {
+    task();
+    return future;
+  }
+
+  {
+    std::lock_guard lock(pimpl_->compilerMutex_);
+
+    if (pimpl_->compilerThreads_.empty()) {
+      for (uint32_t i = 0; i != config_.numPipelineCompilerThreads; i++) {
+        pimpl_->compilerThreads_.emplace_back([impl = pimpl_.get()]() {
+          for (;;) {
+            std::packaged_task<VkPipeline()> nextTask;
+            {
+              std::unique_lock lock(impl->compilerMutex_);
+              impl->compilerCondition_.wait(lock, [impl]() { return impl->compilerExit_ || !impl->compilerTasks_.empty(); });
+              if (impl->compilerTasks_.empty()) {
+                return;
+              }
+              nextTask = std::move(impl->compilerTasks_.front());
+              impl->compilerTasks_.pop_front();
+            }
+            nextTask();
+          }
+        });
+      }
+    }
+
+    pimpl_->compilerTasks_.push_back(std::move(task));
+  }
+
+  pimpl_->compilerCondition_.notify_one();
+
+  return future;
+}
+
+lvk::Holder<lvk::ComputePipelineHandle> lvk::VulkanContext::createComputePipeline(const ComputePipelineDesc& desc, Result* outResult) {
+  if (!LVK_VERIFY(desc.smComp.valid())) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Missing compute shader");
+    return {};
+  }
+
+  lvk::ComputePipelineState cps{desc};
+
+  if (desc.specInfo.data && desc.specInfo.dataSize) {
+    // copy into a local storage
+    cps.specConstantDataStorage_ = malloc(desc.specInfo.dataSize);
+    memcpy(cps.specConstantDataStorage_, desc.specInfo.data, desc.specInfo.dataSize);
+    cps.desc_.specInfo.data = cps.specConstantDataStorage_;
+  }
+
+  const ComputePipelineHandle handle = computePipelinesPool_.create(std::move(cps));
+
+  if (handle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create ComputePipeline: the pool is full");
+    return {};
+  }
+
+  return {this, handle};
+}
 
 lvk::Holder<lvk::RayTracingPipelineHandle> lvk::VulkanContext::createRayTracingPipeline(const RayTracingPipelineDesc& desc,
                                                                                         Result* outResult) {
@@ -5474,7 +7997,14 @@ lvk::Holder<lvk::RayTracingPipelineHandle> lvk::VulkanContext::createRayTracingP
     rtps.desc_.specInfo.data = rtps.specConstantDataStorage_;
   }
 
-  return {this, rayTracingPipelinesPool_.create(std::move(rtps))};
+  const RayTracingPipelineHandle handle = rayTracingPipelinesPool_.create(std::move(rtps));
+
+  if (handle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create RayTracingPipeline: the pool is full");
+    return {};
+  }
+
+  return {this, handle};
 }
 
 lvk::Holder<lvk::RenderPipelineHandle> lvk::VulkanContext::createRenderPipeline(const RenderPipelineDesc& desc, Result* outResult) {
@@ -5547,7 +8077,18 @@ lvk::Holder<lvk::RenderPipelineHandle> lvk::VulkanContext::createRenderPipeline(
     rps.desc_.specInfo.data = rps.specConstantDataStorage_;
   }
 
-  return {this, renderPipelinesPool_.create(std::move(rps))};
+  if (has_EXT_extended_dynamic_state3_) {
+    rps.staticStateKey_ = getStaticRenderPipelineStateKey(rps);
+  }
+
+  const RenderPipelineHandle handle = renderPipelinesPool_.create(std::move(rps));
+
+  if (handle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create RenderPipeline: the pool is full");
+    return {};
+  }
+
+  return {this, handle};
 }
 
 void lvk::VulkanContext::destroy(lvk::RayTracingPipelineHandle handle) {
@@ -5557,12 +8098,15 @@ void lvk::VulkanContext::destroy(lvk::RayTracingPipelineHandle handle) {
     return;
   }
 
+  if (rtps->pendingPipeline_.valid()) {
+    // the background compilation references the specialization constants data
+    rtps->pipeline_ = takeCompiledPipeline(rtps->pendingPipeline_, PipelineNotReady_Wait);
+  }
+
   free(rtps->specConstantDataStorage_);
 
-  deferredTask(
-      std::packaged_task<void()>([device = getVkDevice(), pipeline = rtps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-  deferredTask(std::packaged_task<void()>(
-      [device = getVkDevice(), layout = rtps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+  deferredDestroy(DeferredObjectType_Pipeline, (uint64_t)rtps->pipeline_);
+  deferredDestroy(DeferredObjectType_PipelineLayout, (uint64_t)rtps->pipelineLayout_);
 
   rayTracingPipelinesPool_.destroy(handle);
 }
@@ -5574,29 +8118,49 @@ void lvk::VulkanContext::destroy(lvk::ComputePipelineHandle handle) {
     return;
   }
 
+  if (cps->pendingPipeline_.valid()) {
+    // the background compilation references the specialization constants data
+    cps->pipeline_ = takeCompiledPipeline(cps->pendingPipeline_, PipelineNotReady_Wait);
+  }
+
   free(cps->specConstantDataStorage_);
 
-  deferredTask(
-      std::packaged_task<void()>([device = getVkDevice(), pipeline = cps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-  deferredTask(std::packaged_task<void()>(
-      [device = getVkDevice(), layout = cps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+  deferredDestroy(DeferredObjectType_Pipeline, (uint64_t)cps->pipeline_);
+  deferredDestroy(DeferredObjectType_PipelineLayout, (uint64_t)cps->pipelineLayout_);
 
   computePipelinesPool_.destroy(handle);
 }
 
 void lvk::VulkanContext::destroy(lvk::RenderPipelineHandle handle) {
+  std::shared_future<VkPipeline> pendingPipeline;
+  {
+    std::lock_guard lock(pimpl_->renderPipelinesMutex_);
+
+    const lvk::RenderPipelineState* rps = renderPipelinesPool_.get(handle);
+
+    if (!rps) {
+      return;
+    }
+
+    pendingPipeline = rps->pendingPipeline_;
+  }
+
+  // the background compilation references the specialization constants data; wait for it without blocking other recording threads
+  if (pendingPipeline.valid()) {
+    pendingPipeline.wait();
+  }
+
+  std::lock_guard lock(pimpl_->renderPipelinesMutex_);
+
   lvk::RenderPipelineState* rps = renderPipelinesPool_.get(handle);
 
   if (!rps) {
     return;
   }
 
-  free(rps->specConstantDataStorage_);
+  releasePipeline(rps);
 
-  deferredTask(
-      std::packaged_task<void()>([device = getVkDevice(), pipeline = rps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-  deferredTask(std::packaged_task<void()>(
-      [device = getVkDevice(), layout = rps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+  free(rps->specConstantDataStorage_);
 
   renderPipelinesPool_.destroy(handle);
 }
@@ -5618,9 +8182,15 @@ void lvk::VulkanContext::destroy(SamplerHandle handle) {
 
   VkSampler sampler = *samplersPool_.get(handle);
 
-  samplersPool_.destroy(handle);
+  {
+    std::lock_guard lock(descriptorsMutex_);
+    samplersPool_.invalidate(handle);
+  }
+
+  deferredDestroy(DeferredObjectType_Sampler, (uint64_t)sampler);
 
-  deferredTask(std::packaged_task<void()>([device = vkDevice_, sampler = sampler]() { vkDestroySampler(device, sampler, nullptr); }));
+  // the descriptor slot can be reused only after the GPU is done with it
+  deferredDestroy(DeferredObjectType_SamplerSlot, handle.index());
 }
 
 void lvk::VulkanContext::destroy(BufferHandle handle) {
@@ -5636,21 +8206,19 @@ void lvk::VulkanContext::destroy(BufferHandle handle) {
     return;
   }
 
+  trackMemory(buf->memoryCategory_, buf->bufferSize_, false);
+
   if (LVK_VULKAN_USE_VMA) {
     if (buf->mappedPtr_) {
       vmaUnmapMemory((VmaAllocator)getVmaAllocator(), buf->vmaAllocation_);
     }
-    deferredTask(std::packaged_task<void()>([vma = getVmaAllocator(), buffer = buf->vkBuffer_, allocation = buf->vmaAllocation_]() {
-      vmaDestroyBuffer((VmaAllocator)vma, buffer, allocation);
-    }));
+    deferredDestroy(DeferredObjectType_Buffer, (uint64_t)buf->vkBuffer_, buf->vmaAllocation_);
   } else {
     if (buf->mappedPtr_) {
       vkUnmapMemory(vkDevice_, buf->vkMemory_);
     }
-    deferredTask(std::packaged_task<void()>([device = vkDevice_, buffer = buf->vkBuffer_, memory = buf->vkMemory_]() {
-      vkDestroyBuffer(device, buffer, nullptr);
-      vkFreeMemory(device, memory, nullptr);
-    }));
+    deferredDestroy(DeferredObjectType_Buffer, (uint64_t)buf->vkBuffer_);
+    deferredDestroy(DeferredObjectType_DeviceMemory, (uint64_t)buf->vkMemory_);
   }
 }
 
@@ -5658,8 +8226,14 @@ void lvk::VulkanContext::destroy(lvk::TextureHandle handle) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_DESTROY);
 
   SCOPE_EXIT {
-    texturesPool_.destroy(handle);
-    awaitingCreation_ = true; // make the validation layers happy
+    {
+      std::lock_guard lock(descriptorsMutex_);
+      texturesPool_.invalidate(handle);
+    }
+    if (!handle.empty()) {
+      // the descriptor slot can be reused only after the GPU is done with it; replace it with a dummy to make the validation layers happy
+      deferredDestroy(DeferredObjectType_TextureSlot, handle.index());
+    }
   };
 
   lvk::VulkanImage* tex = texturesPool_.get(handle);
@@ -5668,25 +8242,21 @@ void lvk::VulkanContext::destroy(lvk::TextureHandle handle) {
     return;
   }
 
-  deferredTask(std::packaged_task<void()>(
-      [device = getVkDevice(), imageView = tex->imageView_]() { vkDestroyImageView(device, imageView, nullptr); }));
+  deferredDestroy(DeferredObjectType_ImageView, (uint64_t)tex->imageView_);
   if (tex->imageViewStorage_) {
-    deferredTask(std::packaged_task<void()>(
-        [device = getVkDevice(), imageView = tex->imageViewStorage_]() { vkDestroyImageView(device, imageView, nullptr); }));
+    deferredDestroy(DeferredObjectType_ImageView, (uint64_t)tex->imageViewStorage_);
   }
 
   for (size_t i = 0; i != LVK_MAX_MIP_LEVELS; i++) {
     for (size_t j = 0; j != LVK_ARRAY_NUM_ELEMENTS(tex->imageViewForFramebuffer_[0]); j++) {
       VkImageView v = tex->imageViewForFramebuffer_[i][j];
       if (v != VK_NULL_HANDLE) {
-        deferredTask(
-            std::packaged_task<void()>([device = getVkDevice(), imageView = v]() { vkDestroyImageView(device, imageView, nullptr); }));
+        deferredDestroy(DeferredObjectType_ImageView, (uint64_t)v);
       }
     }
     VkImageView v = tex->imageViewForFramebufferMultiview_[i];
     if (v != VK_NULL_HANDLE) {
-      deferredTask(
-          std::packaged_task<void()>([device = getVkDevice(), imageView = v]() { vkDestroyImageView(device, imageView, nullptr); }));
+      deferredDestroy(DeferredObjectType_ImageView, (uint64_t)v);
     }
   }
 
@@ -5694,33 +8264,49 @@ void lvk::VulkanContext::destroy(lvk::TextureHandle handle) {
     return;
   }
 
+  if (tex->sparse_) {
+    std::vector<uint32_t> pages;
+    pages.reserve(tex->sparse_->numResidentPages_);
+    for (uint32_t page : tex->sparse_->pages_) {
+      if (page != VulkanSparseImage::kUnbound) {
+        pages.push_back(page);
+      }
+    }
+    freeSparsePagesDeferred(std::move(pages));
+    trackMemory(MemoryCategory_Texture, tex->memorySize_, false);
+    destroy(tex->sparse_->feedback_);
+    deferredDestroy(DeferredObjectType_Image, (uint64_t)tex->vkImage_);
+    if (tex->sparse_->mipTailMemory_) {
+      deferredDestroy(DeferredObjectType_DeviceMemory, (uint64_t)tex->sparse_->mipTailMemory_);
+    }
+    delete tex->sparse_;
+    tex->sparse_ = nullptr;
+    return;
+  }
+
+  if (!tex->isOwningVkMemory_) {
+    // the memory belongs to the aliased texture
+    deferredDestroy(DeferredObjectType_Image, (uint64_t)tex->vkImage_);
+    return;
+  }
+
+  trackMemory(MemoryCategory_Texture, tex->memorySize_, false);
+
   if (LVK_VULKAN_USE_VMA && tex->vkMemory_[1] == VK_NULL_HANDLE) {
     if (tex->mappedPtr_) {
       vmaUnmapMemory((VmaAllocator)getVmaAllocator(), tex->vmaAllocation_);
     }
-    deferredTask(std::packaged_task<void()>([vma = getVmaAllocator(), image = tex->vkImage_, allocation = tex->vmaAllocation_]() {
-      vmaDestroyImage((VmaAllocator)vma, image, allocation);
-    }));
+    deferredDestroy(DeferredObjectType_Image, (uint64_t)tex->vkImage_, tex->vmaAllocation_);
   } else {
     if (tex->mappedPtr_) {
       vkUnmapMemory(vkDevice_, tex->vkMemory_[0]);
     }
-    deferredTask(std::packaged_task<void()>([device = vkDevice_,
-                                             image = tex->vkImage_,
-                                             memory0 = tex->vkMemory_[0],
-                                             memory1 = tex->vkMemory_[1],
-                                             memory2 = tex->vkMemory_[2]]() {
-      vkDestroyImage(device, image, nullptr);
-      if (memory0 != VK_NULL_HANDLE) {
-        vkFreeMemory(device, memory0, nullptr);
+    deferredDestroy(DeferredObjectType_Image, (uint64_t)tex->vkImage_);
+    for (VkDeviceMemory memory : tex->vkMemory_) {
+      if (memory != VK_NULL_HANDLE) {
+        deferredDestroy(DeferredObjectType_DeviceMemory, (uint64_t)memory);
       }
-      if (memory1 != VK_NULL_HANDLE) {
-        vkFreeMemory(device, memory1, nullptr);
-      }
-      if (memory2 != VK_NULL_HANDLE) {
-        vkFreeMemory(device, memory2, nullptr);
-      }
-    }));
+    }
   }
 }
 
@@ -5729,18 +8315,47 @@ void lvk::VulkanContext::destroy(lvk::QueryPoolHandle handle) {
 
   queriesPool_.destroy(handle);
 
-  deferredTask(std::packaged_task<void()>([device = vkDevice_, pool = pool]() { vkDestroyQueryPool(device, pool, nullptr); }));
+  deferredDestroy(DeferredObjectType_QueryPool, (uint64_t)pool);
 }
 
 void lvk::VulkanContext::destroy(lvk::AccelStructHandle handle) {
   AccelerationStructure* accelStruct = accelStructuresPool_.get(handle);
 
   SCOPE_EXIT {
-    accelStructuresPool_.destroy(handle);
+    {
+      std::lock_guard lock(descriptorsMutex_);
+      accelStructuresPool_.invalidate(handle);
+    }
+    if (!handle.empty()) {
+      // the descriptor slot can be reused only after the GPU is done with it
+      deferredDestroy(DeferredObjectType_AccelStructSlot, handle.index());
+    }
   };
 
-  deferredTask(std::packaged_task<void()>(
-      [device = vkDevice_, as = accelStruct->vkHandle]() { vkDestroyAccelerationStructureKHR(device, as, nullptr); }));
+  deferredDestroy(DeferredObjectType_AccelStruct, (uint64_t)accelStruct->vkHandle);
+}
+
+void lvk::VulkanContext::destroy(lvk::ReadbackHandle handle) {
+  lvk::ReadbackState* readback = readbacksPool_.get(handle);
+
+  if (!readback) {
+    return;
+  }
+
+  const lvk::VulkanBuffer* buf = buffersPool_.get(readback->buffer_);
+
+  // keep the buffer around for new readbacks; `size_` is its full capacity here
+  freeReadbackBuffers_.push_back({
+      .size_ = buf ? (size_t)buf->bufferSize_ : 0,
+      .handle_ = readback->handle_,
+  });
+  freeReadbackBuffers_.back().buffer_ = std::move(readback->buffer_);
+
+  if (freeReadbackBuffers_.size() > kMaxFreeReadbackBuffers) {
+    freeReadbackBuffers_.erase(freeReadbackBuffers_.begin());
+  }
+
+  readbacksPool_.destroy(handle);
 }
 
 void lvk::VulkanContext::destroy(Framebuffer& fb) {
@@ -5775,8 +8390,38 @@ uint64_t lvk::VulkanContext::gpuAddress(AccelStructHandle handle) const {
 lvk::Result lvk::VulkanContext::upload(lvk::BufferHandle handle, const void* data, size_t size, size_t offset) {
   LVK_PROFILER_FUNCTION();
 
+  Result result;
+
+  uploadBuffer(*stagingDevice_, handle, data, size, offset, &result);
+
+  return result;
+}
+
+lvk::SubmitHandle lvk::VulkanContext::uploadAsync(lvk::BufferHandle handle,
+                                                  const void* data,
+                                                  size_t size,
+                                                  size_t offset,
+                                                  Result* outResult) {
+  LVK_PROFILER_FUNCTION();
+
+  const lvk::VulkanBuffer* buf = buffersPool_.get(handle);
+
+  // exclusive buffers belong to the graphics queue family
+  const bool isAsync = (buf && buf->isShared_) || deviceQueues_.transferQueueFamilyIndex == deviceQueues_.graphicsQueueFamilyIndex;
+
+  return uploadBuffer(isAsync ? *stagingDeviceAsync_ : *stagingDevice_, handle, data, size, offset, outResult, false);
+}
+
+lvk::SubmitHandle lvk::VulkanContext::uploadBuffer(lvk::VulkanStagingDevice& staging,
+                                                   lvk::BufferHandle handle,
+                                                   const void* data,
+                                                   size_t size,
+                                                   size_t offset,
+                                                   Result* outResult,
+                                                   bool canStall) {
   if (!LVK_VERIFY(data)) {
-    return Result(Result::Code::ArgumentOutOfRange);
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange);
+    return {};
   }
 
   LVK_ASSERT_MSG(size, "Data size should be non-zero");
@@ -5784,16 +8429,22 @@ lvk::Result lvk::VulkanContext::upload(lvk::BufferHandle handle, const void* dat
   lvk::VulkanBuffer* buf = buffersPool_.get(handle);
 
   if (!LVK_VERIFY(buf)) {
-    return Result(Result::Code::ArgumentOutOfRange);
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange);
+    return {};
   }
 
   if (!LVK_VERIFY(offset + size <= buf->bufferSize_)) {
-    return Result(Result::Code::ArgumentOutOfRange, "Out of range");
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Out of range");
+    return {};
   }
 
-  stagingDevice_->bufferSubData(*buf, offset, size, data);
+  bool isPending = false;
 
-  return Result();
+  const SubmitHandle submitHandle = staging.bufferSubData(*buf, offset, size, data, canStall ? nullptr : &isPending);
+
+  Result::setResult(outResult, isPending ? Result(Result::Code::Pending, "Staging memory is full") : Result());
+
+  return submitHandle;
 }
 
 lvk::Result lvk::VulkanContext::download(lvk::BufferHandle handle, void* data, size_t size, size_t offset) {
@@ -5846,6 +8497,10 @@ void lvk::VulkanContext::flushMappedMemory(BufferHandle handle, size_t offset, s
   buf->flushMappedMemory(*this, offset, size);
 }
 
+lvk::TransientAllocation lvk::VulkanContext::allocateTransient(size_t size, size_t alignment) {
+  return transientAllocator_->allocate(size, alignment);
+}
+
 lvk::Result lvk::VulkanContext::download(lvk::TextureHandle handle, const TextureRangeDesc& range, void* outData) {
   if (!outData) {
     return Result(Result::Code::ArgumentOutOfRange);
@@ -5881,2233 +8536,4376 @@ lvk::Result lvk::VulkanContext::download(lvk::TextureHandle handle, const Textur
   return Result();
 }
 
-lvk::Result lvk::VulkanContext::upload(lvk::TextureHandle handle,
-                                       const TextureRangeDesc& range,
-                                       const void* data,
-                                       uint32_t bufferRowLength) {
-  LVK_PROFILER_FUNCTION();
-
-  if (!LVK_VERIFY(data)) {
-    return Result(Result::Code::ArgumentOutOfRange);
+lvk::Holder<lvk::BufferHandle> lvk::VulkanContext::acquireReadbackBuffer(size_t size, Result* outResult) {
+  // reuse the smallest released buffer which is large enough and no longer written by the GPU
+  size_t best = freeReadbackBuffers_.size();
+  for (size_t i = 0; i != freeReadbackBuffers_.size(); i++) {
+    const ReadbackState& r = freeReadbackBuffers_[i];
+    if (r.size_ >= size && (best == freeReadbackBuffers_.size() || r.size_ < freeReadbackBuffers_[best].size_) &&
+        immediate_->isReady(r.handle_)) {
+      best = i;
+    }
   }
 
-  lvk::VulkanImage* texture = texturesPool_.get(handle);
-
-  if (!LVK_VERIFY(texture)) {
-    return Result(Result::Code::ArgumentOutOfRange);
+  if (best != freeReadbackBuffers_.size()) {
+    lvk::Holder<lvk::BufferHandle> buffer = std::move(freeReadbackBuffers_[best].buffer_);
+    freeReadbackBuffers_.erase(freeReadbackBuffers_.begin() + best);
+    return buffer;
   }
 
-  const Result result = validateRange(texture->vkExtent_, texture->numLevels_, range);
+  char debugName[256] = {0};
+  snprintf(debugName, sizeof(debugName) - 1, "Buffer: readback buffer %u", readbackBufferCounter_++);
 
-  if (!LVK_VERIFY(result.isOk())) {
-    return Result(Result::Code::ArgumentOutOfRange);
+  Result result;
+  lvk::Holder<lvk::BufferHandle> buffer = {
+      this,
+      createBuffer(getAlignedSize(size, kReadbackBufferAlignment),
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                   &result,
+                   debugName)};
+
+  if (!result.isOk()) {
+    Result::setResult(outResult, result);
+    return {};
   }
 
-  const uint32_t numLayers = std::max(range.numLayers, 1u);
+  return buffer;
+}
 
-  VkFormat vkFormat = texture->vkImageFormat_;
+lvk::Holder<lvk::ReadbackHandle> lvk::VulkanContext::readbackAsync(lvk::BufferHandle handle,
+                                                                   size_t size,
+                                                                   size_t offset,
+                                                                   Result* outResult) {
+  LVK_PROFILER_FUNCTION();
 
-  if (texture->vkType_ == VK_IMAGE_TYPE_3D) {
-    stagingDevice_->imageData3D(*texture,
-                                VkOffset3D{range.offset.x, range.offset.y, range.offset.z},
-                                VkExtent3D{range.dimensions.width, range.dimensions.height, range.dimensions.depth},
-                                vkFormat,
-                                data);
-  } else {
-    const VkRect2D imageRegion = {
-        .offset = {.x = range.offset.x, .y = range.offset.y},
-        .extent = {.width = range.dimensions.width, .height = range.dimensions.height},
-    };
-    stagingDevice_->imageData2D(
-        *texture, imageRegion, range.mipLevel, range.numMipLevels, range.layer, range.numLayers, vkFormat, data, bufferRowLength);
-  }
+  LVK_ASSERT_MSG(size, "Data size should be non-zero");
 
-  return Result();
-}
+  const lvk::VulkanBuffer* buf = buffersPool_.get(handle);
 
-lvk::Dimensions lvk::VulkanContext::getDimensions(TextureHandle handle) const {
-  if (!handle) {
+  if (!LVK_VERIFY(buf)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange);
     return {};
   }
 
-  const lvk::VulkanImage* tex = texturesPool_.get(handle);
+  if (!LVK_VERIFY(offset + size <= buf->bufferSize_)) {
+    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Out of range"));
+    return {};
+  }
 
-  LVK_ASSERT(tex);
+  ReadbackState readback = {
+      .buffer_ = acquireReadbackBuffer(size, outResult),
+      .size_ = size,
+  };
 
-  if (!tex) {
+  if (readback.buffer_.empty()) {
     return {};
   }
 
-  return {
-      .width = tex->vkExtent_.width,
-      .height = tex->vkExtent_.height,
-      .depth = tex->vkExtent_.depth,
+  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = immediate_->acquire();
+
+  const VkBufferMemoryBarrier2 barrierBefore = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+      .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+      .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+      .dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+      .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = buf->vkBuffer_,
+      .offset = offset,
+      .size = size,
   };
-}
+  const VkDependencyInfo dependencyBefore = {
+      .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+      .bufferMemoryBarrierCount = 1,
+      .pBufferMemoryBarriers = &barrierBefore,
+  };
+  vkCmdPipelineBarrier2(wrapper.cmdBuf_, &dependencyBefore);
 
-float lvk::VulkanContext::getAspectRatio(TextureHandle handle) const {
-  if (!handle) {
-    return 1.0f;
-  }
+  const VkBufferCopy copy = {
+      .srcOffset = offset,
+      .dstOffset = 0,
+      .size = size,
+  };
+  vkCmdCopyBuffer(wrapper.cmdBuf_, buf->vkBuffer_, getVkBuffer(this, readback.buffer_), 1, &copy);
 
-  const lvk::VulkanImage* tex = texturesPool_.get(handle);
+  readback.handle_ = submitReadback(wrapper, getVkBuffer(this, readback.buffer_));
 
-  LVK_ASSERT(tex);
+  const ReadbackHandle readbackHandle = readbacksPool_.create(std::move(readback));
 
-  if (!tex) {
-    return 1.0f;
+  if (readbackHandle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create Readback: the pool is full");
+    return {};
   }
 
-  return static_cast<float>(tex->vkExtent_.width) / static_cast<float>(tex->vkExtent_.height);
+  return {this, readbackHandle};
 }
 
-void lvk::VulkanContext::generateMipmap(TextureHandle handle) const {
-  if (handle.empty()) {
-    return;
-  }
+lvk::Holder<lvk::ReadbackHandle> lvk::VulkanContext::readbackAsync(lvk::TextureHandle handle,
+                                                                   const TextureRangeDesc& range,
+                                                                   Result* outResult) {
+  LVK_PROFILER_FUNCTION();
 
-  const lvk::VulkanImage* tex = texturesPool_.get(handle);
+  const lvk::VulkanImage* texture = texturesPool_.get(handle);
 
-  if (tex->numLevels_ <= 1) {
-    return;
+  if (!LVK_VERIFY(texture)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange);
+    return {};
   }
 
-  LVK_ASSERT(tex->vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
-  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = immediate_->acquire();
-  tex->generateMipmap(wrapper.cmdBuf_);
-  immediate_->submit(wrapper);
-}
+  const Result result = validateRange(texture->vkExtent_, texture->numLevels_, range);
 
-lvk::Format lvk::VulkanContext::getFormat(TextureHandle handle) const {
-  if (handle.empty()) {
-    return Format_Invalid;
+  if (!LVK_VERIFY(result.isOk())) {
+    Result::setResult(outResult, result);
+    return {};
   }
 
-  return vkFormatToFormat(texturesPool_.get(handle)->vkImageFormat_);
-}
-
-lvk::Holder<lvk::ShaderModuleHandle> lvk::VulkanContext::createShaderModule(const ShaderModuleDesc& desc, Result* outResult) {
-  Result result;
-  auto isSlang = [](const char* code) {
-    if (!code)
-      return false;
-    return strstr(code, "[shader(\"") != nullptr;
-  };
-  ShaderModuleState sm = desc.dataSize ? createShaderModuleFromSPIRV(desc.data, desc.dataSize, desc.debugName, &result) // binary
-                         : isSlang(desc.data) // text
-                             ? createShaderModuleFromSlang(desc.stage, desc.data, desc.entryPointName, desc.debugName, &result)
-                             : createShaderModuleFromGLSL(desc.stage, desc.data, desc.debugName, &result);
-
-  if (!result.isOk()) {
-    Result::setResult(outResult, result);
+  if (!LVK_VERIFY(range.numMipLevels == 1)) {
+    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Only one mip-level can be read back at a time"));
     return {};
   }
-  Result::setResult(outResult, result);
 
-  return {this, shaderModulesPool_.create(std::move(sm))};
-}
+  LVK_ASSERT(texture->vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
 
-lvk::ShaderModuleState lvk::VulkanContext::createShaderModuleFromSPIRV(const void* spirv,
-                                                                       size_t numBytes,
-                                                                       const char* debugName,
-                                                                       Result* outResult) const {
-  (void)debugName;
+  const size_t size = (size_t)getTextureBytesPerLayer(range.dimensions.width,
+                                                      range.dimensions.height,
+                                                      vkFormatToFormat(texture->vkImageFormat_),
+                                                      0) *
+                      range.dimensions.depth * range.numLayers;
 
-  if (!spirv || !numBytes) {
-    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Expecting non-empty SPIR-V code"));
+  ReadbackState readback = {
+      .buffer_ = acquireReadbackBuffer(size, outResult),
+      .size_ = size,
+  };
+
+  if (readback.buffer_.empty()) {
     return {};
   }
 
-  SpvReflectShaderModule mdl;
-  SpvReflectResult result = spvReflectCreateShaderModule(numBytes, spirv, &mdl);
-  LVK_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
-  SCOPE_EXIT {
-    spvReflectDestroyShaderModule(&mdl);
+  // copies can read only one aspect of depth-stencil images
+  const VkImageAspectFlags aspect = texture->isDepthFormat_     ? VK_IMAGE_ASPECT_DEPTH_BIT
+                                    : texture->isStencilFormat_ ? VK_IMAGE_ASPECT_STENCIL_BIT
+                                                                : VK_IMAGE_ASPECT_COLOR_BIT;
+  const VkImageSubresourceRange subresourceRange = {
+      .aspectMask = texture->getImageAspectFlags(),
+      .baseMipLevel = range.mipLevel,
+      .levelCount = 1,
+      .baseArrayLayer = range.layer,
+      .layerCount = range.numLayers,
   };
 
-  uint32_t pushConstantsSize = 0;
-
-  for (uint32_t i = 0; i < mdl.push_constant_block_count; ++i) {
-    const SpvReflectBlockVariable& block = mdl.push_constant_blocks[i];
-    pushConstantsSize = std::max(pushConstantsSize, block.offset + block.size);
-  }
+  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = immediate_->acquire();
 
-  const VkShaderModuleCreateInfo ci = {
-      .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-      .codeSize = numBytes,
-      .pCode = (const uint32_t*)malloc(numBytes),
+  // 1. Transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+  lvk::imageMemoryBarrier2(wrapper.cmdBuf_,
+                           texture->vkImage_,
+                           StageAccess{.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, .access = VK_ACCESS_2_MEMORY_WRITE_BIT},
+                           StageAccess{.stage = VK_PIPELINE_STAGE_2_TRANSFER_BIT, .access = VK_ACCESS_2_TRANSFER_READ_BIT},
+                           texture->vkImageLayout_,
+                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           subresourceRange);
+
+  // 2. Copy the texels into the readback buffer tightly packed
+  const VkBufferImageCopy2 copy = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
+      .bufferOffset = 0,
+      .bufferRowLength = 0,
+      .bufferImageHeight = 0,
+      .imageSubresource =
+          VkImageSubresourceLayers{
+              .aspectMask = aspect,
+              .mipLevel = range.mipLevel,
+              .baseArrayLayer = range.layer,
+              .layerCount = range.numLayers,
+          },
+      .imageOffset = VkOffset3D{range.offset.x, range.offset.y, range.offset.z},
+      .imageExtent = VkExtent3D{range.dimensions.width, range.dimensions.height, range.dimensions.depth},
   };
-
-  memcpy((void*)ci.pCode, spirv, numBytes);
-
-  return {
-      .ci = ci,
-      .pushConstantsSize = pushConstantsSize,
+  const VkCopyImageToBufferInfo2 copyInfo = {
+      .sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_BUFFER_INFO_2,
+      .srcImage = texture->vkImage_,
+      .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+      .dstBuffer = getVkBuffer(this, readback.buffer_),
+      .regionCount = 1,
+      .pRegions = &copy,
   };
-}
+  vkCmdCopyImageToBuffer2(wrapper.cmdBuf_, &copyInfo);
 
-lvk::ShaderModuleState lvk::VulkanContext::createShaderModuleFromGLSL(ShaderStage stage,
-                                                                      const char* source,
-                                                                      const char* debugName,
-                                                                      Result* outResult) const {
-  const VkShaderStageFlagBits vkStage = shaderStageToVkShaderStage(stage);
-  LVK_ASSERT(vkStage != VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM);
-  LVK_ASSERT(source);
+  // 3. Transition back to the current image layout
+  lvk::imageMemoryBarrier2(
+      wrapper.cmdBuf_,
+      texture->vkImage_,
+      StageAccess{.stage = VK_PIPELINE_STAGE_2_TRANSFER_BIT, .access = VK_ACCESS_2_NONE},
+      StageAccess{.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, .access = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT},
+      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+      texture->vkImageLayout_,
+      subresourceRange);
 
-  std::string sourcePatched;
+  readback.handle_ = submitReadback(wrapper, getVkBuffer(this, readback.buffer_));
 
-  if (!source || !*source) {
-    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Shader source is empty");
+  const ReadbackHandle readbackHandle = readbacksPool_.create(std::move(readback));
+
+  if (readbackHandle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create Readback: the pool is full");
     return {};
   }
 
-  auto addCode = [source, &sourcePatched](const char* substr, const char* code) -> void {
-    if (strstr(source, substr)) {
-      sourcePatched.append(code);
-    }
-  };
+  return {this, readbackHandle};
+}
 
-  if (strstr(source, "#version ") == nullptr) {
-    if (vkStage == VK_SHADER_STAGE_TASK_BIT_EXT || vkStage == VK_SHADER_STAGE_MESH_BIT_EXT) {
-      sourcePatched +=
-          "#version 460\n"
-          "#extension GL_EXT_buffer_reference : require\n"
-          "#extension GL_EXT_buffer_reference_uvec2 : require\n"
-          "#extension GL_EXT_debug_printf : enable\n"
-          "#extension GL_EXT_nonuniform_qualifier : require\n"
-          "#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require\n"
-          "#extension GL_EXT_mesh_shader : require\n";
-    }
-    if (vkStage == VK_SHADER_STAGE_VERTEX_BIT || vkStage == VK_SHADER_STAGE_COMPUTE_BIT ||
-        vkStage == VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT || vkStage == VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT) {
-      sourcePatched +=
-          "#version 460\n"
-          "#extension GL_EXT_buffer_reference : require\n"
-          "#extension GL_EXT_buffer_reference_uvec2 : require\n"
-          "#extension GL_EXT_debug_printf : enable\n"
-          "#extension GL_EXT_nonuniform_qualifier : require\n"
-          "#extension GL_EXT_samplerless_texture_functions : require\n"
-          "#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require\n";
-    }
-    if (vkStage == VK_SHADER_STAGE_FRAGMENT_BIT) {
-      // Note how nonuniformEXT() should be used:
-      // https://github.com/KhronosGroup/Vulkan-Samples/blob/main/shaders/descriptor_indexing/nonuniform-quads.frag#L33-L39
-      sourcePatched +=
-          "#version 460\n"
-          "#extension GL_EXT_buffer_reference_uvec2 : require\n"
-          "#extension GL_EXT_debug_printf : enable\n"
-          "#extension GL_EXT_nonuniform_qualifier : require\n"
-          "#extension GL_EXT_samplerless_texture_functions : require\n"
-          "#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require\n";
-      addCode("kTLAS[",
-              "#extension GL_EXT_buffer_reference : require\n"
-              "#extension GL_EXT_ray_query : require\n"
-              "layout(set = 0, binding = 4) uniform accelerationStructureEXT kTLAS[];\n");
-      sourcePatched +=
-          "layout (set = 0, binding = 0) uniform texture2D   kTextures2D[];\n"
-          "layout (set = 1, binding = 0) uniform texture3D   kTextures3D[];\n"
-          "layout (set = 2, binding = 0) uniform textureCube kTexturesCube[];\n"
-          "layout (set = 3, binding = 0) uniform texture2D   kTextures2DShadow[];\n"
-          "layout (set = 0, binding = 1) uniform sampler       kSamplers[];\n"
-          "layout (set = 3, binding = 1) uniform samplerShadow kSamplersShadow[];\n"
-          "layout (set = 0, binding = 3) uniform sampler2D     kSamplersYUV[];\n";
-      addCode("textureBindless2D(",
-              "vec4 textureBindless2D(uint textureid, uint samplerid, vec2 uv) {\n"
-              "  return texture(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])), uv);\n"
-              "}\n");
-      addCode("textureBindless2DLod(",
-              "vec4 textureBindless2DLod(uint textureid, uint samplerid, vec2 uv, float lod) {\n"
-              "  return textureLod(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])), uv, lod);\n"
-              "}\n");
-      addCode("textureBindless2DShadow(",
-              "float textureBindless2DShadow(uint textureid, uint samplerid, vec3 uvw) {"
-              "  return texture(nonuniformEXT(sampler2DShadow(kTextures2DShadow[textureid], kSamplersShadow[samplerid])), uvw);\n"
-              "}\n");
-      addCode("textureBindlessSize2D(",
-              "ivec2 textureBindlessSize2D(uint textureid) {\n"
-              "  return textureSize(nonuniformEXT(kTextures2D[textureid]), 0);\n"
-              "}\n");
-      addCode("textureBindlessCube(",
-              "vec4 textureBindlessCube(uint textureid, uint samplerid, vec3 uvw) {\n"
-              "  return texture(nonuniformEXT(samplerCube(kTexturesCube[textureid], kSamplers[samplerid])), uvw);\n"
-              "}\n");
-      addCode("textureBindlessCubeLod(",
-              "vec4 textureBindlessCubeLod(uint textureid, uint samplerid, vec3 uvw, float lod) {\n"
-              "  return textureLod(nonuniformEXT(samplerCube(kTexturesCube[textureid], kSamplers[samplerid])), uvw, lod);\n"
-              "}\n");
-      addCode("textureBindless3D(",
-              "vec4 textureBindless3D(uint textureid, uint samplerid, vec3 uvw) {\n"
-              "  return texture(nonuniformEXT(sampler3D(kTextures3D[textureid], kSamplers[samplerid])), uvw);\n"
-              "}\n");
-      addCode("textureBindless3DLod(",
-              "vec4 textureBindless3DLod(uint textureid, uint samplerid, vec3 uvw, float lod) {\n"
-              "  return textureLod(nonuniformEXT(sampler3D(kTextures3D[textureid], kSamplers[samplerid])), uvw, lod);\n"
-              "}\n");
-      addCode("textureBindlessQueryLevels2D(",
-              "int textureBindlessQueryLevels2D(uint textureid) {\n"
-              "  return textureQueryLevels(nonuniformEXT(kTextures2D[textureid]));\n"
-              "}\n");
-      addCode("textureBindlessQueryLevelsCube(",
-              "int textureBindlessQueryLevelsCube(uint textureid) {\n"
-              "  return textureQueryLevels(nonuniformEXT(kTexturesCube[textureid]));\n"
-              "}\n");
-    }
-    sourcePatched += source;
-    source = sourcePatched.c_str();
-  }
+lvk::SubmitHandle lvk::VulkanContext::submitReadback(const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper,
+                                                     VkBuffer readbackBuffer) {
+  // make the copied data visible to the host
+  const VkBufferMemoryBarrier2 barrier = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+      .srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+      .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+      .dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT,
+      .dstAccessMask = VK_ACCESS_2_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = readbackBuffer,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  const VkDependencyInfo dependencyInfo = {
+      .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+      .bufferMemoryBarrierCount = 1,
+      .pBufferMemoryBarriers = &barrier,
+  };
+  vkCmdPipelineBarrier2(wrapper.cmdBuf_, &dependencyInfo);
 
-  const glslang_resource_t glslangResource = lvk::getGlslangResource(getVkPhysicalDeviceProperties().limits);
+  return immediate_->submit(wrapper);
+}
 
-  std::vector<uint8_t> spirv;
-  lvk::Result::setResult(outResult, lvk::compileShaderGlslang(stage, source, &spirv, &glslangResource));
+bool lvk::VulkanContext::isReady(ReadbackHandle handle) const {
+  const lvk::ReadbackState* readback = readbacksPool_.get(handle);
 
-  return createShaderModuleFromSPIRV(spirv.data(), spirv.size(), debugName, outResult);
+  return readback && immediate_->isReady(readback->handle_);
 }
 
-lvk::ShaderModuleState lvk::VulkanContext::createShaderModuleFromSlang(ShaderStage stage,
-                                                                       const char* source,
-                                                                       const char* entryPointName,
-                                                                       const char* debugName,
-                                                                       Result* outResult) const {
-  std::string sourcePatched;
+const void* lvk::VulkanContext::getReadbackData(ReadbackHandle handle, size_t* outSize) {
+  lvk::ReadbackState* readback = readbacksPool_.get(handle);
 
-  if (!source || !*source) {
-    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Shader source is empty");
-    return {};
+  if (!LVK_VERIFY(readback) || !immediate_->isReady(readback->handle_)) {
+    return nullptr;
   }
 
-  auto addCode = [source, &sourcePatched](const char* substr, const char* code) -> void {
-    if (strstr(source, substr)) {
-      sourcePatched.append(code);
-    }
-  };
-
-  // overloaded operators to mimic GLSL matrix operations
-  sourcePatched +=
-      "float2x2 operator*(float2x2 a, float2x2 b) { return mul(b, a); }\n"
-      "float2   operator*(float2x2 a, float2   b) { return mul(b, a); }\n"
-      "float3x3 operator*(float3x3 a, float3x3 b) { return mul(b, a); }\n"
-      "float3   operator*(float3x3 a, float3   b) { return mul(b, a); }\n"
-      "float4x4 operator*(float4x4 a, float4x4 b) { return mul(b, a); }\n"
-      "float4   operator*(float4x4 a, float4   b) { return mul(b, a); }\n";
-  // bindless texture and sampler arrays
-  sourcePatched +=
-      "[[vk::binding(0, 0)]] Texture2D    kTextures2D[];\n"
-      "[[vk::binding(0, 1)]] Texture3D    kTextures3D[];\n"
-      "[[vk::binding(0, 2)]] TextureCube  kTexturesCube[];\n"
-      "[[vk::binding(0, 3)]] Texture2D    kTextures2DShadow[];\n"
-      "[[vk::binding(1, 0)]] SamplerState kSamplers[];\n"
-      "[[vk::binding(1, 3)]] SamplerComparisonState kSamplersShadow[];\n"
-      "[[vk::binding(3, 0)]] Sampler2D    kSamplersYUV[];\n";
-  // cannot handle unbounded arrays https://github.com/shader-slang/slang/issues/8902
-  addCode("kTLAS[", "[[vk::binding(4, 0)]] RaytracingAccelerationStructure kTLAS[];\n");
-  addCode("textureBindless2D(",
-          "float4 textureBindless2D(uint textureid, uint samplerid, float2 uv) {\n"
-          "  return kTextures2D[NonUniformResourceIndex(textureid)].Sample(\n"
-          "    kSamplers[NonUniformResourceIndex(samplerid)], uv);\n"
-          "}\n");
-  addCode("textureBindless2DLod(",
-          "float4 textureBindless2DLod(uint textureid, uint samplerid, float2 uv, float lod) {\n"
-          "  return kTextures2D[NonUniformResourceIndex(textureid)].SampleLevel(\n"
-          "    kSamplers[NonUniformResourceIndex(samplerid)], uv, lod);\n"
-          "}\n");
-  addCode("textureBindlessCube(",
-          "float4 textureBindlessCube(uint textureid, uint samplerid, float3 dir) {\n"
-          "  return kTexturesCube[NonUniformResourceIndex(textureid)].Sample(\n"
-          "    kSamplers[NonUniformResourceIndex(samplerid)], dir);\n"
-          "}\n");
-  addCode("textureBindlessSize2D(",
-          "int2 textureBindlessSize2D(uint textureid) {\n"
-          "  uint width, height;\n"
-          "  kTextures2D[NonUniformResourceIndex(textureid)].GetDimensions(width, height);\n"
-          "  return int2(width, height);\n"
-          "}\n");
-  addCode("textureBindless2DShadow(",
-          "float textureBindless2DShadow(uint textureid, uint samplerid, float3 uvw) {\n"
-          "  return kTextures2DShadow[NonUniformResourceIndex(textureid)].SampleCmpLevelZero(\n"
-          "    kSamplersShadow[NonUniformResourceIndex(samplerid)], uvw.xy, uvw.z);\n"
-          "}\n");
-  addCode("textureBindless3D(",
-          "float4 textureBindless3D(uint textureid, uint samplerid, float3 uvw) {\n"
-          "  return kTextures3D[NonUniformResourceIndex(textureid)].Sample(\n"
-          "    kSamplers[NonUniformResourceIndex(samplerid)], uvw);\n"
-          "}\n");
-  addCode("textureBindless3DLod(",
-          "float4 textureBindless3DLod(uint textureid, uint samplerid, float3 uvw, float lod) {\n"
-          "  return kTextures3D[NonUniformResourceIndex(textureid)].SampleLevel(\n"
-          "    kSamplers[NonUniformResourceIndex(samplerid)], uvw, lod);\n"
-          "}\n");
+  const lvk::VulkanBuffer* buf = buffersPool_.get(readback->buffer_);
 
-  sourcePatched += source;
-  source = sourcePatched.c_str();
+  if (!readback->isInvalidated_ && !buf->isCoherentMemory_) {
+    buf->invalidateMappedMemory(*this, 0, readback->size_);
+  }
+  readback->isInvalidated_ = true;
 
-  std::vector<uint8_t> spirv;
-  lvk::Result::setResult(outResult, lvk::compileShaderSlang(stage, source, entryPointName, &spirv));
+  if (outSize) {
+    *outSize = readback->size_;
+  }
 
-  return createShaderModuleFromSPIRV(spirv.data(), spirv.size(), debugName, outResult);
+  return buf->getMappedPtr();
 }
 
-lvk::Format lvk::VulkanContext::getSwapchainFormat() const {
-  if (!hasSwapchain()) {
-    return Format_Invalid;
-  }
+lvk::Result lvk::VulkanContext::upload(lvk::TextureHandle handle,
+                                       const TextureRangeDesc& range,
+                                       const void* data,
+                                       uint32_t bufferRowLength) {
+  LVK_PROFILER_FUNCTION();
 
-  return vkFormatToFormat(swapchain_->getSurfaceFormat().format);
-}
+  Result result;
 
-lvk::ColorSpace lvk::VulkanContext::getSwapchainColorSpace() const {
-  if (!hasSwapchain()) {
-    return ColorSpace_SRGB_NONLINEAR;
-  }
+  uploadTexture(*stagingDevice_, handle, range, data, bufferRowLength, &result);
 
-  return vkColorSpaceToColorSpace(swapchain_->getSurfaceFormat().colorSpace);
+  return result;
 }
 
-uint32_t lvk::VulkanContext::getNumSwapchainImages() const {
-  return hasSwapchain() ? swapchain_->getNumSwapchainImages() : 0;
-}
+lvk::SubmitHandle lvk::VulkanContext::uploadAsync(lvk::TextureHandle handle,
+                                                  const TextureRangeDesc& range,
+                                                  const void* data,
+                                                  uint32_t bufferRowLength,
+                                                  Result* outResult) {
+  LVK_PROFILER_FUNCTION();
 
-lvk::TextureHandle lvk::VulkanContext::getCurrentSwapchainTexture() {
-  LVK_PROFILER_FUNCTION();
+  const lvk::VulkanImage* tex = texturesPool_.get(handle);
 
-  if (!hasSwapchain()) {
+  // exclusive images belong to the graphics queue family
+  const bool isAsync = tex && (tex->isShared_ || deviceQueues_.transferQueueFamilyIndex == deviceQueues_.graphicsQueueFamilyIndex) &&
+                       isTransferGranularityCompatible(*tex, range);
+
+  return uploadTexture(isAsync ? *stagingDeviceAsync_ : *stagingDevice_, handle, range, data, bufferRowLength, outResult, false);
+}
+
+bool lvk::VulkanContext::isTransferGranularityCompatible(const VulkanImage& image, const TextureRangeDesc& range) const {
+  const VkExtent3D& g = transferImageGranularity_;
+
+  if (g.width == 1 && g.height == 1 && g.depth == 1) {
+    return true;
+  }
+
+  // whole mip-levels can be copied with any granularity
+  const uint32_t level = range.mipLevel;
+
+  return !range.offset.x && !range.offset.y && !range.offset.z && range.dimensions.width == std::max(image.vkExtent_.width >> level, 1u) &&
+         range.dimensions.height == std::max(image.vkExtent_.height >> level, 1u) &&
+         range.dimensions.depth == std::max(image.vkExtent_.depth >> level, 1u);
+}
+
+lvk::SubmitHandle lvk::VulkanContext::uploadTexture(lvk::VulkanStagingDevice& staging,
+                                                    lvk::TextureHandle handle,
+                                                    const TextureRangeDesc& range,
+                                                    const void* data,
+                                                    uint32_t bufferRowLength,
+                                                    Result* outResult,
+                                                    bool canStall) {
+  if (!LVK_VERIFY(data)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange);
     return {};
   }
 
-  TextureHandle tex = swapchain_->getCurrentTexture();
+  lvk::VulkanImage* texture = texturesPool_.get(handle);
 
-  if (!LVK_VERIFY(tex.valid())) {
-    LVK_ASSERT_MSG(false, "Swapchain has no valid texture");
+  if (!LVK_VERIFY(texture)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange);
     return {};
   }
 
-  LVK_ASSERT_MSG(texturesPool_.get(tex)->vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid image format");
+  const Result result = validateRange(texture->vkExtent_, texture->numLevels_, range);
 
-  return tex;
-}
+  if (!LVK_VERIFY(result.isOk())) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange);
+    return {};
+  }
 
-uint32_t lvk::VulkanContext::getSwapchainCurrentImageIndex() const {
-  if (hasSwapchain()) {
-    // make sure we do not use a stale image
-    (void)swapchain_->getCurrentTexture();
+  VkFormat vkFormat = texture->vkImageFormat_;
+
+  bool isPending = false;
+  SubmitHandle submitHandle;
+
+  if (texture->vkType_ == VK_IMAGE_TYPE_3D) {
+    submitHandle = staging.imageData3D(*texture,
+                                       VkOffset3D{range.offset.x, range.offset.y, range.offset.z},
+                                       VkExtent3D{range.dimensions.width, range.dimensions.height, range.dimensions.depth},
+                                       vkFormat,
+                                       data,
+                                       canStall ? nullptr : &isPending);
+  } else {
+    const VkRect2D imageRegion = {
+        .offset = {.x = range.offset.x, .y = range.offset.y},
+        .extent = {.width = range.dimensions.width, .height = range.dimensions.height},
+    };
+    submitHandle = staging.imageData2D(*texture,
+                                       imageRegion,
+                                       range.mipLevel,
+                                       range.numMipLevels,
+                                       range.layer,
+                                       range.numLayers,
+                                       vkFormat,
+                                       data,
+                                       bufferRowLength,
+                                       canStall ? nullptr : &isPending);
   }
 
-  return hasSwapchain() ? swapchain_->getSwapchainCurrentImageIndex() : 0;
-}
+  Result::setResult(outResult, isPending ? Result(Result::Code::Pending, "Staging memory is full") : Result());
 
-void lvk::VulkanContext::recreateSwapchain(int newWidth, int newHeight) {
-  initSwapchain(newWidth, newHeight);
+  return submitHandle;
 }
 
-bool lvk::VulkanContext::setCurrentPresentMode(PresentMode mode) {
-  if (!hasSwapchain() || !has_KHR_swapchain_maintenance1_) {
-    return false;
+lvk::Dimensions lvk::VulkanContext::getDimensions(TextureHandle handle) const {
+  if (!handle) {
+    return {};
   }
 
-  return swapchain_->setCurrentPresentMode(presentModeToVkPresentMode(mode));
-}
+  const lvk::VulkanImage* tex = texturesPool_.get(handle);
 
-[[nodiscard]] lvk::PresentMode lvk::VulkanContext::getCurrentPresentMode() const {
-  return swapchain_ ? vkPresentModeToPresentMode(swapchain_->currentPresentMode_) : PresentMode_FIFO;
-}
+  LVK_ASSERT(tex);
 
-uint32_t lvk::VulkanContext::getFramebufferMSAABitMask() const {
-  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
-  return limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts;
+  if (!tex) {
+    return {};
+  }
+
+  return {
+      .width = tex->vkExtent_.width,
+      .height = tex->vkExtent_.height,
+      .depth = tex->vkExtent_.depth,
+  };
 }
 
-double lvk::VulkanContext::getTimestampPeriodToMs() const {
-  return double(getVkPhysicalDeviceProperties().limits.timestampPeriod) * 1e-6;
+float lvk::VulkanContext::getAspectRatio(TextureHandle handle) const {
+  if (!handle) {
+    return 1.0f;
+  }
+
+  const lvk::VulkanImage* tex = texturesPool_.get(handle);
+
+  LVK_ASSERT(tex);
+
+  if (!tex) {
+    return 1.0f;
+  }
+
+  return static_cast<float>(tex->vkExtent_.width) / static_cast<float>(tex->vkExtent_.height);
 }
 
-bool lvk::VulkanContext::getQueryPoolResults(QueryPoolHandle pool,
-                                             uint32_t firstQuery,
-                                             uint32_t queryCount,
-                                             size_t dataSize,
-                                             void* outData,
-                                             size_t stride) const {
-  VkQueryPool vkPool = *queriesPool_.get(pool);
+void lvk::VulkanContext::generateMipmap(TextureHandle handle) {
+  if (handle.empty()) {
+    return;
+  }
 
-  VK_ASSERT(vkGetQueryPoolResults(
-      vkDevice_, vkPool, firstQuery, queryCount, dataSize, outData, stride, VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT));
+  lvk::VulkanImage* tex = texturesPool_.get(handle);
 
-  return true;
+  if (tex->numLevels_ <= 1) {
+    return;
+  }
+
+  LVK_ASSERT(tex->vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
+  const lvk::VulkanImmediateCommands::CommandBufferWrapper& wrapper = immediate_->acquire();
+  generateMipmaps(wrapper.cmdBuf_, &tex, 1);
+  immediate_->submit(wrapper);
 }
 
-lvk::AccelStructSizes lvk::VulkanContext::getAccelStructSizes(const AccelStructDesc& desc, Result* outResult) const {
-  LVK_PROFILER_FUNCTION();
+VkPipeline lvk::VulkanContext::getOrCreateMipmapPipeline() {
+  std::lock_guard lock(pimpl_->mipmapPipelineMutex_);
 
-  if (!LVK_VERIFY(has_KHR_acceleration_structure_)) {
-    Result::setResult(outResult, Result(Result::Code::RuntimeError, "VK_KHR_acceleration_structure is not enabled"));
-    return {};
+  if (pipelineMipmap_ != VK_NULL_HANDLE) {
+    return pipelineMipmap_;
   }
 
-  Result result;
-  VkAccelerationStructureGeometryKHR accelerationStructureGeometry{};
-  VkAccelerationStructureBuildSizesInfoKHR accelerationStructureBuildSizesInfo{};
-  switch (desc.type) {
-  case AccelStructType_BLAS:
-    getBuildInfoBLAS(desc, accelerationStructureGeometry, accelerationStructureBuildSizesInfo);
-    break;
-  case AccelStructType_TLAS:
-    getBuildInfoTLAS(desc, accelerationStructureGeometry, accelerationStructureBuildSizesInfo);
-    break;
-  default:
-    LVK_ASSERT_MSG(false, "Invalid acceleration structure type");
-    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Invalid acceleration structure type"));
-    return {};
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  std::vector<uint8_t> spirv;
+  const Result result = compileShader(Stage_Comp, kMipmapComputeShader, "main", false, &spirv);
+
+  if (!LVK_VERIFY(result.isOk())) {
+    LLOGW("Cannot compile the mipmap generation shader: %s", result.message);
+    return VK_NULL_HANDLE;
   }
 
-  Result::setResult(outResult, Result::Code::Ok);
+  const lvk::ShaderModuleState sm = createShaderModuleFromSPIRV(spirv.data(), spirv.size(), "Shader Module: mipmap", nullptr);
+  SCOPE_EXIT {
+    free((void*)sm.ci.pCode);
+  };
 
-  return lvk::AccelStructSizes{
-      .accelerationStructureSize = accelerationStructureBuildSizesInfo.accelerationStructureSize,
-      .updateScratchSize = accelerationStructureBuildSizesInfo.updateScratchSize,
-      .buildScratchSize = accelerationStructureBuildSizesInfo.buildScratchSize,
+  // the descriptors are pushed per dispatch: the source level and up to 4 destination levels
+  const VkDescriptorSetLayoutBinding bindings[] = {
+      lvk::getDSLBinding(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+      lvk::getDSLBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMipmapLevelsPerDispatch, VK_SHADER_STAGE_COMPUTE_BIT),
+  };
+  const VkDescriptorSetLayoutCreateInfo dslci = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT |
+               (has_EXT_descriptor_buffer_ ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u),
+      .bindingCount = (uint32_t)LVK_ARRAY_NUM_ELEMENTS(bindings),
+      .pBindings = bindings,
+  };
+  VK_ASSERT(vkCreateDescriptorSetLayout(vkDevice_, &dslci, nullptr, &dslMipmap_));
+  VK_ASSERT(lvk::setDebugObjectName(
+      vkDevice_, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)dslMipmap_, "Descriptor Set Layout: VulkanContext::dslMipmap_"));
+
+  const VkPushConstantRange range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = (uint32_t)getAlignedSize(sizeof(MipmapPushConstants), 16),
   };
+  const VkPipelineLayoutCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &dslMipmap_,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &range,
+  };
+  VK_ASSERT(vkCreatePipelineLayout(vkDevice_, &ci, nullptr, &pipelineLayoutMipmap_));
+  VK_ASSERT(lvk::setDebugObjectName(
+      vkDevice_, VK_OBJECT_TYPE_PIPELINE_LAYOUT, (uint64_t)pipelineLayoutMipmap_, "Pipeline Layout: VulkanContext::pipelineLayoutMipmap_"));
+
+  pipelineMipmap_ = compileComputePipeline({.entryPoint = "main", .debugName = "Pipeline: mipmap"}, sm, pipelineLayoutMipmap_);
+
+  return pipelineMipmap_;
 }
 
-lvk::Result lvk::VulkanContext::createInstance() {
-  vkInstance_ = VK_NULL_HANDLE;
+void lvk::VulkanContext::generateMipmaps(VkCommandBuffer cmdBuf, lvk::VulkanImage* const* images, uint32_t numImages) {
+  LVK_PROFILER_FUNCTION();
 
-  // check if we have validation layers in the system
-  {
-    uint32_t numLayerProperties = 0;
-    vkEnumerateInstanceLayerProperties(&numLayerProperties, nullptr);
-    std::vector<VkLayerProperties> layerProperties(numLayerProperties);
-    vkEnumerateInstanceLayerProperties(&numLayerProperties, layerProperties.data());
+  std::vector<lvk::VulkanImage*> computeImages;
+  std::vector<VkImageLayout> originalLayouts;
+  computeImages.reserve(numImages);
+  originalLayouts.reserve(numImages);
 
-    [this, &layerProperties]() -> void {
-      for (const VkLayerProperties& props : layerProperties) {
-        for (const char* layer : kDefaultValidationLayers) {
-          if (!strcmp(props.layerName, layer)) {
-            khronosValidationVersion_ = props.specVersion;
-            return;
-          }
-        }
-      }
-      config_.enableValidation = false; // no validation layers available
-    }();
+  for (uint32_t i = 0; i != numImages; i++) {
+    lvk::VulkanImage* img = images[i];
+    if (!img || img->numLevels_ <= 1) {
+      continue;
+    }
+    LVK_ASSERT(img->vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
+    if (isMipmapComputeSupported(*img) && getOrCreateMipmapPipeline() != VK_NULL_HANDLE) {
+      computeImages.push_back(img);
+      originalLayouts.push_back(img->vkImageLayout_);
+    } else {
+      img->generateMipmap(cmdBuf);
+    }
   }
 
-  std::vector<VkExtensionProperties> allInstanceExtensions;
-  {
-    uint32_t count = 0;
-    VK_ASSERT(vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr));
-    allInstanceExtensions.resize(count);
-    VK_ASSERT(vkEnumerateInstanceExtensionProperties(nullptr, &count, allInstanceExtensions.data()));
+  if (computeImages.empty()) {
+    return;
   }
-  // collect instance extensions from all validation layers
-  if (config_.enableValidation) {
-    for (const char* layer : kDefaultValidationLayers) {
-      uint32_t count = 0;
-      VK_ASSERT(vkEnumerateInstanceExtensionProperties(layer, &count, nullptr));
-      if (count > 0) {
-        const size_t sz = allInstanceExtensions.size();
-        allInstanceExtensions.resize(sz + count);
-        VK_ASSERT(vkEnumerateInstanceExtensionProperties(layer, &count, allInstanceExtensions.data() + sz));
-      }
-    }
+
+  if (vkCmdBeginDebugUtilsLabelEXT) {
+    const VkDebugUtilsLabelEXT utilsLabel = {
+        .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+        .pLabelName = "Generate mipmaps (compute)",
+        .color = {1.0f, 0.75f, 1.0f, 1.0f},
+    };
+    vkCmdBeginDebugUtilsLabelEXT(cmdBuf, &utilsLabel);
   }
 
-  enabledInstanceExtensionNames_ = {
-      VK_KHR_SURFACE_EXTENSION_NAME,
-#if defined(_WIN32)
-      VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
-#elif defined(VK_USE_PLATFORM_ANDROID_KHR)
-      VK_KHR_ANDROID_SURFACE_EXTENSION_NAME,
-#elif defined(__linux__)
-#if defined(VK_USE_PLATFORM_WAYLAND_KHR)
-      VK_KHR_WAYLAND_SURFACE_EXTENSION_NAME,
-#else
-      VK_KHR_XLIB_SURFACE_EXTENSION_NAME,
-#endif // VK_USE_PLATFORM_WAYLAND_KHR
-#endif
+  std::vector<VkImageMemoryBarrier2> barriers;
+  barriers.reserve(computeImages.size());
+
+  // transition all levels and layers of all images with one barrier
+  auto transitionAll = [&barriers, cmdBuf, &computeImages](const std::vector<VkImageLayout>& newLayouts) {
+    barriers.clear();
+    for (size_t i = 0; i != computeImages.size(); i++) {
+      const lvk::VulkanImage* img = computeImages[i];
+      VkImageMemoryBarrier2 barrier = {};
+      if (img->transitionLayout(
+              newLayouts[i], VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, img->numLevels_, 0, img->numLayers_}, barrier)) {
+        barriers.push_back(barrier);
+      }
+    }
+    if (!barriers.empty()) {
+      const VkDependencyInfo dependencyInfo = {
+          .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+          .imageMemoryBarrierCount = (uint32_t)barriers.size(),
+          .pImageMemoryBarriers = barriers.data(),
+      };
+      vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo);
+    }
   };
 
-  const bool hasPortabilityEnumeration = hasExtension(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME, allInstanceExtensions);
+  // 1: Transition all images into VK_IMAGE_LAYOUT_GENERAL
+  transitionAll(std::vector<VkImageLayout>(computeImages.size(), VK_IMAGE_LAYOUT_GENERAL));
 
-#if defined(__APPLE__)
-  if (hasExtension(VK_EXT_LAYER_SETTINGS_EXTENSION_NAME, allInstanceExtensions)) {
-    enabledInstanceExtensionNames_.push_back(VK_EXT_LAYER_SETTINGS_EXTENSION_NAME);
-  }
-  if (hasExtension(VK_MVK_MACOS_SURFACE_EXTENSION_NAME, allInstanceExtensions)) {
-    has_MVK_macos_surface_ = true;
-    enabledInstanceExtensionNames_.push_back(VK_MVK_MACOS_SURFACE_EXTENSION_NAME);
+  vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineMipmap_);
+  if (has_EXT_descriptor_buffer_ && !descriptorBufferProperties_.bufferlessPushDescriptors) {
+    // push descriptors are stored in the bound descriptor buffer
+    bindDescriptorBuffer(cmdBuf);
   }
-  if (hasExtension(VK_EXT_METAL_SURFACE_EXTENSION_NAME, allInstanceExtensions)) {
-    enabledInstanceExtensionNames_.push_back(VK_EXT_METAL_SURFACE_EXTENSION_NAME);
+
+  uint32_t maxNumLevels = 0;
+  for (const lvk::VulkanImage* img : computeImages) {
+    maxNumLevels = std::max(maxNumLevels, img->numLevels_);
   }
-  if (hasPortabilityEnumeration) {
-    enabledInstanceExtensionNames_.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+
+  // 2: Every pass generates the next 4 levels of all images; passes depend on each other, images within one pass do not
+  for (uint32_t baseLevel = 0; baseLevel + 1 < maxNumLevels; baseLevel += kMipmapLevelsPerDispatch) {
+    if (baseLevel) {
+      const VkMemoryBarrier2 barrier = {
+          .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+          .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+          .srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+          .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+      };
+      const VkDependencyInfo dependencyInfo = {
+          .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+          .memoryBarrierCount = 1,
+          .pMemoryBarriers = &barrier,
+      };
+      vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo);
+    }
+    for (lvk::VulkanImage* img : computeImages) {
+      if (baseLevel + 1 >= img->numLevels_) {
+        continue;
+      }
+      const uint32_t numLevels = std::min(kMipmapLevelsPerDispatch, img->numLevels_ - baseLevel - 1);
+      const MipmapPushConstants pc = {
+          .srcSize = {(int32_t)std::max(img->vkExtent_.width >> baseLevel, 1u), (int32_t)std::max(img->vkExtent_.height >> baseLevel, 1u)},
+          .numLevels = numLevels,
+      };
+      const uint32_t dstWidth = std::max(pc.srcSize[0] >> 1, 1);
+      const uint32_t dstHeight = std::max(pc.srcSize[1] >> 1, 1);
+      vkCmdPushConstants(cmdBuf, pipelineLayoutMipmap_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+      for (uint32_t layer = 0; layer != img->numLayers_; layer++) {
+        VkDescriptorImageInfo infos[1 + kMipmapLevelsPerDispatch] = {};
+        for (uint32_t i = 0; i != LVK_ARRAY_NUM_ELEMENTS(infos); i++) {
+          // unused destination slots repeat the last level; they are never written by the shader
+          const uint32_t level = baseLevel + std::min(i, numLevels);
+          infos[i] = {
+              .imageView = img->getOrCreateVkImageViewForFramebuffer(*this, (uint8_t)level, (uint16_t)layer, 0),
+              .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+          };
+        }
+        const VkWriteDescriptorSet writes[] = {
+            {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstBinding = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .pImageInfo = &infos[0],
+            },
+            {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstBinding = 1,
+                .descriptorCount = kMipmapLevelsPerDispatch,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                .pImageInfo = &infos[1],
+            },
+        };
+        vkCmdPushDescriptorSetKHR(
+            cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayoutMipmap_, 0, (uint32_t)LVK_ARRAY_NUM_ELEMENTS(writes), writes);
+        vkCmdDispatch(cmdBuf, (dstWidth + 7) / 8, (dstHeight + 7) / 8, 1);
+      }
+    }
   }
-#endif // __APPLE__
 
-  // check if we have the VK_EXT_debug_utils extension
-  const bool hasDebugUtils = hasExtension(VK_EXT_DEBUG_UTILS_EXTENSION_NAME, allInstanceExtensions);
+  // 3: Transition all images back to their original layouts
+  transitionAll(originalLayouts);
 
-  if (hasDebugUtils) {
-    enabledInstanceExtensionNames_.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+  if (vkCmdEndDebugUtilsLabelEXT) {
+    vkCmdEndDebugUtilsLabelEXT(cmdBuf);
   }
+}
 
-  if (config_.enableValidation) {
-    enabledInstanceExtensionNames_.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME); // enabled only for validation
+lvk::Format lvk::VulkanContext::getFormat(TextureHandle handle) const {
+  if (handle.empty()) {
+    return Format_Invalid;
   }
 
-  if (config_.enableHeadlessSurface) {
-    enabledInstanceExtensionNames_.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
-  }
+  return vkFormatToFormat(texturesPool_.get(handle)->vkImageFormat_);
+}
 
-  if (hasExtension(VK_KHR_SURFACE_MAINTENANCE_1_EXTENSION_NAME, allInstanceExtensions)) {
-    enabledInstanceExtensionNames_.push_back(VK_KHR_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
-  }
-  // Lavapipe 25.3.3 supports both `VK_KHR_surface_maintenance` and `VK_EXT_surface_maintenance`,
-  // but only supports `VK_EXT_swapchain_maintenance1`, which in turn requires `VK_EXT_surface_maintenance1`
-  if (hasExtension(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME, allInstanceExtensions)) {
-    // remove once VK_KHR_surface_maintenance1 becomes mandatory
-    enabledInstanceExtensionNames_.push_back(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
-  }
+bool lvk::VulkanContext::isTextureFormatSupported(Format format) const {
+  const VkFormat vkFormat = formatToVkFormat(format);
 
-  if (hasExtension(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME, allInstanceExtensions)) {
-    has_EXT_swapchain_colorspace_ = true;
-    enabledInstanceExtensionNames_.push_back(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME);
+  if (vkFormat == VK_FORMAT_UNDEFINED) {
+    return false;
   }
 
-  if (hasExtension(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME, allInstanceExtensions)) {
-    // required by the instance extension VK_EXT_surface_maintenance1
-    enabledInstanceExtensionNames_.push_back(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
+  VkFormatProperties2 props = {
+      .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2,
+  };
+  vkGetPhysicalDeviceFormatProperties2(vkPhysicalDevice_, vkFormat, &props);
+
+  return (props.formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+lvk::Holder<lvk::ShaderModuleHandle> lvk::VulkanContext::createShaderModule(const ShaderModuleDesc& desc, Result* outResult) {
+  Result result;
+  ShaderModuleState sm = createShaderModuleState(desc, &result);
+
+  if (!result.isOk()) {
+    Result::setResult(outResult, result);
+    return {};
   }
+  const ShaderModuleHandle handle = shaderModulesPool_.create(std::move(sm));
 
-  for (const char* ext : config_.extensionsInstance) {
-    if (ext) {
-      enabledInstanceExtensionNames_.push_back(ext);
-    }
+  if (handle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create ShaderModule: the pool is full");
+    return {};
   }
 
-#if !defined(ANDROID)
-  // GPU Assisted Validation doesn't work on Android.
-  // It implicitly requires vertexPipelineStoresAndAtomics feature that's not supported even on high-end devices.
-  const VkValidationFeatureEnableEXT validationFeaturesEnabled[] = {
-      VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_EXT,
-      VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_RESERVE_BINDING_SLOT_EXT,
-  };
-#endif // ANDROID
+  Result::setResult(outResult, result);
 
-#if defined(__APPLE__)
-  // Shader validation doesn't work in MoltenVK for SPIR-V 1.6 under Vulkan 1.3:
-  // "Invalid SPIR-V binary version 1.6 for target environment SPIR-V 1.5 (under Vulkan 1.2 semantics)."
-  const VkValidationFeatureDisableEXT validationFeaturesDisabled[] = {
-      VK_VALIDATION_FEATURE_DISABLE_SHADERS_EXT,
-      VK_VALIDATION_FEATURE_DISABLE_SHADER_VALIDATION_CACHE_EXT,
-  };
-#endif // __APPLE__
+  return {this, handle};
+}
 
-  const VkValidationFeaturesEXT features = {
-      .sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT,
-      .pNext = nullptr,
-#if !defined(ANDROID)
-      .enabledValidationFeatureCount = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(validationFeaturesEnabled) : 0u,
-      .pEnabledValidationFeatures = config_.enableValidation ? validationFeaturesEnabled : nullptr,
-#endif
-#if defined(__APPLE__)
-      .disabledValidationFeatureCount = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(validationFeaturesDisabled) : 0u,
-      .pDisabledValidationFeatures = config_.enableValidation ? validationFeaturesDisabled : nullptr,
-#endif
-  };
+void lvk::VulkanContext::createShaderModules(const ShaderModuleDesc* desc,
+                                             Holder<ShaderModuleHandle>* outHandles,
+                                             uint32_t numShaderModules,
+                                             Result* outResult) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
 
-#if defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
-  // https://github.com/KhronosGroup/MoltenVK/blob/main/Docs/MoltenVK_Configuration_Parameters.md
-  const int useMetalArgumentBuffers = 1;
-  const VkBool32 gpuav_descriptor_checks = VK_FALSE; // https://github.com/KhronosGroup/Vulkan-ValidationLayers/issues/8688
-  const VkBool32 gpuav_indirect_draws_buffers = VK_FALSE; // https://github.com/KhronosGroup/Vulkan-ValidationLayers/issues/8579
-  const VkBool32 gpuav_post_process_descriptor_indexing = VK_FALSE; // https://github.com/KhronosGroup/Vulkan-ValidationLayers/issues/9222
-#define LAYER_SETTINGS_BOOL32(name, var)                                                                                        \
-  VkLayerSettingEXT {                                                                                                           \
-    .pLayerName = kDefaultValidationLayers[0], .pSettingName = name, .type = VK_LAYER_SETTING_TYPE_BOOL32_EXT, .valueCount = 1, \
-    .pValues = var,                                                                                                             \
+  if (!LVK_VERIFY(desc && outHandles)) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Expecting non-null `desc` and `outHandles`");
+    return;
   }
-  const VkLayerSettingEXT settings[] = {
-      LAYER_SETTINGS_BOOL32("gpuav_descriptor_checks", &gpuav_descriptor_checks),
-      LAYER_SETTINGS_BOOL32("gpuav_indirect_draws_buffers", &gpuav_indirect_draws_buffers),
-      LAYER_SETTINGS_BOOL32("gpuav_post_process_descriptor_indexing", &gpuav_post_process_descriptor_indexing),
-      {"MoltenVK", "MVK_CONFIG_USE_METAL_ARGUMENT_BUFFERS", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &useMetalArgumentBuffers},
-  };
-#undef LAYER_SETTINGS_BOOL32
-  const VkLayerSettingsCreateInfoEXT layerSettingsCreateInfo = {
-      .sType = VK_STRUCTURE_TYPE_LAYER_SETTINGS_CREATE_INFO_EXT,
-      .pNext = config_.enableValidation ? &features : nullptr,
-      .settingCount = (uint32_t)LVK_ARRAY_NUM_ELEMENTS(settings),
-      .pSettings = settings,
+
+  std::vector<ShaderModuleState> states(numShaderModules);
+  std::vector<Result> results(numShaderModules);
+
+  // compile on the pipeline compiler threads and on this thread; the pool is not touched until all the tasks are finished
+  std::atomic<uint32_t> nextModule = 0;
+  auto compile = [&]() {
+    for (uint32_t i = nextModule++; i < numShaderModules; i = nextModule++) {
+      states[i] = createShaderModuleState(desc[i], &results[i]);
+    }
   };
-#endif // defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
+  const uint32_t numTasks = numShaderModules ? std::min(numShaderModules - 1, config_.numPipelineCompilerThreads) : 0;
+  std::vector<std::shared_future<VkPipeline>> tasks;
+  tasks.reserve(numTasks);
+  for (uint32_t i = 0; i != numTasks; i++) {
+    tasks.push_back(compilePipelineAsync(std::packaged_task<VkPipeline()>([&compile]() -> VkPipeline {
+      compile();
+      return VK_NULL_HANDLE;
+    })));
+  }
+  // a busy pool does not stall this thread: the tasks which start late find nothing left to compile
+  compile();
+  for (const std::shared_future<VkPipeline>& t : tasks) {
+    t.wait();
+  }
 
-  // check extensions
-  {
-    std::string missingExtensions;
-    for (const char* ext : enabledInstanceExtensionNames_) {
-      if (!hasExtension(ext, allInstanceExtensions))
-        missingExtensions += "\n   " + std::string(ext);
+  Result::setResult(outResult, Result());
+
+  for (uint32_t i = 0; i != numShaderModules; i++) {
+    if (!results[i].isOk()) {
+      // report the first error
+      if (outResult && outResult->isOk()) {
+        *outResult = results[i];
+      }
+      free((void*)states[i].ci.pCode);
+      outHandles[i] = {};
+      continue;
     }
-    if (!missingExtensions.empty()) {
-      MINILOG_LOG_PROC(minilog::FatalError, "Missing Vulkan instance extensions: %s\n", missingExtensions.c_str());
-      assert(false);
-      return Result(Result::Code::RuntimeError);
+    outHandles[i] = {this, shaderModulesPool_.create(std::move(states[i]))};
+    if (outHandles[i].empty() && outResult && outResult->isOk()) {
+      *outResult = Result(Result::Code::RuntimeError, "Cannot create ShaderModule: the pool is full");
     }
   }
+}
 
-  const VkApplicationInfo appInfo = {
-      .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
-      .pNext = nullptr,
-      .pApplicationName = "LVK/Vulkan",
-      .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
-      .pEngineName = "LVK/Vulkan",
-      .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-#if defined(VK_API_VERSION_1_4)
-      .apiVersion = config_.vulkanVersion == VulkanVersion_1_3 ? VK_API_VERSION_1_3 : VK_API_VERSION_1_4,
-#else
-      .apiVersion = VK_API_VERSION_1_3,
-#endif // VK_API_VERSION_1_4
-  };
-
-  const VkInstanceCreateInfo ci = {
-      .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
-#if defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
-      .pNext = &layerSettingsCreateInfo,
-#else
-      .pNext = config_.enableValidation ? &features : nullptr,
-#endif // defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
-      .flags = hasPortabilityEnumeration ? VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR : 0u,
-      .pApplicationInfo = &appInfo,
-      .enabledLayerCount = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(kDefaultValidationLayers) : 0u,
-      .ppEnabledLayerNames = config_.enableValidation ? kDefaultValidationLayers : nullptr,
-      .enabledExtensionCount = (uint32_t)enabledInstanceExtensionNames_.size(),
-      .ppEnabledExtensionNames = enabledInstanceExtensionNames_.data(),
+lvk::ShaderModuleState lvk::VulkanContext::createShaderModuleState(const ShaderModuleDesc& desc, Result* outResult) const {
+  auto isSlang = [](const char* code) {
+    if (!code)
+      return false;
+    return strstr(code, "[shader(\"") != nullptr;
   };
-  VK_ASSERT(vkCreateInstance(&ci, nullptr, &vkInstance_));
+  return desc.dataSize ? createShaderModuleFromSPIRV(desc.data, desc.dataSize, desc.debugName, outResult) // binary
+         : isSlang(desc.data) // text
+             ? createShaderModuleFromSlang(desc.stage, desc.data, desc.entryPointName, desc.debugName, outResult)
+             : createShaderModuleFromGLSL(desc.stage, desc.data, desc.debugName, outResult);
+}
 
-  volkLoadInstance(vkInstance_);
+lvk::ShaderModuleState lvk::VulkanContext::createShaderModuleFromSPIRV(const void* spirv,
+                                                                       size_t numBytes,
+                                                                       const char* debugName,
+                                                                       Result* outResult) const {
+  (void)debugName;
 
-  // debug messenger
-  if (hasDebugUtils) {
-    const VkDebugUtilsMessengerCreateInfoEXT ci = {
-        .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT,
-        .messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT |
-                           VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
-        .messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
-                       VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
-        .pfnUserCallback = &vulkanDebugCallback,
-        .pUserData = this,
-    };
-    VK_ASSERT(vkCreateDebugUtilsMessengerEXT(vkInstance_, &ci, nullptr, &vkDebugUtilsMessenger_));
+  if (!spirv || !numBytes) {
+    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Expecting non-empty SPIR-V code"));
+    return {};
   }
 
-  LLOGL("%s layer version: %u.%u.%u\n",
-        kDefaultValidationLayers[0],
-        VK_VERSION_MAJOR(khronosValidationVersion_),
-        VK_VERSION_MINOR(khronosValidationVersion_),
-        VK_VERSION_PATCH(khronosValidationVersion_));
+  SpvReflectShaderModule mdl;
+  SpvReflectResult result = spvReflectCreateShaderModule(numBytes, spirv, &mdl);
+  LVK_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  SCOPE_EXIT {
+    spvReflectDestroyShaderModule(&mdl);
+  };
 
-  // log available instance extensions
-  LLOGL("\nVulkan instance extensions:\n");
+  uint32_t pushConstantsSize = 0;
 
-  for (const VkExtensionProperties& extension : allInstanceExtensions) {
-    LLOGL("  %s\n", extension.extensionName);
+  for (uint32_t i = 0; i < mdl.push_constant_block_count; ++i) {
+    const SpvReflectBlockVariable& block = mdl.push_constant_blocks[i];
+    pushConstantsSize = std::max(pushConstantsSize, block.offset + block.size);
   }
 
-  return Result();
-}
-
-void lvk::VulkanContext::createHeadlessSurface() {
-  const VkHeadlessSurfaceCreateInfoEXT ci = {
-      .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
-      .pNext = nullptr,
-      .flags = 0,
+  const VkShaderModuleCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+      .codeSize = numBytes,
+      .pCode = (const uint32_t*)malloc(numBytes),
   };
-  VK_ASSERT(vkCreateHeadlessSurfaceEXT(vkInstance_, &ci, nullptr, &vkSurface_));
-}
 
-void lvk::VulkanContext::createSurface(void* window, void* display) {
-#if defined(VK_USE_PLATFORM_WIN32_KHR)
-  const VkWin32SurfaceCreateInfoKHR ci = {
-      .sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR,
-      .hinstance = GetModuleHandle(nullptr),
-      .hwnd = (HWND)window,
-  };
-  VK_ASSERT(vkCreateWin32SurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
-#elif defined(VK_USE_PLATFORM_ANDROID_KHR)
-  const VkAndroidSurfaceCreateInfoKHR ci = {
-      .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
-      .pNext = nullptr,
-      .flags = 0,
-      .window = (ANativeWindow*)window,
-  };
-  VK_ASSERT(vkCreateAndroidSurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
-#elif defined(VK_USE_PLATFORM_XLIB_KHR)
-  const VkXlibSurfaceCreateInfoKHR ci = {
-      .sType = VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR,
-      .flags = 0,
-      .dpy = (Display*)display,
-      .window = (Window)window,
-  };
-  VK_ASSERT(vkCreateXlibSurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
-#elif defined(VK_USE_PLATFORM_WAYLAND_KHR)
-  const VkWaylandSurfaceCreateInfoKHR ci = {
-      .sType = VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR,
-      .flags = 0,
-      .display = (wl_display*)display,
-      .surface = (wl_surface*)window,
+  memcpy((void*)ci.pCode, spirv, numBytes);
+
+  return {
+      .ci = ci,
+      .pushConstantsSize = pushConstantsSize,
   };
-  VK_ASSERT(vkCreateWaylandSurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
-#elif defined(VK_USE_PLATFORM_MACOS_MVK) || defined(VK_USE_PLATFORM_METAL_EXT)
-  if (has_MVK_macos_surface_) {
-    const VkMacOSSurfaceCreateInfoMVK ci = {
-        .sType = VK_STRUCTURE_TYPE_MACOS_SURFACE_CREATE_INFO_MVK,
-        .flags = 0,
-        .pView = window,
-    };
-    VK_ASSERT(vkCreateMacOSSurfaceMVK(vkInstance_, &ci, nullptr, &vkSurface_));
-  } else {
-    const VkMetalSurfaceCreateInfoEXT ci = {
-        .sType = VK_STRUCTURE_TYPE_METAL_SURFACE_CREATE_INFO_EXT,
-        .flags = 0,
-        .pLayer = display, // layer
-    };
-    VK_ASSERT(vkCreateMetalSurfaceEXT(vkInstance_, &ci, nullptr, &vkSurface_));
-  }
-#else
-#error Implement for other platforms
-#endif
 }
 
-uint32_t lvk::VulkanContext::queryDevices(HWDeviceDesc* outDevices, uint32_t maxOutDevices) {
-  // Physical devices
-  uint32_t deviceCount = 0;
-  VK_ASSERT(vkEnumeratePhysicalDevices(vkInstance_, &deviceCount, nullptr));
-  std::vector<VkPhysicalDevice> vkDevices(deviceCount);
-  VK_ASSERT(vkEnumeratePhysicalDevices(vkInstance_, &deviceCount, vkDevices.data()));
+lvk::ShaderModuleState lvk::VulkanContext::createShaderModuleFromGLSL(ShaderStage stage,
+                                                                      const char* source,
+                                                                      const char* debugName,
+                                                                      Result* outResult) const {
+  const VkShaderStageFlagBits vkStage = shaderStageToVkShaderStage(stage);
+  LVK_ASSERT(vkStage != VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM);
+  LVK_ASSERT(source);
 
-  auto convertVulkanDeviceTypeToLVK = [](VkPhysicalDeviceType vkDeviceType) -> HWDeviceType {
-    switch (vkDeviceType) {
-    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
-      return HWDeviceType_Integrated;
-    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
-      return HWDeviceType_Discrete;
-    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
-      return HWDeviceType_External;
-    case VK_PHYSICAL_DEVICE_TYPE_CPU:
-      return HWDeviceType_Software;
-    default:
-      return HWDeviceType_Software;
+  std::string sourcePatched;
+
+  if (!source || !*source) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Shader source is empty");
+    return {};
+  }
+
+  auto addCode = [source, &sourcePatched](const char* substr, const char* code) -> void {
+    if (strstr(source, substr)) {
+      sourcePatched.append(code);
     }
   };
 
-  uint32_t numCompatibleDevices = 0;
+  if (strstr(source, "#version ") == nullptr) {
+    if (vkStage == VK_SHADER_STAGE_TASK_BIT_EXT || vkStage == VK_SHADER_STAGE_MESH_BIT_EXT) {
+      sourcePatched +=
+          "#version 460\n"
+          "#extension GL_EXT_buffer_reference : require\n"
+          "#extension GL_EXT_buffer_reference_uvec2 : require\n"
+          "#extension GL_EXT_debug_printf : enable\n"
+          "#extension GL_EXT_nonuniform_qualifier : require\n"
+          "#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require\n"
+          "#extension GL_EXT_mesh_shader : require\n";
+    }
+    if (vkStage == VK_SHADER_STAGE_VERTEX_BIT || vkStage == VK_SHADER_STAGE_COMPUTE_BIT ||
+        vkStage == VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT || vkStage == VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT) {
+      sourcePatched +=
+          "#version 460\n"
+          "#extension GL_EXT_buffer_reference : require\n"
+          "#extension GL_EXT_buffer_reference_uvec2 : require\n"
+          "#extension GL_EXT_debug_printf : enable\n"
+          "#extension GL_EXT_nonuniform_qualifier : require\n"
+          "#extension GL_EXT_samplerless_texture_functions : require\n"
+          "#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require\n";
+    }
+    if (vkStage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+      // Note how nonuniformEXT() should be used:
+      // https://github.com/KhronosGroup/Vulkan-Samples/blob/main/shaders/descriptor_indexing/nonuniform-quads.frag#L33-L39
+      sourcePatched +=
+          "#version 460\n"
+          "#extension GL_EXT_buffer_reference_uvec2 : require\n"
+          "#extension GL_EXT_debug_printf : enable\n"
+          "#extension GL_EXT_nonuniform_qualifier : require\n"
+          "#extension GL_EXT_samplerless_texture_functions : require\n"
+          "#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require\n";
+      addCode("kTLAS[",
+              "#extension GL_EXT_buffer_reference : require\n"
+              "#extension GL_EXT_ray_query : require\n"
+              "layout(set = 0, binding = 4) uniform accelerationStructureEXT kTLAS[];\n");
+      addCode("textureBindless2DSparse(",
+              "#extension GL_ARB_sparse_texture2 : require\n"
+              "#extension GL_EXT_buffer_reference : require\n");
+      sourcePatched +=
+          "layout (set = 0, binding = 0) uniform texture2D   kTextures2D[];\n"
+          "layout (set = 1, binding = 0) uniform texture3D   kTextures3D[];\n"
+          "layout (set = 2, binding = 0) uniform textureCube kTexturesCube[];\n"
+          "layout (set = 3, binding = 0) uniform texture2D   kTextures2DShadow[];\n"
+          "layout (set = 0, binding = 1) uniform sampler       kSamplers[];\n"
+          "layout (set = 3, binding = 1) uniform samplerShadow kSamplersShadow[];\n"
+          "layout (set = 0, binding = 3) uniform sampler2D     kSamplersYUV[];\n";
+      addCode("textureBindless2D(",
+              "vec4 textureBindless2D(uint textureid, uint samplerid, vec2 uv) {\n"
+              "  return texture(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])), uv);\n"
+              "}\n");
+      addCode("textureBindless2DLod(",
+              "vec4 textureBindless2DLod(uint textureid, uint samplerid, vec2 uv, float lod) {\n"
+              "  return textureLod(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])), uv, lod);\n"
+              "}\n");
+      addCode("textureBindless2DShadow(",
+              "float textureBindless2DShadow(uint textureid, uint samplerid, vec3 uvw) {"
+              "  return texture(nonuniformEXT(sampler2DShadow(kTextures2DShadow[textureid], kSamplersShadow[samplerid])), uvw);\n"
+              "}\n");
+      addCode("textureBindlessSize2D(",
+              "ivec2 textureBindlessSize2D(uint textureid) {\n"
+              "  return textureSize(nonuniformEXT(kTextures2D[textureid]), 0);\n"
+              "}\n");
+      addCode("textureBindlessCube(",
+              "vec4 textureBindlessCube(uint textureid, uint samplerid, vec3 uvw) {\n"
+              "  return texture(nonuniformEXT(samplerCube(kTexturesCube[textureid], kSamplers[samplerid])), uvw);\n"
+              "}\n");
+      addCode("textureBindlessCubeLod(",
+              "vec4 textureBindlessCubeLod(uint textureid, uint samplerid, vec3 uvw, float lod) {\n"
+              "  return textureLod(nonuniformEXT(samplerCube(kTexturesCube[textureid], kSamplers[samplerid])), uvw, lod);\n"
+              "}\n");
+      addCode("textureBindless3D(",
+              "vec4 textureBindless3D(uint textureid, uint samplerid, vec3 uvw) {\n"
+              "  return texture(nonuniformEXT(sampler3D(kTextures3D[textureid], kSamplers[samplerid])), uvw);\n"
+              "}\n");
+      addCode("textureBindless3DLod(",
+              "vec4 textureBindless3DLod(uint textureid, uint samplerid, vec3 uvw, float lod) {\n"
+              "  return textureLod(nonuniformEXT(sampler3D(kTextures3D[textureid], kSamplers[samplerid])), uvw, lod);\n"
+              "}\n");
+      addCode("textureBindlessQueryLevels2D(",
+              "int textureBindlessQueryLevels2D(uint textureid) {\n"
+              "  return textureQueryLevels(nonuniformEXT(kTextures2D[textureid]));\n"
+              "}\n");
+      addCode("textureBindlessQueryLevelsCube(",
+              "int textureBindlessQueryLevelsCube(uint textureid) {\n"
+              "  return textureQueryLevels(nonuniformEXT(kTexturesCube[textureid]));\n"
+              "}\n");
+      // see lvk::SparseTextureInfo
+      addCode("textureBindless2DSparse(",
+              "layout(std430, buffer_reference) buffer SparseFeedback {\n"
+              "  uint pageWidth;\n"
+              "  uint pageHeight;\n"
+              "  uint firstMipTailLevel;\n"
+              "  uint numPages;\n"
+              "  uvec2 levels[16]; // x - first page, y - pages per row\n"
+              "  uint requested[];\n"
+              "};\n"
+              "vec4 textureBindless2DSparse(uint textureid, uint samplerid, vec2 uv, uvec2 feedback) {\n"
+              "  SparseFeedback fb = SparseFeedback(feedback);\n"
+              "  uint level = uint(textureQueryLod(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])), uv).x);\n"
+              "  if (level < fb.firstMipTailLevel) {\n"
+              "    uvec2 size = uvec2(textureSize(nonuniformEXT(kTextures2D[textureid]), int(level)));\n"
+              "    uvec2 page = min(uvec2(fract(uv) * vec2(size)), size - 1) / uvec2(fb.pageWidth, fb.pageHeight);\n"
+              "    uint index = fb.levels[level].x + page.y * fb.levels[level].y + page.x;\n"
+              "    uint bit = 1u << (index & 31u);\n"
+              "    if ((fb.requested[index >> 5] & bit) == 0) atomicOr(fb.requested[index >> 5], bit);\n"
+              "  }\n"
+              "  vec4 color;\n"
+              "  int code = sparseTextureARB(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])), uv, color);\n"
+              "  for (uint l = level + 1; !sparseTexelsResidentARB(code) && l < fb.firstMipTailLevel; l++) {\n"
+              "    code = sparseTextureLodARB(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])),\n"
+              "                               uv, float(l), color);\n"
+              "  }\n"
+              "  if (!sparseTexelsResidentARB(code)) {\n"
+              "    color = textureLod(nonuniformEXT(sampler2D(kTextures2D[textureid], kSamplers[samplerid])),\n"
+              "                       uv, float(fb.firstMipTailLevel));\n"
+              "  }\n"
+              "  return color;\n"
+              "}\n");
+    }
+    sourcePatched += source;
+    source = sourcePatched.c_str();
+  }
 
-  for (uint32_t i = 0; i < deviceCount; ++i) {
-    VkPhysicalDevice physicalDevice = vkDevices[i];
-    VkPhysicalDeviceProperties deviceProperties;
-    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+  std::vector<uint8_t> spirv;
+  lvk::Result::setResult(outResult, compileShader(stage, source, nullptr, false, &spirv));
 
-    const HWDeviceType deviceType = convertVulkanDeviceTypeToLVK(deviceProperties.deviceType);
+  return createShaderModuleFromSPIRV(spirv.data(), spirv.size(), debugName, outResult);
+}
 
-    if (outDevices && numCompatibleDevices < maxOutDevices) {
-      outDevices[numCompatibleDevices] = {.guid = (uintptr_t)vkDevices[i], .type = deviceType};
-      strncpy(outDevices[numCompatibleDevices].name, deviceProperties.deviceName, strlen(deviceProperties.deviceName));
-      numCompatibleDevices++;
-    }
+lvk::ShaderModuleState lvk::VulkanContext::createShaderModuleFromSlang(ShaderStage stage,
+                                                                       const char* source,
+                                                                       const char* entryPointName,
+                                                                       const char* debugName,
+                                                                       Result* outResult) const {
+  std::string sourcePatched;
+
+  if (!source || !*source) {
+    Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Shader source is empty");
+    return {};
   }
 
-  return numCompatibleDevices;
-}
+  auto addCode = [source, &sourcePatched](const char* substr, const char* code) -> void {
+    if (strstr(source, substr)) {
+      sourcePatched.append(code);
+    }
+  };
 
-void lvk::VulkanContext::addNextPhysicalDeviceProperties(void* properties) {
-  if (!properties)
-    return;
+  // overloaded operators to mimic GLSL matrix operations
+  sourcePatched +=
+      "float2x2 operator*(float2x2 a, float2x2 b) { return mul(b, a); }\n"
+      "float2   operator*(float2x2 a, float2   b) { return mul(b, a); }\n"
+      "float3x3 operator*(float3x3 a, float3x3 b) { return mul(b, a); }\n"
+      "float3   operator*(float3x3 a, float3   b) { return mul(b, a); }\n"
+      "float4x4 operator*(float4x4 a, float4x4 b) { return mul(b, a); }\n"
+      "float4   operator*(float4x4 a, float4   b) { return mul(b, a); }\n";
+  // bindless texture and sampler arrays
+  sourcePatched +=
+      "[[vk::binding(0, 0)]] Texture2D    kTextures2D[];\n"
+      "[[vk::binding(0, 1)]] Texture3D    kTextures3D[];\n"
+      "[[vk::binding(0, 2)]] TextureCube  kTexturesCube[];\n"
+      "[[vk::binding(0, 3)]] Texture2D    kTextures2DShadow[];\n"
+      "[[vk::binding(1, 0)]] SamplerState kSamplers[];\n"
+      "[[vk::binding(1, 3)]] SamplerComparisonState kSamplersShadow[];\n"
+      "[[vk::binding(3, 0)]] Sampler2D    kSamplersYUV[];\n";
+  // cannot handle unbounded arrays https://github.com/shader-slang/slang/issues/8902
+  addCode("kTLAS[", "[[vk::binding(4, 0)]] RaytracingAccelerationStructure kTLAS[];\n");
+  addCode("textureBindless2D(",
+          "float4 textureBindless2D(uint textureid, uint samplerid, float2 uv) {\n"
+          "  return kTextures2D[NonUniformResourceIndex(textureid)].Sample(\n"
+          "    kSamplers[NonUniformResourceIndex(samplerid)], uv);\n"
+          "}\n");
+  addCode("textureBindless2DLod(",
+          "float4 textureBindless2DLod(uint textureid, uint samplerid, float2 uv, float lod) {\n"
+          "  return kTextures2D[NonUniformResourceIndex(textureid)].SampleLevel(\n"
+          "    kSamplers[NonUniformResourceIndex(samplerid)], uv, lod);\n"
+          "}\n");
+  addCode("textureBindlessCube(",
+          "float4 textureBindlessCube(uint textureid, uint samplerid, float3 dir) {\n"
+          "  return kTexturesCube[NonUniformResourceIndex(textureid)].Sample(\n"
+          "    kSamplers[NonUniformResourceIndex(samplerid)], dir);\n"
+          "}\n");
+  addCode("textureBindlessSize2D(",
+          "int2 textureBindlessSize2D(uint textureid) {\n"
+          "  uint width, height;\n"
+          "  kTextures2D[NonUniformResourceIndex(textureid)].GetDimensions(width, height);\n"
+          "  return int2(width, height);\n"
+          "}\n");
+  addCode("textureBindless2DShadow(",
+          "float textureBindless2DShadow(uint textureid, uint samplerid, float3 uvw) {\n"
+          "  return kTextures2DShadow[NonUniformResourceIndex(textureid)].SampleCmpLevelZero(\n"
+          "    kSamplersShadow[NonUniformResourceIndex(samplerid)], uvw.xy, uvw.z);\n"
+          "}\n");
+  addCode("textureBindless3D(",
+          "float4 textureBindless3D(uint textureid, uint samplerid, float3 uvw) {\n"
+          "  return kTextures3D[NonUniformResourceIndex(textureid)].Sample(\n"
+          "    kSamplers[NonUniformResourceIndex(samplerid)], uvw);\n"
+          "}\n");
+  addCode("textureBindless3DLod(",
+          "float4 textureBindless3DLod(uint textureid, uint samplerid, float3 uvw, float lod) {\n"
+          "  return kTextures3D[NonUniformResourceIndex(textureid)].SampleLevel(\n"
+          "    kSamplers[NonUniformResourceIndex(samplerid)], uvw, lod);\n"
+          "}\n");
 
-  std::launder(reinterpret_cast<VkBaseOutStructure*>(properties))->pNext =
-      std::launder(reinterpret_cast<VkBaseOutStructure*>(vkPhysicalDeviceProperties2_.pNext));
+  sourcePatched += source;
+  source = sourcePatched.c_str();
 
-  vkPhysicalDeviceProperties2_.pNext = properties;
+  std::vector<uint8_t> spirv;
+  lvk::Result::setResult(outResult, compileShader(stage, source, entryPointName, true, &spirv));
+
+  return createShaderModuleFromSPIRV(spirv.data(), spirv.size(), debugName, outResult);
 }
 
-void lvk::VulkanContext::getBuildInfoBLAS(const AccelStructDesc& desc,
-                                          VkAccelerationStructureGeometryKHR& outGeometry,
-                                          VkAccelerationStructureBuildSizesInfoKHR& outSizesInfo) const {
-  LVK_ASSERT(desc.type == AccelStructType_BLAS);
-  LVK_ASSERT(desc.geometryType == AccelStructGeomType_Triangles);
-  LVK_ASSERT(desc.numVertices);
-  LVK_ASSERT(desc.indexBuffer.valid());
-  LVK_ASSERT(desc.vertexBuffer.valid());
-  LVK_ASSERT(desc.transformBuffer.valid());
-  LVK_ASSERT(desc.buildRange.primitiveCount);
+lvk::Result lvk::VulkanContext::compileShader(ShaderStage stage,
+                                              const char* source,
+                                              const char* entryPointName,
+                                              bool isSlang,
+                                              std::vector<uint8_t>* outSPIRV) const {
+  const glslang_resource_t glslangResource = lvk::getGlslangResource(getVkPhysicalDeviceProperties().limits);
 
-  LVK_ASSERT(buffersPool_.get(desc.indexBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
-  LVK_ASSERT(buffersPool_.get(desc.vertexBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
-  LVK_ASSERT(buffersPool_.get(desc.transformBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
+  auto compile = [&]() -> Result {
+    const auto start = std::chrono::steady_clock::now();
+    const Result result = isSlang ? lvk::compileShaderSlang(stage, source, entryPointName, outSPIRV)
+                                  : lvk::compileShaderGlslang(stage, source, outSPIRV, &glslangResource);
+    pimpl_->numShaderCompilations_++;
+    const auto duration = std::chrono::steady_clock::now() - start;
+    pimpl_->shaderCompilationTimeNs_ += std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return result;
+  };
 
-  VkGeometryFlagsKHR geometryFlags = 0;
+  if (!config_.enableShaderCache) {
+    return compile();
+  }
 
-  if (desc.geometryFlags & AccelStructGeometryFlagBits_Opaque) {
-    geometryFlags |= VK_GEOMETRY_OPAQUE_BIT_KHR;
+  // everything which can change the generated SPIR-V goes into the key; strings are zero-terminated to keep adjacent ones apart
+  static const std::string compilerVersion = lvk::getShaderCompilerVersion();
+  std::string key;
+  key.append((const char*)&stage, sizeof(stage));
+  key.append((const char*)&isSlang, sizeof(isSlang));
+  key.append(compilerVersion).push_back('\0');
+  key.append(entryPointName ? entryPointName : "").push_back('\0');
+  if (!isSlang) {
+    // the limits are bools - append them separately to skip the struct padding
+    key.append((const char*)&glslangResource, offsetof(glslang_resource_t, limits));
+    key.append((const char*)&glslangResource.limits, sizeof(glslangResource.limits));
   }
-  if (desc.geometryFlags & AccelStructGeometryFlagBits_NoDuplicateAnyHit) {
-    geometryFlags |= VK_GEOMETRY_NO_DUPLICATE_ANY_HIT_INVOCATION_BIT_KHR;
+  key.append(source);
+
+  {
+    std::lock_guard lock(pimpl_->shaderCacheMutex_);
+    if (auto it = pimpl_->shaderCache_.find(key); it != pimpl_->shaderCache_.end()) {
+      *outSPIRV = it->second;
+      pimpl_->numShaderCacheHits_++;
+      return Result();
+    }
   }
 
-  outGeometry = VkAccelerationStructureGeometryKHR{
-      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
-      .geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR,
-      .geometry =
-          {
-              .triangles =
-                  {
-                      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR,
-                      .vertexFormat = vertexFormatToVkFormat(desc.vertexFormat),
-                      .vertexData = {.deviceAddress = gpuAddress(desc.vertexBuffer)},
-                      .vertexStride = desc.vertexStride ? desc.vertexStride : lvk::getVertexFormatSize(desc.vertexFormat),
-                      .maxVertex = desc.numVertices - 1,
-                      .indexType = VK_INDEX_TYPE_UINT32,
-                      .indexData = {.deviceAddress = gpuAddress(desc.indexBuffer)},
-                      .transformData = {.deviceAddress = gpuAddress(desc.transformBuffer)},
-                  },
-          },
-      .flags = geometryFlags,
-  };
+  if (config_.shaderCacheDirectory && loadShaderCacheFile(config_.shaderCacheDirectory, key, *outSPIRV)) {
+    std::lock_guard lock(pimpl_->shaderCacheMutex_);
+    pimpl_->shaderCache_[key] = *outSPIRV;
+    pimpl_->numShaderCacheHits_++;
+    return Result();
+  }
 
-  const VkAccelerationStructureBuildGeometryInfoKHR accelerationBuildGeometryInfo{
-      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
-      .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
-      .flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR,
-      .geometryCount = 1,
-      .pGeometries = &outGeometry,
-  };
+  const Result result = compile();
 
-  outSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-  vkGetAccelerationStructureBuildSizesKHR(vkDevice_,
-                                          VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-                                          &accelerationBuildGeometryInfo,
-                                          &desc.buildRange.primitiveCount,
-                                          &outSizesInfo);
-  const uint32_t alignment = accelerationStructureProperties_.minAccelerationStructureScratchOffsetAlignment;
-  outSizesInfo.accelerationStructureSize += alignment;
-  outSizesInfo.updateScratchSize += alignment;
-  outSizesInfo.buildScratchSize += alignment;
+  if (!result.isOk()) {
+    return result;
+  }
+
+  if (config_.shaderCacheDirectory) {
+    saveShaderCacheFile(config_.shaderCacheDirectory, key, *outSPIRV);
+  }
+
+  std::lock_guard lock(pimpl_->shaderCacheMutex_);
+  pimpl_->shaderCache_[key] = *outSPIRV;
+
+  return result;
 }
 
-void lvk::VulkanContext::getBuildInfoTLAS(const AccelStructDesc& desc,
-                                          VkAccelerationStructureGeometryKHR& outGeometry,
-                                          VkAccelerationStructureBuildSizesInfoKHR& outSizesInfo) const {
-  LVK_ASSERT(desc.type == AccelStructType_TLAS);
-  LVK_ASSERT(desc.geometryType == AccelStructGeomType_Instances);
-  LVK_ASSERT(desc.numVertices == 0);
-  LVK_ASSERT(desc.instancesBuffer.valid());
-  LVK_ASSERT(desc.buildRange.primitiveCount);
-  LVK_ASSERT(buffersPool_.get(desc.instancesBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
+lvk::Format lvk::VulkanContext::getSwapchainFormat() const {
+  if (!hasSwapchain()) {
+    return Format_Invalid;
+  }
 
-  VkGeometryFlagsKHR geometryFlags = 0;
+  return vkFormatToFormat(swapchain_->getSurfaceFormat().format);
+}
 
-  if (desc.geometryFlags & AccelStructGeometryFlagBits_Opaque) {
-    geometryFlags |= VK_GEOMETRY_OPAQUE_BIT_KHR;
+lvk::ColorSpace lvk::VulkanContext::getSwapchainColorSpace() const {
+  if (!hasSwapchain()) {
+    return ColorSpace_SRGB_NONLINEAR;
   }
-  if (desc.geometryFlags & AccelStructGeometryFlagBits_NoDuplicateAnyHit) {
-    geometryFlags |= VK_GEOMETRY_NO_DUPLICATE_ANY_HIT_INVOCATION_BIT_KHR;
+
+  return vkColorSpaceToColorSpace(swapchain_->getSurfaceFormat().colorSpace);
+}
+
+uint32_t lvk::VulkanContext::getNumSwapchainImages() const {
+  return hasSwapchain() ? swapchain_->getNumSwapchainImages() : 0;
+}
+
+lvk::TextureHandle lvk::VulkanContext::getCurrentSwapchainTexture() {
+  LVK_PROFILER_FUNCTION();
+
+  if (!hasSwapchain()) {
+    return {};
   }
 
-  outGeometry = VkAccelerationStructureGeometryKHR{
-      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
-      .geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR,
-      .geometry =
-          {
-              .instances =
-                  {
-                      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR,
-                      .arrayOfPointers = VK_FALSE,
-                      .data = {.deviceAddress = gpuAddress(desc.instancesBuffer)},
-                  },
-          },
-      .flags = geometryFlags,
-  };
+  TextureHandle tex = swapchain_->getCurrentTexture();
 
-  const VkAccelerationStructureBuildGeometryInfoKHR accelerationStructureBuildGeometryInfo = {
-      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
-      .type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
-      .flags = buildFlagsToVkBuildAccelerationStructureFlags(desc.buildFlags),
-      .geometryCount = 1,
-      .pGeometries = &outGeometry,
-  };
+  if (!LVK_VERIFY(tex.valid())) {
+    LVK_ASSERT_MSG(false, "Swapchain has no valid texture");
+    return {};
+  }
 
-  outSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR,
-  vkGetAccelerationStructureBuildSizesKHR(vkDevice_,
-                                          VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-                                          &accelerationStructureBuildGeometryInfo,
-                                          &desc.buildRange.primitiveCount,
-                                          &outSizesInfo);
-  const uint32_t alignment = accelerationStructureProperties_.minAccelerationStructureScratchOffsetAlignment;
-  outSizesInfo.accelerationStructureSize += alignment;
-  outSizesInfo.updateScratchSize += alignment;
-  outSizesInfo.buildScratchSize += alignment;
+  LVK_ASSERT_MSG(texturesPool_.get(tex)->vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid image format");
+
+  return tex;
 }
 
-lvk::Result lvk::VulkanContext::initContext(const HWDeviceDesc& desc) {
-  if (desc.guid == 0UL) {
-    LLOGW("Invalid hardwareGuid(%lu)", desc.guid);
-    return Result(Result::Code::RuntimeError, "Vulkan is not supported");
+uint32_t lvk::VulkanContext::getSwapchainCurrentImageIndex() const {
+  if (hasSwapchain()) {
+    // make sure we do not use a stale image
+    (void)swapchain_->getCurrentTexture();
   }
 
-  vkPhysicalDevice_ = (VkPhysicalDevice)desc.guid;
+  return hasSwapchain() ? swapchain_->getSwapchainCurrentImageIndex() : 0;
+}
 
-  useStaging_ = !isHostVisibleSingleHeapMemory(vkPhysicalDevice_);
+void lvk::VulkanContext::recreateSwapchain(int newWidth, int newHeight) {
+  initSwapchain(newWidth, newHeight);
+}
 
-  std::vector<VkExtensionProperties> allDeviceExtensions;
-  getDeviceExtensionProps(vkPhysicalDevice_, allDeviceExtensions);
-  if (config_.enableValidation) {
-    for (const char* layer : kDefaultValidationLayers) {
-      getDeviceExtensionProps(vkPhysicalDevice_, allDeviceExtensions, layer);
-    }
+bool lvk::VulkanContext::setCurrentPresentMode(PresentMode mode) {
+  if (!hasSwapchain() || !has_KHR_swapchain_maintenance1_) {
+    return false;
   }
 
-  if (hasExtension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME, allDeviceExtensions)) {
-    addNextPhysicalDeviceProperties(&accelerationStructureProperties_);
-  }
-  if (hasExtension(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME, allDeviceExtensions)) {
-    addNextPhysicalDeviceProperties(&rayTracingPipelineProperties_);
+  return swapchain_->setCurrentPresentMode(presentModeToVkPresentMode(mode));
+}
+
+[[nodiscard]] lvk::PresentMode lvk::VulkanContext::getCurrentPresentMode() const {
+  return swapchain_ ? vkPresentModeToPresentMode(swapchain_->currentPresentMode_) : PresentMode_FIFO;
+}
+
+void lvk::VulkanContext::waitForNextFrame() {
+  if (hasSwapchain()) {
+    swapchain_->waitForNextFrame();
   }
+}
 
-#if defined(VK_API_VERSION_1_4)
-  if (config_.vulkanVersion >= VulkanVersion_1_4) {
-    addNextPhysicalDeviceProperties(&vkPhysicalDeviceVulkan14Properties_);
-    vkFeatures13_.pNext = &vkFeatures14_;
+void lvk::VulkanContext::setMaxFramesInFlight(uint32_t maxFramesInFlight) {
+  config_.maxFramesInFlight = maxFramesInFlight;
+}
+
+bool lvk::VulkanContext::getPresentTimings(PresentTimings& outTimings) const {
+  if (!swapchain_ || !swapchain_->hasPresentTimings_) {
+    return false;
   }
-#else
-  LVK_ASSERT_MSG(config_.vulkanVersion == VulkanVersion_1_3, "Only Vulkan 1.3 is supported on this platform");
-#endif // VK_API_VERSION_1_4
 
-  vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &vkFeatures10_);
-  vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &vkPhysicalDeviceProperties2_);
+  outTimings = swapchain_->presentTimings_;
 
-  const uint32_t apiVersion = vkPhysicalDeviceProperties2_.properties.apiVersion;
+  return true;
+}
 
-  LLOGL("Vulkan physical device: %s\n", vkPhysicalDeviceProperties2_.properties.deviceName);
-  LLOGL("           API version: %i.%i.%i.%i\n",
-        VK_API_VERSION_MAJOR(apiVersion),
-        VK_API_VERSION_MINOR(apiVersion),
-        VK_API_VERSION_PATCH(apiVersion),
-        VK_API_VERSION_VARIANT(apiVersion));
-  LLOGL("           Driver info: %s %s\n", vkPhysicalDeviceDriverProperties_.driverName, vkPhysicalDeviceDriverProperties_.driverInfo);
+uint32_t lvk::VulkanContext::getFramebufferMSAABitMask() const {
+  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
+  return limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts;
+}
 
-  LLOGL("Vulkan physical device extensions:\n");
+double lvk::VulkanContext::getTimestampPeriodToMs() const {
+  return double(getVkPhysicalDeviceProperties().limits.timestampPeriod) * 1e-6;
+}
 
-  // log available physical device extensions
-  for (const VkExtensionProperties& ext : allDeviceExtensions) {
-    LLOGL("  %s\n", ext.extensionName);
-  }
+bool lvk::VulkanContext::getQueryPoolResults(QueryPoolHandle pool,
+                                             uint32_t firstQuery,
+                                             uint32_t queryCount,
+                                             size_t dataSize,
+                                             void* outData,
+                                             size_t stride) const {
+  VkQueryPool vkPool = *queriesPool_.get(pool);
 
-  deviceQueues_.graphicsQueueFamilyIndex = lvk::findQueueFamilyIndex(vkPhysicalDevice_, VK_QUEUE_GRAPHICS_BIT);
-  deviceQueues_.computeQueueFamilyIndex = lvk::findQueueFamilyIndex(vkPhysicalDevice_, VK_QUEUE_COMPUTE_BIT);
+  VK_ASSERT(vkGetQueryPoolResults(
+      vkDevice_, vkPool, firstQuery, queryCount, dataSize, outData, stride, VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT));
 
-  if (deviceQueues_.graphicsQueueFamilyIndex == DeviceQueues::INVALID) {
-    LLOGW("VK_QUEUE_GRAPHICS_BIT is not supported");
-    return Result(Result::Code::RuntimeError, "VK_QUEUE_GRAPHICS_BIT is not supported");
-  }
+  return true;
+}
 
-  if (deviceQueues_.computeQueueFamilyIndex == DeviceQueues::INVALID) {
-    LLOGW("VK_QUEUE_COMPUTE_BIT is not supported");
-    return Result(Result::Code::RuntimeError, "VK_QUEUE_COMPUTE_BIT is not supported");
+lvk::AccelStructSizes lvk::VulkanContext::getAccelStructSizes(const AccelStructDesc& desc, Result* outResult) const {
+  LVK_PROFILER_FUNCTION();
+
+  if (!LVK_VERIFY(has_KHR_acceleration_structure_)) {
+    Result::setResult(outResult, Result(Result::Code::RuntimeError, "VK_KHR_acceleration_structure is not enabled"));
+    return {};
   }
 
-  const float queuePriority = 1.0f;
+  Result result;
+  VkAccelerationStructureGeometryKHR accelerationStructureGeometry{};
+  VkAccelerationStructureBuildSizesInfoKHR accelerationStructureBuildSizesInfo{};
+  switch (desc.type) {
+  case AccelStructType_BLAS:
+    getBuildInfoBLAS(desc, accelerationStructureGeometry, accelerationStructureBuildSizesInfo);
+    break;
+  case AccelStructType_TLAS:
+    getBuildInfoTLAS(desc, accelerationStructureGeometry, accelerationStructureBuildSizesInfo);
+    break;
+  default:
+    LVK_ASSERT_MSG(false, "Invalid acceleration structure type");
+    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Invalid acceleration structure type"));
+    return {};
+  }
 
-  const VkDeviceQueueCreateInfo ciQueue[2] = {
-      {
-          .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-          .queueFamilyIndex = deviceQueues_.graphicsQueueFamilyIndex,
-          .queueCount = 1,
-          .pQueuePriorities = &queuePriority,
-      },
-      {
-          .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-          .queueFamilyIndex = deviceQueues_.computeQueueFamilyIndex,
-          .queueCount = 1,
-          .pQueuePriorities = &queuePriority,
-      },
-  };
-  const uint32_t numQueues = ciQueue[0].queueFamilyIndex == ciQueue[1].queueFamilyIndex ? 1 : 2;
+  Result::setResult(outResult, Result::Code::Ok);
 
-  enabledDeviceExtensionNames_ = {
-      VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+  return lvk::AccelStructSizes{
+      .accelerationStructureSize = accelerationStructureBuildSizesInfo.accelerationStructureSize,
+      .updateScratchSize = accelerationStructureBuildSizesInfo.updateScratchSize,
+      .buildScratchSize = accelerationStructureBuildSizesInfo.buildScratchSize,
   };
+}
 
-  if (hasExtension("VK_KHR_portability_subset", allDeviceExtensions)) {
-    enabledDeviceExtensionNames_.push_back("VK_KHR_portability_subset");
-  }
+lvk::Result lvk::VulkanContext::createInstance() {
+  vkInstance_ = VK_NULL_HANDLE;
 
-  for (const char* ext : config_.extensionsDevice) {
-    if (ext) {
-      enabledDeviceExtensionNames_.push_back(ext);
-    }
-  }
+  // check if we have validation layers in the system
+  {
+    uint32_t numLayerProperties = 0;
+    vkEnumerateInstanceLayerProperties(&numLayerProperties, nullptr);
+    std::vector<VkLayerProperties> layerProperties(numLayerProperties);
+    vkEnumerateInstanceLayerProperties(&numLayerProperties, layerProperties.data());
 
-  VkPhysicalDeviceFeatures deviceFeatures10 = {
-      .independentBlend = vkFeatures10_.features.independentBlend, // enable if supported
-      .geometryShader = vkFeatures10_.features.geometryShader, // enable if supported
-      .tessellationShader = vkFeatures10_.features.tessellationShader, // enable if supported
-      .sampleRateShading = vkFeatures10_.features.sampleRateShading, // enable if supported
-      .multiDrawIndirect = VK_TRUE,
-      .drawIndirectFirstInstance = VK_TRUE,
-      .depthBiasClamp = vkFeatures10_.features.depthBiasClamp, // enable if supported,
-      .fillModeNonSolid = vkFeatures10_.features.fillModeNonSolid, // enable if supported
-      .samplerAnisotropy = VK_TRUE,
-      .textureCompressionBC = vkFeatures10_.features.textureCompressionBC, // enable if supported
-      .vertexPipelineStoresAndAtomics = vkFeatures10_.features.vertexPipelineStoresAndAtomics, // enable if supported
-      .fragmentStoresAndAtomics = VK_TRUE,
-      .shaderImageGatherExtended = VK_TRUE,
-      .shaderInt64 = vkFeatures10_.features.shaderInt64, // enable if supported
-      .shaderInt16 = vkFeatures10_.features.shaderInt16, // enable if supported
-  };
-  VkPhysicalDeviceVulkan11Features deviceFeatures11 = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
-      .pNext = config_.extensionsDeviceFeatures,
-      .storageBuffer16BitAccess = VK_TRUE,
-      .multiview = vkFeatures11_.multiview, // enable if supported
-      .samplerYcbcrConversion = vkFeatures11_.samplerYcbcrConversion, // enable if supported
-      .shaderDrawParameters = VK_TRUE,
-  };
-  VkPhysicalDeviceVulkan12Features deviceFeatures12 = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
-      .pNext = &deviceFeatures11,
-      .samplerMirrorClampToEdge = VK_TRUE,
-      .drawIndirectCount = vkFeatures12_.drawIndirectCount, // enable if supported
-      .storageBuffer8BitAccess = vkFeatures12_.storageBuffer8BitAccess, // enable if supported
-      .uniformAndStorageBuffer8BitAccess = vkFeatures12_.uniformAndStorageBuffer8BitAccess, // enable if supported
-      .shaderFloat16 = vkFeatures12_.shaderFloat16, // enable if supported
-      .shaderInt8 = vkFeatures12_.shaderInt8, // enable if supported
-      .descriptorIndexing = VK_TRUE,
-      .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
-      .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
-      .descriptorBindingStorageImageUpdateAfterBind = VK_TRUE,
-      .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
-      .descriptorBindingPartiallyBound = VK_TRUE,
-      .descriptorBindingVariableDescriptorCount = VK_TRUE,
-      .runtimeDescriptorArray = VK_TRUE,
-      .scalarBlockLayout = VK_TRUE,
-      .uniformBufferStandardLayout = VK_TRUE,
-      .hostQueryReset = vkFeatures12_.hostQueryReset, // enable if supported
-      .timelineSemaphore = VK_TRUE,
-      .bufferDeviceAddress = VK_TRUE,
-      .vulkanMemoryModel = vkFeatures12_.vulkanMemoryModel, // enable if supported
-      .vulkanMemoryModelDeviceScope = vkFeatures12_.vulkanMemoryModelDeviceScope, // enable if supported
-  };
-  VkPhysicalDeviceVulkan13Features deviceFeatures13 = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
-      .pNext = &deviceFeatures12,
-      .shaderDemoteToHelperInvocation = vkFeatures13_.shaderDemoteToHelperInvocation, // enable if supported
-      .subgroupSizeControl = VK_TRUE,
-      .synchronization2 = VK_TRUE,
-      .dynamicRendering = VK_TRUE,
-      .maintenance4 = VK_TRUE,
-  };
-#if defined(VK_API_VERSION_1_4)
-  VkPhysicalDeviceVulkan14Features deviceFeatures14 = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_4_FEATURES,
-      .pNext = &deviceFeatures13,
-      .indexTypeUint8 = vkFeatures14_.indexTypeUint8,
-      .dynamicRenderingLocalRead = VK_TRUE,
-      .maintenance5 = VK_TRUE,
-  };
-#endif // VK_API_VERSION_1_4
+    [this, &layerProperties]() -> void {
+      for (const VkLayerProperties& props : layerProperties) {
+        for (const char* layer : kDefaultValidationLayers) {
+          if (!strcmp(props.layerName, layer)) {
+            khronosValidationVersion_ = props.specVersion;
+            return;
+          }
+        }
+      }
+      config_.enableValidation = false; // no validation layers available
+    }();
+  }
 
-#if defined(VK_API_VERSION_1_4)
-  void* createInfoNext = config_.vulkanVersion >= VulkanVersion_1_4 ? (void*)&deviceFeatures14 : (void*)&deviceFeatures13;
+  std::vector<VkExtensionProperties> allInstanceExtensions;
+  {
+    uint32_t count = 0;
+    VK_ASSERT(vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr));
+    allInstanceExtensions.resize(count);
+    VK_ASSERT(vkEnumerateInstanceExtensionProperties(nullptr, &count, allInstanceExtensions.data()));
+  }
+  // collect instance extensions from all validation layers
+  if (config_.enableValidation) {
+    for (const char* layer : kDefaultValidationLayers) {
+      uint32_t count = 0;
+      VK_ASSERT(vkEnumerateInstanceExtensionProperties(layer, &count, nullptr));
+      if (count > 0) {
+        const size_t sz = allInstanceExtensions.size();
+        allInstanceExtensions.resize(sz + count);
+        VK_ASSERT(vkEnumerateInstanceExtensionProperties(layer, &count, allInstanceExtensions.data() + sz));
+      }
+    }
+  }
+
+  enabledInstanceExtensionNames_ = {
+      VK_KHR_SURFACE_EXTENSION_NAME,
+#if defined(_WIN32)
+      VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
+#elif defined(VK_USE_PLATFORM_ANDROID_KHR)
+      VK_KHR_ANDROID_SURFACE_EXTENSION_NAME,
+#elif defined(__linux__)
+#if defined(VK_USE_PLATFORM_WAYLAND_KHR)
+      VK_KHR_WAYLAND_SURFACE_EXTENSION_NAME,
 #else
-  void* createInfoNext = &deviceFeatures13;
+      VK_KHR_XLIB_SURFACE_EXTENSION_NAME,
+#endif // VK_USE_PLATFORM_WAYLAND_KHR
 #endif
-  VkPhysicalDeviceAccelerationStructureFeaturesKHR accelerationStructureFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR,
-      .accelerationStructure = VK_TRUE,
-      .accelerationStructureCaptureReplay = VK_FALSE,
-      .accelerationStructureIndirectBuild = VK_FALSE,
-      .accelerationStructureHostCommands = VK_FALSE,
-      .descriptorBindingAccelerationStructureUpdateAfterBind = VK_TRUE,
-  };
-  VkPhysicalDeviceRayTracingPipelineFeaturesKHR rayTracingFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR,
-      .rayTracingPipeline = VK_TRUE,
-      .rayTracingPipelineShaderGroupHandleCaptureReplay = VK_FALSE,
-      .rayTracingPipelineShaderGroupHandleCaptureReplayMixed = VK_FALSE,
-      .rayTracingPipelineTraceRaysIndirect = VK_TRUE,
-      .rayTraversalPrimitiveCulling = VK_FALSE,
-  };
-  VkPhysicalDeviceRayQueryFeaturesKHR rayQueryFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
-      .rayQuery = VK_TRUE,
   };
-  VkPhysicalDeviceRayTracingInvocationReorderFeaturesEXT rayTracingInvocationReorderFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_INVOCATION_REORDER_FEATURES_EXT,
-      .rayTracingInvocationReorder = VK_TRUE,
+
+  const bool hasPortabilityEnumeration = hasExtension(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME, allInstanceExtensions);
+
+#if defined(__APPLE__)
+  if (hasExtension(VK_EXT_LAYER_SETTINGS_EXTENSION_NAME, allInstanceExtensions)) {
+    enabledInstanceExtensionNames_.push_back(VK_EXT_LAYER_SETTINGS_EXTENSION_NAME);
+  }
+  if (hasExtension(VK_MVK_MACOS_SURFACE_EXTENSION_NAME, allInstanceExtensions)) {
+    has_MVK_macos_surface_ = true;
+    enabledInstanceExtensionNames_.push_back(VK_MVK_MACOS_SURFACE_EXTENSION_NAME);
+  }
+  if (hasExtension(VK_EXT_METAL_SURFACE_EXTENSION_NAME, allInstanceExtensions)) {
+    enabledInstanceExtensionNames_.push_back(VK_EXT_METAL_SURFACE_EXTENSION_NAME);
+  }
+  if (hasPortabilityEnumeration) {
+    enabledInstanceExtensionNames_.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+  }
+#endif // __APPLE__
+
+  // check if we have the VK_EXT_debug_utils extension
+  const bool hasDebugUtils = hasExtension(VK_EXT_DEBUG_UTILS_EXTENSION_NAME, allInstanceExtensions);
+
+  if (hasDebugUtils) {
+    enabledInstanceExtensionNames_.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+  }
+
+  if (config_.enableValidation) {
+    enabledInstanceExtensionNames_.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME); // enabled only for validation
+  }
+
+  if (config_.enableHeadlessSurface) {
+    enabledInstanceExtensionNames_.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+  }
+
+  if (hasExtension(VK_KHR_SURFACE_MAINTENANCE_1_EXTENSION_NAME, allInstanceExtensions)) {
+    enabledInstanceExtensionNames_.push_back(VK_KHR_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+  }
+  // Lavapipe 25.3.3 supports both `VK_KHR_surface_maintenance` and `VK_EXT_surface_maintenance`,
+  // but only supports `VK_EXT_swapchain_maintenance1`, which in turn requires `VK_EXT_surface_maintenance1`
+  if (hasExtension(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME, allInstanceExtensions)) {
+    // remove once VK_KHR_surface_maintenance1 becomes mandatory
+    enabledInstanceExtensionNames_.push_back(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+  }
+
+  if (hasExtension(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME, allInstanceExtensions)) {
+    has_EXT_swapchain_colorspace_ = true;
+    enabledInstanceExtensionNames_.push_back(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME);
+  }
+
+  if (hasExtension(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME, allInstanceExtensions)) {
+    // required by the instance extension VK_EXT_surface_maintenance1
+    enabledInstanceExtensionNames_.push_back(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
+  }
+
+  for (const char* ext : config_.extensionsInstance) {
+    if (ext) {
+      enabledInstanceExtensionNames_.push_back(ext);
+    }
+  }
+
+#if !defined(ANDROID)
+  // GPU Assisted Validation doesn't work on Android.
+  // It implicitly requires vertexPipelineStoresAndAtomics feature that's not supported even on high-end devices.
+  const VkValidationFeatureEnableEXT validationFeaturesEnabled[] = {
+      VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_EXT,
+      VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_RESERVE_BINDING_SLOT_EXT,
   };
-  VkPhysicalDeviceSwapchainMaintenance1FeaturesKHR swapchainMaintenance1Features = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_KHR,
-      .swapchainMaintenance1 = VK_TRUE,
+#endif // ANDROID
+
+#if defined(__APPLE__)
+  // Shader validation doesn't work in MoltenVK for SPIR-V 1.6 under Vulkan 1.3:
+  // "Invalid SPIR-V binary version 1.6 for target environment SPIR-V 1.5 (under Vulkan 1.2 semantics)."
+  const VkValidationFeatureDisableEXT validationFeaturesDisabled[] = {
+      VK_VALIDATION_FEATURE_DISABLE_SHADERS_EXT,
+      VK_VALIDATION_FEATURE_DISABLE_SHADER_VALIDATION_CACHE_EXT,
   };
-  VkPhysicalDeviceIndexTypeUint8FeaturesEXT indexTypeUint8Features = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_INDEX_TYPE_UINT8_FEATURES_EXT,
-      .indexTypeUint8 = VK_TRUE,
+#endif // __APPLE__
+
+  const VkValidationFeaturesEXT features = {
+      .sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT,
+      .pNext = nullptr,
+#if !defined(ANDROID)
+      .enabledValidationFeatureCount = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(validationFeaturesEnabled) : 0u,
+      .pEnabledValidationFeatures = config_.enableValidation ? validationFeaturesEnabled : nullptr,
+#endif
+#if defined(__APPLE__)
+      .disabledValidationFeatureCount = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(validationFeaturesDisabled) : 0u,
+      .pDisabledValidationFeatures = config_.enableValidation ? validationFeaturesDisabled : nullptr,
+#endif
   };
-  VkPhysicalDeviceFaultFeaturesEXT deviceFaultFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FAULT_FEATURES_EXT,
-      .deviceFault = VK_TRUE,
+
+#if defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
+  // https://github.com/KhronosGroup/MoltenVK/blob/main/Docs/MoltenVK_Configuration_Parameters.md
+  const int useMetalArgumentBuffers = 1;
+  const VkBool32 gpuav_descriptor_checks = VK_FALSE; // https://github.com/KhronosGroup/Vulkan-ValidationLayers/issues/8688
+  const VkBool32 gpuav_indirect_draws_buffers = VK_FALSE; // https://github.com/KhronosGroup/Vulkan-ValidationLayers/issues/8579
+  const VkBool32 gpuav_post_process_descriptor_indexing = VK_FALSE; // https://github.com/KhronosGroup/Vulkan-ValidationLayers/issues/9222
+#define LAYER_SETTINGS_BOOL32(name, var)                                                                                        \
+  VkLayerSettingEXT {                                                                                                           \
+    .pLayerName = kDefaultValidationLayers[0], .pSettingName = name, .type = VK_LAYER_SETTING_TYPE_BOOL32_EXT, .valueCount = 1, \
+    .pValues = var,                                                                                                             \
+  }
+  const VkLayerSettingEXT settings[] = {
+      LAYER_SETTINGS_BOOL32("gpuav_descriptor_checks", &gpuav_descriptor_checks),
+      LAYER_SETTINGS_BOOL32("gpuav_indirect_draws_buffers", &gpuav_indirect_draws_buffers),
+      LAYER_SETTINGS_BOOL32("gpuav_post_process_descriptor_indexing", &gpuav_post_process_descriptor_indexing),
+      {"MoltenVK", "MVK_CONFIG_USE_METAL_ARGUMENT_BUFFERS", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &useMetalArgumentBuffers},
   };
-  VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5Features = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR,
-      .maintenance5 = VK_TRUE,
+#undef LAYER_SETTINGS_BOOL32
+  const VkLayerSettingsCreateInfoEXT layerSettingsCreateInfo = {
+      .sType = VK_STRUCTURE_TYPE_LAYER_SETTINGS_CREATE_INFO_EXT,
+      .pNext = config_.enableValidation ? &features : nullptr,
+      .settingCount = (uint32_t)LVK_ARRAY_NUM_ELEMENTS(settings),
+      .pSettings = settings,
   };
-  VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR dynamicRenderingLocalReadFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR,
-      .dynamicRenderingLocalRead = VK_TRUE,
+#endif // defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
+
+  // check extensions
+  {
+    std::string missingExtensions;
+    for (const char* ext : enabledInstanceExtensionNames_) {
+      if (!hasExtension(ext, allInstanceExtensions))
+        missingExtensions += "\n   " + std::string(ext);
+    }
+    if (!missingExtensions.empty()) {
+      MINILOG_LOG_PROC(minilog::FatalError, "Missing Vulkan instance extensions: %s\n", missingExtensions.c_str());
+      assert(false);
+      return Result(Result::Code::RuntimeError);
+    }
+  }
+
+  const VkApplicationInfo appInfo = {
+      .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+      .pNext = nullptr,
+      .pApplicationName = "LVK/Vulkan",
+      .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+      .pEngineName = "LVK/Vulkan",
+      .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+#if defined(VK_API_VERSION_1_4)
+      .apiVersion = config_.vulkanVersion == VulkanVersion_1_3 ? VK_API_VERSION_1_3 : VK_API_VERSION_1_4,
+#else
+      .apiVersion = VK_API_VERSION_1_3,
+#endif // VK_API_VERSION_1_4
   };
-  VkPhysicalDeviceShaderTileImageFeaturesEXT shaderTileImageFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_TILE_IMAGE_FEATURES_EXT,
-      .shaderTileImageColorReadAccess = VK_TRUE,
-      .shaderTileImageDepthReadAccess = VK_TRUE,
+
+  const VkInstanceCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+#if defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
+      .pNext = &layerSettingsCreateInfo,
+#else
+      .pNext = config_.enableValidation ? &features : nullptr,
+#endif // defined(VK_EXT_layer_settings) && VK_EXT_layer_settings
+      .flags = hasPortabilityEnumeration ? VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR : 0u,
+      .pApplicationInfo = &appInfo,
+      .enabledLayerCount = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(kDefaultValidationLayers) : 0u,
+      .ppEnabledLayerNames = config_.enableValidation ? kDefaultValidationLayers : nullptr,
+      .enabledExtensionCount = (uint32_t)enabledInstanceExtensionNames_.size(),
+      .ppEnabledExtensionNames = enabledInstanceExtensionNames_.data(),
   };
-  VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
-      .taskShader = VK_TRUE,
-      .meshShader = VK_TRUE,
+  VK_ASSERT(vkCreateInstance(&ci, nullptr, &vkInstance_));
+
+  volkLoadInstance(vkInstance_);
+
+  // debug messenger
+  if (hasDebugUtils) {
+    const VkDebugUtilsMessengerCreateInfoEXT ci = {
+        .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT,
+        .messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT |
+                           VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+        .messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                       VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+        .pfnUserCallback = &vulkanDebugCallback,
+        .pUserData = this,
+    };
+    VK_ASSERT(vkCreateDebugUtilsMessengerEXT(vkInstance_, &ci, nullptr, &vkDebugUtilsMessenger_));
+  }
+
+  LLOGL("%s layer version: %u.%u.%u\n",
+        kDefaultValidationLayers[0],
+        VK_VERSION_MAJOR(khronosValidationVersion_),
+        VK_VERSION_MINOR(khronosValidationVersion_),
+        VK_VERSION_PATCH(khronosValidationVersion_));
+
+  // log available instance extensions
+  LLOGL("\nVulkan instance extensions:\n");
+
+  for (const VkExtensionProperties& extension : allInstanceExtensions) {
+    LLOGL("  %s\n", extension.extensionName);
+  }
+
+  return Result();
+}
+
+void lvk::VulkanContext::createHeadlessSurface() {
+  const VkHeadlessSurfaceCreateInfoEXT ci = {
+      .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+      .pNext = nullptr,
+      .flags = 0,
   };
-  VkPhysicalDevicePresentModeFifoLatestReadyFeaturesKHR presentModeLatestReadyFeatures = {
-      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_MODE_FIFO_LATEST_READY_FEATURES_KHR,
-      .presentModeFifoLatestReady = VK_TRUE,
+  VK_ASSERT(vkCreateHeadlessSurfaceEXT(vkInstance_, &ci, nullptr, &vkSurface_));
+}
+
+void lvk::VulkanContext::createSurface(void* window, void* display) {
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+  const VkWin32SurfaceCreateInfoKHR ci = {
+      .sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR,
+      .hinstance = GetModuleHandle(nullptr),
+      .hwnd = (HWND)window,
+  };
+  VK_ASSERT(vkCreateWin32SurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
+#elif defined(VK_USE_PLATFORM_ANDROID_KHR)
+  const VkAndroidSurfaceCreateInfoKHR ci = {
+      .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
+      .pNext = nullptr,
+      .flags = 0,
+      .window = (ANativeWindow*)window,
+  };
+  VK_ASSERT(vkCreateAndroidSurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
+#elif defined(VK_USE_PLATFORM_XLIB_KHR)
+  const VkXlibSurfaceCreateInfoKHR ci = {
+      .sType = VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR,
+      .flags = 0,
+      .dpy = (Display*)display,
+      .window = (Window)window,
+  };
+  VK_ASSERT(vkCreateXlibSurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
+#elif defined(VK_USE_PLATFORM_WAYLAND_KHR)
+  const VkWaylandSurfaceCreateInfoKHR ci = {
+      .sType = VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR,
+      .flags = 0,
+      .display = (wl_display*)display,
+      .surface = (wl_surface*)window,
   };
+  VK_ASSERT(vkCreateWaylandSurfaceKHR(vkInstance_, &ci, nullptr, &vkSurface_));
+#elif defined(VK_USE_PLATFORM_MACOS_MVK) || defined(VK_USE_PLATFORM_METAL_EXT)
+  if (has_MVK_macos_surface_) {
+    const VkMacOSSurfaceCreateInfoMVK ci = {
+        .sType = VK_STRUCTURE_TYPE_MACOS_SURFACE_CREATE_INFO_MVK,
+        .flags = 0,
+        .pView = window,
+    };
+    VK_ASSERT(vkCreateMacOSSurfaceMVK(vkInstance_, &ci, nullptr, &vkSurface_));
+  } else {
+    const VkMetalSurfaceCreateInfoEXT ci = {
+        .sType = VK_STRUCTURE_TYPE_METAL_SURFACE_CREATE_INFO_EXT,
+        .flags = 0,
+        .pLayer = display, // layer
+    };
+    VK_ASSERT(vkCreateMetalSurfaceEXT(vkInstance_, &ci, nullptr, &vkSurface_));
+  }
+#else
+#error Implement for other platforms
+#endif
+}
 
-  auto addExtension = [&allDeviceExtensions, this, &createInfoNext](const char* name, void* features = nullptr) mutable -> void {
-    if (!hasExtension(name, allDeviceExtensions)) {
-      LLOGW("Unsupported mandatory extension `%s`\n", name);
-      return;
-    }
-    enabledDeviceExtensionNames_.push_back(name);
-    if (features) {
-      std::launder(reinterpret_cast<VkBaseOutStructure*>(features))->pNext =
-          std::launder(reinterpret_cast<VkBaseOutStructure*>(createInfoNext));
-      createInfoNext = features;
+uint32_t lvk::VulkanContext::queryDevices(HWDeviceDesc* outDevices, uint32_t maxOutDevices) {
+  // Physical devices
+  uint32_t deviceCount = 0;
+  VK_ASSERT(vkEnumeratePhysicalDevices(vkInstance_, &deviceCount, nullptr));
+  std::vector<VkPhysicalDevice> vkDevices(deviceCount);
+  VK_ASSERT(vkEnumeratePhysicalDevices(vkInstance_, &deviceCount, vkDevices.data()));
+
+  auto convertVulkanDeviceTypeToLVK = [](VkPhysicalDeviceType vkDeviceType) -> HWDeviceType {
+    switch (vkDeviceType) {
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+      return HWDeviceType_Integrated;
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+      return HWDeviceType_Discrete;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+      return HWDeviceType_External;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:
+      return HWDeviceType_Software;
+    default:
+      return HWDeviceType_Software;
     }
   };
 
-  auto addOptionalExtension = [&allDeviceExtensions, this, &createInfoNext](
-                                  const char* name, bool& enabled, void* features = nullptr) mutable -> bool {
-    if (!hasExtension(name, allDeviceExtensions))
-      return false;
-    enabled = true;
-    enabledDeviceExtensionNames_.push_back(name);
-    if (features) {
-      std::launder(reinterpret_cast<VkBaseOutStructure*>(features))->pNext =
-          std::launder(reinterpret_cast<VkBaseOutStructure*>(createInfoNext));
-      createInfoNext = features;
+  uint32_t numCompatibleDevices = 0;
+
+  for (uint32_t i = 0; i < deviceCount; ++i) {
+    VkPhysicalDevice physicalDevice = vkDevices[i];
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+    const HWDeviceType deviceType = convertVulkanDeviceTypeToLVK(deviceProperties.deviceType);
+
+    if (outDevices && numCompatibleDevices < maxOutDevices) {
+      outDevices[numCompatibleDevices] = {.guid = (uintptr_t)vkDevices[i], .type = deviceType};
+      strncpy(outDevices[numCompatibleDevices].name, deviceProperties.deviceName, strlen(deviceProperties.deviceName));
+      numCompatibleDevices++;
     }
-    return true;
-  };
-  auto addOptionalExtensions = [&allDeviceExtensions, this, &createInfoNext](
-                                   const char* name1, const char* name2, bool& enabled, void* features = nullptr) mutable {
-    if (!hasExtension(name1, allDeviceExtensions) || !hasExtension(name2, allDeviceExtensions))
-      return;
-    enabled = true;
-    enabledDeviceExtensionNames_.push_back(name1);
-    enabledDeviceExtensionNames_.push_back(name2);
-    if (features) {
-      std::launder(reinterpret_cast<VkBaseOutStructure*>(features))->pNext =
-          std::launder(reinterpret_cast<VkBaseOutStructure*>(createInfoNext));
-      createInfoNext = features;
+  }
+
+  return numCompatibleDevices;
+}
+
+void lvk::VulkanContext::addNextPhysicalDeviceProperties(void* properties) {
+  if (!properties)
+    return;
+
+  std::launder(reinterpret_cast<VkBaseOutStructure*>(properties))->pNext =
+      std::launder(reinterpret_cast<VkBaseOutStructure*>(vkPhysicalDeviceProperties2_.pNext));
+
+  vkPhysicalDeviceProperties2_.pNext = properties;
+}
+
+void lvk::VulkanContext::getBuildInfoBLAS(const AccelStructDesc& desc,
+                                          VkAccelerationStructureGeometryKHR& outGeometry,
+                                          VkAccelerationStructureBuildSizesInfoKHR& outSizesInfo) const {
+  LVK_ASSERT(desc.type == AccelStructType_BLAS);
+  LVK_ASSERT(desc.geometryType == AccelStructGeomType_Triangles);
+  LVK_ASSERT(desc.numVertices);
+  LVK_ASSERT(desc.indexBuffer.valid());
+  LVK_ASSERT(desc.vertexBuffer.valid());
+  LVK_ASSERT(desc.transformBuffer.valid());
+  LVK_ASSERT(desc.buildRange.primitiveCount);
+
+  LVK_ASSERT(buffersPool_.get(desc.indexBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
+  LVK_ASSERT(buffersPool_.get(desc.vertexBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
+  LVK_ASSERT(buffersPool_.get(desc.transformBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
+
+  VkGeometryFlagsKHR geometryFlags = 0;
+
+  if (desc.geometryFlags & AccelStructGeometryFlagBits_Opaque) {
+    geometryFlags |= VK_GEOMETRY_OPAQUE_BIT_KHR;
+  }
+  if (desc.geometryFlags & AccelStructGeometryFlagBits_NoDuplicateAnyHit) {
+    geometryFlags |= VK_GEOMETRY_NO_DUPLICATE_ANY_HIT_INVOCATION_BIT_KHR;
+  }
+
+  outGeometry = VkAccelerationStructureGeometryKHR{
+      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+      .geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR,
+      .geometry =
+          {
+              .triangles =
+                  {
+                      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR,
+                      .vertexFormat = vertexFormatToVkFormat(desc.vertexFormat),
+                      .vertexData = {.deviceAddress = gpuAddress(desc.vertexBuffer)},
+                      .vertexStride = desc.vertexStride ? desc.vertexStride : lvk::getVertexFormatSize(desc.vertexFormat),
+                      .maxVertex = desc.numVertices - 1,
+                      .indexType = VK_INDEX_TYPE_UINT32,
+                      .indexData = {.deviceAddress = gpuAddress(desc.indexBuffer)},
+                      .transformData = {.deviceAddress = gpuAddress(desc.transformBuffer)},
+                  },
+          },
+      .flags = geometryFlags,
+  };
+
+  const VkAccelerationStructureBuildGeometryInfoKHR accelerationBuildGeometryInfo{
+      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
+      .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+      .flags = buildFlagsToVkBuildAccelerationStructureFlags(desc.buildFlags),
+      .geometryCount = 1,
+      .pGeometries = &outGeometry,
+  };
+
+  outSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+  vkGetAccelerationStructureBuildSizesKHR(vkDevice_,
+                                          VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+                                          &accelerationBuildGeometryInfo,
+                                          &desc.buildRange.primitiveCount,
+                                          &outSizesInfo);
+  const uint32_t alignment = accelerationStructureProperties_.minAccelerationStructureScratchOffsetAlignment;
+  outSizesInfo.accelerationStructureSize += alignment;
+  outSizesInfo.updateScratchSize += alignment;
+  outSizesInfo.buildScratchSize += alignment;
+}
+
+void lvk::VulkanContext::getBuildInfoTLAS(const AccelStructDesc& desc,
+                                          VkAccelerationStructureGeometryKHR& outGeometry,
+                                          VkAccelerationStructureBuildSizesInfoKHR& outSizesInfo) const {
+  LVK_ASSERT(desc.type == AccelStructType_TLAS);
+  LVK_ASSERT(desc.geometryType == AccelStructGeomType_Instances);
+  LVK_ASSERT(desc.numVertices == 0);
+  LVK_ASSERT(desc.instancesBuffer.valid());
+  LVK_ASSERT(desc.buildRange.primitiveCount);
+  LVK_ASSERT(buffersPool_.get(desc.instancesBuffer)->vkUsageFlags_ & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR);
+
+  VkGeometryFlagsKHR geometryFlags = 0;
+
+  if (desc.geometryFlags & AccelStructGeometryFlagBits_Opaque) {
+    geometryFlags |= VK_GEOMETRY_OPAQUE_BIT_KHR;
+  }
+  if (desc.geometryFlags & AccelStructGeometryFlagBits_NoDuplicateAnyHit) {
+    geometryFlags |= VK_GEOMETRY_NO_DUPLICATE_ANY_HIT_INVOCATION_BIT_KHR;
+  }
+
+  outGeometry = VkAccelerationStructureGeometryKHR{
+      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+      .geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR,
+      .geometry =
+          {
+              .instances =
+                  {
+                      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR,
+                      .arrayOfPointers = VK_FALSE,
+                      .data = {.deviceAddress = gpuAddress(desc.instancesBuffer)},
+                  },
+          },
+      .flags = geometryFlags,
+  };
+
+  const VkAccelerationStructureBuildGeometryInfoKHR accelerationStructureBuildGeometryInfo = {
+      .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
+      .type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
+      .flags = buildFlagsToVkBuildAccelerationStructureFlags(desc.buildFlags),
+      .geometryCount = 1,
+      .pGeometries = &outGeometry,
+  };
+
+  outSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR,
+  vkGetAccelerationStructureBuildSizesKHR(vkDevice_,
+                                          VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+                                          &accelerationStructureBuildGeometryInfo,
+                                          &desc.buildRange.primitiveCount,
+                                          &outSizesInfo);
+  const uint32_t alignment = accelerationStructureProperties_.minAccelerationStructureScratchOffsetAlignment;
+  outSizesInfo.accelerationStructureSize += alignment;
+  outSizesInfo.updateScratchSize += alignment;
+  outSizesInfo.buildScratchSize += alignment;
+}
+
+lvk::Result lvk::VulkanContext::initContext(const HWDeviceDesc& desc) {
+  if (desc.guid == 0UL) {
+    LLOGW("Invalid hardwareGuid(%lu)", desc.guid);
+    return Result(Result::Code::RuntimeError, "Vulkan is not supported");
+  }
+
+  vkPhysicalDevice_ = (VkPhysicalDevice)desc.guid;
+
+  useStaging_ = !isHostVisibleSingleHeapMemory(vkPhysicalDevice_);
+  hasLazilyAllocatedMemory_ = hasLazilyAllocatedMemory(vkPhysicalDevice_);
+
+  std::vector<VkExtensionProperties> allDeviceExtensions;
+  getDeviceExtensionProps(vkPhysicalDevice_, allDeviceExtensions);
+  if (config_.enableValidation) {
+    for (const char* layer : kDefaultValidationLayers) {
+      getDeviceExtensionProps(vkPhysicalDevice_, allDeviceExtensions, layer);
+    }
+  }
+
+  if (hasExtension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME, allDeviceExtensions)) {
+    addNextPhysicalDeviceProperties(&accelerationStructureProperties_);
+  }
+  if (hasExtension(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME, allDeviceExtensions)) {
+    addNextPhysicalDeviceProperties(&rayTracingPipelineProperties_);
+  }
+  if (config_.enableDescriptorBuffer && hasExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, allDeviceExtensions)) {
+    addNextPhysicalDeviceProperties(&descriptorBufferProperties_);
+  }
+
+#if defined(VK_API_VERSION_1_4)
+  if (config_.vulkanVersion >= VulkanVersion_1_4) {
+    addNextPhysicalDeviceProperties(&vkPhysicalDeviceVulkan14Properties_);
+    vkFeatures13_.pNext = &vkFeatures14_;
+  }
+#else
+  LVK_ASSERT_MSG(config_.vulkanVersion == VulkanVersion_1_3, "Only Vulkan 1.3 is supported on this platform");
+#endif // VK_API_VERSION_1_4
+
+  vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &vkFeatures10_);
+  vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &vkPhysicalDeviceProperties2_);
+
+  const uint32_t apiVersion = vkPhysicalDeviceProperties2_.properties.apiVersion;
+
+  LLOGL("Vulkan physical device: %s\n", vkPhysicalDeviceProperties2_.properties.deviceName);
+  LLOGL("           API version: %i.%i.%i.%i\n",
+        VK_API_VERSION_MAJOR(apiVersion),
+        VK_API_VERSION_MINOR(apiVersion),
+        VK_API_VERSION_PATCH(apiVersion),
+        VK_API_VERSION_VARIANT(apiVersion));
+  LLOGL("           Driver info: %s %s\n", vkPhysicalDeviceDriverProperties_.driverName, vkPhysicalDeviceDriverProperties_.driverInfo);
+
+  LLOGL("Vulkan physical device extensions:\n");
+
+  // log available physical device extensions
+  for (const VkExtensionProperties& ext : allDeviceExtensions) {
+    LLOGL("  %s\n", ext.extensionName);
+  }
+
+  deviceQueues_.graphicsQueueFamilyIndex = lvk::findQueueFamilyIndex(vkPhysicalDevice_, VK_QUEUE_GRAPHICS_BIT);
+  deviceQueues_.computeQueueFamilyIndex = lvk::findQueueFamilyIndex(vkPhysicalDevice_, VK_QUEUE_COMPUTE_BIT);
+  deviceQueues_.transferQueueFamilyIndex = lvk::findQueueFamilyIndex(vkPhysicalDevice_, VK_QUEUE_TRANSFER_BIT);
+
+  if (deviceQueues_.graphicsQueueFamilyIndex == DeviceQueues::INVALID) {
+    LLOGW("VK_QUEUE_GRAPHICS_BIT is not supported");
+    return Result(Result::Code::RuntimeError, "VK_QUEUE_GRAPHICS_BIT is not supported");
+  }
+
+  if (deviceQueues_.computeQueueFamilyIndex == DeviceQueues::INVALID) {
+    LLOGW("VK_QUEUE_COMPUTE_BIT is not supported");
+    return Result(Result::Code::RuntimeError, "VK_QUEUE_COMPUTE_BIT is not supported");
+  }
+
+  if (deviceQueues_.transferQueueFamilyIndex == DeviceQueues::INVALID) {
+    // graphics and compute queues always support transfer operations
+    deviceQueues_.transferQueueFamilyIndex = deviceQueues_.computeQueueFamilyIndex;
+  }
+
+  // sparse textures are bound on the graphics queue; asynchronous uploads on the transfer queue depend on its copy granularity; timing
+  // scopes are skipped on queue families without timestamps
+  {
+    uint32_t numQueueFamilies = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice_, &numQueueFamilies, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(numQueueFamilies);
+    vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice_, &numQueueFamilies, queueFamilies.data());
+    transferImageGranularity_ = queueFamilies[deviceQueues_.transferQueueFamilyIndex].minImageTransferGranularity;
+    timestampValidBits_[QueueType_Graphics] = queueFamilies[deviceQueues_.graphicsQueueFamilyIndex].timestampValidBits;
+    timestampValidBits_[QueueType_Compute] = queueFamilies[deviceQueues_.computeQueueFamilyIndex].timestampValidBits;
+    timestampValidBits_[QueueType_Transfer] = queueFamilies[deviceQueues_.transferQueueFamilyIndex].timestampValidBits;
+    const VkPhysicalDeviceFeatures& features = vkFeatures10_.features;
+    has_sparseResidency_ = features.sparseBinding && features.sparseResidencyImage2D && features.shaderResourceResidency &&
+                           (queueFamilies[deviceQueues_.graphicsQueueFamilyIndex].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT);
+  }
+
+  // every queue family is used only once; resources shared between several families are created with VK_SHARING_MODE_CONCURRENT
+  const uint32_t queueFamilyIndices[] = {
+      deviceQueues_.graphicsQueueFamilyIndex,
+      deviceQueues_.computeQueueFamilyIndex,
+      deviceQueues_.transferQueueFamilyIndex,
+  };
+  for (uint32_t idx : queueFamilyIndices) {
+    bool isDuplicate = false;
+    for (uint32_t i = 0; i != numSharedQueueFamilyIndices_; i++) {
+      isDuplicate |= sharedQueueFamilyIndices_[i] == idx;
+    }
+    if (!isDuplicate) {
+      sharedQueueFamilyIndices_[numSharedQueueFamilyIndices_++] = idx;
+    }
+  }
+
+  const float queuePriority = 1.0f;
+
+  VkDeviceQueueCreateInfo ciQueue[LVK_ARRAY_NUM_ELEMENTS(sharedQueueFamilyIndices_)] = {};
+  for (uint32_t i = 0; i != numSharedQueueFamilyIndices_; i++) {
+    ciQueue[i] = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+        .queueFamilyIndex = sharedQueueFamilyIndices_[i],
+        .queueCount = 1,
+        .pQueuePriorities = &queuePriority,
+    };
+  }
+  const uint32_t numQueues = numSharedQueueFamilyIndices_;
+
+  enabledDeviceExtensionNames_ = {
+      VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+  };
+
+  if (hasExtension("VK_KHR_portability_subset", allDeviceExtensions)) {
+    enabledDeviceExtensionNames_.push_back("VK_KHR_portability_subset");
+  }
+
+  for (const char* ext : config_.extensionsDevice) {
+    if (ext) {
+      enabledDeviceExtensionNames_.push_back(ext);
+    }
+  }
+
+  VkPhysicalDeviceFeatures deviceFeatures10 = {
+      .independentBlend = vkFeatures10_.features.independentBlend, // enable if supported
+      .geometryShader = vkFeatures10_.features.geometryShader, // enable if supported
+      .tessellationShader = vkFeatures10_.features.tessellationShader, // enable if supported
+      .sampleRateShading = vkFeatures10_.features.sampleRateShading, // enable if supported
+      .multiDrawIndirect = VK_TRUE,
+      .drawIndirectFirstInstance = VK_TRUE,
+      .depthBiasClamp = vkFeatures10_.features.depthBiasClamp, // enable if supported,
+      .fillModeNonSolid = vkFeatures10_.features.fillModeNonSolid, // enable if supported
+      .samplerAnisotropy = VK_TRUE,
+      .textureCompressionETC2 = vkFeatures10_.features.textureCompressionETC2, // enable if supported
+      .textureCompressionASTC_LDR = vkFeatures10_.features.textureCompressionASTC_LDR, // enable if supported
+      .textureCompressionBC = vkFeatures10_.features.textureCompressionBC, // enable if supported
+      .vertexPipelineStoresAndAtomics = vkFeatures10_.features.vertexPipelineStoresAndAtomics, // enable if supported
+      .fragmentStoresAndAtomics = VK_TRUE,
+      .shaderImageGatherExtended = VK_TRUE,
+      .shaderInt64 = vkFeatures10_.features.shaderInt64, // enable if supported
+      .shaderInt16 = vkFeatures10_.features.shaderInt16, // enable if supported
+      .shaderResourceResidency = has_sparseResidency_ ? VK_TRUE : VK_FALSE,
+      .sparseBinding = has_sparseResidency_ ? VK_TRUE : VK_FALSE,
+      .sparseResidencyImage2D = has_sparseResidency_ ? VK_TRUE : VK_FALSE,
+  };
+  VkPhysicalDeviceVulkan11Features deviceFeatures11 = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+      .pNext = config_.extensionsDeviceFeatures,
+      .storageBuffer16BitAccess = VK_TRUE,
+      .multiview = vkFeatures11_.multiview, // enable if supported
+      .samplerYcbcrConversion = vkFeatures11_.samplerYcbcrConversion, // enable if supported
+      .shaderDrawParameters = VK_TRUE,
+  };
+  VkPhysicalDeviceVulkan12Features deviceFeatures12 = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+      .pNext = &deviceFeatures11,
+      .samplerMirrorClampToEdge = VK_TRUE,
+      .drawIndirectCount = vkFeatures12_.drawIndirectCount, // enable if supported
+      .storageBuffer8BitAccess = vkFeatures12_.storageBuffer8BitAccess, // enable if supported
+      .uniformAndStorageBuffer8BitAccess = vkFeatures12_.uniformAndStorageBuffer8BitAccess, // enable if supported
+      .shaderFloat16 = vkFeatures12_.shaderFloat16, // enable if supported
+      .shaderInt8 = vkFeatures12_.shaderInt8, // enable if supported
+      .descriptorIndexing = VK_TRUE,
+      .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+      .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+      .descriptorBindingStorageImageUpdateAfterBind = VK_TRUE,
+      .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+      .descriptorBindingPartiallyBound = VK_TRUE,
+      .descriptorBindingVariableDescriptorCount = VK_TRUE,
+      .runtimeDescriptorArray = VK_TRUE,
+      .scalarBlockLayout = VK_TRUE,
+      .uniformBufferStandardLayout = VK_TRUE,
+      .hostQueryReset = vkFeatures12_.hostQueryReset, // enable if supported
+      .timelineSemaphore = VK_TRUE,
+      .bufferDeviceAddress = VK_TRUE,
+      .vulkanMemoryModel = vkFeatures12_.vulkanMemoryModel, // enable if supported
+      .vulkanMemoryModelDeviceScope = vkFeatures12_.vulkanMemoryModelDeviceScope, // enable if supported
+  };
+  VkPhysicalDeviceVulkan13Features deviceFeatures13 = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+      .pNext = &deviceFeatures12,
+      .shaderDemoteToHelperInvocation = vkFeatures13_.shaderDemoteToHelperInvocation, // enable if supported
+      .subgroupSizeControl = VK_TRUE,
+      .synchronization2 = VK_TRUE,
+      .dynamicRendering = VK_TRUE,
+      .maintenance4 = VK_TRUE,
+  };
+#if defined(VK_API_VERSION_1_4)
+  VkPhysicalDeviceVulkan14Features deviceFeatures14 = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_4_FEATURES,
+      .pNext = &deviceFeatures13,
+      .indexTypeUint8 = vkFeatures14_.indexTypeUint8,
+      .dynamicRenderingLocalRead = VK_TRUE,
+      .maintenance5 = VK_TRUE,
+  };
+#endif // VK_API_VERSION_1_4
+
+#if defined(VK_API_VERSION_1_4)
+  void* createInfoNext = config_.vulkanVersion >= VulkanVersion_1_4 ? (void*)&deviceFeatures14 : (void*)&deviceFeatures13;
+#else
+  void* createInfoNext = &deviceFeatures13;
+#endif
+  VkPhysicalDeviceAccelerationStructureFeaturesKHR accelerationStructureFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR,
+      .accelerationStructure = VK_TRUE,
+      .accelerationStructureCaptureReplay = VK_FALSE,
+      .accelerationStructureIndirectBuild = VK_FALSE,
+      .accelerationStructureHostCommands = VK_FALSE,
+      .descriptorBindingAccelerationStructureUpdateAfterBind = VK_TRUE,
+  };
+  VkPhysicalDeviceRayTracingPipelineFeaturesKHR rayTracingFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR,
+      .rayTracingPipeline = VK_TRUE,
+      .rayTracingPipelineShaderGroupHandleCaptureReplay = VK_FALSE,
+      .rayTracingPipelineShaderGroupHandleCaptureReplayMixed = VK_FALSE,
+      .rayTracingPipelineTraceRaysIndirect = VK_TRUE,
+      .rayTraversalPrimitiveCulling = VK_FALSE,
+  };
+  VkPhysicalDeviceRayQueryFeaturesKHR rayQueryFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
+      .rayQuery = VK_TRUE,
+  };
+  VkPhysicalDeviceRayTracingInvocationReorderFeaturesEXT rayTracingInvocationReorderFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_INVOCATION_REORDER_FEATURES_EXT,
+      .rayTracingInvocationReorder = VK_TRUE,
+  };
+  VkPhysicalDeviceSwapchainMaintenance1FeaturesKHR swapchainMaintenance1Features = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_KHR,
+      .swapchainMaintenance1 = VK_TRUE,
+  };
+  VkPhysicalDeviceIndexTypeUint8FeaturesEXT indexTypeUint8Features = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_INDEX_TYPE_UINT8_FEATURES_EXT,
+      .indexTypeUint8 = VK_TRUE,
+  };
+  VkPhysicalDeviceFaultFeaturesEXT deviceFaultFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FAULT_FEATURES_EXT,
+      .deviceFault = VK_TRUE,
+  };
+  VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5Features = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR,
+      .maintenance5 = VK_TRUE,
+  };
+  VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR dynamicRenderingLocalReadFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR,
+      .dynamicRenderingLocalRead = VK_TRUE,
+  };
+  VkPhysicalDeviceShaderTileImageFeaturesEXT shaderTileImageFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_TILE_IMAGE_FEATURES_EXT,
+      .shaderTileImageColorReadAccess = VK_TRUE,
+      .shaderTileImageDepthReadAccess = VK_TRUE,
+  };
+  VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
+      .taskShader = VK_TRUE,
+      .meshShader = VK_TRUE,
+  };
+  VkPhysicalDevicePresentModeFifoLatestReadyFeaturesKHR presentModeLatestReadyFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_MODE_FIFO_LATEST_READY_FEATURES_KHR,
+      .presentModeFifoLatestReady = VK_TRUE,
+  };
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+      .presentId = VK_TRUE,
+  };
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+      .presentWait = VK_TRUE,
+  };
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+      .descriptorBuffer = VK_TRUE,
+      .descriptorBufferPushDescriptors = VK_TRUE, // input attachments use push descriptors
+  };
+  VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extendedDynamicState3Features = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+      .extendedDynamicState3PolygonMode = VK_TRUE,
+      .extendedDynamicState3RasterizationSamples = VK_TRUE,
+      .extendedDynamicState3ColorBlendEnable = VK_TRUE,
+      .extendedDynamicState3ColorBlendEquation = VK_TRUE,
+      .extendedDynamicState3ColorWriteMask = VK_TRUE,
+  };
+
+  auto addExtension = [&allDeviceExtensions, this, &createInfoNext](const char* name, void* features = nullptr) mutable -> void {
+    if (!hasExtension(name, allDeviceExtensions)) {
+      LLOGW("Unsupported mandatory extension `%s`\n", name);
+      return;
+    }
+    enabledDeviceExtensionNames_.push_back(name);
+    if (features) {
+      std::launder(reinterpret_cast<VkBaseOutStructure*>(features))->pNext =
+          std::launder(reinterpret_cast<VkBaseOutStructure*>(createInfoNext));
+      createInfoNext = features;
+    }
+  };
+
+  auto addOptionalExtension = [&allDeviceExtensions, this, &createInfoNext](
+                                  const char* name, bool& enabled, void* features = nullptr) mutable -> bool {
+    if (!hasExtension(name, allDeviceExtensions))
+      return false;
+    enabled = true;
+    enabledDeviceExtensionNames_.push_back(name);
+    if (features) {
+      std::launder(reinterpret_cast<VkBaseOutStructure*>(features))->pNext =
+          std::launder(reinterpret_cast<VkBaseOutStructure*>(createInfoNext));
+      createInfoNext = features;
+    }
+    return true;
+  };
+  auto addOptionalExtensions = [&allDeviceExtensions, this, &createInfoNext](
+                                   const char* name1, const char* name2, bool& enabled, void* features = nullptr) mutable {
+    if (!hasExtension(name1, allDeviceExtensions) || !hasExtension(name2, allDeviceExtensions))
+      return;
+    enabled = true;
+    enabledDeviceExtensionNames_.push_back(name1);
+    enabledDeviceExtensionNames_.push_back(name2);
+    if (features) {
+      std::launder(reinterpret_cast<VkBaseOutStructure*>(features))->pNext =
+          std::launder(reinterpret_cast<VkBaseOutStructure*>(createInfoNext));
+      createInfoNext = features;
+    }
+  };
+
+  if (config_.vulkanVersion < VulkanVersion_1_4) {
+    addExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, nullptr);
+    addExtension(VK_KHR_MAINTENANCE_5_EXTENSION_NAME, &maintenance5Features);
+    addExtension(VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME, &dynamicRenderingLocalReadFeatures);
+    if (!addOptionalExtension(VK_KHR_INDEX_TYPE_UINT8_EXTENSION_NAME, has_8BitIndices_, &indexTypeUint8Features)) {
+      addOptionalExtension(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME, has_8BitIndices_, &indexTypeUint8Features);
+    }
+  }
+#if defined(LVK_WITH_TRACY)
+  addOptionalExtension(VK_KHR_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, has_KHR_calibrated_timestamps_, nullptr);
+#endif
+  addOptionalExtensions(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
+                        VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
+                        has_KHR_acceleration_structure_,
+                        &accelerationStructureFeatures);
+  addOptionalExtension(VK_KHR_RAY_QUERY_EXTENSION_NAME, has_KHR_ray_query_, &rayQueryFeatures);
+  addOptionalExtension(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME, has_KHR_ray_tracing_pipeline_, &rayTracingFeatures);
+  addOptionalExtension(
+      VK_EXT_RAY_TRACING_INVOCATION_REORDER_EXTENSION_NAME, has_EXT_ray_tracing_invocation_reorder, &rayTracingInvocationReorderFeatures);
+  if (!addOptionalExtension(
+          VK_KHR_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME, has_KHR_swapchain_maintenance1_, &swapchainMaintenance1Features)) {
+    addOptionalExtension(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME, has_KHR_swapchain_maintenance1_, &swapchainMaintenance1Features);
+  }
+  addOptionalExtension(VK_EXT_HDR_METADATA_EXTENSION_NAME, has_EXT_hdr_metadata_);
+  addOptionalExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, has_EXT_memory_budget_);
+  addOptionalExtension(VK_EXT_DEVICE_FAULT_EXTENSION_NAME, has_EXT_device_fault_, &deviceFaultFeatures);
+  addOptionalExtension(VK_EXT_SHADER_TILE_IMAGE_EXTENSION_NAME, has_EXT_shader_tile_image, &shaderTileImageFeatures);
+  addOptionalExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME, has_EXT_mesh_shader_, &meshShaderFeatures);
+  addOptionalExtension(VK_KHR_SHARED_PRESENTABLE_IMAGE_EXTENSION_NAME, has_KHR_shared_presentable_image_);
+  addOptionalExtension(
+      VK_KHR_PRESENT_MODE_FIFO_LATEST_READY_EXTENSION_NAME, has_KHR_present_mode_fifo_latest_ready_, &presentModeLatestReadyFeatures);
+  if (config_.enableDescriptorBuffer) {
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT availableDescriptorBufferFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+    };
+    if (hasExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, allDeviceExtensions)) {
+      VkPhysicalDeviceFeatures2 features = {
+          .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+          .pNext = &availableDescriptorBufferFeatures,
+      };
+      vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    }
+    if (availableDescriptorBufferFeatures.descriptorBuffer && availableDescriptorBufferFeatures.descriptorBufferPushDescriptors) {
+      addOptionalExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, has_EXT_descriptor_buffer_, &descriptorBufferFeatures);
+    } else {
+      LLOGW("VK_EXT_descriptor_buffer is not supported. Falling back to descriptor sets\n");
+    }
+  }
+  if (config_.enableExtendedDynamicState3) {
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT availableExtendedDynamicState3Features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+    };
+    if (hasExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, allDeviceExtensions)) {
+      VkPhysicalDeviceFeatures2 features = {
+          .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+          .pNext = &availableExtendedDynamicState3Features,
+      };
+      vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    }
+    const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& eds3 = availableExtendedDynamicState3Features;
+    if (eds3.extendedDynamicState3PolygonMode && eds3.extendedDynamicState3RasterizationSamples &&
+        eds3.extendedDynamicState3ColorBlendEnable && eds3.extendedDynamicState3ColorBlendEquation &&
+        eds3.extendedDynamicState3ColorWriteMask) {
+      addOptionalExtension(
+          VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, has_EXT_extended_dynamic_state3_, &extendedDynamicState3Features);
+    } else {
+      LLOGW("VK_EXT_extended_dynamic_state3 is not supported. Falling back to static pipeline state\n");
+    }
+  }
+  if (config_.enableLowLatency) {
+    VkPhysicalDevicePresentWaitFeaturesKHR availablePresentWaitFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+    };
+    VkPhysicalDevicePresentIdFeaturesKHR availablePresentIdFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+        .pNext = &availablePresentWaitFeatures,
+    };
+    if (hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME, allDeviceExtensions) &&
+        hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME, allDeviceExtensions)) {
+      VkPhysicalDeviceFeatures2 features = {
+          .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+          .pNext = &availablePresentIdFeatures,
+      };
+      vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    }
+    if (availablePresentIdFeatures.presentId && availablePresentWaitFeatures.presentWait) {
+      bool hasPresentId = false;
+      addOptionalExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME, hasPresentId, &presentIdFeatures);
+      addOptionalExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME, has_KHR_present_wait_, &presentWaitFeatures);
+      // uses present ids to match latency markers with frames
+      addOptionalExtension(VK_NV_LOW_LATENCY_2_EXTENSION_NAME, has_NV_low_latency2_);
+    } else {
+      LLOGW("VK_KHR_present_wait is not supported. Falling back to frame pacing by GPU completion\n");
+    }
+  }
+
+  // check extensions
+  {
+    std::string missingExtensions;
+    for (const char* ext : enabledDeviceExtensionNames_) {
+      if (!hasExtension(ext, allDeviceExtensions))
+        missingExtensions += "\n   " + std::string(ext);
+    }
+    if (!missingExtensions.empty()) {
+      MINILOG_LOG_PROC(minilog::FatalError, "Missing Vulkan device extensions: %s\n", missingExtensions.c_str());
+      assert(false);
+      return Result(Result::Code::RuntimeError);
+    }
+  }
+
+  // check features
+  {
+    std::string missingFeatures;
+#define CHECK_VULKAN_FEATURE(reqFeatures, availFeatures, feature, version)     \
+  if ((reqFeatures.feature == VK_TRUE) && (availFeatures.feature == VK_FALSE)) \
+    missingFeatures.append("\n   " version " ." #feature);
+#define CHECK_FEATURE_1_0(feature) CHECK_VULKAN_FEATURE(deviceFeatures10, vkFeatures10_.features, feature, "1.0 ");
+    CHECK_FEATURE_1_0(robustBufferAccess);
+    CHECK_FEATURE_1_0(fullDrawIndexUint32);
+    CHECK_FEATURE_1_0(imageCubeArray);
+    CHECK_FEATURE_1_0(independentBlend);
+    CHECK_FEATURE_1_0(geometryShader);
+    CHECK_FEATURE_1_0(tessellationShader);
+    CHECK_FEATURE_1_0(sampleRateShading);
+    CHECK_FEATURE_1_0(dualSrcBlend);
+    CHECK_FEATURE_1_0(logicOp);
+    CHECK_FEATURE_1_0(multiDrawIndirect);
+    CHECK_FEATURE_1_0(drawIndirectFirstInstance);
+    CHECK_FEATURE_1_0(depthClamp);
+    CHECK_FEATURE_1_0(depthBiasClamp);
+    CHECK_FEATURE_1_0(fillModeNonSolid);
+    CHECK_FEATURE_1_0(depthBounds);
+    CHECK_FEATURE_1_0(wideLines);
+    CHECK_FEATURE_1_0(largePoints);
+    CHECK_FEATURE_1_0(alphaToOne);
+    CHECK_FEATURE_1_0(multiViewport);
+    CHECK_FEATURE_1_0(samplerAnisotropy);
+    CHECK_FEATURE_1_0(textureCompressionETC2);
+    CHECK_FEATURE_1_0(textureCompressionASTC_LDR);
+    CHECK_FEATURE_1_0(textureCompressionBC);
+    CHECK_FEATURE_1_0(occlusionQueryPrecise);
+    CHECK_FEATURE_1_0(pipelineStatisticsQuery);
+    CHECK_FEATURE_1_0(vertexPipelineStoresAndAtomics);
+    CHECK_FEATURE_1_0(fragmentStoresAndAtomics);
+    CHECK_FEATURE_1_0(shaderTessellationAndGeometryPointSize);
+    CHECK_FEATURE_1_0(shaderImageGatherExtended);
+    CHECK_FEATURE_1_0(shaderStorageImageExtendedFormats);
+    CHECK_FEATURE_1_0(shaderStorageImageMultisample);
+    CHECK_FEATURE_1_0(shaderStorageImageReadWithoutFormat);
+    CHECK_FEATURE_1_0(shaderStorageImageWriteWithoutFormat);
+    CHECK_FEATURE_1_0(shaderUniformBufferArrayDynamicIndexing);
+    CHECK_FEATURE_1_0(shaderSampledImageArrayDynamicIndexing);
+    CHECK_FEATURE_1_0(shaderStorageBufferArrayDynamicIndexing);
+    CHECK_FEATURE_1_0(shaderStorageImageArrayDynamicIndexing);
+    CHECK_FEATURE_1_0(shaderClipDistance);
+    CHECK_FEATURE_1_0(shaderCullDistance);
+    CHECK_FEATURE_1_0(shaderFloat64);
+    CHECK_FEATURE_1_0(shaderInt64);
+    CHECK_FEATURE_1_0(shaderInt16);
+    CHECK_FEATURE_1_0(shaderResourceResidency);
+    CHECK_FEATURE_1_0(shaderResourceMinLod);
+    CHECK_FEATURE_1_0(sparseBinding);
+    CHECK_FEATURE_1_0(sparseResidencyBuffer);
+    CHECK_FEATURE_1_0(sparseResidencyImage2D);
+    CHECK_FEATURE_1_0(sparseResidencyImage3D);
+    CHECK_FEATURE_1_0(sparseResidency2Samples);
+    CHECK_FEATURE_1_0(sparseResidency4Samples);
+    CHECK_FEATURE_1_0(sparseResidency8Samples);
+    CHECK_FEATURE_1_0(sparseResidency16Samples);
+    CHECK_FEATURE_1_0(sparseResidencyAliased);
+    CHECK_FEATURE_1_0(variableMultisampleRate);
+    CHECK_FEATURE_1_0(inheritedQueries);
+#undef CHECK_FEATURE_1_0
+#define CHECK_FEATURE_1_1(feature) CHECK_VULKAN_FEATURE(deviceFeatures11, vkFeatures11_, feature, "1.1 ");
+    CHECK_FEATURE_1_1(storageBuffer16BitAccess);
+    CHECK_FEATURE_1_1(uniformAndStorageBuffer16BitAccess);
+    CHECK_FEATURE_1_1(storagePushConstant16);
+    CHECK_FEATURE_1_1(storageInputOutput16);
+    CHECK_FEATURE_1_1(multiview);
+    CHECK_FEATURE_1_1(multiviewGeometryShader);
+    CHECK_FEATURE_1_1(multiviewTessellationShader);
+    CHECK_FEATURE_1_1(variablePointersStorageBuffer);
+    CHECK_FEATURE_1_1(variablePointers);
+    CHECK_FEATURE_1_1(protectedMemory);
+    CHECK_FEATURE_1_1(samplerYcbcrConversion);
+    CHECK_FEATURE_1_1(shaderDrawParameters);
+#undef CHECK_FEATURE_1_1
+#define CHECK_FEATURE_1_2(feature) CHECK_VULKAN_FEATURE(deviceFeatures12, vkFeatures12_, feature, "1.2 ");
+    CHECK_FEATURE_1_2(samplerMirrorClampToEdge);
+    CHECK_FEATURE_1_2(drawIndirectCount);
+    CHECK_FEATURE_1_2(storageBuffer8BitAccess);
+    CHECK_FEATURE_1_2(uniformAndStorageBuffer8BitAccess);
+    CHECK_FEATURE_1_2(storagePushConstant8);
+    CHECK_FEATURE_1_2(shaderBufferInt64Atomics);
+    CHECK_FEATURE_1_2(shaderSharedInt64Atomics);
+    CHECK_FEATURE_1_2(shaderFloat16);
+    CHECK_FEATURE_1_2(shaderInt8);
+    CHECK_FEATURE_1_2(descriptorIndexing);
+    CHECK_FEATURE_1_2(shaderInputAttachmentArrayDynamicIndexing);
+    CHECK_FEATURE_1_2(shaderUniformTexelBufferArrayDynamicIndexing);
+    CHECK_FEATURE_1_2(shaderStorageTexelBufferArrayDynamicIndexing);
+    CHECK_FEATURE_1_2(shaderUniformBufferArrayNonUniformIndexing);
+    CHECK_FEATURE_1_2(shaderSampledImageArrayNonUniformIndexing);
+    CHECK_FEATURE_1_2(shaderStorageBufferArrayNonUniformIndexing);
+    CHECK_FEATURE_1_2(shaderStorageImageArrayNonUniformIndexing);
+    CHECK_FEATURE_1_2(shaderInputAttachmentArrayNonUniformIndexing);
+    CHECK_FEATURE_1_2(shaderUniformTexelBufferArrayNonUniformIndexing);
+    CHECK_FEATURE_1_2(shaderStorageTexelBufferArrayNonUniformIndexing);
+    CHECK_FEATURE_1_2(descriptorBindingUniformBufferUpdateAfterBind);
+    CHECK_FEATURE_1_2(descriptorBindingSampledImageUpdateAfterBind);
+    CHECK_FEATURE_1_2(descriptorBindingStorageImageUpdateAfterBind);
+    CHECK_FEATURE_1_2(descriptorBindingStorageBufferUpdateAfterBind);
+    CHECK_FEATURE_1_2(descriptorBindingUniformTexelBufferUpdateAfterBind);
+    CHECK_FEATURE_1_2(descriptorBindingStorageTexelBufferUpdateAfterBind);
+    CHECK_FEATURE_1_2(descriptorBindingUpdateUnusedWhilePending);
+    CHECK_FEATURE_1_2(descriptorBindingPartiallyBound);
+    CHECK_FEATURE_1_2(descriptorBindingVariableDescriptorCount);
+    CHECK_FEATURE_1_2(runtimeDescriptorArray);
+    CHECK_FEATURE_1_2(samplerFilterMinmax);
+    CHECK_FEATURE_1_2(scalarBlockLayout);
+    CHECK_FEATURE_1_2(imagelessFramebuffer);
+    CHECK_FEATURE_1_2(uniformBufferStandardLayout);
+    CHECK_FEATURE_1_2(shaderSubgroupExtendedTypes);
+    CHECK_FEATURE_1_2(separateDepthStencilLayouts);
+    CHECK_FEATURE_1_2(hostQueryReset);
+    CHECK_FEATURE_1_2(timelineSemaphore);
+    CHECK_FEATURE_1_2(bufferDeviceAddress);
+    CHECK_FEATURE_1_2(bufferDeviceAddressCaptureReplay);
+    CHECK_FEATURE_1_2(bufferDeviceAddressMultiDevice);
+    CHECK_FEATURE_1_2(vulkanMemoryModel);
+    CHECK_FEATURE_1_2(vulkanMemoryModelDeviceScope);
+    CHECK_FEATURE_1_2(vulkanMemoryModelAvailabilityVisibilityChains);
+    CHECK_FEATURE_1_2(shaderOutputViewportIndex);
+    CHECK_FEATURE_1_2(shaderOutputLayer);
+    CHECK_FEATURE_1_2(subgroupBroadcastDynamicId);
+#undef CHECK_FEATURE_1_2
+#define CHECK_FEATURE_1_3(feature) CHECK_VULKAN_FEATURE(deviceFeatures13, vkFeatures13_, feature, "1.3 ");
+    CHECK_FEATURE_1_3(robustImageAccess);
+    CHECK_FEATURE_1_3(inlineUniformBlock);
+    CHECK_FEATURE_1_3(descriptorBindingInlineUniformBlockUpdateAfterBind);
+    CHECK_FEATURE_1_3(pipelineCreationCacheControl);
+    CHECK_FEATURE_1_3(privateData);
+    CHECK_FEATURE_1_3(shaderDemoteToHelperInvocation);
+    CHECK_FEATURE_1_3(shaderTerminateInvocation);
+    CHECK_FEATURE_1_3(subgroupSizeControl);
+    CHECK_FEATURE_1_3(computeFullSubgroups);
+    CHECK_FEATURE_1_3(synchronization2);
+    CHECK_FEATURE_1_3(textureCompressionASTC_HDR);
+    CHECK_FEATURE_1_3(shaderZeroInitializeWorkgroupMemory);
+    CHECK_FEATURE_1_3(dynamicRendering);
+    CHECK_FEATURE_1_3(shaderIntegerDotProduct);
+    CHECK_FEATURE_1_3(maintenance4);
+#undef CHECK_FEATURE_1_3
+    if (!missingFeatures.empty()) {
+      MINILOG_LOG_PROC(
+#ifndef __APPLE__
+          minilog::FatalError,
+#else
+          minilog::Warning,
+#endif
+          "Missing Vulkan features: %s\n",
+          missingFeatures.c_str());
+      // Do not exit here in case of MoltenVK, some 1.3 features are available via extensions.
+#ifndef __APPLE__
+      assert(false);
+      return Result(Result::Code::RuntimeError);
+#endif
+    }
+  }
+
+  const VkDeviceCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+      .pNext = createInfoNext,
+      .queueCreateInfoCount = numQueues,
+      .pQueueCreateInfos = ciQueue,
+      .enabledExtensionCount = (uint32_t)enabledDeviceExtensionNames_.size(),
+      .ppEnabledExtensionNames = enabledDeviceExtensionNames_.data(),
+      .pEnabledFeatures = &deviceFeatures10,
+  };
+  VK_ASSERT_RETURN(vkCreateDevice(vkPhysicalDevice_, &ci, nullptr, &vkDevice_));
+
+  volkLoadDevice(vkDevice_);
+
+  vkGetDeviceQueue(vkDevice_, deviceQueues_.graphicsQueueFamilyIndex, 0, &deviceQueues_.graphicsQueue);
+  vkGetDeviceQueue(vkDevice_, deviceQueues_.computeQueueFamilyIndex, 0, &deviceQueues_.computeQueue);
+  vkGetDeviceQueue(vkDevice_, deviceQueues_.transferQueueFamilyIndex, 0, &deviceQueues_.transferQueue);
+
+  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_DEVICE, (uint64_t)vkDevice_, "Device: VulkanContext::vkDevice_"));
+
+  immediate_ = std::make_unique<lvk::VulkanImmediateCommands>(vkDevice_,
+                                                              deviceQueues_.graphicsQueueFamilyIndex,
+                                                              QueueType_Graphics,
+                                                              has_EXT_device_fault_,
+                                                              "VulkanContext::immediate_",
+                                                              config_.maxCommandBuffers);
+  immediateCompute_ = std::make_unique<lvk::VulkanImmediateCommands>(vkDevice_,
+                                                                     deviceQueues_.computeQueueFamilyIndex,
+                                                                     QueueType_Compute,
+                                                                     has_EXT_device_fault_,
+                                                                     "VulkanContext::immediateCompute_",
+                                                                     config_.maxCommandBuffers);
+  immediateTransfer_ = std::make_unique<lvk::VulkanImmediateCommands>(vkDevice_,
+                                                                      deviceQueues_.transferQueueFamilyIndex,
+                                                                      QueueType_Transfer,
+                                                                      has_EXT_device_fault_,
+                                                                      "VulkanContext::immediateTransfer_",
+                                                                      config_.maxCommandBuffers);
+
+  // create Vulkan pipeline cache
+  {
+    std::vector<uint8_t> cacheData;
+    if (!pimpl_->pipelineCacheFileName_.empty() && !config_.pipelineCacheData) {
+      cacheData = loadPipelineCacheFile(pimpl_->pipelineCacheFileName_.c_str(), vkPhysicalDeviceProperties2_.properties);
+    }
+    const VkPipelineCacheCreateInfo ci = {
+        VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        nullptr,
+        VkPipelineCacheCreateFlags(0),
+        cacheData.empty() ? config_.pipelineCacheDataSize : cacheData.size(),
+        cacheData.empty() ? config_.pipelineCacheData : cacheData.data(),
+    };
+    vkCreatePipelineCache(vkDevice_, &ci, nullptr, &pipelineCache_);
+  }
+
+  if (LVK_VULKAN_USE_VMA) {
+    pimpl_->vma_ = lvk::createVmaAllocator(vkPhysicalDevice_,
+                                           vkDevice_,
+                                           vkInstance_,
+                                           apiVersion > VK_API_VERSION_1_3 ? VK_API_VERSION_1_3 : apiVersion,
+                                           has_EXT_memory_budget_);
+    LVK_ASSERT(pimpl_->vma_ != VK_NULL_HANDLE);
+  }
+
+  if (has_sparseResidency_) {
+    pimpl_->sparseTimelineSemaphore_ = lvk::createSemaphoreTimeline(vkDevice_, 0, "Semaphore: sparseTimelineSemaphore_");
+  }
+
+  stagingDevice_ = std::make_unique<lvk::VulkanStagingDevice>(*this, *immediate_);
+  stagingDeviceAsync_ = std::make_unique<lvk::VulkanStagingDevice>(*this, *immediateTransfer_);
+  transientAllocator_ = std::make_unique<lvk::VulkanTransientAllocator>(*this);
+
+  // default texture
+  {
+    const uint32_t pixel = 0xFF000000;
+    Result result;
+    dummyTexture_ = this->createTexture(
+                            {
+                                .format = lvk::Format_RGBA_UN8,
+                                .dimensions = {1, 1, 1},
+                                .usage = TextureUsageBits_Sampled | TextureUsageBits_Storage,
+                                .data = &pixel,
+                                .isShared = true,
+                            },
+                            "Dummy 1x1 (black)",
+                            &result)
+                        .release();
+    if (!LVK_VERIFY(result.isOk())) {
+      return result;
+    }
+    LVK_ASSERT(texturesPool_.numObjects() == 1);
+  }
+
+  // default sampler
+  LVK_ASSERT(samplersPool_.numObjects() == 0);
+  createSampler(
+      {
+          .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+          .pNext = nullptr,
+          .flags = 0,
+          .magFilter = VK_FILTER_LINEAR,
+          .minFilter = VK_FILTER_LINEAR,
+          .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+          .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+          .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+          .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+          .mipLodBias = 0.0f,
+          .anisotropyEnable = VK_FALSE,
+          .maxAnisotropy = 0.0f,
+          .compareEnable = VK_FALSE,
+          .compareOp = VK_COMPARE_OP_ALWAYS,
+          .minLod = 0.0f,
+          .maxLod = static_cast<float>(LVK_MAX_MIP_LEVELS - 1),
+          .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
+          .unnormalizedCoordinates = VK_FALSE,
+      },
+      nullptr,
+      Format_Invalid,
+      "Sampler: default");
+
+  querySurfaceCapabilities();
+
+#if defined(LVK_WITH_TRACY_GPU)
+  std::vector<VkTimeDomainEXT> timeDomains;
+
+  if (has_KHR_calibrated_timestamps_) {
+    uint32_t numTimeDomains = 0;
+    VK_ASSERT(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(vkPhysicalDevice_, &numTimeDomains, nullptr));
+    timeDomains.resize(numTimeDomains);
+    VK_ASSERT(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(vkPhysicalDevice_, &numTimeDomains, timeDomains.data()));
+  }
+
+  const bool hasHostQuery = vkFeatures12_.hostQueryReset && [&timeDomains]() -> bool {
+    for (VkTimeDomainEXT domain : timeDomains)
+      if (domain == VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_EXT || domain == VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT)
+        return true;
+    return false;
+  }();
+
+  if (hasHostQuery) {
+    pimpl_->tracyVkCtx_ = TracyVkContextHostCalibrated(
+        vkPhysicalDevice_, vkDevice_, vkResetQueryPool, vkGetPhysicalDeviceCalibrateableTimeDomainsEXT, vkGetCalibratedTimestampsEXT);
+  } else {
+    const VkCommandPoolCreateInfo ciCommandPool = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = deviceQueues_.graphicsQueueFamilyIndex,
+    };
+    VK_ASSERT(vkCreateCommandPool(vkDevice_, &ciCommandPool, nullptr, &pimpl_->tracyCommandPool_));
+    VK_ASSERT(lvk::setDebugObjectName(
+        vkDevice_, VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)pimpl_->tracyCommandPool_, "Command Pool: VulkanContextImpl::tracyCommandPool_"));
+    const VkCommandBufferAllocateInfo aiCommandBuffer = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = pimpl_->tracyCommandPool_,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1,
+    };
+    VK_ASSERT(vkAllocateCommandBuffers(vkDevice_, &aiCommandBuffer, &pimpl_->tracyCommandBuffer_));
+    if (has_KHR_calibrated_timestamps_) {
+      pimpl_->tracyVkCtx_ = TracyVkContextCalibrated(vkPhysicalDevice_,
+                                                     vkDevice_,
+                                                     deviceQueues_.graphicsQueue,
+                                                     pimpl_->tracyCommandBuffer_,
+                                                     vkGetPhysicalDeviceCalibrateableTimeDomainsEXT,
+                                                     vkGetCalibratedTimestampsEXT);
+    } else {
+      pimpl_->tracyVkCtx_ = TracyVkContext(vkPhysicalDevice_, vkDevice_, deviceQueues_.graphicsQueue, pimpl_->tracyCommandBuffer_);
+    };
+  }
+  LVK_ASSERT(pimpl_->tracyVkCtx_);
+#endif // LVK_WITH_TRACY_GPU
+
+  // add one empty dset
+  DSets_.push_back({});
+
+  // create one separate DSL for input attachments
+  {
+    VkDescriptorSetLayoutBinding bindings[LVK_MAX_COLOR_ATTACHMENTS];
+    for (uint32_t i = 0; i != LVK_ARRAY_NUM_ELEMENTS(bindings); i++) {
+      bindings[i] = lvk::getDSLBinding(i, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+    };
+    const VkPhysicalDeviceLimits& limits = this->getVkPhysicalDeviceProperties().limits;
+    const VkDescriptorSetLayoutCreateInfo dslci = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT |
+                 (has_EXT_descriptor_buffer_ ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u),
+        .bindingCount = std::min((uint32_t)LVK_MAX_COLOR_ATTACHMENTS, limits.maxPerStageDescriptorInputAttachments),
+        .pBindings = bindings,
+    };
+    VK_ASSERT(vkCreateDescriptorSetLayout(vkDevice_, &dslci, nullptr, &dslInputAttachments_));
+    VK_ASSERT(lvk::setDebugObjectName(vkDevice_,
+                                      VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+                                      (uint64_t)dslInputAttachments_,
+                                      "Descriptor Set Layout: VulkanContext::dslInputAttachments_"));
+  }
+
+  if (has_EXT_descriptor_buffer_) {
+    const Result result = createDescriptorBuffer();
+    if (!result.isOk()) {
+      return result;
+    }
+  }
+
+  return Result();
+}
+
+lvk::Result lvk::VulkanContext::initSwapchain(uint32_t width, uint32_t height) {
+  if (!vkDevice_ || !immediate_) {
+    LLOGW("Call initContext() first");
+    return Result(Result::Code::RuntimeError, "Call initContext() first");
+  }
+
+  if (swapchain_) {
+    // destroy the old swapchain first
+    // TODO: replace with VK_EXT_swapchain_maintenance1
+    VK_ASSERT(vkDeviceWaitIdle(vkDevice_));
+    swapchain_ = nullptr;
+    vkDestroySemaphore(vkDevice_, timelineSemaphore_, nullptr);
+  }
+
+  if (!width || !height) {
+    return Result(Result::Code::ArgumentOutOfRange, "Width and Height cannot be 0");
+  }
+
+  swapchain_ = std::make_unique<lvk::VulkanSwapchain>(*this, width, height);
+
+  timelineSemaphore_ = lvk::createSemaphoreTimeline(vkDevice_, swapchain_->getNumSwapchainImages() - 1, "Semaphore: timelineSemaphore_");
+
+  return swapchain_ ? Result() : Result(Result::Code::RuntimeError, "Failed to create swapchain");
+}
+
+lvk::Result lvk::VulkanContext::growDescriptorPool(VulkanContext::DescriptorSet& dset,
+                                                   uint32_t maxTextures,
+                                                   uint32_t maxSamplers,
+                                                   uint32_t maxAccelStructs) {
+  if (maxTextures == dset.maxTextures && maxSamplers == dset.maxSamplers && maxAccelStructs == dset.maxAccelStructs &&
+      !awaitingNewImmutableSamplers_) {
+    return Result();
+  }
+
+  dset.maxTextures = maxTextures;
+  dset.maxSamplers = maxSamplers;
+  dset.maxAccelStructs = maxAccelStructs;
+
+#if LVK_VULKAN_PRINT_COMMANDS
+  LLOGL("growDescriptorPool(%u, %u)\n", maxTextures, maxSamplers);
+#endif // LVK_VULKAN_PRINT_COMMANDS
+
+  if (!LVK_VERIFY(maxTextures <= vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSampledImages)) {
+    LLOGW("Max Textures exceeded: %u (max %u)",
+          maxTextures,
+          vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSampledImages);
+  }
+
+  if (!LVK_VERIFY(maxSamplers <= vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSamplers)) {
+    LLOGW("Max Samplers exceeded %u (max %u)", maxSamplers, vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSamplers);
+  }
+
+  if (dset.vkDSL != VK_NULL_HANDLE) {
+    deferredDestroy(DeferredObjectType_DescriptorSetLayout, (uint64_t)dset.vkDSL);
+  }
+  if (dset.vkDPool != VK_NULL_HANDLE) {
+    deferredDestroy(DeferredObjectType_DescriptorPool, (uint64_t)dset.vkDPool);
+  }
+
+  VkSampler firstYcbcrSampler = VK_NULL_HANDLE;
+
+  // check if we have any YUV images
+  for (const auto& obj : texturesPool_.objects_) {
+    const VulkanImage* img = &obj.obj_;
+    // multisampled images cannot be directly accessed from shaders
+    const bool isTextureAvailable = (img->vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
+    const bool isYUVImage = isTextureAvailable && img->isSampledImage() && lvk::getNumImagePlanes(img->vkImageFormat_) > 1;
+    if (isYUVImage) {
+      // find the first Ycbcr sampler and use it as a dummy
+      // (https://docs.vulkan.org/spec/latest/chapters/descriptorsets.html#VUID-VkDescriptorSetLayoutBinding-descriptorType-12200)
+      firstYcbcrSampler = getOrCreateYcbcrSampler(vkFormatToFormat(img->vkImageFormat_));
+      break;
+    }
+  }
+
+  std::vector<VkSampler> immutableSamplers;
+  const VkSampler* immutableSamplersData = nullptr;
+
+  // immutable samplers cannot be updated in place, so creating a new YUV texture recreates the layout anyway: the YUV binding covers
+  // only the existing textures instead of the whole reserved capacity
+  dset.maxYUVImages = firstYcbcrSampler ? (uint32_t)texturesPool_.objects_.size() : 0;
+
+  if (firstYcbcrSampler) {
+    immutableSamplers.resize(dset.maxYUVImages, firstYcbcrSampler);
+    for (size_t i = 0; i != texturesPool_.objects_.size(); i++) {
+      const auto& obj = texturesPool_.objects_[i];
+      const VulkanImage* img = &obj.obj_;
+      // multisampled images cannot be directly accessed from shaders
+      const bool isTextureAvailable = (img->vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
+      const bool isYUVImage = isTextureAvailable && img->isSampledImage() && lvk::getNumImagePlanes(img->vkImageFormat_) > 1;
+      immutableSamplers[i] = isYUVImage ? getOrCreateYcbcrSampler(vkFormatToFormat(img->vkImageFormat_)) : firstYcbcrSampler;
+    }
+    immutableSamplersData = immutableSamplers.data();
+  }
+
+  // create default descriptor set layout which is going to be shared by graphics pipelines
+  const VkShaderStageFlags stageFlags = getBindlessShaderStageFlags(has_KHR_ray_tracing_pipeline_);
+  const VkDescriptorSetLayoutBinding bindings[kBinding_NumBindings] = {
+      lvk::getDSLBinding(kBinding_Textures, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures, stageFlags),
+      lvk::getDSLBinding(kBinding_Samplers, VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers, stageFlags),
+      lvk::getDSLBinding(kBinding_StorageImages, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxTextures, stageFlags),
+      lvk::getDSLBinding(
+          kBinding_YUVImages, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, dset.maxYUVImages, stageFlags, immutableSamplersData),
+      lvk::getDSLBinding(kBinding_AccelerationStructures, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, maxAccelStructs, stageFlags),
+  };
+  const uint32_t flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                         VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+  VkDescriptorBindingFlags bindingFlags[kBinding_NumBindings];
+  for (int i = 0; i < kBinding_NumBindings; ++i) {
+    bindingFlags[i] = flags;
+  }
+  const VkDescriptorSetLayoutBindingFlagsCreateInfo setLayoutBindingFlagsCI = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT,
+      .bindingCount = uint32_t(has_KHR_acceleration_structure_ ? kBinding_NumBindings : kBinding_NumBindings - 1),
+      .pBindingFlags = bindingFlags,
+  };
+  const VkDescriptorSetLayoutCreateInfo dslci = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .pNext = &setLayoutBindingFlagsCI,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT,
+      .bindingCount = uint32_t(has_KHR_acceleration_structure_ ? kBinding_NumBindings : kBinding_NumBindings - 1),
+      .pBindings = bindings,
+  };
+  VK_ASSERT(vkCreateDescriptorSetLayout(vkDevice_, &dslci, nullptr, &dset.vkDSL));
+  VK_ASSERT(lvk::setDebugObjectName(
+      vkDevice_, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)dset.vkDSL, "Descriptor Set Layout: VulkanContext::vkDSL"));
+
+  {
+    // create default descriptor pool and allocate 1 descriptor set
+    VkDescriptorPoolSize poolSizes[kBinding_NumBindings] = {
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxTextures},
+    };
+    uint32_t numPoolSizes = 3;
+    if (!immutableSamplers.empty()) {
+      poolSizes[numPoolSizes++] = VkDescriptorPoolSize{
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          pimpl_->maxCombinedImageSamplerDescriptorCount_ * dset.maxYUVImages,
+      };
+    }
+    if (has_KHR_acceleration_structure_) {
+      poolSizes[numPoolSizes++] = VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, maxAccelStructs};
+    }
+    LVK_ASSERT(numPoolSizes <= kBinding_NumBindings);
+    const VkDescriptorPoolCreateInfo ci = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = numPoolSizes,
+        .pPoolSizes = poolSizes,
+    };
+    VK_ASSERT_RETURN(vkCreateDescriptorPool(vkDevice_, &ci, nullptr, &dset.vkDPool));
+    const VkDescriptorSetAllocateInfo ai = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = dset.vkDPool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &dset.vkDSL,
+    };
+    VK_ASSERT_RETURN(vkAllocateDescriptorSets(vkDevice_, &ai, &dset.vkDSet));
+  }
+
+  awaitingNewImmutableSamplers_ = false;
+
+  return Result();
+}
+
+lvk::Result lvk::VulkanContext::createDescriptorBuffer() {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  LVK_ASSERT(has_EXT_descriptor_buffer_);
+  LVK_ASSERT(DSets_.size() == 1 && DSets_[0].vkDSL == VK_NULL_HANDLE);
+
+  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
+
+  // descriptor buffers cannot grow without rebinding, so the capacity is fixed upfront
+  DescriptorSet& dset = DSets_[0];
+  dset.maxTextures = std::min({config_.maxBindlessTextures,
+                               limits.maxPerStageDescriptorSampledImages,
+                               limits.maxPerStageDescriptorStorageImages,
+                               limits.maxDescriptorSetSampledImages,
+                               limits.maxDescriptorSetStorageImages});
+  dset.maxSamplers = std::min({config_.maxBindlessSamplers, limits.maxPerStageDescriptorSamplers, limits.maxDescriptorSetSamplers});
+  dset.maxAccelStructs = has_KHR_acceleration_structure_ ? std::min(config_.maxBindlessAccelStructs,
+                                                                    accelerationStructureProperties_.maxDescriptorSetAccelerationStructures)
+                                                         : 0u;
+
+  const VkShaderStageFlags stageFlags = getBindlessShaderStageFlags(has_KHR_ray_tracing_pipeline_);
+
+  // YUV images require immutable samplers baked into the layout, which would defeat a fixed layout
+  const VkDescriptorSetLayoutBinding bindings[kBinding_NumBindings] = {
+      lvk::getDSLBinding(kBinding_Textures, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, dset.maxTextures, stageFlags),
+      lvk::getDSLBinding(kBinding_Samplers, VK_DESCRIPTOR_TYPE_SAMPLER, dset.maxSamplers, stageFlags),
+      lvk::getDSLBinding(kBinding_StorageImages, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, dset.maxTextures, stageFlags),
+      lvk::getDSLBinding(kBinding_YUVImages, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, stageFlags),
+      lvk::getDSLBinding(kBinding_AccelerationStructures, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, dset.maxAccelStructs, stageFlags),
+  };
+  const uint32_t numBindings = has_KHR_acceleration_structure_ ? kBinding_NumBindings : kBinding_NumBindings - 1;
+  const VkDescriptorSetLayoutCreateInfo dslci = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+      .bindingCount = numBindings,
+      .pBindings = bindings,
+  };
+  VK_ASSERT_RETURN(vkCreateDescriptorSetLayout(vkDevice_, &dslci, nullptr, &dset.vkDSL));
+  VK_ASSERT(lvk::setDebugObjectName(
+      vkDevice_, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)dset.vkDSL, "Descriptor Set Layout: VulkanContext::vkDSL (buffer)"));
+
+  VkDeviceSize size = 0;
+  vkGetDescriptorSetLayoutSizeEXT(vkDevice_, dset.vkDSL, &size);
+  for (uint32_t i = 0; i != numBindings; i++) {
+    vkGetDescriptorSetLayoutBindingOffsetEXT(vkDevice_, dset.vkDSL, i, &descriptorBufferBindingOffsets_[i]);
+  }
+
+  descriptorBufferUsage_ = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                           VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  if (!descriptorBufferProperties_.bufferlessPushDescriptors) {
+    // push descriptors for input attachments are stored in the bound descriptor buffer
+    descriptorBufferUsage_ |= VK_BUFFER_USAGE_PUSH_DESCRIPTORS_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
+
+  Result result;
+  descriptorBuffer_ = createBuffer(getAlignedSize(size, descriptorBufferProperties_.descriptorBufferOffsetAlignment),
+                                   descriptorBufferUsage_,
+                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                   &result,
+                                   "Buffer: VulkanContext::descriptorBuffer_",
+                                   true);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  LLOGL("Descriptor buffer: %u textures, %u samplers, %u acceleration structures (%u bytes)\n",
+        dset.maxTextures,
+        dset.maxSamplers,
+        dset.maxAccelStructs,
+        (uint32_t)size);
+
+  return Result();
+}
+
+void lvk::VulkanContext::updateDescriptorBuffer() {
+  const DescriptorSet& dset = DSets_[0];
+  const lvk::VulkanBuffer* buf = buffersPool_.get(descriptorBuffer_);
+
+  LVK_ASSERT(buf && buf->isMapped());
+
+  std::vector<DescriptorRange> rangesTextures;
+  std::vector<DescriptorRange> rangesSamplers;
+  std::vector<DescriptorRange> rangesAccelStructs;
+
+  getDirtyDescriptorRanges(dirtyTextures_, rangesTextures);
+  getDirtyDescriptorRanges(dirtySamplers_, rangesSamplers);
+  getDirtyDescriptorRanges(dirtyAccelStructs_, rangesAccelStructs);
+
+  uint8_t* mappedPtr = buf->getMappedPtr();
+
+  auto writeDescriptor = [this, mappedPtr](VkDescriptorType type, VkDescriptorDataEXT data, uint32_t binding, uint32_t index, size_t size) {
+    const VkDescriptorGetInfoEXT info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+        .type = type,
+        .data = data,
+    };
+    vkGetDescriptorEXT(vkDevice_, &info, size, mappedPtr + descriptorBufferBindingOffsets_[binding] + index * size);
+  };
+
+  // use dummies to avoid sparse arrays
+  const VkImageView dummyImageView = texturesPool_.objects_[0].obj_.imageView_;
+  const VkSampler dummySampler = samplersPool_.objects_[0].obj_;
+
+  for (const DescriptorRange& r : rangesTextures) {
+    for (uint32_t i = r.first; i != r.first + r.count; i++) {
+      if (!LVK_VERIFY(i < dset.maxTextures)) {
+        LLOGW("Max Textures exceeded: %u (max %u)\n", i + 1, dset.maxTextures);
+        break;
+      }
+      const VulkanImage& img = texturesPool_.objects_[i].obj_;
+      const VkImageView view = img.imageView_;
+      const VkImageView storageView = img.imageViewStorage_ ? img.imageViewStorage_ : view;
+      // multisampled images cannot be directly accessed from shaders
+      const bool isTextureAvailable = (img.vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
+      const bool isYUVImage = isTextureAvailable && img.isSampledImage() && lvk::getNumImagePlanes(img.vkImageFormat_) > 1;
+      const bool isSampledImage = isTextureAvailable && img.isSampledImage() && !isYUVImage;
+      const bool isStorageImage = isTextureAvailable && img.isStorageImage();
+      if (isYUVImage && !hasWarnedDescriptorBufferYUV_) {
+        LLOGW("YUV textures are not supported with VK_EXT_descriptor_buffer\n");
+        hasWarnedDescriptorBufferYUV_ = true;
+      }
+      const VkDescriptorImageInfo infoSampledImage = {
+          .sampler = VK_NULL_HANDLE,
+          .imageView = isSampledImage ? view : dummyImageView,
+          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      };
+      const VkDescriptorImageInfo infoStorageImage = {
+          .sampler = VK_NULL_HANDLE,
+          .imageView = isStorageImage ? storageView : dummyImageView,
+          .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+      };
+      writeDescriptor(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                      {.pSampledImage = &infoSampledImage},
+                      kBinding_Textures,
+                      i,
+                      descriptorBufferProperties_.sampledImageDescriptorSize);
+      writeDescriptor(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                      {.pStorageImage = &infoStorageImage},
+                      kBinding_StorageImages,
+                      i,
+                      descriptorBufferProperties_.storageImageDescriptorSize);
+    }
+  }
+
+  for (const DescriptorRange& r : rangesSamplers) {
+    for (uint32_t i = r.first; i != r.first + r.count; i++) {
+      if (!LVK_VERIFY(i < dset.maxSamplers)) {
+        LLOGW("Max Samplers exceeded: %u (max %u)\n", i + 1, dset.maxSamplers);
+        break;
+      }
+      const VkSampler sampler = samplersPool_.objects_[i].obj_ ? samplersPool_.objects_[i].obj_ : dummySampler;
+      writeDescriptor(
+          VK_DESCRIPTOR_TYPE_SAMPLER, {.pSampler = &sampler}, kBinding_Samplers, i, descriptorBufferProperties_.samplerDescriptorSize);
+    }
+  }
+
+  // use the first valid TLAS as a dummy
+  const VkDeviceAddress dummyTLAS = [this]() -> VkDeviceAddress {
+    for (const auto& as : accelStructuresPool_.objects_) {
+      if (as.obj_.vkHandle && as.obj_.isTLAS)
+        return as.obj_.deviceAddress;
+    }
+    return 0;
+  }();
+
+  for (const DescriptorRange& r : rangesAccelStructs) {
+    for (uint32_t i = r.first; i != r.first + r.count && dummyTLAS; i++) {
+      if (!LVK_VERIFY(i < dset.maxAccelStructs)) {
+        LLOGW("Max Acceleration Structures exceeded: %u (max %u)\n", i + 1, dset.maxAccelStructs);
+        break;
+      }
+      const AccelerationStructure& as = accelStructuresPool_.objects_[i].obj_;
+      writeDescriptor(VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+                      {.accelerationStructure = as.isTLAS && as.vkHandle ? as.deviceAddress : dummyTLAS},
+                      kBinding_AccelerationStructures,
+                      i,
+                      descriptorBufferProperties_.accelerationStructureDescriptorSize);
+    }
+  }
+
+  if (!buf->isCoherentMemory_) {
+    buf->flushMappedMemory(*this, 0, VK_WHOLE_SIZE);
+  }
+}
+
+lvk::BufferHandle lvk::VulkanContext::createBuffer(VkDeviceSize bufferSize,
+                                                   VkBufferUsageFlags usageFlags,
+                                                   VkMemoryPropertyFlags memFlags,
+                                                   lvk::Result* outResult,
+                                                   const char* debugName,
+                                                   bool isShared) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  LVK_ASSERT(bufferSize > 0);
+
+#define ENSURE_BUFFER_SIZE(flag, maxSize)                                                             \
+  if (usageFlags & flag) {                                                                            \
+    if (!LVK_VERIFY(bufferSize <= maxSize)) {                                                         \
+      Result::setResult(outResult, Result(Result::Code::RuntimeError, "Buffer size exceeded" #flag)); \
+      return {};                                                                                      \
+    }                                                                                                 \
+  }
+
+  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
+
+  ENSURE_BUFFER_SIZE(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, limits.maxUniformBufferRange);
+  ENSURE_BUFFER_SIZE(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, limits.maxStorageBufferRange);
+  // any buffer
+  ENSURE_BUFFER_SIZE(VK_BUFFER_USAGE_FLAG_BITS_MAX_ENUM, vkPhysicalDeviceVulkan11Properties_.maxMemoryAllocationSize);
+#undef ENSURE_BUFFER_SIZE
+
+  VulkanBuffer buf = {
+      .bufferSize_ = bufferSize,
+      .vkUsageFlags_ = usageFlags,
+      .vkMemFlags_ = memFlags,
+      .isShared_ = isShared,
+  };
+
+  if (usageFlags & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR) {
+    buf.memoryCategory_ = MemoryCategory_AccelStruct;
+  } else if (usageFlags & (VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT)) {
+    buf.memoryCategory_ = MemoryCategory_Descriptors;
+  } else if (!(usageFlags & ~(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))) {
+    // buffers created from BufferDesc always have some usage flags beyond transfers
+    buf.memoryCategory_ = MemoryCategory_Staging;
+  }
+
+  // shared buffers can be accessed from the graphics, async compute, and transfer queues without ownership transfers
+  const bool isConcurrentSharing = isShared && numSharedQueueFamilyIndices_ > 1;
+
+  const VkBufferCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .size = bufferSize,
+      .usage = usageFlags,
+      .sharingMode = isConcurrentSharing ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+      .queueFamilyIndexCount = isConcurrentSharing ? numSharedQueueFamilyIndices_ : 0u,
+      .pQueueFamilyIndices = isConcurrentSharing ? sharedQueueFamilyIndices_ : nullptr,
+  };
+
+  if (LVK_VULKAN_USE_VMA) {
+    VmaAllocationCreateInfo vmaAllocInfo = {};
+
+    // Initialize VmaAllocation Info
+    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+      vmaAllocInfo = {
+          .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+          .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+          .preferredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+      };
+    }
+
+    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+      // Check if coherent buffer is available.
+      VK_ASSERT(vkCreateBuffer(vkDevice_, &ci, nullptr, &buf.vkBuffer_));
+      VkMemoryRequirements requirements = {};
+      vkGetBufferMemoryRequirements(vkDevice_, buf.vkBuffer_, &requirements);
+      vkDestroyBuffer(vkDevice_, buf.vkBuffer_, nullptr);
+      buf.vkBuffer_ = VK_NULL_HANDLE;
+
+      if (requirements.memoryTypeBits & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+        vmaAllocInfo.requiredFlags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        buf.isCoherentMemory_ = true;
+      }
+    }
+
+    vmaAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+    vmaCreateBufferWithAlignment((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, 16, &buf.vkBuffer_, &buf.vmaAllocation_, nullptr);
+
+    // handle memory-mapped buffers
+    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+      vmaMapMemory((VmaAllocator)getVmaAllocator(), buf.vmaAllocation_, &buf.mappedPtr_);
+    }
+  } else {
+    // create buffer
+    VK_ASSERT(vkCreateBuffer(vkDevice_, &ci, nullptr, &buf.vkBuffer_));
+
+    // back the buffer with some memory
+    {
+      const VkBufferMemoryRequirementsInfo2 ri = {
+          .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2,
+          .buffer = buf.vkBuffer_,
+      };
+      VkMemoryRequirements2 requirements = {
+          .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+      };
+      vkGetBufferMemoryRequirements2(vkDevice_, &ri, &requirements);
+      if (requirements.memoryRequirements.memoryTypeBits & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+        buf.isCoherentMemory_ = true;
+      }
+
+      VK_ASSERT(lvk::allocateMemory2(vkPhysicalDevice_, vkDevice_, &requirements, memFlags, &buf.vkMemory_));
+      VK_ASSERT(vkBindBufferMemory(vkDevice_, buf.vkBuffer_, buf.vkMemory_, 0));
+    }
+
+    // handle memory-mapped buffers
+    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+      VK_ASSERT(vkMapMemory(vkDevice_, buf.vkMemory_, 0, buf.bufferSize_, 0, &buf.mappedPtr_));
+    }
+  }
+
+  LVK_ASSERT(buf.vkBuffer_ != VK_NULL_HANDLE);
+
+  // set debug name
+  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_BUFFER, (uint64_t)buf.vkBuffer_, debugName));
+
+  // handle shader access
+  if (usageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+    const VkBufferDeviceAddressInfo ai = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = buf.vkBuffer_,
+    };
+    buf.vkDeviceAddress_ = vkGetBufferDeviceAddress(vkDevice_, &ai);
+    LVK_ASSERT(buf.vkDeviceAddress_);
+  }
+
+  const MemoryCategory memoryCategory = buf.memoryCategory_;
+  const VkDeviceSize bufferSize = buf.bufferSize_;
+
+  const BufferHandle handle = buffersPool_.create(std::move(buf));
+
+  if (handle.empty()) {
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create Buffer: the pool is full");
+    return {};
+  }
+
+  trackMemory(memoryCategory, bufferSize, true);
+
+  return handle;
+}
+
+void lvk::VulkanContext::bindDescriptorBuffer(VkCommandBuffer cmdBuf) const {
+  LVK_ASSERT(has_EXT_descriptor_buffer_);
+
+  const VkDescriptorBufferBindingInfoEXT bi = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+      .address = buffersPool_.get(descriptorBuffer_)->vkDeviceAddress_,
+      .usage = descriptorBufferUsage_,
+  };
+  vkCmdBindDescriptorBuffersEXT(cmdBuf, 1, &bi);
+}
+
+void lvk::VulkanContext::bindDefaultDescriptorSets(VkCommandBuffer cmdBuf, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const {
+  LVK_PROFILER_FUNCTION();
+  if (has_EXT_descriptor_buffer_) {
+    // the descriptor buffer itself is bound by CommandBuffer::bindDefaultDescriptorSets()
+    // all 4 sets share the same layout and live at the beginning of the descriptor buffer
+    const uint32_t bufferIndices[4] = {0, 0, 0, 0};
+    const VkDeviceSize offsets[4] = {0, 0, 0, 0};
+    vkCmdSetDescriptorBufferOffsetsEXT(cmdBuf, bindPoint, layout, 0, 4, bufferIndices, offsets);
+    return;
+  }
+  const VkDescriptorSet dset = DSets_[lastUpdatedDSet_].vkDSet;
+  const VkDescriptorSet dsets[4] = {dset, dset, dset, dset};
+  vkCmdBindDescriptorSets(cmdBuf, bindPoint, layout, 0, (uint32_t)LVK_ARRAY_NUM_ELEMENTS(dsets), dsets, 0, nullptr);
+}
+
+void lvk::VulkanContext::checkAndUpdateDescriptorSets() {
+  if (!awaitingCreation_) {
+    // nothing to update here
+    return;
+  }
+
+  // newly created resources can be used immediately - make sure they are put into descriptor sets
+  LVK_PROFILER_FUNCTION();
+
+  std::lock_guard lock(descriptorsMutex_);
+
+  if (has_EXT_descriptor_buffer_) {
+    // the descriptor buffer has a fixed capacity and is written in place
+    updateDescriptorBuffer();
+    awaitingCreation_ = false;
+    return;
+  }
+
+  // make sure the guard values are always there
+  LVK_ASSERT(texturesPool_.numObjects() >= 1);
+  LVK_ASSERT(samplersPool_.numObjects() >= 1);
+
+  // the reserved capacity keeps the descriptor set layout stable, so that pipelines are not rebuilt when new resources are created
+  const VkPhysicalDeviceVulkan12Properties& props = vkPhysicalDeviceVulkan12Properties_;
+  const uint32_t reservedTextures = std::min({config_.maxBindlessTextures,
+                                              props.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                              props.maxPerStageDescriptorUpdateAfterBindStorageImages,
+                                              props.maxDescriptorSetUpdateAfterBindSampledImages,
+                                              props.maxDescriptorSetUpdateAfterBindStorageImages});
+  const uint32_t reservedSamplers = std::min(
+      {config_.maxBindlessSamplers, props.maxPerStageDescriptorUpdateAfterBindSamplers, props.maxDescriptorSetUpdateAfterBindSamplers});
+  const uint32_t reservedAccelStructs =
+      has_KHR_acceleration_structure_ ? std::min(config_.maxBindlessAccelStructs,
+                                                 accelerationStructureProperties_.maxDescriptorSetUpdateAfterBindAccelerationStructures)
+                                      : 0u;
+
+  uint32_t newMaxTextures = std::max({DSets_[lastUpdatedDSet_].maxTextures, reservedTextures, 16u});
+  uint32_t newMaxSamplers = std::max({DSets_[lastUpdatedDSet_].maxSamplers, reservedSamplers, 16u});
+  uint32_t newMaxAccelStructs = std::max({DSets_[lastUpdatedDSet_].maxAccelStructs, reservedAccelStructs, 1u});
+
+  while (texturesPool_.objects_.size() > newMaxTextures) {
+    newMaxTextures *= 2;
+  }
+  while (samplersPool_.objects_.size() > newMaxSamplers) {
+    newMaxSamplers *= 2;
+  }
+  while (accelStructuresPool_.objects_.size() > newMaxAccelStructs) {
+    newMaxAccelStructs *= 2;
+  }
+
+  const DescriptorSet& currentDSet = DSets_[lastUpdatedDSet_];
+
+  // the current dset is persistent and is updated in place (UPDATE_AFTER_BIND) unless its layout has to change
+  const bool needsNewDSet = !currentDSet.vkDSet || newMaxTextures != currentDSet.maxTextures ||
+                            newMaxSamplers != currentDSet.maxSamplers || newMaxAccelStructs != currentDSet.maxAccelStructs ||
+                            awaitingNewImmutableSamplers_;
+
+  if (currentDSet.vkDSet && needsNewDSet && !awaitingNewImmutableSamplers_) {
+    LLOGW("Bindless capacity exceeded (textures %u, samplers %u, acceleration structures %u) - all pipelines will be rebuilt\n",
+          newMaxTextures,
+          newMaxSamplers,
+          newMaxAccelStructs);
+  }
+
+  std::vector<DescriptorRange> rangesTextures;
+  std::vector<DescriptorRange> rangesSamplers;
+  std::vector<DescriptorRange> rangesAccelStructs;
+
+  if (needsNewDSet) {
+    lastUpdatedDSet_ = (lastUpdatedDSet_ + 1) % DSets_.size();
+
+    if (const DescriptorSet& dset = DSets_[lastUpdatedDSet_]; dset.vkDSet) {
+      // we can't reuse a dset that's either waiting to be submitted in a draw call
+      // (which happens when textures are created mid-frame) or is still being processed
+      if (dset.handle_.empty() || !immediate_->isReady(dset.handle_) || !immediateCompute_->isReady(dset.computeHandle_)) {
+        // add a new empty dset to be populated right away
+        lastUpdatedDSet_ = DSets_.size();
+        DSets_.push_back({});
+      }
+    }
+
+    DSets_[lastUpdatedDSet_].handle_ = {};
+    DSets_[lastUpdatedDSet_].computeHandle_ = {};
+
+    growDescriptorPool(DSets_[lastUpdatedDSet_], newMaxTextures, newMaxSamplers, newMaxAccelStructs);
+
+    // rewrite everything
+    rangesTextures.push_back({0, (uint32_t)texturesPool_.objects_.size()});
+    rangesSamplers.push_back({0, (uint32_t)samplersPool_.objects_.size()});
+    if (!accelStructuresPool_.objects_.empty()) {
+      rangesAccelStructs.push_back({0, (uint32_t)accelStructuresPool_.objects_.size()});
+    }
+    dirtyTextures_.clear();
+    dirtySamplers_.clear();
+    dirtyAccelStructs_.clear();
+  } else {
+    // write only new and changed slots
+    getDirtyDescriptorRanges(dirtyTextures_, rangesTextures);
+    getDirtyDescriptorRanges(dirtySamplers_, rangesSamplers);
+    getDirtyDescriptorRanges(dirtyAccelStructs_, rangesAccelStructs);
+  }
+
+  const DescriptorSet& dset = DSets_[lastUpdatedDSet_];
+
+  // 1. Sampled and storage images
+  std::vector<VkDescriptorImageInfo> infoSampledImages;
+  std::vector<VkDescriptorImageInfo> infoStorageImages;
+  std::vector<VkDescriptorImageInfo> infoYUVImages;
+
+  uint32_t numTextures = 0;
+  for (const DescriptorRange& r : rangesTextures) {
+    numTextures += r.count;
+  }
+
+  infoSampledImages.reserve(numTextures);
+  infoStorageImages.reserve(numTextures);
+
+  const bool hasYcbcrSamplers = pimpl_->numYcbcrSamplers_ > 0;
+
+  if (hasYcbcrSamplers) {
+    infoYUVImages.reserve(numTextures);
+  }
+
+  // use dummies to avoid sparse arrays
+  VkImageView dummyImageView = texturesPool_.objects_[0].obj_.imageView_;
+  VkSampler dummySampler = samplersPool_.objects_[0].obj_;
+
+  for (const DescriptorRange& r : rangesTextures) {
+    for (uint32_t i = r.first; i != r.first + r.count; i++) {
+      const VulkanImage& img = texturesPool_.objects_[i].obj_;
+      const VkImageView view = img.imageView_;
+      const VkImageView storageView = img.imageViewStorage_ ? img.imageViewStorage_ : view;
+      // multisampled images cannot be directly accessed from shaders
+      const bool isTextureAvailable = (img.vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
+      const bool isYUVImage = isTextureAvailable && img.isSampledImage() && lvk::getNumImagePlanes(img.vkImageFormat_) > 1;
+      const bool isSampledImage = isTextureAvailable && img.isSampledImage() && !isYUVImage;
+      const bool isStorageImage = isTextureAvailable && img.isStorageImage();
+      infoSampledImages.push_back(VkDescriptorImageInfo{
+          .sampler = VK_NULL_HANDLE,
+          .imageView = isSampledImage ? view : dummyImageView,
+          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      });
+      LVK_ASSERT(infoSampledImages.back().imageView != VK_NULL_HANDLE);
+      infoStorageImages.push_back(VkDescriptorImageInfo{
+          .sampler = VK_NULL_HANDLE,
+          .imageView = isStorageImage ? storageView : dummyImageView,
+          .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+      });
+      if (hasYcbcrSamplers) {
+        // we don't need to update this if there're no YUV samplers
+        infoYUVImages.push_back(VkDescriptorImageInfo{
+            .sampler = dummySampler, // this will be replaced by immutable samplers from VkPipeline
+            .imageView = isYUVImage ? view : dummyImageView,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        });
+      }
+    }
+  }
+
+  // 2. Samplers
+  std::vector<VkDescriptorImageInfo> infoSamplers;
+
+  for (const DescriptorRange& r : rangesSamplers) {
+    for (uint32_t i = r.first; i != r.first + r.count; i++) {
+      const VkSampler sampler = samplersPool_.objects_[i].obj_;
+      infoSamplers.push_back({
+          .sampler = sampler ? sampler : dummySampler,
+          .imageView = VK_NULL_HANDLE,
+          .imageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      });
+    }
+  }
+
+  // 3. Acceleration structures
+  std::vector<VkAccelerationStructureKHR> handlesAccelStructs;
+
+  // use the first valid TLAS as a dummy
+  const VkAccelerationStructureKHR dummyTLAS = [this]() -> VkAccelerationStructureKHR {
+    for (const auto& as : accelStructuresPool_.objects_) {
+      if (as.obj_.vkHandle && as.obj_.isTLAS)
+        return as.obj_.vkHandle;
     }
-  };
+    return VK_NULL_HANDLE;
+  }();
 
-  if (config_.vulkanVersion < VulkanVersion_1_4) {
-    addExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, nullptr);
-    addExtension(VK_KHR_MAINTENANCE_5_EXTENSION_NAME, &maintenance5Features);
-    addExtension(VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME, &dynamicRenderingLocalReadFeatures);
-    if (!addOptionalExtension(VK_KHR_INDEX_TYPE_UINT8_EXTENSION_NAME, has_8BitIndices_, &indexTypeUint8Features)) {
-      addOptionalExtension(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME, has_8BitIndices_, &indexTypeUint8Features);
+  for (const DescriptorRange& r : rangesAccelStructs) {
+    for (uint32_t i = r.first; i != r.first + r.count; i++) {
+      const AccelerationStructure& as = accelStructuresPool_.objects_[i].obj_;
+      handlesAccelStructs.push_back(as.isTLAS ? as.vkHandle : dummyTLAS);
     }
   }
-#if defined(LVK_WITH_TRACY)
-  addOptionalExtension(VK_KHR_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, has_KHR_calibrated_timestamps_, nullptr);
-#endif
-  addOptionalExtensions(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
-                        VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
-                        has_KHR_acceleration_structure_,
-                        &accelerationStructureFeatures);
-  addOptionalExtension(VK_KHR_RAY_QUERY_EXTENSION_NAME, has_KHR_ray_query_, &rayQueryFeatures);
-  addOptionalExtension(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME, has_KHR_ray_tracing_pipeline_, &rayTracingFeatures);
-  addOptionalExtension(
-      VK_EXT_RAY_TRACING_INVOCATION_REORDER_EXTENSION_NAME, has_EXT_ray_tracing_invocation_reorder, &rayTracingInvocationReorderFeatures);
-  if (!addOptionalExtension(
-          VK_KHR_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME, has_KHR_swapchain_maintenance1_, &swapchainMaintenance1Features)) {
-    addOptionalExtension(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME, has_KHR_swapchain_maintenance1_, &swapchainMaintenance1Features);
+
+  std::vector<VkWriteDescriptorSetAccelerationStructureKHR> writesAccelStructs;
+  writesAccelStructs.reserve(rangesAccelStructs.size()); // keep pointers stable
+
+  std::vector<VkWriteDescriptorSet> writes;
+
+  uint32_t offset = 0;
+
+  for (const DescriptorRange& r : rangesAccelStructs) {
+    writesAccelStructs.push_back(VkWriteDescriptorSetAccelerationStructureKHR{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
+        .accelerationStructureCount = r.count,
+        .pAccelerationStructures = handlesAccelStructs.data() + offset,
+    });
+    writes.push_back(VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext = &writesAccelStructs.back(),
+        .dstSet = dset.vkDSet,
+        .dstBinding = kBinding_AccelerationStructures,
+        .dstArrayElement = r.first,
+        .descriptorCount = r.count,
+        .descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+    });
+    offset += r.count;
   }
-  addOptionalExtension(VK_EXT_HDR_METADATA_EXTENSION_NAME, has_EXT_hdr_metadata_);
-  addOptionalExtension(VK_EXT_DEVICE_FAULT_EXTENSION_NAME, has_EXT_device_fault_, &deviceFaultFeatures);
-  addOptionalExtension(VK_EXT_SHADER_TILE_IMAGE_EXTENSION_NAME, has_EXT_shader_tile_image, &shaderTileImageFeatures);
-  addOptionalExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME, has_EXT_mesh_shader_, &meshShaderFeatures);
-  addOptionalExtension(VK_KHR_SHARED_PRESENTABLE_IMAGE_EXTENSION_NAME, has_KHR_shared_presentable_image_);
-  addOptionalExtension(
-      VK_KHR_PRESENT_MODE_FIFO_LATEST_READY_EXTENSION_NAME, has_KHR_present_mode_fifo_latest_ready_, &presentModeLatestReadyFeatures);
 
-  // check extensions
-  {
-    std::string missingExtensions;
-    for (const char* ext : enabledDeviceExtensionNames_) {
-      if (!hasExtension(ext, allDeviceExtensions))
-        missingExtensions += "\n   " + std::string(ext);
-    }
-    if (!missingExtensions.empty()) {
-      MINILOG_LOG_PROC(minilog::FatalError, "Missing Vulkan device extensions: %s\n", missingExtensions.c_str());
-      assert(false);
-      return Result(Result::Code::RuntimeError);
+  offset = 0;
+
+  for (const DescriptorRange& r : rangesTextures) {
+    writes.push_back(VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = dset.vkDSet,
+        .dstBinding = kBinding_Textures,
+        .dstArrayElement = r.first,
+        .descriptorCount = r.count,
+        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        .pImageInfo = infoSampledImages.data() + offset,
+    });
+    writes.push_back(VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = dset.vkDSet,
+        .dstBinding = kBinding_StorageImages,
+        .dstArrayElement = r.first,
+        .descriptorCount = r.count,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        .pImageInfo = infoStorageImages.data() + offset,
+    });
+    if (!infoYUVImages.empty() && r.first < dset.maxYUVImages) {
+      // textures created after the layout are not YUV textures - they would have recreated it
+      writes.push_back(VkWriteDescriptorSet{
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = dset.vkDSet,
+          .dstBinding = kBinding_YUVImages,
+          .dstArrayElement = r.first,
+          .descriptorCount = std::min(r.count, dset.maxYUVImages - r.first),
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .pImageInfo = infoYUVImages.data() + offset,
+      });
     }
+    offset += r.count;
   }
 
-  // check features
-  {
-    std::string missingFeatures;
-#define CHECK_VULKAN_FEATURE(reqFeatures, availFeatures, feature, version)     \
-  if ((reqFeatures.feature == VK_TRUE) && (availFeatures.feature == VK_FALSE)) \
-    missingFeatures.append("\n   " version " ." #feature);
-#define CHECK_FEATURE_1_0(feature) CHECK_VULKAN_FEATURE(deviceFeatures10, vkFeatures10_.features, feature, "1.0 ");
-    CHECK_FEATURE_1_0(robustBufferAccess);
-    CHECK_FEATURE_1_0(fullDrawIndexUint32);
-    CHECK_FEATURE_1_0(imageCubeArray);
-    CHECK_FEATURE_1_0(independentBlend);
-    CHECK_FEATURE_1_0(geometryShader);
-    CHECK_FEATURE_1_0(tessellationShader);
-    CHECK_FEATURE_1_0(sampleRateShading);
-    CHECK_FEATURE_1_0(dualSrcBlend);
-    CHECK_FEATURE_1_0(logicOp);
-    CHECK_FEATURE_1_0(multiDrawIndirect);
-    CHECK_FEATURE_1_0(drawIndirectFirstInstance);
-    CHECK_FEATURE_1_0(depthClamp);
-    CHECK_FEATURE_1_0(depthBiasClamp);
-    CHECK_FEATURE_1_0(fillModeNonSolid);
-    CHECK_FEATURE_1_0(depthBounds);
-    CHECK_FEATURE_1_0(wideLines);
-    CHECK_FEATURE_1_0(largePoints);
-    CHECK_FEATURE_1_0(alphaToOne);
-    CHECK_FEATURE_1_0(multiViewport);
-    CHECK_FEATURE_1_0(samplerAnisotropy);
-    CHECK_FEATURE_1_0(textureCompressionETC2);
-    CHECK_FEATURE_1_0(textureCompressionASTC_LDR);
-    CHECK_FEATURE_1_0(textureCompressionBC);
-    CHECK_FEATURE_1_0(occlusionQueryPrecise);
-    CHECK_FEATURE_1_0(pipelineStatisticsQuery);
-    CHECK_FEATURE_1_0(vertexPipelineStoresAndAtomics);
-    CHECK_FEATURE_1_0(fragmentStoresAndAtomics);
-    CHECK_FEATURE_1_0(shaderTessellationAndGeometryPointSize);
-    CHECK_FEATURE_1_0(shaderImageGatherExtended);
-    CHECK_FEATURE_1_0(shaderStorageImageExtendedFormats);
-    CHECK_FEATURE_1_0(shaderStorageImageMultisample);
-    CHECK_FEATURE_1_0(shaderStorageImageReadWithoutFormat);
-    CHECK_FEATURE_1_0(shaderStorageImageWriteWithoutFormat);
-    CHECK_FEATURE_1_0(shaderUniformBufferArrayDynamicIndexing);
-    CHECK_FEATURE_1_0(shaderSampledImageArrayDynamicIndexing);
-    CHECK_FEATURE_1_0(shaderStorageBufferArrayDynamicIndexing);
-    CHECK_FEATURE_1_0(shaderStorageImageArrayDynamicIndexing);
-    CHECK_FEATURE_1_0(shaderClipDistance);
-    CHECK_FEATURE_1_0(shaderCullDistance);
-    CHECK_FEATURE_1_0(shaderFloat64);
-    CHECK_FEATURE_1_0(shaderInt64);
-    CHECK_FEATURE_1_0(shaderInt16);
-    CHECK_FEATURE_1_0(shaderResourceResidency);
-    CHECK_FEATURE_1_0(shaderResourceMinLod);
-    CHECK_FEATURE_1_0(sparseBinding);
-    CHECK_FEATURE_1_0(sparseResidencyBuffer);
-    CHECK_FEATURE_1_0(sparseResidencyImage2D);
-    CHECK_FEATURE_1_0(sparseResidencyImage3D);
-    CHECK_FEATURE_1_0(sparseResidency2Samples);
-    CHECK_FEATURE_1_0(sparseResidency4Samples);
-    CHECK_FEATURE_1_0(sparseResidency8Samples);
-    CHECK_FEATURE_1_0(sparseResidency16Samples);
-    CHECK_FEATURE_1_0(sparseResidencyAliased);
-    CHECK_FEATURE_1_0(variableMultisampleRate);
-    CHECK_FEATURE_1_0(inheritedQueries);
-#undef CHECK_FEATURE_1_0
-#define CHECK_FEATURE_1_1(feature) CHECK_VULKAN_FEATURE(deviceFeatures11, vkFeatures11_, feature, "1.1 ");
-    CHECK_FEATURE_1_1(storageBuffer16BitAccess);
-    CHECK_FEATURE_1_1(uniformAndStorageBuffer16BitAccess);
-    CHECK_FEATURE_1_1(storagePushConstant16);
-    CHECK_FEATURE_1_1(storageInputOutput16);
-    CHECK_FEATURE_1_1(multiview);
-    CHECK_FEATURE_1_1(multiviewGeometryShader);
-    CHECK_FEATURE_1_1(multiviewTessellationShader);
-    CHECK_FEATURE_1_1(variablePointersStorageBuffer);
-    CHECK_FEATURE_1_1(variablePointers);
-    CHECK_FEATURE_1_1(protectedMemory);
-    CHECK_FEATURE_1_1(samplerYcbcrConversion);
-    CHECK_FEATURE_1_1(shaderDrawParameters);
-#undef CHECK_FEATURE_1_1
-#define CHECK_FEATURE_1_2(feature) CHECK_VULKAN_FEATURE(deviceFeatures12, vkFeatures12_, feature, "1.2 ");
-    CHECK_FEATURE_1_2(samplerMirrorClampToEdge);
-    CHECK_FEATURE_1_2(drawIndirectCount);
-    CHECK_FEATURE_1_2(storageBuffer8BitAccess);
-    CHECK_FEATURE_1_2(uniformAndStorageBuffer8BitAccess);
-    CHECK_FEATURE_1_2(storagePushConstant8);
-    CHECK_FEATURE_1_2(shaderBufferInt64Atomics);
-    CHECK_FEATURE_1_2(shaderSharedInt64Atomics);
-    CHECK_FEATURE_1_2(shaderFloat16);
-    CHECK_FEATURE_1_2(shaderInt8);
-    CHECK_FEATURE_1_2(descriptorIndexing);
-    CHECK_FEATURE_1_2(shaderInputAttachmentArrayDynamicIndexing);
-    CHECK_FEATURE_1_2(shaderUniformTexelBufferArrayDynamicIndexing);
-    CHECK_FEATURE_1_2(shaderStorageTexelBufferArrayDynamicIndexing);
-    CHECK_FEATURE_1_2(shaderUniformBufferArrayNonUniformIndexing);
-    CHECK_FEATURE_1_2(shaderSampledImageArrayNonUniformIndexing);
-    CHECK_FEATURE_1_2(shaderStorageBufferArrayNonUniformIndexing);
-    CHECK_FEATURE_1_2(shaderStorageImageArrayNonUniformIndexing);
-    CHECK_FEATURE_1_2(shaderInputAttachmentArrayNonUniformIndexing);
-    CHECK_FEATURE_1_2(shaderUniformTexelBufferArrayNonUniformIndexing);
-    CHECK_FEATURE_1_2(shaderStorageTexelBufferArrayNonUniformIndexing);
-    CHECK_FEATURE_1_2(descriptorBindingUniformBufferUpdateAfterBind);
-    CHECK_FEATURE_1_2(descriptorBindingSampledImageUpdateAfterBind);
-    CHECK_FEATURE_1_2(descriptorBindingStorageImageUpdateAfterBind);
-    CHECK_FEATURE_1_2(descriptorBindingStorageBufferUpdateAfterBind);
-    CHECK_FEATURE_1_2(descriptorBindingUniformTexelBufferUpdateAfterBind);
-    CHECK_FEATURE_1_2(descriptorBindingStorageTexelBufferUpdateAfterBind);
-    CHECK_FEATURE_1_2(descriptorBindingUpdateUnusedWhilePending);
-    CHECK_FEATURE_1_2(descriptorBindingPartiallyBound);
-    CHECK_FEATURE_1_2(descriptorBindingVariableDescriptorCount);
-    CHECK_FEATURE_1_2(runtimeDescriptorArray);
-    CHECK_FEATURE_1_2(samplerFilterMinmax);
-    CHECK_FEATURE_1_2(scalarBlockLayout);
-    CHECK_FEATURE_1_2(imagelessFramebuffer);
-    CHECK_FEATURE_1_2(uniformBufferStandardLayout);
-    CHECK_FEATURE_1_2(shaderSubgroupExtendedTypes);
-    CHECK_FEATURE_1_2(separateDepthStencilLayouts);
-    CHECK_FEATURE_1_2(hostQueryReset);
-    CHECK_FEATURE_1_2(timelineSemaphore);
-    CHECK_FEATURE_1_2(bufferDeviceAddress);
-    CHECK_FEATURE_1_2(bufferDeviceAddressCaptureReplay);
-    CHECK_FEATURE_1_2(bufferDeviceAddressMultiDevice);
-    CHECK_FEATURE_1_2(vulkanMemoryModel);
-    CHECK_FEATURE_1_2(vulkanMemoryModelDeviceScope);
-    CHECK_FEATURE_1_2(vulkanMemoryModelAvailabilityVisibilityChains);
-    CHECK_FEATURE_1_2(shaderOutputViewportIndex);
-    CHECK_FEATURE_1_2(shaderOutputLayer);
-    CHECK_FEATURE_1_2(subgroupBroadcastDynamicId);
-#undef CHECK_FEATURE_1_2
-#define CHECK_FEATURE_1_3(feature) CHECK_VULKAN_FEATURE(deviceFeatures13, vkFeatures13_, feature, "1.3 ");
-    CHECK_FEATURE_1_3(robustImageAccess);
-    CHECK_FEATURE_1_3(inlineUniformBlock);
-    CHECK_FEATURE_1_3(descriptorBindingInlineUniformBlockUpdateAfterBind);
-    CHECK_FEATURE_1_3(pipelineCreationCacheControl);
-    CHECK_FEATURE_1_3(privateData);
-    CHECK_FEATURE_1_3(shaderDemoteToHelperInvocation);
-    CHECK_FEATURE_1_3(shaderTerminateInvocation);
-    CHECK_FEATURE_1_3(subgroupSizeControl);
-    CHECK_FEATURE_1_3(computeFullSubgroups);
-    CHECK_FEATURE_1_3(synchronization2);
-    CHECK_FEATURE_1_3(textureCompressionASTC_HDR);
-    CHECK_FEATURE_1_3(shaderZeroInitializeWorkgroupMemory);
-    CHECK_FEATURE_1_3(dynamicRendering);
-    CHECK_FEATURE_1_3(shaderIntegerDotProduct);
-    CHECK_FEATURE_1_3(maintenance4);
-#undef CHECK_FEATURE_1_3
-    if (!missingFeatures.empty()) {
-      MINILOG_LOG_PROC(
-#ifndef __APPLE__
-          minilog::FatalError,
-#else
-          minilog::Warning,
-#endif
-          "Missing Vulkan features: %s\n",
-          missingFeatures.c_str());
-      // Do not exit here in case of MoltenVK, some 1.3 features are available via extensions.
-#ifndef __APPLE__
-      assert(false);
-      return Result(Result::Code::RuntimeError);
-#endif
-    }
+  offset = 0;
+
+  for (const DescriptorRange& r : rangesSamplers) {
+    writes.push_back(VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = dset.vkDSet,
+        .dstBinding = kBinding_Samplers,
+        .dstArrayElement = r.first,
+        .descriptorCount = r.count,
+        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+        .pImageInfo = infoSamplers.data() + offset,
+    });
+    offset += r.count;
+  }
+
+  if (!writes.empty()) {
+#if LVK_VULKAN_PRINT_COMMANDS
+    LLOGL("vkUpdateDescriptorSets(%u)\n", (uint32_t)writes.size());
+#endif // LVK_VULKAN_PRINT_COMMANDS
+    LVK_PROFILER_ZONE("vkUpdateDescriptorSets()", LVK_PROFILER_COLOR_PRESENT);
+    vkUpdateDescriptorSets(vkDevice_, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+    LVK_PROFILER_ZONE_END();
+  }
+
+  awaitingCreation_ = false;
+}
+
+lvk::SamplerHandle lvk::VulkanContext::createSampler(const VkSamplerCreateInfo& ci,
+                                                     lvk::Result* outResult,
+                                                     lvk::Format yuvFormat,
+                                                     const char* debugName) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  VkSamplerCreateInfo cinfo = ci;
+
+  if (yuvFormat != Format_Invalid) {
+    cinfo.pNext = getOrCreateYcbcrConversionInfo(yuvFormat);
+    // must be CLAMP_TO_EDGE
+    // https://vulkan.lunarg.com/doc/view/1.3.268.0/windows/1.3-extensions/vkspec.html#VUID-VkSamplerCreateInfo-addressModeU-01646
+    cinfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    cinfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    cinfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    cinfo.anisotropyEnable = VK_FALSE;
+    cinfo.unnormalizedCoordinates = VK_FALSE;
   }
 
-  const VkDeviceCreateInfo ci = {
-      .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-      .pNext = createInfoNext,
-      .queueCreateInfoCount = numQueues,
-      .pQueueCreateInfos = ciQueue,
-      .enabledExtensionCount = (uint32_t)enabledDeviceExtensionNames_.size(),
-      .ppEnabledExtensionNames = enabledDeviceExtensionNames_.data(),
-      .pEnabledFeatures = &deviceFeatures10,
-  };
-  VK_ASSERT_RETURN(vkCreateDevice(vkPhysicalDevice_, &ci, nullptr, &vkDevice_));
-
-  volkLoadDevice(vkDevice_);
+  VkSampler sampler = VK_NULL_HANDLE;
+  VK_ASSERT(vkCreateSampler(vkDevice_, &cinfo, nullptr, &sampler));
+  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_SAMPLER, (uint64_t)sampler, debugName));
 
-  vkGetDeviceQueue(vkDevice_, deviceQueues_.graphicsQueueFamilyIndex, 0, &deviceQueues_.graphicsQueue);
-  vkGetDeviceQueue(vkDevice_, deviceQueues_.computeQueueFamilyIndex, 0, &deviceQueues_.computeQueue);
+  const SamplerHandle handle = createBindless(samplersPool_, dirtySamplers_, VkSampler(sampler));
 
-  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_DEVICE, (uint64_t)vkDevice_, "Device: VulkanContext::vkDevice_"));
+  if (handle.empty()) {
+    vkDestroySampler(vkDevice_, sampler, nullptr);
+    Result::setResult(outResult, Result::Code::RuntimeError, "Cannot create Sampler: the pool is full");
+    return {};
+  }
 
-  immediate_ = std::make_unique<lvk::VulkanImmediateCommands>(
-      vkDevice_, deviceQueues_.graphicsQueueFamilyIndex, has_EXT_device_fault_, "VulkanContext::immediate_");
+  return handle;
+}
 
-  // create Vulkan pipeline cache
-  {
-    const VkPipelineCacheCreateInfo ci = {
-        VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
-        nullptr,
-        VkPipelineCacheCreateFlags(0),
-        config_.pipelineCacheDataSize,
-        config_.pipelineCacheData,
+void lvk::VulkanContext::querySurfaceCapabilities() {
+  // enumerate only the formats we are using
+  const VkFormat depthFormats[] = {
+      VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D16_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM};
+  for (const VkFormat& depthFormat : depthFormats) {
+    VkFormatProperties2 props = {
+        .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2,
     };
-    vkCreatePipelineCache(vkDevice_, &ci, nullptr, &pipelineCache_);
+    vkGetPhysicalDeviceFormatProperties2(vkPhysicalDevice_, depthFormat, &props);
+
+    if (props.formatProperties.optimalTilingFeatures) {
+      deviceDepthFormats_.push_back(depthFormat);
+    }
   }
 
-  if (LVK_VULKAN_USE_VMA) {
-    pimpl_->vma_ = lvk::createVmaAllocator(
-        vkPhysicalDevice_, vkDevice_, vkInstance_, apiVersion > VK_API_VERSION_1_3 ? VK_API_VERSION_1_3 : apiVersion);
-    LVK_ASSERT(pimpl_->vma_ != VK_NULL_HANDLE);
+  if (vkSurface_ == VK_NULL_HANDLE) {
+    return;
   }
 
-  stagingDevice_ = std::make_unique<lvk::VulkanStagingDevice>(*this);
+  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkPhysicalDevice_, vkSurface_, &deviceSurfaceCaps_);
 
-  // default texture
-  {
-    const uint32_t pixel = 0xFF000000;
-    Result result;
-    dummyTexture_ = this->createTexture(
-                            {
-                                .format = lvk::Format_RGBA_UN8,
-                                .dimensions = {1, 1, 1},
-                                .usage = TextureUsageBits_Sampled | TextureUsageBits_Storage,
-                                .data = &pixel,
-                            },
-                            "Dummy 1x1 (black)",
-                            &result)
-                        .release();
-    if (!LVK_VERIFY(result.isOk())) {
-      return result;
-    }
-    LVK_ASSERT(texturesPool_.numObjects() == 1);
+  uint32_t formatCount;
+  vkGetPhysicalDeviceSurfaceFormatsKHR(vkPhysicalDevice_, vkSurface_, &formatCount, nullptr);
+
+  if (formatCount) {
+    deviceSurfaceFormats_.resize(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(vkPhysicalDevice_, vkSurface_, &formatCount, deviceSurfaceFormats_.data());
   }
 
-  // default sampler
-  LVK_ASSERT(samplersPool_.numObjects() == 0);
-  createSampler(
-      {
-          .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-          .pNext = nullptr,
-          .flags = 0,
-          .magFilter = VK_FILTER_LINEAR,
-          .minFilter = VK_FILTER_LINEAR,
-          .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
-          .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-          .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-          .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-          .mipLodBias = 0.0f,
-          .anisotropyEnable = VK_FALSE,
-          .maxAnisotropy = 0.0f,
-          .compareEnable = VK_FALSE,
-          .compareOp = VK_COMPARE_OP_ALWAYS,
-          .minLod = 0.0f,
-          .maxLod = static_cast<float>(LVK_MAX_MIP_LEVELS - 1),
-          .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
-          .unnormalizedCoordinates = VK_FALSE,
-      },
-      nullptr,
-      Format_Invalid,
-      "Sampler: default");
+  uint32_t presentModeCount;
+  vkGetPhysicalDeviceSurfacePresentModesKHR(vkPhysicalDevice_, vkSurface_, &presentModeCount, nullptr);
 
-  querySurfaceCapabilities();
+  if (presentModeCount) {
+    devicePresentModes_.resize(presentModeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(vkPhysicalDevice_, vkSurface_, &presentModeCount, devicePresentModes_.data());
+  }
+}
 
-#if defined(LVK_WITH_TRACY_GPU)
-  std::vector<VkTimeDomainEXT> timeDomains;
+std::vector<uint8_t> lvk::VulkanContext::getPipelineCacheData() const {
+  size_t size = 0;
+  vkGetPipelineCacheData(vkDevice_, pipelineCache_, &size, nullptr);
 
-  if (has_KHR_calibrated_timestamps_) {
-    uint32_t numTimeDomains = 0;
-    VK_ASSERT(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(vkPhysicalDevice_, &numTimeDomains, nullptr));
-    timeDomains.resize(numTimeDomains);
-    VK_ASSERT(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(vkPhysicalDevice_, &numTimeDomains, timeDomains.data()));
+  std::vector<uint8_t> data(size);
+
+  if (size) {
+    vkGetPipelineCacheData(vkDevice_, pipelineCache_, &size, data.data());
   }
 
-  const bool hasHostQuery = vkFeatures12_.hostQueryReset && [&timeDomains]() -> bool {
-    for (VkTimeDomainEXT domain : timeDomains)
-      if (domain == VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_EXT || domain == VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT)
-        return true;
-    return false;
-  }();
+  return data;
+}
 
-  if (hasHostQuery) {
-    pimpl_->tracyVkCtx_ = TracyVkContextHostCalibrated(
-        vkPhysicalDevice_, vkDevice_, vkResetQueryPool, vkGetPhysicalDeviceCalibrateableTimeDomainsEXT, vkGetCalibratedTimestampsEXT);
-  } else {
-    const VkCommandPoolCreateInfo ciCommandPool = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
-        .queueFamilyIndex = deviceQueues_.graphicsQueueFamilyIndex,
-    };
-    VK_ASSERT(vkCreateCommandPool(vkDevice_, &ciCommandPool, nullptr, &pimpl_->tracyCommandPool_));
-    VK_ASSERT(lvk::setDebugObjectName(
-        vkDevice_, VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)pimpl_->tracyCommandPool_, "Command Pool: VulkanContextImpl::tracyCommandPool_"));
-    const VkCommandBufferAllocateInfo aiCommandBuffer = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = pimpl_->tracyCommandPool_,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1,
-    };
-    VK_ASSERT(vkAllocateCommandBuffers(vkDevice_, &aiCommandBuffer, &pimpl_->tracyCommandBuffer_));
-    if (has_KHR_calibrated_timestamps_) {
-      pimpl_->tracyVkCtx_ = TracyVkContextCalibrated(vkPhysicalDevice_,
-                                                     vkDevice_,
-                                                     deviceQueues_.graphicsQueue,
-                                                     pimpl_->tracyCommandBuffer_,
-                                                     vkGetPhysicalDeviceCalibrateableTimeDomainsEXT,
-                                                     vkGetCalibratedTimestampsEXT);
-    } else {
-      pimpl_->tracyVkCtx_ = TracyVkContext(vkPhysicalDevice_, vkDevice_, deviceQueues_.graphicsQueue, pimpl_->tracyCommandBuffer_);
-    };
+bool lvk::VulkanContext::savePipelineCache() {
+  LVK_PROFILER_FUNCTION();
+
+  if (pimpl_->pipelineCacheFileName_.empty()) {
+    return false;
   }
-  LVK_ASSERT(pimpl_->tracyVkCtx_);
-#endif // LVK_WITH_TRACY_GPU
 
-  // add one empty dset
-  DSets_.push_back({});
+  pimpl_->lastPipelineCacheSaveTime_ = std::chrono::steady_clock::now();
 
-  // create one separate DSL for input attachments
-  {
-    VkDescriptorSetLayoutBinding bindings[LVK_MAX_COLOR_ATTACHMENTS];
-    for (uint32_t i = 0; i != LVK_ARRAY_NUM_ELEMENTS(bindings); i++) {
-      bindings[i] = lvk::getDSLBinding(i, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
-    };
-    const VkPhysicalDeviceLimits& limits = this->getVkPhysicalDeviceProperties().limits;
-    const VkDescriptorSetLayoutCreateInfo dslci = {
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT,
-        .bindingCount = std::min((uint32_t)LVK_MAX_COLOR_ATTACHMENTS, limits.maxPerStageDescriptorInputAttachments),
-        .pBindings = bindings,
-    };
-    VK_ASSERT(vkCreateDescriptorSetLayout(vkDevice_, &dslci, nullptr, &dslInputAttachments_));
-    VK_ASSERT(lvk::setDebugObjectName(vkDevice_,
-                                      VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
-                                      (uint64_t)dslInputAttachments_,
-                                      "Descriptor Set Layout: VulkanContext::dslInputAttachments_"));
+  const uint32_t numMisses = pimpl_->numPipelineCacheMisses_;
+
+  if (numMisses == pimpl_->numPipelineCacheMissesSaved_) {
+    // the cache did not change since the last save
+    return true;
   }
-  return Result();
+
+  if (pimpl_->pipelineCacheSaveFuture_.valid()) {
+    // wait for the previous save to finish
+    if (!pimpl_->pipelineCacheSaveFuture_.get()) {
+      return false;
+    }
+  }
+
+  pimpl_->numPipelineCacheMissesSaved_ = numMisses;
+
+  // the file is written on a separate thread to avoid stalling the frame
+  pimpl_->pipelineCacheSaveFuture_ = std::async(std::launch::async,
+                                                savePipelineCacheFile,
+                                                pimpl_->pipelineCacheFileName_,
+                                                vkPhysicalDeviceProperties2_.properties,
+                                                getPipelineCacheData());
+
+  return true;
 }
 
-lvk::Result lvk::VulkanContext::initSwapchain(uint32_t width, uint32_t height) {
-  if (!vkDevice_ || !immediate_) {
-    LLOGW("Call initContext() first");
-    return Result(Result::Code::RuntimeError, "Call initContext() first");
+void lvk::VulkanContext::trackPipelineCacheHit(const VkPipelineCreationFeedback& feedback) const {
+  if (!(feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT)) {
+    return;
   }
 
-  if (swapchain_) {
-    // destroy the old swapchain first
-    // TODO: replace with VK_EXT_swapchain_maintenance1
-    VK_ASSERT(vkDeviceWaitIdle(vkDevice_));
-    swapchain_ = nullptr;
-    vkDestroySemaphore(vkDevice_, timelineSemaphore_, nullptr);
+  if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT) {
+    pimpl_->numPipelineCacheHits_++;
+  } else {
+    pimpl_->numPipelineCacheMisses_++;
   }
+  pimpl_->pipelineCreationTimeNs_ += feedback.duration;
 
-  if (!width || !height) {
-    return Result(Result::Code::ArgumentOutOfRange, "Width and Height cannot be 0");
+  [[maybe_unused]] const uint32_t numHits = pimpl_->numPipelineCacheHits_;
+  [[maybe_unused]] const uint32_t numMisses = pimpl_->numPipelineCacheMisses_;
+
+  LVK_PROFILER_PLOT("Pipeline cache hit rate, %", 100.0 * numHits / std::max(numHits + numMisses, 1u));
+  LVK_PROFILER_PLOT("Pipeline creation time, ms", feedback.duration * 1e-6);
+}
+
+lvk::DeferredBucket& lvk::VulkanContext::getDeferredBucket(SubmitHandle handle, SubmitHandle computeHandle) const {
+  std::deque<DeferredBucket>& buckets = pimpl_->deferredBuckets_;
+
+  if (!buckets.empty() && buckets.back().handle_.handle() == handle.handle()) {
+    if (!computeHandle.empty()) {
+      // compute submits complete in order
+      buckets.back().computeHandle_ = computeHandle;
+    }
+    return buckets.back();
   }
 
-  swapchain_ = std::make_unique<lvk::VulkanSwapchain>(*this, width, height);
+  if (pimpl_->freeDeferredBuckets_.empty()) {
+    buckets.emplace_back();
+  } else {
+    buckets.push_back(std::move(pimpl_->freeDeferredBuckets_.back()));
+    pimpl_->freeDeferredBuckets_.pop_back();
+  }
+  buckets.back().handle_ = handle;
+  buckets.back().computeHandle_ = computeHandle;
 
-  timelineSemaphore_ = lvk::createSemaphoreTimeline(vkDevice_, swapchain_->getNumSwapchainImages() - 1, "Semaphore: timelineSemaphore_");
+  return buckets.back();
+}
 
-  return swapchain_ ? Result() : Result(Result::Code::RuntimeError, "Failed to create swapchain");
+lvk::SubmitHandle lvk::VulkanContext::getComputeHandleInUse() const {
+  // the compute command buffer being recorded can reference anything; otherwise, only the submitted ones can
+  return pimpl_->currentCommandBufferCompute_.ctx_ ? immediateCompute_->getNextSubmitHandle() : immediateCompute_->getLastSubmitHandle();
 }
 
-lvk::Result lvk::VulkanContext::growDescriptorPool(VulkanContext::DescriptorSet& dset,
-                                                   uint32_t maxTextures,
-                                                   uint32_t maxSamplers,
-                                                   uint32_t maxAccelStructs) {
-  if (maxTextures == dset.maxTextures && maxSamplers == dset.maxSamplers && maxAccelStructs == dset.maxAccelStructs &&
-      !awaitingNewImmutableSamplers_) {
-    return Result();
+void lvk::VulkanContext::deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) const {
+  SubmitHandle computeHandle = {};
+  if (handle.empty()) {
+    handle = immediate_->getNextSubmitHandle();
+    computeHandle = getComputeHandleInUse();
   }
+  std::lock_guard lock(pimpl_->deferredMutex_);
+  getDeferredBucket(handle, computeHandle).tasks_.push_back(std::move(task));
+}
 
-  dset.maxTextures = maxTextures;
-  dset.maxSamplers = maxSamplers;
-  dset.maxAccelStructs = maxAccelStructs;
+void lvk::VulkanContext::deferredDestroy(DeferredObjectType type, uint64_t object, VmaAllocation allocation, SubmitHandle handle) const {
+  SubmitHandle computeHandle = {};
+  if (handle.empty()) {
+    handle = immediate_->getNextSubmitHandle();
+    computeHandle = getComputeHandleInUse();
+  }
+  std::lock_guard lock(pimpl_->deferredMutex_);
+  getDeferredBucket(handle, computeHandle).objects_.push_back({
+      .type_ = type,
+      .object_ = object,
+      .allocation_ = allocation,
+  });
+}
+
+void lvk::VulkanContext::retireDeferredBucket(DeferredBucket& bucket) {
+  for (const DeferredObject& obj : bucket.objects_) {
+    const uint32_t index = (uint32_t)obj.object_;
+    switch (obj.type_) {
+    case DeferredObjectType_Buffer:
+      if (obj.allocation_) {
+        vmaDestroyBuffer(pimpl_->vma_, (VkBuffer)obj.object_, obj.allocation_);
+      } else {
+        vkDestroyBuffer(vkDevice_, (VkBuffer)obj.object_, nullptr);
+      }
+      break;
+    case DeferredObjectType_Image:
+      if (obj.allocation_) {
+        vmaDestroyImage(pimpl_->vma_, (VkImage)obj.object_, obj.allocation_);
+      } else {
+        vkDestroyImage(vkDevice_, (VkImage)obj.object_, nullptr);
+      }
+      break;
+    case DeferredObjectType_ImageView:
+      vkDestroyImageView(vkDevice_, (VkImageView)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_DeviceMemory:
+      vkFreeMemory(vkDevice_, (VkDeviceMemory)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_Sampler:
+      vkDestroySampler(vkDevice_, (VkSampler)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_Pipeline:
+      vkDestroyPipeline(vkDevice_, (VkPipeline)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_PipelineLayout:
+      vkDestroyPipelineLayout(vkDevice_, (VkPipelineLayout)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_QueryPool:
+      vkDestroyQueryPool(vkDevice_, (VkQueryPool)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_AccelStruct:
+      vkDestroyAccelerationStructureKHR(vkDevice_, (VkAccelerationStructureKHR)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_DescriptorSetLayout:
+      vkDestroyDescriptorSetLayout(vkDevice_, (VkDescriptorSetLayout)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_DescriptorPool:
+      vkDestroyDescriptorPool(vkDevice_, (VkDescriptorPool)obj.object_, nullptr);
+      break;
+    case DeferredObjectType_TextureSlot:
+      recycleBindless(texturesPool_, dirtyTextures_, index);
+      break;
+    case DeferredObjectType_SamplerSlot:
+      recycleBindless(samplersPool_, dirtySamplers_, index);
+      break;
+    case DeferredObjectType_AccelStructSlot:
+      recycleBindless(accelStructuresPool_, dirtyAccelStructs_, index);
+      break;
+    }
+  }
+  for (std::packaged_task<void()>& task : bucket.tasks_) {
+    task();
+  }
+  bucket.objects_.clear();
+  bucket.tasks_.clear();
+}
 
-#if LVK_VULKAN_PRINT_COMMANDS
-  LLOGL("growDescriptorPool(%u, %u)\n", maxTextures, maxSamplers);
-#endif // LVK_VULKAN_PRINT_COMMANDS
+void* lvk::VulkanContext::getVmaAllocator() const {
+  return pimpl_->vma_;
+}
 
-  if (!LVK_VERIFY(maxTextures <= vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSampledImages)) {
-    LLOGW("Max Textures exceeded: %u (max %u)",
-          maxTextures,
-          vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSampledImages);
-  }
+void lvk::VulkanContext::processDeferredTasks() {
+  std::unique_lock lock(pimpl_->deferredMutex_);
 
-  if (!LVK_VERIFY(maxSamplers <= vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSamplers)) {
-    LLOGW("Max Samplers exceeded %u (max %u)", maxSamplers, vkPhysicalDeviceVulkan12Properties_.maxDescriptorSetUpdateAfterBindSamplers);
-  }
+  std::deque<DeferredBucket>& buckets = pimpl_->deferredBuckets_;
 
-  if (dset.vkDSL != VK_NULL_HANDLE) {
-    deferredTask(
-        std::packaged_task<void()>([device = vkDevice_, dsl = dset.vkDSL]() { vkDestroyDescriptorSetLayout(device, dsl, nullptr); }));
-  }
-  if (dset.vkDPool != VK_NULL_HANDLE) {
-    deferredTask(std::packaged_task<void()>([device = vkDevice_, dp = dset.vkDPool]() { vkDestroyDescriptorPool(device, dp, nullptr); }));
+  while (!buckets.empty() && getImmediateCommands(buckets.front().handle_)->isReady(buckets.front().handle_, true) &&
+         immediateCompute_->isReady(buckets.front().computeHandle_, true)) {
+    DeferredBucket bucket = std::move(buckets.front());
+    buckets.pop_front();
+    // other threads can keep adding objects while this bucket is being retired
+    lock.unlock();
+    retireDeferredBucket(bucket);
+    lock.lock();
+    pimpl_->freeDeferredBuckets_.push_back(std::move(bucket));
   }
+}
 
-  VkSampler firstYcbcrSampler = VK_NULL_HANDLE;
+void lvk::VulkanContext::waitDeferredTasks() {
+  std::unique_lock lock(pimpl_->deferredMutex_);
 
-  // check if we have any YUV images
-  for (const auto& obj : texturesPool_.objects_) {
-    const VulkanImage* img = &obj.obj_;
-    // multisampled images cannot be directly accessed from shaders
-    const bool isTextureAvailable = (img->vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
-    const bool isYUVImage = isTextureAvailable && img->isSampledImage() && lvk::getNumImagePlanes(img->vkImageFormat_) > 1;
-    if (isYUVImage) {
-      // find the first Ycbcr sampler and use it as a dummy
-      // (https://docs.vulkan.org/spec/latest/chapters/descriptorsets.html#VUID-VkDescriptorSetLayoutBinding-descriptorType-12200)
-      firstYcbcrSampler = getOrCreateYcbcrSampler(vkFormatToFormat(img->vkImageFormat_));
-      break;
+  std::deque<DeferredBucket>& buckets = pimpl_->deferredBuckets_;
+
+  while (!buckets.empty()) {
+    DeferredBucket bucket = std::move(buckets.front());
+    buckets.pop_front();
+    lock.unlock();
+    getImmediateCommands(bucket.handle_)->wait(bucket.handle_);
+    if (!bucket.computeHandle_.empty()) {
+      immediateCompute_->wait(bucket.computeHandle_);
     }
+    retireDeferredBucket(bucket);
+    lock.lock();
   }
+  pimpl_->freeDeferredBuckets_.clear();
+}
 
-  std::vector<VkSampler> immutableSamplers;
-  const VkSampler* immutableSamplersData = nullptr;
+uint32_t lvk::VulkanContext::getMaxStorageBufferRange() const {
+  return vkPhysicalDeviceProperties2_.properties.limits.maxStorageBufferRange;
+}
 
-  if (firstYcbcrSampler) {
-    immutableSamplers.resize(maxTextures, firstYcbcrSampler);
-    for (size_t i = 0; i != texturesPool_.objects_.size(); i++) {
-      const auto& obj = texturesPool_.objects_[i];
-      const VulkanImage* img = &obj.obj_;
-      // multisampled images cannot be directly accessed from shaders
-      const bool isTextureAvailable = (img->vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
-      const bool isYUVImage = isTextureAvailable && img->isSampledImage() && lvk::getNumImagePlanes(img->vkImageFormat_) > 1;
-      immutableSamplers[i] = isYUVImage ? getOrCreateYcbcrSampler(vkFormatToFormat(img->vkImageFormat_)) : firstYcbcrSampler;
-    }
-    immutableSamplersData = immutableSamplers.data();
-  }
+uint32_t lvk::VulkanContext::getNumStagingStalls() const {
+  return stagingDevice_->getNumStalls() + stagingDeviceAsync_->getNumStalls();
+}
 
-  // create default descriptor set layout which is going to be shared by graphics pipelines
-  VkShaderStageFlags stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT |
-                                  VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
-  if (has_KHR_ray_tracing_pipeline_) {
-    stageFlags |= (VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_ANY_HIT_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
-                   VK_SHADER_STAGE_MISS_BIT_KHR | VK_SHADER_STAGE_INTERSECTION_BIT_KHR | VK_SHADER_STAGE_CALLABLE_BIT_KHR);
-  }
-  const VkDescriptorSetLayoutBinding bindings[kBinding_NumBindings] = {
-      lvk::getDSLBinding(kBinding_Textures, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures, stageFlags),
-      lvk::getDSLBinding(kBinding_Samplers, VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers, stageFlags),
-      lvk::getDSLBinding(kBinding_StorageImages, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxTextures, stageFlags),
-      lvk::getDSLBinding(kBinding_YUVImages,
-                         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                         (uint32_t)immutableSamplers.size() ? maxTextures : 0,
-                         stageFlags,
-                         immutableSamplersData),
-      lvk::getDSLBinding(kBinding_AccelerationStructures, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, maxAccelStructs, stageFlags),
+void lvk::VulkanContext::getCreationStats(CreationStats& outStats) const {
+  const uint32_t numHits = pimpl_->numPipelineCacheHits_;
+  outStats = {
+      .numPipelines = numHits + pimpl_->numPipelineCacheMisses_,
+      .numPipelineCacheHits = numHits,
+      .pipelineTimeMs = pimpl_->pipelineCreationTimeNs_ * 1e-6,
+      .numShaderCompilations = pimpl_->numShaderCompilations_,
+      .numShaderCacheHits = pimpl_->numShaderCacheHits_,
+      .shaderCompilationTimeMs = pimpl_->shaderCompilationTimeNs_ * 1e-6,
   };
-  const uint32_t flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
-                         VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
-  VkDescriptorBindingFlags bindingFlags[kBinding_NumBindings];
-  for (int i = 0; i < kBinding_NumBindings; ++i) {
-    bindingFlags[i] = flags;
+}
+
+bool lvk::VulkanContext::getFrameStats(FrameStats& outStats) const {
+  std::lock_guard lock(pimpl_->timingMutex_);
+
+  if (!pimpl_->hasFrameStats_) {
+    return false;
   }
-  const VkDescriptorSetLayoutBindingFlagsCreateInfo setLayoutBindingFlagsCI = {
-      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT,
-      .bindingCount = uint32_t(has_KHR_acceleration_structure_ ? kBinding_NumBindings : kBinding_NumBindings - 1),
-      .pBindingFlags = bindingFlags,
+
+  outStats = pimpl_->lastFrameStats_;
+
+  return true;
+}
+
+void lvk::VulkanContext::getMemoryStats(MemoryStats& outStats) const {
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
   };
-  const VkDescriptorSetLayoutCreateInfo dslci = {
-      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-      .pNext = &setLayoutBindingFlagsCI,
-      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT,
-      .bindingCount = uint32_t(has_KHR_acceleration_structure_ ? kBinding_NumBindings : kBinding_NumBindings - 1),
-      .pBindings = bindings,
+  VkPhysicalDeviceMemoryProperties2 props = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+      .pNext = has_EXT_memory_budget_ ? &budget : nullptr,
   };
-  VK_ASSERT(vkCreateDescriptorSetLayout(vkDevice_, &dslci, nullptr, &dset.vkDSL));
-  VK_ASSERT(lvk::setDebugObjectName(
-      vkDevice_, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)dset.vkDSL, "Descriptor Set Layout: VulkanContext::vkDSL"));
+  vkGetPhysicalDeviceMemoryProperties2(vkPhysicalDevice_, &props);
 
-  {
-    // create default descriptor pool and allocate 1 descriptor set
-    VkDescriptorPoolSize poolSizes[kBinding_NumBindings] = {
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers},
-        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxTextures},
-    };
-    uint32_t numPoolSizes = 3;
-    if (!immutableSamplers.empty()) {
-      poolSizes[numPoolSizes++] = VkDescriptorPoolSize{
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          pimpl_->maxCombinedImageSamplerDescriptorCount_ * maxTextures,
-      };
-    }
-    if (has_KHR_acceleration_structure_) {
-      poolSizes[numPoolSizes++] = VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, maxAccelStructs};
-    }
-    LVK_ASSERT(numPoolSizes <= kBinding_NumBindings);
-    const VkDescriptorPoolCreateInfo ci = {
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
-        .maxSets = 1,
-        .poolSizeCount = numPoolSizes,
-        .pPoolSizes = poolSizes,
-    };
-    VK_ASSERT_RETURN(vkCreateDescriptorPool(vkDevice_, &ci, nullptr, &dset.vkDPool));
-    const VkDescriptorSetAllocateInfo ai = {
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        .descriptorPool = dset.vkDPool,
-        .descriptorSetCount = 1,
-        .pSetLayouts = &dset.vkDSL,
+  // without VK_EXT_memory_budget, VMA knows only about its own allocations
+  VmaBudget vmaBudgets[VK_MAX_MEMORY_HEAPS] = {};
+  if (LVK_VULKAN_USE_VMA && !has_EXT_memory_budget_) {
+    vmaGetHeapBudgets(pimpl_->vma_, vmaBudgets);
+  }
+
+  outStats = {
+      .numHeaps = std::min(props.memoryProperties.memoryHeapCount, (uint32_t)MemoryStats::LVK_MAX_MEMORY_HEAPS),
+      .hasMemoryBudget = has_EXT_memory_budget_,
+  };
+
+  for (uint32_t i = 0; i != outStats.numHeaps; i++) {
+    const VkMemoryHeap& heap = props.memoryProperties.memoryHeaps[i];
+    outStats.heaps[i] = {
+        .size = heap.size,
+        .budget = has_EXT_memory_budget_ ? budget.heapBudget[i] : heap.size * 8 / 10,
+        .usage = has_EXT_memory_budget_ ? budget.heapUsage[i] : vmaBudgets[i].usage,
+        .isDeviceLocal = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
     };
-    VK_ASSERT_RETURN(vkAllocateDescriptorSets(vkDevice_, &ai, &dset.vkDSet));
   }
+  for (uint32_t i = 0; i != MemoryCategory_Num; i++) {
+    outStats.categoryBytes[i] = pimpl_->memoryBytes_[i];
+    outStats.categoryCount[i] = pimpl_->memoryCount_[i];
+  }
+}
 
-  awaitingNewImmutableSamplers_ = false;
+void lvk::VulkanContext::setMemoryBudgetCallback(MemoryBudgetCallback callback, void* userData, float threshold) {
+  LVK_ASSERT(threshold > 0.0f);
 
-  return Result();
+  std::lock_guard lock(pimpl_->memoryBudgetMutex_);
+
+  pimpl_->memoryBudgetCallback_ = callback;
+  pimpl_->memoryBudgetUserData_ = userData;
+  pimpl_->memoryBudgetThreshold_ = threshold;
 }
 
-lvk::BufferHandle lvk::VulkanContext::createBuffer(VkDeviceSize bufferSize,
-                                                   VkBufferUsageFlags usageFlags,
-                                                   VkMemoryPropertyFlags memFlags,
-                                                   lvk::Result* outResult,
-                                                   const char* debugName) {
-  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+bool lvk::VulkanContext::isSparseResidencySupported() const {
+  return has_sparseResidency_;
+}
 
-  LVK_ASSERT(bufferSize > 0);
+lvk::SparseTextureInfo lvk::VulkanContext::getSparseTextureInfo(TextureHandle handle) const {
+  const lvk::VulkanImage* tex = texturesPool_.get(handle);
 
-#define ENSURE_BUFFER_SIZE(flag, maxSize)                                                             \
-  if (usageFlags & flag) {                                                                            \
-    if (!LVK_VERIFY(bufferSize <= maxSize)) {                                                         \
-      Result::setResult(outResult, Result(Result::Code::RuntimeError, "Buffer size exceeded" #flag)); \
-      return {};                                                                                      \
-    }                                                                                                 \
+  if (!LVK_VERIFY(tex && tex->sparse_)) {
+    return {};
   }
 
-  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
-
-  ENSURE_BUFFER_SIZE(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, limits.maxUniformBufferRange);
-  ENSURE_BUFFER_SIZE(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, limits.maxStorageBufferRange);
-  // any buffer
-  ENSURE_BUFFER_SIZE(VK_BUFFER_USAGE_FLAG_BITS_MAX_ENUM, vkPhysicalDeviceVulkan11Properties_.maxMemoryAllocationSize);
-#undef ENSURE_BUFFER_SIZE
+  const VulkanSparseImage& sparse = *tex->sparse_;
 
-  VulkanBuffer buf = {
-      .bufferSize_ = bufferSize,
-      .vkUsageFlags_ = usageFlags,
-      .vkMemFlags_ = memFlags,
+  SparseTextureInfo info = {
+      .pageDimensions = {sparse.pageExtent_.width, sparse.pageExtent_.height, sparse.pageExtent_.depth},
+      .pageSize = (uint32_t)sparse.pageSize_,
+      .firstMipTailLevel = sparse.firstMipTailLevel_,
+      .numPages = sparse.numPages_,
+      .numResidentPages = sparse.numResidentPages_,
+      .feedback = sparse.feedback_,
+      .feedbackOffset = sparse.feedbackOffset_,
   };
 
-  const VkBufferCreateInfo ci = {
-      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-      .pNext = nullptr,
-      .flags = 0,
-      .size = bufferSize,
-      .usage = usageFlags,
-      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-      .queueFamilyIndexCount = 0,
-      .pQueueFamilyIndices = nullptr,
-  };
+  for (uint32_t l = 0; l != sparse.firstMipTailLevel_; l++) {
+    info.levelFirstPage[l] = sparse.levelFirstPage_[l];
+    info.levelPagesPerRow[l] = sparse.levelPagesPerRow_[l];
+  }
 
-  if (LVK_VULKAN_USE_VMA) {
-    VmaAllocationCreateInfo vmaAllocInfo = {};
+  return info;
+}
 
-    // Initialize VmaAllocation Info
-    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      vmaAllocInfo = {
-          .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
-          .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-          .preferredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
-      };
-    }
+lvk::Result lvk::VulkanContext::updateSparsePages(TextureHandle handle,
+                                                  const SparsePage* bind,
+                                                  uint32_t numBind,
+                                                  const SparsePage* unbind,
+                                                  uint32_t numUnbind) {
+  LVK_PROFILER_FUNCTION();
 
-    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      // Check if coherent buffer is available.
-      VK_ASSERT(vkCreateBuffer(vkDevice_, &ci, nullptr, &buf.vkBuffer_));
-      VkMemoryRequirements requirements = {};
-      vkGetBufferMemoryRequirements(vkDevice_, buf.vkBuffer_, &requirements);
-      vkDestroyBuffer(vkDevice_, buf.vkBuffer_, nullptr);
-      buf.vkBuffer_ = VK_NULL_HANDLE;
+  lvk::VulkanImage* tex = texturesPool_.get(handle);
 
-      if (requirements.memoryTypeBits & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
-        vmaAllocInfo.requiredFlags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        buf.isCoherentMemory_ = true;
-      }
-    }
+  if (!LVK_VERIFY(tex && tex->sparse_)) {
+    return Result(Result::Code::ArgumentOutOfRange, "Not a sparse texture");
+  }
 
-    vmaAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  VulkanSparseImage& sparse = *tex->sparse_;
+  const VkExtent3D& pageExtent = sparse.pageExtent_;
 
-    vmaCreateBufferWithAlignment((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, 16, &buf.vkBuffer_, &buf.vmaAllocation_, nullptr);
+  std::vector<VkSparseImageMemoryBind> binds;
+  binds.reserve(numBind + numUnbind);
 
-    // handle memory-mapped buffers
-    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      vmaMapMemory((VmaAllocator)getVmaAllocator(), buf.vmaAllocation_, &buf.mappedPtr_);
+  // returns the page index or kUnbound if the page is outside of the texture
+  auto getPageIndex = [&sparse, tex, &pageExtent](const SparsePage& page) -> uint32_t {
+    if (page.mipLevel >= sparse.firstMipTailLevel_) {
+      return VulkanSparseImage::kUnbound;
     }
-  } else {
-    // create buffer
-    VK_ASSERT(vkCreateBuffer(vkDevice_, &ci, nullptr, &buf.vkBuffer_));
+    const uint32_t height = std::max(tex->vkExtent_.height >> page.mipLevel, 1u);
+    if (page.x >= sparse.levelPagesPerRow_[page.mipLevel] || page.y >= (height + pageExtent.height - 1) / pageExtent.height) {
+      return VulkanSparseImage::kUnbound;
+    }
+    return sparse.levelFirstPage_[page.mipLevel] + page.y * sparse.levelPagesPerRow_[page.mipLevel] + page.x;
+  };
+  auto addBind = [&binds, tex, &pageExtent](const SparsePage& page, VkDeviceMemory memory, VkDeviceSize memoryOffset) {
+    const uint32_t width = std::max(tex->vkExtent_.width >> page.mipLevel, 1u);
+    const uint32_t height = std::max(tex->vkExtent_.height >> page.mipLevel, 1u);
+    // the extent of the pages at the right and bottom edges is clamped to the size of the mip-level
+    binds.push_back({
+        .subresource = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = page.mipLevel, .arrayLayer = 0},
+        .offset = {int32_t(page.x * pageExtent.width), int32_t(page.y * pageExtent.height), 0},
+        .extent = {std::min(pageExtent.width, width - page.x * pageExtent.width),
+                   std::min(pageExtent.height, height - page.y * pageExtent.height),
+                   1},
+        .memory = memory,
+        .memoryOffset = memoryOffset,
+    });
+  };
 
-    // back the buffer with some memory
-    {
-      const VkBufferMemoryRequirementsInfo2 ri = {
-          .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2,
-          .buffer = buf.vkBuffer_,
-      };
-      VkMemoryRequirements2 requirements = {
-          .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
-      };
-      vkGetBufferMemoryRequirements2(vkDevice_, &ri, &requirements);
-      if (requirements.memoryRequirements.memoryTypeBits & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
-        buf.isCoherentMemory_ = true;
-      }
+  Result result;
 
-      VK_ASSERT(lvk::allocateMemory2(vkPhysicalDevice_, vkDevice_, &requirements, memFlags, &buf.vkMemory_));
-      VK_ASSERT(vkBindBufferMemory(vkDevice_, buf.vkBuffer_, buf.vkMemory_, 0));
+  std::vector<uint32_t> unboundPages;
+
+  std::unique_lock lock(pimpl_->sparseMutex_);
+
+  for (uint32_t i = 0; i != numUnbind; i++) {
+    const uint32_t index = getPageIndex(unbind[i]);
+    if (!LVK_VERIFY(index != VulkanSparseImage::kUnbound)) {
+      result = Result(Result::Code::ArgumentOutOfRange, "Invalid sparse page");
+      continue;
     }
+    if (sparse.pages_[index] == VulkanSparseImage::kUnbound) {
+      continue;
+    }
+    unboundPages.push_back(sparse.pages_[index]);
+    sparse.pages_[index] = VulkanSparseImage::kUnbound;
+    sparse.numResidentPages_--;
+    addBind(unbind[i], VK_NULL_HANDLE, 0);
+  }
 
-    // handle memory-mapped buffers
-    if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      VK_ASSERT(vkMapMemory(vkDevice_, buf.vkMemory_, 0, buf.bufferSize_, 0, &buf.mappedPtr_));
+  for (uint32_t i = 0; i != numBind; i++) {
+    const uint32_t index = getPageIndex(bind[i]);
+    if (!LVK_VERIFY(index != VulkanSparseImage::kUnbound)) {
+      result = Result(Result::Code::ArgumentOutOfRange, "Invalid sparse page");
+      continue;
+    }
+    if (sparse.pages_[index] != VulkanSparseImage::kUnbound) {
+      continue;
+    }
+    const uint32_t page = allocateSparsePage(sparse);
+    if (page == VulkanSparseImage::kUnbound) {
+      result = Result(Result::Code::RuntimeError, "Cannot allocate memory for sparse pages");
+      break;
     }
+    const VulkanContextImpl::SparseMemoryBlock& block = pimpl_->sparseBlocks_[page / VulkanContextImpl::kSparsePagesPerBlock];
+    sparse.pages_[index] = page;
+    sparse.numResidentPages_++;
+    addBind(bind[i], block.memory_, (page % VulkanContextImpl::kSparsePagesPerBlock) * block.pageSize_);
   }
 
-  LVK_ASSERT(buf.vkBuffer_ != VK_NULL_HANDLE);
+  if (binds.empty()) {
+    return result;
+  }
 
-  // set debug name
-  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_BUFFER, (uint64_t)buf.vkBuffer_, debugName));
+  const VkSparseImageMemoryBindInfo imageBind = {
+      .image = tex->vkImage_,
+      .bindCount = (uint32_t)binds.size(),
+      .pBinds = binds.data(),
+  };
 
-  // handle shader access
-  if (usageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
-    const VkBufferDeviceAddressInfo ai = {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-        .buffer = buf.vkBuffer_,
-    };
-    buf.vkDeviceAddress_ = vkGetBufferDeviceAddress(vkDevice_, &ai);
-    LVK_ASSERT(buf.vkDeviceAddress_);
+  const bool hasUnbinds = !unboundPages.empty();
+  const Result resultBind = bindSparse(nullptr, &imageBind, hasUnbinds, binds.size() > unboundPages.size());
+
+  lock.unlock();
+
+  freeSparsePagesDeferred(std::move(unboundPages));
+
+  return resultBind.isOk() ? result : resultBind;
+}
+
+void lvk::VulkanContext::trackMemory(lvk::MemoryCategory category, VkDeviceSize size, bool isAllocated) {
+  LVK_ASSERT(category < MemoryCategory_Num);
+
+  if (isAllocated) {
+    pimpl_->memoryBytes_[category] += size;
+    pimpl_->memoryCount_[category]++;
+  } else {
+    pimpl_->memoryBytes_[category] -= size;
+    pimpl_->memoryCount_[category]--;
+  }
+}
+
+void lvk::VulkanContext::checkMemoryBudget() {
+  if (LVK_VULKAN_USE_VMA) {
+    // VMA refreshes its cached VK_EXT_memory_budget values when the frame index changes
+    vmaSetCurrentFrameIndex(pimpl_->vma_, ++pimpl_->vmaFrameIndex_);
   }
 
-  return buffersPool_.create(std::move(buf));
-}
-
-void lvk::VulkanContext::bindDefaultDescriptorSets(VkCommandBuffer cmdBuf, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const {
-  LVK_PROFILER_FUNCTION();
-  const VkDescriptorSet dset = DSets_[lastUpdatedDSet_].vkDSet;
-  const VkDescriptorSet dsets[4] = {dset, dset, dset, dset};
-  vkCmdBindDescriptorSets(cmdBuf, bindPoint, layout, 0, (uint32_t)LVK_ARRAY_NUM_ELEMENTS(dsets), dsets, 0, nullptr);
-}
+  MemoryBudgetCallback callback = nullptr;
+  void* userData = nullptr;
+  float threshold = 0;
+  {
+    // the callback may reset itself
+    std::lock_guard lock(pimpl_->memoryBudgetMutex_);
+    callback = pimpl_->memoryBudgetCallback_;
+    userData = pimpl_->memoryBudgetUserData_;
+    threshold = pimpl_->memoryBudgetThreshold_;
+  }
 
-void lvk::VulkanContext::checkAndUpdateDescriptorSets() {
-  if (!awaitingCreation_) {
-    // nothing to update here
+  if (!callback) {
     return;
   }
 
-  // newly created resources can be used immediately - make sure they are put into descriptor sets
+  MemoryStats stats;
+  getMemoryStats(stats);
+
+  for (uint32_t i = 0; i != stats.numHeaps; i++) {
+    const MemoryHeapStats& heap = stats.heaps[i];
+    if (heap.budget && double(heap.usage) >= double(heap.budget) * threshold) {
+      callback(stats, i, userData);
+    }
+  }
+}
+
+lvk::Result lvk::VulkanContext::createSparseImage(VulkanImage& image, const VkImageCreateInfo& ci, const char* debugName) {
   LVK_PROFILER_FUNCTION();
 
-  // update Vulkan descriptor set here
+  VkMemoryRequirements requirements = {};
+  vkGetImageMemoryRequirements(vkDevice_, image.vkImage_, &requirements);
+
+  uint32_t numSparseRequirements = 0;
+  vkGetImageSparseMemoryRequirements(vkDevice_, image.vkImage_, &numSparseRequirements, nullptr);
+  std::vector<VkSparseImageMemoryRequirements> sparseRequirements(numSparseRequirements);
+  vkGetImageSparseMemoryRequirements(vkDevice_, image.vkImage_, &numSparseRequirements, sparseRequirements.data());
 
-  lastUpdatedDSet_ = (lastUpdatedDSet_ + 1) % DSets_.size();
+  const VkSparseImageMemoryRequirements* color = nullptr;
+  const VkSparseImageMemoryRequirements* metadata = nullptr;
 
-  if (const DescriptorSet& dset = DSets_[lastUpdatedDSet_]; dset.vkDSet) {
-    // we can't reuse a dset that's either waiting to be submitted in a draw call
-    // (which happens when textures are created mid-frame) or is still being processed
-    if (dset.handle_.empty() || !immediate_->isReady(dset.handle_)) {
-      // add a new empty dset to be populated right away
-      lastUpdatedDSet_ = DSets_.size();
-      DSets_.push_back({});
+  for (const VkSparseImageMemoryRequirements& r : sparseRequirements) {
+    if (r.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
+      color = &r;
+    }
+    if (r.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT) {
+      metadata = &r;
     }
   }
 
-  DescriptorSet& dset = DSets_[lastUpdatedDSet_];
+  if (!color) {
+    LLOGW("Sparse residency is not supported for VkFormat = %u\n", (uint32_t)ci.format);
+    return Result(Result::Code::RuntimeError, "Sparse residency is not supported for this format");
+  }
 
-  dset.handle_ = {};
+  std::unique_ptr<VulkanSparseImage> sparse = std::make_unique<VulkanSparseImage>();
 
-  // make sure the guard values are always there
-  LVK_ASSERT(texturesPool_.numObjects() >= 1);
-  LVK_ASSERT(samplersPool_.numObjects() >= 1);
+  sparse->pageExtent_ = color->formatProperties.imageGranularity;
+  sparse->pageSize_ = requirements.alignment; // the sparse block size
+  sparse->memoryTypeBits_ = requirements.memoryTypeBits;
+  sparse->firstMipTailLevel_ = std::min(color->imageMipTailFirstLod, ci.mipLevels);
 
-  uint32_t newMaxTextures = std::max(dset.maxTextures, 16u);
-  uint32_t newMaxSamplers = std::max(dset.maxSamplers, 16u);
-  uint32_t newMaxAccelStructs = std::max(dset.maxAccelStructs, 1u);
+  for (uint32_t l = 0; l != sparse->firstMipTailLevel_; l++) {
+    const uint32_t width = std::max(ci.extent.width >> l, 1u);
+    const uint32_t height = std::max(ci.extent.height >> l, 1u);
+    const uint32_t pagesPerRow = (width + sparse->pageExtent_.width - 1) / sparse->pageExtent_.width;
+    const uint32_t numRows = (height + sparse->pageExtent_.height - 1) / sparse->pageExtent_.height;
+    sparse->levelFirstPage_[l] = sparse->numPages_;
+    sparse->levelPagesPerRow_[l] = pagesPerRow;
+    sparse->numPages_ += pagesPerRow * numRows;
+  }
 
-  while (texturesPool_.objects_.size() > newMaxTextures) {
-    newMaxTextures *= 2;
+  sparse->pages_.resize(sparse->numPages_, VulkanSparseImage::kUnbound);
+
+  // the mip-tail and the metadata (if any) are always resident and live in one dedicated allocation
+  VkSparseMemoryBind tailBinds[2] = {};
+  uint32_t numTailBinds = 0;
+
+  if (sparse->firstMipTailLevel_ < ci.mipLevels) {
+    tailBinds[numTailBinds++] = {
+        .resourceOffset = color->imageMipTailOffset,
+        .size = color->imageMipTailSize,
+    };
   }
-  while (samplersPool_.objects_.size() > newMaxSamplers) {
-    newMaxSamplers *= 2;
+  if (metadata) {
+    tailBinds[numTailBinds++] = {
+        .resourceOffset = metadata->imageMipTailOffset,
+        .size = metadata->imageMipTailSize,
+        .flags = VK_SPARSE_MEMORY_BIND_METADATA_BIT,
+    };
   }
-  while (accelStructuresPool_.objects_.size() > newMaxAccelStructs) {
-    newMaxAccelStructs *= 2;
+  for (uint32_t i = 0; i != numTailBinds; i++) {
+    tailBinds[i].memoryOffset = sparse->mipTailSize_;
+    sparse->mipTailSize_ += (tailBinds[i].size + requirements.alignment - 1) & ~(requirements.alignment - 1);
   }
-  growDescriptorPool(dset, newMaxTextures, newMaxSamplers, newMaxAccelStructs);
 
-  // 1. Sampled and storage images
-  std::vector<VkDescriptorImageInfo> infoSampledImages;
-  std::vector<VkDescriptorImageInfo> infoStorageImages;
-  std::vector<VkDescriptorImageInfo> infoYUVImages;
+  if (sparse->mipTailSize_) {
+    const VkMemoryRequirements2 memRequirements = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .memoryRequirements =
+            {
+                .size = sparse->mipTailSize_,
+                .alignment = requirements.alignment,
+                .memoryTypeBits = requirements.memoryTypeBits,
+            },
+    };
+    VK_ASSERT_RETURN(
+        lvk::allocateMemory2(vkPhysicalDevice_, vkDevice_, &memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &sparse->mipTailMemory_));
+    for (uint32_t i = 0; i != numTailBinds; i++) {
+      tailBinds[i].memory = sparse->mipTailMemory_;
+    }
+  }
 
-  infoSampledImages.reserve(texturesPool_.numObjects());
-  infoStorageImages.reserve(texturesPool_.numObjects());
+  // the header of the feedback buffer is read by textureBindless2DSparse(): {pageWidth, pageHeight, firstMipTailLevel, numPages} and
+  // uvec2(levelFirstPage, levelPagesPerRow) for every mip-level; the bitmask of requested pages follows it
+  sparse->feedbackOffset_ = (4 + 2 * LVK_MAX_MIP_LEVELS) * sizeof(uint32_t);
 
-  const bool hasYcbcrSamplers = pimpl_->numYcbcrSamplers_ > 0;
+  std::vector<uint32_t> feedback(sparse->feedbackOffset_ / sizeof(uint32_t) + (sparse->numPages_ + 31) / 32);
+  feedback[0] = sparse->pageExtent_.width;
+  feedback[1] = sparse->pageExtent_.height;
+  feedback[2] = sparse->firstMipTailLevel_;
+  feedback[3] = sparse->numPages_;
+  for (uint32_t l = 0; l != sparse->firstMipTailLevel_; l++) {
+    feedback[4 + 2 * l + 0] = sparse->levelFirstPage_[l];
+    feedback[4 + 2 * l + 1] = sparse->levelPagesPerRow_[l];
+  }
 
-  if (hasYcbcrSamplers) {
-    infoYUVImages.reserve(texturesPool_.numObjects());
+  char debugNameFeedback[256] = {0};
+  if (debugName && *debugName) {
+    snprintf(debugNameFeedback, sizeof(debugNameFeedback) - 1, "Buffer: sparse feedback %s", debugName);
   }
 
-  // use dummies to avoid sparse arrays
-  VkImageView dummyImageView = texturesPool_.objects_[0].obj_.imageView_;
-  VkSampler dummySampler = samplersPool_.objects_[0].obj_;
+  Result result;
+  sparse->feedback_ = createBuffer(
+                          {
+                              .usage = lvk::BufferUsageBits_Storage,
+                              .storage = lvk::StorageType_Device,
+                              .size = feedback.size() * sizeof(uint32_t),
+                              .data = feedback.data(),
+                              .debugName = debugNameFeedback,
+                          },
+                          nullptr,
+                          &result)
+                          .release();
 
-  for (const auto& obj : texturesPool_.objects_) {
-    const VulkanImage& img = obj.obj_;
-    const VkImageView view = obj.obj_.imageView_;
-    const VkImageView storageView = obj.obj_.imageViewStorage_ ? obj.obj_.imageViewStorage_ : view;
-    // multisampled images cannot be directly accessed from shaders
-    const bool isTextureAvailable = (img.vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
-    const bool isYUVImage = isTextureAvailable && img.isSampledImage() && lvk::getNumImagePlanes(img.vkImageFormat_) > 1;
-    const bool isSampledImage = isTextureAvailable && img.isSampledImage() && !isYUVImage;
-    const bool isStorageImage = isTextureAvailable && img.isStorageImage();
-    infoSampledImages.push_back(VkDescriptorImageInfo{
-        .sampler = VK_NULL_HANDLE,
-        .imageView = isSampledImage ? view : dummyImageView,
-        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-    });
-    LVK_ASSERT(infoSampledImages.back().imageView != VK_NULL_HANDLE);
-    infoStorageImages.push_back(VkDescriptorImageInfo{
-        .sampler = VK_NULL_HANDLE,
-        .imageView = isStorageImage ? storageView : dummyImageView,
-        .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
-    });
-    if (hasYcbcrSamplers) {
-      // we don't need to update this if there're no YUV samplers
-      infoYUVImages.push_back(VkDescriptorImageInfo{
-          .sampler = dummySampler, // this will be replaced by immutable samplers from VkPipeline
-          .imageView = isYUVImage ? view : dummyImageView,
-          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-      });
+  if (!result.isOk()) {
+    vkFreeMemory(vkDevice_, sparse->mipTailMemory_, nullptr);
+    return result;
+  }
+
+  if (numTailBinds) {
+    const VkSparseImageOpaqueMemoryBindInfo opaqueBind = {
+        .image = image.vkImage_,
+        .bindCount = numTailBinds,
+        .pBinds = tailBinds,
+    };
+    result = bindSparse(&opaqueBind, nullptr, false, true);
+    if (!result.isOk()) {
+      destroy(sparse->feedback_);
+      vkFreeMemory(vkDevice_, sparse->mipTailMemory_, nullptr);
+      return result;
     }
   }
 
-  // 2. Samplers
-  std::vector<VkDescriptorImageInfo> infoSamplers;
-  infoSamplers.reserve(samplersPool_.objects_.size());
+  image.memorySize_ = sparse->mipTailSize_;
+  image.sparse_ = sparse.release();
 
-  for (const auto& sampler : samplersPool_.objects_) {
-    infoSamplers.push_back({
-        .sampler = sampler.obj_ ? sampler.obj_ : samplersPool_.objects_[0].obj_,
-        .imageView = VK_NULL_HANDLE,
-        .imageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-    });
-  }
+  return Result();
+}
 
-  // 3. Acceleration structures
-  std::vector<VkAccelerationStructureKHR> handlesAccelStructs;
-  handlesAccelStructs.reserve(accelStructuresPool_.objects_.size());
+lvk::Result lvk::VulkanContext::bindSparse(const VkSparseImageOpaqueMemoryBindInfo* opaqueBinds,
+                                           const VkSparseImageMemoryBindInfo* imageBinds,
+                                           bool hasUnbinds,
+                                           bool hasBinds) {
+  LVK_PROFILER_FUNCTION();
+  LVK_ASSERT(has_sparseResidency_);
 
-  // use the first valid TLAS as a dummy
-  const VkAccelerationStructureKHR dummyTLAS = [this]() -> VkAccelerationStructureKHR {
-    for (const auto& as : accelStructuresPool_.objects_) {
-      if (as.obj_.vkHandle && as.obj_.isTLAS)
-        return as.obj_.vkHandle;
+  VulkanImmediateCommands* queues[] = {immediate_.get(), immediateCompute_.get(), immediateTransfer_.get()};
+
+  VkSemaphore waitSemaphores[LVK_ARRAY_NUM_ELEMENTS(queues) + 1] = {};
+  uint64_t waitValues[LVK_ARRAY_NUM_ELEMENTS(queues) + 1] = {};
+  uint32_t numWaitSemaphores = 0;
+
+  // only unbinds have to wait for the submitted work which can still access the pages; freed pages are not reused until the GPU is
+  // done with them (see freeSparsePagesDeferred()), so new pages can be bound right away
+  if (hasUnbinds) {
+    for (VulkanImmediateCommands* queue : queues) {
+      const uint64_t value = queue->getTimelineValue(queue->getLastSubmitHandle());
+      if (value) {
+        waitSemaphores[numWaitSemaphores] = queue->getTimelineSemaphore();
+        waitValues[numWaitSemaphores++] = value;
+      }
     }
-    return VK_NULL_HANDLE;
-  }();
+  }
 
-  for (const auto& as : accelStructuresPool_.objects_) {
-    handlesAccelStructs.push_back(as.obj_.isTLAS ? as.obj_.vkHandle : dummyTLAS);
+  // vkQueueBindSparse() uses the graphics queue; also guards `sparseTimelineValue_`
+  std::unique_lock lockImmediate(immediate_->getMutex());
+
+  // keep the sparse binds in order
+  if (pimpl_->sparseTimelineValue_) {
+    waitSemaphores[numWaitSemaphores] = pimpl_->sparseTimelineSemaphore_;
+    waitValues[numWaitSemaphores++] = pimpl_->sparseTimelineValue_;
   }
 
-  VkWriteDescriptorSetAccelerationStructureKHR writeAccelStruct = {
-      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
-      .accelerationStructureCount = (uint32_t)handlesAccelStructs.size(),
-      .pAccelerationStructures = handlesAccelStructs.data(),
+  const uint64_t signalValue = pimpl_->sparseTimelineValue_ + 1;
+
+  const VkTimelineSemaphoreSubmitInfo timelineInfo = {
+      .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+      .waitSemaphoreValueCount = numWaitSemaphores,
+      .pWaitSemaphoreValues = waitValues,
+      .signalSemaphoreValueCount = 1,
+      .pSignalSemaphoreValues = &signalValue,
   };
+  const VkBindSparseInfo bi = {
+      .sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+      .pNext = &timelineInfo,
+      .waitSemaphoreCount = numWaitSemaphores,
+      .pWaitSemaphores = waitSemaphores,
+      .imageOpaqueBindCount = opaqueBinds ? 1u : 0u,
+      .pImageOpaqueBinds = opaqueBinds,
+      .imageBindCount = imageBinds ? 1u : 0u,
+      .pImageBinds = imageBinds,
+      .signalSemaphoreCount = 1,
+      .pSignalSemaphores = &pimpl_->sparseTimelineSemaphore_,
+  };
+  VK_ASSERT_RETURN(vkQueueBindSparse(deviceQueues_.graphicsQueue, 1, &bi, VK_NULL_HANDLE));
 
-  VkWriteDescriptorSet write[kBinding_NumBindings] = {};
-  uint32_t numWrites = 0;
+  pimpl_->sparseTimelineValue_ = signalValue;
 
-  if (!handlesAccelStructs.empty()) {
-    write[numWrites++] = VkWriteDescriptorSet{
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext = &writeAccelStruct,
-        .dstSet = dset.vkDSet,
-        .dstBinding = kBinding_AccelerationStructures,
-        .dstArrayElement = 0,
-        .descriptorCount = (uint32_t)handlesAccelStructs.size(),
-        .descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
-    };
+  if (!hasBinds) {
+    // nothing new to access
+    return Result();
   }
 
-  if (!infoSampledImages.empty()) {
-    write[numWrites++] = VkWriteDescriptorSet{
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .dstSet = dset.vkDSet,
-        .dstBinding = kBinding_Textures,
-        .dstArrayElement = 0,
-        .descriptorCount = (uint32_t)infoSampledImages.size(),
-        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-        .pImageInfo = infoSampledImages.data(),
-    };
-  }
+  // the next submits can access the new pages on any queue
+  immediate_->waitSemaphoreTimeline(pimpl_->sparseTimelineSemaphore_, signalValue);
 
-  if (!infoSamplers.empty()) {
-    write[numWrites++] = VkWriteDescriptorSet{
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .dstSet = dset.vkDSet,
-        .dstBinding = kBinding_Samplers,
-        .dstArrayElement = 0,
-        .descriptorCount = (uint32_t)infoSamplers.size(),
-        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
-        .pImageInfo = infoSamplers.data(),
-    };
+  lockImmediate.unlock();
+
+  immediateCompute_->waitSemaphoreTimeline(pimpl_->sparseTimelineSemaphore_, signalValue);
+  immediateTransfer_->waitSemaphoreTimeline(pimpl_->sparseTimelineSemaphore_, signalValue);
+
+  return Result();
+}
+
+uint32_t lvk::VulkanContext::allocateSparsePage(const VulkanSparseImage& sparse) {
+  // pimpl_->sparseMutex_ is locked by the caller
+  std::vector<VulkanContextImpl::SparseMemoryBlock>& blocks = pimpl_->sparseBlocks_;
+
+  for (uint32_t b = 0; b != blocks.size(); b++) {
+    VulkanContextImpl::SparseMemoryBlock& block = blocks[b];
+    if (block.memoryTypeBits_ == sparse.memoryTypeBits_ && block.pageSize_ == sparse.pageSize_ && !block.freePages_.empty()) {
+      const uint32_t page = block.freePages_.back();
+      block.freePages_.pop_back();
+      return b * VulkanContextImpl::kSparsePagesPerBlock + page;
+    }
   }
 
-  if (!infoStorageImages.empty()) {
-    write[numWrites++] = VkWriteDescriptorSet{
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .dstSet = dset.vkDSet,
-        .dstBinding = kBinding_StorageImages,
-        .dstArrayElement = 0,
-        .descriptorCount = (uint32_t)infoStorageImages.size(),
-        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-        .pImageInfo = infoStorageImages.data(),
-    };
+  const VkDeviceSize blockSize = sparse.pageSize_ * VulkanContextImpl::kSparsePagesPerBlock;
+  const VkMemoryRequirements2 memRequirements = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+      .memoryRequirements = {.size = blockSize, .alignment = sparse.pageSize_, .memoryTypeBits = sparse.memoryTypeBits_},
+  };
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+
+  const VkResult result =
+      lvk::allocateMemory2(vkPhysicalDevice_, vkDevice_, &memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &memory);
+
+  if (result != VK_SUCCESS) {
+    LLOGW("Cannot allocate a sparse page block: %s\n", lvk::getVulkanResultString(result));
+    return VulkanSparseImage::kUnbound;
   }
 
-  if (!infoYUVImages.empty()) {
-    write[numWrites++] = VkWriteDescriptorSet{
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .dstSet = dset.vkDSet,
-        .dstBinding = kBinding_YUVImages,
-        .dstArrayElement = 0,
-        .descriptorCount = (uint32_t)infoYUVImages.size(),
-        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-        .pImageInfo = infoYUVImages.data(),
-    };
+  trackMemory(MemoryCategory_SparsePages, blockSize, true);
+
+  VulkanContextImpl::SparseMemoryBlock block = {
+      .memory_ = memory,
+      .memoryTypeBits_ = sparse.memoryTypeBits_,
+      .pageSize_ = sparse.pageSize_,
+  };
+  // page 0 is returned right away
+  block.freePages_.reserve(VulkanContextImpl::kSparsePagesPerBlock);
+  for (uint32_t i = VulkanContextImpl::kSparsePagesPerBlock - 1; i != 0; i--) {
+    block.freePages_.push_back(i);
   }
 
-  // do not switch to the next descriptor set if there is nothing to update
-  if (numWrites) {
-#if LVK_VULKAN_PRINT_COMMANDS
-    LLOGL("vkUpdateDescriptorSets()\n");
-#endif // LVK_VULKAN_PRINT_COMMANDS
-    LVK_PROFILER_ZONE("vkUpdateDescriptorSets()", LVK_PROFILER_COLOR_PRESENT);
-    vkUpdateDescriptorSets(vkDevice_, numWrites, write, 0, nullptr);
-    LVK_PROFILER_ZONE_END();
+  blocks.push_back(std::move(block));
+
+  return uint32_t(blocks.size() - 1) * VulkanContextImpl::kSparsePagesPerBlock;
+}
+
+void lvk::VulkanContext::freeSparsePage(uint32_t page) {
+  // pimpl_->sparseMutex_ is locked by the caller
+  const uint32_t block = page / VulkanContextImpl::kSparsePagesPerBlock;
+
+  LVK_ASSERT(block < pimpl_->sparseBlocks_.size());
+
+  pimpl_->sparseBlocks_[block].freePages_.push_back(page % VulkanContextImpl::kSparsePagesPerBlock);
+}
+
+void lvk::VulkanContext::freeSparsePagesDeferred(std::vector<uint32_t>&& pages) {
+  if (pages.empty()) {
+    return;
   }
 
-  awaitingCreation_ = false;
+  // the submitted command buffers can still access the pages; they can be bound again once the GPU is done with them
+  deferredTask(std::packaged_task<void()>([this, pages = std::move(pages)]() {
+    std::lock_guard lock(pimpl_->sparseMutex_);
+    for (uint32_t page : pages) {
+      freeSparsePage(page);
+    }
+  }));
 }
 
-lvk::SamplerHandle lvk::VulkanContext::createSampler(const VkSamplerCreateInfo& ci,
-                                                     lvk::Result* outResult,
-                                                     lvk::Format yuvFormat,
-                                                     const char* debugName) {
-  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+lvk::TimingScopeRef lvk::VulkanContext::beginTimingScope(VkCommandBuffer cmdBuf, const char* name, uint32_t depth, uint32_t numViews) {
+  std::lock_guard lock(pimpl_->timingMutex_);
 
-  VkSamplerCreateInfo cinfo = ci;
+  if (pimpl_->isTimingFrameDropped_ || !pimpl_->isTimingSupported_) {
+    return {};
+  }
 
-  if (yuvFormat != Format_Invalid) {
-    cinfo.pNext = getOrCreateYcbcrConversionInfo(yuvFormat);
-    // must be CLAMP_TO_EDGE
-    // https://vulkan.lunarg.com/doc/view/1.3.268.0/windows/1.3-extensions/vkspec.html#VUID-VkSamplerCreateInfo-addressModeU-01646
-    cinfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    cinfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    cinfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    cinfo.anisotropyEnable = VK_FALSE;
-    cinfo.unnormalizedCoordinates = VK_FALSE;
+  if (!pimpl_->hasTimingQueryPools_) {
+    // query pools are reset on the host, so that timing scopes can be recorded into any command buffer in any order
+    if (!vkFeatures12_.hostQueryReset || !getVkPhysicalDeviceProperties().limits.timestampComputeAndGraphics) {
+      LLOGW("GPU timing scopes are not supported: hostQueryReset and timestampComputeAndGraphics are required\n");
+      pimpl_->isTimingSupported_ = false;
+      return {};
+    }
+    const VkQueryPoolCreateInfo ci = {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = VulkanContextImpl::kMaxTimingQueries,
+    };
+    for (VulkanContextImpl::TimingFrame& f : pimpl_->timingFrames_) {
+      VK_ASSERT(vkCreateQueryPool(vkDevice_, &ci, nullptr, &f.queryPool_));
+      VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)f.queryPool_, "Query Pool: timing scopes"));
+      vkResetQueryPool(vkDevice_, f.queryPool_, 0, VulkanContextImpl::kMaxTimingQueries);
+    }
+    pimpl_->hasTimingQueryPools_ = true;
   }
 
-  VkSampler sampler = VK_NULL_HANDLE;
-  VK_ASSERT(vkCreateSampler(vkDevice_, &cinfo, nullptr, &sampler));
-  VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_SAMPLER, (uint64_t)sampler, debugName));
+  VulkanContextImpl::TimingFrame& f = pimpl_->timingFrames_[pimpl_->currentTimingFrame_];
 
-  SamplerHandle handle = samplersPool_.create(VkSampler(sampler));
+  // reserve the queries for the end of this scope as well
+  if (f.stats_.numScopes >= FrameStats::LVK_MAX_GPU_TIMING_SCOPES || f.numQueries_ + 2 * numViews > VulkanContextImpl::kMaxTimingQueries) {
+    return {};
+  }
 
-  awaitingCreation_ = true;
+  const uint32_t scope = f.stats_.numScopes++;
 
-  return handle;
-}
+  GpuTimingScope& s = f.stats_.scopes[scope];
+  s = {.depth = depth};
+  strncpy(s.name, name, sizeof(s.name) - 1);
 
-void lvk::VulkanContext::querySurfaceCapabilities() {
-  // enumerate only the formats we are using
-  const VkFormat depthFormats[] = {
-      VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D16_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM};
-  for (const VkFormat& depthFormat : depthFormats) {
-    VkFormatProperties2 props = {
-        .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2,
-    };
-    vkGetPhysicalDeviceFormatProperties2(vkPhysicalDevice_, depthFormat, &props);
+  f.beginQueries_[scope] = f.numQueries_;
+  f.endQueries_[scope] = ~0u;
+  f.numQueries_ += numViews;
 
-    if (props.formatProperties.optimalTilingFeatures) {
-      deviceDepthFormats_.push_back(depthFormat);
-    }
+  vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, f.queryPool_, f.beginQueries_[scope]);
+
+  return {
+      .frameIndex = pimpl_->timingFrameIndex_,
+      .frame = pimpl_->currentTimingFrame_,
+      .scope = scope,
+  };
+}
+
+void lvk::VulkanContext::endTimingScope(VkCommandBuffer cmdBuf, const TimingScopeRef& ref, uint32_t numViews) {
+  if (ref.scope == ~0u) {
+    return;
   }
 
-  if (vkSurface_ == VK_NULL_HANDLE) {
+  std::lock_guard lock(pimpl_->timingMutex_);
+
+  VulkanContextImpl::TimingFrame& f = pimpl_->timingFrames_[ref.frame];
+
+  // the frame might have been resolved and recycled while this scope was open
+  if (f.stats_.frameIndex != ref.frameIndex || (!f.isPending_ && ref.frame != pimpl_->currentTimingFrame_)) {
+    return;
+  }
+  if (f.numQueries_ + numViews > VulkanContextImpl::kMaxTimingQueries) {
     return;
   }
 
-  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkPhysicalDevice_, vkSurface_, &deviceSurfaceCaps_);
+  f.endQueries_[ref.scope] = f.numQueries_;
+  f.numQueries_ += numViews;
 
-  uint32_t formatCount;
-  vkGetPhysicalDeviceSurfaceFormatsKHR(vkPhysicalDevice_, vkSurface_, &formatCount, nullptr);
+  vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, f.queryPool_, f.endQueries_[ref.scope]);
+}
 
-  if (formatCount) {
-    deviceSurfaceFormats_.resize(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(vkPhysicalDevice_, vkSurface_, &formatCount, deviceSurfaceFormats_.data());
+void lvk::VulkanContext::addCommandBufferStats(const CommandBufferStats& stats) {
+  std::lock_guard lock(pimpl_->timingMutex_);
+
+  if (pimpl_->isTimingFrameDropped_) {
+    return;
   }
 
-  uint32_t presentModeCount;
-  vkGetPhysicalDeviceSurfacePresentModesKHR(vkPhysicalDevice_, vkSurface_, &presentModeCount, nullptr);
+  FrameStats& s = pimpl_->timingFrames_[pimpl_->currentTimingFrame_].stats_;
 
-  if (presentModeCount) {
-    devicePresentModes_.resize(presentModeCount);
-    vkGetPhysicalDeviceSurfacePresentModesKHR(vkPhysicalDevice_, vkSurface_, &presentModeCount, devicePresentModes_.data());
+  if (s.numCommandBuffers < FrameStats::LVK_MAX_FRAME_COMMAND_BUFFERS) {
+    s.commandBuffers[s.numCommandBuffers++] = stats;
   }
+  s.total.numDrawCalls += stats.numDrawCalls;
+  s.total.numDispatches += stats.numDispatches;
+  s.total.numBarriers += stats.numBarriers;
+  s.total.numRedundantBinds += stats.numRedundantBinds;
 }
 
-std::vector<uint8_t> lvk::VulkanContext::getPipelineCacheData() const {
-  size_t size = 0;
-  vkGetPipelineCacheData(vkDevice_, pipelineCache_, &size, nullptr);
+void lvk::VulkanContext::endTimingFrame() {
+  std::lock_guard lock(pimpl_->timingMutex_);
 
-  std::vector<uint8_t> data(size);
+  if (!pimpl_->isTimingFrameDropped_) {
+    VulkanContextImpl::TimingFrame& f = pimpl_->timingFrames_[pimpl_->currentTimingFrame_];
+    f.handle_ = immediate_->getLastSubmitHandle();
+    f.computeHandle_ = immediateCompute_->getLastSubmitHandle();
+    f.isPending_ = true;
+    pimpl_->currentTimingFrame_ = (pimpl_->currentTimingFrame_ + 1) % VulkanContextImpl::kNumTimingFrames;
+  }
 
-  if (size) {
-    vkGetPipelineCacheData(vkDevice_, pipelineCache_, &size, data.data());
+  pimpl_->timingFrameIndex_++;
+
+  // pending frames are resolved in order, starting from the oldest one which follows the current frame
+  for (uint32_t i = 0; i != VulkanContextImpl::kNumTimingFrames; i++) {
+    const uint32_t frame = (pimpl_->currentTimingFrame_ + i) % VulkanContextImpl::kNumTimingFrames;
+    if (pimpl_->timingFrames_[frame].isPending_ && !resolveTimingFrame(frame)) {
+      break;
+    }
   }
 
-  return data;
-}
+  VulkanContextImpl::TimingFrame& f = pimpl_->timingFrames_[pimpl_->currentTimingFrame_];
 
-void lvk::VulkanContext::deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) const {
-  if (handle.empty()) {
-    handle = immediate_->getNextSubmitHandle();
+  // the GPU is too far behind - drop this frame instead of waiting
+  pimpl_->isTimingFrameDropped_ = f.isPending_;
+
+  if (!f.isPending_) {
+    f.numQueries_ = 0;
+    f.stats_ = {.frameIndex = pimpl_->timingFrameIndex_};
   }
-  pimpl_->deferredTasks_.emplace_back(std::move(task), handle);
 }
 
-void* lvk::VulkanContext::getVmaAllocator() const {
-  return pimpl_->vma_;
-}
+bool lvk::VulkanContext::resolveTimingFrame(uint32_t frame) {
+  VulkanContextImpl::TimingFrame& f = pimpl_->timingFrames_[frame];
 
-void lvk::VulkanContext::processDeferredTasks() const {
-  std::vector<DeferredTask>::iterator it = pimpl_->deferredTasks_.begin();
+  LVK_ASSERT(f.isPending_);
 
-  while (it != pimpl_->deferredTasks_.end() && immediate_->isReady(it->handle_, true)) {
-    (it++)->task_();
-  }
+  if (f.numQueries_) {
+    uint64_t timestamps[VulkanContextImpl::kMaxTimingQueries];
 
-  pimpl_->deferredTasks_.erase(pimpl_->deferredTasks_.begin(), it);
-}
+    auto getResults = [this, &f, &timestamps]() -> VkResult {
+      // no VK_QUERY_RESULT_WAIT_BIT: VK_NOT_READY means some timestamps are not available yet
+      return vkGetQueryPoolResults(vkDevice_,
+                                   f.queryPool_,
+                                   0,
+                                   f.numQueries_,
+                                   f.numQueries_ * sizeof(uint64_t),
+                                   timestamps,
+                                   sizeof(uint64_t),
+                                   VK_QUERY_RESULT_64_BIT);
+    };
 
-void lvk::VulkanContext::waitDeferredTasks() {
-  for (auto& task : pimpl_->deferredTasks_) {
-    immediate_->wait(task.handle_);
-    task.task_();
+    VkResult result = getResults();
+
+    if (result == VK_NOT_READY) {
+      if (!immediate_->isReady(f.handle_) || !immediateCompute_->isReady(f.computeHandle_)) {
+        return false;
+      }
+      // everything submitted during the frame has completed - query again in case it finished after the first query
+      result = getResults();
+    }
+
+    if (result == VK_NOT_READY) {
+      // some scopes were recorded into command buffers which were never submitted; drop the frame instead of blocking the ring
+      vkResetQueryPool(vkDevice_, f.queryPool_, 0, f.numQueries_);
+      f.isPending_ = false;
+      return true;
+    }
+    VK_ASSERT(result);
+
+    // pair a GPU timestamp with the CPU time to convert timestamps into std::chrono::steady_clock nanoseconds
+    uint64_t calibratedTimestamp = 0;
+    int64_t calibratedTimeNs = 0;
+    if (has_KHR_calibrated_timestamps_) {
+      const VkCalibratedTimestampInfoEXT info = {
+          .sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT,
+          .timeDomain = VK_TIME_DOMAIN_DEVICE_EXT,
+      };
+      auto getTimeNs = []() -> int64_t {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      };
+      uint64_t maxDeviation = 0;
+      const int64_t before = getTimeNs();
+      if (vkGetCalibratedTimestampsEXT(vkDevice_, 1, &info, &calibratedTimestamp, &maxDeviation) == VK_SUCCESS) {
+        calibratedTimeNs = before + (getTimeNs() - before) / 2;
+      }
+    }
+
+    const double timestampPeriodNs = getVkPhysicalDeviceProperties().limits.timestampPeriod;
+    const double toMs = getTimestampPeriodToMs();
+
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    for (uint32_t i = 0; i != f.stats_.numScopes; i++) {
+      first = std::min(first, timestamps[f.beginQueries_[i]]);
+      if (f.endQueries_[i] != ~0u) {
+        last = std::max(last, timestamps[f.endQueries_[i]]);
+      }
+    }
+    for (uint32_t i = 0; i != f.stats_.numScopes; i++) {
+      GpuTimingScope& s = f.stats_.scopes[i];
+      const uint64_t begin = timestamps[f.beginQueries_[i]];
+      s.beginMs = double(begin - first) * toMs;
+      s.durationMs = f.endQueries_[i] != ~0u ? double(timestamps[f.endQueries_[i]] - begin) * toMs : 0.0;
+      if (calibratedTimeNs) {
+        s.cpuTimeNs = calibratedTimeNs + int64_t(double(int64_t(begin - calibratedTimestamp)) * timestampPeriodNs);
+      }
+    }
+    f.stats_.gpuTimeMs = last > first ? double(last - first) * toMs : 0.0;
+
+    vkResetQueryPool(vkDevice_, f.queryPool_, 0, f.numQueries_);
   }
-  pimpl_->deferredTasks_.clear();
-}
 
-uint32_t lvk::VulkanContext::getMaxStorageBufferRange() const {
-  return vkPhysicalDeviceProperties2_.properties.limits.maxStorageBufferRange;
+  f.isPending_ = false;
+
+  pimpl_->lastFrameStats_ = f.stats_;
+  pimpl_->hasFrameStats_ = true;
+
+  return true;
 }
 
 bool lvk::VulkanContext::isExtensionEnabled(const char* ext) const {
@@ -10,24 +10,53 @@
 #include <lvk/Pool.h>
 #include <lvk/vulkan/VulkanUtils.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace lvk {
 
 class VulkanContext;
+struct DeferredBucket;
 
 struct DeviceQueues final {
   const static uint32_t INVALID = 0xFFFFFFFF;
   uint32_t graphicsQueueFamilyIndex = INVALID;
   uint32_t computeQueueFamilyIndex = INVALID;
+  uint32_t transferQueueFamilyIndex = INVALID;
 
   VkQueue graphicsQueue = VK_NULL_HANDLE;
   VkQueue computeQueue = VK_NULL_HANDLE;
+  VkQueue transferQueue = VK_NULL_HANDLE;
 };
 
-struct VulkanBuffer final {
+// raw Vulkan objects and bindless descriptor slots retired by VulkanContext::deferredDestroy() without any closures
+enum DeferredObjectType : uint8_t {
+  DeferredObjectType_Buffer = 0, // with an optional VmaAllocation
+  DeferredObjectType_Image, // with an optional VmaAllocation
+  DeferredObjectType_ImageView,
+  DeferredObjectType_DeviceMemory,
+  DeferredObjectType_Sampler,
+  DeferredObjectType_Pipeline,
+  DeferredObjectType_PipelineLayout,
+  DeferredObjectType_QueryPool,
+  DeferredObjectType_AccelStruct,
+  DeferredObjectType_DescriptorSetLayout,
+  DeferredObjectType_DescriptorPool,
+  // the object is a pool index which can be reused and has to be rewritten in the descriptor sets
+  DeferredObjectType_TextureSlot,
+  DeferredObjectType_SamplerSlot,
+  DeferredObjectType_AccelStructSlot,
+};
+
+// aligned to a cache line: resolving a BufferHandle in the draw loop touches exactly one cache line
+struct alignas(64) VulkanBuffer final {
   // clang-format off
   [[nodiscard]] inline uint8_t* getMappedPtr() const { return static_cast<uint8_t*>(mappedPtr_); }
   [[nodiscard]] inline bool isMapped() const { return mappedPtr_ != nullptr;  }
@@ -48,9 +77,31 @@ struct VulkanBuffer final {
   VkMemoryPropertyFlags vkMemFlags_ = 0;
   void* mappedPtr_ = nullptr;
   bool isCoherentMemory_ = false;
+  bool isShared_ = false; // VK_SHARING_MODE_CONCURRENT
+  lvk::MemoryCategory memoryCategory_ = MemoryCategory_Buffer;
 };
 
-struct VulkanImage final {
+// page tables of a sparse texture (see TextureDesc::sparse); owned by the VulkanImage which owns the VkImage
+struct VulkanSparseImage final {
+  static constexpr uint32_t kUnbound = ~0u;
+
+  VkExtent3D pageExtent_ = {0, 0, 0}; // sparse image format granularity
+  VkDeviceSize pageSize_ = 0; // VkMemoryRequirements::alignment
+  uint32_t memoryTypeBits_ = 0;
+  uint32_t firstMipTailLevel_ = 0;
+  uint32_t levelFirstPage_[LVK_MAX_MIP_LEVELS] = {};
+  uint32_t levelPagesPerRow_[LVK_MAX_MIP_LEVELS] = {};
+  uint32_t numPages_ = 0;
+  uint32_t numResidentPages_ = 0;
+  std::vector<uint32_t> pages_; // page pool ids, or kUnbound
+  VkDeviceMemory mipTailMemory_ = VK_NULL_HANDLE;
+  VkDeviceSize mipTailSize_ = 0;
+  BufferHandle feedback_; // owned
+  uint32_t feedbackOffset_ = 0;
+};
+
+// the hot fields used when resolving a TextureHandle (recording commands, updating descriptors) fit into the first cache line
+struct alignas(64) VulkanImage final {
   // clang-format off
   [[nodiscard]] inline bool isSampledImage() const { return (vkUsageFlags_ & VK_IMAGE_USAGE_SAMPLED_BIT) > 0; }
   [[nodiscard]] inline bool isStorageImage() const { return (vkUsageFlags_ & VK_IMAGE_USAGE_STORAGE_BIT) > 0; }
@@ -80,6 +131,10 @@ struct VulkanImage final {
 
   void generateMipmap(VkCommandBuffer commandBuffer) const;
   void transitionLayout(VkCommandBuffer commandBuffer, VkImageLayout newImageLayout, const VkImageSubresourceRange& subresourceRange) const;
+  // update the tracked layout and return a barrier to be recorded by the caller; returns false if no barrier is required
+  [[nodiscard]] bool transitionLayout(VkImageLayout newImageLayout,
+                                      const VkImageSubresourceRange& subresourceRange,
+                                      VkImageMemoryBarrier2& outBarrier) const;
 
   [[nodiscard]] VkImageAspectFlags getImageAspectFlags() const;
 
@@ -90,29 +145,36 @@ struct VulkanImage final {
   [[nodiscard]] static bool isStencilFormat(VkFormat format);
 
  public:
+  // hot: the first 64 bytes
   VkImage vkImage_ = VK_NULL_HANDLE;
+  // precached image views - owned by this VulkanImage
+  VkImageView imageView_ = VK_NULL_HANDLE; // default view with all mip-levels
+  VkImageView imageViewStorage_ = VK_NULL_HANDLE; // default view with identity swizzle (all mip-levels)
+  // current image layout
+  mutable VkImageLayout vkImageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
   VkImageUsageFlags vkUsageFlags_ = 0;
-  VkDeviceMemory vkMemory_[3] = {VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE};
-  VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
-  VkFormatProperties vkFormatProperties_ = {};
-  VkExtent3D vkExtent_ = {0, 0, 0};
-  VkImageType vkType_ = VK_IMAGE_TYPE_MAX_ENUM;
   VkFormat vkImageFormat_ = VK_FORMAT_UNDEFINED;
   VkSampleCountFlagBits vkSamples_ = VK_SAMPLE_COUNT_1_BIT;
-  void* mappedPtr_ = nullptr;
-  bool isSwapchainImage_ = false;
-  bool isOwningVkImage_ = true;
-  bool isResolveAttachment = false; // autoset by cmdBeginRendering() for extra synchronization
+  VkExtent3D vkExtent_ = {0, 0, 0};
   uint32_t numLevels_ = 1u;
   uint32_t numLayers_ = 1u;
   bool isDepthFormat_ = false;
   bool isStencilFormat_ = false;
+  bool isSwapchainImage_ = false;
+  bool isResolveAttachment = false; // autoset by cmdBeginRendering() for extra synchronization
+  // cold: creation and destruction
+  VkImageType vkType_ = VK_IMAGE_TYPE_MAX_ENUM;
+  VkDeviceMemory vkMemory_[3] = {VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE};
+  VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
+  VkFormatProperties vkFormatProperties_ = {};
+  void* mappedPtr_ = nullptr;
+  VkDeviceSize memorySize_ = 0; // accounted in MemoryStats when the image owns its memory
+  bool isOwningVkImage_ = true;
+  bool isOwningVkMemory_ = true; // false if the memory belongs to another image (see TextureDesc::aliasTexture)
+  bool isMemoryAliased_ = false; // other images can write into the same memory
+  bool isShared_ = false; // VK_SHARING_MODE_CONCURRENT
+  VulkanSparseImage* sparse_ = nullptr; // owned if isOwningVkImage_, texture views share it
   char debugName_[256] = {0};
-  // current image layout
-  mutable VkImageLayout vkImageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
-  // precached image views - owned by this VulkanImage
-  VkImageView imageView_ = VK_NULL_HANDLE; // default view with all mip-levels
-  VkImageView imageViewStorage_ = VK_NULL_HANDLE; // default view with identity swizzle (all mip-levels)
   VkImageView imageViewForFramebuffer_[LVK_MAX_MIP_LEVELS][6] = {}; // max 6 faces for cubemap rendering
   VkImageView imageViewForFramebufferMultiview_[LVK_MAX_MIP_LEVELS] = {};
 };
@@ -133,6 +195,10 @@ class VulkanSwapchain final {
   uint32_t getNumSwapchainImages() const;
   // runtime present mode switching without swapchain recreation (VK_KHR_swapchain_maintenance1), returns `false` if the mode cannot be set
   [[nodiscard]] bool setCurrentPresentMode(VkPresentModeKHR mode);
+  // see IContext::waitForNextFrame()
+  void waitForNextFrame();
+  // VK_NV_low_latency2 markers for the current frame
+  void setLatencyMarker(VkLatencyMarkerNV marker) const;
 
  public:
   VulkanContext& ctx_;
@@ -165,15 +231,31 @@ class VulkanSwapchain final {
   VkFence presentFence_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
   VkFence acquireFence_[LVK_MAX_SWAPCHAIN_IMAGES] = {}; // remove once VK_EXT_swapchain_maintenance1 becomes mandatory
   uint64_t timelineWaitValues_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
+  // frame pacing: the present id of a frame is `frameIndex + 1`
+  VkSemaphore latencySemaphore_ = VK_NULL_HANDLE; // VK_NV_low_latency2
+  uint64_t latencySemaphoreValue_ = 0;
+  std::chrono::steady_clock::time_point frameStartTime_[LVK_MAX_SWAPCHAIN_IMAGES] = {}; // when waitForNextFrame() returned
+  double frameSleepMs_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
+  std::chrono::steady_clock::time_point lastPresentTime_ = {};
+  bool hasPresentTimings_ = false;
+  PresentTimings presentTimings_ = {};
 };
 
 class VulkanImmediateCommands final {
  public:
-  // the maximum number of command buffers which can similtaneously exist in the system; when we run out of buffers, we stall and wait until
-  // an existing buffer becomes available
-  static constexpr uint32_t kMaxCommandBuffers = 64;
-
-  VulkanImmediateCommands(VkDevice device, uint32_t queueFamilyIndex, bool has_EXT_device_fault, const char* debugName);
+  // the default number of command buffers which can simultaneously exist per queue; when we run out of buffers, we block until the oldest
+  // submitted buffer is retired by the GPU
+  static constexpr uint32_t kMaxCommandBuffers = LVK_MAX_COMMAND_BUFFERS;
+  // the queue type is stored in the upper bits of SubmitHandle::bufferIndex_
+  static constexpr uint32_t kQueueTypeShift = 30;
+  static constexpr uint32_t kMaxTimelineWaits = 4;
+
+  VulkanImmediateCommands(VkDevice device,
+                          uint32_t queueFamilyIndex,
+                          lvk::QueueType queueType,
+                          bool has_EXT_device_fault,
+                          const char* debugName,
+                          uint32_t maxCommandBuffers = kMaxCommandBuffers);
   ~VulkanImmediateCommands();
   VulkanImmediateCommands(const VulkanImmediateCommands&) = delete;
   VulkanImmediateCommands& operator=(const VulkanImmediateCommands&) = delete;
@@ -182,8 +264,8 @@ class VulkanImmediateCommands final {
     VkCommandBuffer cmdBuf_ = VK_NULL_HANDLE;
     VkCommandBuffer cmdBufAllocated_ = VK_NULL_HANDLE;
     SubmitHandle handle_ = {};
-    VkFence fence_ = VK_NULL_HANDLE;
     VkSemaphore semaphore_ = VK_NULL_HANDLE;
+    uint64_t timelineValue_ = 0; // the value of `timelineSemaphore_` signaled by this submit; the buffer is retired once it is reached
     bool isEncoding_ = false;
   };
 
@@ -192,25 +274,55 @@ class VulkanImmediateCommands final {
   SubmitHandle submit(const CommandBufferWrapper& wrapper);
   void waitSemaphore(VkSemaphore semaphore);
   void signalSemaphore(VkSemaphore semaphore, uint64_t signalValue);
+  // wait for a timeline semaphore value (usually from another queue) in the next submit
+  void waitSemaphoreTimeline(VkSemaphore semaphore, uint64_t value);
   VkSemaphore acquireLastSubmitSemaphore();
-  VkFence getVkFence(SubmitHandle handle) const;
+  VkSemaphore getTimelineSemaphore() const {
+    return timelineSemaphore_;
+  }
+  // returns 0 if the handle has already completed
+  uint64_t getTimelineValue(SubmitHandle handle) const;
+  lvk::QueueType getQueueType() const {
+    return queueType_;
+  }
+  static lvk::QueueType getQueueType(SubmitHandle handle) {
+    return lvk::QueueType(handle.bufferIndex_ >> kQueueTypeShift);
+  }
   SubmitHandle getLastSubmitHandle() const;
   SubmitHandle getNextSubmitHandle() const;
   bool isReady(SubmitHandle handle, bool fastCheckNoVulkan = false) const;
   void wait(SubmitHandle handle);
   void waitAll();
+  // all methods are thread-safe; lock this to make a sequence of calls atomic, e.g. signalSemaphore() followed by submit()
+  std::recursive_mutex& getMutex() const {
+    return mutex_;
+  }
 
  private:
+  // retires all submitted buffers whose timeline values have been reached by the GPU
   void purge();
+  // fetches the current value of `timelineSemaphore_` into `completedTimelineValue_`
+  uint64_t updateCompletedTimelineValue() const;
+  // blocks without holding `mutex_` unless the caller holds it
+  void waitTimelineValue(uint64_t value);
+  static uint32_t getBufferIndex(SubmitHandle handle) {
+    return handle.bufferIndex_ & ((1u << kQueueTypeShift) - 1);
+  }
 
  private:
   VkDevice device_ = VK_NULL_HANDLE;
   VkQueue queue_ = VK_NULL_HANDLE;
   VkCommandPool commandPool_ = VK_NULL_HANDLE;
   uint32_t queueFamilyIndex_ = 0;
+  lvk::QueueType queueType_ = lvk::QueueType_Graphics;
   bool has_EXT_device_fault_ = false;
   const char* debugName_ = "";
-  CommandBufferWrapper buffers_[kMaxCommandBuffers];
+  std::vector<CommandBufferWrapper> buffers_; // never resized after construction, acquire() returns references into it
+  std::vector<uint32_t> freeBuffers_; // indices of buffers ready to be acquired, the most recently retired ones are at the back
+  // indices of submitted buffers in the submission order (ascending timeline values), a ring buffer of buffers_.size() elements
+  std::vector<uint32_t> submittedBuffers_;
+  uint32_t firstSubmittedBuffer_ = 0;
+  uint32_t numSubmittedBuffers_ = 0;
   SubmitHandle lastSubmitHandle_ = SubmitHandle();
   SubmitHandle nextSubmitHandle_ = SubmitHandle();
   VkSemaphoreSubmitInfo lastSubmitSemaphore_ = {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
@@ -219,8 +331,15 @@ class VulkanImmediateCommands final {
                                           .stageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT}; // extra "wait" semaphore
   VkSemaphoreSubmitInfo signalSemaphore_ = {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
                                             .stageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT}; // extra "signal" semaphore
-  uint32_t numAvailableCommandBuffers_ = kMaxCommandBuffers;
+  VkSemaphoreSubmitInfo waitTimelineSemaphores_[kMaxTimelineWaits] = {};
+  uint32_t numWaitTimelineSemaphores_ = 0;
+  // signaled by every submit with an incrementing value; used for cross-queue synchronization
+  VkSemaphore timelineSemaphore_ = VK_NULL_HANDLE;
+  uint64_t timelineValue_ = 0;
+  mutable uint64_t completedTimelineValue_ = 0; // the last value of `timelineSemaphore_` observed on the CPU
   uint32_t submitCounter_ = 1;
+  mutable std::recursive_mutex mutex_;
+  std::condition_variable_any submitted_; // notified by submit(), acquire() waits on it when all buffers are being encoded
 };
 
 struct RenderPipelineState final {
@@ -238,10 +357,15 @@ struct RenderPipelineState final {
   VkShaderStageFlags shaderStageFlags_ = 0;
   VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
   VkPipeline pipeline_ = VK_NULL_HANDLE;
+  std::shared_future<VkPipeline> pendingPipeline_; // compiled on a background thread, becomes `pipeline_` once ready
 
   void* specConstantDataStorage_ = nullptr;
 
   uint32_t viewMask_ = 0;
+
+  // VK_EXT_extended_dynamic_state3: the static state only; pipelines with equal keys share one VkPipeline
+  std::string staticStateKey_;
+  uint64_t sharedPipelineKey_ = 0; // non-zero if `pipeline_` and `pipelineLayout_` are owned by VulkanContextImpl::sharedRenderPipelines_
 };
 
 class VulkanPipelineBuilder final {
@@ -270,6 +394,8 @@ class VulkanPipelineBuilder final {
   VulkanPipelineBuilder& depthAttachmentFormat(VkFormat format);
   VulkanPipelineBuilder& stencilAttachmentFormat(VkFormat format);
   VulkanPipelineBuilder& patchControlPoints(uint32_t numPoints);
+  VulkanPipelineBuilder& flags(VkPipelineCreateFlags flags);
+  VulkanPipelineBuilder& creationFeedback(VkPipelineCreationFeedback* feedback);
 
   VkResult build(VkDevice device,
                  VkPipelineCache pipelineCache,
@@ -304,7 +430,10 @@ class VulkanPipelineBuilder final {
   VkFormat depthAttachmentFormat_ = VK_FORMAT_UNDEFINED;
   VkFormat stencilAttachmentFormat_ = VK_FORMAT_UNDEFINED;
 
-  static uint32_t numPipelinesCreated_;
+  VkPipelineCreateFlags flags_ = 0;
+  VkPipelineCreationFeedback* creationFeedback_ = nullptr;
+
+  static std::atomic<uint32_t> numPipelinesCreated_; // pipelines can be built on background threads
 };
 
 struct ComputePipelineState final {
@@ -315,6 +444,7 @@ struct ComputePipelineState final {
 
   VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
   VkPipeline pipeline_ = VK_NULL_HANDLE;
+  std::shared_future<VkPipeline> pendingPipeline_; // compiled on a background thread, becomes `pipeline_` once ready
 
   void* specConstantDataStorage_ = nullptr;
 };
@@ -328,6 +458,7 @@ struct RayTracingPipelineState final {
   VkShaderStageFlags shaderStageFlags_ = 0;
   VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
   VkPipeline pipeline_ = VK_NULL_HANDLE;
+  std::shared_future<VkPipeline> pendingPipeline_; // compiled on a background thread, becomes `pipeline_` once ready
 
   void* specConstantDataStorage_ = nullptr;
 
@@ -350,6 +481,15 @@ struct ShaderModuleState final {
   uint32_t pushConstantsSize = 0;
 };
 
+struct RayTracingShaderModules final {
+  const ShaderModuleState* rayGen[RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_SHADERS] = {};
+  const ShaderModuleState* miss[RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_SHADERS] = {};
+  const ShaderModuleState* callable[RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_SHADERS] = {};
+  const ShaderModuleState* anyHit[RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_HIT_GROUPS] = {};
+  const ShaderModuleState* closestHit[RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_HIT_GROUPS] = {};
+  const ShaderModuleState* intersection[RayTracingPipelineDesc::LVK_MAX_RAY_TRACING_HIT_GROUPS] = {};
+};
+
 struct AccelerationStructure {
   bool isTLAS = false;
   VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo = {};
@@ -357,12 +497,33 @@ struct AccelerationStructure {
   uint64_t deviceAddress = 0;
   lvk::Holder<lvk::BufferHandle> buffer;
   lvk::Holder<lvk::BufferHandle> scratchBuffer; // Store only for TLAS
+  // TLAS only: what cmdUpdateTLAS() needs to refit or rebuild it
+  uint8_t buildFlags = 0;
+  VkGeometryFlagsKHR geometryFlags = 0;
+  uint32_t maxNumRefits = 0;
+  uint32_t numRefits = 0;
+  bool isShared = false;
+};
+
+struct ReadbackState final {
+  lvk::Holder<lvk::BufferHandle> buffer_; // host-visible; recycled for new readbacks once this one is destroyed
+  size_t size_ = 0;
+  SubmitHandle handle_ = {}; // the submit which copies the data into `buffer_`
+  bool isInvalidated_ = false;
+};
+
+// an open GPU timing scope - see VulkanContext::beginTimingScope()
+struct TimingScopeRef {
+  uint64_t frameIndex = 0;
+  uint32_t frame = 0; // index of the timing frame
+  uint32_t scope = ~0u; // ~0u if the scope is not timed
 };
 
 class CommandBuffer final : public ICommandBuffer {
  public:
   CommandBuffer() = default;
-  explicit CommandBuffer(VulkanContext* ctx);
+  explicit CommandBuffer(VulkanContext* ctx, QueueType queue = QueueType_Graphics);
+  CommandBuffer(VulkanContext* ctx, const VulkanImmediateCommands::CommandBufferWrapper* secondaryWrapper);
   ~CommandBuffer() override;
 
   CommandBuffer& operator=(CommandBuffer&& other) = default;
@@ -383,9 +544,16 @@ class CommandBuffer final : public ICommandBuffer {
   void cmdInsertDebugEventLabel(const char* label, uint32_t colorRGBA) const override;
   void cmdPopDebugGroupLabel() const override;
 
+  void cmdBeginTimingScope(const char* name, uint32_t colorRGBA) override;
+  void cmdEndTimingScope() override;
+  [[nodiscard]] const CommandBufferStats& getStats() const override {
+    return stats_;
+  }
+
   void cmdBeginRendering(const lvk::RenderPass& renderPass, const lvk::Framebuffer& desc, const Dependencies& deps) override;
   void cmdEndRendering() override;
   void cmdNextSubpass() override;
+  void cmdExecuteCommands(ICommandBuffer* const* secondaryCommandBuffers, uint32_t numCommandBuffers) override;
 
   void cmdBindViewport(const Viewport& viewport) override;
   void cmdBindScissorRect(const ScissorRect& rect) override;
@@ -441,7 +609,8 @@ class CommandBuffer final : public ICommandBuffer {
                     const TextureLayers& srcLayers,
                     const TextureLayers& dstLayers) override;
   void cmdGenerateMipmap(TextureHandle handle) override;
-  void cmdUpdateTLAS(AccelStructHandle handle, BufferHandle instancesBuffer) override;
+  void cmdGenerateMipmaps(const TextureHandle* handles, uint32_t numTextures) override;
+  void cmdUpdateTLAS(AccelStructHandle handle, BufferHandle instancesBuffer, bool forceRebuild) override;
 
   VkCommandBuffer getVkCommandBuffer() const {
     return wrapper_ ? wrapper_->cmdBuf_ : VK_NULL_HANDLE;
@@ -450,6 +619,14 @@ class CommandBuffer final : public ICommandBuffer {
  private:
   void useComputeTexture(TextureHandle texture, VkPipelineStageFlags2 dstStage);
   void bufferBarrier(BufferHandle handle, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage);
+  void imageBarrier(const lvk::VulkanImage& image, VkImageLayout newImageLayout, const VkImageSubresourceRange& subresourceRange);
+  // record all pending barriers with one vkCmdPipelineBarrier2()
+  void flushBarriers();
+  // timestamps use one query per view inside multiview render passes
+  uint32_t getNumTimestampViews() const;
+  // forget all shadowed state when the state of the Vulkan command buffer becomes undefined
+  void resetBoundState();
+  void bindDefaultDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout);
 
  private:
   friend class VulkanContext;
@@ -468,9 +645,48 @@ class CommandBuffer final : public ICommandBuffer {
 
   VkPipeline lastPipelineBound_ = VK_NULL_HANDLE;
 
+  // accumulated by bufferBarrier() and imageBarrier() until the next command which depends on them
+  std::vector<VkBufferMemoryBarrier2> pendingBufferBarriers_;
+  std::vector<VkImageMemoryBarrier2> pendingImageBarriers_;
+
   bool isRendering_ = false;
+  bool isSecondary_ = false;
+  // the pipeline bound to this bind point is still compiling - skip draw, dispatch and trace rays commands
+  bool isGraphicsPipelineNotReady_ = false;
+  bool isComputePipelineNotReady_ = false;
+  bool isRayTracingPipelineNotReady_ = false;
   uint32_t viewMask_ = 0;
 
+  lvk::CommandBufferStats stats_ = {};
+
+  // shadowed state used to drop redundant bind and set commands
+  enum { kMaxPushConstantsShadowSize = 256 };
+  struct BoundState {
+    BufferHandle vertexBuffers[VertexInput::LVK_VERTEX_BUFFER_MAX] = {};
+    uint64_t vertexBufferOffsets[VertexInput::LVK_VERTEX_BUFFER_MAX] = {};
+    BufferHandle indexBuffer = {};
+    IndexFormat indexFormat = IndexFormat_UI32;
+    uint64_t indexBufferOffset = 0;
+    Viewport viewport = {};
+    ScissorRect scissor = {};
+    DepthState depthState = {};
+    float depthBias[3] = {}; // constant factor, slope factor, clamp
+    bool hasViewport = false;
+    bool hasScissor = false;
+    bool hasDepthState = false;
+    bool hasDepthBias = false;
+    bool hasDescriptorBuffer = false; // VK_EXT_descriptor_buffer: the descriptor buffer is bound once per command buffer
+    // the last vkCmdPushConstants() call
+    VkPipelineLayout pushConstantsLayout = VK_NULL_HANDLE;
+    VkShaderStageFlags pushConstantsStages = 0;
+    uint32_t pushConstantsOffset = 0;
+    uint32_t pushConstantsSize = 0;
+    uint8_t pushConstants[kMaxPushConstantsShadowSize] = {};
+  } boundState_;
+  enum { kMaxTimingScopeDepth = 32 };
+  TimingScopeRef timingScopes_[kMaxTimingScopeDepth]; // open timing scopes
+  uint32_t numTimingScopes_ = 0;
+
   lvk::RenderPipelineHandle currentPipelineGraphics_ = {};
   lvk::ComputePipelineHandle currentPipelineCompute_ = {};
   lvk::RayTracingPipelineHandle currentPipelineRayTracing_ = {};
@@ -478,23 +694,32 @@ class CommandBuffer final : public ICommandBuffer {
 
 class VulkanStagingDevice final {
  public:
-  explicit VulkanStagingDevice(VulkanContext& ctx);
+  // all copies are recorded and submitted using `immediate`, which can belong to any queue capable of transfer operations
+  VulkanStagingDevice(VulkanContext& ctx, VulkanImmediateCommands& immediate);
   ~VulkanStagingDevice() = default;
 
   VulkanStagingDevice(const VulkanStagingDevice&) = delete;
   VulkanStagingDevice& operator=(const VulkanStagingDevice&) = delete;
 
-  void bufferSubData(VulkanBuffer& buffer, size_t dstOffset, size_t size, const void* data);
-  void imageData2D(VulkanImage& image,
-                   const VkRect2D& imageRegion,
-                   uint32_t baseMipLevel,
-                   uint32_t numMipLevels,
-                   uint32_t layer,
-                   uint32_t numLayers,
-                   VkFormat format,
-                   const void* data,
-                   uint32_t bufferRowLength);
-  void imageData3D(VulkanImage& image, const VkOffset3D& offset, const VkExtent3D& extent, VkFormat format, const void* data);
+  // return the submit handle of the last copy; with non-null `outIsPending`, nothing is copied and `*outIsPending` is set to true instead
+  // of stalling when the staging memory is full (buffer uploads larger than one staging block can still stall after the first chunk)
+  SubmitHandle bufferSubData(VulkanBuffer& buffer, size_t dstOffset, size_t size, const void* data, bool* outIsPending = nullptr);
+  SubmitHandle imageData2D(VulkanImage& image,
+                           const VkRect2D& imageRegion,
+                           uint32_t baseMipLevel,
+                           uint32_t numMipLevels,
+                           uint32_t layer,
+                           uint32_t numLayers,
+                           VkFormat format,
+                           const void* data,
+                           uint32_t bufferRowLength,
+                           bool* outIsPending = nullptr);
+  SubmitHandle imageData3D(VulkanImage& image,
+                           const VkOffset3D& offset,
+                           const VkExtent3D& extent,
+                           VkFormat format,
+                           const void* data,
+                           bool* outIsPending = nullptr);
   void getImageData(VulkanImage& image,
                     const VkOffset3D& offset,
                     const VkExtent3D& extent,
@@ -502,28 +727,94 @@ class VulkanStagingDevice final {
                     VkFormat format,
                     void* outData);
 
+  uint32_t getNumStalls() const {
+    return numStalls_;
+  }
+
  private:
   enum { kStagingBufferAlignment = 16 }; // updated to support BC7 compressed image
+  enum { kMinBufferChunkSize = 64 * 1024 }; // buffer uploads are split into chunks not smaller than this
 
   struct MemoryRegionDesc {
+    uint32_t block_ = 0;
     uint64_t offset_ = 0;
     uint64_t size_ = 0;
     SubmitHandle handle_ = {};
   };
 
-  MemoryRegionDesc getNextFreeOffset(uint32_t size);
-  void ensureStagingBufferSize(uint32_t sizeNeeded);
-  void waitAndReset();
+  // every staging block is a ring buffer: regions are bump-allocated at `head_` and retired at `tail_` in submission order
+  struct StagingBlock {
+    lvk::Holder<BufferHandle> buffer_;
+    uint64_t size_ = 0;
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+    uint32_t numInFlight_ = 0;
+    bool isWrapped_ = false; // `head_` has wrapped around and is behind `tail_`
+  };
+
+  // returns a region of at least `minSize` and at most `size` bytes; stalls only when all blocks are in flight and no new blocks can be
+  // created (or returns an empty region if `canStall` is false)
+  MemoryRegionDesc allocate(uint64_t size, uint64_t minSize, bool canStall = true);
+  bool tryAllocate(uint32_t blockIndex, uint64_t size, uint64_t minSize, MemoryRegionDesc& outDesc);
+  bool tryAllocateFromAnyBlock(uint64_t size, uint64_t minSize, MemoryRegionDesc& outDesc);
+  void retireCompletedRegions();
+  StagingBlock createBlock(uint64_t size);
+  lvk::VulkanBuffer* getStagingBuffer(const MemoryRegionDesc& desc) const;
 
  private:
   VulkanContext& ctx_;
-  lvk::Holder<BufferHandle> stagingBuffer_;
-  VkDeviceSize stagingBufferSize_ = 0;
+  VulkanImmediateCommands& immediate_;
+  std::mutex mutex_; // uploads can come from any thread
+  std::vector<StagingBlock> blocks_;
+  uint32_t currentBlock_ = 0;
+  uint32_t maxNumBlocks_ = 0;
   uint32_t stagingBufferCounter_ = 0;
-  // the staging buffer grows from minBufferSize up to maxBufferSize as needed
+  uint32_t numStalls_ = 0;
+  // staging blocks are created with sizes from minBufferSize up to maxBufferSize as needed
   VkDeviceSize maxBufferSize_ = 0;
   VkDeviceSize minBufferSize_ = 4u * 2048u * 2048u; // ad hoc value to avoid frequent reallocations
-  std::vector<MemoryRegionDesc> regions_;
+  std::deque<MemoryRegionDesc> inFlightRegions_; // the oldest regions are at the front
+};
+
+// per-frame linear allocator over persistently mapped buffers; chunks are recycled once the submits which used them have completed
+class VulkanTransientAllocator final {
+ public:
+  explicit VulkanTransientAllocator(VulkanContext& ctx);
+  ~VulkanTransientAllocator() = default;
+
+  VulkanTransientAllocator(const VulkanTransientAllocator&) = delete;
+  VulkanTransientAllocator& operator=(const VulkanTransientAllocator&) = delete;
+
+  TransientAllocation allocate(size_t size, size_t alignment);
+  // called when a command buffer is acquired on `queue`: allocations made until it is submitted can be used by it
+  void beginFrame(QueueType queue);
+  // called right before `handle` is submitted: the chunks allocated from while its command buffer was recorded are retired with it
+  void endFrame(SubmitHandle handle);
+
+ private:
+  struct Chunk {
+    lvk::Holder<BufferHandle> buffer_;
+    uint8_t* ptr_ = nullptr;
+    uint64_t gpuAddress_ = 0;
+    uint64_t size_ = 0;
+    uint64_t offset_ = 0;
+    // the last graphics and compute submits which used this chunk (see endFrame())
+    SubmitHandle handle_ = {};
+    SubmitHandle computeHandle_ = {};
+    // allocated from while a graphics or compute command buffer was recorded; each flag is cleared only by a submit to its own queue
+    bool isInUse_[2] = {};
+  };
+
+  uint32_t acquireChunk(uint64_t minSize);
+
+ private:
+  VulkanContext& ctx_;
+  uint64_t minAlignment_ = 16; // uniform and storage buffer offsets
+  std::mutex mutex_;
+  std::vector<Chunk> chunks_;
+  bool isRecording_[2] = {}; // graphics and compute command buffers acquired but not submitted yet
+  uint32_t current_ = ~0u;
+  uint32_t chunkCounter_ = 0;
 };
 
 class VulkanContext final : public IContext {
@@ -531,10 +822,15 @@ class VulkanContext final : public IContext {
   VulkanContext(const lvk::ContextConfig& config, void* window, void* display = nullptr, VkSurfaceKHR surface = VK_NULL_HANDLE);
   ~VulkanContext();
 
-  ICommandBuffer& acquireCommandBuffer() override;
+  ICommandBuffer& acquireCommandBuffer(QueueType queue = QueueType_Graphics) override;
 
   SubmitHandle submit(lvk::ICommandBuffer& commandBuffer, TextureHandle present) override;
   void wait(SubmitHandle handle) override;
+  void gpuWait(QueueType queue, SubmitHandle handle) override;
+  bool isReady(SubmitHandle handle) const override;
+
+  ICommandBuffer& acquireSecondaryCommandBuffer(const RenderPass& renderPass, const Framebuffer& fb) override;
+  void endSecondaryCommandBuffer(ICommandBuffer& commandBuffer) override;
 
   Holder<BufferHandle> createBuffer(const BufferDesc& desc, const char* debugName, Result* outResult) override;
   Holder<SamplerHandle> createSampler(const SamplerStateDesc& desc, Result* outResult) override;
@@ -548,10 +844,18 @@ class VulkanContext final : public IContext {
   Holder<RenderPipelineHandle> createRenderPipeline(const RenderPipelineDesc& desc, Result* outResult) override;
   Holder<RayTracingPipelineHandle> createRayTracingPipeline(const RayTracingPipelineDesc& desc, Result* outResult = nullptr) override;
   Holder<ShaderModuleHandle> createShaderModule(const ShaderModuleDesc& desc, Result* outResult) override;
+  void createShaderModules(const ShaderModuleDesc* desc,
+                           Holder<ShaderModuleHandle>* outHandles,
+                           uint32_t numShaderModules,
+                           Result* outResult) override;
 
   Holder<QueryPoolHandle> createQueryPool(uint32_t numQueries, const char* debugName, Result* outResult) override;
 
   Holder<AccelStructHandle> createAccelerationStructure(const AccelStructDesc& desc, Result* outResult) override;
+  void createAccelerationStructures(const AccelStructDesc* desc,
+                                    Holder<AccelStructHandle>* outHandles,
+                                    uint32_t numAccelStructs,
+                                    Result* outResult) override;
 
   void destroy(ComputePipelineHandle handle) override;
   void destroy(RenderPipelineHandle handle) override;
@@ -562,6 +866,7 @@ class VulkanContext final : public IContext {
   void destroy(TextureHandle handle) override;
   void destroy(QueryPoolHandle handle) override;
   void destroy(AccelStructHandle handle) override;
+  void destroy(ReadbackHandle handle) override;
   void destroy(Framebuffer& fb) override;
 
   uint64_t gpuAddress(AccelStructHandle handle) const override;
@@ -572,11 +877,24 @@ class VulkanContext final : public IContext {
   uint64_t gpuAddress(BufferHandle handle, size_t offset = 0) const override;
   void flushMappedMemory(BufferHandle handle, size_t offset, size_t size) const override;
 
+  SubmitHandle uploadAsync(BufferHandle handle, const void* data, size_t size, size_t offset, Result* outResult) override;
+  SubmitHandle uploadAsync(TextureHandle handle,
+                           const TextureRangeDesc& range,
+                           const void* data,
+                           uint32_t bufferRowLength,
+                           Result* outResult) override;
+
+  Holder<ReadbackHandle> readbackAsync(BufferHandle handle, size_t size, size_t offset, Result* outResult) override;
+  Holder<ReadbackHandle> readbackAsync(TextureHandle handle, const TextureRangeDesc& range, Result* outResult) override;
+  bool isReady(ReadbackHandle handle) const override;
+  const void* getReadbackData(ReadbackHandle handle, size_t* outSize) override;
+
   Result upload(TextureHandle handle, const TextureRangeDesc& range, const void* data, uint32_t bufferRowLength = 0) override;
   Result download(TextureHandle handle, const TextureRangeDesc& range, void* outData) override;
   Dimensions getDimensions(TextureHandle handle) const override;
   float getAspectRatio(TextureHandle handle) const override;
   Format getFormat(TextureHandle handle) const override;
+  bool isTextureFormatSupported(Format format) const override;
 
   TextureHandle getCurrentSwapchainTexture() override;
   Format getSwapchainFormat() const override;
@@ -587,6 +905,10 @@ class VulkanContext final : public IContext {
   bool setCurrentPresentMode(PresentMode mode) override;
   PresentMode getCurrentPresentMode() const override;
 
+  void waitForNextFrame() override;
+  void setMaxFramesInFlight(uint32_t maxFramesInFlight) override;
+  bool getPresentTimings(PresentTimings& outTimings) const override;
+
   uint32_t getFramebufferMSAABitMask() const override;
   bool isExtensionEnabled(const char* ext) const override;
 
@@ -599,7 +921,8 @@ class VulkanContext final : public IContext {
   ///////////////
 
   VkPipeline getVkPipeline(ComputePipelineHandle handle);
-  VkPipeline getVkPipeline(RenderPipelineHandle handle, uint32_t viewMask);
+  // secondary command buffers are recorded on worker threads and do not update descriptor sets (see acquireSecondaryCommandBuffer())
+  VkPipeline getVkPipeline(RenderPipelineHandle handle, uint32_t viewMask, bool updateDescriptorSets = true);
   VkPipeline getVkPipeline(RayTracingPipelineHandle handle);
 
   uint32_t queryDevices(HWDeviceDesc* outDevices, uint32_t maxOutDevices = 1);
@@ -610,7 +933,8 @@ class VulkanContext final : public IContext {
                             VkBufferUsageFlags usageFlags,
                             VkMemoryPropertyFlags memFlags,
                             lvk::Result* outResult,
-                            const char* debugName = nullptr);
+                            const char* debugName = nullptr,
+                            bool isShared = false);
   SamplerHandle createSampler(const VkSamplerCreateInfo& ci,
                               lvk::Result* outResult,
                               lvk::Format yuvFormat = Format_Invalid,
@@ -638,9 +962,16 @@ class VulkanContext final : public IContext {
   }
 
   std::vector<uint8_t> getPipelineCacheData() const;
+  // write the pipeline cache into ContextConfig::pipelineCacheFileName (if any); called periodically from submit()
+  bool savePipelineCache();
 
   // execute a task some time in the future after the submit handle finished processing
   void deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle = SubmitHandle()) const;
+  // thread-safe and allocation-free in the steady state; prefer this over deferredTask() for destroying objects
+  void deferredDestroy(DeferredObjectType type,
+                       uint64_t object,
+                       VmaAllocation allocation = VK_NULL_HANDLE,
+                       SubmitHandle handle = SubmitHandle()) const;
 
   void* getVmaAllocator() const;
 
@@ -648,26 +979,97 @@ class VulkanContext final : public IContext {
   void bindDefaultDescriptorSets(VkCommandBuffer cmdBuf, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const;
 
   [[nodiscard]] uint32_t getMaxStorageBufferRange() const override;
+  [[nodiscard]] uint32_t getNumStagingStalls() const override;
+  bool getFrameStats(FrameStats& outStats) const override;
+  void getCreationStats(CreationStats& outStats) const override;
+  void getMemoryStats(MemoryStats& outStats) const override;
+  void setMemoryBudgetCallback(MemoryBudgetCallback callback, void* userData, float threshold) override;
+
+  [[nodiscard]] bool isSparseResidencySupported() const override;
+  [[nodiscard]] SparseTextureInfo getSparseTextureInfo(TextureHandle handle) const override;
+  Result updateSparsePages(TextureHandle handle,
+                           const SparsePage* bind,
+                           uint32_t numBind,
+                           const SparsePage* unbind,
+                           uint32_t numUnbind) override;
+
+  void prewarm(RenderPipelineHandle handle, uint32_t viewMask) override;
+  void prewarm(ComputePipelineHandle handle) override;
+  void prewarm(RayTracingPipelineHandle handle) override;
+  [[nodiscard]] bool isReady(RenderPipelineHandle handle) const override;
+  [[nodiscard]] bool isReady(ComputePipelineHandle handle) const override;
+  [[nodiscard]] bool isReady(RayTracingPipelineHandle handle) const override;
 
  private:
   struct DescriptorSet {
     uint32_t maxTextures = 0;
     uint32_t maxSamplers = 0;
     uint32_t maxAccelStructs = 0;
+    uint32_t maxYUVImages = 0; // the size of the immutable samplers array
     VkDescriptorSetLayout vkDSL = VK_NULL_HANDLE;
     VkDescriptorPool vkDPool = VK_NULL_HANDLE;
     VkDescriptorSet vkDSet = VK_NULL_HANDLE;
     SubmitHandle handle_ = {}; // last use
+    SubmitHandle computeHandle_ = {}; // last use on the async compute queue
   };
 
   lvk::Result createInstance();
   void createSurface(void* window, void* display);
   void createHeadlessSurface();
   void querySurfaceCapabilities();
-  void processDeferredTasks() const;
+  void processDeferredTasks();
+  SubmitHandle getComputeHandleInUse() const;
+  // must be called with VulkanContextImpl::deferredMutex_ locked
+  DeferredBucket& getDeferredBucket(SubmitHandle handle, SubmitHandle computeHandle) const;
+  void retireDeferredBucket(DeferredBucket& bucket);
+  lvk::VulkanImmediateCommands* getImmediateCommands(SubmitHandle handle) const;
+  lvk::VulkanImmediateCommands* getImmediateCommands(QueueType queue) const;
+  SubmitHandle uploadBuffer(lvk::VulkanStagingDevice& staging,
+                            BufferHandle handle,
+                            const void* data,
+                            size_t size,
+                            size_t offset,
+                            Result* outResult,
+                            bool canStall = true);
+  SubmitHandle uploadTexture(lvk::VulkanStagingDevice& staging,
+                             TextureHandle handle,
+                             const TextureRangeDesc& range,
+                             const void* data,
+                             uint32_t bufferRowLength,
+                             Result* outResult,
+                             bool canStall = true);
+  // the transfer queue can copy only whole mip-levels or ranges aligned to its minImageTransferGranularity
+  bool isTransferGranularityCompatible(const VulkanImage& image, const TextureRangeDesc& range) const;
   void waitDeferredTasks();
-  void generateMipmap(TextureHandle handle) const;
+  // build on the calling thread or start compiling on a background thread; does nothing if the pipeline is already built or compiling
+  void buildPipeline(lvk::RenderPipelineState* rps, uint32_t viewMask, bool async, bool updateDescriptorSets = true);
+  void buildPipeline(lvk::ComputePipelineState* cps, bool async);
+  void buildPipeline(lvk::RayTracingPipelineState* rtps, bool async);
+  // destroy the VkPipeline and VkPipelineLayout or drop a reference to the shared ones
+  void releasePipeline(lvk::RenderPipelineState* rps);
+  // thread-safe, these functions do not touch any pools
+  VkPipeline compileRenderPipeline(const lvk::RenderPipelineState& rps,
+                                   const lvk::ShaderModuleState* const* modules, // indexed by lvk::ShaderStage
+                                   VkPipelineLayout layout,
+                                   uint32_t viewMask) const;
+  VkPipeline compileComputePipeline(const lvk::ComputePipelineDesc& desc, const lvk::ShaderModuleState& sm, VkPipelineLayout layout) const;
+  VkPipeline compileRayTracingPipeline(const lvk::RayTracingPipelineDesc& desc,
+                                       const lvk::RayTracingShaderModules& modules,
+                                       VkPipelineLayout layout) const;
+  std::shared_future<VkPipeline> compilePipelineAsync(std::packaged_task<VkPipeline()>&& task);
+  void trackPipelineCacheHit(const VkPipelineCreationFeedback& feedback) const;
+  lvk::RayTracingShaderModules getRayTracingShaderModules(const lvk::RayTracingPipelineDesc& desc) const;
+  void createShaderBindingTable(lvk::RayTracingPipelineState* rtps);
+  void generateMipmap(TextureHandle handle);
+  lvk::Holder<lvk::BufferHandle> acquireReadbackBuffer(size_t size, Result* outResult);
+  SubmitHandle submitReadback(const VulkanImmediateCommands::CommandBufferWrapper& wrapper, VkBuffer readbackBuffer);
+  void generateMipmaps(VkCommandBuffer cmdBuf, lvk::VulkanImage* const* images, uint32_t numImages);
+  VkPipeline getOrCreateMipmapPipeline();
+  void bindDescriptorBuffer(VkCommandBuffer cmdBuf) const;
   lvk::Result growDescriptorPool(VulkanContext::DescriptorSet& dset, uint32_t maxTextures, uint32_t maxSamplers, uint32_t maxAccelStructs);
+  lvk::Result createDescriptorBuffer();
+  void updateDescriptorBuffer();
+  ShaderModuleState createShaderModuleState(const ShaderModuleDesc& desc, Result* outResult) const;
   ShaderModuleState createShaderModuleFromSPIRV(const void* spirv, size_t numBytes, const char* debugName, Result* outResult) const;
   ShaderModuleState createShaderModuleFromGLSL(ShaderStage stage, const char* source, const char* debugName, Result* outResult) const;
   ShaderModuleState createShaderModuleFromSlang(ShaderStage stage,
@@ -675,9 +1077,40 @@ class VulkanContext final : public IContext {
                                                 const char* entryPointName,
                                                 const char* debugName,
                                                 Result* outResult) const;
+  // compile a patched GLSL or Slang source into SPIR-V going through the SPIR-V cache
+  Result compileShader(ShaderStage stage,
+                       const char* source,
+                       const char* entryPointName,
+                       bool isSlang,
+                       std::vector<uint8_t>* outSPIRV) const;
   const VkSamplerYcbcrConversionInfo* getOrCreateYcbcrConversionInfo(lvk::Format format);
   VkSampler getOrCreateYcbcrSampler(lvk::Format format);
   void addNextPhysicalDeviceProperties(void* properties);
+  // GPU timing scopes: `numViews` timestamps are written inside multiview render passes; returns an untimed scope if there is no room
+  TimingScopeRef beginTimingScope(VkCommandBuffer cmdBuf, const char* name, uint32_t depth, uint32_t numViews);
+  void endTimingScope(VkCommandBuffer cmdBuf, const TimingScopeRef& ref, uint32_t numViews);
+  void addCommandBufferStats(const CommandBufferStats& stats);
+  void endTimingFrame();
+  void trackMemory(lvk::MemoryCategory category, VkDeviceSize size, bool isAllocated);
+  void checkMemoryBudget();
+  // sparse textures: page tables, mip-tail memory, and the feedback buffer of a newly created VkImage
+  Result createSparseImage(VulkanImage& image, const VkImageCreateInfo& ci, const char* debugName);
+  // vkQueueBindSparse() on the graphics queue; unbinds are ordered after all submitted command buffers, binds before all future ones
+  Result bindSparse(const VkSparseImageOpaqueMemoryBindInfo* opaqueBinds,
+                    const VkSparseImageMemoryBindInfo* imageBinds,
+                    bool hasUnbinds,
+                    bool hasBinds);
+  // returns a page id from the sparse page pool, or VulkanSparseImage::kUnbound
+  uint32_t allocateSparsePage(const VulkanSparseImage& sparse);
+  void freeSparsePage(uint32_t page);
+  void freeSparsePagesDeferred(std::vector<uint32_t>&& pages);
+  // must be called with VulkanContextImpl::timingMutex_ locked; returns false if the GPU has not written all timestamps yet
+  bool resolveTimingFrame(uint32_t frame);
+  // add or recycle a slot of a pool backing bindless descriptors (textures, samplers, acceleration structures)
+  template<typename ObjectType, typename ImplObjectType>
+  Handle<ObjectType> createBindless(lvk::Pool<ObjectType, ImplObjectType>& pool, std::vector<uint32_t>& dirty, ImplObjectType&& obj);
+  template<typename ObjectType, typename ImplObjectType>
+  void recycleBindless(lvk::Pool<ObjectType, ImplObjectType>& pool, std::vector<uint32_t>& dirty, uint32_t index);
 
   void getBuildInfoBLAS(const AccelStructDesc& desc,
                         VkAccelerationStructureGeometryKHR& geom,
@@ -689,6 +1122,8 @@ class VulkanContext final : public IContext {
  private:
   friend class lvk::VulkanSwapchain;
   friend class lvk::VulkanStagingDevice;
+  friend class lvk::VulkanTransientAllocator;
+  friend class lvk::CommandBuffer;
 
   VkInstance vkInstance_ = VK_NULL_HANDLE;
   VkDebugUtilsMessengerEXT vkDebugUtilsMessenger_ = VK_NULL_HANDLE;
@@ -713,6 +1148,8 @@ class VulkanContext final : public IContext {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_PROPERTIES_KHR};
   VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties_ = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
+  VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
   VkPhysicalDeviceDriverProperties vkPhysicalDeviceDriverProperties_ = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DRIVER_PROPERTIES, nullptr};
 #if defined(VK_API_VERSION_1_4)
   // provided by Vulkan 1.4
@@ -752,20 +1189,46 @@ class VulkanContext final : public IContext {
   std::unique_ptr<lvk::VulkanSwapchain> swapchain_;
   VkSemaphore timelineSemaphore_ = VK_NULL_HANDLE;
   std::unique_ptr<lvk::VulkanImmediateCommands> immediate_;
+  std::unique_ptr<lvk::VulkanImmediateCommands> immediateCompute_;
+  std::unique_ptr<lvk::VulkanImmediateCommands> immediateTransfer_;
   std::unique_ptr<lvk::VulkanStagingDevice> stagingDevice_;
+  std::unique_ptr<lvk::VulkanStagingDevice> stagingDeviceAsync_; // records onto `immediateTransfer_`
+  std::unique_ptr<lvk::VulkanTransientAllocator> transientAllocator_;
+  // unique queue family indices for resources created with VK_SHARING_MODE_CONCURRENT
+  uint32_t sharedQueueFamilyIndices_[3] = {};
+  uint32_t numSharedQueueFamilyIndices_ = 0;
+  VkExtent3D transferImageGranularity_ = {1, 1, 1}; // minImageTransferGranularity of the transfer queue family
+  uint32_t timestampValidBits_[QueueType_Transfer + 1] = {}; // per QueueType; 0 if the queue family cannot write timestamps
   VkDescriptorSetLayout dslInputAttachments_ = VK_NULL_HANDLE;
+  // compute mipmap generation - see generateMipmaps()
+  VkDescriptorSetLayout dslMipmap_ = VK_NULL_HANDLE;
+  VkPipelineLayout pipelineLayoutMipmap_ = VK_NULL_HANDLE;
+  VkPipeline pipelineMipmap_ = VK_NULL_HANDLE;
   std::vector<DescriptorSet> DSets_ = {};
   size_t lastUpdatedDSet_ = 0;
+  // VK_EXT_descriptor_buffer: one fixed-capacity layout in `DSets_[0]` backed by this host-visible buffer
+  BufferHandle descriptorBuffer_;
+  VkBufferUsageFlags descriptorBufferUsage_ = 0;
+  bool hasWarnedDescriptorBufferYUV_ = false;
+  VkDeviceSize descriptorBufferBindingOffsets_[5] = {}; // one per binding, see `Bindings` in VulkanClasses.cpp
   // don't use staging on devices with shared host-visible memory
   bool useStaging_ = true;
+  bool hasLazilyAllocatedMemory_ = false;
 
   std::unique_ptr<struct VulkanContextImpl> pimpl_;
 
   VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
 
   // a texture/sampler was created since the last descriptor set update
-  mutable bool awaitingCreation_ = false;
-  mutable bool awaitingNewImmutableSamplers_ = false;
+  mutable std::atomic<bool> awaitingCreation_ = false;
+  // guards the bindless pools and the dirty slots below: resources can be created on any thread, and descriptor updates should never
+  // see a partially written slot (recursive because updating descriptor sets can create Ycbcr samplers)
+  std::recursive_mutex descriptorsMutex_;
+  // pool slots which have to be written into the current descriptor set
+  std::vector<uint32_t> dirtyTextures_;
+  std::vector<uint32_t> dirtySamplers_;
+  std::vector<uint32_t> dirtyAccelStructs_;
+  mutable std::atomic<bool> awaitingNewImmutableSamplers_ = false;
 
   lvk::ContextConfig config_;
   bool has_KHR_acceleration_structure_ = false;
@@ -783,6 +1246,12 @@ class VulkanContext final : public IContext {
   bool has_MVK_macos_surface_ = false;
   bool has_KHR_shared_presentable_image_ = false;
   bool has_KHR_present_mode_fifo_latest_ready_ = false;
+  bool has_EXT_descriptor_buffer_ = false;
+  bool has_EXT_memory_budget_ = false;
+  bool has_EXT_extended_dynamic_state3_ = false;
+  bool has_sparseResidency_ = false; // sparseResidencyImage2D + shaderResourceResidency on the graphics queue
+  bool has_KHR_present_wait_ = false; // VK_KHR_present_id + VK_KHR_present_wait
+  bool has_NV_low_latency2_ = false;
   std::vector<const char*> enabledInstanceExtensionNames_;
   std::vector<const char*> enabledDeviceExtensionNames_;
 
@@ -797,6 +1266,12 @@ class VulkanContext final : public IContext {
   lvk::Pool<lvk::Texture, lvk::VulkanImage> texturesPool_;
   lvk::Pool<lvk::QueryPool, VkQueryPool> queriesPool_;
   lvk::Pool<lvk::AccelerationStructure, lvk::AccelerationStructure> accelStructuresPool_;
+  lvk::Pool<lvk::Readback, lvk::ReadbackState> readbacksPool_;
+  // buffers of destroyed readbacks are recycled once the GPU has finished copying into them
+  enum { kMaxFreeReadbackBuffers = 16 };
+  enum { kReadbackBufferAlignment = 4096 };
+  std::vector<lvk::ReadbackState> freeReadbackBuffers_;
+  uint32_t readbackBufferCounter_ = 0;
 };
 
 } // namespace lvk
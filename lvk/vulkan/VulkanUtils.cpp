@@ -6,6 +6,9 @@
  */
 
 #include <glslang/Include/glslang_c_interface.h>
+#if __has_include(<glslang/build_info.h>)
+#include <glslang/build_info.h>
+#endif // __has_include(<glslang/build_info.h>)
 
 #if defined(LVK_WITH_SLANG) && LVK_WITH_SLANG
 #include <slang.h>
@@ -250,6 +253,8 @@ VkFormat lvk::formatToVkFormat(lvk::Format format) {
     return VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
   case lvk::Format_BC7_RGBA:
     return VK_FORMAT_BC7_UNORM_BLOCK;
+  case lvk::Format_ASTC_4x4_RGBA:
+    return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
   case lvk::Format_Z_UN16:
     return VK_FORMAT_D16_UNORM;
   case lvk::Format_Z_UN24:
@@ -337,6 +342,8 @@ lvk::Format lvk::vkFormatToFormat(VkFormat format) {
     return Format_Z_UN16;
   case VK_FORMAT_BC7_UNORM_BLOCK:
     return Format_BC7_RGBA;
+  case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+    return Format_ASTC_4x4_RGBA;
   case VK_FORMAT_X8_D24_UNORM_PACK32:
     return Format_Z_UN24;
   case VK_FORMAT_D24_UNORM_S8_UINT:
@@ -427,6 +434,10 @@ uint32_t lvk::findQueueFamilyIndex(VkPhysicalDevice physDev, VkQueueFlags flags)
 
   // dedicated queue for transfer
   if (flags & VK_QUEUE_TRANSFER_BIT) {
+    // prefer a pure DMA queue family which does not compete with async compute
+    const uint32_t qDMA = findDedicatedQueueFamilyIndex(flags, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+    if (qDMA != DeviceQueues::INVALID)
+      return qDMA;
     const uint32_t q = findDedicatedQueueFamilyIndex(flags, VK_QUEUE_GRAPHICS_BIT);
     if (q != DeviceQueues::INVALID)
       return q;
@@ -436,7 +447,11 @@ uint32_t lvk::findQueueFamilyIndex(VkPhysicalDevice physDev, VkQueueFlags flags)
   return findDedicatedQueueFamilyIndex(flags, 0);
 }
 
-VmaAllocator lvk::createVmaAllocator(VkPhysicalDevice physDev, VkDevice device, VkInstance instance, uint32_t apiVersion) {
+VmaAllocator lvk::createVmaAllocator(VkPhysicalDevice physDev,
+                                     VkDevice device,
+                                     VkInstance instance,
+                                     uint32_t apiVersion,
+                                     bool hasMemoryBudget) {
   const VmaVulkanFunctions funcs = {
       .vkGetInstanceProcAddr = vkGetInstanceProcAddr,
       .vkGetDeviceProcAddr = vkGetDeviceProcAddr,
@@ -467,7 +482,7 @@ VmaAllocator lvk::createVmaAllocator(VkPhysicalDevice physDev, VkDevice device,
   };
 
   const VmaAllocatorCreateInfo ci = {
-      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT | (hasMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u),
       .physicalDevice = physDev,
       .device = device,
       .preferredLargeHeapBlockSize = 0,
@@ -964,6 +979,19 @@ lvk::Result lvk::compileShaderSlang(lvk::ShaderStage stage,
 #endif // defined(LVK_WITH_SLANG) && LVK_WITH_SLANG
 }
 
+std::string lvk::getShaderCompilerVersion() {
+  std::string version = "glslang";
+#if defined(GLSLANG_VERSION_MAJOR)
+  version += " " + std::to_string(GLSLANG_VERSION_MAJOR) + "." + std::to_string(GLSLANG_VERSION_MINOR) + "." +
+             std::to_string(GLSLANG_VERSION_PATCH);
+#endif // GLSLANG_VERSION_MAJOR
+#if defined(LVK_WITH_SLANG) && LVK_WITH_SLANG
+  version += ", slang ";
+  version += spGetBuildTagString();
+#endif // defined(LVK_WITH_SLANG) && LVK_WITH_SLANG
+  return version;
+}
+
 VkResult lvk::setDebugObjectName(VkDevice device, VkObjectType type, uint64_t handle, const char* name) {
   if (!name || !*name || !vkSetDebugUtilsObjectNameEXT) {
     return VK_SUCCESS;
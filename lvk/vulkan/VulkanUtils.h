@@ -23,6 +23,7 @@
 
 #include <cassert>
 #include <cstdio>
+#include <string>
 #include <vector>
 
 #include <volk.h>
@@ -68,7 +69,7 @@ namespace lvk {
 VkSemaphore createSemaphore(VkDevice device, const char* debugName);
 VkSemaphore createSemaphoreTimeline(VkDevice device, uint64_t initialValue, const char* debugName);
 VkFence createFence(VkDevice device, const char* debugName, bool isSignaled = false);
-VmaAllocator createVmaAllocator(VkPhysicalDevice physDev, VkDevice device, VkInstance instance, uint32_t apiVersion);
+VmaAllocator createVmaAllocator(VkPhysicalDevice physDev, VkDevice device, VkInstance instance, uint32_t apiVersion, bool hasMemoryBudget);
 uint32_t findQueueFamilyIndex(VkPhysicalDevice physDev, VkQueueFlags flags);
 VkResult setDebugObjectName(VkDevice device, VkObjectType type, uint64_t handle, const char* name);
 VkResult allocateMemory2(VkPhysicalDevice physDev,
@@ -83,6 +84,8 @@ Result compileShaderGlslang(lvk::ShaderStage stage,
                             std::vector<uint8_t>* outSPIRV,
                             const glslang_resource_t* glslLangResource = nullptr);
 Result compileShaderSlang(lvk::ShaderStage stage, const char* code, const char* entryPointName, std::vector<uint8_t>* outSPIRV);
+// identifies the versions of the shader compilers, so that cached SPIR-V can be invalidated when they change
+std::string getShaderCompilerVersion();
 
 VkSamplerCreateInfo samplerStateDescToVkSamplerCreateInfo(const lvk::SamplerStateDesc& desc, const VkPhysicalDeviceLimits& limits);
 VkDescriptorSetLayoutBinding getDSLBinding(uint32_t binding,
@@ -0,0 +1,296 @@
+/*
+ * LightweightVK
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ Headless benchmark mode of the samples:
+
+   app --benchmark <frames> [--benchmark-warmup <frames>] [--benchmark-file <filename>]
+
+ The app runs headless with a fixed time step and no input, so the camera follows the same path every run. After the warmup
+ frames, every frame is recorded and the results are written as JSON:
+
+   BenchmarkRecorder benchmark("name");
+   benchmark.parseArgument(argc, argv, i); // for every command line argument
+   while (!benchmark.isFinished()) {
+     benchmark.beginFrame();
+     render(BenchmarkRecorder::kDeltaSeconds);
+     benchmark.endFrame(ctx); // after IContext::submit()
+   }
+   benchmark.write(ctx, width, height);
+
+ GPU times come from IContext::getFrameStats(), so only the passes which samples wrap into timing scopes are reported.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <lvk/LVK.h>
+
+class BenchmarkRecorder {
+ public:
+  static constexpr float kDeltaSeconds = 1.0f / 60.0f;
+
+  explicit BenchmarkRecorder(const char* name) : name_(name) {}
+
+  // returns true if argv[i] is a benchmark argument; `i` is advanced past its value
+  bool parseArgument(int argc, char* argv[], int& i) {
+    if (!strcmp(argv[i], "--benchmark")) {
+      if (i + 1 < argc) {
+        numFrames_ = (uint32_t)strtoul(argv[++i], nullptr, 10);
+      } else {
+        LLOGW("Specify a number of frames for `--benchmark <frames>`");
+      }
+      return true;
+    }
+    if (!strcmp(argv[i], "--benchmark-warmup")) {
+      if (i + 1 < argc) {
+        numWarmupFrames_ = (uint32_t)strtoul(argv[++i], nullptr, 10);
+      } else {
+        LLOGW("Specify a number of frames for `--benchmark-warmup <frames>`");
+      }
+      return true;
+    }
+    if (!strcmp(argv[i], "--benchmark-file")) {
+      if (i + 1 < argc) {
+        fileName_ = argv[++i];
+      } else {
+        LLOGW("Specify a file name for `--benchmark-file <filename>`");
+      }
+      return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] bool isEnabled() const {
+    return numFrames_ > 0;
+  }
+  [[nodiscard]] bool isFinished() const {
+    return isEnabled() && cpuFrameTimeMs_.size() >= numFrames_;
+  }
+
+  void beginFrame() {
+    frameBegin_ = std::chrono::steady_clock::now();
+  }
+
+  // call after the last submit of the frame
+  void endFrame(lvk::IContext& ctx) {
+    if (!isEnabled() || isFinished()) {
+      return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const double cpuMs = std::chrono::duration<double, std::milli>(now - frameBegin_).count();
+    const double frameMs = frameCount_ ? std::chrono::duration<double, std::milli>(now - frameEnd_).count() : cpuMs;
+    frameEnd_ = now;
+
+    if (frameCount_++ < numWarmupFrames_) {
+      return;
+    }
+
+    if (cpuFrameTimeMs_.empty()) {
+      numStagingStallsStart_ = ctx.getNumStagingStalls();
+    }
+
+    cpuFrameTimeMs_.push_back(frameMs);
+    cpuRecordTimeMs_.push_back(cpuMs);
+
+    // GPU timings lag a few frames behind; new frames are picked up as soon as they are available
+    if (ctx.getFrameStats(frameStats_) && frameStats_.frameIndex != lastGpuFrameIndex_) {
+      lastGpuFrameIndex_ = frameStats_.frameIndex;
+      addGpuFrame(frameStats_);
+    }
+
+    if (isFinished()) {
+      numStagingStalls_ = ctx.getNumStagingStalls() - numStagingStallsStart_;
+    }
+  }
+
+  bool write(const lvk::IContext& ctx, uint32_t width, uint32_t height) const {
+    FILE* f = fopen(fileName_, "w");
+
+    if (!f) {
+      LLOGW("Cannot write benchmark results to `%s`\n", fileName_);
+      return false;
+    }
+
+    lvk::CreationStats creation;
+    ctx.getCreationStats(creation);
+
+    lvk::MemoryStats memory;
+    ctx.getMemoryStats(memory);
+
+    const uint32_t numGpuFrames = (uint32_t)gpuFrameTimeMs_.size();
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"name\": \"%s\",\n", name_.c_str());
+    fprintf(f, "  \"width\": %u,\n  \"height\": %u,\n", width, height);
+    fprintf(f, "  \"frames\": %u,\n  \"warmupFrames\": %u,\n", (uint32_t)cpuFrameTimeMs_.size(), numWarmupFrames_);
+    writeSummary(f, "cpuFrameTimeMs", cpuFrameTimeMs_);
+    writeSummary(f, "cpuRecordTimeMs", cpuRecordTimeMs_);
+    writeSummary(f, "gpuFrameTimeMs", gpuFrameTimeMs_);
+    fprintf(f, "  \"gpuScopes\": [");
+    for (size_t i = 0; i != scopes_.size(); i++) {
+      const Scope& s = scopes_[i];
+      fprintf(f,
+              "%s\n    {\"name\": \"%s\", \"depth\": %u, \"count\": %u, \"avg\": %.4f, \"min\": %.4f, \"max\": %.4f}",
+              i ? "," : "",
+              s.name.c_str(),
+              s.depth,
+              s.count,
+              s.sumMs / std::max(s.count, 1u),
+              s.minMs,
+              s.maxMs);
+    }
+    fprintf(f, "%s],\n", scopes_.empty() ? "" : "\n  ");
+    fprintf(f,
+            "  \"commandBuffers\": {\"drawCalls\": %.1f, \"dispatches\": %.1f, \"barriers\": %.1f, \"redundantBinds\": %.1f},\n",
+            (double)total_.numDrawCalls / std::max(numGpuFrames, 1u),
+            (double)total_.numDispatches / std::max(numGpuFrames, 1u),
+            (double)total_.numBarriers / std::max(numGpuFrames, 1u),
+            (double)total_.numRedundantBinds / std::max(numGpuFrames, 1u));
+    fprintf(f, "  \"stagingStalls\": %u,\n", numStagingStalls_);
+    fprintf(f,
+            "  \"creation\": {\"pipelines\": %u, \"pipelineCacheHits\": %u, \"pipelineTimeMs\": %.3f, "
+            "\"shaderCompilations\": %u, \"shaderCacheHits\": %u, \"shaderCompilationTimeMs\": %.3f},\n",
+            creation.numPipelines,
+            creation.numPipelineCacheHits,
+            creation.pipelineTimeMs,
+            creation.numShaderCompilations,
+            creation.numShaderCacheHits,
+            creation.shaderCompilationTimeMs);
+    const char* categories[] = {"buffer", "texture", "accelStruct", "staging", "descriptors", "sparsePages"};
+    static_assert(LVK_ARRAY_NUM_ELEMENTS(categories) == lvk::MemoryCategory_Num, "Update the names of lvk::MemoryCategory");
+    fprintf(f, "  \"memory\": {\n");
+    for (uint32_t i = 0; i != lvk::MemoryCategory_Num; i++) {
+      fprintf(f,
+              "    \"%s\": {\"bytes\": %llu, \"count\": %u},\n",
+              categories[i],
+              (unsigned long long)memory.categoryBytes[i],
+              memory.categoryCount[i]);
+    }
+    fprintf(f, "    \"heaps\": [");
+    for (uint32_t i = 0; i != memory.numHeaps; i++) {
+      const lvk::MemoryHeapStats& h = memory.heaps[i];
+      fprintf(f,
+              "%s\n      {\"size\": %llu, \"budget\": %llu, \"usage\": %llu, \"deviceLocal\": %s}",
+              i ? "," : "",
+              (unsigned long long)h.size,
+              (unsigned long long)h.budget,
+              (unsigned long long)h.usage,
+              h.isDeviceLocal ? "true" : "false");
+    }
+    fprintf(f, "%s]\n  },\n", memory.numHeaps ? "\n    " : "");
+    // raw per-frame values for regression tracking
+    fprintf(f, "  \"cpuFrameTimesMs\": [");
+    for (size_t i = 0; i != cpuFrameTimeMs_.size(); i++) {
+      fprintf(f, "%s%.4f", i ? ", " : "", cpuFrameTimeMs_[i]);
+    }
+    fprintf(f, "],\n  \"gpuFrameTimesMs\": [");
+    for (size_t i = 0; i != gpuFrameTimeMs_.size(); i++) {
+      fprintf(f, "%s%.4f", i ? ", " : "", gpuFrameTimeMs_[i]);
+    }
+    fprintf(f, "]\n}\n");
+
+    fclose(f);
+
+    LLOGL("Benchmark results saved to `%s`\n", fileName_);
+
+    return true;
+  }
+
+ private:
+  struct Scope {
+    std::string name;
+    uint32_t depth = 0;
+    uint32_t count = 0;
+    double sumMs = 0;
+    double minMs = 0;
+    double maxMs = 0;
+  };
+
+  void addGpuFrame(const lvk::FrameStats& stats) {
+    gpuFrameTimeMs_.push_back(stats.gpuTimeMs);
+
+    total_.numDrawCalls += stats.total.numDrawCalls;
+    total_.numDispatches += stats.total.numDispatches;
+    total_.numBarriers += stats.total.numBarriers;
+    total_.numRedundantBinds += stats.total.numRedundantBinds;
+
+    for (uint32_t i = 0; i != stats.numScopes; i++) {
+      const lvk::GpuTimingScope& s = stats.scopes[i];
+      auto it = std::find_if(scopes_.begin(), scopes_.end(), [&s](const Scope& scope) {
+        return scope.depth == s.depth && scope.name == s.name;
+      });
+      if (it == scopes_.end()) {
+        // scope names go into JSON strings as-is
+        std::string name = s.name;
+        std::replace_if(name.begin(), name.end(), [](char c) { return c == '"' || c == '\\' || c < ' '; }, '_');
+        scopes_.push_back({.name = name, .depth = s.depth, .minMs = s.durationMs, .maxMs = s.durationMs});
+        it = scopes_.end() - 1;
+      }
+      it->count++;
+      it->sumMs += s.durationMs;
+      it->minMs = std::min(it->minMs, s.durationMs);
+      it->maxMs = std::max(it->maxMs, s.durationMs);
+    }
+  }
+
+  static void writeSummary(FILE* f, const char* name, std::vector<double> values) {
+    if (values.empty()) {
+      fprintf(f, "  \"%s\": null,\n", name);
+      return;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    double sum = 0;
+    for (double v : values) {
+      sum += v;
+    }
+
+    auto percentile = [&values](double p) { return values[std::min(size_t(p * values.size()), values.size() - 1)]; };
+
+    fprintf(f,
+            "  \"%s\": {\"avg\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+            name,
+            sum / values.size(),
+            values.front(),
+            percentile(0.50),
+            percentile(0.95),
+            percentile(0.99),
+            values.back());
+  }
+
+ private:
+  std::string name_;
+  const char* fileName_ = "benchmark.json";
+  uint32_t numFrames_ = 0;
+  uint32_t numWarmupFrames_ = 16;
+
+  uint32_t frameCount_ = 0; // including warmup
+  std::chrono::steady_clock::time_point frameBegin_ = {};
+  std::chrono::steady_clock::time_point frameEnd_ = {};
+
+  std::vector<double> cpuFrameTimeMs_; // between the ends of consecutive frames
+  std::vector<double> cpuRecordTimeMs_; // between beginFrame() and endFrame()
+  std::vector<double> gpuFrameTimeMs_;
+  std::vector<Scope> scopes_;
+  lvk::CommandBufferStats total_ = {};
+  lvk::FrameStats frameStats_ = {}; // too large for the stack
+  uint64_t lastGpuFrameIndex_ = ~0ull;
+
+  uint32_t numStagingStallsStart_ = 0;
+  uint32_t numStagingStalls_ = 0;
+};
@@ -13,8 +13,9 @@
 
  The result is stored in the global variables:
 
-   std::vector<VertexData> vertexData_;
-   std::vector<uint32_t> indexData_;
+   MeshCache meshCache_; // memory-mapped; use meshCache_.upload() with MeshCacheChunk_Vertices and MeshCacheChunk_Indices
+   uint32_t numVertices_;
+   uint32_t numIndices_;
    std::vector<CachedMaterial> cachedMaterials_;
 */
 
@@ -39,13 +40,22 @@
 #include <ldrutils/lutils/ScopeExit.h>
 #include <lvk/LVK.h>
 
+#include "MeshCache.h"
+
 using glm::mat3;
 using glm::mat4;
 using glm::vec2;
 using glm::vec3;
 using glm::vec4;
 
-constexpr uint32_t kMeshCacheVersion = 0xC0DE000A;
+constexpr uint32_t kMeshCacheVersion = 0xC0DE000B;
+constexpr bool kMeshCacheCompression = true; // meshopt-encode vertices and indices
+
+enum MeshCacheChunkId : uint32_t {
+  MeshCacheChunk_Materials = 0,
+  MeshCacheChunk_Vertices,
+  MeshCacheChunk_Indices,
+};
 
 #define MAX_MATERIAL_NAME 128
 
@@ -58,8 +68,9 @@ struct VertexData {
 
 static_assert(sizeof(VertexData) == 5 * sizeof(uint32_t));
 
-std::vector<VertexData> vertexData_;
-std::vector<uint32_t> indexData_;
+MeshCache meshCache_;
+uint32_t numVertices_ = 0;
+uint32_t numIndices_ = 0;
 
 struct CachedMaterial {
   char name[MAX_MATERIAL_NAME] = {};
@@ -99,6 +110,8 @@ std::string normalizeTextureName(const char* n) {
   return name;
 }
 
+bool loadFromCache(const char* cacheFileName);
+
 bool loadAndCache(const std::string& folderContentRoot, const char* cacheFileName, const char* modelFileName) {
   LVK_PROFILER_FUNCTION();
 
@@ -124,7 +137,10 @@ bool loadAndCache(const std::string& folderContentRoot, const char* cacheFileNam
   for (uint32_t i = 0; i < mesh->face_count; ++i)
     vertexCount += mesh->face_vertices[i];
 
-  vertexData_.reserve(vertexCount);
+  std::vector<VertexData> vertexData;
+  std::vector<uint32_t> indexData;
+
+  vertexData.reserve(vertexCount);
 
   uint32_t vertexIndex = 0;
 
@@ -137,7 +153,7 @@ bool loadAndCache(const std::string& folderContentRoot, const char* cacheFileNam
       const float* n = &mesh->normals[gi.n * 3];
       const float* t = &mesh->texcoords[gi.t * 2];
 
-      vertexData_.push_back({
+      vertexData.push_back({
           .position = vec3(p[0], p[1], p[2]),
           .uv = glm::packHalf2x16(vec2(t[0], t[1])),
           .normal = packOctahedral16(vec3(n[0], n[1], n[2])),
@@ -149,25 +165,27 @@ bool loadAndCache(const std::string& folderContentRoot, const char* cacheFileNam
   // repack the mesh as described in https://github.com/zeux/meshoptimizer
   {
     // 1. Generate an index buffer
-    const size_t indexCount = vertexData_.size();
+    const size_t indexCount = vertexData.size();
     std::vector<uint32_t> remap(indexCount);
     const size_t vertexCount =
-        meshopt_generateVertexRemap(remap.data(), nullptr, indexCount, vertexData_.data(), indexCount, sizeof(VertexData));
+        meshopt_generateVertexRemap(remap.data(), nullptr, indexCount, vertexData.data(), indexCount, sizeof(VertexData));
     // 2. Remap vertices
     std::vector<VertexData> remappedVertices;
-    indexData_.resize(indexCount);
+    indexData.resize(indexCount);
     remappedVertices.resize(vertexCount);
-    meshopt_remapIndexBuffer(indexData_.data(), nullptr, indexCount, &remap[0]);
-    meshopt_remapVertexBuffer(remappedVertices.data(), vertexData_.data(), indexCount, sizeof(VertexData), remap.data());
-    vertexData_ = remappedVertices;
+    meshopt_remapIndexBuffer(indexData.data(), nullptr, indexCount, &remap[0]);
+    meshopt_remapVertexBuffer(remappedVertices.data(), vertexData.data(), indexCount, sizeof(VertexData), remap.data());
+    vertexData = remappedVertices;
     // 3. Optimize for the GPU vertex cache reuse and overdraw
-    meshopt_optimizeVertexCache(indexData_.data(), indexData_.data(), indexCount, vertexCount);
+    meshopt_optimizeVertexCache(indexData.data(), indexData.data(), indexCount, vertexCount);
     meshopt_optimizeOverdraw(
-        indexData_.data(), indexData_.data(), indexCount, &vertexData_[0].position.x, vertexCount, sizeof(VertexData), 1.05f);
-    meshopt_optimizeVertexFetch(vertexData_.data(), indexData_.data(), indexCount, vertexData_.data(), vertexCount, sizeof(VertexData));
+        indexData.data(), indexData.data(), indexCount, &vertexData[0].position.x, vertexCount, sizeof(VertexData), 1.05f);
+    meshopt_optimizeVertexFetch(vertexData.data(), indexData.data(), indexCount, vertexData.data(), vertexCount, sizeof(VertexData));
   }
 
   // loop over materials
+  std::vector<CachedMaterial> cachedMaterials;
+
   for (uint32_t mtlIdx = 0; mtlIdx != mesh->material_count; mtlIdx++) {
     const fastObjMaterial& m = mesh->materials[mtlIdx];
     CachedMaterial mtl;
@@ -178,60 +196,57 @@ bool loadAndCache(const std::string& folderContentRoot, const char* cacheFileNam
     strcat(mtl.ambient_texname, normalizeTextureName(mesh->textures[m.map_Ka].name).c_str());
     strcat(mtl.diffuse_texname, normalizeTextureName(mesh->textures[m.map_Kd].name).c_str());
     strcat(mtl.alpha_texname, normalizeTextureName(mesh->textures[m.map_d].name).c_str());
-    cachedMaterials_.push_back(mtl);
+    cachedMaterials.push_back(mtl);
   }
 
   LLOGL("Caching mesh...\n");
 
-  FILE* cacheFile = fopen(cacheFileName, "wb");
-  if (!cacheFile) {
+  MeshCacheWriter writer;
+  writer.addChunk(MeshCacheChunk_Materials, cachedMaterials.data(), (uint32_t)cachedMaterials.size(), sizeof(CachedMaterial));
+  writer.addChunk(MeshCacheChunk_Vertices,
+                  vertexData.data(),
+                  (uint32_t)vertexData.size(),
+                  sizeof(VertexData),
+                  kMeshCacheCompression ? MeshCacheEncoding_MeshoptVertex : MeshCacheEncoding_Raw);
+  writer.addChunk(MeshCacheChunk_Indices,
+                  indexData.data(),
+                  (uint32_t)indexData.size(),
+                  sizeof(uint32_t),
+                  kMeshCacheCompression ? MeshCacheEncoding_MeshoptIndex : MeshCacheEncoding_Raw);
+
+  if (!writer.write(cacheFileName, kMeshCacheVersion)) {
     return false;
   }
-  const uint32_t numMaterials = (uint32_t)cachedMaterials_.size();
-  const uint32_t numVertices = (uint32_t)vertexData_.size();
-  const uint32_t numIndices = (uint32_t)indexData_.size();
-  fwrite(&kMeshCacheVersion, sizeof(kMeshCacheVersion), 1, cacheFile);
-  fwrite(&numMaterials, sizeof(numMaterials), 1, cacheFile);
-  fwrite(&numVertices, sizeof(numVertices), 1, cacheFile);
-  fwrite(&numIndices, sizeof(numIndices), 1, cacheFile);
-  fwrite(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile);
-  fwrite(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile);
-  fwrite(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile);
-  return fclose(cacheFile) == 0;
+
+  // free the intermediate data before mapping the cache back
+  vertexData = {};
+  indexData = {};
+
+  return loadFromCache(cacheFileName);
 }
 
 bool loadFromCache(const char* cacheFileName) {
-  FILE* cacheFile = fopen(cacheFileName, "rb");
-  SCOPE_EXIT {
-    if (cacheFile) {
-      fclose(cacheFile);
-    }
-  };
-  if (!cacheFile) {
+  LVK_PROFILER_FUNCTION();
+
+  if (!meshCache_.open(cacheFileName, kMeshCacheVersion)) {
     return false;
   }
-#define CHECK_READ(expected, read) \
-  if ((read) != (expected)) {      \
-    return false;                  \
-  }
-  uint32_t versionProbe = 0;
-  CHECK_READ(1, fread(&versionProbe, sizeof(versionProbe), 1, cacheFile));
-  if (versionProbe != kMeshCacheVersion) {
-    LLOGL("Cache file has wrong version id\n");
+
+  const MeshCacheChunk* materials = meshCache_.findChunk(MeshCacheChunk_Materials);
+  const MeshCacheChunk* vertices = meshCache_.findChunk(MeshCacheChunk_Vertices);
+  const MeshCacheChunk* indices = meshCache_.findChunk(MeshCacheChunk_Indices);
+
+  if (!materials || materials->elementSize != sizeof(CachedMaterial) || !vertices || vertices->elementSize != sizeof(VertexData) ||
+      !indices || indices->elementSize != sizeof(uint32_t)) {
+    LLOGL("Cache file has wrong layout\n");
+    meshCache_.close();
     return false;
   }
-  uint32_t numMaterials = 0;
-  uint32_t numVertices = 0;
-  uint32_t numIndices = 0;
-  CHECK_READ(1, fread(&numMaterials, sizeof(numMaterials), 1, cacheFile));
-  CHECK_READ(1, fread(&numVertices, sizeof(numVertices), 1, cacheFile));
-  CHECK_READ(1, fread(&numIndices, sizeof(numIndices), 1, cacheFile));
-  cachedMaterials_.resize(numMaterials);
-  vertexData_.resize(numVertices);
-  indexData_.resize(numIndices);
-  CHECK_READ(numMaterials, fread(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile));
-  CHECK_READ(numVertices, fread(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile));
-  CHECK_READ(numIndices, fread(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile));
-#undef CHECK_READ
-  return true;
+
+  // materials are small and are needed on the CPU; vertices and indices stay in the mapped file until uploaded
+  cachedMaterials_.resize(materials->numElements);
+  numVertices_ = vertices->numElements;
+  numIndices_ = indices->numElements;
+
+  return meshCache_.read(MeshCacheChunk_Materials, cachedMaterials_.data());
 }
@@ -0,0 +1,461 @@
+/*
+ * LightweightVK
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ A memory-mapped container for cached meshes:
+
+   MeshCacheWriter writer;
+   writer.addChunk(id, data, numElements, elementSize, MeshCacheEncoding_MeshoptVertex);
+   writer.write(fileName, contentVersion);
+
+   MeshCache cache;
+   cache.open(fileName, contentVersion);
+   const T* data = cache.getData<T>(id); // raw chunks are accessed in-place
+   cache.upload(ctx, buffer, id); // streams a chunk into a GPU buffer, compressed chunks are decoded page by page
+
+ File layout (little-endian):
+
+   MeshCacheHeader
+   MeshCacheChunk[numChunks]
+   chunk data, every chunk starts at a kMeshCacheAlignment-aligned offset
+
+ Compressed chunks are split into independently encoded pages, so the peak memory on the CPU side is one decoded page:
+
+   uint32_t numPages
+   uint32_t elementsPerPage
+   MeshCachePage[numPages]
+   page data
+*/
+
+#pragma once
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <meshoptimizer.h>
+
+#include <lvk/LVK.h>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif // NOMINMAX
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+constexpr uint32_t kMeshCacheMagic = 0x434B564C; // 'LVKC'
+constexpr uint32_t kMeshCacheFormatVersion = 1;
+constexpr uint64_t kMeshCacheAlignment = 4096;
+constexpr uint64_t kMeshCachePageSize = 16 * 1024 * 1024; // decoded bytes per page, also the granularity of uploads
+
+enum MeshCacheEncoding : uint32_t {
+  MeshCacheEncoding_Raw = 0,
+  MeshCacheEncoding_MeshoptVertex, // meshopt_encodeVertexBuffer()
+  MeshCacheEncoding_MeshoptIndex, // meshopt_encodeIndexBuffer(), 32-bit indices only
+};
+
+struct MeshCacheHeader {
+  uint32_t magic = kMeshCacheMagic;
+  uint32_t formatVersion = kMeshCacheFormatVersion;
+  uint32_t contentVersion = 0; // defined by the application
+  uint32_t numChunks = 0;
+};
+
+struct MeshCacheChunk {
+  uint32_t id = 0; // defined by the application
+  uint32_t encoding = MeshCacheEncoding_Raw;
+  uint32_t elementSize = 0;
+  uint32_t numElements = 0;
+  uint64_t offset = 0; // from the beginning of the file
+  uint64_t size = 0; // stored bytes
+};
+
+struct MeshCachePage {
+  uint64_t offset = 0; // from the beginning of the chunk
+  uint64_t size = 0; // stored bytes
+};
+
+static_assert(sizeof(MeshCacheHeader) == 16);
+static_assert(sizeof(MeshCacheChunk) == 32);
+static_assert(sizeof(MeshCachePage) == 16);
+
+class MeshCacheWriter {
+ public:
+  // `data` should stay alive until write() is called
+  void addChunk(uint32_t id,
+                const void* data,
+                uint32_t numElements,
+                uint32_t elementSize,
+                MeshCacheEncoding encoding = MeshCacheEncoding_Raw) {
+    LVK_ASSERT(elementSize);
+    LVK_ASSERT(encoding != MeshCacheEncoding_MeshoptVertex || (elementSize % 4 == 0 && elementSize <= 256));
+    LVK_ASSERT(encoding != MeshCacheEncoding_MeshoptIndex || (elementSize == sizeof(uint32_t) && numElements % 3 == 0));
+    chunks_.push_back({id, (const uint8_t*)data, numElements, elementSize, encoding});
+  }
+
+  bool write(const char* fileName, uint32_t contentVersion) const {
+    LVK_PROFILER_FUNCTION();
+
+    std::vector<std::vector<uint8_t>> payloads(chunks_.size());
+    std::vector<MeshCacheChunk> table(chunks_.size());
+
+    uint64_t offset = getAlignedOffset(sizeof(MeshCacheHeader) + table.size() * sizeof(MeshCacheChunk));
+
+    for (size_t i = 0; i != chunks_.size(); i++) {
+      const Chunk& c = chunks_[i];
+      const uint64_t rawSize = uint64_t(c.numElements) * c.elementSize;
+      if (c.encoding != MeshCacheEncoding_Raw) {
+        payloads[i] = encode(c);
+      }
+      table[i] = {
+          .id = c.id,
+          .encoding = c.encoding,
+          .elementSize = c.elementSize,
+          .numElements = c.numElements,
+          .offset = offset,
+          .size = c.encoding == MeshCacheEncoding_Raw ? rawSize : payloads[i].size(),
+      };
+      offset = getAlignedOffset(offset + table[i].size);
+    }
+
+    FILE* file = fopen(fileName, "wb");
+    if (!file) {
+      return false;
+    }
+
+    const MeshCacheHeader header = {.contentVersion = contentVersion, .numChunks = (uint32_t)table.size()};
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(table.data(), sizeof(MeshCacheChunk), table.size(), file) == table.size();
+
+    uint64_t pos = sizeof(header) + table.size() * sizeof(MeshCacheChunk);
+
+    for (size_t i = 0; ok && i != table.size(); i++) {
+      ok = pad(file, table[i].offset - pos);
+      const void* data = chunks_[i].encoding == MeshCacheEncoding_Raw ? chunks_[i].data : payloads[i].data();
+      ok = ok && (!table[i].size || fwrite(data, table[i].size, 1, file) == 1);
+      pos = table[i].offset + table[i].size;
+    }
+
+    // the last chunk is padded as well, so it can be mapped by whole pages
+    ok = ok && pad(file, getAlignedOffset(pos) - pos);
+
+    return (fclose(file) == 0) && ok;
+  }
+
+ private:
+  struct Chunk {
+    uint32_t id;
+    const uint8_t* data;
+    uint32_t numElements;
+    uint32_t elementSize;
+    MeshCacheEncoding encoding;
+  };
+
+  static uint64_t getAlignedOffset(uint64_t offset) {
+    return (offset + kMeshCacheAlignment - 1) & ~(kMeshCacheAlignment - 1);
+  }
+
+  static bool pad(FILE* file, uint64_t size) {
+    const uint8_t zeros[256] = {};
+    while (size) {
+      const size_t n = (size_t)std::min(size, (uint64_t)sizeof(zeros));
+      if (fwrite(zeros, n, 1, file) != 1) {
+        return false;
+      }
+      size -= n;
+    }
+    return true;
+  }
+
+  static std::vector<uint8_t> encode(const Chunk& c) {
+    uint32_t elementsPerPage = std::max(uint32_t(kMeshCachePageSize / c.elementSize), 1u);
+    if (c.encoding == MeshCacheEncoding_MeshoptIndex) {
+      elementsPerPage -= elementsPerPage % 3; // whole triangles
+    }
+    const uint32_t numPages = (c.numElements + elementsPerPage - 1) / elementsPerPage;
+    const uint64_t pagesOffset = 2 * sizeof(uint32_t) + numPages * sizeof(MeshCachePage);
+
+    std::vector<uint8_t> out(pagesOffset);
+    memcpy(out.data(), &numPages, sizeof(numPages));
+    memcpy(out.data() + sizeof(numPages), &elementsPerPage, sizeof(elementsPerPage));
+
+    std::vector<uint8_t> page;
+
+    for (uint32_t p = 0; p != numPages; p++) {
+      const uint32_t first = p * elementsPerPage;
+      const uint32_t count = std::min(elementsPerPage, c.numElements - first);
+      const uint8_t* src = c.data + uint64_t(first) * c.elementSize;
+
+      if (c.encoding == MeshCacheEncoding_MeshoptVertex) {
+        page.resize(meshopt_encodeVertexBufferBound(count, c.elementSize));
+        page.resize(meshopt_encodeVertexBuffer(page.data(), page.size(), src, count, c.elementSize));
+      } else {
+        const uint32_t* indices = reinterpret_cast<const uint32_t*>(src);
+        const uint32_t maxIndex = count ? *std::max_element(indices, indices + count) : 0;
+        page.resize(meshopt_encodeIndexBufferBound(count, maxIndex + 1));
+        page.resize(meshopt_encodeIndexBuffer(page.data(), page.size(), indices, count));
+      }
+      LVK_ASSERT(!page.empty());
+
+      const MeshCachePage desc = {.offset = out.size(), .size = page.size()};
+      memcpy(out.data() + 2 * sizeof(uint32_t) + p * sizeof(MeshCachePage), &desc, sizeof(desc));
+      out.insert(out.end(), page.begin(), page.end());
+    }
+
+    return out;
+  }
+
+ private:
+  std::vector<Chunk> chunks_;
+};
+
+class MeshCache {
+ public:
+  MeshCache() = default;
+  ~MeshCache() {
+    close();
+  }
+  MeshCache(const MeshCache&) = delete;
+  MeshCache& operator=(const MeshCache&) = delete;
+
+  bool open(const char* fileName, uint32_t contentVersion) {
+    close();
+
+    if (!map(fileName)) {
+      return false;
+    }
+
+    bool ok = size_ >= sizeof(MeshCacheHeader);
+
+    if (ok) {
+      memcpy(&header_, data_, sizeof(header_));
+      ok = header_.magic == kMeshCacheMagic && header_.formatVersion == kMeshCacheFormatVersion;
+    }
+    if (ok && header_.contentVersion != contentVersion) {
+      LLOGL("Cache file has wrong version id\n");
+      ok = false;
+    }
+
+    ok = ok && sizeof(MeshCacheHeader) + uint64_t(header_.numChunks) * sizeof(MeshCacheChunk) <= size_;
+
+    for (uint32_t i = 0; ok && i != header_.numChunks; i++) {
+      const MeshCacheChunk& c = getChunks()[i];
+      ok = c.elementSize && c.offset % kMeshCacheAlignment == 0 && c.offset <= size_ && c.size <= size_ - c.offset;
+      if (ok && c.encoding == MeshCacheEncoding_Raw) {
+        ok = c.size == uint64_t(c.numElements) * c.elementSize;
+      }
+    }
+
+    if (!ok) {
+      close();
+    }
+
+    return ok;
+  }
+
+  void close() {
+    unmap();
+    header_ = {};
+  }
+
+  [[nodiscard]] bool isOpen() const {
+    return data_ != nullptr;
+  }
+
+  [[nodiscard]] const MeshCacheChunk* findChunk(uint32_t id) const {
+    for (uint32_t i = 0; i != header_.numChunks; i++) {
+      if (getChunks()[i].id == id) {
+        return &getChunks()[i];
+      }
+    }
+    return nullptr;
+  }
+
+  [[nodiscard]] uint32_t getNumElements(uint32_t id) const {
+    const MeshCacheChunk* c = findChunk(id);
+    return c ? c->numElements : 0;
+  }
+
+  // zero-copy access to raw chunks; returns nullptr for missing or compressed chunks and for mismatching element sizes
+  template <typename T>
+  [[nodiscard]] const T* getData(uint32_t id) const {
+    const MeshCacheChunk* c = findChunk(id);
+    if (!c || c->encoding != MeshCacheEncoding_Raw || c->elementSize != sizeof(T)) {
+      return nullptr;
+    }
+    return reinterpret_cast<const T*>(data_ + c->offset);
+  }
+
+  // decodes a whole chunk into `dst`, which should be at least numElements * elementSize bytes
+  bool read(uint32_t id, void* dst) const {
+    return forEachPage(id, [dst](const uint8_t* data, uint64_t offset, uint64_t size) -> bool {
+      memcpy((uint8_t*)dst + offset, data, size);
+      return true;
+    });
+  }
+
+  // streams a chunk into `buffer` at `bufferOffset` without materializing the whole chunk in memory
+  bool upload(lvk::IContext& ctx, lvk::BufferHandle buffer, uint32_t id, size_t bufferOffset = 0) const {
+    LVK_PROFILER_FUNCTION();
+    return forEachPage(id, [&ctx, buffer, bufferOffset](const uint8_t* data, uint64_t offset, uint64_t size) -> bool {
+      return ctx.upload(buffer, data, size, bufferOffset + offset).isOk();
+    });
+  }
+
+ private:
+  [[nodiscard]] const MeshCacheChunk* getChunks() const {
+    return reinterpret_cast<const MeshCacheChunk*>(data_ + sizeof(MeshCacheHeader));
+  }
+
+  // calls `fn(data, offset, size)` for consecutive pieces of the decoded chunk, each at most kMeshCachePageSize bytes
+  template <typename Fn>
+  bool forEachPage(uint32_t id, Fn&& fn) const {
+    const MeshCacheChunk* c = findChunk(id);
+
+    if (!LVK_VERIFY(c)) {
+      return false;
+    }
+
+    const uint8_t* chunk = data_ + c->offset;
+
+    if (c->encoding == MeshCacheEncoding_Raw) {
+      for (uint64_t offset = 0; offset < c->size; offset += kMeshCachePageSize) {
+        if (!fn(chunk + offset, offset, std::min(kMeshCachePageSize, c->size - offset))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    uint32_t numPages = 0;
+    uint32_t elementsPerPage = 0;
+
+    if (c->size < 2 * sizeof(uint32_t)) {
+      return false;
+    }
+    memcpy(&numPages, chunk, sizeof(numPages));
+    memcpy(&elementsPerPage, chunk + sizeof(numPages), sizeof(elementsPerPage));
+
+    if (!elementsPerPage || uint64_t(numPages) * elementsPerPage < c->numElements ||
+        2 * sizeof(uint32_t) + uint64_t(numPages) * sizeof(MeshCachePage) > c->size) {
+      return false;
+    }
+
+    std::vector<uint8_t> decoded(uint64_t(std::min(elementsPerPage, c->numElements)) * c->elementSize);
+
+    for (uint32_t p = 0; p != numPages; p++) {
+      MeshCachePage page;
+      memcpy(&page, chunk + 2 * sizeof(uint32_t) + p * sizeof(MeshCachePage), sizeof(page));
+
+      const uint32_t first = p * elementsPerPage;
+
+      if (first >= c->numElements || page.offset > c->size || page.size > c->size - page.offset) {
+        return false;
+      }
+
+      const uint32_t count = std::min(elementsPerPage, c->numElements - first);
+      const int result = c->encoding == MeshCacheEncoding_MeshoptVertex
+                             ? meshopt_decodeVertexBuffer(decoded.data(), count, c->elementSize, chunk + page.offset, page.size)
+                             : meshopt_decodeIndexBuffer(decoded.data(), count, c->elementSize, chunk + page.offset, page.size);
+      if (result != 0) {
+        LLOGW("Cannot decode page %u of chunk %u (error %i)\n", p, c->id, result);
+        return false;
+      }
+      if (!fn(decoded.data(), uint64_t(first) * c->elementSize, uint64_t(count) * c->elementSize)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool map(const char* fileName) {
+#if defined(_WIN32)
+    file_ = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      return false;
+    }
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file_, &size) || !size.QuadPart) {
+      unmap();
+      return false;
+    }
+    size_ = (uint64_t)size.QuadPart;
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data_ = mapping_ ? (const uint8_t*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+    fd_ = ::open(fileName, O_RDONLY);
+    if (fd_ < 0) {
+      return false;
+    }
+    struct stat st = {};
+    if (fstat(fd_, &st) != 0 || !st.st_size) {
+      unmap();
+      return false;
+    }
+    size_ = (uint64_t)st.st_size;
+    void* ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    data_ = ptr != MAP_FAILED ? (const uint8_t*)ptr : nullptr;
+    if (data_) {
+      madvise(ptr, size_, MADV_SEQUENTIAL);
+    }
+#endif // _WIN32
+    if (!data_) {
+      unmap();
+      return false;
+    }
+    return true;
+  }
+
+  void unmap() {
+#if defined(_WIN32)
+    if (data_) {
+      UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+      CloseHandle(mapping_);
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+      CloseHandle(file_);
+    }
+    mapping_ = nullptr;
+    file_ = INVALID_HANDLE_VALUE;
+#else
+    if (data_) {
+      munmap((void*)data_, size_);
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    fd_ = -1;
+#endif // _WIN32
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+ private:
+#if defined(_WIN32)
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#else
+  int fd_ = -1;
+#endif // _WIN32
+  const uint8_t* data_ = nullptr;
+  uint64_t size_ = 0;
+  MeshCacheHeader header_ = {};
+};
@@ -739,18 +739,23 @@ bool initModel(const std::string& folderContentRoot) {
   res.vb0_ = ctx_->createBuffer({
       .usage = lvk::BufferUsageBits_Vertex | lvk::BufferUsageBits_AccelStructBuildInputReadOnly,
       .storage = lvk::StorageType_Device,
-      .size = sizeof(VertexData) * vertexData_.size(),
-      .data = vertexData_.data(),
+      .size = sizeof(VertexData) * numVertices_,
       .debugName = "Buffer: vertex",
   });
   res.ib0_ = ctx_->createBuffer({
       .usage = lvk::BufferUsageBits_Index | lvk::BufferUsageBits_AccelStructBuildInputReadOnly,
       .storage = lvk::StorageType_Device,
-      .size = sizeof(uint32_t) * indexData_.size(),
-      .data = indexData_.data(),
+      .size = sizeof(uint32_t) * numIndices_,
       .debugName = "Buffer: index",
   });
 
+  // stream vertices and indices straight from the memory-mapped cache
+  if (!LVK_VERIFY(meshCache_.upload(*ctx_, res.vb0_, MeshCacheChunk_Vertices)) ||
+      !LVK_VERIFY(meshCache_.upload(*ctx_, res.ib0_, MeshCacheChunk_Indices))) {
+    return false;
+  }
+  meshCache_.close();
+
   const glm::mat3x4 transformMatrix(1.0f);
 
   lvk::Holder<lvk::BufferHandle> transformBuffer = ctx_->createBuffer({
@@ -760,14 +765,14 @@ bool initModel(const std::string& folderContentRoot) {
       .data = &transformMatrix,
   });
 
-  const uint32_t totalPrimitiveCount = (uint32_t)indexData_.size() / 3;
+  const uint32_t totalPrimitiveCount = numIndices_ / 3;
   lvk::AccelStructDesc blasDesc{
       .type = lvk::AccelStructType_BLAS,
       .geometryType = lvk::AccelStructGeomType_Triangles,
       .vertexFormat = lvk::VertexFormat::Float3,
       .vertexBuffer = res.vb0_,
       .vertexStride = sizeof(VertexData),
-      .numVertices = (uint32_t)vertexData_.size(),
+      .numVertices = numVertices_,
       .indexFormat = lvk::IndexFormat_UI32,
       .indexBuffer = res.ib0_,
       .transformBuffer = transformBuffer,
@@ -1044,7 +1049,7 @@ VULKAN_APP_MAIN {
       };
       buffer.cmdPushConstants(pc);
       buffer.cmdBindDepthState({.compareOp = lvk::CompareOp_Less, .isDepthWriteEnabled = true});
-      buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+      buffer.cmdDrawIndexed(numIndices_);
       buffer.cmdPopDebugGroupLabel();
       buffer.cmdEndRendering();
     }
@@ -1082,7 +1087,7 @@ VULKAN_APP_MAIN {
       };
       buffer.cmdPushConstants(pc);
       buffer.cmdBindDepthState({.compareOp = lvk::CompareOp_Equal, .isDepthWriteEnabled = false});
-      buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+      buffer.cmdDrawIndexed(numIndices_);
       buffer.cmdPopDebugGroupLabel();
       buffer.cmdEndRendering();
     }
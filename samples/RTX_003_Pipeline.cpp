@@ -499,17 +499,22 @@ bool initModel(const std::string& folderContentRoot) {
 
   res.vb0_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Storage | lvk::BufferUsageBits_AccelStructBuildInputReadOnly,
                                  .storage = lvk::StorageType_Device,
-                                 .size = sizeof(VertexData) * vertexData_.size(),
-                                 .data = vertexData_.data(),
+                                 .size = sizeof(VertexData) * numVertices_,
                                  .debugName = "Buffer: vertex"},
                                 nullptr);
   res.ib0_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Storage | lvk::BufferUsageBits_AccelStructBuildInputReadOnly,
                                  .storage = lvk::StorageType_Device,
-                                 .size = sizeof(uint32_t) * indexData_.size(),
-                                 .data = indexData_.data(),
+                                 .size = sizeof(uint32_t) * numIndices_,
                                  .debugName = "Buffer: index"},
                                 nullptr);
 
+  // stream vertices and indices straight from the memory-mapped cache
+  if (!LVK_VERIFY(meshCache_.upload(*ctx_, res.vb0_, MeshCacheChunk_Vertices)) ||
+      !LVK_VERIFY(meshCache_.upload(*ctx_, res.ib0_, MeshCacheChunk_Indices))) {
+    return false;
+  }
+  meshCache_.close();
+
   const glm::mat3x4 transformMatrix(1.0f);
 
   lvk::Holder<lvk::BufferHandle> transformBuffer = ctx_->createBuffer({
@@ -519,14 +524,14 @@ bool initModel(const std::string& folderContentRoot) {
       .data = &transformMatrix,
   });
 
-  const auto totalPrimitiveCount = (uint32_t)indexData_.size() / 3;
+  const auto totalPrimitiveCount = numIndices_ / 3;
   lvk::AccelStructDesc blasDesc{
       .type = lvk::AccelStructType_BLAS,
       .geometryType = lvk::AccelStructGeomType_Triangles,
       .vertexFormat = lvk::VertexFormat::Float3,
       .vertexBuffer = res.vb0_,
       .vertexStride = sizeof(VertexData),
-      .numVertices = (uint32_t)vertexData_.size(),
+      .numVertices = numVertices_,
       .indexFormat = lvk::IndexFormat_UI32,
       .indexBuffer = res.ib0_,
       .transformBuffer = transformBuffer,
@@ -552,23 +557,31 @@ bool initModel(const std::string& folderContentRoot) {
   LLOGL("maxStorageBufferSize = %u bytes\nNumber of BLAS = %u\n", maxStorageBufferSize, requiredBlasCount);
 
   const glm::mat3x4 transform(glm::scale(mat4(1.0f), vec3(0.05f)));
-  res.BLAS_.reserve(requiredBlasCount);
 
-  std::vector<lvk::AccelStructInstance> instances;
-  instances.reserve(requiredBlasCount);
+  // build all BLASes at once and compact them
+  blasDesc.buildFlags |= lvk::AccelStructBuildFlagBits_AllowCompaction;
+  std::vector<lvk::AccelStructDesc> blasDescs;
+  blasDescs.reserve(requiredBlasCount);
   const auto primitiveCount = blasDesc.buildRange.primitiveCount;
   for (int i = 0; i < totalPrimitiveCount; i += (int)primitiveCount) {
     const auto rest = (int)totalPrimitiveCount - i;
     blasDesc.buildRange.primitiveOffset = (uint32_t)i * 3 * sizeof(uint32_t);
     blasDesc.buildRange.primitiveCount = (primitiveCount < rest) ? primitiveCount : rest;
-    res.BLAS_.emplace_back(ctx_->createAccelerationStructure(blasDesc));
+    blasDescs.push_back(blasDesc);
+  }
+  res.BLAS_.resize(blasDescs.size());
+  ctx_->createAccelerationStructures(blasDescs.data(), res.BLAS_.data(), (uint32_t)blasDescs.size());
+
+  std::vector<lvk::AccelStructInstance> instances;
+  instances.reserve(res.BLAS_.size());
+  for (const lvk::Holder<lvk::AccelStructHandle>& blas : res.BLAS_) {
     instances.emplace_back(lvk::AccelStructInstance{
         .transform = (const lvk::mat3x4&)transform,
         .instanceCustomIndex = 0,
         .mask = 0xff,
         .instanceShaderBindingTableRecordOffset = 0,
         .flags = lvk::AccelStructInstanceFlagBits_TriangleFacingCullDisable,
-        .accelerationStructureReference = ctx_->gpuAddress(res.BLAS_.back()),
+        .accelerationStructureReference = ctx_->gpuAddress(blas),
     });
   }
 
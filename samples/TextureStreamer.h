@@ -0,0 +1,480 @@
+/*
+ * LightweightVK
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ Asynchronous streaming of KTX2 textures:
+
+   TextureStreamer streamer(ctx, {});
+   const uint32_t id = streamer.request({.fileName = "texture.ktx2"});
+   ...
+   // every frame, on the thread which records command buffers
+   if (streamer.update()) {
+     material.tex = streamer.getTextureIndex(id); // a placeholder until the first mip-levels arrive
+   }
+
+ 1. Worker threads load KTX2 files and transcode Basis Universal payloads into the best format supported by the device
+    (BC7, ASTC 4x4, or RGBA8). Uncompressed KTX2 files are used as-is.
+ 2. update() uploads the mip-tail (all mip-levels not larger than `Config::tailSize`) through IContext::uploadAsync(), so every texture
+    becomes visible after a few frames.
+ 3. Then the resolution is refined one mip-level at a time while the device-local memory stays within `Config::budgetFraction` of the
+    budget. Every refinement step uploads a new texture with one more mip-level and replaces the old one once the upload has completed.
+ 4. When the context reports the memory budget to be exceeded, the largest textures are downgraded one mip-level at a time (but never
+    below the mip-tail).
+
+ Mip-level data on the CPU side is released once a texture is at full resolution or cannot be refined because of the budget; it is
+ reloaded from the file when needed again.
+*/
+
+#pragma once
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ktx-software/lib/src/vkformat_enum.h>
+#include <ktx.h>
+#include <ldrutils/lutils/ScopeExit.h>
+#include <taskflow/taskflow.hpp>
+
+#include <lvk/LVK.h>
+
+constexpr uint32_t kInvalidStreamedTexture = 0xFFFFFFFF;
+
+struct StreamedTextureDesc {
+  std::string fileName; // KTX2
+  lvk::ComponentMapping components = {};
+  // Invoked on a worker thread before the file is opened, e.g. to compress the KTX2 file if it does not exist yet. Returning false marks
+  // the texture as failed.
+  std::function<bool(const std::string& fileName)> prepare;
+  std::string debugName;
+};
+
+class TextureStreamer final {
+ public:
+  struct Config {
+    uint32_t numThreads = 2;
+    uint32_t tailSize = 64; // in pixels
+    uint32_t placeholderColor = 0xFF808080; // ABGR
+    size_t maxUploadBytesPerFrame = 32 * 1024 * 1024; // the mip-tail of new textures ignores this limit for at least one texture per frame
+    float budgetFraction = 0.8f; // refine while the usage of the largest device-local heap is below this fraction of its budget
+    float evictionThreshold = 0.95f; // see IContext::setMemoryBudgetCallback()
+  };
+
+  TextureStreamer(lvk::IContext& ctx, const Config& cfg) : ctx_(ctx), cfg_(cfg), executor_(std::max(cfg.numThreads, 1u)) {
+    if (ctx_.isTextureFormatSupported(lvk::Format_BC7_RGBA)) {
+      transcodeFormat_ = KTX_TTF_BC7_RGBA;
+    } else if (ctx_.isTextureFormatSupported(lvk::Format_ASTC_4x4_RGBA)) {
+      transcodeFormat_ = KTX_TTF_ASTC_4x4_RGBA;
+    } else {
+      transcodeFormat_ = KTX_TTF_RGBA32;
+    }
+
+    placeholder_ = ctx_.createTexture({
+        .format = lvk::Format_RGBA_UN8,
+        .dimensions = {1, 1},
+        .usage = lvk::TextureUsageBits_Sampled,
+        .data = &cfg_.placeholderColor,
+        .debugName = "TextureStreamer::placeholder_",
+    });
+
+    ctx_.setMemoryBudgetCallback(onMemoryBudget, this, cfg_.evictionThreshold);
+  }
+
+  ~TextureStreamer() {
+    shouldExit_.store(true, std::memory_order_release);
+    executor_.wait_for_all();
+    ctx_.setMemoryBudgetCallback(nullptr, nullptr);
+  }
+
+  TextureStreamer(const TextureStreamer&) = delete;
+  TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+  // requests of the same file return the same id
+  uint32_t request(const StreamedTextureDesc& desc) {
+    if (desc.fileName.empty()) {
+      return kInvalidStreamedTexture;
+    }
+
+    const auto it = ids_.find(desc.fileName);
+
+    if (it != ids_.end()) {
+      return it->second;
+    }
+
+    const uint32_t id = (uint32_t)textures_.size();
+
+    textures_.emplace_back();
+    textures_.back().desc = desc;
+    ids_[desc.fileName] = id;
+
+    load(id);
+
+    return id;
+  }
+
+  // returns true if any getTextureIndex() value has changed
+  bool update() {
+    LVK_PROFILER_FUNCTION();
+
+    bool changed = false;
+
+    // 1. Swap in the textures whose uploads have completed
+    for (StreamedTexture& t : textures_) {
+      if (t.pendingTexture.empty() || !ctx_.isReady(t.pendingSubmit)) {
+        continue;
+      }
+      t.texture = std::move(t.pendingTexture);
+      t.residentLevel = t.pendingLevel;
+      t.pendingSubmit = {};
+      if (t.residentLevel == 0) {
+        releaseData(t);
+      }
+      changed = true;
+    }
+
+    // 2. Take the data loaded by worker threads
+    {
+      std::lock_guard lock(loadedMutex_);
+      for (LoadedTexture& l : loaded_) {
+        StreamedTexture& t = textures_[l.id];
+        t.isLoading = false;
+        if (l.format == lvk::Format_Invalid) {
+          if (t.residentLevel == kNotResident) {
+            t.isFailed = true;
+            changed = true;
+          } else {
+            // a refinement or a downgrade could not reload the file - keep the resident mip-levels
+            t.targetLevel = t.residentLevel;
+            t.isReloadFailed = true;
+          }
+          continue;
+        }
+        t.format = l.format;
+        t.dimensions = l.dimensions;
+        t.numLevels = l.numLevels;
+        t.data = std::move(l.data);
+        memcpy(t.levelOffsets, l.levelOffsets, sizeof(t.levelOffsets));
+        if (t.residentLevel == kNotResident) {
+          t.targetLevel = getTailLevel(t);
+        }
+      }
+      loaded_.clear();
+    }
+
+    lvk::MemoryStats stats;
+    ctx_.getMemoryStats(stats);
+
+    uint64_t heapSize = 0;
+    uint64_t budget = 0;
+    uint64_t usage = 0;
+    for (uint32_t i = 0; i != stats.numHeaps; i++) {
+      if (stats.heaps[i].isDeviceLocal && stats.heaps[i].size > heapSize) {
+        heapSize = stats.heaps[i].size;
+        budget = stats.heaps[i].budget;
+        usage = stats.heaps[i].usage;
+      }
+    }
+
+    const bool isOverBudget = isOverBudget_.exchange(false, std::memory_order_acq_rel);
+
+    // 3. Downgrade the largest texture when the context runs out of memory
+    if (isOverBudget) {
+      StreamedTexture* largest = nullptr;
+      for (StreamedTexture& t : textures_) {
+        if (t.texture.empty() || !t.pendingTexture.empty() || t.residentLevel >= getTailLevel(t)) {
+          continue;
+        }
+        if (!largest || getNumBytes(t, t.residentLevel) > getNumBytes(*largest, largest->residentLevel)) {
+          largest = &t;
+        }
+      }
+      if (largest) {
+        largest->targetLevel = largest->residentLevel + 1;
+      }
+    }
+
+    // 4. Upload new mip-tails, refinements, and downgrades
+    size_t uploadedBytes = 0;
+
+    for (uint32_t i = 0; i != textures_.size(); i++) {
+      StreamedTexture& t = textures_[(nextTexture_ + i) % textures_.size()];
+
+      if (t.isFailed || t.isLoading || !t.pendingTexture.empty()) {
+        continue;
+      }
+
+      if (t.residentLevel != kNotResident && t.targetLevel == t.residentLevel && t.residentLevel > 0 && !isOverBudget) {
+        const uint64_t bytes = getNumBytes(t, t.residentLevel - 1);
+        if (!budget || usage + bytes <= uint64_t(cfg_.budgetFraction * double(budget))) {
+          t.targetLevel = t.residentLevel - 1;
+        } else {
+          releaseData(t);
+        }
+      }
+
+      if (t.targetLevel == t.residentLevel) {
+        continue;
+      }
+
+      if (t.data.empty()) {
+        if (t.isReloadFailed) {
+          // do not hit the file system every frame
+          t.targetLevel = t.residentLevel;
+        } else {
+          load(uint32_t(&t - textures_.data()));
+        }
+        continue;
+      }
+
+      const size_t bytes = getNumBytes(t, t.targetLevel);
+      const bool isFirstUpload = t.residentLevel == kNotResident && uploadedBytes == 0;
+
+      if (uploadedBytes + bytes > cfg_.maxUploadBytesPerFrame && !isFirstUpload) {
+        nextTexture_ = uint32_t(&t - textures_.data());
+        break;
+      }
+
+      bool isStagingFull = false;
+
+      if (upload(t, isStagingFull)) {
+        uploadedBytes += bytes;
+        usage += bytes;
+      } else if (isStagingFull) {
+        nextTexture_ = uint32_t(&t - textures_.data());
+        break;
+      }
+    }
+
+    return changed;
+  }
+
+  [[nodiscard]] uint32_t getTextureIndex(uint32_t id) const {
+    if (id == kInvalidStreamedTexture || textures_[id].isFailed) {
+      return 0;
+    }
+    return textures_[id].texture.empty() ? placeholder_.index() : textures_[id].texture.index();
+  }
+
+  [[nodiscard]] bool isResident(uint32_t id) const {
+    return id != kInvalidStreamedTexture && !textures_[id].texture.empty();
+  }
+
+  // the number of requested textures which are not visible yet
+  [[nodiscard]] uint32_t getNumLoading() const {
+    return (uint32_t)std::count_if(
+        textures_.begin(), textures_.end(), [](const StreamedTexture& t) { return t.texture.empty() && !t.isFailed; });
+  }
+
+  [[nodiscard]] uint32_t getNumTextures() const {
+    return (uint32_t)textures_.size();
+  }
+
+ private:
+  enum { kNotResident = lvk::LVK_MAX_MIP_LEVELS };
+
+  struct StreamedTexture {
+    StreamedTextureDesc desc;
+    lvk::Format format = lvk::Format_Invalid;
+    lvk::Dimensions dimensions = {};
+    uint32_t numLevels = 0;
+    // all mip-levels tightly packed starting from the largest one (as expected by IContext::uploadAsync())
+    std::vector<uint8_t> data;
+    uint32_t levelOffsets[lvk::LVK_MAX_MIP_LEVELS + 1] = {};
+    lvk::Holder<lvk::TextureHandle> texture; // contains mip-levels [residentLevel...numLevels)
+    lvk::Holder<lvk::TextureHandle> pendingTexture; // contains mip-levels [pendingLevel...numLevels) after `pendingSubmit` has completed
+    lvk::SubmitHandle pendingSubmit;
+    uint32_t residentLevel = kNotResident;
+    uint32_t pendingLevel = kNotResident;
+    uint32_t targetLevel = kNotResident;
+    bool isLoading = false;
+    bool isFailed = false;
+    bool isReloadFailed = false; // the mip-levels which are resident stay until the texture is destroyed
+  };
+
+  struct LoadedTexture {
+    uint32_t id = 0;
+    lvk::Format format = lvk::Format_Invalid;
+    lvk::Dimensions dimensions = {};
+    uint32_t numLevels = 0;
+    std::vector<uint8_t> data;
+    uint32_t levelOffsets[lvk::LVK_MAX_MIP_LEVELS + 1] = {};
+  };
+
+  static void onMemoryBudget(const lvk::MemoryStats& stats, uint32_t heapIndex, void* userData) {
+    if (stats.heaps[heapIndex].isDeviceLocal) {
+      static_cast<TextureStreamer*>(userData)->isOverBudget_.store(true, std::memory_order_release);
+    }
+  }
+
+  static lvk::Format formatFromVkFormat(uint32_t vkFormat) {
+    switch (vkFormat) {
+    case VK_FORMAT_R8_UNORM:
+      return lvk::Format_R_UN8;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+      return lvk::Format_RGBA_UN8;
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+      return lvk::Format_BC7_RGBA;
+    case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+      return lvk::Format_ASTC_4x4_RGBA;
+    default:
+      return lvk::Format_Invalid;
+    }
+  }
+
+  uint32_t getTailLevel(const StreamedTexture& t) const {
+    uint32_t level = 0;
+    while (level + 1 < t.numLevels && std::max(t.dimensions.width >> level, t.dimensions.height >> level) > cfg_.tailSize) {
+      level++;
+    }
+    return level;
+  }
+
+  // the size of mip-levels [level...numLevels)
+  static size_t getNumBytes(const StreamedTexture& t, uint32_t level) {
+    return t.levelOffsets[t.numLevels] - t.levelOffsets[level];
+  }
+
+  static void releaseData(StreamedTexture& t) {
+    std::vector<uint8_t>().swap(t.data);
+  }
+
+  void load(uint32_t id) {
+    StreamedTexture& t = textures_[id];
+
+    LVK_ASSERT(!t.isLoading);
+
+    t.isLoading = true;
+
+    executor_.silent_async([this, id, desc = t.desc]() {
+      LoadedTexture l = {.id = id};
+      if (!shouldExit_.load(std::memory_order_acquire)) {
+        if (!desc.prepare || desc.prepare(desc.fileName)) {
+          loadFile(desc.fileName.c_str(), l);
+        }
+      }
+      std::lock_guard lock(loadedMutex_);
+      loaded_.push_back(std::move(l));
+    });
+  }
+
+  // worker threads
+  void loadFile(const char* fileName, LoadedTexture& l) const {
+    LVK_PROFILER_FUNCTION();
+
+    ktxTexture2* ktx = nullptr;
+
+    if (ktxTexture2_CreateFromNamedFile(fileName, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &ktx) != KTX_SUCCESS) {
+      LLOGW("TextureStreamer: cannot load %s\n", fileName);
+      return;
+    }
+
+    SCOPE_EXIT {
+      ktxTexture_Destroy(ktxTexture(ktx));
+    };
+
+    if (ktxTexture2_NeedsTranscoding(ktx) && ktxTexture2_TranscodeBasis(ktx, transcodeFormat_, 0) != KTX_SUCCESS) {
+      LLOGW("TextureStreamer: cannot transcode %s\n", fileName);
+      return;
+    }
+
+    const lvk::Format format = formatFromVkFormat(ktx->vkFormat);
+
+    if (format == lvk::Format_Invalid || ktx->numDimensions != 2 || ktx->numLayers != 1 || ktx->numFaces != 1 ||
+        ktx->numLevels > lvk::LVK_MAX_MIP_LEVELS) {
+      LLOGW("TextureStreamer: unsupported texture %s (VkFormat = %u)\n", fileName, ktx->vkFormat);
+      return;
+    }
+
+    l.dimensions = {ktx->baseWidth, ktx->baseHeight};
+    l.numLevels = ktx->numLevels;
+
+    for (uint32_t i = 0; i != l.numLevels; i++) {
+      l.levelOffsets[i + 1] = l.levelOffsets[i] + lvk::getTextureBytesPerLayer(l.dimensions.width, l.dimensions.height, format, i);
+    }
+
+    l.data.resize(l.levelOffsets[l.numLevels]);
+
+    for (uint32_t i = 0; i != l.numLevels; i++) {
+      ktx_size_t offset = 0;
+      (void)LVK_VERIFY(ktxTexture_GetImageOffset(ktxTexture(ktx), i, 0, 0, &offset) == KTX_SUCCESS);
+      LVK_ASSERT(ktxTexture_GetImageSize(ktxTexture(ktx), i) == l.levelOffsets[i + 1] - l.levelOffsets[i]);
+      memcpy(l.data.data() + l.levelOffsets[i], ktxTexture_GetData(ktxTexture(ktx)) + offset, l.levelOffsets[i + 1] - l.levelOffsets[i]);
+    }
+
+    l.format = format;
+  }
+
+  bool upload(StreamedTexture& t, bool& isStagingFull) {
+    const uint32_t level = t.targetLevel;
+    const lvk::Dimensions dim = {
+        .width = std::max(t.dimensions.width >> level, 1u),
+        .height = std::max(t.dimensions.height >> level, 1u),
+    };
+
+    lvk::Result result;
+    lvk::Holder<lvk::TextureHandle> texture = ctx_.createTexture(
+        {
+            .format = t.format,
+            .dimensions = dim,
+            .usage = lvk::TextureUsageBits_Sampled,
+            .numMipLevels = t.numLevels - level,
+            .components = t.desc.components,
+            .isShared = true, // uploaded on the transfer queue
+            .debugName = t.desc.debugName.c_str(),
+        },
+        nullptr,
+        &result);
+
+    if (result.isOk()) {
+      t.pendingSubmit = ctx_.uploadAsync(
+          texture, {.dimensions = dim, .numMipLevels = t.numLevels - level}, t.data.data() + t.levelOffsets[level], 0, &result);
+    }
+
+    if (result.code == lvk::Result::Code::Pending) {
+      // the staging memory is full - try again during the next update()
+      isStagingFull = true;
+      return false;
+    }
+
+    if (!result.isOk()) {
+      // keep whatever is resident now
+      LLOGW("TextureStreamer: cannot upload %s (%s)\n", t.desc.fileName.c_str(), result.message);
+      t.targetLevel = t.residentLevel;
+      t.isFailed = t.residentLevel == kNotResident;
+      return false;
+    }
+
+    t.pendingTexture = std::move(texture);
+    t.pendingLevel = level;
+
+    return true;
+  }
+
+ private:
+  lvk::IContext& ctx_;
+  Config cfg_;
+  ktx_transcode_fmt_e transcodeFormat_ = KTX_TTF_RGBA32;
+  lvk::Holder<lvk::TextureHandle> placeholder_;
+
+  // accessible only from the thread calling update()
+  std::vector<StreamedTexture> textures_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  uint32_t nextTexture_ = 0;
+
+  std::mutex loadedMutex_;
+  std::vector<LoadedTexture> loaded_;
+  std::atomic<bool> shouldExit_ = false;
+  std::atomic<bool> isOverBudget_ = false;
+
+  tf::Executor executor_; // the last member, so worker threads are done before anything else is destroyed
+};
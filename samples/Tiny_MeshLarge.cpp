@@ -44,9 +44,9 @@
 #include <shared/UtilsFPS.h>
 #include <stb/stb_image.h>
 #include <stb/stb_image_resize2.h>
-#include <taskflow/taskflow.hpp>
 
 #include <implot/implot.h>
+#include <lvk/HelpersCulling.h>
 #include <lvk/HelpersImGui.h>
 #include <lvk/LVK.h>
 
@@ -58,9 +58,18 @@
 #include <GLFW/glfw3.h>
 #endif
 
+#include "Benchmark.h"
 #include "DEMO_002_Bistro.cpp" // temporary
-
-constexpr uint32_t kMeshCacheVersion = 0xC0DE000A;
+#include "MeshCache.h"
+#include "TextureStreamer.h"
+
+constexpr uint32_t kMeshCacheVersion = 0xC0DE000C;
+constexpr bool kMeshCacheCompression = true; // meshopt-encode vertices and indices
+// should match the task and mesh shaders
+constexpr uint32_t kMeshletTaskGroupSize = 32;
+constexpr uint32_t kMaxMeshletVertices = 64;
+constexpr uint32_t kMaxMeshletTriangles = 124;
+constexpr float kMeshletConeWeight = 0.25f;
 #if !defined(__APPLE__)
 constexpr int kNumSamplesMSAA = 8;
 #else
@@ -466,6 +475,190 @@ void main() {
 }
 )";
 
+// meshlets: shared by the task and mesh shaders
+const char* kCodeMeshletCommon = R"(
+struct Material {
+  vec4 ambient;
+  vec4 diffuse;
+  int texAmbient;
+  int texDiffuse;
+  int texAlpha;
+  int padding;
+};
+
+struct Meshlet {
+  vec4 sphere; // xyz - center, w - radius
+  vec4 cone; // xyz - axis, w - cutoff
+  uint vertexOffset;
+  uint triangleOffset;
+  uint vertexCount;
+  uint triangleCount;
+};
+
+layout(std430, buffer_reference) readonly buffer PerFrame {
+  mat4 proj;
+  mat4 view;
+  mat4 light;
+  uint texSkyboxRadiance;
+  uint texSkyboxIrradiance;
+  uint texShadow;
+  uint sampler0;
+  uint samplerShadow0;
+};
+
+layout(std430, buffer_reference) readonly buffer PerObject {
+  mat4 model;
+  mat4 normal;
+};
+
+layout(std430, buffer_reference) readonly buffer Materials {
+  Material mtl[];
+};
+
+layout(std430, buffer_reference) readonly buffer Meshlets {
+  Meshlet meshlets[];
+};
+
+layout(std430, buffer_reference) readonly buffer MeshletVertices {
+  uint vertices[];
+};
+
+layout(std430, buffer_reference) readonly buffer MeshletTriangles {
+  uint triangles[]; // packed 8-bit local indices
+};
+
+layout(std430, buffer_reference) readonly buffer Vertices {
+  uint data[]; // VertexData, 5 uints per vertex
+};
+
+layout(std430, buffer_reference) readonly buffer MeshletCulling {
+  vec4 frustumPlanes[6];
+  vec4 cameraPos;
+  uint numMeshlets;
+  uint isCullingEnabled;
+};
+
+layout(push_constant) uniform constants {
+  PerFrame perFrame;
+  PerObject perObject;
+  Materials materials;
+  Meshlets meshlets;
+  MeshletVertices meshletVertices;
+  MeshletTriangles meshletTriangles;
+  Vertices vertices;
+  MeshletCulling culling;
+} pc;
+
+struct TaskPayload {
+  uint meshlets[32];
+};
+
+taskPayloadSharedEXT TaskPayload payload;
+)";
+
+const char* kCodeMeshletTS = R"(
+layout (local_size_x = 32, local_size_y = 1, local_size_z = 1) in;
+
+shared uint numVisibleMeshlets;
+
+bool isMeshletVisible(uint idx) {
+  const Meshlet m = pc.meshlets.meshlets[idx];
+  const mat4 model = pc.perObject.model;
+  const vec3 center = (model * vec4(m.sphere.xyz, 1.0)).xyz;
+  const float radius = m.sphere.w * max(max(length(model[0].xyz), length(model[1].xyz)), length(model[2].xyz));
+
+  for (uint i = 0; i != 6; i++) {
+    if (dot(pc.culling.frustumPlanes[i].xyz, center) + pc.culling.frustumPlanes[i].w < -radius) {
+      return false;
+    }
+  }
+
+  // https://github.com/zeux/meshoptimizer#clusterization
+  const vec3 axis = normalize(mat3(model) * m.cone.xyz);
+  const vec3 v = center - pc.culling.cameraPos.xyz;
+
+  return dot(v, axis) < m.cone.w * length(v) + radius;
+}
+
+void main() {
+  const uint idx = gl_GlobalInvocationID.x;
+
+  if (gl_LocalInvocationIndex == 0) {
+    numVisibleMeshlets = 0;
+  }
+
+  barrier();
+
+  if (idx < pc.culling.numMeshlets && (pc.culling.isCullingEnabled == 0 || isMeshletVisible(idx))) {
+    payload.meshlets[atomicAdd(numVisibleMeshlets, 1)] = idx;
+  }
+
+  barrier();
+
+  EmitMeshTasksEXT(numVisibleMeshlets, 1, 1);
+}
+)";
+
+const char* kCodeMeshletMS = R"(
+layout (local_size_x = 32, local_size_y = 1, local_size_z = 1) in;
+layout (triangles, max_vertices = 64, max_primitives = 124) out;
+
+// output
+struct PerVertex {
+  vec3 normal;
+  vec2 uv;
+  vec4 shadowCoords;
+};
+layout (location=0) out PerVertex vtx[];
+layout (location=5) flat out Material mtl[];
+//
+
+// https://www.shadertoy.com/view/llfcRl
+vec2 unpackSnorm2x8(uint d) {
+  return vec2(uvec2(d, d >> 8) & 255u) / 127.5 - 1.0;
+}
+vec3 unpackOctahedral16(uint data) {
+  vec2 v = unpackSnorm2x8(data);
+  // https://x.com/Stubbesaurus/status/937994790553227264
+  vec3 n = vec3(v, 1.0 - abs(v.x) - abs(v.y));
+  float t = max(-n.z, 0.0);
+  n.x += (n.x > 0.0) ? -t : t;
+  n.y += (n.y > 0.0) ? -t : t;
+  return normalize(n);
+}
+//
+
+uint getLocalIndex(uint offset) {
+  return (pc.meshletTriangles.triangles[offset >> 2] >> ((offset & 3) * 8)) & 255u;
+}
+
+void main() {
+  const Meshlet m = pc.meshlets.meshlets[payload.meshlets[gl_WorkGroupID.x]];
+
+  SetMeshOutputsEXT(m.vertexCount, m.triangleCount);
+
+  const mat4 model = pc.perObject.model;
+  const mat4 mvp = pc.perFrame.proj * pc.perFrame.view * model;
+  const mat4 light = pc.perFrame.light * model;
+
+  for (uint i = gl_LocalInvocationIndex; i < m.vertexCount; i += 32) {
+    const uint base = 5 * pc.meshletVertices.vertices[m.vertexOffset + i];
+    const vec3 pos = uintBitsToFloat(uvec3(pc.vertices.data[base + 0], pc.vertices.data[base + 1], pc.vertices.data[base + 2]));
+    const uint normalAndMtl = pc.vertices.data[base + 4];
+    gl_MeshVerticesEXT[i].gl_Position = mvp * vec4(pos, 1.0);
+    vtx[i].normal = normalize(mat3(pc.perObject.normal) * unpackOctahedral16(normalAndMtl & 0xffffu));
+    vtx[i].uv = unpackHalf2x16(pc.vertices.data[base + 3]);
+    vtx[i].shadowCoords = light * vec4(pos, 1.0);
+    mtl[i] = pc.materials.mtl[normalAndMtl >> 16];
+  }
+
+  for (uint i = gl_LocalInvocationIndex; i < m.triangleCount; i += 32) {
+    const uint offset = m.triangleOffset + 3 * i;
+    gl_PrimitiveTriangleIndicesEXT[i] = uvec3(getLocalIndex(offset + 0), getLocalIndex(offset + 1), getLocalIndex(offset + 2));
+  }
+}
+)";
+
 using glm::mat4;
 using glm::vec2;
 using glm::vec3;
@@ -481,6 +674,7 @@ lvk::Framebuffer fbOffscreen_;
 lvk::Holder<lvk::TextureHandle> fbOffscreenColor_;
 lvk::Holder<lvk::TextureHandle> fbOffscreenDepth_;
 lvk::Holder<lvk::TextureHandle> fbOffscreenResolve_;
+lvk::Framebuffer fbDepthPrepass_; // single-sampled depth of the meshlets drawn by the GPU culler, the source of its Hi-Z pyramid
 lvk::Framebuffer fbShadowMap_;
 lvk::Holder<lvk::ShaderModuleHandle> smMeshVert_;
 lvk::Holder<lvk::ShaderModuleHandle> smMeshFrag_;
@@ -493,15 +687,28 @@ lvk::Holder<lvk::ShaderModuleHandle> smFullscreenFrag_;
 lvk::Holder<lvk::ShaderModuleHandle> smSkyboxVert_;
 lvk::Holder<lvk::ShaderModuleHandle> smSkyboxFrag_;
 lvk::Holder<lvk::ShaderModuleHandle> smGrayscaleComp_;
+lvk::Holder<lvk::ShaderModuleHandle> smMeshletTask_;
+lvk::Holder<lvk::ShaderModuleHandle> smMeshletMesh_;
+lvk::Holder<lvk::ShaderModuleHandle> smMeshletFrag_;
 lvk::Holder<lvk::ComputePipelineHandle> computePipelineState_Grayscale_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Mesh_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_MeshNormals_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_MeshWireframe_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Shadow_;
+lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_DepthPrepass_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Skybox_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Fullscreen_;
+lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Meshlets_;
+lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_MeshletsNormals_;
 lvk::Holder<lvk::BufferHandle> vb0_, ib0_; // buffers for vertices and indices
 lvk::Holder<lvk::BufferHandle> sbMaterials_; // storage buffer for materials
+// meshlets: task and mesh shaders
+lvk::Holder<lvk::BufferHandle> sbMeshlets_, sbMeshletVertices_, sbMeshletTriangles_;
+lvk::Holder<lvk::BufferHandle> ubMeshletCulling_;
+// meshlets: indirect draws generated by the GPU culler (the only option when VK_EXT_mesh_shader is not available)
+lvk::Holder<lvk::BufferHandle> ibMeshlets_; // meshlet triangles expanded into the global index space
+lvk::Holder<lvk::BufferHandle> sbCullingMeshes_, sbCullingInstances_;
+std::unique_ptr<lvk::GpuCuller> culler_;
 lvk::Holder<lvk::BufferHandle> ubPerFrame_, ubPerFrameShadow_, ubPerObject_;
 lvk::Holder<lvk::SamplerHandle> sampler_;
 lvk::Holder<lvk::SamplerHandle> samplerShadow_;
@@ -523,9 +730,14 @@ bool enableComputePass_ = false;
 bool enableWireframe_ = false;
 bool showPerfStats_ = false;
 bool drawNormals_ = false;
+bool enableMeshlets_ = false;
+bool hasMeshShaders_ = false;
+bool useGpuCuller_ = false;
 
 bool isShadowMapDirty_ = true;
 
+const mat4 modelMatrix_ = glm::scale(mat4(1.0f), vec3(0.05f));
+
 struct VertexData {
   vec3 position;
   uint32_t uv; // hvec2
@@ -551,8 +763,40 @@ uint16_t packOctahedral16(vec3 n) {
   return ::packSnorm2x8((n.z >= 0.0) ? vec2(n.x, n.y) : (vec2(1.0) - abs(vec2(n.y, n.x))) * msign(vec2(n)));
 }
 
-std::vector<VertexData> vertexData_;
-std::vector<uint32_t> indexData_;
+enum MeshCacheChunkId : uint32_t {
+  MeshCacheChunk_Materials = 0, // CachedMaterial
+  MeshCacheChunk_Vertices, // VertexData
+  MeshCacheChunk_Indices, // uint32_t
+  MeshCacheChunk_Meshlets, // GPUMeshlet
+  MeshCacheChunk_MeshletVertices, // uint32_t, indices into MeshCacheChunk_Vertices
+  MeshCacheChunk_MeshletTriangles, // uint8_t, local indices into MeshCacheChunk_MeshletVertices, every meshlet is padded to 4 bytes
+};
+
+MeshCache meshCache_; // memory-mapped, see loadFromCache()
+uint32_t numVertices_ = 0;
+uint32_t numIndices_ = 0;
+uint32_t numMeshlets_ = 0;
+
+// this goes into our task and mesh shaders
+struct GPUMeshlet {
+  vec4 sphere; // xyz - center, w - radius
+  vec4 cone; // xyz - axis, w - cutoff
+  uint32_t vertexOffset = 0; // into MeshCacheChunk_MeshletVertices
+  uint32_t triangleOffset = 0; // into MeshCacheChunk_MeshletTriangles
+  uint32_t vertexCount = 0;
+  uint32_t triangleCount = 0;
+};
+
+static_assert(sizeof(GPUMeshlet) == 48);
+
+
+struct UniformsMeshletCulling {
+  vec4 frustumPlanes[6];
+  vec4 cameraPos;
+  uint32_t numMeshlets = 0;
+  uint32_t isCullingEnabled = 1;
+  uint32_t padding[2] = {};
+};
 
 struct UniformsPerFrame {
   mat4 proj;
@@ -595,39 +839,17 @@ static_assert(sizeof(GPUMaterial) % 16 == 0);
 std::vector<CachedMaterial> cachedMaterials_;
 std::vector<GPUMaterial> materials_;
 
+// TextureStreamer ids
 struct MaterialTextures {
-  lvk::TextureHandle ambient;
-  lvk::TextureHandle diffuse;
-  lvk::TextureHandle alpha;
+  uint32_t ambient = kInvalidStreamedTexture;
+  uint32_t diffuse = kInvalidStreamedTexture;
+  uint32_t alpha = kInvalidStreamedTexture;
 };
 
 std::vector<MaterialTextures> textures_; // same indexing as in materials_
 
-struct LoadedImage {
-  uint32_t w = 0;
-  uint32_t h = 0;
-  uint32_t channels = 0;
-  uint8_t* pixels = nullptr;
-  std::string debugName;
-  std::string compressedFileName;
-};
-
-struct LoadedMaterial {
-  size_t idx = 0;
-  LoadedImage ambient;
-  LoadedImage diffuse;
-  LoadedImage alpha;
-};
-
-// file name -> LoadedImage
-std::mutex imagesCacheMutex_;
-std::unordered_map<std::string, LoadedImage> imagesCache_; // accessible only from the loader pool (multiple threads)
-std::unordered_map<std::string, lvk::Holder<lvk::TextureHandle>> texturesCache_; // accessible the main thread
-std::vector<LoadedMaterial> loadedMaterials_;
-std::mutex loadedMaterialsMutex_;
+std::unique_ptr<TextureStreamer> textureStreamer_;
 std::atomic<bool> loaderShouldExit_ = false;
-std::atomic<uint32_t> remainingMaterialsToLoad_ = 0;
-std::unique_ptr<tf::Executor> loaderPool_ = std::make_unique<tf::Executor>(std::max(2u, std::thread::hardware_concurrency() / 2));
 
 static bool endsWith(const std::string& str, const std::string& suffix) {
   return str.size() >= suffix.size() && 0 == str.compare(str.size() - suffix.size(), suffix.size(), suffix);
@@ -648,7 +870,7 @@ static std::string convertFileName(std::string fileName) {
   std::replace(fileName.begin(), fileName.end(), '\\', '_');
 
   // return absolute compressed filename
-  return compressedPathPrefix + fileName + ".ktx";
+  return compressedPathPrefix + fileName + ".ktx2";
 }
 static void stringReplaceAll(std::string& s, const std::string& searchString, const std::string& replaceString) {
   size_t pos = 0;
@@ -665,6 +887,9 @@ void createShadowMap();
 void createOffscreenFramebuffer();
 
 bool init(lvk::LVKwindow* window) {
+  hasMeshShaders_ = ctx_->isExtensionEnabled("VK_EXT_mesh_shader");
+  useGpuCuller_ = !hasMeshShaders_;
+
   {
     const uint32_t pixel = 0xFFFFFFFF;
     textureDummyWhite_ = ctx_->createTexture(
@@ -698,6 +923,12 @@ bool init(lvk::LVKwindow* window) {
       .size = sizeof(UniformsPerObject),
       .debugName = "Buffer: uniforms (per object)",
   });
+  ubMeshletCulling_ = ctx_->createBuffer({
+      .usage = lvk::BufferUsageBits_Uniform,
+      .storage = lvk::StorageType_HostVisible,
+      .size = sizeof(UniformsMeshletCulling),
+      .debugName = "Buffer: uniforms (meshlet culling)",
+  });
 
   depthState_ = {.compareOp = lvk::CompareOp_Less, .isDepthWriteEnabled = true};
   depthStateLEqual_ = {.compareOp = lvk::CompareOp_LessEqual, .isDepthWriteEnabled = true};
@@ -767,6 +998,14 @@ void destroy() {
   ubPerFrame_ = nullptr;
   ubPerFrameShadow_ = nullptr;
   ubPerObject_ = nullptr;
+  sbMeshlets_ = nullptr;
+  sbMeshletVertices_ = nullptr;
+  sbMeshletTriangles_ = nullptr;
+  ubMeshletCulling_ = nullptr;
+  ibMeshlets_ = nullptr;
+  sbCullingMeshes_ = nullptr;
+  sbCullingInstances_ = nullptr;
+  culler_ = nullptr;
   smMeshVert_ = nullptr;
   smMeshFrag_ = nullptr;
   smMeshWireframeVert_ = nullptr;
@@ -778,31 +1017,35 @@ void destroy() {
   smSkyboxVert_ = nullptr;
   smSkyboxFrag_ = nullptr;
   smGrayscaleComp_ = nullptr;
+  smMeshletTask_ = nullptr;
+  smMeshletMesh_ = nullptr;
+  smMeshletFrag_ = nullptr;
   renderPipelineState_Mesh_ = nullptr;
   renderPipelineState_MeshNormals_ = nullptr;
   renderPipelineState_MeshWireframe_ = nullptr;
   renderPipelineState_Shadow_ = nullptr;
+  renderPipelineState_DepthPrepass_ = nullptr;
   renderPipelineState_Skybox_ = nullptr;
   renderPipelineState_Fullscreen_ = nullptr;
+  renderPipelineState_Meshlets_ = nullptr;
+  renderPipelineState_MeshletsNormals_ = nullptr;
   computePipelineState_Grayscale_ = nullptr;
   textureDummyWhite_ = nullptr;
   skyboxTextureReference_ = nullptr;
   skyboxTextureIrradiance_ = nullptr;
   textures_.clear();
-  texturesCache_.clear();
+  printf("Waiting for the texture streamer to exit...\n");
+  textureStreamer_ = nullptr;
   sampler_ = nullptr;
   samplerShadow_ = nullptr;
   ctx_->destroy(fbMain_);
   ctx_->destroy(fbShadowMap_);
+  ctx_->destroy(fbDepthPrepass_);
   fbOffscreenColor_ = nullptr;
   fbOffscreenDepth_ = nullptr;
   fbOffscreenResolve_ = nullptr;
   queryPoolTimestamps_ = nullptr;
   ctx_ = nullptr;
-
-  printf("Waiting for the loader thread to exit...\n");
-
-  loaderPool_ = nullptr;
 }
 
 std::string normalizeTextureName(const char* n) {
@@ -816,6 +1059,8 @@ std::string normalizeTextureName(const char* n) {
   return name;
 }
 
+bool loadFromCache(const char* cacheFileName);
+
 bool loadAndCache(const char* cacheFileName) {
   LVK_PROFILER_FUNCTION();
 
@@ -838,7 +1083,10 @@ bool loadAndCache(const char* cacheFileName) {
   for (uint32_t i = 0; i < mesh->face_count; ++i)
     vertexCount += mesh->face_vertices[i];
 
-  vertexData_.reserve(vertexCount);
+  std::vector<VertexData> vertexData;
+  std::vector<uint32_t> indexData;
+
+  vertexData.reserve(vertexCount);
 
   uint32_t vertexIndex = 0;
 
@@ -851,7 +1099,7 @@ bool loadAndCache(const char* cacheFileName) {
       const float* n = &mesh->normals[gi.n * 3];
       const float* t = &mesh->texcoords[gi.t * 2];
 
-      vertexData_.push_back({
+      vertexData.push_back({
           .position = vec3(p[0], p[1], p[2]),
           .uv = glm::packHalf2x16(vec2(t[0], t[1])),
           .normal = packOctahedral16(vec3(n[0], n[1], n[2])),
@@ -863,25 +1111,71 @@ bool loadAndCache(const char* cacheFileName) {
   // repack the mesh as described in https://github.com/zeux/meshoptimizer
   {
     // 1. Generate an index buffer
-    const size_t indexCount = vertexData_.size();
+    const size_t indexCount = vertexData.size();
     std::vector<uint32_t> remap(indexCount);
     const size_t vertexCount =
-        meshopt_generateVertexRemap(remap.data(), nullptr, indexCount, vertexData_.data(), indexCount, sizeof(VertexData));
+        meshopt_generateVertexRemap(remap.data(), nullptr, indexCount, vertexData.data(), indexCount, sizeof(VertexData));
     // 2. Remap vertices
     std::vector<VertexData> remappedVertices;
-    indexData_.resize(indexCount);
+    indexData.resize(indexCount);
     remappedVertices.resize(vertexCount);
-    meshopt_remapIndexBuffer(indexData_.data(), nullptr, indexCount, &remap[0]);
-    meshopt_remapVertexBuffer(remappedVertices.data(), vertexData_.data(), indexCount, sizeof(VertexData), remap.data());
-    vertexData_ = remappedVertices;
+    meshopt_remapIndexBuffer(indexData.data(), nullptr, indexCount, &remap[0]);
+    meshopt_remapVertexBuffer(remappedVertices.data(), vertexData.data(), indexCount, sizeof(VertexData), remap.data());
+    vertexData = remappedVertices;
     // 3. Optimize for the GPU vertex cache reuse and overdraw
-    meshopt_optimizeVertexCache(indexData_.data(), indexData_.data(), indexCount, vertexCount);
+    meshopt_optimizeVertexCache(indexData.data(), indexData.data(), indexCount, vertexCount);
     meshopt_optimizeOverdraw(
-        indexData_.data(), indexData_.data(), indexCount, &vertexData_[0].position.x, vertexCount, sizeof(VertexData), 1.05f);
-    meshopt_optimizeVertexFetch(vertexData_.data(), indexData_.data(), indexCount, vertexData_.data(), vertexCount, sizeof(VertexData));
+        indexData.data(), indexData.data(), indexCount, &vertexData[0].position.x, vertexCount, sizeof(VertexData), 1.05f);
+    meshopt_optimizeVertexFetch(vertexData.data(), indexData.data(), indexCount, vertexData.data(), vertexCount, sizeof(VertexData));
+  }
+
+  // split the mesh into meshlets and compute their culling data
+  std::vector<GPUMeshlet> meshletsGPU;
+  std::vector<uint32_t> meshletVertices;
+  std::vector<uint8_t> meshletTriangles;
+  {
+    const size_t maxMeshlets = meshopt_buildMeshletsBound(indexData.size(), kMaxMeshletVertices, kMaxMeshletTriangles);
+    std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+    meshletVertices.resize(maxMeshlets * kMaxMeshletVertices);
+    meshletTriangles.resize(maxMeshlets * kMaxMeshletTriangles * 3);
+    const size_t numMeshlets = meshopt_buildMeshlets(meshlets.data(),
+                                                     meshletVertices.data(),
+                                                     meshletTriangles.data(),
+                                                     indexData.data(),
+                                                     indexData.size(),
+                                                     &vertexData[0].position.x,
+                                                     vertexData.size(),
+                                                     sizeof(VertexData),
+                                                     kMaxMeshletVertices,
+                                                     kMaxMeshletTriangles,
+                                                     kMeshletConeWeight);
+    LVK_ASSERT(numMeshlets);
+    const meshopt_Meshlet& last = meshlets[numMeshlets - 1];
+    meshletVertices.resize(last.vertex_offset + last.vertex_count);
+    meshletTriangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
+    meshletsGPU.reserve(numMeshlets);
+    for (size_t i = 0; i != numMeshlets; i++) {
+      const meshopt_Meshlet& m = meshlets[i];
+      const meshopt_Bounds b = meshopt_computeMeshletBounds(&meshletVertices[m.vertex_offset],
+                                                            &meshletTriangles[m.triangle_offset],
+                                                            m.triangle_count,
+                                                            &vertexData[0].position.x,
+                                                            vertexData.size(),
+                                                            sizeof(VertexData));
+      meshletsGPU.push_back({
+          .sphere = vec4(b.center[0], b.center[1], b.center[2], b.radius),
+          .cone = vec4(b.cone_axis[0], b.cone_axis[1], b.cone_axis[2], b.cone_cutoff),
+          .vertexOffset = m.vertex_offset,
+          .triangleOffset = m.triangle_offset,
+          .vertexCount = m.vertex_count,
+          .triangleCount = m.triangle_count,
+      });
+    }
   }
 
   // loop over materials
+  std::vector<CachedMaterial> cachedMaterials;
+
   for (uint32_t mtlIdx = 0; mtlIdx != mesh->material_count; mtlIdx++) {
     const fastObjMaterial& m = mesh->materials[mtlIdx];
     CachedMaterial mtl;
@@ -892,62 +1186,65 @@ bool loadAndCache(const char* cacheFileName) {
     strcat(mtl.ambient_texname, normalizeTextureName(mesh->textures[m.map_Ka].name).c_str());
     strcat(mtl.diffuse_texname, normalizeTextureName(mesh->textures[m.map_Kd].name).c_str());
     strcat(mtl.alpha_texname, normalizeTextureName(mesh->textures[m.map_d].name).c_str());
-    cachedMaterials_.push_back(mtl);
+    cachedMaterials.push_back(mtl);
   }
 
   LLOGL("Caching mesh...\n");
 
-  FILE* cacheFile = fopen(cacheFileName, "wb");
-  if (!cacheFile) {
+  MeshCacheWriter writer;
+  writer.addChunk(MeshCacheChunk_Materials, cachedMaterials.data(), (uint32_t)cachedMaterials.size(), sizeof(CachedMaterial));
+  writer.addChunk(MeshCacheChunk_Vertices,
+                  vertexData.data(),
+                  (uint32_t)vertexData.size(),
+                  sizeof(VertexData),
+                  kMeshCacheCompression ? MeshCacheEncoding_MeshoptVertex : MeshCacheEncoding_Raw);
+  writer.addChunk(MeshCacheChunk_Indices,
+                  indexData.data(),
+                  (uint32_t)indexData.size(),
+                  sizeof(uint32_t),
+                  kMeshCacheCompression ? MeshCacheEncoding_MeshoptIndex : MeshCacheEncoding_Raw);
+  // meshlets are read in-place on the CPU by the indirect fallback, so they are never compressed
+  writer.addChunk(MeshCacheChunk_Meshlets, meshletsGPU.data(), (uint32_t)meshletsGPU.size(), sizeof(GPUMeshlet));
+  writer.addChunk(MeshCacheChunk_MeshletVertices, meshletVertices.data(), (uint32_t)meshletVertices.size(), sizeof(uint32_t));
+  writer.addChunk(MeshCacheChunk_MeshletTriangles, meshletTriangles.data(), (uint32_t)meshletTriangles.size(), sizeof(uint8_t));
+
+  if (!writer.write(cacheFileName, kMeshCacheVersion)) {
     return false;
   }
-  const uint32_t numMaterials = (uint32_t)cachedMaterials_.size();
-  const uint32_t numVertices = (uint32_t)vertexData_.size();
-  const uint32_t numIndices = (uint32_t)indexData_.size();
-  fwrite(&kMeshCacheVersion, sizeof(kMeshCacheVersion), 1, cacheFile);
-  fwrite(&numMaterials, sizeof(numMaterials), 1, cacheFile);
-  fwrite(&numVertices, sizeof(numVertices), 1, cacheFile);
-  fwrite(&numIndices, sizeof(numIndices), 1, cacheFile);
-  fwrite(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile);
-  fwrite(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile);
-  fwrite(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile);
-  return fclose(cacheFile) == 0;
+
+  // free the intermediate data before mapping the cache back
+  vertexData = {};
+  indexData = {};
+
+  return loadFromCache(cacheFileName);
 }
 
 bool loadFromCache(const char* cacheFileName) {
-  FILE* cacheFile = fopen(cacheFileName, "rb");
-  SCOPE_EXIT {
-    if (cacheFile) {
-      fclose(cacheFile);
-    }
-  };
-  if (!cacheFile) {
+  LVK_PROFILER_FUNCTION();
+
+  if (!meshCache_.open(cacheFileName, kMeshCacheVersion)) {
     return false;
   }
-#define CHECK_READ(expected, read) \
-  if ((read) != (expected)) {      \
-    return false;                  \
-  }
-  uint32_t versionProbe = 0;
-  CHECK_READ(1, fread(&versionProbe, sizeof(versionProbe), 1, cacheFile));
-  if (versionProbe != kMeshCacheVersion) {
-    LLOGL("Cache file has wrong version id\n");
+
+  const MeshCacheChunk* materials = meshCache_.findChunk(MeshCacheChunk_Materials);
+  const MeshCacheChunk* vertices = meshCache_.findChunk(MeshCacheChunk_Vertices);
+  const MeshCacheChunk* indices = meshCache_.findChunk(MeshCacheChunk_Indices);
+
+  if (!materials || materials->elementSize != sizeof(CachedMaterial) || !vertices || vertices->elementSize != sizeof(VertexData) ||
+      !indices || indices->elementSize != sizeof(uint32_t) || !meshCache_.getData<GPUMeshlet>(MeshCacheChunk_Meshlets) ||
+      !meshCache_.getData<uint32_t>(MeshCacheChunk_MeshletVertices) || !meshCache_.getData<uint8_t>(MeshCacheChunk_MeshletTriangles)) {
+    LLOGL("Cache file has wrong layout\n");
+    meshCache_.close();
     return false;
   }
-  uint32_t numMaterials = 0;
-  uint32_t numVertices = 0;
-  uint32_t numIndices = 0;
-  CHECK_READ(1, fread(&numMaterials, sizeof(numMaterials), 1, cacheFile));
-  CHECK_READ(1, fread(&numVertices, sizeof(numVertices), 1, cacheFile));
-  CHECK_READ(1, fread(&numIndices, sizeof(numIndices), 1, cacheFile));
-  cachedMaterials_.resize(numMaterials);
-  vertexData_.resize(numVertices);
-  indexData_.resize(numIndices);
-  CHECK_READ(numMaterials, fread(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile));
-  CHECK_READ(numVertices, fread(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile));
-  CHECK_READ(numIndices, fread(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile));
-#undef CHECK_READ
-  return true;
+
+  // materials are small and are needed on the CPU; everything else stays in the mapped file until uploaded
+  cachedMaterials_.resize(materials->numElements);
+  numVertices_ = vertices->numElements;
+  numIndices_ = indices->numElements;
+  numMeshlets_ = meshCache_.getNumElements(MeshCacheChunk_Meshlets);
+
+  return meshCache_.read(MeshCacheChunk_Materials, cachedMaterials_.data());
 }
 
 bool initModel() {
@@ -972,18 +1269,96 @@ bool initModel() {
                                      .debugName = "Buffer: materials"},
                                     nullptr);
 
-  vb0_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Vertex,
+  vb0_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Vertex | lvk::BufferUsageBits_Storage,
                              .storage = lvk::StorageType_Device,
-                             .size = sizeof(VertexData) * vertexData_.size(),
-                             .data = vertexData_.data(),
+                             .size = sizeof(VertexData) * numVertices_,
                              .debugName = "Buffer: vertex"},
                             nullptr);
   ib0_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Index,
                              .storage = lvk::StorageType_Device,
-                             .size = sizeof(uint32_t) * indexData_.size(),
-                             .data = indexData_.data(),
+                             .size = sizeof(uint32_t) * numIndices_,
                              .debugName = "Buffer: index"},
                             nullptr);
+
+  // stream vertices and indices straight from the memory-mapped cache, decoding them page by page
+  if (!LVK_VERIFY(meshCache_.upload(*ctx_, vb0_, MeshCacheChunk_Vertices)) ||
+      !LVK_VERIFY(meshCache_.upload(*ctx_, ib0_, MeshCacheChunk_Indices))) {
+    return false;
+  }
+
+  const GPUMeshlet* meshlets = meshCache_.getData<GPUMeshlet>(MeshCacheChunk_Meshlets);
+  const uint32_t* meshletVertices = meshCache_.getData<uint32_t>(MeshCacheChunk_MeshletVertices);
+  const uint8_t* meshletTriangles = meshCache_.getData<uint8_t>(MeshCacheChunk_MeshletTriangles);
+
+  if (hasMeshShaders_) {
+    sbMeshlets_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Storage,
+                                      .storage = lvk::StorageType_Device,
+                                      .size = sizeof(GPUMeshlet) * numMeshlets_,
+                                      .data = meshlets,
+                                      .debugName = "Buffer: meshlets"},
+                                     nullptr);
+    sbMeshletVertices_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Storage,
+                                             .storage = lvk::StorageType_Device,
+                                             .size = sizeof(uint32_t) * meshCache_.getNumElements(MeshCacheChunk_MeshletVertices),
+                                             .data = meshletVertices,
+                                             .debugName = "Buffer: meshlet vertices"},
+                                            nullptr);
+    sbMeshletTriangles_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Storage,
+                                              .storage = lvk::StorageType_Device,
+                                              .size = meshCache_.getNumElements(MeshCacheChunk_MeshletTriangles),
+                                              .data = meshletTriangles,
+                                              .debugName = "Buffer: meshlet triangles"},
+                                             nullptr);
+  }
+
+  // every meshlet becomes a separate indexed draw generated by the GPU culler
+  {
+    std::vector<uint32_t> indices;
+    std::vector<lvk::CullingMesh> meshes;
+    std::vector<lvk::CullingInstance> instances;
+    indices.reserve(numIndices_);
+    meshes.reserve(numMeshlets_);
+    instances.reserve(numMeshlets_);
+    for (uint32_t idx = 0; idx != numMeshlets_; idx++) {
+      const GPUMeshlet& m = meshlets[idx];
+      lvk::CullingMesh mesh = {
+          .indexCount = 3 * m.triangleCount,
+          .firstIndex = (uint32_t)indices.size(),
+      };
+      memcpy(mesh.boundingSphere, glm::value_ptr(m.sphere), sizeof(mesh.boundingSphere));
+      for (uint32_t i = 0; i != mesh.indexCount; i++) {
+        indices.push_back(meshletVertices[m.vertexOffset + meshletTriangles[m.triangleOffset + i]]);
+      }
+      lvk::CullingInstance instance = {.meshIndex = (uint32_t)meshes.size()};
+      memcpy(instance.model, glm::value_ptr(modelMatrix_), sizeof(instance.model));
+      meshes.push_back(mesh);
+      instances.push_back(instance);
+    }
+
+    ibMeshlets_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Index,
+                                      .storage = lvk::StorageType_Device,
+                                      .size = sizeof(uint32_t) * indices.size(),
+                                      .data = indices.data(),
+                                      .debugName = "Buffer: meshlet indices"},
+                                     nullptr);
+    sbCullingMeshes_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Storage,
+                                           .storage = lvk::StorageType_Device,
+                                           .size = sizeof(lvk::CullingMesh) * meshes.size(),
+                                           .data = meshes.data(),
+                                           .debugName = "Buffer: culling meshes"},
+                                          nullptr);
+    sbCullingInstances_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Storage,
+                                              .storage = lvk::StorageType_Device,
+                                              .size = sizeof(lvk::CullingInstance) * instances.size(),
+                                              .data = instances.data(),
+                                              .debugName = "Buffer: culling instances"},
+                                             nullptr);
+    culler_ = std::make_unique<lvk::GpuCuller>(*ctx_, numMeshlets_);
+  }
+
+  // everything is on the GPU now
+  meshCache_.close();
+
   return true;
 }
 
@@ -1062,6 +1437,35 @@ void createPipelines() {
     renderPipelineState_MeshWireframe_ = ctx_->createRenderPipeline(desc, nullptr);
   }
 
+  // meshlets: always GLSL, so the fragment shader inputs match the mesh shader outputs
+  if (hasMeshShaders_) {
+    const std::string codeTask = std::string(kCodeMeshletCommon) + kCodeMeshletTS;
+    const std::string codeMesh = std::string(kCodeMeshletCommon) + kCodeMeshletMS;
+    smMeshletTask_ = ctx_->createShaderModule({codeTask.c_str(), lvk::Stage_Task, "Shader Module: meshlets (task)"});
+    smMeshletMesh_ = ctx_->createShaderModule({codeMesh.c_str(), lvk::Stage_Mesh, "Shader Module: meshlets (mesh)"});
+    smMeshletFrag_ = ctx_->createShaderModule({kCodeFS, lvk::Stage_Frag, "Shader Module: meshlets (frag)"});
+
+    lvk::RenderPipelineDesc desc = {
+        .smTask = smMeshletTask_,
+        .smMesh = smMeshletMesh_,
+        .smFrag = smMeshletFrag_,
+        .color = {{.format = ctx_->getFormat(fbOffscreen_.color[0].texture)}},
+        .depthFormat = ctx_->getFormat(fbOffscreen_.depthStencil.texture),
+        .cullMode = lvk::CullMode_Back,
+        .frontFace = lvk::WindingMode_CCW,
+        .samplesCount = kNumSamplesMSAA,
+        .debugName = "Pipeline: meshlets",
+    };
+
+    renderPipelineState_Meshlets_ = ctx_->createRenderPipeline(desc, nullptr);
+
+    const uint32_t drawNormals = 1;
+
+    desc.specInfo = {.entries = {{.constantId = 0, .size = sizeof(uint32_t)}}, .data = &drawNormals, .dataSize = sizeof(drawNormals)};
+
+    renderPipelineState_MeshletsNormals_ = ctx_->createRenderPipeline(desc, nullptr);
+  }
+
   // shadow
   renderPipelineState_Shadow_ = ctx_->createRenderPipeline(
       lvk::RenderPipelineDesc{
@@ -1074,6 +1478,19 @@ void createPipelines() {
       },
       nullptr);
 
+  // depth prepass: the shadow shaders transform by `perFrame.proj * perFrame.view`
+  renderPipelineState_DepthPrepass_ = ctx_->createRenderPipeline(
+      lvk::RenderPipelineDesc{
+          .vertexInput = vdescs,
+          .smVert = smShadowVert_,
+          .smFrag = smShadowFrag_,
+          .depthFormat = ctx_->getFormat(fbDepthPrepass_.depthStencil.texture),
+          .cullMode = lvk::CullMode_Back,
+          .frontFace = lvk::WindingMode_CCW,
+          .debugName = "Pipeline: depth prepass",
+      },
+      nullptr);
+
   // fullscreen
   {
     const lvk::RenderPipelineDesc desc = {
@@ -1181,6 +1598,19 @@ void createOffscreenFramebuffer() {
   }
 
   fbOffscreen_ = fb;
+
+  // the Hi-Z pyramid needs a single-sampled depth buffer
+  const lvk::TextureDesc descDepthPrepass = {
+      .type = lvk::TextureType_2D,
+      .format = lvk::Format_Z_UN24,
+      .dimensions = {w, h},
+      .usage = lvk::TextureUsageBits_Attachment | lvk::TextureUsageBits_Sampled,
+      .debugName = "Depth prepass",
+  };
+  ctx_->destroy(fbDepthPrepass_);
+  fbDepthPrepass_ = {
+      .depthStencil = {.texture = ctx_->createTexture(descDepthPrepass).release()},
+  };
 }
 
 void resize() {
@@ -1193,7 +1623,21 @@ void resize() {
 
 void showTimeGPU();
 double getCurrentTimestamp();
-void processLoadedMaterials(lvk::ICommandBuffer& buffer);
+void updateMaterials(lvk::ICommandBuffer& buffer);
+
+// Gribb-Hartmann, expects the Vulkan clip space with depth in [0..1]
+void getFrustumPlanes(const mat4& viewProj, vec4 planes[6]) {
+  const mat4 m = glm::transpose(viewProj);
+  planes[0] = m[3] + m[0]; // left
+  planes[1] = m[3] - m[0]; // right
+  planes[2] = m[3] + m[1]; // bottom
+  planes[3] = m[3] - m[1]; // top
+  planes[4] = m[2]; // near
+  planes[5] = m[3] - m[2]; // far
+  for (int i = 0; i != 6; i++) {
+    planes[i] /= glm::length(vec3(planes[i]));
+  }
+}
 
 void render(double delta) {
   LVK_PROFILER_FUNCTION();
@@ -1216,19 +1660,23 @@ void render(double delta) {
     ImGui::Text("C - toggle compute shader postprocessing");
     ImGui::Text("N - toggle normals");
     ImGui::Text("T - toggle wireframe");
+    ImGui::Text("M - toggle meshlets (%u, %s)", numMeshlets_, useGpuCuller_ ? "GPU culler" : "mesh shaders");
+    if (hasMeshShaders_) {
+      ImGui::Text("G - toggle GPU culler");
+    }
     ImGui::Text("P - show perf stats");
     ImGui::End();
 
-    if (!textures_[1].diffuse.empty()) {
+    if (textures_.size() > 1 && textureStreamer_->isResident(textures_[1].diffuse)) {
       ImGui::Begin("Texture Viewer", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoNavInputs);
-      ImGui::Image(textures_[1].diffuse.index(), ImVec2(256, 256));
+      ImGui::Image(textureStreamer_->getTextureIndex(textures_[1].diffuse), ImVec2(256, 256));
       ImGui::End();
     }
 
-    if (uint32_t num = remainingMaterialsToLoad_.load(std::memory_order_acquire)) {
+    if (uint32_t num = textureStreamer_->getNumLoading()) {
       ImGui::SetNextWindowPos(ImVec2(0, 0));
       ImGui::Begin("Loading...", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoNavInputs);
-      ImGui::ProgressBar(1.0f - float(num) / cachedMaterials_.size(), ImVec2(ImGui::GetIO().DisplaySize.x, 32));
+      ImGui::ProgressBar(1.0f - float(num) / textureStreamer_->getNumTextures(), ImVec2(ImGui::GetIO().DisplaySize.x, 32));
       ImGui::End();
     }
     // a nice FPS counter
@@ -1283,16 +1731,14 @@ void render(double delta) {
       .samplerShadow = samplerShadow_.index(),
   };
 
-  const mat4 modelMatrix = glm::scale(mat4(1.0f), vec3(0.05f));
-
   const UniformsPerObject perObject = {
-      .model = modelMatrix,
-      .normal = glm::transpose(glm::inverse(modelMatrix)),
+      .model = modelMatrix_,
+      .normal = glm::transpose(glm::inverse(modelMatrix_)),
   };
 
   lvk::ICommandBuffer& buffer = ctx_->acquireCommandBuffer();
 
-  processLoadedMaterials(buffer);
+  updateMaterials(buffer);
 
   buffer.cmdUpdateBuffer(ubPerFrame_, 0, sizeof(perFrame_), &perFrame_);
   buffer.cmdUpdateBuffer(ubPerObject_, 0, sizeof(perObject), &perObject);
@@ -1319,7 +1765,7 @@ void render(double delta) {
       };
       buffer.cmdPushConstants(bindings);
       buffer.cmdBindIndexBuffer(ib0_, lvk::IndexFormat_UI32);
-      buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+      buffer.cmdDrawIndexed(numIndices_);
       buffer.cmdPopDebugGroupLabel();
     }
     buffer.cmdEndRendering();
@@ -1328,6 +1774,63 @@ void render(double delta) {
     isShadowMapDirty_ = false;
   }
 
+  // meshlets culling
+  const bool renderMeshlets = enableMeshlets_ && numMeshlets_ > 0;
+  const bool useIndirectMeshlets = renderMeshlets && useGpuCuller_;
+
+  if (renderMeshlets) {
+    // glm::perspective() produces depth in [-1..1]
+    const mat4 clipToVulkan = mat4(1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.0, 0.0, 0.5, 1.0);
+    const mat4 viewProj = clipToVulkan * perFrame_.proj * perFrame_.view;
+
+    if (!useIndirectMeshlets) {
+      UniformsMeshletCulling culling = {
+          .cameraPos = glm::inverse(perFrame_.view)[3],
+          .numMeshlets = numMeshlets_,
+      };
+      getFrustumPlanes(viewProj, culling.frustumPlanes);
+      buffer.cmdUpdateBuffer(ubMeshletCulling_, 0, sizeof(culling), &culling);
+    } else {
+      lvk::CullingDesc desc = {
+          .instances = sbCullingInstances_,
+          .meshes = sbCullingMeshes_,
+          .numInstances = numMeshlets_,
+          .enableOcclusion = true, // against the Hi-Z pyramid of the previous frame
+      };
+      memcpy(desc.viewProj, glm::value_ptr(viewProj), sizeof(desc.viewProj));
+      culler_->cull(buffer, desc);
+
+      // the offscreen depth buffer is multisampled: render the visible meshlets into a single-sampled one for the next frame's Hi-Z,
+      // using the same Vulkan clip space as `viewProj`
+      UniformsPerFrame perFramePrepass = perFrame_;
+      perFramePrepass.proj = clipToVulkan * perFrame_.proj;
+      const lvk::TransientAllocation perFramePrepassAlloc = ctx_->allocateTransient(sizeof(perFramePrepass));
+      memcpy(perFramePrepassAlloc.ptr, &perFramePrepass, sizeof(perFramePrepass));
+
+      buffer.cmdBeginRendering(
+          renderPassShadow_, fbDepthPrepass_, {.buffers = {culler_->getIndirectBuffer(), culler_->getCountBuffer()}});
+      {
+        buffer.cmdBindRenderPipeline(renderPipelineState_DepthPrepass_);
+        buffer.cmdPushDebugGroupLabel("Render Depth Prepass", 0xff0000ff);
+        buffer.cmdBindDepthState(depthState_);
+        buffer.cmdBindVertexBuffer(0, vb0_, 0);
+        struct {
+          uint64_t perFrame;
+          uint64_t perObject;
+        } bindings = {
+            .perFrame = perFramePrepassAlloc.gpuAddress,
+            .perObject = ctx_->gpuAddress(ubPerObject_),
+        };
+        buffer.cmdPushConstants(bindings);
+        buffer.cmdBindIndexBuffer(ibMeshlets_, lvk::IndexFormat_UI32);
+        culler_->cmdDraw(buffer);
+        buffer.cmdPopDebugGroupLabel();
+      }
+      buffer.cmdEndRendering();
+      culler_->buildHiZ(buffer, fbDepthPrepass_.depthStencil.texture, glm::value_ptr(viewProj));
+    }
+  }
+
 #define GPU_TIMESTAMP(timestamp) buffer.cmdWriteTimestamp(queryPoolTimestamps_, timestamp);
 
   // Pass 2: mesh
@@ -1337,29 +1840,76 @@ void render(double delta) {
     GPU_TIMESTAMP(GPUTimestamp_BeginSceneRendering);
 
     // This will clear the framebuffer
-    buffer.cmdBeginRendering(renderPassOffscreen_, fbOffscreen_);
+    buffer.cmdBeginRendering(
+        renderPassOffscreen_,
+        fbOffscreen_,
+        {.buffers = {useIndirectMeshlets ? culler_->getIndirectBuffer() : lvk::BufferHandle{},
+                     useIndirectMeshlets ? culler_->getCountBuffer() : lvk::BufferHandle{}}});
     {
       // Scene
-      buffer.cmdBindRenderPipeline(drawNormals_ ? renderPipelineState_MeshNormals_ : renderPipelineState_Mesh_);
-      buffer.cmdPushDebugGroupLabel("Render Mesh", 0xff0000ff);
-      buffer.cmdBindDepthState(depthState_);
-      buffer.cmdBindVertexBuffer(0, vb0_, 0);
-
-      struct {
-        uint64_t perFrame;
-        uint64_t perObject;
-        uint64_t materials;
-      } bindings = {
-          .perFrame = ctx_->gpuAddress(ubPerFrame_),
-          .perObject = ctx_->gpuAddress(ubPerObject_),
-          .materials = ctx_->gpuAddress(sbMaterials_),
-      };
-      buffer.cmdPushConstants(bindings);
-      buffer.cmdBindIndexBuffer(ib0_, lvk::IndexFormat_UI32);
-      buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+      if (renderMeshlets && !useIndirectMeshlets) {
+        buffer.cmdBindRenderPipeline(drawNormals_ ? renderPipelineState_MeshletsNormals_ : renderPipelineState_Meshlets_);
+        buffer.cmdPushDebugGroupLabel("Render Meshlets", 0xff0000ff);
+        buffer.cmdBindDepthState(depthState_);
+
+        struct {
+          uint64_t perFrame;
+          uint64_t perObject;
+          uint64_t materials;
+          uint64_t meshlets;
+          uint64_t meshletVertices;
+          uint64_t meshletTriangles;
+          uint64_t vertices;
+          uint64_t culling;
+        } bindings = {
+            .perFrame = ctx_->gpuAddress(ubPerFrame_),
+            .perObject = ctx_->gpuAddress(ubPerObject_),
+            .materials = ctx_->gpuAddress(sbMaterials_),
+            .meshlets = ctx_->gpuAddress(sbMeshlets_),
+            .meshletVertices = ctx_->gpuAddress(sbMeshletVertices_),
+            .meshletTriangles = ctx_->gpuAddress(sbMeshletTriangles_),
+            .vertices = ctx_->gpuAddress(vb0_),
+            .culling = ctx_->gpuAddress(ubMeshletCulling_),
+        };
+        buffer.cmdPushConstants(bindings);
+        buffer.cmdDrawMeshTasks({.width = (numMeshlets_ + kMeshletTaskGroupSize - 1) / kMeshletTaskGroupSize});
+      } else {
+        buffer.cmdBindRenderPipeline(drawNormals_ ? renderPipelineState_MeshNormals_ : renderPipelineState_Mesh_);
+        buffer.cmdPushDebugGroupLabel("Render Mesh", 0xff0000ff);
+        buffer.cmdBindDepthState(depthState_);
+
+        struct {
+          uint64_t perFrame;
+          uint64_t perObject;
+          uint64_t materials;
+        } bindings = {
+            .perFrame = ctx_->gpuAddress(ubPerFrame_),
+            .perObject = ctx_->gpuAddress(ubPerObject_),
+            .materials = ctx_->gpuAddress(sbMaterials_),
+        };
+        buffer.cmdPushConstants(bindings);
+        buffer.cmdBindVertexBuffer(0, vb0_, 0);
+        if (useIndirectMeshlets) {
+          buffer.cmdBindIndexBuffer(ibMeshlets_, lvk::IndexFormat_UI32);
+          culler_->cmdDraw(buffer);
+        } else {
+          buffer.cmdBindIndexBuffer(ib0_, lvk::IndexFormat_UI32);
+          buffer.cmdDrawIndexed(numIndices_);
+        }
+      }
       if (enableWireframe_) {
+        struct {
+          uint64_t perFrame;
+          uint64_t perObject;
+        } bindings = {
+            .perFrame = ctx_->gpuAddress(ubPerFrame_),
+            .perObject = ctx_->gpuAddress(ubPerObject_),
+        };
         buffer.cmdBindRenderPipeline(renderPipelineState_MeshWireframe_);
-        buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+        buffer.cmdPushConstants(bindings);
+        buffer.cmdBindVertexBuffer(0, vb0_, 0);
+        buffer.cmdBindIndexBuffer(ib0_, lvk::IndexFormat_UI32);
+        buffer.cmdDrawIndexed(numIndices_);
       }
       buffer.cmdPopDebugGroupLabel();
 
@@ -1450,23 +2000,38 @@ void render(double delta) {
   }
 }
 
-void generateCompressedTexture(LoadedImage img) {
+// convert an image into a KTX2 file with a full mip-pyramid; RGBA images are compressed to Basis Universal and transcoded by the streamer
+bool cookTexture(const std::string& srcFileName, const std::string& dstFileName, uint32_t channels) {
   LVK_PROFILER_FUNCTION();
 
+  if (std::filesystem::exists(dstFileName)) {
+    return true;
+  }
+
   if (loaderShouldExit_.load(std::memory_order_acquire)) {
-    return;
+    return false;
   }
 
-  printf("...compressing texture to %s\n", img.compressedFileName.c_str());
+  int w, h;
+  uint8_t* pixels = stbi_load(srcFileName.c_str(), &w, &h, nullptr, (int)channels);
+
+  if (!pixels) {
+    return false;
+  }
 
-  const uint32_t mipmapLevelCount = lvk::calcNumMipLevels(img.w, img.h);
+  SCOPE_EXIT {
+    stbi_image_free(pixels);
+  };
+
+  printf("...compressing texture to %s\n", dstFileName.c_str());
+
+  const uint32_t mipmapLevelCount = lvk::calcNumMipLevels(w, h);
 
-  // create a KTX2 texture for RGBA data
   ktxTextureCreateInfo createInfoKTX2 = {
-      .glInternalformat = GL_RGBA8,
-      .vkFormat = VK_FORMAT_R8G8B8A8_UNORM,
-      .baseWidth = img.w,
-      .baseHeight = img.h,
+      .glInternalformat = channels == 1 ? GL_R8 : GL_RGBA8,
+      .vkFormat = channels == 1 ? VK_FORMAT_R8_UNORM : VK_FORMAT_R8G8B8A8_UNORM,
+      .baseWidth = (uint32_t)w,
+      .baseHeight = (uint32_t)h,
       .baseDepth = 1u,
       .numDimensions = 2u,
       .numLevels = mipmapLevelCount,
@@ -1481,160 +2046,89 @@ void generateCompressedTexture(LoadedImage img) {
     ktxTexture_Destroy(ktxTexture(textureKTX2));
   };
 
-  uint32_t w = img.w;
-  uint32_t h = img.h;
+  uint32_t levelWidth = w;
+  uint32_t levelHeight = h;
 
   // generate custom mip-pyramid
   for (uint32_t i = 0; i != mipmapLevelCount; ++i) {
     size_t offset = 0;
     ktxTexture_GetImageOffset(ktxTexture(textureKTX2), i, 0, 0, &offset);
 
-    stbir_resize_uint8_linear((const unsigned char*)img.pixels,
-                              (int)img.w,
-                              (int)img.h,
-                              0,
-                              ktxTexture_GetData(ktxTexture(textureKTX2)) + offset,
+    stbir_resize_uint8_linear((const unsigned char*)pixels,
                               w,
                               h,
                               0,
-                              STBIR_RGBA);
+                              ktxTexture_GetData(ktxTexture(textureKTX2)) + offset,
+                              levelWidth,
+                              levelHeight,
+                              0,
+                              channels == 1 ? STBIR_1CHANNEL : STBIR_RGBA);
 
-    h = h > 1 ? h >> 1 : 1;
-    w = w > 1 ? w >> 1 : 1;
+    levelHeight = levelHeight > 1 ? levelHeight >> 1 : 1;
+    levelWidth = levelWidth > 1 ? levelWidth >> 1 : 1;
   }
 
   if (loaderShouldExit_.load(std::memory_order_acquire)) {
-    return;
-  }
-
-  // compress to Basis and transcode to BC7
-  ktxBasisParams params = {
-      .structSize = sizeof(params),
-      .threadCount = 8,
-      .compressionLevel = KTX_ETC1S_DEFAULT_COMPRESSION_LEVEL,
-      .qualityLevel = 255,
-  };
-  (void)LVK_VERIFY(ktxTexture2_CompressBasisEx(textureKTX2, &params) == KTX_SUCCESS);
-  (void)LVK_VERIFY(ktxTexture2_TranscodeBasis(textureKTX2, KTX_TTF_BC7_RGBA, 0) == KTX_SUCCESS);
-
-  // convert to KTX1
-  ktxTextureCreateInfo createInfoKTX1 = {
-      .glInternalformat = GL_COMPRESSED_RGBA_BPTC_UNORM,
-      .vkFormat = VK_FORMAT_BC7_UNORM_BLOCK,
-      .baseWidth = img.w,
-      .baseHeight = img.h,
-      .baseDepth = 1u,
-      .numDimensions = 2u,
-      .numLevels = mipmapLevelCount,
-      .numLayers = 1u,
-      .numFaces = 1u,
-      .generateMipmaps = KTX_FALSE,
-  };
-  ktxTexture1* textureKTX1 = nullptr;
-  (void)LVK_VERIFY(ktxTexture1_Create(&createInfoKTX1, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &textureKTX1) == KTX_SUCCESS);
-
-  for (uint32_t i = 0; i != mipmapLevelCount; ++i) {
-    size_t offset1 = 0;
-    (void)LVK_VERIFY(ktxTexture_GetImageOffset(ktxTexture(textureKTX1), i, 0, 0, &offset1) == KTX_SUCCESS);
-    size_t offset2 = 0;
-    (void)LVK_VERIFY(ktxTexture_GetImageOffset(ktxTexture(textureKTX2), i, 0, 0, &offset2) == KTX_SUCCESS);
-    memcpy(ktxTexture_GetData(ktxTexture(textureKTX1)) + offset1,
-           ktxTexture_GetData(ktxTexture(textureKTX2)) + offset2,
-           ktxTexture_GetImageSize(ktxTexture(textureKTX1), i));
+    return false;
   }
 
-  ktxTexture_WriteToNamedFile(ktxTexture(textureKTX1), img.compressedFileName.c_str());
-}
-
-LoadedImage loadImage(const char* fileName, int channels) {
-  LVK_PROFILER_FUNCTION();
-
-  if (!fileName || !*fileName) {
-    return LoadedImage();
+  if (kEnableCompression && channels == 4) {
+    // compress to Basis; transcoding into a GPU format happens in TextureStreamer
+    ktxBasisParams params = {
+        .structSize = sizeof(params),
+        .threadCount = 8,
+        .compressionLevel = KTX_ETC1S_DEFAULT_COMPRESSION_LEVEL,
+        .qualityLevel = 255,
+    };
+    (void)LVK_VERIFY(ktxTexture2_CompressBasisEx(textureKTX2, &params) == KTX_SUCCESS);
   }
 
-  char debugStr[512] = {0};
-
-  snprintf(debugStr, sizeof(debugStr) - 1, "%s (%i)", fileName, channels);
-
-  const std::string debugName(debugStr);
-
-  {
-    std::lock_guard lock(imagesCacheMutex_);
-
-    const auto it = imagesCache_.find(debugName);
-
-    if (it != imagesCache_.end()) {
-      LVK_ASSERT(channels == it->second.channels);
-      return it->second;
-    }
-  }
+  // write into a temporary file first, so an interrupted compression does not leave a broken cache behind
+  const std::string tmpFileName = dstFileName + ".tmp";
 
-  int w, h;
-  uint8_t* pixels = stbi_load(fileName, &w, &h, nullptr, channels);
-
-  const LoadedImage img = {
-      .w = (uint32_t)w,
-      .h = (uint32_t)h,
-      .channels = (uint32_t)channels,
-      .pixels = pixels,
-      .debugName = debugName,
-      .compressedFileName = convertFileName(fileName),
-  };
-
-  if (img.pixels && kEnableCompression && (channels != 1) && !std::filesystem::exists(img.compressedFileName.c_str())) {
-    generateCompressedTexture(img);
+  if (ktxTexture_WriteToNamedFile(ktxTexture(textureKTX2), tmpFileName.c_str()) != KTX_SUCCESS) {
+    return false;
   }
 
-  std::lock_guard lock(imagesCacheMutex_);
-
-  imagesCache_[fileName] = img;
+  std::error_code ec;
+  std::filesystem::rename(tmpFileName, dstFileName, ec);
 
-  return img;
+  return !ec;
 }
 
-void loadMaterial(size_t i) {
+void loadMaterials() {
   LVK_PROFILER_FUNCTION();
 
   static const std::string pathPrefix = folderContentRoot + "src/bistro/Exterior/";
 
-  SCOPE_EXIT {
-    remainingMaterialsToLoad_.fetch_sub(1u, std::memory_order_release);
-  };
-
-#define LOAD_TEX(result, tex, channels)                                                                                                   \
-  const LoadedImage result =                                                                                                              \
-      std::string(cachedMaterials_[i].tex).empty() ? LoadedImage() : loadImage((pathPrefix + cachedMaterials_[i].tex).c_str(), channels); \
-  if (loaderShouldExit_.load(std::memory_order_acquire)) {                                                                                \
-    return;                                                                                                                               \
-  }
-
-  LOAD_TEX(ambient, ambient_texname, 4);
-  LOAD_TEX(diffuse, diffuse_texname, 4);
-  LOAD_TEX(alpha, alpha_texname, 1);
-
-#undef LOAD_TEX
-
-  const LoadedMaterial mtl{i, ambient, diffuse, alpha};
-
-  if (!mtl.ambient.pixels && !mtl.diffuse.pixels) {
-    // skip missing textures
-    materials_[i].texDiffuse = 0;
-  } else {
-    std::lock_guard guard(loadedMaterialsMutex_);
-    loadedMaterials_.push_back(mtl);
-    remainingMaterialsToLoad_.fetch_add(1u, std::memory_order_release);
-  }
-}
-
-void loadMaterials() {
   stbi_set_flip_vertically_on_load(1);
 
-  remainingMaterialsToLoad_ = (uint32_t)cachedMaterials_.size();
+  textureStreamer_ = std::make_unique<TextureStreamer>(*ctx_,
+                                                       TextureStreamer::Config{
+                                                           .numThreads = std::max(2u, std::thread::hardware_concurrency() / 2),
+                                                       });
+
+  auto requestTexture = [](const char* texName, uint32_t channels) -> uint32_t {
+    if (!*texName) {
+      return kInvalidStreamedTexture;
+    }
+    const std::string srcFileName = pathPrefix + texName;
+    return textureStreamer_->request({
+        .fileName = convertFileName(srcFileName),
+        .components = channels == 1 ? lvk::ComponentMapping{lvk::Swizzle_R, lvk::Swizzle_R, lvk::Swizzle_R, lvk::Swizzle_R}
+                                    : lvk::ComponentMapping{},
+        .prepare = [srcFileName, channels](const std::string& fileName) { return cookTexture(srcFileName, fileName, channels); },
+        .debugName = srcFileName,
+    });
+  };
 
   textures_.resize(cachedMaterials_.size());
   for (size_t i = 0; i != cachedMaterials_.size(); i++) {
-    loaderPool_->silent_async([i]() { loadMaterial(i); });
+    textures_[i] = {
+        .ambient = requestTexture(cachedMaterials_[i].ambient_texname, 4),
+        .diffuse = requestTexture(cachedMaterials_[i].diffuse_texname, 4),
+        .alpha = requestTexture(cachedMaterials_[i].alpha_texname, 1),
+    };
   }
 }
 
@@ -1830,109 +2324,17 @@ void loadSkyboxTexture() {
   loadCubemapTexture(fileNameIrrKTX, skyboxTextureIrradiance_);
 }
 
-lvk::Format formatFromChannels(uint32_t channels) {
-  if (channels == 1) {
-    return lvk::Format_R_UN8;
-  }
-
-  if (channels == 4) {
-    return kEnableCompression ? lvk::Format_BC7_RGBA : lvk::Format_RGBA_UN8;
-  }
-
-  return lvk::Format_Invalid;
-}
-
-lvk::TextureHandle createTexture(const LoadedImage& img) {
-  if (!img.pixels) {
-    return {};
-  }
-
-  const auto it = texturesCache_.find(img.debugName);
-
-  if (it != texturesCache_.end()) {
-    return it->second;
-  }
-
-  const bool hasCompressedTexture = kEnableCompression && img.channels == 4 && std::filesystem::exists(img.compressedFileName.c_str());
-
-  const void* initialData = img.pixels;
-  uint32_t initialDataNumMipLevels = 1u;
-
-  ktxTexture* texture = nullptr;
-
-  if (hasCompressedTexture) {
-    // uploading the texture
-    if (!LVK_VERIFY(ktxTexture_CreateFromNamedFile(img.compressedFileName.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture) ==
-                    KTX_SUCCESS)) {
-      printf("Failed to load %s\n", img.compressedFileName.c_str());
-      assert(0);
-    }
-    initialData = texture->pData;
-    initialDataNumMipLevels = lvk::calcNumMipLevels(img.w, img.h);
-  }
-  SCOPE_EXIT {
-    if (texture)
-      ktxTexture_Destroy(ktxTexture(texture));
-  };
-
-  // No mip-maps come from files on Apple and Android platforms, we need to generate them.
-#if defined(__APPLE__) || defined(ANDROID)
-  const bool generateMipmaps = true;
-#else
-  const bool generateMipmaps = !hasCompressedTexture;
-#endif
-
-  lvk::Holder<lvk::TextureHandle> tex = ctx_->createTexture({
-      .type = lvk::TextureType_2D,
-      .format = formatFromChannels(img.channels),
-      .dimensions = {img.w, img.h},
-      .usage = lvk::TextureUsageBits_Sampled,
-      .numMipLevels = lvk::calcNumMipLevels(img.w, img.h),
-      .components = (img.channels == 1) ? lvk::ComponentMapping{lvk::Swizzle_R, lvk::Swizzle_R, lvk::Swizzle_R, lvk::Swizzle_R}
-                                        : lvk::ComponentMapping{},
-      .data = initialData,
-      .dataNumMipLevels = initialDataNumMipLevels,
-      .generateMipmaps = generateMipmaps,
-      .debugName = img.debugName.c_str(),
-  });
-
-  lvk::TextureHandle handle = tex;
-
-  texturesCache_[img.debugName] = std::move(tex);
-
-  return handle;
-}
-
-void processLoadedMaterials(lvk::ICommandBuffer& buffer) {
-  LoadedMaterial mtl;
-
-  {
-    std::lock_guard guard(loadedMaterialsMutex_);
-    if (loadedMaterials_.empty()) {
-      return;
-    } else {
-      mtl = loadedMaterials_.back();
-      loadedMaterials_.pop_back();
-      remainingMaterialsToLoad_.fetch_sub(1u, std::memory_order_release);
-    }
+void updateMaterials(lvk::ICommandBuffer& buffer) {
+  if (!textureStreamer_->update()) {
+    return;
   }
 
-  {
-    MaterialTextures tex;
-
-    tex.ambient = createTexture(mtl.ambient);
-    tex.diffuse = createTexture(mtl.diffuse);
-    tex.alpha = createTexture(mtl.alpha);
-
-    // update GPU materials
-    materials_[mtl.idx].texAmbient = tex.ambient.index();
-    materials_[mtl.idx].texDiffuse = tex.diffuse.index();
-    materials_[mtl.idx].texAlpha = tex.alpha.index();
-    textures_[mtl.idx] = std::move(tex);
+  // placeholders until the streamer has uploaded something
+  for (size_t i = 0; i != materials_.size(); i++) {
+    materials_[i].texAmbient = textureStreamer_->getTextureIndex(textures_[i].ambient);
+    materials_[i].texDiffuse = textureStreamer_->getTextureIndex(textures_[i].diffuse);
+    materials_[i].texAlpha = textureStreamer_->getTextureIndex(textures_[i].alpha);
   }
-  LVK_ASSERT(materials_[mtl.idx].texAmbient >= 0);
-  LVK_ASSERT(materials_[mtl.idx].texDiffuse >= 0);
-  LVK_ASSERT(materials_[mtl.idx].texAlpha >= 0);
   buffer.cmdUpdateBuffer(sbMaterials_, 0, sizeof(GPUMaterial) * materials_.size(), materials_.data());
 }
 
@@ -2073,6 +2475,11 @@ GLFWmousebuttonfun g_PrevMouseButtonCallback = nullptr;
 int main(int argc, char* argv[]) {
   minilog::initialize(nullptr, {.threadNames = false});
 
+  BenchmarkRecorder benchmark("Tiny_MeshLarge");
+  for (int i = 1; i < argc; i++) {
+    benchmark.parseArgument(argc, argv, i);
+  }
+
   // find the content folder
   {
     using namespace std::filesystem;
@@ -2091,12 +2498,13 @@ int main(int argc, char* argv[]) {
     folderContentRoot = (dir / subdir).string();
   }
 
-  lvk::LVKwindow* window = lvk::initWindow("Vulkan Bistro", width_, height_);
+  lvk::LVKwindow* window = lvk::initWindow("Vulkan Bistro", width_, height_, false, benchmark.isEnabled());
   ctx_ = lvk::createVulkanContextWithSwapchain(window,
                                                width_,
                                                height_,
                                                {
                                                    .enableValidation = kEnableValidationLayers,
+                                                   .enableHeadlessSurface = benchmark.isEnabled(),
                                                },
                                                kPreferIntegratedGPU ? lvk::HWDeviceType_Integrated : lvk::HWDeviceType_Discrete);
   if (!ctx_) {
@@ -2111,115 +2519,125 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
-  glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int width, int height) {
-    width_ = width;
-    height_ = height;
-    resize();
-  });
-
-  glfwSetCursorPosCallback(window, [](auto* window, double x, double y) {
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    if (width && height) {
-      mousePos_ = vec2(x / width, 1.0f - y / height);
-      ImGui::GetIO().MousePos = ImVec2(x, y);
-    }
-  });
+  if (window) {
+    glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int width, int height) {
+      width_ = width;
+      height_ = height;
+      resize();
+    });
 
-  g_PrevMouseButtonCallback = glfwSetMouseButtonCallback(window, [](auto* window, int button, int action, int mods) {
-    if (!ImGui::GetIO().WantCaptureMouse) {
-      if (button == GLFW_MOUSE_BUTTON_LEFT) {
-        mousePressed_ = (action == GLFW_PRESS);
+    glfwSetCursorPosCallback(window, [](auto* window, double x, double y) {
+      int width, height;
+      glfwGetFramebufferSize(window, &width, &height);
+      if (width && height) {
+        mousePos_ = vec2(x / width, 1.0f - y / height);
+        ImGui::GetIO().MousePos = ImVec2(x, y);
       }
-    } else {
-      // release the mouse
-      mousePressed_ = false;
-    }
-    // call the previous installed callback
-    if (g_PrevMouseButtonCallback)
-      g_PrevMouseButtonCallback(window, button, action, mods);
-  });
+    });
 
-  g_PrevKeyCallback = glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int scancode, int action, int mods) {
-    const bool pressed = action != GLFW_RELEASE && !ImGui::GetIO().WantCaptureKeyboard;
-    if (key == GLFW_KEY_ESCAPE && pressed) {
-      loaderShouldExit_.store(true, std::memory_order_release);
-      glfwSetWindowShouldClose(window, GLFW_TRUE);
-    }
-    if (key == GLFW_KEY_N && pressed) {
-      drawNormals_ = !drawNormals_;
-    }
-    if (key == GLFW_KEY_C && pressed) {
-      enableComputePass_ = !enableComputePass_;
-    }
-    if (key == GLFW_KEY_T && pressed) {
-      enableWireframe_ = !enableWireframe_;
-    }
-    if (key == GLFW_KEY_P && pressed) {
-      showPerfStats_ = !showPerfStats_;
-    }
-    if (key == GLFW_KEY_ESCAPE && pressed)
-      glfwSetWindowShouldClose(window, GLFW_TRUE);
-    if (key == GLFW_KEY_W) {
-      positioner_.movement_.forward_ = pressed;
-    }
-    if (key == GLFW_KEY_S) {
-      positioner_.movement_.backward_ = pressed;
-    }
-    if (key == GLFW_KEY_A) {
-      positioner_.movement_.left_ = pressed;
-    }
-    if (key == GLFW_KEY_D) {
-      positioner_.movement_.right_ = pressed;
-    }
-    if (key == GLFW_KEY_1) {
-      positioner_.movement_.up_ = pressed;
-    }
-    if (key == GLFW_KEY_2) {
-      positioner_.movement_.down_ = pressed;
-    }
-    if (mods & GLFW_MOD_SHIFT) {
-      positioner_.movement_.fastSpeed_ = pressed;
-    }
-    if (key == GLFW_KEY_LEFT_SHIFT || key == GLFW_KEY_RIGHT_SHIFT) {
-      positioner_.movement_.fastSpeed_ = pressed;
-    }
-    if (key == GLFW_KEY_SPACE) {
-      positioner_.setUpVector(vec3(0.0f, 1.0f, 0.0f));
-    }
-    if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
-      ktxTextureCreateInfo createInfo = {
-          .glInternalformat = GL_RGBA8,
-          .vkFormat = VK_FORMAT_B8G8R8A8_UNORM,
-          .baseWidth = static_cast<uint32_t>(width_),
-          .baseHeight = static_cast<uint32_t>(height_),
-          .baseDepth = 1u,
-          .numDimensions = 2u,
-          .numLevels = 1u,
-          .numLayers = 1u,
-          .numFaces = 1u,
-          .generateMipmaps = KTX_FALSE,
-      };
+    g_PrevMouseButtonCallback = glfwSetMouseButtonCallback(window, [](auto* window, int button, int action, int mods) {
+      if (!ImGui::GetIO().WantCaptureMouse) {
+        if (button == GLFW_MOUSE_BUTTON_LEFT) {
+          mousePressed_ = (action == GLFW_PRESS);
+        }
+      } else {
+        // release the mouse
+        mousePressed_ = false;
+      }
+      // call the previous installed callback
+      if (g_PrevMouseButtonCallback)
+        g_PrevMouseButtonCallback(window, button, action, mods);
+    });
 
-      ktxTexture1* texture = nullptr;
-      (void)LVK_VERIFY(ktxTexture1_Create(&createInfo, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &texture) == KTX_SUCCESS);
-      ctx_->download(ctx_->getCurrentSwapchainTexture(), {.dimensions = {(uint32_t)width_, (uint32_t)height_}}, texture->pData);
-      ktxTexture_WriteToNamedFile(ktxTexture(texture), "screenshot.ktx");
-      ktxTexture_Destroy(ktxTexture(texture));
-    }
-    // call the previous installed callback
-    if (g_PrevKeyCallback)
-      g_PrevKeyCallback(window, key, scancode, action, mods);
-  });
+    g_PrevKeyCallback = glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int scancode, int action, int mods) {
+      const bool pressed = action != GLFW_RELEASE && !ImGui::GetIO().WantCaptureKeyboard;
+      if (key == GLFW_KEY_ESCAPE && pressed) {
+        loaderShouldExit_.store(true, std::memory_order_release);
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+      }
+      if (key == GLFW_KEY_N && pressed) {
+        drawNormals_ = !drawNormals_;
+      }
+      if (key == GLFW_KEY_C && pressed) {
+        enableComputePass_ = !enableComputePass_;
+      }
+      if (key == GLFW_KEY_T && pressed) {
+        enableWireframe_ = !enableWireframe_;
+      }
+      if (key == GLFW_KEY_M && pressed) {
+        enableMeshlets_ = !enableMeshlets_;
+      }
+      if (key == GLFW_KEY_G && pressed && hasMeshShaders_) {
+        useGpuCuller_ = !useGpuCuller_;
+      }
+      if (key == GLFW_KEY_P && pressed) {
+        showPerfStats_ = !showPerfStats_;
+      }
+      if (key == GLFW_KEY_ESCAPE && pressed)
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+      if (key == GLFW_KEY_W) {
+        positioner_.movement_.forward_ = pressed;
+      }
+      if (key == GLFW_KEY_S) {
+        positioner_.movement_.backward_ = pressed;
+      }
+      if (key == GLFW_KEY_A) {
+        positioner_.movement_.left_ = pressed;
+      }
+      if (key == GLFW_KEY_D) {
+        positioner_.movement_.right_ = pressed;
+      }
+      if (key == GLFW_KEY_1) {
+        positioner_.movement_.up_ = pressed;
+      }
+      if (key == GLFW_KEY_2) {
+        positioner_.movement_.down_ = pressed;
+      }
+      if (mods & GLFW_MOD_SHIFT) {
+        positioner_.movement_.fastSpeed_ = pressed;
+      }
+      if (key == GLFW_KEY_LEFT_SHIFT || key == GLFW_KEY_RIGHT_SHIFT) {
+        positioner_.movement_.fastSpeed_ = pressed;
+      }
+      if (key == GLFW_KEY_SPACE) {
+        positioner_.setUpVector(vec3(0.0f, 1.0f, 0.0f));
+      }
+      if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+        ktxTextureCreateInfo createInfo = {
+            .glInternalformat = GL_RGBA8,
+            .vkFormat = VK_FORMAT_B8G8R8A8_UNORM,
+            .baseWidth = static_cast<uint32_t>(width_),
+            .baseHeight = static_cast<uint32_t>(height_),
+            .baseDepth = 1u,
+            .numDimensions = 2u,
+            .numLevels = 1u,
+            .numLayers = 1u,
+            .numFaces = 1u,
+            .generateMipmaps = KTX_FALSE,
+        };
+
+        ktxTexture1* texture = nullptr;
+        (void)LVK_VERIFY(ktxTexture1_Create(&createInfo, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &texture) == KTX_SUCCESS);
+        ctx_->download(ctx_->getCurrentSwapchainTexture(), {.dimensions = {(uint32_t)width_, (uint32_t)height_}}, texture->pData);
+        ktxTexture_WriteToNamedFile(ktxTexture(texture), "screenshot.ktx");
+        ktxTexture_Destroy(ktxTexture(texture));
+      }
+      // call the previous installed callback
+      if (g_PrevKeyCallback)
+        g_PrevKeyCallback(window, key, scancode, action, mods);
+    });
+  }
 
   double prevTime = getCurrentTimestamp();
 
   // Main loop
-  while (!glfwWindowShouldClose(window)) {
-    glfwPollEvents();
+  while (benchmark.isEnabled() ? !benchmark.isFinished() : !glfwWindowShouldClose(window)) {
+    if (window) {
+      glfwPollEvents();
+    }
 
     const double newTime = getCurrentTimestamp();
-    const double delta = newTime - prevTime;
+    const double delta = benchmark.isEnabled() ? BenchmarkRecorder::kDeltaSeconds : newTime - prevTime;
     prevTime = newTime;
 
     if (!width_ || !height_)
@@ -2227,7 +2645,19 @@ int main(int argc, char* argv[]) {
 
     fps_.tick(delta);
 
+    benchmark.beginFrame();
+
     render(delta);
+
+    // frames are recorded only after all textures have been streamed in
+    if (!textureStreamer_->getNumLoading()) {
+      benchmark.endFrame(*ctx_);
+    }
+  }
+
+  if (benchmark.isFinished()) {
+    ctx_->wait({});
+    benchmark.write(*ctx_, (uint32_t)width_, (uint32_t)height_);
   }
 
   // destroy all the Vulkan stuff before closing the window
@@ -162,6 +162,8 @@ VulkanApp::VulkanApp(android_app* androidApp, const VulkanAppConfig& cfg) : andr
 #else
 VulkanApp::VulkanApp(int argc, char* argv[], const VulkanAppConfig& cfg) : cfg_(cfg) {
   const char* logFileName = nullptr;
+  const std::string appName = std::filesystem::path(argv[0]).stem().string();
+  benchmark_ = BenchmarkRecorder(appName.c_str());
   for (int i = 1; i < argc; i++) {
     if (!strcmp(argv[i], "--headless")) {
       cfg_.contextConfig.enableHeadlessSurface = true;
@@ -183,8 +185,13 @@ VulkanApp::VulkanApp(int argc, char* argv[], const VulkanAppConfig& cfg) : cfg_(
       } else {
         LLOGW("Specify a file name for `--screenshot-file <filename>`");
       }
+    } else {
+      benchmark_.parseArgument(argc, argv, i);
     }
   }
+  if (benchmark_.isEnabled()) {
+    cfg_.contextConfig.enableHeadlessSurface = true;
+  }
 #endif // ANDROID
   minilog::initialize(logFileName,
                       {
@@ -384,9 +391,19 @@ void VulkanApp::run(DrawFrameFunc drawFrame) {
     }
   } while (!androidApp_->destroyRequested);
 #else
-  while (cfg_.contextConfig.enableHeadlessSurface || !glfwWindowShouldClose(window_)) {
+  while ((cfg_.contextConfig.enableHeadlessSurface || !glfwWindowShouldClose(window_)) && !benchmark_.isFinished()) {
+    if (ctx_) {
+      // sleep before sampling time and input (see lvk::ContextConfig::enableLowLatency)
+      ctx_->waitForNextFrame();
+    }
+
+    if (benchmark_.isEnabled()) {
+      // animations driven by glfwGetTime() are replayed identically in every run
+      glfwSetTime(frameCount_ * BenchmarkRecorder::kDeltaSeconds);
+    }
+
     const double newTimeStamp = glfwGetTime();
-    deltaSeconds = static_cast<float>(newTimeStamp - timeStamp);
+    deltaSeconds = benchmark_.isEnabled() ? BenchmarkRecorder::kDeltaSeconds : static_cast<float>(newTimeStamp - timeStamp);
     if (fpsCounter_.tick(deltaSeconds)) {
       LLOGL("FPS: %.1f\n", fpsCounter_.getFPS());
     }
@@ -407,12 +424,18 @@ void VulkanApp::run(DrawFrameFunc drawFrame) {
       continue;
     const float ratio = width_ / (float)height_;
 
-    positioner_.update(deltaSeconds, mouseState_.pos, ImGui::GetIO().WantCaptureMouse ? false : mouseState_.pressedLeft);
+    benchmark_.beginFrame();
+
+    // no input in the benchmark mode, the camera stays where VulkanAppConfig puts it
+    const bool mousePressed = !benchmark_.isEnabled() && !ImGui::GetIO().WantCaptureMouse && mouseState_.pressedLeft;
+    positioner_.update(deltaSeconds, mouseState_.pos, mousePressed);
 
     lvk::TextureHandle tex = ctx_->getCurrentSwapchainTexture();
 
     drawFrame((uint32_t)width_, (uint32_t)height_, ratio, deltaSeconds);
 
+    benchmark_.endFrame(*ctx_);
+
     if (cfg_.screenshotFrameNumber == ++frameCount_) {
       ctx_->wait({});
       const lvk::Dimensions dim = ctx_->getDimensions(tex);
@@ -442,6 +465,11 @@ void VulkanApp::run(DrawFrameFunc drawFrame) {
       break;
     }
   }
+
+  if (benchmark_.isFinished()) {
+    ctx_->wait({});
+    benchmark_.write(*ctx_, (uint32_t)width_, (uint32_t)height_);
+  }
 #endif // ANDROID
 
   LLOGD("Terminating app...");
@@ -19,6 +19,8 @@
 #include <lvk/HelpersImGui.h>
 #include <lvk/LVK.h>
 
+#include "Benchmark.h"
+
 // clang-format off
 #if defined(ANDROID)
 #  include <android_native_app_glue.h>
@@ -129,4 +131,6 @@ class VulkanApp {
 #endif // ANDROID
 
   uint64_t frameCount_ = 0;
+
+  BenchmarkRecorder benchmark_ = BenchmarkRecorder("VulkanApp"); // see Benchmark.h
 };